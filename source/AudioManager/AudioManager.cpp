@@ -10,6 +10,7 @@
 // ******************************************************************************
 
 #include "AudioManager.h"
+#include "../utils/Profiler.h"
 
 // Initialize the singleton instance
 AudioManager *AudioManager::c_instance = 0;
@@ -85,6 +86,8 @@ AudioManager::AudioManager()
 
 void AudioManager::Update(vec3 listenerPos, vec3 listenerForward, vec3 listenerUp)
 {
+	PROFILE_ZONE("AudioManager::Update");
+
 	FMOD_VECTOR listenerpos = { listenerPos.x, listenerPos.y, listenerPos.z };
 	FMOD_VECTOR vel = { 0.0f, 0.0f, 0.0f };
 	FMOD_VECTOR forward = { listenerForward.x, listenerForward.y, listenerForward.z };
@@ -16,6 +16,9 @@
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
 #include "../utils/FileUtils.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
 
 #include "../Lighting/LightingManager.h"
 #include "../Particles/BlockParticleManager.h"
@@ -1987,100 +1990,65 @@ void Enemy::CheckNPCDamageRadius()
 	}
 }
 
-void Enemy::CheckProjectileDamageRadius(Projectile* pProjectile)
+bool Enemy::CheckProjectileHit(Projectile* pProjectile, float* pHitTime)
 {
 	if(pProjectile->CanAttackEnemies() == false)
 	{
-		return;
+		return false;
 	}
 
 	vec3 projectileHitboxCenter = GetProjectileHitboxCenter();
 
-	vec3 toProjectile = projectileHitboxCenter - pProjectile->GetCenter();
+	// Sweep along the movement of the projectile in the last step, so a fast projectile can't pass through between steps
+	vec3 sweepStart = pProjectile->GetSweepStartCenter();
+	vec3 sweepEnd = pProjectile->GetCenter();
 
-	bool hitByProjectile = false;
 	if(m_eProjectileHitboxType == eProjectileHitboxType_Sphere)
 	{
-		if(length(toProjectile) < GetRadius() + pProjectile->GetRadius())
-		{
-			hitByProjectile = true;
-		}
+		return SweptCollision::SphereSphere(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRadius(), pHitTime);
 	}
 	else if(m_eProjectileHitboxType == eProjectileHitboxType_Cube)
 	{
-		Plane3D planes[6];
-		Matrix4x4 rotationMatrix;
-		rotationMatrix.SetYRotation(DegToRad(GetRotation()));
-		planes[0] = Plane3D(rotationMatrix * vec3(-1.0f, 0.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[1] = Plane3D(rotationMatrix * vec3(1.0f, 0.0f, 0.0f),  projectileHitboxCenter + (rotationMatrix * vec3(-m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[2] = Plane3D(rotationMatrix * vec3(0.0f, -1.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, m_projectileHitboxYLength, 0.0f)));
-		planes[3] = Plane3D(rotationMatrix * vec3(0.0f, 1.0f, 0.0f),  projectileHitboxCenter + (rotationMatrix * vec3(0.0f, -m_projectileHitboxYLength, 0.0f)));
-		planes[4] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, -1.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, m_projectileHitboxZLength)));
-		planes[5] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, 1.0f),  projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, -m_projectileHitboxZLength)));
-
-		float distance;
-		int inside = 0;
-		vec3 normal;
+		vec3 halfLengths = vec3(m_projectileHitboxXLength, m_projectileHitboxYLength, m_projectileHitboxZLength);
 
-		for(int i = 0; i < 6; i++)
-		{
-			distance = planes[i].GetPointDistance(pProjectile->GetCenter());
+		return EntityStep::SweepCubeHitbox(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRotation(), halfLengths, pHitTime);
+	}
 
-			if (distance < -pProjectile->GetRadius())
-			{
-				// Outside...
-			}
-			else if (distance < pProjectile->GetRadius())
-			{
-				// Intersecting..
-				inside++;
-			}
-			else
-			{
-				// Inside...
-				inside++;
-			}
-		}
+	return false;
+}
 
-		if(inside == 6)
-		{
-			hitByProjectile = true;
-		}
+void Enemy::HitByProjectile(Projectile* pProjectile)
+{
+	vec3 knockbackDirection;
+	if(m_eEnemyType == eEnemyType_Bee || m_eEnemyType == eEnemyType_Bat || m_eEnemyType == eEnemyType_Ghost || m_eEnemyType == eEnemyType_Doppelganger)
+	{
+		knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f);
 	}
-
-	if(hitByProjectile)
+	else
 	{
-		vec3 knockbackDirection;
-		if(m_eEnemyType == eEnemyType_Bee || m_eEnemyType == eEnemyType_Bat || m_eEnemyType == eEnemyType_Ghost || m_eEnemyType == eEnemyType_Doppelganger)
-		{
-			knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f);
-		}
-		else
-		{
-			knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
-		}
+		knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
+	}
 
-		knockbackDirection = normalize(knockbackDirection);
-		Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
+	knockbackDirection = normalize(knockbackDirection);
+	Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
 
-		// Set NPC target as attacker, if they owned the projectile
-		bool playerDamage = (pProjectile->GetPlayerOwner() != NULL);
-		if(pProjectile->GetNPCOwner() != NULL)
-		{
-			SetTargetNPC(pProjectile->GetNPCOwner());
-		}
+	// Set NPC target as attacker, if they owned the projectile
+	bool playerDamage = (pProjectile->GetPlayerOwner() != NULL);
+	if(pProjectile->GetNPCOwner() != NULL)
+	{
+		SetTargetNPC(pProjectile->GetNPCOwner());
+	}
 
-		float knockbackAmount = 16.0f;
-		if (m_eEnemyType == eEnemyType_Bee || m_eEnemyType == eEnemyType_Bat || m_eEnemyType == eEnemyType_Ghost || m_eEnemyType == eEnemyType_Doppelganger)
-		{
-			knockbackAmount = 1.0f;
-		}
-		DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false, playerDamage);
+	float knockbackAmount = 16.0f;
+	if (m_eEnemyType == eEnemyType_Bee || m_eEnemyType == eEnemyType_Bat || m_eEnemyType == eEnemyType_Ghost || m_eEnemyType == eEnemyType_Doppelganger)
+	{
+		knockbackAmount = 1.0f;
+	}
+	DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false, playerDamage);
 
-		if(pProjectile->IsReturnToPlayer() == false)
-		{
-			pProjectile->Explode();
-		}
+	if(pProjectile->IsReturnToPlayer() == false)
+	{
+		pProjectile->Explode();
 	}
 }
 
@@ -2791,8 +2759,30 @@ void Enemy::SpawnGibs()
 }
 
 // Rendering Helpers
+void Enemy::StorePreviousSimulationPosition()
+{
+	m_previousSimulationPosition = m_position;
+}
+
+vec3 Enemy::GetInterpolatedPosition(float interpolation)
+{
+	if(interpolation >= 1.0f)
+	{
+		return m_position;
+	}
+
+	return m_previousSimulationPosition + (m_position - m_previousSimulationPosition) * interpolation;
+}
+
 void Enemy::CalculateWorldTransformMatrix()
 {
+	CalculateWorldTransformMatrix(1.0f);
+}
+
+void Enemy::CalculateWorldTransformMatrix(float interpolation)
+{
+	vec3 position = GetInterpolatedPosition(interpolation);
+
 	vec3 lForward = m_forward;
 	vec3 lUp = vec3(0.0f, 1.0f, 0.0f);
 	if(lForward.x == 0.0f && lForward.z == 0.0f)
@@ -2815,7 +2805,7 @@ void Enemy::CalculateWorldTransformMatrix()
 		lRight.x, lRight.y, lRight.z, 0.0f,
 		lUp.x, lUp.y, lUp.z, 0.0f,
 		lForward.x, lForward.y, lForward.z, 0.0f,
-		m_position.x, m_position.y, m_position.z, 1.0f
+		position.x, position.y, position.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(lMatrix);
@@ -2994,10 +2984,13 @@ void Enemy::Update(float dt)
 
 	// Check for NPC attack damage
 	CheckNPCDamageRadius();
+}
 
+void Enemy::UpdateAnimationAndPhysics(float dt, DeferredCommandBuffer* pCommands)
+{
 	if(m_pVoxelCharacter != NULL)
 	{
-		m_pVoxelCharacter->Update(dt, m_animationSpeed);
+		m_pVoxelCharacter->Update(dt, m_animationSpeed, pCommands);
 		m_pVoxelCharacter->SetWeaponTrailsOriginMatrix(dt, m_worldMatrix);
 
 		for(int i = 0; i < AnimationSections_NUMSECTIONS; i++)
@@ -3068,12 +3061,23 @@ void Enemy::Update(float dt)
 	// Update the enemy light
 	if (m_eEnemyType == eEnemyType_Doppelganger)
 	{
-		m_pLightingManager->UpdateLightPosition(m_enemyLightId, GetCenter());
-
-		m_pEnemyParticleEffect->SetPosition(GetCenter() + vec3(0.0f, 0.75f, 0.0f));
+		pCommands->AddCommand(_UpdateEnemyLightDeferred, this, NULL);
 	}
 }
 
+void Enemy::_UpdateEnemyLightDeferred(void *pObject, void *pData)
+{
+	Enemy* pEnemy = (Enemy*)pObject;
+	pEnemy->UpdateEnemyLight();
+}
+
+void Enemy::UpdateEnemyLight()
+{
+	m_pLightingManager->UpdateLightPosition(m_enemyLightId, GetCenter());
+
+	m_pEnemyParticleEffect->SetPosition(GetCenter() + vec3(0.0f, 0.75f, 0.0f));
+}
+
 void Enemy::UpdatePhysics(float dt)
 {
 	// Gravity modifications for flying creatures
@@ -3926,7 +3930,7 @@ void Enemy::Render(bool outline, bool reflection, bool silhouette)
 
 			Colour OulineColour(1.0f, 0.0f, 0.0f, 1.0f);
 
-			m_pVoxelCharacter->Render(outline, reflection, silhouette, OulineColour, false);
+			m_pVoxelCharacter->Render(outline, reflection, silhouette, OulineColour);
 			m_pVoxelCharacter->RenderWeapons(outline, reflection, silhouette, OulineColour);
 		m_pRenderer->PopMatrix();
 	}
@@ -29,6 +29,7 @@ class NPCManager;
 class NPC;
 class EnemySpawner;
 class HUD;
+class DeferredCommandBuffer;
 
 enum eEnemyType
 {
@@ -138,7 +139,9 @@ public:
 	void DoDamage(float amount, Colour textColour, vec3 knockbackDirection, float knockbackAmount, bool createParticleHit, bool shouldUpdateGUI);
 	void CheckPlayerDamageRadius();
 	void CheckNPCDamageRadius();
-	void CheckProjectileDamageRadius(Projectile* pProjectile);
+	// When the projectile's movement in the last step hits the projectile hitbox, and the time of impact along that step
+	bool CheckProjectileHit(Projectile* pProjectile, float* pHitTime);
+	void HitByProjectile(Projectile* pProjectile);
 	void Explode();
 	void ConvertIntoOtherEnemyType(eEnemyType newEnemyType, float scale);
 	void Respawn();
@@ -182,7 +185,10 @@ public:
 	void SpawnGibs();
 
 	// Rendering Helpers
+	void StorePreviousSimulationPosition();
+	vec3 GetInterpolatedPosition(float interpolation);
 	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolation);
 	void SetOutlineRender(bool outline);
 	bool GetOutlineRender();
 	void SetWireFrameRender(bool wireframe);
@@ -191,6 +197,8 @@ public:
 	void UpdateWeaponLights(float dt);
 	void UpdateWeaponParticleEffects(float dt);
 	void Update(float dt);
+	// Only changes this enemy, so that it can run in parallel with the other enemies, anything else is added to pCommands
+	void UpdateAnimationAndPhysics(float dt, DeferredCommandBuffer* pCommands);
 	void UpdatePhysics(float dt);
 	void UpdateLookingAndForwardTarget(float dt);
 	void UpdateCombat(float dt);
@@ -221,6 +229,9 @@ protected:
 	static void _AttackEnabledDelayTimerFinished(void *apData);
 	void AttackEnabledDelayTimerFinished();
 
+	static void _UpdateEnemyLightDeferred(void *pObject, void *pData);
+	void UpdateEnemyLight();
+
 private:
 	/* Private methods */
 
@@ -254,6 +265,7 @@ private:
 	// Enemy position and movement variables
 	vec3 m_position;
 	vec3 m_previousPosition;
+	vec3 m_previousSimulationPosition;
 	vec3 m_velocity;
 	vec3 m_gravityDirection;
 
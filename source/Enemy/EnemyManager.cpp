@@ -19,6 +19,13 @@
 #include "../Projectile/ProjectileManager.h"
 #include "../VoxGame.h"
 #include "../GameGUI/HUD.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/Profiler.h"
+
+#include <algorithm>
 
 
 EnemyManager::EnemyManager(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer)
@@ -26,6 +33,10 @@ EnemyManager::EnemyManager(Renderer* pRenderer, ChunkManager* pChunkManager, Pla
 	m_pRenderer = pRenderer;
 	m_pChunkManager = pChunkManager;
 	m_pPlayer = pPlayer;
+	m_pSpatialGrid = NULL;
+	m_pParallelUpdate = NULL;
+
+	m_updateDeltaTime = 0.0f;
 
 	m_numRenderEnemies = 0;
 }
@@ -70,6 +81,16 @@ void EnemyManager::SetNPCManager(NPCManager* pNPCManager)
 	m_pNPCManager = pNPCManager;
 }
 
+void EnemyManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+void EnemyManager::SetParallelUpdate(ParallelUpdate* pParallelUpdate)
+{
+	m_pParallelUpdate = pParallelUpdate;
+}
+
 EnemyManager::~EnemyManager()
 {
 	ClearEnemies();
@@ -89,6 +110,11 @@ void EnemyManager::ClearEnemies()
 	m_vpEnemyList.clear();
 	m_enemyMutex.unlock();
 
+	if(m_pSpatialGrid != NULL)
+	{
+		m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Enemy);
+	}
+
 	// Create list
 	for(unsigned int i = 0; i < m_vpEnemyCreateList.size(); i++)
 	{
@@ -141,6 +167,7 @@ Enemy* EnemyManager::CreateEnemy(vec3 position, eEnemyType enemyType, float scal
 	Enemy* pNewEnemy = new Enemy(m_pRenderer, m_pChunkManager, m_pPlayer, m_pLightingManager, m_pBlockParticleManager, m_pTextEffectsManager, m_pItemManager, m_pProjectileManager, m_pHUD, this, m_pNPCManager, m_pQubicleBinaryManager, enemyType);
 
 	pNewEnemy->SetPosition(position);
+	pNewEnemy->StorePreviousSimulationPosition();
 	pNewEnemy->SetLeashParameters(position, 15.0f);
 	pNewEnemy->ResetRandomTargetPosition();
 	if(enemyType != eEnemyType_Mimic)
@@ -226,14 +253,20 @@ Enemy* EnemyManager::GetCursorEnemy(Camera* pGameCamera, int cursorX, int cursor
 	int interations = 0;
 	float increments = Chunk::BLOCK_RENDER_SIZE*0.1f;
 	vec3 worldNormal = normalize(worldPos2 - worldPos1);
-	while(collides == false && interations < 100)
+
+	// Only the enemies near the projected mouse line need to be checked, the pick radius is 2.5 times the enemy radius
+	vector<void*> vpEnemies;
+	vec3 lineEnd = worldPos1 + worldNormal * (increments + Chunk::BLOCK_RENDER_SIZE*99.0f);
+	m_pSpatialGrid->SegmentQuery(eSpatialGridLayer_Enemy, worldPos1, lineEnd, m_pSpatialGrid->GetMaxRadius(eSpatialGridLayer_Enemy)*1.5f, &vpEnemies);
+
+	while(collides == false && interations < 100 && vpEnemies.size() > 0)
 	{
 		vec3 newPos = worldPos1 + worldNormal * increments;
 
 		m_enemyMutex.lock();
-		for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+		for(unsigned int i = 0; i < vpEnemies.size(); i++)
 		{
-			Enemy* pEnemy = m_vpEnemyList[i];
+			Enemy* pEnemy = (Enemy*)vpEnemies[i];
 
 			vec3 diff = pEnemy->GetCenter() - newPos;
 			float diff_length = length(diff);
@@ -284,26 +317,25 @@ void EnemyManager::RemoveSappedFromEnemies(Enemy *pEnemyToBeSapped)
 // Collision
 void EnemyManager::PushCollisions(Enemy* pPushingEnemy, vec3 position, float radius)
 {
-	EnemyList::iterator enemy_iterator;
+	vector<void*> vpEnemies;
+	m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Enemy, position, radius, &vpEnemies);
+
 	m_enemyMutex.lock();
-	for(enemy_iterator = m_vpEnemyList.begin(); enemy_iterator != m_vpEnemyList.end(); ++enemy_iterator)
+	for(unsigned int i = 0; i < vpEnemies.size(); i++)
 	{
-		Enemy* pEnemy = (*enemy_iterator);
+		Enemy* pEnemy = (Enemy*)vpEnemies[i];
 
 		if(pEnemy == pPushingEnemy)
 		{
 			continue;  // Can't push ourselves
 		}
 
-		vec3 distance = pEnemy->GetCenter() - position;
-		float lengthResult = length(distance) - radius - pEnemy->GetRadius();
-
-		if(lengthResult < 0.0f)
+		vec3 pushVector;
+		if(EntityStep::GetPushVector(position, radius, pEnemy->GetCenter(), pEnemy->GetRadius(), &pushVector))
 		{
-			vec3 pushVector = distance;
-			pushVector.y = 0.0f;  // Don't push in Y direction
-			pushVector *= lengthResult;
-			pEnemy->SetPosition(pEnemy->GetPosition() - pushVector);
+			pEnemy->SetPosition(pEnemy->GetPosition() + pushVector);
+
+			m_pSpatialGrid->AddObject(eSpatialGridLayer_Enemy, pEnemy, pEnemy->GetCenter(), pEnemy->GetRadius());
 		}
 	}
 	m_enemyMutex.unlock();
@@ -360,6 +392,8 @@ bool needs_erasing(Enemy* aE)
 
 void EnemyManager::Update(float dt)
 {
+	PROFILE_ZONE("EnemyManager::Update");
+
 	// Update all enemy spawners
 	m_enemySpawnerMutex.lock();
 	for(unsigned int i = 0; i < m_vpEnemySpawnerList.size(); i++)
@@ -396,8 +430,13 @@ void EnemyManager::Update(float dt)
 	// Erase any dead enemies
 	m_enemyMutex.lock();
 	m_vpEnemyList.erase( remove_if(m_vpEnemyList.begin(), m_vpEnemyList.end(), needs_erasing), m_vpEnemyList.end() );
+	m_enemyMutex.unlock();
+
+	// Register the enemies with the spatial grid, now that the dead ones are gone
+	UpdateSpatialGrid();
 
-	// Update all enemies
+	// Update the enemy behaviour, one enemy at a time since this interacts with the world and the other entities
+	m_enemyMutex.lock();
 	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
@@ -409,6 +448,17 @@ void EnemyManager::Update(float dt)
 		//}
 
 		pEnemy->Update(dt);
+	}
+
+	// Update the enemy animation and physics in parallel
+	m_updateDeltaTime = dt;
+	m_pParallelUpdate->Run((int)m_vpEnemyList.size(), _UpdateEnemyParallel, this);
+
+	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_Enemy, pEnemy, pEnemy->GetCenter(), pEnemy->GetRadius());
 
 		m_enemyMutex.unlock();
 
@@ -432,6 +482,14 @@ void EnemyManager::Update(float dt)
 	UpdateEnemyProjectileCheck(dt);
 }
 
+void EnemyManager::_UpdateEnemyParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	EnemyManager* pEnemyManager = (EnemyManager*)pData;
+	Enemy* pEnemy = pEnemyManager->m_vpEnemyList[index];
+
+	pEnemy->UpdateAnimationAndPhysics(pEnemyManager->m_updateDeltaTime, pCommands);
+}
+
 void EnemyManager::UpdateEnemyPlayerAttackCheck(float dt)
 {
 	if(m_pPlayer->IsDead() == true)
@@ -462,6 +520,9 @@ void EnemyManager::UpdateEnemyPlayerAttackCheck(float dt)
 
 void EnemyManager::UpdateEnemyProjectileCheck(float dt)
 {
+	vector<void*> vpProjectiles;
+	vector<SweptHit> vHits;
+
 	m_enemyMutex.lock();
 	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
 	{
@@ -478,40 +539,124 @@ void EnemyManager::UpdateEnemyProjectileCheck(float dt)
 		//	continue;
 		//}
 
-		for(int j = 0; j < m_pProjectileManager->GetNumProjectiles(); j++)
+		// Only look at the projectiles that could reach the projectile hitbox, a cube hitbox can turn so use its diagonal.
+		// The corners of the cube grow by more than the projectile radius, so allow a bit extra for the projectile.
+		float hitboxReach = pEnemy->GetRadius();
+		if(pEnemy->GetProjectileHitboxType() == eProjectileHitboxType_Cube)
 		{
-			Projectile* pProjectile = m_pProjectileManager->GetProjectile(j);
+			float xLength = pEnemy->GetProjectileHitboxXLength();
+			float zLength = pEnemy->GetProjectileHitboxZLength();
+			hitboxReach = sqrtf(xLength*xLength + zLength*zLength) + m_pSpatialGrid->GetMaxRadius(eSpatialGridLayer_Projectile)*0.5f;
+		}
 
-			if(pProjectile != NULL && pProjectile->GetErase() == false)
+		m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Projectile, pEnemy->GetProjectileHitboxCenter(), hitboxReach, &vpProjectiles);
+
+		for(unsigned int j = 0; j < vpProjectiles.size(); j++)
+		{
+			Projectile* pProjectile = (Projectile*)vpProjectiles[j];
+
+			SweptHit hit;
+			if(pProjectile != NULL && pProjectile->GetErase() == false && pEnemy->CheckProjectileHit(pProjectile, &hit.m_time))
 			{
-				pEnemy->CheckProjectileDamageRadius(pProjectile);
+				hit.m_pObject = pEnemy;
+				hit.m_pOther = pProjectile;
+				vHits.push_back(hit);
 			}
 		}
 	}
+
+	// Apply the hits in the order they happened in the step, so a projectile that explodes on the first enemy it reaches doesn't hit the ones behind it too
+	stable_sort(vHits.begin(), vHits.end(), SweptHit::EarliestFirst);
+	for(unsigned int i = 0; i < vHits.size(); i++)
+	{
+		Enemy* pEnemy = (Enemy*)vHits[i].m_pObject;
+		Projectile* pProjectile = (Projectile*)vHits[i].m_pOther;
+
+		if(pProjectile->GetErase() == false)
+		{
+			pEnemy->HitByProjectile(pProjectile);
+		}
+	}
+	m_enemyMutex.unlock();
+}
+
+void EnemyManager::StorePreviousSimulationPositions()
+{
+	m_enemyMutex.lock();
+	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+
+		pEnemy->StorePreviousSimulationPosition();
+	}
+	m_enemyMutex.unlock();
+}
+
+void EnemyManager::CalculateWorldTransformMatrix(float interpolation)
+{
+	m_enemyMutex.lock();
+	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+
+		pEnemy->CalculateWorldTransformMatrix(interpolation);
+	}
 	m_enemyMutex.unlock();
 }
 
-void EnemyManager::CalculateWorldTransformMatrix()
+void EnemyManager::UpdateSpatialGrid()
 {
+	m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Enemy);
+
 	m_enemyMutex.lock();
 	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		pEnemy->CalculateWorldTransformMatrix();
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_Enemy, pEnemy, pEnemy->GetCenter(), pEnemy->GetRadius());
 	}
 	m_enemyMutex.unlock();
 }
 
 // Rendering
+// Culling
+void EnemyManager::CullEnemies(VisibilityCuller* pVisibilityCuller)
+{
+	m_enemyMutex.lock();
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleEnemies[i].clear();
+	}
+
+	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+
+		unsigned int passMask = pVisibilityCuller->CullSphere(VisibilityType_Enemy, pEnemy->GetCenter(), pEnemy->GetRadius());
+		for(int j = 0; j < RenderPass_NumPasses; j++)
+		{
+			if(passMask & (1 << j))
+			{
+				m_vpVisibleEnemies[j].push_back(pEnemy);
+			}
+		}
+	}
+	m_enemyMutex.unlock();
+}
+
 void EnemyManager::Render(bool outline, bool reflection, bool silhouette, bool shadow)
 {
+	PROFILE_ZONE("EnemyManager::Render");
+
 	m_numRenderEnemies = 0;
 
+	// Only the enemies that CullEnemies() found in this pass's frustum
+	EnemyList& vpVisibleEnemies = m_vpVisibleEnemies[shadow ? RenderPass_Shadow : RenderPass_Main];
+
 	m_enemyMutex.lock();
-	for(unsigned int i = 0; i < m_vpEnemyList.size(); i++)
+	for(unsigned int i = 0; i < vpVisibleEnemies.size(); i++)
 	{
-		Enemy* pEnemy = m_vpEnemyList[i];
+		Enemy* pEnemy = vpVisibleEnemies[i];
 
 		if(silhouette && pEnemy->GetOutlineRender() == false)
 		{
@@ -535,12 +680,9 @@ void EnemyManager::Render(bool outline, bool reflection, bool silhouette, bool s
 			m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
 		}
 
-		if(shadow || m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
-		{
-			pEnemy->Render(outline, reflection, silhouette);
+		pEnemy->Render(outline, reflection, silhouette);
 
-			m_numRenderEnemies++;
-		}
+		m_numRenderEnemies++;
 
 		m_pRenderer->DisableTransparency();
 	}
@@ -26,6 +26,9 @@ class ItemManager;
 class ProjectileManager;
 class HUD;
 class NPCManager;
+class SpatialGrid;
+class ParallelUpdate;
+class DeferredCommandBuffer;
 
 typedef std::vector<Enemy*> EnemyList;
 typedef std::vector<EnemySpawner*> EnemySpawnerList;
@@ -46,6 +49,8 @@ public:
 	void SetHUD(HUD* pHUD);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
 	void SetNPCManager(NPCManager* pNPCManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+	void SetParallelUpdate(ParallelUpdate* pParallelUpdate);
 
 	// Clearing
 	void ClearEnemies();
@@ -82,7 +87,11 @@ public:
 	void Update(float dt);
 	void UpdateEnemyPlayerAttackCheck(float dt);
 	void UpdateEnemyProjectileCheck(float dt);
-	void CalculateWorldTransformMatrix();
+	void StorePreviousSimulationPositions();
+	void CalculateWorldTransformMatrix(float interpolation);
+
+	// Culling
+	void CullEnemies(VisibilityCuller* pVisibilityCuller);
 
 	// Rendering
 	void Render(bool outline, bool reflection, bool silhouette, bool shadow);
@@ -96,6 +105,8 @@ protected:
 
 private:
 	/* Private methods */
+	void UpdateSpatialGrid();
+	static void _UpdateEnemyParallel(void* pData, int index, DeferredCommandBuffer* pCommands);
 
 public:
 	/* Public members */
@@ -117,6 +128,11 @@ private:
 	HUD* m_pHUD;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	NPCManager* m_pNPCManager;
+	SpatialGrid* m_pSpatialGrid;
+	ParallelUpdate* m_pParallelUpdate;
+
+	// Delta time for the parallel update jobs
+	float m_updateDeltaTime;
 
 	int m_numRenderEnemies;
 
@@ -125,6 +141,9 @@ private:
 	EnemyList m_vpEnemyList;
 	EnemyList m_vpEnemyCreateList;
 
+	// The enemies that each render pass can see, rebuilt every frame
+	EnemyList m_vpVisibleEnemies[RenderPass_NumPasses];
+
 	// Enemy spawner
 	tthread::mutex m_enemySpawnerMutex;
 	EnemySpawnerList m_vpEnemySpawnerList;
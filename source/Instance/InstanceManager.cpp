@@ -12,11 +12,13 @@
 #include "InstanceManager.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include "../Renderer/Renderer.h"
 #include "../utils/Random.h"
 #include "../blocks/Chunk.h"
 #include "../models/QubicleBinary.h"
+#include "../utils/Profiler.h"
 
 
 InstanceManager::InstanceManager(Renderer* pRenderer)
@@ -66,6 +68,12 @@ void InstanceManager::ClearInstanceObjects()
 
 		delete m_vpInstanceParentList[i]->m_pQubicleBinary;
 
+		if(m_vpInstanceParentList[i]->m_indexBuffer != -1)
+		{
+			glDeleteBuffers(1, &m_vpInstanceParentList[i]->m_indexBuffer);
+		}
+		m_pRenderer->DeleteInstanceBuffer(m_vpInstanceParentList[i]->m_instanceBuffer);
+
 		delete m_vpInstanceParentList[i];
 		m_vpInstanceParentList[i] = 0;
 	}
@@ -133,7 +141,9 @@ void InstanceManager::SetupGLBuffers(InstanceParent *pInstanceParent)
 	pInstanceParent->m_positionBuffer = -1;
 	pInstanceParent->m_normalBuffer = -1;
 	pInstanceParent->m_colourBuffer = -1;
-	pInstanceParent->m_matrixBuffer = -1;
+	pInstanceParent->m_indexBuffer = -1;
+	pInstanceParent->m_numIndices = 0;
+	pInstanceParent->m_instanceBuffer = -1;
 
 	pInstanceParent->m_pQubicleBinary = new QubicleBinary(m_pRenderer);
 	pInstanceParent->m_pQubicleBinary->Import(pInstanceParent->m_modelName.c_str(), true);
@@ -161,21 +171,21 @@ void InstanceManager::SetupGLBuffers(InstanceParent *pInstanceParent)
 	for(int i = 0; i < (int)pMesh->m_vertices.size(); i++)
 	{
 		// Vertices
-		vertices[counter+0] = pMesh->m_vertices[i]->vertexPosition[0];
-		vertices[counter+1] = pMesh->m_vertices[i]->vertexPosition[1];
-		vertices[counter+2] = pMesh->m_vertices[i]->vertexPosition[2];
+		vertices[counter+0] = pMesh->m_vertices[i].vertexPosition[0];
+		vertices[counter+1] = pMesh->m_vertices[i].vertexPosition[1];
+		vertices[counter+2] = pMesh->m_vertices[i].vertexPosition[2];
 		vertices[counter+3] = 1.0f;
 
 		// Normals
-		normals[counter+0] = pMesh->m_vertices[i]->vertexNormals[0];
-		normals[counter+1] = pMesh->m_vertices[i]->vertexNormals[1];
-		normals[counter+2] = pMesh->m_vertices[i]->vertexNormals[2];
+		normals[counter+0] = pMesh->m_vertices[i].vertexNormals[0];
+		normals[counter+1] = pMesh->m_vertices[i].vertexNormals[1];
+		normals[counter+2] = pMesh->m_vertices[i].vertexNormals[2];
 		normals[counter+3] = 1.0f;
 
 		// Colours
-		colours[counter+0] = pMesh->m_vertices[i]->vertexColour[0];
-		colours[counter+1] = pMesh->m_vertices[i]->vertexColour[1];
-		colours[counter+2] = pMesh->m_vertices[i]->vertexColour[2];
+		colours[counter+0] = pMesh->m_vertices[i].vertexColour[0];
+		colours[counter+1] = pMesh->m_vertices[i].vertexColour[1];
+		colours[counter+2] = pMesh->m_vertices[i].vertexColour[2];
 		colours[counter+3] = 1.0f;
 
 		counter += 4;
@@ -214,9 +224,31 @@ void InstanceManager::SetupGLBuffers(InstanceParent *pInstanceParent)
 	glEnableVertexAttribArray(in_color);
 	glVertexAttribPointer(in_color, 4, GL_FLOAT, 0, 0, 0);
 
+	// The index buffer is part of the vertex array state, so it only needs building once
+	unsigned int numTriangles = (int)pMesh->m_triangles.size();
+	unsigned int* indices = new unsigned int[numTriangles * 3];
+	for(unsigned int i = 0; i < numTriangles; i++)
+	{
+		indices[i*3+0] = pMesh->m_triangles[i].vertexIndices[0];
+		indices[i*3+1] = pMesh->m_triangles[i].vertexIndices[1];
+		indices[i*3+2] = pMesh->m_triangles[i].vertexIndices[2];
+	}
+
+	glGenBuffers(1, &pInstanceParent->m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pInstanceParent->m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*numTriangles*3, indices, GL_STATIC_DRAW);
+	pInstanceParent->m_numIndices = numTriangles * 3;
+
+	m_pRenderer->CreateInstanceBuffer(16, &pInstanceParent->m_instanceBuffer);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
 	delete vertices;
 	delete normals;
 	delete colours;
+	delete indices;
 }
 
 // Creation
@@ -293,6 +325,8 @@ void InstanceManager::SetWireFrameRender(bool wireframe)
 // Update
 void InstanceManager::Update(float dt)
 {
+	PROFILE_ZONE("InstanceManager::Update");
+
 	if(m_checkChunkInstanceTimer > 0.0f)
 	{
 		m_checkChunkInstanceTimer -= dt;
@@ -337,6 +371,8 @@ void InstanceManager::Update(float dt)
 // Rendering
 void InstanceManager::Render()
 {
+	PROFILE_ZONE("InstanceManager::Render");
+
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
 	GLint in_position = glGetAttribLocation(pShader->GetProgramObject(), "in_position");
@@ -345,80 +381,35 @@ void InstanceManager::Render()
 
 	for(int instanceParentId = 0; instanceParentId < (int)m_vpInstanceParentList.size(); instanceParentId++)
 	{
-		OpenGLTriangleMesh* pMesh = m_vpInstanceParentList[instanceParentId]->m_pQubicleBinary->GetQubicleMatrix(0)->m_pMesh;
+		InstanceParent* pInstanceParent = m_vpInstanceParentList[instanceParentId];
 
-		unsigned int numIndices = (int)pMesh->m_triangles.size() * 3;
-		unsigned int numTriangles = (int)pMesh->m_triangles.size();
-		unsigned int* indicesBuffer = new unsigned int[numIndices];
-		int lIndexCounter = 0;
-		for(unsigned int i = 0; i < numTriangles; i++)
+		int numInstanceObjectsRender = GetNumInstanceRenderObjectsForParent(instanceParentId);
+		if(numInstanceObjectsRender == 0)
 		{
-			indicesBuffer[lIndexCounter] = pMesh->m_triangles[i]->vertexIndices[0];
-			indicesBuffer[lIndexCounter+1] = pMesh->m_triangles[i]->vertexIndices[1];
-			indicesBuffer[lIndexCounter+2] = pMesh->m_triangles[i]->vertexIndices[2];
-
-			lIndexCounter += 3;
+			continue;
 		}
 
+		float* pMatrices = m_pRenderer->GetInstanceBufferData(pInstanceParent->m_instanceBuffer, numInstanceObjectsRender);
+
 		int instanceObjectRenderCounter = 0;
-		int numInstanceObjectsRender = GetNumInstanceRenderObjectsForParent(instanceParentId);
-		if(numInstanceObjectsRender > 0)
+		for(unsigned int i = 0; i < (int)pInstanceParent->m_vpInstanceObjectList.size() && instanceObjectRenderCounter < numInstanceObjectsRender; i++)
 		{
-			float* newMatrices = new float[16 * numInstanceObjectsRender];
-
-			int counter = 0;
-			
-			instanceObjectRenderCounter = 0;
-			for(unsigned int i = 0; i < (int)m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList.size() && instanceObjectRenderCounter < numInstanceObjectsRender; i++)
+			if(pInstanceParent->m_vpInstanceObjectList[i]->m_render == false)
 			{
-				if(m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_render == false)
-				{
-					continue;
-				}
-
-				newMatrices[counter+0] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[0];
-				newMatrices[counter+1] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[1];
-				newMatrices[counter+2] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[2];
-				newMatrices[counter+3] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[3];
-				newMatrices[counter+4] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[4];
-				newMatrices[counter+5] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[5];
-				newMatrices[counter+6] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[6];
-				newMatrices[counter+7] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[7];
-				newMatrices[counter+8] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[8];
-				newMatrices[counter+9] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[9];
-				newMatrices[counter+10] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[10];
-				newMatrices[counter+11] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[11];
-				newMatrices[counter+12] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[12];
-				newMatrices[counter+13] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[13];
-				newMatrices[counter+14] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[14];
-				newMatrices[counter+15] = m_vpInstanceParentList[instanceParentId]->m_vpInstanceObjectList[i]->m_worldMatrix.m[15];
-				counter += 16;
-
-				instanceObjectRenderCounter++;
+				continue;
 			}
 
-			glBindVertexArray(m_vpInstanceParentList[instanceParentId]->m_vertexArray);
+			memcpy(&pMatrices[instanceObjectRenderCounter*16], pInstanceParent->m_vpInstanceObjectList[i]->m_worldMatrix.m, sizeof(float)*16);
 
-			if(m_vpInstanceParentList[instanceParentId]->m_matrixBuffer != -1)
-			{
-				glDeleteBuffers(1, &m_vpInstanceParentList[instanceParentId]->m_matrixBuffer);
-			}
-			// Bind buffer for matrix and copy data into buffer
-			glGenBuffers(1, &m_vpInstanceParentList[instanceParentId]->m_matrixBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, m_vpInstanceParentList[instanceParentId]->m_matrixBuffer);
-			for (int i = 0; i < 4; i++)
-			{
-				glVertexAttribPointer(in_model_matrix + i,		// Location
-					4, GL_FLOAT, GL_FALSE,	// vec4
-					4*16,						// Stride
-					reinterpret_cast<void *>(16 * i));		// Start offset
+			instanceObjectRenderCounter++;
+		}
 
-				glEnableVertexAttribArray(in_model_matrix + i);
-				glVertexAttribDivisor(in_model_matrix + i, 1);
-			}
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float)*16*numInstanceObjectsRender, newMatrices, GL_STATIC_READ);
+		glBindVertexArray(pInstanceParent->m_vertexArray);
 
-			delete newMatrices;
+		m_pRenderer->UploadInstanceBuffer(pInstanceParent->m_instanceBuffer, numInstanceObjectsRender);
+		for (int i = 0; i < 4; i++)
+		{
+			m_pRenderer->BindInstanceBufferAttribute(pInstanceParent->m_instanceBuffer, in_model_matrix + i, 4, i * 4);
 		}
 
 		// Render the instances
@@ -456,7 +447,7 @@ void InstanceManager::Render()
 
 		m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
 
-		glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, indicesBuffer, numInstanceObjectsRender);
+		glDrawElementsInstanced(GL_TRIANGLES, pInstanceParent->m_numIndices, GL_UNSIGNED_INT, 0, numInstanceObjectsRender);
 
 		m_pRenderer->DisableTransparency();
 
@@ -465,7 +456,5 @@ void InstanceManager::Render()
 		glBindVertexArray(0);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-		delete indicesBuffer;
 	}
 }
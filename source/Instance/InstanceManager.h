@@ -59,7 +59,13 @@ public:
 	unsigned int m_positionBuffer;
 	unsigned int m_normalBuffer;
 	unsigned int m_colourBuffer;
-	unsigned int m_matrixBuffer;
+
+	// Triangle indices, built once from the mesh
+	unsigned int m_indexBuffer;
+	int m_numIndices;
+
+	// World matrices of the rendered instances, streamed each frame
+	unsigned int m_instanceBuffer;
 
 	InstanceObjectList m_vpInstanceObjectList;
 
@@ -17,6 +17,7 @@
 #include "../GameGUI/InventoryGUI.h"
 #include "../GameGUI/LootGUI.h"
 #include "../GameGUI/ActionBar.h"
+#include "../utils/Profiler.h"
 
 #include <algorithm>
 #include <fstream>
@@ -952,6 +953,10 @@ InventoryItem* InventoryManager::AddInventoryItem(const char* filename, const ch
 InventoryItem* InventoryManager::AddInventoryItem(InventoryItem* pInventoryItem, int inventoryX, int inventoryY)
 {
 	InventoryItem* pItem = AddInventoryItem(pInventoryItem->m_filename.c_str(), pInventoryItem->m_Iconfilename.c_str(), pInventoryItem->m_itemType, pInventoryItem->m_item,  pInventoryItem->m_status, pInventoryItem->m_equipSlot, pInventoryItem->m_itemQuality, pInventoryItem->m_left, pInventoryItem->m_right, pInventoryItem->m_title.c_str(), pInventoryItem->m_description.c_str(), pInventoryItem->m_placementR, pInventoryItem->m_placementG, pInventoryItem->m_placementB, pInventoryItem->m_quantity, pInventoryItem->m_lootSlotX, pInventoryItem->m_lootSlotY, inventoryX, inventoryY);
+	if(pItem == NULL)
+	{
+		return NULL;
+	}
 	
 	for(int i = 0; i < (int)pInventoryItem->m_vpStatAttributes.size(); i++)
 	{
@@ -1291,6 +1296,8 @@ bool needs_removing(InventoryItem* aI)
 
 void InventoryManager::Update(float dt)
 {
+	PROFILE_ZONE("InventoryManager::Update");
+
 	// Remove any items that need to be removed from the vector container
 	m_vpInventoryItemList.erase( remove_if(m_vpInventoryItemList.begin(), m_vpInventoryItemList.end(), needs_removing), m_vpInventoryItemList.end() );
 }
@@ -17,6 +17,7 @@
 
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
+#include "../utils/ParallelUpdate.h"
 #include "../Player/Player.h"
 #include "../Lighting/LightingManager.h"
 #include "../VoxGame.h"
@@ -495,11 +496,33 @@ void Item::SetWireFrameRender(bool wireframe)
 	}
 }
 
+void Item::StorePreviousSimulationPosition()
+{
+	m_previousSimulationPosition = m_position;
+}
+
+vec3 Item::GetInterpolatedPosition(float interpolation)
+{
+	if(interpolation >= 1.0f)
+	{
+		return m_position;
+	}
+
+	return m_previousSimulationPosition + (m_position - m_previousSimulationPosition) * interpolation;
+}
+
 void Item::CalculateWorldTransformMatrix()
 {
+	CalculateWorldTransformMatrix(1.0f);
+}
+
+void Item::CalculateWorldTransformMatrix(float interpolation)
+{
+	vec3 position = GetInterpolatedPosition(interpolation);
+
 	m_worldMatrix.LoadIdentity();
 	m_worldMatrix.SetRotation(DegToRad(m_rotation.x), DegToRad(m_rotation.y), DegToRad(m_rotation.z));
-	m_worldMatrix.SetTranslation(m_position);
+	m_worldMatrix.SetTranslation(position);
 
 	for(unsigned int i = 0; i < m_vpBoundingRegionList.size(); i++)
 	{
@@ -1326,7 +1349,7 @@ int Item::GetMaxInteractCount()
 }
 
 // Update
-void Item::Update(float dt)
+void Item::Update(float dt, DeferredCommandBuffer* pCommands)
 {
 	if(m_erase)
 	{
@@ -1345,7 +1368,7 @@ void Item::Update(float dt)
 	UpdateTimers(dt);
 
 	// Update player magnet
-	UpdatePlayerMagnet(dt);
+	UpdatePlayerMagnet(dt, pCommands);
 
 	// If we don't belong to a chunk
 	if(m_pCachedGridChunk == NULL)
@@ -1358,14 +1381,14 @@ void Item::Update(float dt)
 	{
 		if(m_pOwningChunk != NULL)
 		{
-			m_pOwningChunk->RemoveItem(this);
+			pCommands->AddCommand(_RemoveFromChunkDeferred, this, m_pOwningChunk);
 		}
 
 		m_pOwningChunk = m_pChunkManager->GetChunkFromPosition(m_position.x, m_position.y, m_position.z);
 
 		if(m_pOwningChunk != NULL)
 		{
-			m_pOwningChunk->AddItem(this);
+			pCommands->AddCommand(_AddToChunkDeferred, this, m_pOwningChunk);
 		}
 		else
 		{
@@ -1387,10 +1410,10 @@ void Item::Update(float dt)
 	}
 
 	// Update physics
-	UpdatePhysics(dt);
+	UpdatePhysics(dt, pCommands);
 }
 
-void Item::UpdatePhysics(float dt)
+void Item::UpdatePhysics(float dt, DeferredCommandBuffer* pCommands)
 {
 	vec3 acceleration = (m_gravityDirection * 9.81f) * 4.0f;
 
@@ -1453,14 +1476,14 @@ void Item::UpdatePhysics(float dt)
 		{
 			if (m_pOwningChunk != NULL)
 			{
-				m_pOwningChunk->RemoveItem(this);
+				pCommands->AddCommand(_RemoveFromChunkDeferred, this, m_pOwningChunk);
 			}
 
 			m_pOwningChunk = m_pChunkManager->GetChunkFromPosition(m_position.x, m_position.y, m_position.z);
 
 			if (m_pOwningChunk != NULL)
 			{
-				m_pOwningChunk->AddItem(this);
+				pCommands->AddCommand(_AddToChunkDeferred, this, m_pOwningChunk);
 			}
 
 			if (m_pOwningChunk == NULL)
@@ -1505,7 +1528,7 @@ void Item::UpdateTimers(float dt)
 	}
 }
 
-void Item::UpdatePlayerMagnet(float dt)
+void Item::UpdatePlayerMagnet(float dt, DeferredCommandBuffer* pCommands)
 {
 	if(IsItemPickedUp())
 	{
@@ -1517,7 +1540,7 @@ void Item::UpdatePlayerMagnet(float dt)
 			{
 				if(m_disappearAnimationStarted == false)
 				{
-					Interpolator::GetInstance()->AddFloatInterpolation(&m_disappearScale, m_disappearScale, 0.0f, 0.5f, -100.0f, NULL, _PickupAnimationFinished, this);
+					pCommands->AddCommand(_StartPickupAnimationDeferred, this, NULL);
 
 					m_disappearAnimationStarted = true;
 				}
@@ -1571,20 +1594,7 @@ void Item::UpdatePlayerMagnet(float dt)
 					SetVelocity(vec3(0.0f, 0.0f, 0.0f));
 					SetGravityDirection(vec3(0.0f, 0.0f, 0.0f));
 
-					if(m_itemType == eItem_Heart)
-					{
-						m_pPlayer->GiveHealth(10.0f);
-					}
-
-					if(m_itemType == eItem_Coin)
-					{
-						m_pPlayer->GiveCoins(1);
-					}
-
-					if(m_droppedInventoryItem != NULL)
-					{
-						m_pInventoryManager->AddInventoryItem(m_droppedInventoryItem, -1, -1);
-					}
+					pCommands->AddCommand(_GivePickupDeferred, this, NULL);
 				}
 			}
 		}
@@ -1808,3 +1818,66 @@ void Item::PickupAnimationFinished()
 {
 	SetErase(true);
 }
+
+void Item::_StartPickupAnimationDeferred(void *pObject, void *pData)
+{
+	Item* lpItem = (Item*)pObject;
+	lpItem->StartPickupAnimation();
+}
+
+void Item::StartPickupAnimation()
+{
+	Interpolator::GetInstance()->AddFloatInterpolation(&m_disappearScale, m_disappearScale, 0.0f, 0.5f, -100.0f, NULL, _PickupAnimationFinished, this);
+}
+
+void Item::_GivePickupDeferred(void *pObject, void *pData)
+{
+	Item* lpItem = (Item*)pObject;
+	lpItem->GivePickup();
+}
+
+void Item::GivePickup()
+{
+	if(m_itemType == eItem_Heart)
+	{
+		m_pPlayer->GiveHealth(10.0f);
+	}
+
+	if(m_itemType == eItem_Coin)
+	{
+		m_pPlayer->GiveCoins(1);
+	}
+
+	if(m_droppedInventoryItem != NULL)
+	{
+		// The magnet checked for space during the parallel update, but other pickups in the same step may have filled it since
+		InventoryItem* pAddedItem = NULL;
+		if(m_pInventoryManager->CanAddInventoryItem(GetItemTitle(), GetItemType(), 1))
+		{
+			pAddedItem = m_pInventoryManager->AddInventoryItem(m_droppedInventoryItem, -1, -1);
+		}
+
+		if(pAddedItem == NULL)
+		{
+			// No room after all, cancel the pickup and drop back to the ground
+			m_itemPickup = false;
+			m_disappear = false;
+			SetGravityDirection(vec3(0.0f, -1.0f, 0.0f));
+			SetWorldCollide(true);
+		}
+	}
+}
+
+void Item::_AddToChunkDeferred(void *pObject, void *pData)
+{
+	Item* lpItem = (Item*)pObject;
+	Chunk* pChunk = (Chunk*)pData;
+	pChunk->AddItem(lpItem);
+}
+
+void Item::_RemoveFromChunkDeferred(void *pObject, void *pData)
+{
+	Item* lpItem = (Item*)pObject;
+	Chunk* pChunk = (Chunk*)pData;
+	pChunk->RemoveItem(lpItem);
+}
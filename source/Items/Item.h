@@ -28,6 +28,7 @@
 class LightingManager;
 class ItemManager;
 class ItemSpawner;
+class DeferredCommandBuffer;
 
 // Item helper functionality
 string GetItemTitleForType(eItem type);
@@ -118,7 +119,10 @@ public:
 	void SetOutlineRender(bool outline);
 	bool IsOutlineRender();
 	void SetWireFrameRender(bool wireframe);
+	void StorePreviousSimulationPosition();
+	vec3 GetInterpolatedPosition(float interpolation);
 	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolation);
 
 	// Loot items
 	int GetNumLootItems();
@@ -176,10 +180,11 @@ public:
 	int GetMaxInteractCount();
 
 	// Update
-	void Update(float dt);
-	void UpdatePhysics(float dt);
+	// Only changes this item, so that it can run in parallel with the other items, anything else is added to pCommands
+	void Update(float dt, DeferredCommandBuffer* pCommands);
+	void UpdatePhysics(float dt, DeferredCommandBuffer* pCommands);
 	void UpdateTimers(float dt);
-	void UpdatePlayerMagnet(float dt);
+	void UpdatePlayerMagnet(float dt, DeferredCommandBuffer* pCommands);
 	void UpdateItemLights(float dt);
 	void UpdateItemParticleEffects(float dt);
 
@@ -193,6 +198,13 @@ protected:
 	static void _PickupAnimationFinished(void *apData);
 	void PickupAnimationFinished();
 
+	static void _StartPickupAnimationDeferred(void *pObject, void *pData);
+	void StartPickupAnimation();
+	static void _GivePickupDeferred(void *pObject, void *pData);
+	void GivePickup();
+	static void _AddToChunkDeferred(void *pObject, void *pData);
+	static void _RemoveFromChunkDeferred(void *pObject, void *pData);
+
 private:
 	/* Private methods */
 
@@ -231,6 +243,9 @@ private:
 	// Previous position
 	vec3 m_previousPosition;
 
+	// Position at the start of the current simulation step, rendering interpolates from here to m_position
+	vec3 m_previousSimulationPosition;
+
 	// Velocity
 	vec3 m_velocity;
 
@@ -14,6 +14,9 @@
 #include "../utils/Random.h"
 #include "../Lighting/LightingManager.h"
 #include "../VoxGame.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/Profiler.h"
 
 #include <algorithm>
 
@@ -30,6 +33,10 @@ ItemManager::ItemManager(Renderer* pRenderer, ChunkManager* pChunkManager, Playe
 	m_pInventoryManager = NULL;
 	m_pLightingManager = NULL;
 	m_pBlockParticleManager = NULL;
+	m_pSpatialGrid = NULL;
+	m_pParallelUpdate = NULL;
+
+	m_updateDeltaTime = 0.0f;
 
 	m_numRenderItems = 0;
 
@@ -100,6 +107,16 @@ void ItemManager::SetNPCManager(NPCManager* pNPCManager)
 	m_pNPCManager = pNPCManager;
 }
 
+void ItemManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+void ItemManager::SetParallelUpdate(ParallelUpdate* pParallelUpdate)
+{
+	m_pParallelUpdate = pParallelUpdate;
+}
+
 // Deletion
 void ItemManager::ClearItems()
 {
@@ -109,6 +126,11 @@ void ItemManager::ClearItems()
 		m_vpItemList[i] = 0;
 	}
 	m_vpItemList.clear();
+
+	if(m_pSpatialGrid != NULL)
+	{
+		m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Item);
+	}
 }
 
 void ItemManager::ClearSubSpawnData()
@@ -215,6 +237,7 @@ Item* ItemManager::CreateItem(vec3 position, vec3 velocity, vec3 rotation, const
 
 	vec3 gravityDir = vec3(0.0f, -1.0f, 0.0f);
 	pNewItem->SetPosition(position);
+	pNewItem->StorePreviousSimulationPosition();
 	pNewItem->SetRotation(rotation);
 	pNewItem->SetGravityDirection(gravityDir);
 	pNewItem->SetVelocity(velocity);
@@ -226,6 +249,11 @@ Item* ItemManager::CreateItem(vec3 position, vec3 velocity, vec3 rotation, const
 
 	m_vpItemList.push_back(pNewItem);
 
+	if(m_pSpatialGrid != NULL)
+	{
+		AddItemToSpatialGrid(pNewItem);
+	}
+
 	return pNewItem;
 }
 
@@ -274,23 +302,28 @@ int ItemManager::GetNumRenderItems()
 // Collision detection
 bool ItemManager::CheckCollisions(vec3 center, vec3 previousCenter, float radius, vec3 *pNormal, vec3 *pMovement)
 {
+	vector<void*> vpItems;
+	m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Item, m_pPlayer->GetCenter(), radius, &vpItems);
+
 	bool colliding = false;
-	for(unsigned int i = 0; i < m_vpItemList.size() && colliding == false; i++)
+	for(unsigned int i = 0; i < vpItems.size() && colliding == false; i++)
 	{
-		//if(m_pChunkManager->IsInsideLoader(m_vpItemList[i]->GetCenter()) == false)
+		Item* pItem = (Item*)vpItems[i];
+
+		//if(m_pChunkManager->IsInsideLoader(pItem->GetCenter()) == false)
 		//{
 		//	continue;
 		//}
 
-		if(m_vpItemList[i]->IsCollisionEnabled())
+		if(pItem->IsCollisionEnabled())
 		{
-			vec3 toPlayer = m_vpItemList[i]->GetCenter() - m_pPlayer->GetCenter();
+			vec3 toPlayer = pItem->GetCenter() - m_pPlayer->GetCenter();
 
-			if(length(toPlayer) < radius + m_vpItemList[i]->GetCollisionRadius())
+			if(length(toPlayer) < radius + pItem->GetCollisionRadius())
 			{
-				m_vpItemList[i]->CalculateWorldTransformMatrix();
+				pItem->CalculateWorldTransformMatrix();
 
-				if(m_vpItemList[i]->IsColliding(center, previousCenter, radius, pNormal, pMovement))
+				if(pItem->IsColliding(center, previousCenter, radius, pNormal, pMovement))
 				{
 					colliding = true;
 				}
@@ -309,10 +342,12 @@ Item* ItemManager::CheckItemPlayerInteraction()
 	float maxDotProduct = 0.0f;
 
 	// Check if any item are within interaction range
-	ItemList::iterator item_iterator;
-	for(item_iterator = m_vpItemList.begin(); item_iterator != m_vpItemList.end(); ++item_iterator)
+	vector<void*> vpItems;
+	m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Item, m_pPlayer->GetCenter(), ITEM_INTERACTION_DISTANCE, &vpItems);
+
+	for(unsigned int i = 0; i < vpItems.size(); i++)
 	{
-		Item* pItem = (*item_iterator);
+		Item* pItem = (Item*)vpItems[i];
 
 		if(pItem->NeedsErasing())
 		{
@@ -368,13 +403,23 @@ bool needs_erasing(Item* aI)
 }
 
 // Rendering Helpers
-void ItemManager::CalculateWorldTransformMatrix()
+void ItemManager::StorePreviousSimulationPositions()
 {
 	for (unsigned int i = 0; i < m_vpItemList.size(); i++)
 	{
 		Item* pItem = m_vpItemList[i];
 
-		pItem->CalculateWorldTransformMatrix();
+		pItem->StorePreviousSimulationPosition();
+	}
+}
+
+void ItemManager::CalculateWorldTransformMatrix(float interpolation)
+{
+	for (unsigned int i = 0; i < m_vpItemList.size(); i++)
+	{
+		Item* pItem = m_vpItemList[i];
+
+		pItem->CalculateWorldTransformMatrix(interpolation);
 	}
 }
 
@@ -391,6 +436,8 @@ void ItemManager::SetWireFrameRender(bool wireframe)
 // Update
 void ItemManager::Update(float dt)
 {
+	PROFILE_ZONE("ItemManager::Update");
+
 	// Update all item spawners
 	for (unsigned int i = 0; i < m_vpItemSpawnerList.size(); i++)
 	{
@@ -415,16 +462,46 @@ void ItemManager::Update(float dt)
 
 	UpdateHoverItems();
 
-	for(unsigned int i = 0; i < m_vpItemList.size(); i++)
+	// Update the items in parallel
+	m_updateDeltaTime = dt;
+	m_pParallelUpdate->Run((int)m_vpItemList.size(), _UpdateItemParallel, this);
+
+	// Register the items with the spatial grid, after they have moved
+	UpdateSpatialGrid();
+}
+
+void ItemManager::_UpdateItemParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	ItemManager* pItemManager = (ItemManager*)pData;
+	Item* pItem = pItemManager->m_vpItemList[index];
+
+	if(pItem->NeedsErasing())
 	{
-		Item* pItem = m_vpItemList[i];
+		return;
+	}
 
-		if(pItem->NeedsErasing())
-		{
-			continue;
-		}
+	pItem->Update(pItemManager->m_updateDeltaTime, pCommands);
+}
 
-		pItem->Update(dt);
+void ItemManager::AddItemToSpatialGrid(Item* pItem)
+{
+	// The grid radius has to cover both the collision checks and the interaction checks
+	float radius = pItem->GetRadius();
+	if(pItem->GetCollisionRadius() > radius)
+	{
+		radius = pItem->GetCollisionRadius();
+	}
+
+	m_pSpatialGrid->AddObject(eSpatialGridLayer_Item, pItem, pItem->GetCenter(), radius);
+}
+
+void ItemManager::UpdateSpatialGrid()
+{
+	m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Item);
+
+	for(unsigned int i = 0; i < m_vpItemList.size(); i++)
+	{
+		AddItemToSpatialGrid(m_vpItemList[i]);
 	}
 }
 
@@ -522,9 +599,13 @@ void ItemManager::UpdateHoverItems()
 }
 
 // Rendering
-void ItemManager::Render(bool outline, bool reflection, bool silhouette, bool shadow)
+// Culling
+void ItemManager::CullItems(VisibilityCuller* pVisibilityCuller)
 {
-	m_numRenderItems = 0;
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleItems[i].clear();
+	}
 
 	for(unsigned int i = 0; i < m_vpItemList.size(); i++)
 	{
@@ -535,6 +616,35 @@ void ItemManager::Render(bool outline, bool reflection, bool silhouette, bool sh
 			continue;
 		}
 
+		unsigned int passMask = pVisibilityCuller->CullSphere(VisibilityType_Item, pItem->GetCenter(), pItem->GetRadius());
+		for(int j = 0; j < RenderPass_NumPasses; j++)
+		{
+			if(passMask & (1 << j))
+			{
+				m_vpVisibleItems[j].push_back(pItem);
+			}
+		}
+	}
+}
+
+void ItemManager::Render(bool outline, bool reflection, bool silhouette, bool shadow)
+{
+	PROFILE_ZONE("ItemManager::Render");
+
+	m_numRenderItems = 0;
+
+	// Only the items that CullItems() found in this pass's frustum
+	ItemList& vpVisibleItems = m_vpVisibleItems[shadow ? RenderPass_Shadow : RenderPass_Main];
+
+	for(unsigned int i = 0; i < vpVisibleItems.size(); i++)
+	{
+		Item* pItem = vpVisibleItems[i];
+
+		if(pItem->NeedsErasing())
+		{
+			continue;
+		}
+
 		if((outline || silhouette) && pItem->IsOutlineRender() == false)
 		{
 			continue;
@@ -551,12 +661,9 @@ void ItemManager::Render(bool outline, bool reflection, bool silhouette, bool sh
 			m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
 		}
 
-		if(shadow || m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pItem->GetCenter(), pItem->GetRadius()))
-		{
-			pItem->Render(outline, reflection, silhouette);
+		pItem->Render(outline, reflection, silhouette);
 
-			m_numRenderItems++;
-		}
+		m_numRenderItems++;
 
 		m_pRenderer->DisableTransparency();
 	}
@@ -30,6 +30,9 @@ using namespace std;
 #include "../Player/Player.h"
 
 class LightingManager;
+class SpatialGrid;
+class ParallelUpdate;
+class DeferredCommandBuffer;
 
 typedef std::vector<ItemSpawner*> ItemSpawnerList;
 
@@ -79,6 +82,8 @@ public:
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
 	void SetInventoryManager(InventoryManager* pInventoryManager);
 	void SetNPCManager(NPCManager* pNPCManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+	void SetParallelUpdate(ParallelUpdate* pParallelUpdate);
 
 	// Deletion
 	void ClearItems();
@@ -107,7 +112,8 @@ public:
 	Item* CheckItemPlayerInteraction();
 
 	// Rendering Helpers
-	void CalculateWorldTransformMatrix();
+	void StorePreviousSimulationPositions();
+	void CalculateWorldTransformMatrix(float interpolation);
 	void SetWireFrameRender(bool wireframe);
 
 	// Update
@@ -116,6 +122,9 @@ public:
 	void UpdateItemParticleEffects(float dt);
 	void UpdateHoverItems();
 
+	// Culling
+	void CullItems(VisibilityCuller* pVisibilityCuller);
+
 	// Rendering
 	void Render(bool outline, bool reflection, bool silhouette, bool shadow);
 	void RenderDebug();
@@ -129,6 +138,10 @@ private:
 		string droppedItemFilename, string droppedItemTextureFilename, InventoryType droppedItemInventoryType, eItem droppedItemItem, ItemStatus droppedItemStatus, EquipSlot droppedItemEquipSlot, ItemQuality droppedItemQuality,
 		bool droppedItemLeft, bool droppedItemRight, string droppedItemTitle, string droppedItemDescription, float droppedItemPlacementR, float droppedItemPlacementG, float droppedItemPlacementB, int droppedItemQuantity);
 
+	void AddItemToSpatialGrid(Item* pItem);
+	void UpdateSpatialGrid();
+	static void _UpdateItemParallel(void* pData, int index, DeferredCommandBuffer* pCommands);
+
 public:
 	/* Public members */
 	static float ITEM_INTERACTION_DISTANCE;
@@ -147,6 +160,11 @@ private:
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	InventoryManager* m_pInventoryManager;
 	NPCManager* m_pNPCManager;
+	SpatialGrid* m_pSpatialGrid;
+	ParallelUpdate* m_pParallelUpdate;
+
+	// Delta time for the parallel update jobs
+	float m_updateDeltaTime;
 
 	// Counters
 	int m_numRenderItems;
@@ -154,6 +172,9 @@ private:
 	// Item list
 	ItemList m_vpItemList;
 
+	// The items that each render pass can see, rebuilt every frame
+	ItemList m_vpVisibleItems[RenderPass_NumPasses];
+
 	// Item spawner
 	ItemSpawnerList m_vpItemSpawnerList;
 
@@ -0,0 +1,135 @@
+// ******************************************************************************
+// Filename:    DynamicLightSlotMap.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "DynamicLightSlotMap.h"
+
+
+DynamicLightSlotMap::DynamicLightSlotMap()
+{
+	m_freeSlot = INVALID_ID;
+}
+
+DynamicLightSlotMap::~DynamicLightSlotMap()
+{
+	Clear();
+}
+
+void DynamicLightSlotMap::Clear()
+{
+	while (m_vpLights.size() > 0)
+	{
+		RemoveAtIndex((unsigned int)m_vpLights.size() - 1);
+	}
+}
+
+unsigned int DynamicLightSlotMap::Add(DynamicLight* pLight)
+{
+	unsigned int slot;
+	if (m_freeSlot != INVALID_ID)
+	{
+		slot = m_freeSlot;
+		m_freeSlot = m_vSlots[slot].m_index;
+	}
+	else
+	{
+		if (m_vSlots.size() >= MAX_SLOTS)
+		{
+			delete pLight;
+			return INVALID_ID;
+		}
+
+		DynamicLightSlot newSlot;
+		newSlot.m_generation = 0;
+		slot = (unsigned int)m_vSlots.size();
+		m_vSlots.push_back(newSlot);
+	}
+
+	DynamicLightSlot* pSlot = &m_vSlots[slot];
+	pSlot->m_index = (unsigned int)m_vpLights.size();
+	pSlot->m_used = true;
+
+	unsigned int lightId = (pSlot->m_generation << SLOT_BITS) | slot;
+	pLight->m_lightId = lightId;
+
+	m_vpLights.push_back(pLight);
+	m_vLightSlots.push_back(slot);
+
+	return lightId;
+}
+
+void DynamicLightSlotMap::Remove(unsigned int lightId)
+{
+	unsigned int slot = lightId & SLOT_MASK;
+	if (slot >= m_vSlots.size() || m_vSlots[slot].m_used == false || m_vSlots[slot].m_generation != (lightId >> SLOT_BITS))
+	{
+		return;
+	}
+
+	RemoveAtIndex(m_vSlots[slot].m_index);
+}
+
+DynamicLight* DynamicLightSlotMap::Get(unsigned int lightId)
+{
+	unsigned int slot = lightId & SLOT_MASK;
+	if (slot >= m_vSlots.size() || m_vSlots[slot].m_used == false || m_vSlots[slot].m_generation != (lightId >> SLOT_BITS))
+	{
+		return NULL;
+	}
+
+	return m_vpLights[m_vSlots[slot].m_index];
+}
+
+void DynamicLightSlotMap::RemoveErased()
+{
+	// Backwards, so that the light moved into a hole has already been looked at
+	for (int i = (int)m_vpLights.size() - 1; i >= 0; i--)
+	{
+		if (m_vpLights[i]->NeedsErasing())
+		{
+			RemoveAtIndex(i);
+		}
+	}
+}
+
+int DynamicLightSlotMap::GetNumLights()
+{
+	return (int)m_vpLights.size();
+}
+
+DynamicLight* DynamicLightSlotMap::GetLight(int index)
+{
+	return m_vpLights[index];
+}
+
+void DynamicLightSlotMap::RemoveAtIndex(unsigned int index)
+{
+	unsigned int slot = m_vLightSlots[index];
+
+	delete m_vpLights[index];
+
+	// Move the last light into the hole
+	unsigned int lastIndex = (unsigned int)m_vpLights.size() - 1;
+	if (index != lastIndex)
+	{
+		m_vpLights[index] = m_vpLights[lastIndex];
+		m_vLightSlots[index] = m_vLightSlots[lastIndex];
+		m_vSlots[m_vLightSlots[index]].m_index = index;
+	}
+	m_vpLights.pop_back();
+	m_vLightSlots.pop_back();
+
+	// The new generation makes the old id stale
+	DynamicLightSlot* pSlot = &m_vSlots[slot];
+	pSlot->m_used = false;
+	pSlot->m_generation = (pSlot->m_generation + 1) & MAX_GENERATION;
+	pSlot->m_index = m_freeSlot;
+	m_freeSlot = slot;
+}
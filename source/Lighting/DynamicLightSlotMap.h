@@ -0,0 +1,88 @@
+// ******************************************************************************
+// Filename:    DynamicLightSlotMap.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Owns the dynamic lights and finds them by id in constant time. The lights
+//   are kept packed in one array for rendering, and every id names a slot that
+//   points into that array. A slot's generation goes up each time it is reused,
+//   so an id kept after its light was removed never finds another light.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "DynamicLight.h"
+
+#include <vector>
+using namespace std;
+
+
+class DynamicLightSlot
+{
+public:
+	// Index into the packed light array, or the next free slot when unused
+	unsigned int m_index;
+	unsigned int m_generation;
+	bool m_used;
+};
+
+
+class DynamicLightSlotMap
+{
+public:
+	/* Public methods */
+	DynamicLightSlotMap();
+	~DynamicLightSlotMap();
+
+	// Deletes all of the lights, the ids that were handed out stay invalid
+	void Clear();
+
+	// Takes ownership of the light and returns its id, INVALID_ID when all of the slots are used
+	unsigned int Add(DynamicLight* pLight);
+	// Deletes the light, does nothing for an invalid or stale id
+	void Remove(unsigned int lightId);
+	// NULL for an invalid or stale id
+	DynamicLight* Get(unsigned int lightId);
+
+	// Deletes every light that needs erasing
+	void RemoveErased();
+
+	// The packed lights, the order changes when lights are removed
+	int GetNumLights();
+	DynamicLight* GetLight(int index);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void RemoveAtIndex(unsigned int index);
+
+public:
+	/* Public members */
+	// Never handed out, the callers use -1 for no light
+	static const unsigned int INVALID_ID = 0xFFFFFFFF;
+
+	static const unsigned int SLOT_BITS = 16;
+	static const unsigned int SLOT_MASK = (1 << SLOT_BITS) - 1;
+	static const unsigned int MAX_SLOTS = SLOT_MASK;
+	static const unsigned int MAX_GENERATION = 0xFFFF;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<DynamicLight*> m_vpLights;
+	// The slot of each packed light, to fix up the slot when the last light is moved into a hole
+	vector<unsigned int> m_vLightSlots;
+
+	vector<DynamicLightSlot> m_vSlots;
+	unsigned int m_freeSlot;
+};
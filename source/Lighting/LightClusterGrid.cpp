@@ -0,0 +1,294 @@
+// ******************************************************************************
+// Filename:    LightClusterGrid.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "LightClusterGrid.h"
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+
+// Nothing is rendered closer than this, it keeps the projection of a light around the camera finite
+static const float MIN_LIGHT_DEPTH = 0.01f;
+
+
+LightClusterGrid::LightClusterGrid()
+{
+	m_numLightsBinned = 0;
+	m_numOverflowClusters = 0;
+	m_maxClusterCount = 0;
+
+	SetView(800, 800, 60.0f, 1.0f, 500.0f);
+	SetCamera(vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+}
+
+LightClusterGrid::~LightClusterGrid()
+{
+}
+
+void LightClusterGrid::SetView(int screenWidth, int screenHeight, float fov, float nearD, float farD)
+{
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+	m_numTilesX = (screenWidth + TILE_SIZE - 1) / TILE_SIZE;
+	m_numTilesY = (screenHeight + TILE_SIZE - 1) / TILE_SIZE;
+
+	m_tanHalfFovY = (float)tan(fov * 0.5f * 3.14159265f / 180.0f);
+	m_tanHalfFovX = m_tanHalfFovY * ((float)screenWidth / (float)screenHeight);
+
+	// Exponential slices, each one is the same factor thicker than the one before
+	m_nearDistance = nearD;
+	m_farDistance = farD;
+	float logRatio = log(farD / nearD);
+	m_sliceScale = NUM_SLICES / logRatio;
+	m_sliceBias = -NUM_SLICES * log(nearD) / logRatio;
+	for (int i = 0; i <= NUM_SLICES; i++)
+	{
+		m_sliceDepths[i] = nearD * (float)pow(farD / nearD, (float)i / NUM_SLICES);
+	}
+
+	m_vClusterOffsets.assign(GetNumClusters(), 0);
+	m_vClusterCounts.assign(GetNumClusters(), 0);
+}
+
+void LightClusterGrid::SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up)
+{
+	m_cameraPosition = pos;
+	m_cameraForward = normalize(target - pos);
+	m_cameraRight = normalize(cross(m_cameraForward, up));
+	m_cameraUp = cross(m_cameraRight, m_cameraForward);
+}
+
+vec3 LightClusterGrid::GetViewPosition(const vec3 &worldPosition)
+{
+	vec3 toPosition = worldPosition - m_cameraPosition;
+
+	return vec3(dot(toPosition, m_cameraRight), dot(toPosition, m_cameraUp), -dot(toPosition, m_cameraForward));
+}
+
+void LightClusterGrid::Build(const vector<vec4> &vLights)
+{
+	m_vPairs.clear();
+	m_numLightsBinned = 0;
+
+	for (unsigned int i = 0; i < vLights.size(); i++)
+	{
+		vec3 viewPosition = GetViewPosition(vec3(vLights[i].x, vLights[i].y, vLights[i].z));
+		float radius = vLights[i].w;
+		float depth = -viewPosition.z;
+
+		if (depth + radius < MIN_LIGHT_DEPTH)
+		{
+			// Behind the camera
+			continue;
+		}
+
+		int firstSlice = GetSlice(depth - radius);
+		int lastSlice = GetSlice(depth + radius);
+		bool binned = false;
+
+		for (int slice = firstSlice; slice <= lastSlice; slice++)
+		{
+			// The part of the sphere inside this slice, the first slice reaches the camera and the last one goes on forever
+			// The slice is padded a little, so that a pixel rounded into it by the log in GetSlice() is still covered
+			float sliceNear = (slice == 0) ? MIN_LIGHT_DEPTH : m_sliceDepths[slice] * 0.999f;
+			float sliceFar = (slice == NUM_SLICES - 1) ? depth + radius : m_sliceDepths[slice + 1] * 1.001f;
+			float slabNear = (depth - radius > sliceNear) ? depth - radius : sliceNear;
+			float slabFar = (depth + radius < sliceFar) ? depth + radius : sliceFar;
+			if (slabNear > slabFar)
+			{
+				continue;
+			}
+
+			// The widest cross section of the sphere inside the slab
+			float closestDepth = (depth < slabNear) ? slabNear : ((depth > slabFar) ? slabFar : depth);
+			float crossSection = radius*radius - (closestDepth - depth)*(closestDepth - depth);
+			crossSection = (crossSection > 0.0f) ? sqrt(crossSection) : 0.0f;
+
+			// Project the box around that cross section at both ends of the slab, the extremes are always at one of the ends
+			float minX = (viewPosition.x - crossSection) / ((viewPosition.x - crossSection < 0.0f) ? slabNear : slabFar) / m_tanHalfFovX;
+			float maxX = (viewPosition.x + crossSection) / ((viewPosition.x + crossSection > 0.0f) ? slabNear : slabFar) / m_tanHalfFovX;
+			float minY = (viewPosition.y - crossSection) / ((viewPosition.y - crossSection < 0.0f) ? slabNear : slabFar) / m_tanHalfFovY;
+			float maxY = (viewPosition.y + crossSection) / ((viewPosition.y + crossSection > 0.0f) ? slabNear : slabFar) / m_tanHalfFovY;
+			if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+			{
+				// Off the screen
+				continue;
+			}
+
+			minX = (minX < -1.0f) ? -1.0f : minX;
+			maxX = (maxX > 1.0f) ? 1.0f : maxX;
+			minY = (minY < -1.0f) ? -1.0f : minY;
+			maxY = (maxY > 1.0f) ? 1.0f : maxY;
+
+			int firstTileX = (int)(((minX*0.5f) + 0.5f) * m_screenWidth) / TILE_SIZE;
+			int lastTileX = (int)(((maxX*0.5f) + 0.5f) * m_screenWidth) / TILE_SIZE;
+			int firstTileY = (int)(((minY*0.5f) + 0.5f) * m_screenHeight) / TILE_SIZE;
+			int lastTileY = (int)(((maxY*0.5f) + 0.5f) * m_screenHeight) / TILE_SIZE;
+			lastTileX = (lastTileX >= m_numTilesX) ? m_numTilesX - 1 : lastTileX;
+			lastTileY = (lastTileY >= m_numTilesY) ? m_numTilesY - 1 : lastTileY;
+
+			for (int y = firstTileY; y <= lastTileY; y++)
+			{
+				for (int x = firstTileX; x <= lastTileX; x++)
+				{
+					LightClusterPair pair;
+					pair.m_cluster = (slice*m_numTilesY + y)*m_numTilesX + x;
+					pair.m_light = i;
+					m_vPairs.push_back(pair);
+				}
+			}
+
+			binned = true;
+		}
+
+		if (binned)
+		{
+			m_numLightsBinned++;
+		}
+	}
+
+	// Counting sort of the pairs into the clusters
+	int numClusters = GetNumClusters();
+	for (int i = 0; i < numClusters; i++)
+	{
+		m_vClusterCounts[i] = 0;
+	}
+	for (unsigned int i = 0; i < m_vPairs.size(); i++)
+	{
+		m_vClusterCounts[m_vPairs[i].m_cluster]++;
+	}
+
+	m_numOverflowClusters = 0;
+	m_maxClusterCount = 0;
+	unsigned int offset = 0;
+	for (int i = 0; i < numClusters; i++)
+	{
+		if ((int)m_vClusterCounts[i] > m_maxClusterCount)
+		{
+			m_maxClusterCount = m_vClusterCounts[i];
+		}
+		if (m_vClusterCounts[i] > MAX_CLUSTER_LIGHTS)
+		{
+			m_vClusterCounts[i] = MAX_CLUSTER_LIGHTS;
+			m_numOverflowClusters++;
+		}
+
+		m_vClusterOffsets[i] = offset;
+		offset += m_vClusterCounts[i];
+	}
+
+	m_vLightIndices.resize(offset);
+	m_vClusterFill.assign(numClusters, 0);
+	for (unsigned int i = 0; i < m_vPairs.size(); i++)
+	{
+		unsigned int cluster = m_vPairs[i].m_cluster;
+		if (m_vClusterFill[cluster] < m_vClusterCounts[cluster])
+		{
+			m_vLightIndices[m_vClusterOffsets[cluster] + m_vClusterFill[cluster]] = m_vPairs[i].m_light;
+			m_vClusterFill[cluster]++;
+		}
+	}
+}
+
+// Grid layout
+int LightClusterGrid::GetNumTilesX()
+{
+	return m_numTilesX;
+}
+
+int LightClusterGrid::GetNumTilesY()
+{
+	return m_numTilesY;
+}
+
+int LightClusterGrid::GetNumSlices()
+{
+	return NUM_SLICES;
+}
+
+int LightClusterGrid::GetNumClusters()
+{
+	return m_numTilesX * m_numTilesY * NUM_SLICES;
+}
+
+int LightClusterGrid::GetTileSize()
+{
+	return TILE_SIZE;
+}
+
+float LightClusterGrid::GetSliceScale()
+{
+	return m_sliceScale;
+}
+
+float LightClusterGrid::GetSliceBias()
+{
+	return m_sliceBias;
+}
+
+int LightClusterGrid::GetCluster(float pixelX, float pixelY, float depth)
+{
+	int x = (int)(pixelX / TILE_SIZE);
+	int y = (int)(pixelY / TILE_SIZE);
+	x = (x < 0) ? 0 : ((x >= m_numTilesX) ? m_numTilesX - 1 : x);
+	y = (y < 0) ? 0 : ((y >= m_numTilesY) ? m_numTilesY - 1 : y);
+
+	return (GetSlice(depth)*m_numTilesY + y)*m_numTilesX + x;
+}
+
+unsigned int LightClusterGrid::GetClusterOffset(int cluster)
+{
+	return m_vClusterOffsets[cluster];
+}
+
+unsigned int LightClusterGrid::GetClusterCount(int cluster)
+{
+	return m_vClusterCounts[cluster];
+}
+
+const vector<unsigned int>& LightClusterGrid::GetLightIndices()
+{
+	return m_vLightIndices;
+}
+
+// Statistics for the last build
+int LightClusterGrid::GetNumLightsBinned()
+{
+	return m_numLightsBinned;
+}
+
+int LightClusterGrid::GetNumIndices()
+{
+	return (int)m_vLightIndices.size();
+}
+
+int LightClusterGrid::GetNumOverflowClusters()
+{
+	return m_numOverflowClusters;
+}
+
+int LightClusterGrid::GetMaxClusterCount()
+{
+	return m_maxClusterCount;
+}
+
+int LightClusterGrid::GetSlice(float depth)
+{
+	// Everything closer than the first slice is in it, and everything past the last slice is in that one
+	if (depth <= m_nearDistance)
+	{
+		return 0;
+	}
+
+	int slice = (int)(log(depth)*m_sliceScale + m_sliceBias);
+
+	return (slice >= NUM_SLICES) ? NUM_SLICES - 1 : slice;
+}
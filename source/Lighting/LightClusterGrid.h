@@ -0,0 +1,128 @@
+// ******************************************************************************
+// Filename:    LightClusterGrid.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Bins the dynamic lights into clusters for the deferred lighting. The view
+//   is cut into screen tiles and each tile into depth slices that get thicker
+//   further from the camera. Every light sphere is added to all of the clusters
+//   that it could touch, and the lighting shader then only looks at the lights
+//   in the pixel's own cluster. The grid is built on the CPU and doesn't use
+//   any GL, so it also runs headless.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+using namespace glm;
+
+#include <vector>
+using namespace std;
+
+
+class LightClusterPair
+{
+public:
+	unsigned int m_cluster;
+	unsigned int m_light;
+};
+
+
+class LightClusterGrid
+{
+public:
+	/* Public methods */
+	LightClusterGrid();
+	~LightClusterGrid();
+
+	// The screen size in pixels and the camera projection, the depth slices run from nearD to farD
+	void SetView(int screenWidth, int screenHeight, float fov, float nearD, float farD);
+	// The same camera as gluLookAt()
+	void SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up);
+
+	vec3 GetViewPosition(const vec3 &worldPosition);
+
+	// Each light is a world position and a radius
+	void Build(const vector<vec4> &vLights);
+
+	// Grid layout
+	int GetNumTilesX();
+	int GetNumTilesY();
+	int GetNumSlices();
+	int GetNumClusters();
+	int GetTileSize();
+	// slice = log(depth) * scale + bias
+	float GetSliceScale();
+	float GetSliceBias();
+
+	// The cluster that a pixel falls in, pixels start at the bottom left like gl_FragCoord
+	int GetCluster(float pixelX, float pixelY, float depth);
+
+	// The lights of a cluster are GetLightIndices()[GetClusterOffset(c)] onwards
+	unsigned int GetClusterOffset(int cluster);
+	unsigned int GetClusterCount(int cluster);
+	const vector<unsigned int>& GetLightIndices();
+
+	// Statistics for the last build
+	int GetNumLightsBinned();
+	int GetNumIndices();
+	int GetNumOverflowClusters();
+	int GetMaxClusterCount();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	int GetSlice(float depth);
+
+public:
+	/* Public members */
+	static const int TILE_SIZE = 64;
+	static const int NUM_SLICES = 16;
+	// Must match the loop in the clustered lighting shader, any more lights in a cluster are dropped
+	static const int MAX_CLUSTER_LIGHTS = 64;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_screenWidth;
+	int m_screenHeight;
+	int m_numTilesX;
+	int m_numTilesY;
+
+	float m_tanHalfFovX;
+	float m_tanHalfFovY;
+	float m_nearDistance;
+	float m_farDistance;
+	float m_sliceScale;
+	float m_sliceBias;
+	float m_sliceDepths[NUM_SLICES + 1];
+
+	// The camera basis, the same as the modelview matrix after gluLookAt()
+	vec3 m_cameraPosition;
+	vec3 m_cameraRight;
+	vec3 m_cameraUp;
+	vec3 m_cameraForward;
+
+	vector<unsigned int> m_vClusterOffsets;
+	vector<unsigned int> m_vClusterCounts;
+	vector<unsigned int> m_vLightIndices;
+
+	// Kept between builds so that building doesn't allocate once it has warmed up
+	vector<LightClusterPair> m_vPairs;
+	vector<unsigned int> m_vClusterFill;
+
+	int m_numLightsBinned;
+	int m_numOverflowClusters;
+	int m_maxClusterCount;
+};
@@ -12,15 +12,18 @@
 // ******************************************************************************
 
 #include "LightingManager.h"
+#include "../utils/Profiler.h"
 
-#include <algorithm>
 
 
 LightingManager::LightingManager(Renderer* pRenderer)
 {
 	m_pRenderer = pRenderer;
 
-	m_lightIndexCounter = 0;
+	m_clusterTexturesCreated = false;
+	m_clusterLightsTexture = 0;
+	m_clusterGridTexture = 0;
+	m_clusterIndicesTexture = 0;
 }
 
 LightingManager::~LightingManager()
@@ -30,26 +33,17 @@ LightingManager::~LightingManager()
 
 int LightingManager::GetNumLights()
 {
-	int numLights = (int)m_vpDynamicLightList.size();
-
-	return numLights;
+	return m_dynamicLights.GetNumLights();
 }
 
 DynamicLight* LightingManager::GetLight(int index)
 {
-	DynamicLight* pLight = m_vpDynamicLightList[index];
-
-	return pLight;
+	return m_dynamicLights.GetLight(index);
 }
 
 void LightingManager::ClearLights()
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
-	{
-		delete m_vpDynamicLightList[i];
-		m_vpDynamicLightList[i] = 0;
-	}
-	m_vpDynamicLightList.clear();
+	m_dynamicLights.Clear();
 }
 
 void LightingManager::AddLight(vec3 position, float radius, float diffuseModifier, Colour colour, unsigned int *pID)
@@ -60,13 +54,8 @@ void LightingManager::AddLight(vec3 position, float radius, float diffuseModifie
 	pNewLight->m_radius = radius;
 	pNewLight->m_diffuseScale = diffuseModifier;
 	pNewLight->m_colour = colour;
-	pNewLight->m_lightId = m_lightIndexCounter;
-
-	*pID = m_lightIndexCounter;
 
-	m_lightIndexCounter++;
-
-	m_vpDynamicLightList.push_back(pNewLight);
+	*pID = m_dynamicLights.Add(pNewLight);
 }
 
 void LightingManager::AddDyingLight(vec3 position, float radius, float diffuseModifier, Colour colour, float lifeTime, unsigned int *pID)
@@ -77,129 +66,198 @@ void LightingManager::AddDyingLight(vec3 position, float radius, float diffuseMo
 	pNewLight->m_radius = radius;
 	pNewLight->m_diffuseScale = diffuseModifier;
 	pNewLight->m_colour = colour;
-	pNewLight->m_lightId = m_lightIndexCounter;
 
 	pNewLight->m_lifeTime = lifeTime;
 	pNewLight->m_maxLifeTime = lifeTime;
 	pNewLight->m_dyingLight = true;
 
-	*pID = m_lightIndexCounter;
-
-	m_lightIndexCounter++;
-
-	m_vpDynamicLightList.push_back(pNewLight);
+	*pID = m_dynamicLights.Add(pNewLight);
 }
 
-bool needs_erasing(DynamicLight* aL)
+void LightingManager::RemoveLight(unsigned int lightId)
 {
-	bool needsErase = aL->NeedsErasing();
+	m_dynamicLights.Remove(lightId);
+}
 
-	if(needsErase == true)
+void LightingManager::UpdateLight(unsigned int lightId, vec3 position, float radius, float diffuseModifier, Colour colour)
+{
+	DynamicLight* pLight = m_dynamicLights.Get(lightId);
+	if(pLight != NULL)
 	{
-		delete aL;
+		pLight->m_position = position;
+		pLight->m_radius = radius;
+		pLight->m_diffuseScale = diffuseModifier;
+		pLight->m_colour = colour;
 	}
-
-	return needsErase;
 }
 
-void LightingManager::RemoveLight(unsigned int lightId)
+void LightingManager::UpdateLightRadius(unsigned int lightId, float radius)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	DynamicLight* pLight = m_dynamicLights.Get(lightId);
+	if(pLight != NULL)
 	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->SetErase(true);
-		}
+		pLight->m_radius = radius;
 	}
-
-	// Remove any lights that need to be erased
-	m_vpDynamicLightList.erase( remove_if(m_vpDynamicLightList.begin(), m_vpDynamicLightList.end(), needs_erasing), m_vpDynamicLightList.end() );
 }
 
-void LightingManager::UpdateLight(unsigned int lightId, vec3 position, float radius, float diffuseModifier, Colour colour)
+void LightingManager::UpdateLightDiffuseMultiplier(unsigned int lightId, float diffuseMultiplier)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	DynamicLight* pLight = m_dynamicLights.Get(lightId);
+	if(pLight != NULL)
 	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->m_position = position;
-			m_vpDynamicLightList[i]->m_radius = radius;
-			m_vpDynamicLightList[i]->m_diffuseScale = diffuseModifier;
-			m_vpDynamicLightList[i]->m_colour = colour;
-
-			return;
-		}
+		pLight->m_diffuseScale = diffuseMultiplier;
 	}
 }
 
-void LightingManager::UpdateLightRadius(unsigned int lightId, float radius)
+void LightingManager::UpdateLightPosition(unsigned int lightId, vec3 position)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	DynamicLight* pLight = m_dynamicLights.Get(lightId);
+	if(pLight != NULL)
 	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->m_radius = radius;
-
-			return;
-		}
+		pLight->m_position = position;
 	}
 }
 
-void LightingManager::UpdateLightDiffuseMultiplier(unsigned int lightId, float diffuseMultiplier)
+void LightingManager::UpdateLightColour(unsigned int lightId, Colour colour)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	DynamicLight* pLight = m_dynamicLights.Get(lightId);
+	if(pLight != NULL)
 	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->m_diffuseScale = diffuseMultiplier;
-
-			return;
-		}
+		pLight->m_colour = colour;
 	}
 }
 
-void LightingManager::UpdateLightPosition(unsigned int lightId, vec3 position)
+void LightingManager::Update(float dt)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
-	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->m_position = position;
+	PROFILE_ZONE("LightingManager::Update");
+
+	// Remove any lights that need to be erased
+	m_dynamicLights.RemoveErased();
 
-			return;
-		}
+	for(int i = 0; i < m_dynamicLights.GetNumLights(); i++)
+	{
+		m_dynamicLights.GetLight(i)->Update(dt);
 	}
 }
 
-void LightingManager::UpdateLightColour(unsigned int lightId, Colour colour)
+// Clustered lighting
+void LightingManager::BuildClusterGrid(int screenWidth, int screenHeight, float fov, float nearD, float farD, const vec3 &cameraPos, const vec3 &cameraTarget, const vec3 &cameraUp)
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	PROFILE_ZONE("LightingManager::BuildClusterGrid");
+
+	m_clusterGrid.SetView(screenWidth, screenHeight, fov, nearD, farD);
+	m_clusterGrid.SetCamera(cameraPos, cameraTarget, cameraUp);
+
+	// The light spheres were rendered half a block up, so the lights are moved the same
+	int numLights = m_dynamicLights.GetNumLights();
+	m_vClusterLights.resize(numLights);
+	for(int i = 0; i < numLights; i++)
+	{
+		DynamicLight* pLight = m_dynamicLights.GetLight(i);
+		m_vClusterLights[i] = vec4(pLight->m_position.x, pLight->m_position.y + 0.5f, pLight->m_position.z, pLight->m_radius);
+	}
+
+	m_clusterGrid.Build(m_vClusterLights);
+
+	// Pack the lights, two texels each
+	int lightsHeight = GetClusterLightsTextureHeight();
+	m_vLightTexels.assign(CLUSTER_TEXTURE_WIDTH*lightsHeight*4, 0.0f);
+	for(int i = 0; i < numLights; i++)
 	{
-		if(m_vpDynamicLightList[i]->m_lightId == lightId)
-		{
-			m_vpDynamicLightList[i]->m_colour = colour;
+		DynamicLight* pLight = m_dynamicLights.GetLight(i);
+		vec3 viewPosition = m_clusterGrid.GetViewPosition(vec3(m_vClusterLights[i]));
+
+		float* pTexel = &m_vLightTexels[i*8];
+		pTexel[0] = viewPosition.x;
+		pTexel[1] = viewPosition.y;
+		pTexel[2] = viewPosition.z;
+		pTexel[3] = pLight->m_radius;
+		pTexel[4] = pLight->m_colour.GetRed() * pLight->m_diffuseScale;
+		pTexel[5] = pLight->m_colour.GetGreen() * pLight->m_diffuseScale;
+		pTexel[6] = pLight->m_colour.GetBlue() * pLight->m_diffuseScale;
+		pTexel[7] = pLight->m_colour.GetAlpha() * pLight->m_diffuseScale;
+	}
 
-			return;
-		}
+	// Each cluster is the offset and count of its lights in the index list
+	int numClusters = m_clusterGrid.GetNumClusters();
+	m_vClusterTexels.assign(CLUSTER_TEXTURE_WIDTH*GetClusterGridTextureHeight()*4, 0.0f);
+	for(int i = 0; i < numClusters; i++)
+	{
+		m_vClusterTexels[i*4] = (float)m_clusterGrid.GetClusterOffset(i);
+		m_vClusterTexels[i*4 + 1] = (float)m_clusterGrid.GetClusterCount(i);
+	}
+
+	const vector<unsigned int>& vLightIndices = m_clusterGrid.GetLightIndices();
+	m_vIndexTexels.assign(CLUSTER_TEXTURE_WIDTH*GetClusterIndicesTextureHeight()*4, 0.0f);
+	for(unsigned int i = 0; i < vLightIndices.size(); i++)
+	{
+		m_vIndexTexels[i*4] = (float)vLightIndices[i];
 	}
 }
 
-void LightingManager::Update(float dt)
+void LightingManager::UploadClusterGrid()
 {
-	// Remove any lights that need to be erased
-	m_vpDynamicLightList.erase( remove_if(m_vpDynamicLightList.begin(), m_vpDynamicLightList.end(), needs_erasing), m_vpDynamicLightList.end() );
+	PROFILE_ZONE("LightingManager::UploadClusterGrid");
 
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	if(m_clusterTexturesCreated == false)
 	{
-		m_vpDynamicLightList[i]->Update(dt);
+		m_pRenderer->GenerateEmptyTexture(&m_clusterLightsTexture);
+		m_pRenderer->GenerateEmptyTexture(&m_clusterGridTexture);
+		m_pRenderer->GenerateEmptyTexture(&m_clusterIndicesTexture);
+		m_clusterTexturesCreated = true;
 	}
+
+	m_pRenderer->SetTextureFloatData(m_clusterLightsTexture, CLUSTER_TEXTURE_WIDTH, GetClusterLightsTextureHeight(), &m_vLightTexels[0]);
+	m_pRenderer->SetTextureFloatData(m_clusterGridTexture, CLUSTER_TEXTURE_WIDTH, GetClusterGridTextureHeight(), &m_vClusterTexels[0]);
+	m_pRenderer->SetTextureFloatData(m_clusterIndicesTexture, CLUSTER_TEXTURE_WIDTH, GetClusterIndicesTextureHeight(), &m_vIndexTexels[0]);
+}
+
+LightClusterGrid* LightingManager::GetClusterGrid()
+{
+	return &m_clusterGrid;
+}
+
+unsigned int LightingManager::GetClusterLightsTexture()
+{
+	return m_clusterLightsTexture;
+}
+
+unsigned int LightingManager::GetClusterGridTexture()
+{
+	return m_clusterGridTexture;
+}
+
+unsigned int LightingManager::GetClusterIndicesTexture()
+{
+	return m_clusterIndicesTexture;
+}
+
+int LightingManager::GetClusterLightsTextureHeight()
+{
+	int numTexels = m_dynamicLights.GetNumLights() * 2;
+
+	return (numTexels / CLUSTER_TEXTURE_WIDTH) + 1;
+}
+
+int LightingManager::GetClusterGridTextureHeight()
+{
+	int numTexels = m_clusterGrid.GetNumClusters();
+
+	return (numTexels / CLUSTER_TEXTURE_WIDTH) + 1;
+}
+
+int LightingManager::GetClusterIndicesTextureHeight()
+{
+	int numTexels = m_clusterGrid.GetNumIndices();
+
+	return (numTexels / CLUSTER_TEXTURE_WIDTH) + 1;
 }
 
 void LightingManager::DebugRender()
 {
-	for(unsigned int i = 0; i < m_vpDynamicLightList.size(); i++)
+	for(int i = 0; i < m_dynamicLights.GetNumLights(); i++)
 	{
-		DynamicLight* lpLight = m_vpDynamicLightList[i];
+		DynamicLight* lpLight = m_dynamicLights.GetLight(i);
 
 		float lightRadius = lpLight->m_radius;
 		float r = lpLight->m_colour.GetRed();
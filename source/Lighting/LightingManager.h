@@ -14,15 +14,14 @@
 #pragma once
 
 #include "DynamicLight.h"
+#include "DynamicLightSlotMap.h"
+#include "LightClusterGrid.h"
 #include "../Renderer/Renderer.h"
 
 #include <vector>
 using namespace std;
 
 
-typedef vector<DynamicLight*> DynamicLightList;
-
-
 class LightingManager
 {
 public:
@@ -47,6 +46,19 @@ public:
 
 	void Update(float dt);
 
+	// Clustered lighting, bins the lights for the camera and uploads the grid to the cluster textures
+	void BuildClusterGrid(int screenWidth, int screenHeight, float fov, float nearD, float farD, const vec3 &cameraPos, const vec3 &cameraTarget, const vec3 &cameraUp);
+	void UploadClusterGrid();
+	LightClusterGrid* GetClusterGrid();
+
+	// The cluster textures are CLUSTER_TEXTURE_WIDTH wide, a light is two texels, view position and radius then colour
+	unsigned int GetClusterLightsTexture();
+	unsigned int GetClusterGridTexture();
+	unsigned int GetClusterIndicesTexture();
+	int GetClusterLightsTextureHeight();
+	int GetClusterGridTextureHeight();
+	int GetClusterIndicesTextureHeight();
+
 	void DebugRender();
 
 protected:
@@ -57,6 +69,7 @@ private:
 
 public:
 	/* Public members */
+	static const int CLUSTER_TEXTURE_WIDTH = 1024;
 
 protected:
 	/* Protected members */
@@ -65,7 +78,16 @@ private:
 	/* Private members */
 	Renderer* m_pRenderer;
 
-	DynamicLightList m_vpDynamicLightList;
-
-	unsigned int m_lightIndexCounter;
+	DynamicLightSlotMap m_dynamicLights;
+
+	// Clustered lighting
+	LightClusterGrid m_clusterGrid;
+	vector<vec4> m_vClusterLights;
+	vector<float> m_vLightTexels;
+	vector<float> m_vClusterTexels;
+	vector<float> m_vIndexTexels;
+	bool m_clusterTexturesCreated;
+	unsigned int m_clusterLightsTexture;
+	unsigned int m_clusterGridTexture;
+	unsigned int m_clusterIndicesTexture;
 };
@@ -308,7 +308,9 @@ void Matrix4x4::Inverse() {
 	m[14] = a.m[2]*a.m[5] *a.m[12] - a.m[1]*a.m[6] *a.m[12] - a.m[2]*a.m[4]*a.m[13] + a.m[0]*a.m[6] *a.m[13] + a.m[1]*a.m[4]*a.m[14] - a.m[0]*a.m[5] *a.m[14];
 	m[15] = a.m[1]*a.m[6] *a.m[8]  - a.m[2]*a.m[5] *a.m[8]  + a.m[2]*a.m[4]*a.m[9]  - a.m[0]*a.m[6] *a.m[9]  - a.m[1]*a.m[4]*a.m[10] + a.m[0]*a.m[5] *a.m[10];
 	
-	Scale( *this, 1 / det, *this);
+	// Not Scale(), that resets the diagonal
+	for(int i = 0; i < 16; i++)
+		m[i] /= det;
 }
 
 void Matrix4x4::OrthoNormalize() {
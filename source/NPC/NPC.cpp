@@ -15,6 +15,8 @@
 
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
 
 #include "../Lighting/LightingManager.h"
 #include "../Particles/BlockParticleManager.h"
@@ -25,6 +27,7 @@
 #include "../Projectile/ProjectileManager.h"
 #include "../Projectile/Projectile.h"
 #include "../VoxGame.h"
+#include "../utils/PickingBVH.h"
 
 #include <fstream>
 #include <ostream>
@@ -1531,84 +1534,49 @@ void NPC::CheckEnemyDamageRadius()
 	}
 }
 
-void NPC::CheckProjectileDamageRadius(Projectile* pProjectile)
+bool NPC::CheckProjectileHit(Projectile* pProjectile, float* pHitTime)
 {
 	if(pProjectile->CanAttackNPCs() == false)
 	{
-		return;
+		return false;
 	}
 
 	vec3 projectileHitboxCenter = GetProjectileHitboxCenter();
 
-	vec3 toProjectile = projectileHitboxCenter - pProjectile->GetCenter();
+	// The projectile's whole movement in the last step, not just where it ended up
+	vec3 sweepStart = pProjectile->GetSweepStartCenter();
+	vec3 sweepEnd = pProjectile->GetCenter();
 
-	bool hitByProjectile = false;
 	if(m_eProjectileHitboxType == eProjectileHitboxType_Sphere)
 	{
-		if(length(toProjectile) < GetRadius() + pProjectile->GetRadius())
-		{
-			hitByProjectile = true;
-		}
+		return SweptCollision::SphereSphere(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRadius(), pHitTime);
 	}
 	else if(m_eProjectileHitboxType == eProjectileHitboxType_Cube)
 	{
-		Plane3D planes[6];
-		Matrix4x4 rotationMatrix;
-		rotationMatrix.SetYRotation(DegToRad(GetRotation()));
-		planes[0] = Plane3D(rotationMatrix * vec3(-1.0f, 0.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[1] = Plane3D(rotationMatrix * vec3(1.0f, 0.0f, 0.0f),  projectileHitboxCenter + (rotationMatrix * vec3(-m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[2] = Plane3D(rotationMatrix * vec3(0.0f, -1.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, m_projectileHitboxYLength, 0.0f)));
-		planes[3] = Plane3D(rotationMatrix * vec3(0.0f, 1.0f, 0.0f),  projectileHitboxCenter + (rotationMatrix * vec3(0.0f, -m_projectileHitboxYLength, 0.0f)));
-		planes[4] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, -1.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, m_projectileHitboxZLength)));
-		planes[5] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, 1.0f),  projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, -m_projectileHitboxZLength)));
-
-		float distance;
-		int inside = 0;
-		vec3 normal;
+		vec3 halfLengths = vec3(m_projectileHitboxXLength, m_projectileHitboxYLength, m_projectileHitboxZLength);
 
-		for(int i = 0; i < 6; i++)
-		{
-			distance = planes[i].GetPointDistance(pProjectile->GetCenter());
+		return EntityStep::SweepCubeHitbox(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRotation(), halfLengths, pHitTime);
+	}
 
-			if (distance < -pProjectile->GetRadius())
-			{
-				// Outside...
-			}
-			else if (distance < pProjectile->GetRadius())
-			{
-				// Intersecting..
-				inside++;
-			}
-			else
-			{
-				// Inside...
-				inside++;
-			}
-		}
+	return false;
+}
 
-		if(inside == 6)
-		{
-			hitByProjectile = true;
-		}
-	}
+void NPC::HitByProjectile(Projectile* pProjectile)
+{
+	vec3 knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
+	knockbackDirection = normalize(knockbackDirection);
+	Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
 
-	if(hitByProjectile)
+	if(pProjectile->GetEnemyOwner() != NULL)
 	{
-		vec3 knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
-		knockbackDirection = normalize(knockbackDirection);
-		Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
-
-		if(pProjectile->GetEnemyOwner() != NULL)
-		{
-			// Set NPC target as attacker
-			SetTargetEnemy(pProjectile->GetEnemyOwner());
-		}
+		// Set NPC target as attacker
+		SetTargetEnemy(pProjectile->GetEnemyOwner());
+	}
 
-		float knockbackAmount = 16.0f;
-		DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false);
+	float knockbackAmount = 16.0f;
+	DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false);
 
-		pProjectile->Explode();
-	}
+	pProjectile->Explode();
 }
 
 void NPC::Explode()
@@ -2289,8 +2257,30 @@ bool NPC::IsCreditsNPC()
 	return m_isCreditsNPC;
 }
 
+void NPC::StorePreviousSimulationPosition()
+{
+	m_previousSimulationPosition = m_position;
+}
+
+vec3 NPC::GetInterpolatedPosition(float interpolation)
+{
+	if(interpolation >= 1.0f)
+	{
+		return m_position;
+	}
+
+	return m_previousSimulationPosition + (m_position - m_previousSimulationPosition) * interpolation;
+}
+
 void NPC::CalculateWorldTransformMatrix()
 {
+	CalculateWorldTransformMatrix(1.0f);
+}
+
+void NPC::CalculateWorldTransformMatrix(float interpolation)
+{
+	vec3 position = GetInterpolatedPosition(interpolation);
+
 	m_forward = normalize(m_forward);
 
 	vec3 lForward = m_forward;
@@ -2315,7 +2305,7 @@ void NPC::CalculateWorldTransformMatrix()
 		lRight.x, lRight.y, lRight.z, 0.0f,
 		lUp.x, lUp.y, lUp.z, 0.0f,
 		lForward.x, lForward.y, lForward.z, 0.0f,
-		m_position.x, m_position.y, m_position.z, 1.0f
+		position.x, position.y, position.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(lMatrix);
@@ -3002,10 +2992,13 @@ void NPC::Update(float dt)
 
 	// Update timers
 	UpdateTimers(dt);
+}
 
+void NPC::UpdateAnimationAndPhysics(float dt, DeferredCommandBuffer* pCommands)
+{
 	if(m_pVoxelCharacter != NULL)
 	{
-		m_pVoxelCharacter->Update(dt, m_animationSpeed);
+		m_pVoxelCharacter->Update(dt, m_animationSpeed, pCommands);
 		m_pVoxelCharacter->SetWeaponTrailsOriginMatrix(dt, m_worldMatrix);
 
 		for(int i = 0; i < AnimationSections_NUMSECTIONS; i++)
@@ -3141,7 +3134,7 @@ void NPC::Render(bool outline, bool reflection, bool silhouette)
 		if(m_hoverRender && m_outlineRender == false)
 			OulineColour = Colour(1.0f, 0.0f, 1.0f, 1.0f);
 
-		m_pVoxelCharacter->Render(outline, reflection, silhouette, OulineColour, false);
+		m_pVoxelCharacter->Render(outline, reflection, silhouette, OulineColour);
 		m_pVoxelCharacter->RenderWeapons(outline, reflection, silhouette, OulineColour);
 	m_pRenderer->PopMatrix();
 }
@@ -3393,17 +3386,6 @@ void NPC::RenderSubSelectionNormal()
 	m_pRenderer->PopMatrix();
 }
 
-void NPC::RenderSubSelectionNamePicking()
-{
-	m_pRenderer->PushMatrix();
-		m_pRenderer->MultiplyWorldMatrix(m_worldMatrix);
-
-		Colour OulineColour(1.0f, 1.0f, 0.0f, 1.0f);
-
-		m_pVoxelCharacter->Render(false, false, false, OulineColour, true);
-	m_pRenderer->PopMatrix();
-}
-
 void NPC::RenderProjectileHitboxDebug()
 {
 	m_pRenderer->PushMatrix();
@@ -3576,3 +3558,27 @@ void NPC::AttackEnabledDelayTimerFinished()
 		pProjectile->SetGravityMultiplier(0.0f);
 	}
 }
+
+// Picking
+void NPC::AddPickingVolumes(PickingBVH* pPicking, int pickingId)
+{
+	if(m_pVoxelCharacter == NULL || m_pVoxelCharacter->GetQubicleModel() == NULL)
+	{
+		return;
+	}
+
+	// The model matrices are stored when the character renders, so this picks what was on the screen
+	QubicleBinary* pModel = m_pVoxelCharacter->GetQubicleModel();
+	for(int i = 0; i < pModel->GetNumMatrices(); i++)
+	{
+		QubicleMatrix* pMatrix = pModel->GetQubicleMatrix(i);
+		if(pMatrix->m_removed)
+		{
+			continue;
+		}
+
+		// When sub selecting, each part of the character can be picked on its own
+		int id = GetSubSelectionRender() ? QubicleBinary::SUBSELECTION_NAMEPICKING_OFFSET + i : pickingId;
+		pPicking->AddVoxels(id, pMatrix->m_modelMatrix, pMatrix->m_pColour, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, pMatrix->m_matrixSizeZ);
+	}
+}
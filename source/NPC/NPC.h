@@ -30,6 +30,8 @@ class TextEffectsManager;
 class ItemManager;
 class Enemy;
 class EnemyManager;
+class DeferredCommandBuffer;
+class PickingBVH;
 
 
 enum eNPCState
@@ -156,7 +158,9 @@ public:
 	// Combat
 	void DoDamage(float amount, Colour textColour, vec3 knockbackDirection, float knockbackAmount, bool createParticleHit);
 	void CheckEnemyDamageRadius();
-	void CheckProjectileDamageRadius(Projectile* pProjectile);
+	// When the projectile's movement in the last step hits the projectile hitbox, and the time of impact along that step
+	bool CheckProjectileHit(Projectile* pProjectile, float* pHitTime);
+	void HitByProjectile(Projectile* pProjectile);
 	void Explode();
 	void Respawn();
 
@@ -204,7 +208,10 @@ public:
 	bool IsCreditsNPC();
 
 	// Rendering Helpers
+	void StorePreviousSimulationPosition();
+	vec3 GetInterpolatedPosition(float interpolation);
 	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolation);
 	void SetOutlineRender(bool outline);
 	bool GetOutlineRender();
 	void SetHoverRender(bool hover);
@@ -227,6 +234,8 @@ public:
 	void UpdateNPCState(float dt);
 	void UpdatePhysics(float dt);
 	void Update(float dt);
+	// Only changes this NPC, so that it can run in parallel with the other NPCs, anything else is added to pCommands
+	void UpdateAnimationAndPhysics(float dt, DeferredCommandBuffer* pCommands);
 	void UpdateScreenCoordinates2d(Camera* pCamera);
 	void UpdateSubSelectionNamePicking(int pickingId, bool mousePressed);
 	void UpdateAggroRadius(float dt);
@@ -241,11 +250,13 @@ public:
 	void RenderWaypointsDebug();
 	void RenderSubSelection(bool outline, bool silhouette);
 	void RenderSubSelectionNormal();
-	void RenderSubSelectionNamePicking();
 	void RenderProjectileHitboxDebug();
 	void RenderAggroRadiusDebug();
 	void RenderMovementPositionDebug();
 
+	// Picking
+	void AddPickingVolumes(PickingBVH* pPicking, int pickingId);
+
 protected:
 	/* Protected methods */
 	static void _AttackEnabledTimerFinished(void *apData);
@@ -296,6 +307,7 @@ private:
 	// Player position and movement variables
 	vec3 m_position;
 	vec3 m_previousPosition;
+	vec3 m_previousSimulationPosition;
 	vec3 m_velocity;
 	vec3 m_gravityDirection;
 
@@ -17,7 +17,12 @@
 #include "../Projectile/ProjectileManager.h"
 #include "../Enemy/EnemyManager.h"
 #include "../utils/Random.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
 #include "../VoxGame.h"
+#include "../utils/Profiler.h"
 
 #include <algorithm>
 
@@ -29,6 +34,10 @@ NPCManager::NPCManager(Renderer* pRenderer, ChunkManager* pChunkManager)
 {
 	m_pRenderer = pRenderer;
 	m_pChunkManager = pChunkManager;
+	m_pSpatialGrid = NULL;
+	m_pParallelUpdate = NULL;
+
+	m_updateDeltaTime = 0.0f;
 
 	m_numRenderNPCs = 0;
 }
@@ -85,6 +94,16 @@ void NPCManager::SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryMan
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
 }
 
+void NPCManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+void NPCManager::SetParallelUpdate(ParallelUpdate* pParallelUpdate)
+{
+	m_pParallelUpdate = pParallelUpdate;
+}
+
 // Clearing
 void NPCManager::ClearNPCs()
 {
@@ -96,6 +115,11 @@ void NPCManager::ClearNPCs()
 	}
 	m_vpNPCList.clear();
 	m_NPCMutex.unlock();
+
+	if(m_pSpatialGrid != NULL)
+	{
+		m_pSpatialGrid->ClearLayer(eSpatialGridLayer_NPC);
+	}
 }
 
 void NPCManager::ClearNPCChunkCacheForChunk(Chunk* pChunk)
@@ -127,6 +151,7 @@ NPC* NPCManager::CreateNPC(const char* name, string typeName, string modelName,
 
 	pNewNPC->SetLightingManager(m_pLightingManager);
 	pNewNPC->SetPosition(position);
+	pNewNPC->StorePreviousSimulationPosition();
 
 	float randomScaleAddition = 0.0f;//(scale * 0.05f) * GetRandomNumber(-100, 100, 2) * 0.01f; // Can have a random scale difference of scale of +- 5%
 	pNewNPC->SetScale(scale + randomScaleAddition);
@@ -137,6 +162,11 @@ NPC* NPCManager::CreateNPC(const char* name, string typeName, string modelName,
 	m_vpNPCList.push_back(pNewNPC);
 	m_NPCMutex.unlock();
 
+	if(m_pSpatialGrid != NULL)
+	{
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_NPC, pNewNPC, pNewNPC->GetCenter(), pNewNPC->GetRadius());
+	}
+
 	return pNewNPC;
 }
 
@@ -165,6 +195,11 @@ void NPCManager::DeleteNPC(string name)
 	// Delete
 	if(pDeleteObject != NULL)
 	{
+		if(m_pSpatialGrid != NULL)
+		{
+			m_pSpatialGrid->RemoveObject(eSpatialGridLayer_NPC, pDeleteObject);
+		}
+
 		delete pDeleteObject;
 	}
 }
@@ -231,11 +266,13 @@ void NPCManager::SetEnemyDied(Enemy* pEnemy)
 // Collision
 void NPCManager::PushCollisions(NPC* pPushingNPC, vec3 position, float radius)
 {
-	NPCList::iterator npc_iterator;
+	vector<void*> vpNPCs;
+	m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_NPC, position, radius, &vpNPCs);
+
 	m_NPCMutex.lock();
-	for(npc_iterator = m_vpNPCList.begin(); npc_iterator != m_vpNPCList.end(); ++npc_iterator)
+	for(unsigned int i = 0; i < vpNPCs.size(); i++)
 	{
-		NPC* pNPC = (*npc_iterator);
+		NPC* pNPC = (NPC*)vpNPCs[i];
 
 		if(pNPC == pPushingNPC)
 		{
@@ -247,15 +284,12 @@ void NPCManager::PushCollisions(NPC* pPushingNPC, vec3 position, float radius)
 			continue;
 		}
 
-		vec3 distance = pNPC->GetCenter() - position;
-		float lengthValue = length(distance) - radius - pNPC->GetRadius();
-
-		if(lengthValue < 0.0f)
+		vec3 pushVector;
+		if(EntityStep::GetPushVector(position, radius, pNPC->GetCenter(), pNPC->GetRadius(), &pushVector))
 		{
-			vec3 pushVector = distance;
-			pushVector.y = 0.0f;  // Don't push in Y direction
-			pushVector *= lengthValue;
-			pNPC->SetPosition(pNPC->GetPosition() - pushVector);
+			pNPC->SetPosition(pNPC->GetPosition() + pushVector);
+
+			m_pSpatialGrid->AddObject(eSpatialGridLayer_NPC, pNPC, pNPC->GetCenter(), pNPC->GetRadius());
 		}
 	}
 	m_NPCMutex.unlock();
@@ -458,15 +492,20 @@ bool npc_needs_erasing(NPC* aNPC)
 
 void NPCManager::Update(float dt)
 {
+	PROFILE_ZONE("NPCManager::Update");
+
 	// Remove any NPC that need to be erased
 	m_NPCMutex.lock();
 	m_vpNPCList.erase( remove_if(m_vpNPCList.begin(), m_vpNPCList.end(), npc_needs_erasing), m_vpNPCList.end() );
 	m_NPCMutex.unlock();
 
+	// Register the NPCs with the spatial grid, now that the erased ones are gone
+	UpdateSpatialGrid();
+
 	// Update the mouse hover NPC selection
 	UpdateHoverNPCs();
 
-	// Update all NPCS
+	// Update the NPC behaviour, one NPC at a time since this interacts with the world and the other entities
 	m_NPCMutex.lock();
 	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
 	{
@@ -479,6 +518,17 @@ void NPCManager::Update(float dt)
 		//}
 
 		pNPC->Update(dt);
+	}
+
+	// Update the NPC animation and physics in parallel
+	m_updateDeltaTime = dt;
+	m_pParallelUpdate->Run((int)m_vpNPCList.size(), _UpdateNPCParallel, this);
+
+	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
+	{
+		NPC* pNPC = m_vpNPCList[i];
+
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_NPC, pNPC, pNPC->GetCenter(), pNPC->GetRadius());
 
 		m_NPCMutex.unlock();
 
@@ -499,6 +549,14 @@ void NPCManager::Update(float dt)
 	UpdateNPCProjectileCheck(dt);
 }
 
+void NPCManager::_UpdateNPCParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	NPCManager* pNPCManager = (NPCManager*)pData;
+	NPC* pNPC = pNPCManager->m_vpNPCList[index];
+
+	pNPC->UpdateAnimationAndPhysics(pNPCManager->m_updateDeltaTime, pCommands);
+}
+
 void NPCManager::UpdateScreenCoordinates2d(Camera* pCamera)
 {
 	m_NPCMutex.lock();
@@ -558,6 +616,9 @@ void NPCManager::UpdateHoverNPCs()
 
 void NPCManager::UpdateNPCProjectileCheck(float dt)
 {
+	vector<void*> vpProjectiles;
+	vector<SweptHit> vHits;
+
 	m_NPCMutex.lock();
 	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
 	{
@@ -574,47 +635,149 @@ void NPCManager::UpdateNPCProjectileCheck(float dt)
 		//	continue;
 		//}
 
-		for(int j = 0; j < m_pProjectileManager->GetNumProjectiles(); j++)
+		// Only look at the projectiles that could reach the projectile hitbox, a cube hitbox can turn so use its diagonal.
+		// The corners of the cube grow by more than the projectile radius, so allow a bit extra for the projectile.
+		float hitboxReach = pNPC->GetRadius();
+		if(pNPC->GetProjectileHitboxType() == eProjectileHitboxType_Cube)
 		{
-			Projectile* pProjectile = m_pProjectileManager->GetProjectile(j);
+			float xLength = pNPC->GetProjectileHitboxXLength();
+			float zLength = pNPC->GetProjectileHitboxZLength();
+			hitboxReach = sqrtf(xLength*xLength + zLength*zLength) + m_pSpatialGrid->GetMaxRadius(eSpatialGridLayer_Projectile)*0.5f;
+		}
 
-			if(pProjectile != NULL && pProjectile->GetErase() == false)
+		m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Projectile, pNPC->GetProjectileHitboxCenter(), hitboxReach, &vpProjectiles);
+
+		for(unsigned int j = 0; j < vpProjectiles.size(); j++)
+		{
+			Projectile* pProjectile = (Projectile*)vpProjectiles[j];
+
+			SweptHit hit;
+			if(pProjectile != NULL && pProjectile->GetErase() == false && pNPC->CheckProjectileHit(pProjectile, &hit.m_time))
 			{
-				pNPC->CheckProjectileDamageRadius(pProjectile);
+				hit.m_pObject = pNPC;
+				hit.m_pOther = pProjectile;
+				vHits.push_back(hit);
 			}
 		}
 	}
+
+	// Earliest hits first, a projectile that explodes on the nearest NPC is gone before the NPCs behind it get their turn
+	stable_sort(vHits.begin(), vHits.end(), SweptHit::EarliestFirst);
+	for(unsigned int i = 0; i < vHits.size(); i++)
+	{
+		NPC* pNPC = (NPC*)vHits[i].m_pObject;
+		Projectile* pProjectile = (Projectile*)vHits[i].m_pOther;
+
+		if(pProjectile->GetErase() == false)
+		{
+			pNPC->HitByProjectile(pProjectile);
+		}
+	}
+	m_NPCMutex.unlock();
+}
+
+void NPCManager::UpdateSpatialGrid()
+{
+	m_pSpatialGrid->ClearLayer(eSpatialGridLayer_NPC);
+
+	m_NPCMutex.lock();
+	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
+	{
+		NPC* pNPC = m_vpNPCList[i];
+
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_NPC, pNPC, pNPC->GetCenter(), pNPC->GetRadius());
+	}
 	m_NPCMutex.unlock();
 }
 
-void NPCManager::CalculateWorldTransformMatrix()
+void NPCManager::StorePreviousSimulationPositions()
 {
 	m_NPCMutex.lock();
 	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		pNPC->CalculateWorldTransformMatrix();
+		pNPC->StorePreviousSimulationPosition();
+	}
+	m_NPCMutex.unlock();
+}
+
+void NPCManager::CalculateWorldTransformMatrix(float interpolation)
+{
+	m_NPCMutex.lock();
+	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
+	{
+		NPC* pNPC = m_vpNPCList[i];
+
+		pNPC->CalculateWorldTransformMatrix(interpolation);
 	}
 	m_NPCMutex.unlock();
 }
 
 // Rendering
-void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool renderOnlyOutline, bool renderOnlyNormal, bool shadow)
+// Culling
+void NPCManager::CullNPCs(VisibilityCuller* pVisibilityCuller)
 {
 	m_NPCMutex.lock();
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleNPCs[i].clear();
+	}
+
 	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		if(pNPC->GetSubSelectionRender())
+		unsigned int passMask = pVisibilityCuller->CullSphere(VisibilityType_NPC, pNPC->GetCenter(), pNPC->GetRadius());
+		for(int j = 0; j < RenderPass_NumPasses; j++)
 		{
-			// If we are sub selecting this NPC parts, render this in a different flow
-			if(m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
+			if(passMask & (1 << j))
 			{
-				pNPC->RenderSubSelection(false, true);
+				m_vpVisibleNPCs[j].push_back(pNPC);
 			}
 		}
+	}
+	m_NPCMutex.unlock();
+}
+
+// Picking
+void NPCManager::AddPickingVolumes(PickingBVH* pPicking)
+{
+	NPCList& vpVisibleNPCs = m_vpVisibleNPCs[RenderPass_Main];
+
+	m_NPCMutex.lock();
+	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
+	{
+		NPC* pNPC = m_vpNPCList[i];
+
+		// Only the NPCs that were rendered, the others don't have up to date model matrices
+		if(find(vpVisibleNPCs.begin(), vpVisibleNPCs.end(), pNPC) == vpVisibleNPCs.end())
+		{
+			continue;
+		}
+
+		pNPC->AddPickingVolumes(pPicking, Player::PLAYER_NAME_PICKING + 100 + i);
+	}
+	m_NPCMutex.unlock();
+}
+
+void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool renderOnlyOutline, bool renderOnlyNormal, bool shadow)
+{
+	PROFILE_ZONE("NPCManager::Render");
+
+	// Only the NPCs that CullNPCs() found in this pass's frustum
+	NPCList& vpVisibleNPCs = m_vpVisibleNPCs[shadow ? RenderPass_Shadow : RenderPass_Main];
+
+	m_NPCMutex.lock();
+	for(unsigned int i = 0; i < vpVisibleNPCs.size(); i++)
+	{
+		NPC* pNPC = vpVisibleNPCs[i];
+
+		if(pNPC->GetSubSelectionRender())
+		{
+			// If we are sub selecting this NPC parts, render this in a different flow
+			pNPC->RenderSubSelection(false, true);
+		}
 		else
 		{
 			if(silhouette && (pNPC->GetOutlineRender() == false && pNPC->GetHoverRender() == false))
@@ -650,12 +813,9 @@ void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool ren
 
 			if(pNPC->GetSubSelectionRender() == false)
 			{
-				if(shadow || m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
-				{
-					pNPC->Render(outline, reflection, silhouette);
+				pNPC->Render(outline, reflection, silhouette);
 
-					m_numRenderNPCs++;
-				}
+				m_numRenderNPCs++;
 			}
 
 			m_pRenderer->DisableTransparency();
@@ -732,40 +892,6 @@ void NPCManager::RenderWeaponTrails()
 	m_NPCMutex.unlock();
 }
 
-void NPCManager::RenderNamePicking()
-{
-	m_NPCMutex.lock();
-	for(unsigned int i = 0; i < m_vpNPCList.size(); i++)
-	{
-		NPC* pNPC = m_vpNPCList[i];
-
-		// TODO : Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
-
-		if(pNPC->GetSubSelectionRender())
-		{
-			// If we are sub selecting this NPC parts, render the name picking seperately
-			if(m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
-			{
-				pNPC->RenderSubSelectionNamePicking();
-			}
-		}
-		else
-		{
-			if(m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
-			{
-				m_pRenderer->LoadNameOntoStack(Player::PLAYER_NAME_PICKING + 100 + i);
-				pNPC->Render(false, false, false);
-				m_pRenderer->EndNameStack();
-			}
-		}
-	}
-	m_NPCMutex.unlock();
-}
-
 void NPCManager::RenderOutlineNPCs()
 {
 	m_NPCMutex.lock();
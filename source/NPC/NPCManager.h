@@ -24,6 +24,10 @@ class TextEffectsManager;
 class ItemManager;
 class ProjectileManager;
 class EnemyManager;
+class SpatialGrid;
+class ParallelUpdate;
+class DeferredCommandBuffer;
+class PickingBVH;
 
 class NPCManager
 {
@@ -40,6 +44,8 @@ public:
 	void SetProjectileManager(ProjectileManager* pProjectileManager);
 	void SetEnemyManager(EnemyManager* pEnemyManager);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+	void SetParallelUpdate(ParallelUpdate* pParallelUpdate);
 
 	// Clearing
 	void ClearNPCs();
@@ -77,13 +83,19 @@ public:
 	void UpdateScreenCoordinates2d(Camera* pCamera);
 	void UpdateHoverNPCs();
 	void UpdateNPCProjectileCheck(float dt);
-	void CalculateWorldTransformMatrix();
+	void StorePreviousSimulationPositions();
+	void CalculateWorldTransformMatrix(float interpolation);
+
+	// Culling
+	void CullNPCs(VisibilityCuller* pVisibilityCuller);
+
+	// Picking
+	void AddPickingVolumes(PickingBVH* pPicking);
 
 	// Rendering
 	void Render(bool outline, bool reflection, bool silhouette, bool renderOnlyOutline, bool renderOnlyNormal, bool shadow);
 	void RenderFaces();
 	void RenderWeaponTrails();
-	void RenderNamePicking();
 	void RenderOutlineNPCs();
 	void RenderSubSelectionNPCs();
 	void RenderSubSelectionNormalNPCs();
@@ -95,6 +107,8 @@ protected:
 
 private:
 	/* Private methods */
+	void UpdateSpatialGrid();
+	static void _UpdateNPCParallel(void* pData, int index, DeferredCommandBuffer* pCommands);
 
 public:
 	/* Public members */
@@ -116,10 +130,18 @@ private:
 	ProjectileManager* m_pProjectileManager;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	EnemyManager* m_pEnemyManager;
+	SpatialGrid* m_pSpatialGrid;
+	ParallelUpdate* m_pParallelUpdate;
+
+	// Delta time for the parallel update jobs
+	float m_updateDeltaTime;
 
 	int m_numRenderNPCs;
 
 	// NPC List
 	tthread::mutex m_NPCMutex;
 	NPCList m_vpNPCList;
+
+	// The NPCs that each render pass can see, rebuilt every frame
+	NPCList m_vpVisibleNPCs[RenderPass_NumPasses];
 };
@@ -4,6 +4,10 @@
 // Author:      Steven Ball
 //
 // Purpose:
+//   The per particle data that is only needed by particles that have a parent
+//   emitter, collide with the world or create emitters. The position, velocity,
+//   colour, scale and lifetime of the particles are kept in BlockParticlePool,
+//   which also owns the BlockParticle objects.
 //
 // Revision History:
 //   Initial Revision - 09/11/14
@@ -27,20 +31,15 @@ public:
 	BlockParticle();
 	~BlockParticle();
 
-	void ClearParticleChunkCacheForChunk(Chunk* pChunk);
-
-	void CreateStartingParams();
+	void Reset();
 
-	void CalculateWorldTransformMatrix();
+	void ClearParticleChunkCacheForChunk(Chunk* pChunk);
 
-	void UpdateGridPosition();
+	void UpdateGridPosition(vec3 position);
 	Chunk* GetCachedGridChunkOrFromPosition(vec3 pos);
 
-	void SetFreezeDelayTimer(float timer);
-	void SetWaitAfterUpdateCompleteTimer(float timer);
-
-	// Update
-	void Update(float dt);
+	// Works out the velocity towards the point origin and the tangential velocity, for particles with a parent emitter
+	void UpdatePointVelocity(vec3 position, vec3 velocity, float dt);
 
 protected:
 	/* Protected methods */
@@ -50,69 +49,10 @@ private:
 
 public:
 	/* Public members */
-	bool m_erase;
 
 	// Floor Sliding flag (set manually)
 	bool m_allowFloorSliding;
 
-	// Position
-	vec3 m_position;
-
-	// Position with no world offset
-	vec3 m_position_NoWorldOffset;
-
-	// Velocity
-	vec3 m_velocity;
-	vec3 m_startVelocityVariance;
-
-	// Rotation
-	vec3 m_rotation;
-	vec3 m_startRotation;
-	bool m_randomStartRotation;
-
-	// Angular velocity
-	vec3 m_angularVelocity;
-	vec3 m_startAngularVelocityVariance;
-
-	// Gravity
-	vec3 m_gravityDirection;
-	float m_gravityMultiplier;
-
-	// World matrix
-	Matrix4x4 m_worldMatrix;
-
-	// World matrix with no positional offset, used for viewport rendering without world movements (i.e. characterGUI)
-	Matrix4x4 m_worldMatrix_NoPositionOffset;
-
-	// Particle colour
-	float m_currentRed;
-	float m_startRed;
-	float m_startRedVariance;
-	float m_endRed;
-	float m_endRedVariance;
-	float m_currentGreen;
-	float m_startGreen;
-	float m_startGreenVariance;
-	float m_endGreen;
-	float m_endGreenVariance;
-	float m_currentBlue;
-	float m_startBlue;
-	float m_startBlueVariance;
-	float m_endBlue;
-	float m_endBlueVariance;
-	float m_currentAlpha;
-	float m_startAlpha;
-	float m_startAlphaVariance;
-	float m_endAlpha;
-	float m_endAlphaVariance;
-
-	// Particle scale
-	float m_currentScale;
-	float m_startScale;
-	float m_startScaleVariance;
-	float m_endScale;
-	float m_endScaleVariance;
-
 	// Velocity towards point origin
 	vec3 m_pointOrigin;
 	vec3 m_pointVelocity;
@@ -128,23 +68,12 @@ public:
 	float m_tangentialVelocityYZ;
 	float m_tangentialAccelerationYZ;
 
-	// Lifetime
-	float m_lifeTime;
-	float m_maxLifeTime;
-	float m_lifeTimeVariance;
-
-	// Freeze update / delay
-	float m_freezeUpdateTimer;
-
-	// Wait after complete
-	float m_waitAfterUpdateCompleteTimer;
-
 	// Does particle collide with the world
 	bool m_checkWorldCollisions;
 
 	// Do we destroy this particle instantly on collision with world
 	bool m_destoryOnCollision;
-	
+
 	// Do we only start the life decay after we collide
 	bool m_startLifeDecayOnCollision;
 	bool m_hasCollided;
@@ -390,7 +390,8 @@ void BlockParticleEmitter::Render()
 		}
 		if(m_pParentParticle != NULL)
 		{
-			m_pRenderer->TranslateWorldMatrix(m_pParentParticle->m_position.x, m_pParentParticle->m_position.y, m_pParentParticle->m_position.z);
+			vec3 parentParticlePosition = m_pBlockParticleManager->GetBlockParticlePosition(m_pParentParticle);
+			m_pRenderer->TranslateWorldMatrix(parentParticlePosition.x, parentParticlePosition.y, parentParticlePosition.z);
 		}
 		if(m_particlesFollowEmitter)
 		{
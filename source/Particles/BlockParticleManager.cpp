@@ -11,8 +11,10 @@
 
 #include "BlockParticleManager.h"
 #include "../utils/Random.h"
+#include "../utils/Profiler.h"
 
 #include <algorithm>
+#include <string.h>
 
 
 float vertices[] = { -0.5f, -0.5f, 0.5f, 1.0f, // Front
@@ -74,6 +76,8 @@ BlockParticleManager::BlockParticleManager(Renderer* pRenderer, ChunkManager* pC
 	m_pRenderer = pRenderer;
 	m_pChunkManager = pChunkManager;
 
+	m_pBlockParticlePool = new BlockParticlePool(m_pChunkManager, MAX_NUM_BLOCK_PARTICLES);
+
 	m_particleEffectCounter = 0;
 
 	m_renderWireFrame = false;
@@ -82,8 +86,10 @@ BlockParticleManager::BlockParticleManager(Renderer* pRenderer, ChunkManager* pC
 	m_vertexArray = -1;
 	m_positionBuffer = -1;
 	m_normalBuffer = -1;
-	m_colourBuffer = -1;
-	m_matrixBuffer = -1;
+
+	// Colour (4 floats) followed by the world matrix (16 floats)
+	m_instanceBuffer = -1;
+	m_pRenderer->CreateInstanceBuffer(INSTANCE_FLOATS, &m_instanceBuffer);
 
 	bool shaderLoaded = false;
 	m_instanceShader = -1;
@@ -100,17 +106,16 @@ BlockParticleManager::~BlockParticleManager()
 	ClearBlockParticles();
 	ClearBlockParticleEmitters();
 	ClearBlockParticleEffects();
+
+	delete m_pBlockParticlePool;
+
+	m_pRenderer->DeleteInstanceBuffer(m_instanceBuffer);
 }
 
 // Clearing
 void BlockParticleManager::ClearBlockParticles()
 {
-	for(unsigned int i = 0; i < m_vpBlockParticlesList.size(); i++)
-	{
-		delete m_vpBlockParticlesList[i];
-		m_vpBlockParticlesList[i] = 0;
-	}
-	m_vpBlockParticlesList.clear();
+	m_pBlockParticlePool->ClearParticles();
 }
 
 void BlockParticleManager::ClearBlockParticleEmitters()
@@ -135,21 +140,12 @@ void BlockParticleManager::ClearBlockParticleEffects()
 
 void BlockParticleManager::RemoveEmitterLinkage(BlockParticleEmitter* pEmitter)
 {
-	for(unsigned int i = 0; i < m_vpBlockParticlesList.size(); i++)
-	{
-		if(m_vpBlockParticlesList[i]->m_pParent == pEmitter)
-		{
-			m_vpBlockParticlesList[i]->m_pParent = NULL;
-		}
-	}
+	m_pBlockParticlePool->RemoveEmitterLinkage(pEmitter);
 }
 
 void BlockParticleManager::ClearParticleChunkCacheForChunk(Chunk* pChunk)
 {
-	for (unsigned int i = 0; i < m_vpBlockParticlesList.size(); i++)
-	{
-		m_vpBlockParticlesList[i]->ClearParticleChunkCacheForChunk(pChunk);
-	}
+	m_pBlockParticlePool->ClearParticleChunkCacheForChunk(pChunk);
 }
 
 unsigned int BlockParticleManager::GetInstanceShaderIndex()
@@ -315,7 +311,7 @@ int BlockParticleManager::GetNumBlockParticleEmitters()
 
 int BlockParticleManager::GetNumBlockParticles()
 {
-	int numParticles = (int)m_vpBlockParticlesList.size();
+	int numParticles = m_pBlockParticlePool->GetNumParticles();
 
 	return numParticles;
 }
@@ -323,37 +319,22 @@ int BlockParticleManager::GetNumBlockParticles()
 int BlockParticleManager::GetNumRenderableParticles(bool noWorldOffset)
 {
 	int numparticlesToRender = 0;
-	for(int i = 0; i < (int)m_vpBlockParticlesList.size(); i++)
+	for(int i = 0; i < m_pBlockParticlePool->GetNumParticles(); i++)
 	{
-		// If we are a emitter creation particle, don't render.
-		if(m_vpBlockParticlesList[i]->m_createEmitters == true)
-		{
-			continue;
-		}
-
-		// If we are to be erased, don't render
-		if(m_vpBlockParticlesList[i]->m_erase == true)
+		if(IsBlockParticleRenderable(i, noWorldOffset))
 		{
-			continue;
+			numparticlesToRender++;
 		}
-
-		// If we are rendering the special viewport particles and our parent particle effect viewport flag isn't set, don't render.
-		if (noWorldOffset)
-		{
-			if (m_vpBlockParticlesList[i]->m_pParent == NULL ||
-				m_vpBlockParticlesList[i]->m_pParent->m_pParent == NULL ||
-				m_vpBlockParticlesList[i]->m_pParent->m_pParent->m_renderNoWoldOffsetViewport == false)
-			{
-				continue;
-			}
-		}
-
-		numparticlesToRender++;
 	}
 
 	return numparticlesToRender;
 }
 
+vec3 BlockParticleManager::GetBlockParticlePosition(BlockParticle* pBlockParticle)
+{
+	return m_pBlockParticlePool->GetPosition(m_pBlockParticlePool->GetParticleIndex(pBlockParticle));
+}
+
 // Creation
 BlockParticle* BlockParticleManager::CreateBlockParticleFromEmitterParams(BlockParticleEmitter* pEmitter)
 {
@@ -570,35 +551,48 @@ BlockParticle* BlockParticleManager::CreateBlockParticle(vec3 pos, vec3 posNoWor
 	bool randomStartRotation, vec3 startRotation,  bool worldCollision, bool destoryOnCollision, bool startLifeDecayOnCollision,
 	bool createEmitters, BlockParticleEmitter* pCreatedEmitter)
 {
-	BlockParticle* pBlockParticle = new BlockParticle();
-	pBlockParticle->m_pChunkManager = m_pChunkManager;
-
-	pBlockParticle->m_position = pos;
-	pBlockParticle->m_position_NoWorldOffset = posNoWorldOffset;
-	pBlockParticle->m_gravityDirection = gravityDir;
-	pBlockParticle->m_gravityMultiplier = gravityMultiplier;
-
-	pBlockParticle->m_startScale = startScale;
-	pBlockParticle->m_startScaleVariance = startScaleVariance;
-	pBlockParticle->m_endScale = endScale;
-	pBlockParticle->m_endScaleVariance = endScaleVariance;
-
-	pBlockParticle->m_startRed = startR;
-	pBlockParticle->m_startRedVariance = startRVariance;
-	pBlockParticle->m_startGreen = startG;
-	pBlockParticle->m_startGreenVariance = startGVariance;
-	pBlockParticle->m_startBlue = startB;
-	pBlockParticle->m_startBlueVariance = startBVariance;
-	pBlockParticle->m_startAlpha = startA;
-	pBlockParticle->m_startAlphaVariance = startAVariance;
-	pBlockParticle->m_endRed = endR;
-	pBlockParticle->m_endRedVariance = endRVariance;
-	pBlockParticle->m_endGreen = endG;
-	pBlockParticle->m_endGreenVariance = endGVariance;
-	pBlockParticle->m_endBlue = endB;
-	pBlockParticle->m_endBlueVariance = endBVariance;
-	pBlockParticle->m_endAlpha = endA;
-	pBlockParticle->m_endAlphaVariance = endAVariance;
+	// Random starting params
+	startScale = startScale + ((GetRandomNumber(-1, 1, 2) * startScaleVariance) * startScale);
+	endScale = endScale + ((GetRandomNumber(-1, 1, 2) * endScaleVariance) * endScale);
+
+	startR = startR + (GetRandomNumber(-1, 1, 2) * startRVariance);
+	endR = endR + (GetRandomNumber(-1, 1, 2) * endRVariance);
+
+	startG = startG + (GetRandomNumber(-1, 1, 2) * startGVariance);
+	endG = endG + (GetRandomNumber(-1, 1, 2) * endGVariance);
+
+	startB = startB + (GetRandomNumber(-1, 1, 2) * startBVariance);
+	endB = endB + (GetRandomNumber(-1, 1, 2) * endBVariance);
+
+	startA = startA + (GetRandomNumber(-1, 1, 2) * startAVariance);
+	endA = endA + (GetRandomNumber(-1, 1, 2) * endAVariance);
+
+	lifetime = lifetime + ((GetRandomNumber(-1, 1, 2) * lifetimeVariance) * lifetime);
+
+	vec3 velocity = startVelocity + vec3(GetRandomNumber(-100, 100, 2)*0.01f*startVelocityVariance.x, GetRandomNumber(-100, 100, 2)*0.01f*startVelocityVariance.y, GetRandomNumber(-100, 100, 2)*0.01f*startVelocityVariance.z);
+	vec3 angularVelocity = startAngularVelocity + vec3(GetRandomNumber(-100, 100, 2)*0.01f*startAngularVelocityVariance.x, GetRandomNumber(-100, 100, 2)*0.01f*startAngularVelocityVariance.y, GetRandomNumber(-100, 100, 2)*0.01f*startAngularVelocityVariance.z);
+
+	vec3 rotation = startRotation;
+	if(randomStartRotation)
+	{
+		rotation = vec3(GetRandomNumber(-360, 360, 2), GetRandomNumber(-360, 360, 2), GetRandomNumber(-360, 360, 2));
+	}
+
+	vec3 acceleration = (gravityDir * 9.81f) * gravityMultiplier;
+
+	BlockParticle* pBlockParticle = m_pBlockParticlePool->AddParticle(pos, posNoWorldOffset, velocity, acceleration, rotation, angularVelocity,
+		startR, startG, startB, startA, startScale, endR, endG, endB, endA, endScale, lifetime);
+
+	if(pBlockParticle == NULL)
+	{
+		// The pool is full, don't leave the created emitter without a particle
+		if(pCreatedEmitter != NULL)
+		{
+			pCreatedEmitter->m_erase = true;
+		}
+
+		return NULL;
+	}
 
 	pBlockParticle->m_pointOrigin = pointOrigin;
 	pBlockParticle->m_velocityTowardsPoint = velocityTowardPoint;
@@ -611,32 +605,13 @@ BlockParticle* BlockParticleManager::CreateBlockParticle(vec3 pos, vec3 posNoWor
 	pBlockParticle->m_tangentialVelocityYZ = tangentialVelocityYZ;
 	pBlockParticle->m_tangentialAccelerationYZ = tangentialAccelerationYZ;
 
-	pBlockParticle->m_velocity = startVelocity;
-	pBlockParticle->m_startVelocityVariance = startVelocityVariance;
-
-	pBlockParticle->m_angularVelocity = startAngularVelocity;
-	pBlockParticle->m_startAngularVelocityVariance = startAngularVelocityVariance;
-
-	pBlockParticle->m_lifeTime = lifetime;
-	pBlockParticle->m_maxLifeTime = lifetime;
-	pBlockParticle->m_lifeTimeVariance = lifetimeVariance;
-
 	pBlockParticle->m_checkWorldCollisions = worldCollision;
 	pBlockParticle->m_destoryOnCollision = destoryOnCollision;
 	pBlockParticle->m_startLifeDecayOnCollision = startLifeDecayOnCollision;
 
-	pBlockParticle->m_startRotation = startRotation;
-	pBlockParticle->m_randomStartRotation = randomStartRotation;
-
 	pBlockParticle->m_createEmitters = createEmitters;
 	pBlockParticle->m_pCreatedEmitter = pCreatedEmitter;
 
-	pBlockParticle->m_erase = false;
-
-	pBlockParticle->CreateStartingParams();
-
-	m_vpBlockParticlesList.push_back(pBlockParticle);
-
 	return pBlockParticle;
 }
 
@@ -837,18 +812,6 @@ bool needs_erasing_blockparticle_emitter(BlockParticleEmitter* aB)
 	return needsErase;
 }
 
-bool needs_erasing_blockparticle(BlockParticle* aB)
-{
-	bool needsErase = aB->m_erase;
-
-	if(needsErase == true)
-	{
-		delete aB;
-	}
-
-	return needsErase;
-}
-
 // Rendering modes
 void BlockParticleManager::SetWireFrameRender(bool wireframe)
 {
@@ -863,6 +826,8 @@ void BlockParticleManager::SetInstancedRendering(bool instance)
 // Update
 void BlockParticleManager::Update(float dt)
 {
+	PROFILE_ZONE("BlockParticleManager::Update");
+
 	// Update block particle emitters
 	m_vpBlockParticleEmittersList.erase( remove_if(m_vpBlockParticleEmittersList.begin(), m_vpBlockParticleEmittersList.end(), needs_erasing_blockparticle_emitter), m_vpBlockParticleEmittersList.end() );
 
@@ -894,30 +859,14 @@ void BlockParticleManager::Update(float dt)
 
 
 	// Update block particles
-	for(unsigned int i = 0; i < m_vpBlockParticlesList.size(); i++)
-	{
-		BlockParticle* lpBlockParticle = m_vpBlockParticlesList[i];
-
-		if(lpBlockParticle->m_lifeTime <= 0.0f)
-		{
-			if(lpBlockParticle->m_waitAfterUpdateCompleteTimer <= 0.0f)
-			{
-				// If we have elapsed our timer, then erase the effect and continue
-				lpBlockParticle->m_erase = true;
-
-				continue;
-			}
-		}
-
-		lpBlockParticle->Update(dt);
-	}
-
-	m_vpBlockParticlesList.erase( remove_if(m_vpBlockParticlesList.begin(), m_vpBlockParticlesList.end(), needs_erasing_blockparticle), m_vpBlockParticlesList.end() );
+	m_pBlockParticlePool->Update(dt);
 }
 
 // Rendering
 void BlockParticleManager::Render(bool noWorldOffset)
 {
+	PROFILE_ZONE("BlockParticleManager::Render");
+
 	if (m_instanceRendering && m_instanceShader != -1)
 	{
 		RenderInstanced(noWorldOffset);
@@ -936,149 +885,38 @@ void BlockParticleManager::RenderInstanced(bool noWorldOffset)
 	GLint in_color = glGetAttribLocation(pShader->GetProgramObject(), "in_color");
 	GLint in_model_matrix = glGetAttribLocation(pShader->GetProgramObject(), "in_model_matrix");
 
-	int numBlockParticles = (int)m_vpBlockParticlesList.size();
+	int numBlockParticles = m_pBlockParticlePool->GetNumParticles();
 	int numBlockParticlesRender = GetNumRenderableParticles(noWorldOffset);
 	if (numBlockParticlesRender > 0)
 	{
-		float* newMatrices = new float[16 * numBlockParticlesRender];
-		float* newColors = new float[4 * numBlockParticlesRender];
+		float* pInstanceData = m_pRenderer->GetInstanceBufferData(m_instanceBuffer, numBlockParticlesRender);
 
 		int counter = 0;
 		for (int i = 0; i < numBlockParticles; i++)
 		{
-			// If we are a emitter creation particle, don't render.
-			if (m_vpBlockParticlesList[i]->m_createEmitters == true)
+			if (IsBlockParticleRenderable(i, noWorldOffset) == false)
 			{
 				continue;
 			}
 
-			// If we are to be erased, don't render
-			if (m_vpBlockParticlesList[i]->m_erase == true)
-			{
-				continue;
-			}
+			float* pInstance = &pInstanceData[counter * INSTANCE_FLOATS];
+			m_pBlockParticlePool->GetColour(i, &pInstance[0], &pInstance[1], &pInstance[2], &pInstance[3]);
 
-			// If we are rendering the special viewport particles and our parent particle effect viewport flag isn't set, don't render.
-			if (noWorldOffset)
-			{
-				if (m_vpBlockParticlesList[i]->m_pParent == NULL ||
-					m_vpBlockParticlesList[i]->m_pParent->m_pParent == NULL ||
-					m_vpBlockParticlesList[i]->m_pParent->m_pParent->m_renderNoWoldOffsetViewport == false)
-				{
-					continue;
-				}
-			}
+			Matrix4x4 worldMatrix;
+			m_pBlockParticlePool->CalculateWorldTransformMatrix(i, noWorldOffset, &worldMatrix);
+			memcpy(&pInstance[4], worldMatrix.m, sizeof(float) * 16);
 
-			newColors[counter + 0] = m_vpBlockParticlesList[i]->m_currentRed;
-			newColors[counter + 1] = m_vpBlockParticlesList[i]->m_currentGreen;
-			newColors[counter + 2] = m_vpBlockParticlesList[i]->m_currentBlue;
-			newColors[counter + 3] = m_vpBlockParticlesList[i]->m_currentAlpha;
-			counter += 4;
-		}
-		counter = 0;
-		for (int i = 0; i < numBlockParticles; i++)
-		{
-			// If we are a emitter creation particle, don't render.
-			if (m_vpBlockParticlesList[i]->m_createEmitters == true)
-			{
-				continue;
-			}
-
-			// If we are to be erased, don't render
-			if (m_vpBlockParticlesList[i]->m_erase == true)
-			{
-				continue;
-			}
-
-			// If we are rendering the special viewport particles and our parent particle effect viewport flag isn't set, don't render.
-			if (noWorldOffset)
-			{
-				if (m_vpBlockParticlesList[i]->m_pParent == NULL ||
-					m_vpBlockParticlesList[i]->m_pParent->m_pParent == NULL ||
-					m_vpBlockParticlesList[i]->m_pParent->m_pParent->m_renderNoWoldOffsetViewport == false)
-				{
-					continue;
-				}
-			}
-
-			m_vpBlockParticlesList[i]->CalculateWorldTransformMatrix();
-
-			if (noWorldOffset)
-			{
-				newMatrices[counter + 0] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[0];
-				newMatrices[counter + 1] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[1];
-				newMatrices[counter + 2] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[2];
-				newMatrices[counter + 3] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[3];
-				newMatrices[counter + 4] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[4];
-				newMatrices[counter + 5] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[5];
-				newMatrices[counter + 6] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[6];
-				newMatrices[counter + 7] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[7];
-				newMatrices[counter + 8] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[8];
-				newMatrices[counter + 9] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[9];
-				newMatrices[counter + 10] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[10];
-				newMatrices[counter + 11] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[11];
-				newMatrices[counter + 12] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[12];
-				newMatrices[counter + 13] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[13];
-				newMatrices[counter + 14] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[14];
-				newMatrices[counter + 15] = m_vpBlockParticlesList[i]->m_worldMatrix_NoPositionOffset.m[15];
-			}
-			else
-			{
-				newMatrices[counter + 0] = m_vpBlockParticlesList[i]->m_worldMatrix.m[0];
-				newMatrices[counter + 1] = m_vpBlockParticlesList[i]->m_worldMatrix.m[1];
-				newMatrices[counter + 2] = m_vpBlockParticlesList[i]->m_worldMatrix.m[2];
-				newMatrices[counter + 3] = m_vpBlockParticlesList[i]->m_worldMatrix.m[3];
-				newMatrices[counter + 4] = m_vpBlockParticlesList[i]->m_worldMatrix.m[4];
-				newMatrices[counter + 5] = m_vpBlockParticlesList[i]->m_worldMatrix.m[5];
-				newMatrices[counter + 6] = m_vpBlockParticlesList[i]->m_worldMatrix.m[6];
-				newMatrices[counter + 7] = m_vpBlockParticlesList[i]->m_worldMatrix.m[7];
-				newMatrices[counter + 8] = m_vpBlockParticlesList[i]->m_worldMatrix.m[8];
-				newMatrices[counter + 9] = m_vpBlockParticlesList[i]->m_worldMatrix.m[9];
-				newMatrices[counter + 10] = m_vpBlockParticlesList[i]->m_worldMatrix.m[10];
-				newMatrices[counter + 11] = m_vpBlockParticlesList[i]->m_worldMatrix.m[11];
-				newMatrices[counter + 12] = m_vpBlockParticlesList[i]->m_worldMatrix.m[12];
-				newMatrices[counter + 13] = m_vpBlockParticlesList[i]->m_worldMatrix.m[13];
-				newMatrices[counter + 14] = m_vpBlockParticlesList[i]->m_worldMatrix.m[14];
-				newMatrices[counter + 15] = m_vpBlockParticlesList[i]->m_worldMatrix.m[15];
-			}
-			counter += 16;
+			counter++;
 		}
 
 		glBindVertexArray(m_vertexArray);
 
-		if (m_colourBuffer != -1)
-		{
-			glDeleteBuffers(1, &m_colourBuffer);
-		}
-		// Bind buffer for colors and copy data into buffer
-		glGenBuffers(1, &m_colourBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, m_colourBuffer);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 4 * numBlockParticlesRender, newColors, GL_STATIC_READ);
-		glEnableVertexAttribArray(in_color);
-		glVertexAttribPointer(in_color, 4, GL_FLOAT, GL_FALSE, 4 * 4, 0);
-		glVertexAttribDivisor(in_color, 1);
-
-		if (m_matrixBuffer != -1)
-		{
-			glDeleteBuffers(1, &m_matrixBuffer);
-		}
-		// Bind buffer for matrix and copy data into buffer
-		glGenBuffers(1, &m_matrixBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, m_matrixBuffer);
+		m_pRenderer->UploadInstanceBuffer(m_instanceBuffer, numBlockParticlesRender);
+		m_pRenderer->BindInstanceBufferAttribute(m_instanceBuffer, in_color, 4, 0);
 		for (int i = 0; i < 4; i++)
 		{
-			glVertexAttribPointer(in_model_matrix + i,		// Location
-				4, GL_FLOAT, GL_FALSE,	// vec4
-				4 * 16,						// Stride
-				reinterpret_cast<void *>(16 * i));		// Start offset
-
-			glEnableVertexAttribArray(in_model_matrix + i);
-			glVertexAttribDivisor(in_model_matrix + i, 1);
+			m_pRenderer->BindInstanceBufferAttribute(m_instanceBuffer, in_model_matrix + i, 4, 4 + i * 4);
 		}
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16 * numBlockParticlesRender, newMatrices, GL_STATIC_READ);
-
-		delete newColors;
-		delete newMatrices;
 	}
 
 	// Render the block particle instances
@@ -1130,18 +968,22 @@ void BlockParticleManager::RenderInstanced(bool noWorldOffset)
 void BlockParticleManager::RenderDefault(bool noWorldOffset)
 {
 	// Render all block particles
-	BlockParticlesList::iterator iterator;
-	for (iterator = m_vpBlockParticlesList.begin(); iterator != m_vpBlockParticlesList.end(); ++iterator)
+	for (int particleIndex = 0; particleIndex < m_pBlockParticlePool->GetNumParticles(); particleIndex++)
 	{
-		BlockParticle* lpBlockParticle = (*iterator);
+		if (m_pBlockParticlePool->IsErased(particleIndex))
+		{
+			continue;
+		}
 
 		// Update the block's alpha depending on the life left
+		float r, g, b, a;
+		m_pBlockParticlePool->GetColour(particleIndex, &r, &g, &b, &a);
 		for (int i = 0; i < 24; i++)
 		{
-			m_vertexBuffer[i].r = lpBlockParticle->m_currentRed;
-			m_vertexBuffer[i].g = lpBlockParticle->m_currentGreen;
-			m_vertexBuffer[i].b = lpBlockParticle->m_currentBlue;
-			m_vertexBuffer[i].a = lpBlockParticle->m_currentAlpha;
+			m_vertexBuffer[i].r = r;
+			m_vertexBuffer[i].g = g;
+			m_vertexBuffer[i].b = b;
+			m_vertexBuffer[i].a = a;
 		}
 
 		if (m_renderWireFrame)
@@ -1155,23 +997,17 @@ void BlockParticleManager::RenderDefault(bool noWorldOffset)
 			m_pRenderer->SetRenderMode(RM_SOLID);
 		}
 
-		RenderBlockParticle(lpBlockParticle, noWorldOffset);
+		RenderBlockParticle(particleIndex, noWorldOffset);
 	}
 }
 
-void BlockParticleManager::RenderBlockParticle(BlockParticle* pBlockParticle, bool noWorldOffset)
+void BlockParticleManager::RenderBlockParticle(int particleIndex, bool noWorldOffset)
 {
-	pBlockParticle->CalculateWorldTransformMatrix();
+	Matrix4x4 particleMatrix;
+	m_pBlockParticlePool->CalculateWorldTransformMatrix(particleIndex, noWorldOffset, &particleMatrix);
 
 	m_pRenderer->PushMatrix();
-		if (noWorldOffset)
-		{
-			m_pRenderer->MultiplyWorldMatrix(pBlockParticle->m_worldMatrix_NoPositionOffset);
-		}
-		else
-		{
-			m_pRenderer->MultiplyWorldMatrix(pBlockParticle->m_worldMatrix);
-		}		
+		m_pRenderer->MultiplyWorldMatrix(particleMatrix);
 
 		Matrix4x4 worldMatrix;
 		m_pRenderer->GetModelMatrix(&worldMatrix);
@@ -1215,3 +1051,33 @@ void BlockParticleManager::RenderEffects()
 		lpBlockParticleEffect->Render();
 	}
 }
+
+bool BlockParticleManager::IsBlockParticleRenderable(int particleIndex, bool noWorldOffset)
+{
+	BlockParticle* pBlockParticle = m_pBlockParticlePool->GetParticle(particleIndex);
+
+	// If we are a emitter creation particle, don't render.
+	if(pBlockParticle->m_createEmitters == true)
+	{
+		return false;
+	}
+
+	// If we are to be erased, don't render
+	if(m_pBlockParticlePool->IsErased(particleIndex))
+	{
+		return false;
+	}
+
+	// If we are rendering the special viewport particles and our parent particle effect viewport flag isn't set, don't render.
+	if (noWorldOffset)
+	{
+		if (pBlockParticle->m_pParent == NULL ||
+			pBlockParticle->m_pParent->m_pParent == NULL ||
+			pBlockParticle->m_pParent->m_pParent->m_renderNoWoldOffsetViewport == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -20,10 +20,10 @@
 #include "../Renderer/Renderer.h"
 
 #include "BlockParticle.h"
+#include "BlockParticlePool.h"
 #include "BlockParticleEmitter.h"
 #include "BlockParticleEffect.h"
 
-typedef std::vector<BlockParticle*> BlockParticlesList;
 typedef std::vector<BlockParticleEmitter*> BlockParticlesEmitterList;
 typedef std::vector<BlockParticleEffect*> BlockParticleEffectList;
 
@@ -53,6 +53,7 @@ public:
 	int GetNumBlockParticleEmitters();
 	int GetNumBlockParticles();
 	int GetNumRenderableParticles(bool noWorldOffset);
+	vec3 GetBlockParticlePosition(BlockParticle* pBlockParticle);
 
 	// Creation
 	BlockParticle* CreateBlockParticleFromEmitterParams(BlockParticleEmitter* pEmitter);
@@ -90,7 +91,7 @@ public:
 	void Render(bool noWorldOffset);
 	void RenderInstanced(bool noWorldOffset);
 	void RenderDefault(bool noWorldOffset);
-	void RenderBlockParticle(BlockParticle* pBlockParticle, bool noWorldOffset);
+	void RenderBlockParticle(int particleIndex, bool noWorldOffset);
 	void RenderDebug();
 	void RenderEmitters();
 	void RenderEffects();
@@ -100,9 +101,12 @@ protected:
 
 private:
 	/* Private methods */
+	bool IsBlockParticleRenderable(int particleIndex, bool noWorldOffset);
 
 public:
 	/* Public members */
+	static const int MAX_NUM_BLOCK_PARTICLES = 32768;
+	static const int INSTANCE_FLOATS = 20;
 
 protected:
 	/* Protected members */
@@ -123,8 +127,9 @@ private:
 	GLuint m_vertexArray;
 	GLuint m_positionBuffer;
 	GLuint m_normalBuffer;
-	GLuint m_colourBuffer;
-	GLuint m_matrixBuffer;
+
+	// Per particle colour and matrix, streamed each frame
+	unsigned int m_instanceBuffer;
 
 	// Shader
 	unsigned int m_instanceShader;
@@ -133,8 +138,8 @@ private:
 	unsigned int m_blockMaterialID;
 	OGLPositionNormalColourVertex m_vertexBuffer[24];
 
-	// Block particles list
-	BlockParticlesList m_vpBlockParticlesList;
+	// Block particles
+	BlockParticlePool* m_pBlockParticlePool;
 
 	// Block particle emitters list
 	BlockParticlesEmitterList m_vpBlockParticleEmittersList;
@@ -0,0 +1,623 @@
+// ******************************************************************************
+// Filename:    BlockParticlePool.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BlockParticlePool.h"
+#include "BlockParticleEmitter.h"
+#include "BlockParticleEffect.h"
+#include "../blocks/Chunk.h"
+#include "../blocks/ChunkManager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLOCK_PARTICLE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#if defined(BLOCK_PARTICLE_SSE2)
+namespace {
+
+// Picks a where the mask is set and b where it isn't
+inline __m128 SelectLanes(const __m128 mask, const __m128 a, const __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+}
+#endif
+
+
+BlockParticlePool::BlockParticlePool(ChunkManager* pChunkManager, int capacity)
+{
+	m_pChunkManager = pChunkManager;
+
+	m_capacity = capacity;
+	m_numParticles = 0;
+
+	m_pParticles = new BlockParticle[m_capacity];
+	m_pFlags = new unsigned char[m_capacity];
+
+	m_numStreams = 3*7 + 3*eBlockParticleChannel_NUM + 7;
+	m_pStreamData = new float[m_numStreams * m_capacity];
+
+	float* pStream = m_pStreamData;
+	for(int i = 0; i < 3; i++)
+	{
+		m_pPosition[i] = pStream; pStream += m_capacity;
+		m_pPosition_NoWorldOffset[i] = pStream; pStream += m_capacity;
+		m_pVelocity[i] = pStream; pStream += m_capacity;
+		m_pAcceleration[i] = pStream; pStream += m_capacity;
+		m_pPointVelocity[i] = pStream; pStream += m_capacity;
+		m_pRotation[i] = pStream; pStream += m_capacity;
+		m_pAngularVelocity[i] = pStream; pStream += m_capacity;
+	}
+	for(int i = 0; i < eBlockParticleChannel_NUM; i++)
+	{
+		m_pStart[i] = pStream; pStream += m_capacity;
+		m_pEnd[i] = pStream; pStream += m_capacity;
+		m_pCurrent[i] = pStream; pStream += m_capacity;
+	}
+	m_pLifeTime = pStream; pStream += m_capacity;
+	m_pMaxLifeTime = pStream; pStream += m_capacity;
+	m_pFreezeUpdateTimer = pStream; pStream += m_capacity;
+	m_pWaitAfterUpdateCompleteTimer = pStream; pStream += m_capacity;
+	m_pLifeDecay = pStream; pStream += m_capacity;
+	m_pUpdate = pStream; pStream += m_capacity;
+	m_pActive = pStream; pStream += m_capacity;
+
+	for(int i = 0; i < m_capacity; i++)
+	{
+		m_pParticles[i].m_pChunkManager = m_pChunkManager;
+	}
+}
+
+BlockParticlePool::~BlockParticlePool()
+{
+	ClearParticles();
+
+	delete[] m_pParticles;
+	delete[] m_pFlags;
+	delete[] m_pStreamData;
+}
+
+void BlockParticlePool::ClearParticles()
+{
+	while(m_numParticles > 0)
+	{
+		RemoveParticle(m_numParticles - 1);
+	}
+
+	m_vComplexUpdateIndices.clear();
+}
+
+void BlockParticlePool::RemoveEmitterLinkage(BlockParticleEmitter* pEmitter)
+{
+	for(int i = 0; i < m_numParticles; i++)
+	{
+		if(m_pParticles[i].m_pParent == pEmitter)
+		{
+			m_pParticles[i].m_pParent = NULL;
+		}
+	}
+}
+
+void BlockParticlePool::ClearParticleChunkCacheForChunk(Chunk* pChunk)
+{
+	for(int i = 0; i < m_numParticles; i++)
+	{
+		m_pParticles[i].ClearParticleChunkCacheForChunk(pChunk);
+	}
+}
+
+int BlockParticlePool::GetCapacity()
+{
+	return m_capacity;
+}
+
+int BlockParticlePool::GetNumParticles()
+{
+	return m_numParticles;
+}
+
+BlockParticle* BlockParticlePool::AddParticle(vec3 pos, vec3 posNoWorldOffset, vec3 velocity, vec3 acceleration, vec3 rotation, vec3 angularVelocity,
+											  float startR, float startG, float startB, float startA, float startScale,
+											  float endR, float endG, float endB, float endA, float endScale,
+											  float lifetime)
+{
+	if(m_numParticles >= m_capacity)
+	{
+		return NULL;
+	}
+
+	int index = m_numParticles;
+	m_numParticles++;
+
+	for(int i = 0; i < 3; i++)
+	{
+		m_pPosition[i][index] = pos[i];
+		m_pPosition_NoWorldOffset[i][index] = posNoWorldOffset[i];
+		m_pVelocity[i][index] = velocity[i];
+		m_pAcceleration[i][index] = acceleration[i];
+		m_pPointVelocity[i][index] = 0.0f;
+		m_pRotation[i][index] = rotation[i];
+		m_pAngularVelocity[i][index] = angularVelocity[i];
+	}
+
+	m_pStart[eBlockParticleChannel_Red][index] = startR;
+	m_pStart[eBlockParticleChannel_Green][index] = startG;
+	m_pStart[eBlockParticleChannel_Blue][index] = startB;
+	m_pStart[eBlockParticleChannel_Alpha][index] = startA;
+	m_pStart[eBlockParticleChannel_Scale][index] = startScale;
+	m_pEnd[eBlockParticleChannel_Red][index] = endR;
+	m_pEnd[eBlockParticleChannel_Green][index] = endG;
+	m_pEnd[eBlockParticleChannel_Blue][index] = endB;
+	m_pEnd[eBlockParticleChannel_Alpha][index] = endA;
+	m_pEnd[eBlockParticleChannel_Scale][index] = endScale;
+	for(int i = 0; i < eBlockParticleChannel_NUM; i++)
+	{
+		m_pCurrent[i][index] = m_pStart[i][index];
+	}
+
+	m_pLifeTime[index] = lifetime;
+	m_pMaxLifeTime[index] = lifetime;
+	m_pFreezeUpdateTimer[index] = 0.0f;
+	m_pWaitAfterUpdateCompleteTimer[index] = 0.0f;
+
+	m_pLifeDecay[index] = 1.0f;
+	m_pUpdate[index] = 1.0f;
+	m_pActive[index] = 0.0f;
+
+	m_pFlags[index] = 0;
+
+	BlockParticle* pParticle = &m_pParticles[index];
+	pParticle->Reset();
+
+	return pParticle;
+}
+
+// Accessors
+BlockParticle* BlockParticlePool::GetParticle(int index)
+{
+	return &m_pParticles[index];
+}
+
+int BlockParticlePool::GetParticleIndex(BlockParticle* pParticle)
+{
+	return (int)(pParticle - m_pParticles);
+}
+
+bool BlockParticlePool::IsErased(int index)
+{
+	return (m_pFlags[index] & eBlockParticleFlag_Erase) != 0;
+}
+
+vec3 BlockParticlePool::GetPosition(int index)
+{
+	return vec3(m_pPosition[0][index], m_pPosition[1][index], m_pPosition[2][index]);
+}
+
+void BlockParticlePool::GetColour(int index, float* r, float* g, float* b, float* a)
+{
+	*r = m_pCurrent[eBlockParticleChannel_Red][index];
+	*g = m_pCurrent[eBlockParticleChannel_Green][index];
+	*b = m_pCurrent[eBlockParticleChannel_Blue][index];
+	*a = m_pCurrent[eBlockParticleChannel_Alpha][index];
+}
+
+void BlockParticlePool::CalculateWorldTransformMatrix(int index, bool noWorldOffset, Matrix4x4* pMatrix)
+{
+	BlockParticle* pParticle = &m_pParticles[index];
+
+	pMatrix->LoadIdentity();
+	pMatrix->SetRotation(DegToRad(m_pRotation[0][index]), DegToRad(m_pRotation[1][index]), DegToRad(m_pRotation[2][index]));
+
+	vec3 pos;
+	if(noWorldOffset)
+	{
+		// Non-world matrix that doesn't contain the world positional offset, i.e only local to the particle's emitter and effect
+		pos = vec3(m_pPosition_NoWorldOffset[0][index], m_pPosition_NoWorldOffset[1][index], m_pPosition_NoWorldOffset[2][index]);
+		if(pParticle->m_pParent != NULL && pParticle->m_pParent->m_particlesFollowEmitter)
+		{
+			// If we have a parent and we are locked to their position
+			pos += pParticle->m_pParent->m_position;
+
+			if(pParticle->m_pParent->m_pParent != NULL)
+			{
+				// If our emitter's parent effect has a position offset
+				pos += pParticle->m_pParent->m_pParent->m_position_NoWorldOffset;
+			}
+		}
+	}
+	else
+	{
+		// Full world positional matrix
+		pos = GetPosition(index);
+		if(pParticle->m_pParent != NULL && pParticle->m_pParent->m_particlesFollowEmitter)
+		{
+			// If we have a parent and we are locked to their position
+			pos += pParticle->m_pParent->m_position;
+
+			if(pParticle->m_pParent->m_pParent != NULL)
+			{
+				// If our emitter's parent effect has a position offset
+				pos += pParticle->m_pParent->m_pParent->m_position;
+			}
+		}
+	}
+
+	pMatrix->SetTranslation(pos);
+
+	float scale = m_pCurrent[eBlockParticleChannel_Scale][index];
+	Matrix4x4 scaleMat;
+	scaleMat.SetScale(vec3(scale, scale, scale));
+
+	*pMatrix = scaleMat * (*pMatrix);
+}
+
+// Update
+void BlockParticlePool::Update(float dt)
+{
+	RemoveErasedParticles();
+
+	UpdateComplexParticles(dt);
+
+	IntegrateParticles(dt);
+
+	UpdateComplexParticlesPost(dt);
+}
+
+void BlockParticlePool::RemoveErasedParticles()
+{
+	int i = 0;
+	while(i < m_numParticles)
+	{
+		// Erase particles once their life and wait timer have both run out
+		if((m_pFlags[i] & eBlockParticleFlag_Erase) || (m_pLifeTime[i] <= 0.0f && m_pWaitAfterUpdateCompleteTimer[i] <= 0.0f))
+		{
+			// The last particle is moved into this slot, so look at the same index again
+			RemoveParticle(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void BlockParticlePool::RemoveParticle(int index)
+{
+	BlockParticle* pParticle = &m_pParticles[index];
+	if(pParticle->m_createEmitters == true && pParticle->m_pCreatedEmitter != NULL)
+	{
+		pParticle->m_pCreatedEmitter->m_pParentParticle = NULL;
+		pParticle->m_pCreatedEmitter->m_erase = true;
+	}
+
+	int lastIndex = m_numParticles - 1;
+	if(index != lastIndex)
+	{
+		for(int i = 0; i < m_numStreams; i++)
+		{
+			float* pStream = m_pStreamData + i*m_capacity;
+			pStream[index] = pStream[lastIndex];
+		}
+		m_pFlags[index] = m_pFlags[lastIndex];
+
+		BlockParticle* pLastParticle = &m_pParticles[lastIndex];
+		*pParticle = *pLastParticle;
+
+		// Created emitters follow their particle, point them at its new slot
+		if(pParticle->m_pCreatedEmitter != NULL && pParticle->m_pCreatedEmitter->m_pParentParticle == pLastParticle)
+		{
+			pParticle->m_pCreatedEmitter->m_pParentParticle = pParticle;
+		}
+	}
+
+	m_pParticles[lastIndex].Reset();
+	m_numParticles--;
+}
+
+void BlockParticlePool::UpdateComplexParticles(float dt)
+{
+	m_vComplexUpdateIndices.clear();
+
+	for(int i = 0; i < m_numParticles; i++)
+	{
+		BlockParticle* pParticle = &m_pParticles[i];
+
+		// The parent emitter is set after the particle is added, so work out which particles need this pass on their first update
+		if((m_pFlags[i] & eBlockParticleFlag_Classified) == 0)
+		{
+			m_pFlags[i] |= eBlockParticleFlag_Classified;
+
+			if(pParticle->m_pParent != NULL || pParticle->m_checkWorldCollisions || pParticle->m_startLifeDecayOnCollision || pParticle->m_createEmitters)
+			{
+				m_pFlags[i] |= eBlockParticleFlag_Complex;
+
+				// The life is updated here instead of in the integration
+				m_pLifeDecay[i] = 0.0f;
+			}
+		}
+
+		if((m_pFlags[i] & eBlockParticleFlag_Complex) == 0)
+		{
+			continue;
+		}
+
+		m_pUpdate[i] = 0.0f;
+
+		if(pParticle->m_pParent != NULL && pParticle->m_pParent->m_paused == true)
+		{
+			// If our parent emitter is paused, don't update
+			continue;
+		}
+
+		// Update particle life
+		if(pParticle->m_startLifeDecayOnCollision == false || pParticle->m_hasCollided == true)
+		{
+			m_pLifeTime[i] -= dt;
+
+			if(m_pLifeTime[i] < 0.0f)
+			{
+				m_pLifeTime[i] = 0.0f;
+			}
+		}
+
+		// Update grid position and cached chunk pointer
+		if(pParticle->m_checkWorldCollisions)
+		{
+			pParticle->UpdateGridPosition(GetPosition(i));
+
+			if(pParticle->m_pCachedGridChunk == NULL)
+			{
+				pParticle->m_hasCollided = true;
+
+				if(pParticle->m_destoryOnCollision)
+				{
+					m_pFlags[i] |= eBlockParticleFlag_Erase;
+				}
+
+				continue;
+			}
+		}
+
+		// Point origin and tangential velocity, only while we are not frozen and still alive
+		if(pParticle->m_pParent != NULL && m_pFreezeUpdateTimer[i] < 0.0f && m_pLifeTime[i] > 0.0f)
+		{
+			vec3 velocity = vec3(m_pVelocity[0][i], m_pVelocity[1][i], m_pVelocity[2][i]);
+			pParticle->UpdatePointVelocity(GetPosition(i), velocity, dt);
+
+			vec3 pointVelocity = pParticle->m_tangentialVelocity + pParticle->m_pointVelocity;
+			m_pPointVelocity[0][i] = pointVelocity.x;
+			m_pPointVelocity[1][i] = pointVelocity.y;
+			m_pPointVelocity[2][i] = pointVelocity.z;
+		}
+
+		m_pUpdate[i] = 1.0f;
+		m_vComplexUpdateIndices.push_back(i);
+	}
+}
+
+void BlockParticlePool::IntegrateParticles(float dt)
+{
+	int i = 0;
+
+#if defined(BLOCK_PARTICLE_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 timeStep = _mm_set1_ps(dt);
+
+	for(; i + 4 <= m_numParticles; i += 4)
+	{
+		__m128 update = _mm_cmpgt_ps(_mm_loadu_ps(&m_pUpdate[i]), zero);
+		__m128 lifeDecay = _mm_cmpgt_ps(_mm_loadu_ps(&m_pLifeDecay[i]), zero);
+
+		// Update particle life
+		__m128 lifeTime = _mm_loadu_ps(&m_pLifeTime[i]);
+		lifeTime = SelectLanes(lifeDecay, _mm_max_ps(_mm_sub_ps(lifeTime, timeStep), zero), lifeTime);
+
+		// Frozen particles only count down their freeze timer
+		__m128 freezeUpdateTimer = _mm_loadu_ps(&m_pFreezeUpdateTimer[i]);
+		__m128 frozen = _mm_and_ps(update, _mm_cmpge_ps(freezeUpdateTimer, zero));
+		freezeUpdateTimer = SelectLanes(frozen, _mm_sub_ps(freezeUpdateTimer, timeStep), freezeUpdateTimer);
+
+		__m128 active = _mm_andnot_ps(frozen, update);
+		__m128 alive = _mm_and_ps(active, _mm_cmpgt_ps(lifeTime, zero));
+
+		// Dead particles count down their wait timer
+		__m128 waitAfterUpdateCompleteTimer = _mm_loadu_ps(&m_pWaitAfterUpdateCompleteTimer[i]);
+		__m128 waiting = _mm_andnot_ps(alive, _mm_and_ps(active, _mm_cmpgt_ps(waitAfterUpdateCompleteTimer, zero)));
+		waitAfterUpdateCompleteTimer = SelectLanes(waiting, _mm_sub_ps(waitAfterUpdateCompleteTimer, timeStep), waitAfterUpdateCompleteTimer);
+
+		_mm_storeu_ps(&m_pLifeTime[i], lifeTime);
+		_mm_storeu_ps(&m_pFreezeUpdateTimer[i], freezeUpdateTimer);
+		_mm_storeu_ps(&m_pWaitAfterUpdateCompleteTimer[i], waitAfterUpdateCompleteTimer);
+		_mm_storeu_ps(&m_pActive[i], _mm_and_ps(active, one));
+
+		// Position and rotation integration, only the alive particles get a time step
+		__m128 aliveTimeStep = _mm_and_ps(alive, timeStep);
+		for(int axis = 0; axis < 3; axis++)
+		{
+			__m128 velocity = _mm_loadu_ps(&m_pVelocity[axis][i]);
+			velocity = _mm_add_ps(velocity, _mm_mul_ps(_mm_loadu_ps(&m_pAcceleration[axis][i]), aliveTimeStep));
+			_mm_storeu_ps(&m_pVelocity[axis][i], velocity);
+
+			__m128 step = _mm_mul_ps(_mm_add_ps(velocity, _mm_loadu_ps(&m_pPointVelocity[axis][i])), aliveTimeStep);
+			_mm_storeu_ps(&m_pPosition[axis][i], _mm_add_ps(_mm_loadu_ps(&m_pPosition[axis][i]), step));
+			_mm_storeu_ps(&m_pPosition_NoWorldOffset[axis][i], _mm_add_ps(_mm_loadu_ps(&m_pPosition_NoWorldOffset[axis][i]), step));
+
+			__m128 rotationStep = _mm_mul_ps(_mm_loadu_ps(&m_pAngularVelocity[axis][i]), aliveTimeStep);
+			_mm_storeu_ps(&m_pRotation[axis][i], _mm_add_ps(_mm_loadu_ps(&m_pRotation[axis][i]), rotationStep));
+		}
+
+		// Update colour and scale
+		__m128 maxLifeTime = _mm_loadu_ps(&m_pMaxLifeTime[i]);
+		__m128 timeRatio = _mm_div_ps(_mm_add_ps(lifeTime, freezeUpdateTimer), _mm_add_ps(maxLifeTime, freezeUpdateTimer));
+		__m128 blend = _mm_sub_ps(one, timeRatio);
+		for(int channel = 0; channel < eBlockParticleChannel_NUM; channel++)
+		{
+			__m128 start = _mm_loadu_ps(&m_pStart[channel][i]);
+			__m128 end = _mm_loadu_ps(&m_pEnd[channel][i]);
+			__m128 current = _mm_add_ps(start, _mm_mul_ps(_mm_sub_ps(end, start), blend));
+			_mm_storeu_ps(&m_pCurrent[channel][i], SelectLanes(active, current, _mm_loadu_ps(&m_pCurrent[channel][i])));
+		}
+	}
+#endif
+
+	// Whatever is left over that doesn't fill the lanes
+	IntegrateParticlesScalar(dt, i, m_numParticles);
+}
+
+void BlockParticlePool::IntegrateParticlesScalar(float dt, int start, int end)
+{
+	for(int i = start; i < end; i++)
+	{
+		if(m_pLifeDecay[i] > 0.0f)
+		{
+			m_pLifeTime[i] -= dt;
+
+			if(m_pLifeTime[i] < 0.0f)
+			{
+				m_pLifeTime[i] = 0.0f;
+			}
+		}
+
+		m_pActive[i] = 0.0f;
+
+		if(m_pUpdate[i] <= 0.0f)
+		{
+			continue;
+		}
+
+		// If we are frozen, don't do any physics updating
+		if(m_pFreezeUpdateTimer[i] >= 0.0f)
+		{
+			m_pFreezeUpdateTimer[i] -= dt;
+
+			continue;
+		}
+
+		m_pActive[i] = 1.0f;
+
+		if(m_pLifeTime[i] > 0.0f)
+		{
+			// Position and rotation integration
+			for(int axis = 0; axis < 3; axis++)
+			{
+				m_pVelocity[axis][i] += m_pAcceleration[axis][i] * dt;
+
+				float step = (m_pVelocity[axis][i] + m_pPointVelocity[axis][i]) * dt;
+				m_pPosition[axis][i] += step;
+				m_pPosition_NoWorldOffset[axis][i] += step;
+
+				m_pRotation[axis][i] += m_pAngularVelocity[axis][i] * dt;
+			}
+		}
+		else
+		{
+			if(m_pWaitAfterUpdateCompleteTimer[i] > 0.0f)
+			{
+				m_pWaitAfterUpdateCompleteTimer[i] -= dt;
+			}
+		}
+
+		// Update colour and scale
+		float timeRatio = (m_pLifeTime[i] + m_pFreezeUpdateTimer[i]) / (m_pMaxLifeTime[i] + m_pFreezeUpdateTimer[i]);
+		for(int channel = 0; channel < eBlockParticleChannel_NUM; channel++)
+		{
+			m_pCurrent[channel][i] = m_pStart[channel][i] + ((m_pEnd[channel][i] - m_pStart[channel][i]) * (1.0f - timeRatio));
+		}
+	}
+}
+
+void BlockParticlePool::UpdateComplexParticlesPost(float dt)
+{
+	for(unsigned int j = 0; j < m_vComplexUpdateIndices.size(); j++)
+	{
+		int i = m_vComplexUpdateIndices[j];
+		BlockParticle* pParticle = &m_pParticles[i];
+
+		if(m_pActive[i] <= 0.0f)
+		{
+			// Frozen this frame
+			continue;
+		}
+
+		if(m_pLifeTime[i] > 0.0f && pParticle->m_checkWorldCollisions)
+		{
+			int blockX, blockY, blockZ;
+			vec3 blockPos;
+			vec3 particlePos = GetPosition(i);
+			if(pParticle->m_pParent != NULL && pParticle->m_pParent->m_particlesFollowEmitter)
+			{
+				particlePos += pParticle->m_pParent->m_position;
+			}
+
+			Chunk* pChunk = pParticle->GetCachedGridChunkOrFromPosition(particlePos);
+			bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(particlePos.x, particlePos.y, particlePos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
+
+			if(active == true)
+			{
+				pParticle->m_hasCollided = true;
+
+				if(pParticle->m_destoryOnCollision)
+				{
+					m_pFlags[i] |= eBlockParticleFlag_Erase;
+					continue;
+				}
+
+				if(pParticle->m_allowFloorSliding)
+				{
+					// Roll back the integration, since we will intersect the block otherwise
+					m_pPosition[1][i] -= m_pVelocity[1][i] * dt;
+					for(int axis = 0; axis < 3; axis++)
+					{
+						m_pPosition[axis][i] -= m_pPointVelocity[axis][i] * dt;
+						m_pVelocity[axis][i] -= m_pAcceleration[axis][i] * dt;
+
+						// Apply some damping to the rotation and velocity
+						m_pAngularVelocity[axis][i] *= 0.96f;
+						m_pVelocity[axis][i] *= 0.96f;
+					}
+
+					if(m_pVelocity[1][i] <= 0.05f)
+					{
+						m_pVelocity[1][i] = 0.0f;
+					}
+				}
+				else
+				{
+					// Roll back the integration, since we will intersect the block otherwise
+					for(int axis = 0; axis < 3; axis++)
+					{
+						m_pPosition[axis][i] -= (m_pVelocity[axis][i] + m_pPointVelocity[axis][i]) * dt;
+
+						// Apply some damping to the rotation and velocity
+						m_pAngularVelocity[axis][i] *= 0.96f;
+						m_pVelocity[axis][i] *= 0.96f;
+					}
+
+					if(m_pVelocity[1][i] <= 0.05f)
+					{
+						m_pVelocity[0][i] = 0.0f;
+						m_pVelocity[1][i] = 0.0f;
+						m_pVelocity[2][i] = 0.0f;
+					}
+				}
+			}
+		}
+
+		if(pParticle->m_createEmitters == true && pParticle->m_pCreatedEmitter != NULL)
+		{
+			pParticle->m_pCreatedEmitter->m_pParentParticle = pParticle;
+			pParticle->m_pCreatedEmitter->m_position = GetPosition(i);
+		}
+	}
+}
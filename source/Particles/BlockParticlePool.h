@@ -0,0 +1,143 @@
+// ******************************************************************************
+// Filename:    BlockParticlePool.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Fixed size storage for the block particles. The data that every particle
+//   uses each frame (position, velocity, rotation, colour, scale and the
+//   timers) is kept in one array per value, so that the whole pool can be
+//   integrated a few particles at a time with SSE. Anything that needs the
+//   world, the parent emitter or created emitters is done one particle at a
+//   time using the BlockParticle objects, which also live in the pool. Dead
+//   particles are removed by moving the last particle into their slot.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "BlockParticle.h"
+
+#include <vector>
+using namespace std;
+
+// The values that are blended from their start to end value over the particle's life
+enum eBlockParticleChannel
+{
+	eBlockParticleChannel_Red = 0,
+	eBlockParticleChannel_Green,
+	eBlockParticleChannel_Blue,
+	eBlockParticleChannel_Alpha,
+	eBlockParticleChannel_Scale,
+
+	eBlockParticleChannel_NUM,
+};
+
+enum eBlockParticleFlag
+{
+	eBlockParticleFlag_Erase = 1,
+	eBlockParticleFlag_Classified = 2,
+	eBlockParticleFlag_Complex = 4,
+};
+
+
+class BlockParticlePool
+{
+public:
+	/* Public methods */
+	BlockParticlePool(ChunkManager* pChunkManager, int capacity);
+	~BlockParticlePool();
+
+	void ClearParticles();
+
+	void RemoveEmitterLinkage(BlockParticleEmitter* pEmitter);
+
+	void ClearParticleChunkCacheForChunk(Chunk* pChunk);
+
+	int GetCapacity();
+	int GetNumParticles();
+
+	// Returns NULL when the pool is full. Removing particles moves them, so the returned pointer is only valid until the next Update()
+	BlockParticle* AddParticle(vec3 pos, vec3 posNoWorldOffset, vec3 velocity, vec3 acceleration, vec3 rotation, vec3 angularVelocity,
+							   float startR, float startG, float startB, float startA, float startScale,
+							   float endR, float endG, float endB, float endA, float endScale,
+							   float lifetime);
+
+	// Accessors
+	BlockParticle* GetParticle(int index);
+	int GetParticleIndex(BlockParticle* pParticle);
+	bool IsErased(int index);
+	vec3 GetPosition(int index);
+	void GetColour(int index, float* r, float* g, float* b, float* a);
+	void CalculateWorldTransformMatrix(int index, bool noWorldOffset, Matrix4x4* pMatrix);
+
+	// Update
+	void Update(float dt);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void RemoveErasedParticles();
+	void RemoveParticle(int index);
+
+	// Life, world collision and point velocity for the particles that need more than the integration, before the integration
+	void UpdateComplexParticles(float dt);
+
+	// Freeze and wait timers, position, velocity, rotation, colour and scale for every particle
+	void IntegrateParticles(float dt);
+	void IntegrateParticlesScalar(float dt, int start, int end);
+
+	// World collision response and created emitters, after the integration
+	void UpdateComplexParticlesPost(float dt);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	ChunkManager* m_pChunkManager;
+
+	int m_capacity;
+	int m_numParticles;
+
+	BlockParticle* m_pParticles;
+	unsigned char* m_pFlags;
+
+	// One array per value, all allocated together
+	int m_numStreams;
+	float* m_pStreamData;
+
+	float* m_pPosition[3];
+	float* m_pPosition_NoWorldOffset[3];
+	float* m_pVelocity[3];
+	float* m_pAcceleration[3];
+	float* m_pPointVelocity[3]; // Velocity towards the point origin plus the tangential velocity
+	float* m_pRotation[3];
+	float* m_pAngularVelocity[3];
+
+	float* m_pStart[eBlockParticleChannel_NUM];
+	float* m_pEnd[eBlockParticleChannel_NUM];
+	float* m_pCurrent[eBlockParticleChannel_NUM];
+
+	float* m_pLifeTime;
+	float* m_pMaxLifeTime;
+	float* m_pFreezeUpdateTimer;
+	float* m_pWaitAfterUpdateCompleteTimer;
+
+	// 1.0f or 0.0f per particle, so that the integration can mask with them
+	float* m_pLifeDecay;
+	float* m_pUpdate;
+	float* m_pActive;
+
+	// The complex particles that were updated this frame, for the post integration pass
+	vector<int> m_vComplexUpdateIndices;
+};
@@ -10,13 +10,15 @@
 // ******************************************************************************
 
 #include "Player.h"
-#include "../utils/Interpolator.h"
 #include "../blocks/Chunk.h"
 #include "../VoxGame.h"
 #include "../utils/Random.h"
+#include "../utils/Profiler.h"
 #include <glm/detail/func_geometric.hpp>
 
 const vec3 Player::PLAYER_CENTER_OFFSET = vec3(0.0f, 1.525f, 0.0f);
+const float Player::BLOCK_SELECTION_DISTANCE = 2.725f;
+const float Player::BLOCK_PLACEMENT_DISTANCE = 4.35f;
 
 
 Player::Player(Renderer* pRenderer, ChunkManager* pChunkManager, QubicleBinaryManager* pQubicleBinaryManager, LightingManager* pLightingManager, BlockParticleManager* pBlockParticleManager)
@@ -38,6 +40,13 @@ Player::Player(Renderer* pRenderer, ChunkManager* pChunkManager, QubicleBinaryMa
 	m_pVoxelCharacter = new VoxelCharacter(m_pRenderer, m_pQubicleBinaryManager);
 	m_pCharacterBackup = new QubicleBinary(m_pRenderer);
 
+	// The chunks and items that the player collides with
+	m_stepWorld.m_getBlock = _GetStepBlock;
+	m_stepWorld.m_hasFloor = _HasStepFloor;
+	m_stepWorld.m_checkOtherCollisions = _CheckStepItemCollisions;
+	m_stepWorld.m_isUnderWater = _IsStepUnderWater;
+	m_stepWorld.m_pData = this;
+
 	// Reset player
 	ResetPlayer();
 
@@ -131,16 +140,15 @@ void Player::ResetPlayer()
 
 	m_targetForward = m_forward;
 
-	m_position = vec3(8.0f, 8.0f, 8.0f);
-	m_respawnPosition = m_position + vec3(0.0f, 0.1f, 0.0f);
-	m_gravityDirection = vec3(0.0f, -1.0f, 0.0f);
+	m_body.m_position = vec3(8.0f, 8.0f, 8.0f);
+	m_previousSimulationPosition = m_body.m_position;
+	m_respawnPosition = m_body.m_position + vec3(0.0f, 0.1f, 0.0f);
+	m_body.m_gravityDirection = vec3(0.0f, -1.0f, 0.0f);
 
 	// Stepping up single world blocks by walking into them
-	m_bDoStepUpAnimation = false;
-	m_stepUpAnimationYAmount = 0.0f;
-	m_stepUpAnimationPrevious = 0.0f;
-	m_stepUpAnimationYOffset = 0.0f;
-	m_stepUpAdditionYAmountChangedCache = 0.0f;
+	m_body.m_bDoStepUp = false;
+	m_body.m_stepUpElapsed = PlayerStep::STEP_UP_OFFSET_TIME;
+	m_body.m_stepUpPrevious = 0.0f;
 
 	// Grid positioning
 	m_gridPositionX = 0;
@@ -150,14 +158,14 @@ void Player::ResetPlayer()
 	m_pCachedGridChunk = NULL;
 
 	// Ground check
-	m_bIsOnGround = false;
-	m_groundCheckTimer = 0.0f;
+	m_body.m_bIsOnGround = false;
+	m_body.m_groundCheckTimer = 0.0f;
 
 	// Floor particles
 	m_floorParticleTimer = 0.25f;
 
 	// Jumping
-	m_bCanJump = true;
+	m_body.m_bCanJump = true;
 	m_jumpTimer = 0.0f;
 
 	// Dead flag
@@ -306,7 +314,13 @@ string Player::GetModelName()
 
 void Player::SetPosition(vec3 pos)
 {
-	m_position = pos;
+	m_body.m_position = pos;
+	m_previousSimulationPosition = pos;
+}
+
+vec3 Player::GetPosition()
+{
+	return m_body.m_position;
 }
 
 void Player::SetRespawnPosition(vec3 pos)
@@ -321,10 +335,7 @@ vec3 Player::GetRespawnPosition()
 
 vec3 Player::GetCenter()
 {
-	vec3 center = m_position + m_up * m_radius;
-	center -= vec3(0.0f, (m_bDoStepUpAnimation ? 0.0f : m_stepUpAnimationYOffset), 0.0f);
-
-	return center;
+	return m_body.GetCenter();
 }
 
 vec3 Player::GetForwardVector()
@@ -344,12 +355,12 @@ vec3 Player::GetUpVector()
 
 float Player::GetRadius()
 {
-	return m_radius;
+	return m_body.m_radius;
 }
 
 void Player::UpdateRadius()
 {
-	m_radius = m_pVoxelCharacter->GetCharacterScale() / 0.14f;
+	m_body.m_radius = m_pVoxelCharacter->GetCharacterScale() / 0.14f;
 }
 
 void Player::SetForwardVector(vec3 forward)
@@ -507,7 +518,7 @@ void Player::UnloadWeapon(bool left)
 						lightPos = rotationMatrix * lightPos;
 
 						// Translate to position
-						lightPos += m_position;
+						lightPos += m_body.m_position;
 					}
 
 					float scale = m_pVoxelCharacter->GetCharacterScale();
@@ -1078,274 +1089,102 @@ void Player::RefreshStatModifierCacheValues()
 }
 
 // Collision
-bool Player::CheckCollisions(vec3 positionCheck, vec3 previousPosition, vec3 *pNormal, vec3 *pMovement, bool *pStepUpBlock)
+bool Player::_GetStepBlock(const vec3 &position, vec3* pBlockPos, bool* pLoaded, void* pData)
 {
-	vec3 movementCache = *pMovement;
+	Player* pPlayer = (Player*)pData;
 
-	float radius = GetRadius();
-
-	// Item collisions
-	bool itemCollision = m_pItemManager->CheckCollisions(positionCheck, previousPosition, radius, pNormal, pMovement);
-
-	// World collision
-	bool worldCollision = false;
-
-	vec3 floorPosition;
-	if (m_pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
-	{
-		*pMovement = vec3(0.0f, 0.0f, 0.0f);
-		return true;
-	}
-	else
-	{
-		int blockX, blockY, blockZ;
-		vec3 blockPos;
-		int blockXAbove, blockYAbove, blockZAbove;
-		vec3 blockPosAbove;
-		int numChecks = 1 + (int)(radius / (Chunk::BLOCK_RENDER_SIZE* 2.0f));
-		bool canAllStepUp = false;
-		bool firstStepUp = true;
-		for (int x = -numChecks; x <= numChecks; x++)
-		{
-			for (int y = -numChecks; y <= numChecks; y++)
-			{
-				for (int z = -numChecks; z <= numChecks; z++)
-				{
-					bool isStepUp = false;
-					*pNormal = vec3(0.0f, 0.0f, 0.0f);
+	int blockX, blockY, blockZ;
+	Chunk* pChunk = pPlayer->GetCachedGridChunkOrFromPosition(position);
+	bool active = pPlayer->m_pChunkManager->GetBlockActiveFrom3DPosition(position.x, position.y, position.z, pBlockPos, &blockX, &blockY, &blockZ, &pChunk);
 
-					Chunk* pChunk = GetCachedGridChunkOrFromPosition(positionCheck + vec3((Chunk::BLOCK_RENDER_SIZE*2.0f)*x, (Chunk::BLOCK_RENDER_SIZE*2.0f)*y, (Chunk::BLOCK_RENDER_SIZE*2.0f)*z));
-					bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*x), positionCheck.y + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*y), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*z), &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-					bool activeAbove = false;
-					bool activeAbove2 = false;
+	*pLoaded = (pChunk != NULL && pChunk->IsSetup());
 
-					if (active == false)
-					{
-						if (pChunk == NULL || pChunk->IsSetup() == false)
-						{
-							*pMovement = vec3(0.0f, 0.0f, 0.0f);
-							worldCollision = true;
-						}
-					}
-					else if (active == true)
-					{
-						Plane3D planes[6];
-						planes[0] = Plane3D(vec3(-1.0f, 0.0f, 0.0f), vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-						planes[1] = Plane3D(vec3(1.0f, 0.0f, 0.0f), vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-						planes[2] = Plane3D(vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
-						planes[3] = Plane3D(vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
-						planes[4] = Plane3D(vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
-						planes[5] = Plane3D(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
-
-						float distance;
-						int inside = 0;
-						bool insideCache[6];
-
-						for (int i = 0; i < 6; i++)
-						{
-							vec3 pointToCheck = blockPos - previousPosition;
-							distance = planes[i].GetPointDistance(pointToCheck);
-
-							if (distance < -radius)
-							{
-								// Outside...
-								insideCache[i] = false;
-							}
-							else if (distance < radius)
-							{
-								// Intersecting..
-								insideCache[i] = true;
-							}
-							else
-							{
-								// Inside...
-								insideCache[i] = true;
-							}
-						}
-
-						for (int i = 0; i < 6; i++)
-						{
-							vec3 pointToCheck = blockPos - positionCheck;
-							distance = planes[i].GetPointDistance(pointToCheck);
-
-							if (distance < -radius)
-							{
-								// Outside...
-							}
-							else if (distance < radius)
-							{
-								// Intersecting..
-								inside++;
-								if (insideCache[i] == false)
-								{
-									*pNormal += planes[i].mNormal;
-								}
-							}
-							else
-							{
-								// Inside...
-								inside++;
-								if (insideCache[i] == false)
-								{
-									*pNormal += planes[i].mNormal;
-								}
-							}
-						}
+	return active;
+}
 
-						if (inside == 6)
-						{
-							if (y == 0) // We only want to check on the same y-level as the players position.
-							{
-								vec3 posCheck1 = vec3(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*x), positionCheck.y + (Chunk::BLOCK_RENDER_SIZE*2.0f), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*z));
-								vec3 posCheck2 = vec3(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*x), positionCheck.y + (Chunk::BLOCK_RENDER_SIZE*4.0f), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE*2.0f)*z));
-
-								Chunk* pChunkAbove = GetCachedGridChunkOrFromPosition(vec3(posCheck1.x, posCheck1.y, posCheck1.z));
-								activeAbove = m_pChunkManager->GetBlockActiveFrom3DPosition(posCheck1.x, posCheck1.y, posCheck1.z, &blockPosAbove, &blockXAbove, &blockYAbove, &blockZAbove, &pChunkAbove);
-								Chunk* pChunkAbove2 = GetCachedGridChunkOrFromPosition(vec3(posCheck2.x, posCheck2.y, posCheck2.z));
-								activeAbove2 = m_pChunkManager->GetBlockActiveFrom3DPosition(posCheck2.x, posCheck2.y, posCheck2.z, &blockPosAbove, &blockXAbove, &blockYAbove, &blockZAbove, &pChunkAbove2);
-
-								if ((activeAbove == false) && (activeAbove2 == false))
-								{
-									if (firstStepUp)
-									{
-										canAllStepUp = true;
-									}
-
-									isStepUp = true;
-								}
-								else
-								{
-									canAllStepUp = false;
-								}
-
-								firstStepUp = false;
-							}
-
-							if (length(*pNormal) <= 1.0f)
-							{
-								if (length(*pNormal) > 0.0f)
-								{
-									*pNormal = normalize(*pNormal);
-								}
-
-								float dotResult = dot(*pNormal, *pMovement);
-								*pNormal *= dotResult;
-
-								*pMovement -= *pNormal;
-
-								worldCollision = true;
-							}
-						}
-					}
-				}
-			}
-		}
+bool Player::_HasStepFloor(const vec3 &position, void* pData)
+{
+	Player* pPlayer = (Player*)pData;
 
-		*pStepUpBlock = canAllStepUp;
-	}
+	vec3 floorPosition;
+	return pPlayer->m_pChunkManager->FindClosestFloor(position, &floorPosition);
+}
 
-	if (itemCollision)
-		return true;
+bool Player::_CheckStepItemCollisions(const vec3 &position, const vec3 &previousPosition, float radius, vec3* pNormal, vec3* pMovement, void* pData)
+{
+	Player* pPlayer = (Player*)pData;
 
-	if (worldCollision)
-		return true;
+	return pPlayer->m_pItemManager->CheckCollisions(position, previousPosition, radius, pNormal, pMovement);
+}
 
-	*pMovement = movementCache;
+bool Player::_IsStepUnderWater(const vec3 &position, void* pData)
+{
+	Player* pPlayer = (Player*)pData;
 
-	return false;
+	return pPlayer->m_pChunkManager->IsUnderWater(position);
 }
 
 // Selection
 bool Player::GetSelectionBlock(vec3 *blockPos, int* chunkIndex, int* blockX, int* blockY, int* blockZ)
 {
-	float distance = 0.0f;
-	bool collides = false;
-	int interations = 0;
-	float increments = 0.025f;
-
-	while (collides == false && interations < 110)
+	VoxelRayHit hit;
+	if (m_pChunkManager->RayCast(GetCenter() + PLAYER_CENTER_OFFSET, normalize(m_cameraForward), BLOCK_SELECTION_DISTANCE, &hit) == false)
 	{
-		vec3 testPos = GetCenter() + PLAYER_CENTER_OFFSET + normalize(m_cameraForward) * distance;
-
-		Chunk* pChunk = NULL;
-		bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, blockPos, blockX, blockY, blockZ, &pChunk);
-		if (active == true)
-		{
-			collides = true;
-		}
-
-		distance += increments;
-		interations++;
+		return false;
 	}
 
-	return collides;
+	*blockPos = hit.m_blockPosition;
+	*blockX = hit.m_blockX;
+	*blockY = hit.m_blockY;
+	*blockZ = hit.m_blockZ;
+
+	return true;
 }
 
 bool Player::GetPlacementBlock(vec3 *blockPos, int* chunkIndex, int* blockX, int* blockY, int* blockZ)
 {
-	float distance = 0.0f;
-	bool collides = false;
-	int interations = 0;
-	float increments = 0.025f;
-
-	while (collides == false && interations < 175)
+	VoxelRayHit hit;
+	if (m_pChunkManager->RayCast(GetCenter() + PLAYER_CENTER_OFFSET, normalize(m_cameraForward), BLOCK_PLACEMENT_DISTANCE, &hit) == false)
 	{
-		vec3 testPos = GetCenter() + PLAYER_CENTER_OFFSET + normalize(m_cameraForward) * distance;
+		return false;
+	}
 
-		Chunk* pChunk = NULL;
-		bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, blockPos, blockX, blockY, blockZ, &pChunk);
-		if (active == true)
-		{
-			// Get an empty block position
-			vec3 EmptyPos = testPos - normalize(m_cameraForward) * Chunk::BLOCK_RENDER_SIZE;
-			bool active2 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x, EmptyPos.y, EmptyPos.z, blockPos, blockX, blockY, blockZ, &pChunk);
-			Chunk* pChunk = m_pChunkManager->GetChunkFromPosition(EmptyPos.x, EmptyPos.y, EmptyPos.z);
+	// The ray started inside the block, there is no face to place against
+	if (length(hit.m_normal) == 0.0f)
+	{
+		return false;
+	}
 
-			if (pChunk != NULL && active2 == false)
-			{
-				vec3 blockPosTest;
-				int blockXTest;
-				int blockYTest;
-				int blockZTest;
-				bool pBlock1 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x - (Chunk::BLOCK_RENDER_SIZE*2.0f), EmptyPos.y, EmptyPos.z, &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-				bool pBlock2 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x + (Chunk::BLOCK_RENDER_SIZE*2.0f), EmptyPos.y, EmptyPos.z, &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-				bool pBlock3 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x, EmptyPos.y - (Chunk::BLOCK_RENDER_SIZE*2.0f), EmptyPos.z, &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-				bool pBlock4 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x, EmptyPos.y + (Chunk::BLOCK_RENDER_SIZE*2.0f), EmptyPos.z, &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-				bool pBlock5 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x, EmptyPos.y, EmptyPos.z - (Chunk::BLOCK_RENDER_SIZE*2.0f), &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-				bool pBlock6 = m_pChunkManager->GetBlockActiveFrom3DPosition(EmptyPos.x, EmptyPos.y, EmptyPos.z + (Chunk::BLOCK_RENDER_SIZE*2.0f), &blockPosTest, &blockXTest, &blockYTest, &blockZTest, &pChunk);
-
-				// ONLY allow non-diagonal block placements
-				if (pBlock1 == true || pBlock2 == true || pBlock3 == true || pBlock4 == true || pBlock5 == true || pBlock6 == true)
-				{
-					vec3 dist = (*blockPos) - m_position + PLAYER_CENTER_OFFSET;
-					//dist.y = 0.0f;
-					if (length(dist) > m_radius)
-					{
-						collides = true;
-					}
-				}
-			}
-		}
+	// The empty block in front of the face that was hit, it always touches the hit block by a face
+	vec3 emptyPos = hit.m_blockPosition + hit.m_normal * (Chunk::BLOCK_RENDER_SIZE*2.0f);
+	Chunk* pChunk = NULL;
+	bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(emptyPos.x, emptyPos.y, emptyPos.z, blockPos, blockX, blockY, blockZ, &pChunk);
+	if (pChunk == NULL || active == true)
+	{
+		return false;
+	}
 
-		distance += increments;
-		interations++;
+	vec3 dist = (*blockPos) - m_body.m_position + PLAYER_CENTER_OFFSET;
+	if (length(dist) <= m_body.m_radius)
+	{
+		return false;
 	}
 
-	return collides;
+	return true;
 }
 
 // World
 void Player::UpdateGridPosition()
 {
-	int gridPositionX = (int)((m_position.x + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
-	int gridPositionY = (int)((m_position.y + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
-	int gridPositionZ = (int)((m_position.z + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
+	int gridPositionX = (int)((m_body.m_position.x + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
+	int gridPositionY = (int)((m_body.m_position.y + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
+	int gridPositionZ = (int)((m_body.m_position.z + Chunk::BLOCK_RENDER_SIZE) / Chunk::CHUNK_SIZE);
 
-	if (m_position.x <= -0.5f)
+	if (m_body.m_position.x <= -0.5f)
 		gridPositionX -= 1;
-	if (m_position.y <= -0.5f)
+	if (m_body.m_position.y <= -0.5f)
 		gridPositionY -= 1;
-	if (m_position.z <= -0.5f)
+	if (m_body.m_position.z <= -0.5f)
 		gridPositionZ -= 1;
 
 	if (gridPositionX != m_gridPositionX || gridPositionY != m_gridPositionY || gridPositionZ != m_gridPositionZ || m_pCachedGridChunk == NULL)
@@ -1467,7 +1306,7 @@ void Player::StartGame()
 	int gridX;
 	int gridY;
 	int gridZ;
-	m_pChunkManager->GetGridFromPosition(m_position, &gridX, &gridY, &gridZ);
+	m_pChunkManager->GetGridFromPosition(m_body.m_position, &gridX, &gridY, &gridZ);
 
 	// Update initial HUD for player
 	VoxGame::GetInstance()->GetHUD()->UpdatePlayerData();
@@ -1476,7 +1315,7 @@ void Player::StartGame()
 // Movement
 vec3 Player::GetPositionMovementAmount()
 {
-	return m_positionMovementAmount;
+	return m_body.m_positionMovementAmount;
 }
 
 vec3 Player::MoveAbsolute(vec3 direction, const float speed, bool shouldChangeForward)
@@ -1490,50 +1329,7 @@ vec3 Player::MoveAbsolute(vec3 direction, const float speed, bool shouldChangeFo
 	m_targetForward.y = 0.0f;
 	m_targetForward = normalize(m_targetForward);
 
-	vec3 totalAmountMoved;
-
-	vec3 movement = direction;
-	vec3 movementAmount = direction*speed;
-	vec3 pNormal;
-	int numberDivision = 1;
-	while (length(movementAmount) >= 1.0f)
-	{
-		numberDivision++;
-		movementAmount = direction*(speed / numberDivision);
-	}
-	for (int i = 0; i < numberDivision; i++)
-	{
-		float speedToUse = (speed / numberDivision) + ((speed / numberDivision) * i);
-		vec3 posToCheck = GetCenter() + movement*speedToUse;
-
-		if (m_bDoStepUpAnimation == false)
-		{
-			bool stepUp = false;
-			if (CheckCollisions(posToCheck, m_previousPosition, &pNormal, &movement, &stepUp))
-			{
-				if (m_bIsOnGround == true && m_bCanJump == true)  // Only allow step up block animations when we are on the ground and also when we can jump. i.e not in air.
-				{
-					if (stepUp)
-					{
-						if (m_bDoStepUpAnimation == false)
-						{
-							m_bDoStepUpAnimation = true;
-
-							m_stepUpAnimationYAmount = 0.0f;
-							m_stepUpAnimationPrevious = 0.0f;
-							m_stepUpAnimationYOffset = 0.0f;
-							Interpolator::GetInstance()->AddFloatInterpolation(&m_stepUpAnimationYAmount, 0.0f, (Chunk::BLOCK_RENDER_SIZE*2.2f), 0.1f, 0.0f, NULL, _StepUpAnimationFinished, this);
-							Interpolator::GetInstance()->AddFloatInterpolation(&m_stepUpAnimationYOffset, (Chunk::BLOCK_RENDER_SIZE*2.2f), 0.0f, 0.125f, -100.0f);
-						}
-					}
-				}
-			}
-		}
-
-		m_position += (movement * speedToUse);
-
-		totalAmountMoved += (movement * speedToUse);
-	}
+	vec3 totalAmountMoved = PlayerStep::Move(m_stepWorld, &m_body, direction, speed);
 
 	// Change to run animation
 	if (m_bIsChargingAttack == false)
@@ -1587,7 +1383,7 @@ vec3 Player::MoveAbsolute(vec3 direction, const float speed, bool shouldChangeFo
 
 	// Footstep sounds
 	m_footstepSoundDistance -= fabs(speed);
-	if (m_footstepSoundTimer <= 0.0f && m_footstepSoundDistance <= 0.0f && m_bCanJump)
+	if (m_footstepSoundTimer <= 0.0f && m_footstepSoundDistance <= 0.0f && m_body.m_bCanJump)
 	{
 		int footStepSound = (int)eSoundEffect_FootStep01 + m_footstepSoundIndex;
 		VoxGame::GetInstance()->PlaySoundEffect((eSoundEffect)footStepSound);
@@ -1636,12 +1432,12 @@ void Player::Strafe(const float speed)
 
 void Player::Levitate(const float speed)
 {
-	m_force += vec3(0.0f, 60.0f, 0.0f);
+	m_body.m_force += vec3(0.0f, 60.0f, 0.0f);
 }
 
 void Player::StopMoving()
 {
-	if (m_bCanJump)
+	if (m_body.m_bCanJump)
 	{
 		if (m_bIsIdle == false)
 		{
@@ -1747,7 +1543,7 @@ void Player::StopMoving()
 
 void Player::Jump()
 {
-	if (m_bCanJump == false && m_pChunkManager->IsUnderWater(GetCenter()) == false)
+	if (m_body.m_bCanJump == false && m_pChunkManager->IsUnderWater(GetCenter()) == false)
 	{
 		return;
 	}
@@ -1757,17 +1553,17 @@ void Player::Jump()
 		return;
 	}
 
-	if (m_bIsOnGround == false && m_pChunkManager->IsUnderWater(GetCenter()) == false)
+	if (m_body.m_bIsOnGround == false && m_pChunkManager->IsUnderWater(GetCenter()) == false)
 	{
 		return;
 	}
 
-	if (m_bDoStepUpAnimation == true) // Don't allow jumping if we are doing a step up animation
+	if (m_body.m_bDoStepUp == true) // Don't allow jumping if we are doing a step up animation
 	{
 		return;
 	}
 
-	m_bCanJump = false;
+	m_body.m_bCanJump = false;
 	m_jumpTimer = 0.3f;
 
 	float jumpMultiplier = 14.0f;
@@ -1776,7 +1572,7 @@ void Player::Jump()
 		jumpMultiplier = 5.0f;
 	}
 
-	m_velocity += m_up * jumpMultiplier;
+	m_body.m_velocity += m_up * jumpMultiplier;
 
 	// Change to jump animation
 	if (m_bIsChargingAttack == false)
@@ -1797,7 +1593,7 @@ void Player::Jump()
 
 bool Player::CanJump()
 {
-	return m_bCanJump;
+	return m_body.m_bCanJump;
 }
 
 void Player::SetMoveToTargetPosition(vec3 pos)
@@ -1818,7 +1614,7 @@ void Player::SetLookAtTargetAfterMoveToPosition(vec3 lookAt)
 
 void Player::CreateFloorParticles()
 {
-	if (m_bIsOnGround == false)
+	if (m_body.m_bIsOnGround == false)
 	{
 		return;
 	}
@@ -2533,8 +2329,30 @@ void Player::SetThirdPersonMode()
 }
 
 // Rendering Helpers
+void Player::StorePreviousSimulationPosition()
+{
+	m_previousSimulationPosition = m_body.m_position;
+}
+
+vec3 Player::GetInterpolatedPosition(float interpolation)
+{
+	if (interpolation >= 1.0f)
+	{
+		return m_body.m_position;
+	}
+
+	return m_previousSimulationPosition + (m_body.m_position - m_previousSimulationPosition) * interpolation;
+}
+
 void Player::CalculateWorldTransformMatrix()
 {
+	CalculateWorldTransformMatrix(1.0f);
+}
+
+void Player::CalculateWorldTransformMatrix(float interpolation)
+{
+	vec3 position = GetInterpolatedPosition(interpolation);
+
 	m_right = normalize(cross(m_up, m_forward));
 	m_forward = normalize(cross(m_right, m_up));
 
@@ -2543,7 +2361,7 @@ void Player::CalculateWorldTransformMatrix()
 		m_right.x, m_right.y, m_right.z, 0.0f,
 		m_up.x, m_up.y, m_up.z, 0.0f,
 		m_forward.x, m_forward.y, m_forward.z, 0.0f,
-		m_position.x, m_position.y - (m_bDoStepUpAnimation ? 0.0f : m_stepUpAnimationYOffset), m_position.z, 1.0f
+		position.x, position.y - m_body.GetStepUpOffset(), position.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(lMatrix);
@@ -2557,6 +2375,8 @@ void Player::RebuildVoxelCharacter(bool faceMerge)
 // Updating
 void Player::Update(float dt)
 {
+	PROFILE_ZONE("Player::Update");
+
 	// Update grid position
 	UpdateGridPosition();
 
@@ -2626,82 +2446,10 @@ void Player::UpdateAnimations(float dt)
 
 void Player::UpdatePhysics(float dt)
 {
-	m_positionMovementAmount = vec3(0.0f, 0.0f, 0.0f);
-
-	if (m_groundCheckTimer <= 0.0f)
-	{
-		m_bIsOnGround = false;
-	}
-
-	// Step up animation
-	float stepUpAddition = 0.0f;	
-	if (m_bDoStepUpAnimation)
+	if (PlayerStep::UpdatePhysics(m_stepWorld, &m_body, dt))
 	{
-		stepUpAddition = m_stepUpAnimationYAmount - m_stepUpAnimationPrevious;
-		m_position.y += stepUpAddition;
-
-		m_stepUpAnimationPrevious = m_stepUpAnimationYAmount;
+		VoxGame::GetInstance()->PlaySoundEffect(eSoundEffect_JumpLand);
 	}
-
-	// Gravity multiplier
-	float gravityMultiplier = 4.0f;
-	if (m_pChunkManager->IsUnderWater(GetCenter()))
-	{
-		gravityMultiplier = 0.5f;
-	}
-
-	// Integrate velocity
-	vec3 acceleration = m_force + (m_gravityDirection * 9.81f)*gravityMultiplier;
-	m_velocity += acceleration * dt;
-
-	// Check collision
-	{
-		vec3 velocityToUse = m_velocity;
-		vec3 velAmount = velocityToUse*dt;
-		vec3 pNormal;
-		int numberDivision = 1;
-		while (length(velAmount) >= 1.0f)
-		{
-			numberDivision++;
-			velAmount = velocityToUse*(dt / numberDivision);
-		}
-		for (int i = 0; i < numberDivision; i++)
-		{
-			float dtToUse = (dt / numberDivision) + ((dt / numberDivision) * i);
-			vec3 posToCheck = GetCenter() + velocityToUse*dtToUse;
-			bool stepUp = false;
-			if (CheckCollisions(posToCheck, m_previousPosition, &pNormal, &velAmount, &stepUp))
-			{
-				// Reset velocity, we don't have any bounce
-				m_velocity = vec3(0.0f, 0.0f, 0.0f);
-				velocityToUse = vec3(0.0f, 0.0f, 0.0f);
-
-				if (velocityToUse.y <= 0.0f)
-				{
-					m_bIsOnGround = true;
-					m_groundCheckTimer = 0.1f;
-
-					if (m_bCanJump == false)
-					{
-						m_bCanJump = true;
-
-						VoxGame::GetInstance()->PlaySoundEffect(eSoundEffect_JumpLand);
-					}
-				}
-			}
-		}
-
-		// Integrate position
-		m_position += velocityToUse * dt;
-
-		m_positionMovementAmount += vec3(0.0f, stepUpAddition + m_stepUpAdditionYAmountChangedCache, 0.0f);
-		m_positionMovementAmount += velocityToUse * dt;
-	}
-
-	m_stepUpAdditionYAmountChangedCache = 0.0f;
-
-	// Store previous position
-	m_previousPosition = GetCenter();
 }
 
 void Player::UpdateMovement(float dt)
@@ -2733,7 +2481,7 @@ void Player::UpdateMovement(float dt)
 		{
 			LookAtPoint(targetPos);
 
-			vec3 toTarget = m_targetPosition - m_position;
+			vec3 toTarget = m_targetPosition - m_body.m_position;
 			vec3 movementDirection = toTarget;
 			movementDirection.y = 0.0f;
 			movementDirection = normalize(movementDirection);
@@ -2909,12 +2657,6 @@ void Player::UpdateTimers(float dt)
 		m_jumpTimer -= dt;
 	}
 
-	// Ground check timer
-	if (m_groundCheckTimer >= 0.0f)
-	{
-		m_groundCheckTimer -= dt;
-	}
-
 	// Floor particle timer
 	if (m_floorParticleTimer >= 0.0f)
 	{
@@ -3029,7 +2771,7 @@ void Player::UpdateWeaponLights(float dt)
 						lightPos = rotationMatrix * lightPos;
 
 						// Translate to position
-						lightPos += m_position;
+						lightPos += m_body.m_position;
 					}
 
 					float scale = m_pVoxelCharacter->GetCharacterScale();
@@ -3095,7 +2837,7 @@ void Player::UpdateWeaponParticleEffects(float dt)
 						ParticleEffectPos = rotationMatrix * ParticleEffectPos;
 
 						// Translate to position
-						ParticleEffectPos += m_position;
+						ParticleEffectPos += m_body.m_position;
 					}
 
 					m_pBlockParticleManager->UpdateParticleEffectPosition(particleEffectId, ParticleEffectPos, ParticleEffectPos_NoWorldOffset);
@@ -3164,9 +2906,10 @@ void Player::UpdateCombat(float dt)
 	{
 		Projectile* pProjectile = m_pProjectileManager->GetProjectile(j);
 
-		if (pProjectile != NULL && pProjectile->GetErase() == false)
+		float hitTime;
+		if (pProjectile != NULL && pProjectile->GetErase() == false && CheckProjectileHit(pProjectile, &hitTime))
 		{
-			CheckProjectileDamageRadius(pProjectile);
+			HitByProjectile(pProjectile);
 		}
 	}
 }
@@ -3197,6 +2940,8 @@ void Player::UpdateBlockSelection(float dt)
 // Rendering
 void Player::Render()
 {
+	PROFILE_ZONE("Player::Render");
+
 	if (IsDead())
 	{
 		return;
@@ -3214,7 +2959,7 @@ void Player::Render()
 			m_pVoxelCharacter->RenderWeapons(false, false, false, OulineColour);
 		m_pRenderer->PopMatrix();
 
-		m_pVoxelCharacter->Render(false, false, false, OulineColour, false);
+		m_pVoxelCharacter->Render(false, false, false, OulineColour);
 	m_pRenderer->PopMatrix();
 }
 
@@ -3381,7 +3126,7 @@ void Player::RenderDebug()
 				m_pRenderer->ImmediateColourAlpha(1.0f, 1.0f, 1.0f, 1.0f);
 
 				m_pRenderer->RotateWorldMatrix(90.0f, 0.0f, 0.0f);
-				m_pRenderer->DrawSphere(m_radius, 20, 20);
+				m_pRenderer->DrawSphere(m_body.m_radius, 20, 20);
 			m_pRenderer->PopMatrix();
 
 			// Forwards
@@ -3461,7 +3206,7 @@ void Player::RenderProjectileHitboxDebug()
 
 		if (m_eProjectileHitboxType == eProjectileHitboxType_Sphere)
 		{
-			m_pRenderer->DrawSphere(m_radius, 20, 20);
+			m_pRenderer->DrawSphere(m_body.m_radius, 20, 20);
 		}
 		else if (m_eProjectileHitboxType == eProjectileHitboxType_Cube)
 		{
@@ -3518,18 +3263,3 @@ void Player::RenderProjectileHitboxDebug()
 		}
 	m_pRenderer->PopMatrix();
 }
-
-void Player::_StepUpAnimationFinished(void *apData)
-{
-	Player* lpPlayer = (Player*)apData;
-	lpPlayer->StepUpAnimationFinished();
-}
-
-void Player::StepUpAnimationFinished()
-{
-	// Final addition
-	m_stepUpAdditionYAmountChangedCache = m_stepUpAnimationYAmount - m_stepUpAnimationPrevious;
-	m_position.y += m_stepUpAdditionYAmountChangedCache;
-
-	m_bDoStepUpAnimation = false;
-}
@@ -28,6 +28,7 @@
 #include "../Projectile/ProjectileManager.h"
 #include "../Enemy/EnemyManager.h"
 #include "../Enemy/Enemy.h"
+#include "../utils/PlayerStep.h"
 
 class InventoryGUI;
 class CharacterGUI;
@@ -93,6 +94,7 @@ public:
 	void SetModelname(string modelName);
 	string GetModelName();
 	void SetPosition(vec3 pos);
+	vec3 GetPosition();
 	void SetRespawnPosition(vec3 pos);
 	vec3 GetRespawnPosition();
 	vec3 GetCenter();
@@ -119,9 +121,6 @@ public:
 	// Stat modifier values
 	void RefreshStatModifierCacheValues();
 
-	// Collision
-	bool CheckCollisions(vec3 positionCheck, vec3 previousPosition, vec3 *pNormal, vec3 *pMovement, bool *pStepUpBlock);
-
 	// Selection
 	bool GetSelectionBlock(vec3 *blockPos, int* chunkIndex, int* blockX, int* blockY, int* blockZ);
 	bool GetPlacementBlock(vec3 *blockPos, int* chunkIndex, int* blockX, int* blockY, int* blockZ);
@@ -192,7 +191,9 @@ public:
 	float GetAttackRotation();
 	float GetAttackSegmentAngle();
 	void CheckEnemyDamageRadius(Enemy* pEnemy);
-	void CheckProjectileDamageRadius(Projectile* pProjectile);
+	// When the projectile's movement in the last step hits the projectile hitbox, and the time of impact along that step
+	bool CheckProjectileHit(Projectile* pProjectile, float* pHitTime);
+	void HitByProjectile(Projectile* pProjectile);
 	void DoDamage(float amount, Colour textColour, vec3 knockbackDirection, float knockbackAmount, bool createParticleHit);
 	void Explode();
 	void Respawn();
@@ -276,7 +277,10 @@ public:
 	void SetThirdPersonMode();
 
 	// Rendering Helpers
+	void StorePreviousSimulationPosition();
+	vec3 GetInterpolatedPosition(float interpolation);
 	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolation);
 	void RebuildVoxelCharacter(bool faceMerge);
 
 	// Updating
@@ -309,8 +313,11 @@ public:
 
 protected:
 	/* Protected methods */
-	static void _StepUpAnimationFinished(void *apData);
-	void StepUpAnimationFinished();
+	// The world that the player step collides with
+	static bool _GetStepBlock(const vec3 &position, vec3* pBlockPos, bool* pLoaded, void* pData);
+	static bool _HasStepFloor(const vec3 &position, void* pData);
+	static bool _CheckStepItemCollisions(const vec3 &position, const vec3 &previousPosition, float radius, vec3* pNormal, vec3* pMovement, void* pData);
+	static bool _IsStepUnderWater(const vec3 &position, void* pData);
 
 	static void _AttackEnabledTimerFinished(void *apData);
 	void AttackEnabledTimerFinished();
@@ -331,6 +338,10 @@ public:
 	/* Public members */
 	static const vec3 PLAYER_CENTER_OFFSET;
 
+	// How far the mining selection and block placement rays reach
+	static const float BLOCK_SELECTION_DISTANCE;
+	static const float BLOCK_PLACEMENT_DISTANCE;
+
 	static const int PLAYER_NAME_PICKING = 1;
 
 protected:
@@ -354,21 +365,16 @@ private:
 	LootGUI* m_pLootGUI;
 	ActionBar* m_pActionBar;
 
-	// Player position and movement variables
-	vec3 m_position;
-	vec3 m_velocity;
-	vec3 m_force;
+	// Player position, movement, ground and step up state, moved by PlayerStep
+	PlayerBody m_body;
+	PlayerStepWorld m_stepWorld;
 
-	// Store previous position each frame after we have worked out the new position
-	// Used for collision and other movement calculations
-	vec3 m_previousPosition;
+	// Position at the start of the current simulation step, rendering interpolates from here to m_position
+	vec3 m_previousSimulationPosition;
 
 	// Players respawn position
 	vec3 m_respawnPosition;
 
-	// The direction of gravity for the player
-	vec3 m_gravityDirection;
-
 	// Local axis
 	vec3 m_forward;
 	vec3 m_right;
@@ -377,10 +383,6 @@ private:
 	// Target forward / looking vector
 	vec3 m_targetForward;
 
-	// Keep track of how much we have changed position in the update, based on physics, etc.
-	// So that the fake camera position can be updated, if we are in some kind of follow camera mode.
-	vec3 m_positionMovementAmount;
-
 	// Player name
 	string m_name;
 
@@ -391,13 +393,6 @@ private:
 	string m_type;
 	string m_modelName;
 
-	// Stepping up single world blocks by walking into them
-	bool m_bDoStepUpAnimation;
-	float m_stepUpAnimationYAmount;
-	float m_stepUpAnimationPrevious;
-	float m_stepUpAnimationYOffset;
-	float m_stepUpAdditionYAmountChangedCache;
-
 	// Grid position
 	int m_gridPositionX;
 	int m_gridPositionY;
@@ -412,15 +407,10 @@ private:
 	vec3 m_cameraUp;
 	vec3 m_cameraRight;
 
-	// Ground flag
-	bool m_bIsOnGround;
-	float m_groundCheckTimer;
-
 	// Floor particles
 	float m_floorParticleTimer;
 
-	// Flag to control if we are allowed to jump or not, reset when landing
-	bool m_bCanJump;
+	// Jump delay
 	float m_jumpTimer;
 
 	// Idle flag
@@ -518,9 +508,6 @@ private:
 	int m_armorModifier;
 	int m_luckModifier;
 
-	// Player radius
-	float m_radius;
-
 	// Footstep sounds
 	int m_footstepSoundIndex;
 	float m_footstepSoundTimer;
@@ -12,6 +12,8 @@
 #include "Player.h"
 #include "../utils/Random.h"
 #include "../utils/Interpolator.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
 #include "../Projectile/ProjectileManager.h"
 #include "../Projectile/Projectile.h"
 #include "../VoxGame.h"
@@ -427,7 +429,7 @@ void Player::CheckEnemyDamageRadius(Enemy* pEnemy)
 
 	vec3 distance = GetCenter() - pEnemy->GetCenter();
 	float lengthToEnemy = length(distance);
-	if (lengthToEnemy <= m_radius + pEnemy->GetAttackRadius())
+	if (lengthToEnemy <= m_body.m_radius + pEnemy->GetAttackRadius())
 	{
 		vec3 distance_minus_y = distance;
 		distance_minus_y.y = 0.0f;
@@ -453,111 +455,76 @@ void Player::CheckEnemyDamageRadius(Enemy* pEnemy)
 	}
 }
 
-void Player::CheckProjectileDamageRadius(Projectile* pProjectile)
+bool Player::CheckProjectileHit(Projectile* pProjectile, float* pHitTime)
 {
 	if (IsDead())
 	{
-		return;
+		return false;
 	}
 
 	if (pProjectile->CanAttackPlayer() == false && pProjectile->IsReturnToPlayer() == false)
 	{
-		return;
+		return false;
 	}
 
 	vec3 projectileHitboxCenter = GetProjectileHitboxCenter();
 
-	vec3 toProjectile = projectileHitboxCenter - pProjectile->GetCenter();
+	// Test the segment the projectile moved along in the last step
+	vec3 sweepStart = pProjectile->GetSweepStartCenter();
+	vec3 sweepEnd = pProjectile->GetCenter();
 
-	bool hitByProjectile = false;
 	if (m_eProjectileHitboxType == eProjectileHitboxType_Sphere)
 	{
-		if (length(toProjectile) < GetRadius() + pProjectile->GetRadius())
-		{
-			hitByProjectile = true;
-		}
+		return SweptCollision::SphereSphere(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRadius(), pHitTime);
 	}
 	else if (m_eProjectileHitboxType == eProjectileHitboxType_Cube)
 	{
-		Plane3D planes[6];
-		Matrix4x4 rotationMatrix;
-		rotationMatrix.SetYRotation(DegToRad(GetRotation()));
-		planes[0] = Plane3D(rotationMatrix * vec3(-1.0f, 0.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[1] = Plane3D(rotationMatrix * vec3(1.0f, 0.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(-m_projectileHitboxXLength, 0.0f, 0.0f)));
-		planes[2] = Plane3D(rotationMatrix * vec3(0.0f, -1.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, m_projectileHitboxYLength, 0.0f)));
-		planes[3] = Plane3D(rotationMatrix * vec3(0.0f, 1.0f, 0.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, -m_projectileHitboxYLength, 0.0f)));
-		planes[4] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, -1.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, m_projectileHitboxZLength)));
-		planes[5] = Plane3D(rotationMatrix * vec3(0.0f, 0.0f, 1.0f), projectileHitboxCenter + (rotationMatrix * vec3(0.0f, 0.0f, -m_projectileHitboxZLength)));
-
-		float distance;
-		int inside = 0;
-		vec3 normal;
-
-		for (int i = 0; i < 6; i++)
-		{
-			distance = planes[i].GetPointDistance(pProjectile->GetCenter());
+		vec3 halfLengths = vec3(m_projectileHitboxXLength, m_projectileHitboxYLength, m_projectileHitboxZLength);
 
-			if (distance < -pProjectile->GetRadius())
-			{
-				// Outside...
-			}
-			else if (distance < pProjectile->GetRadius())
-			{
-				// Intersecting..
-				inside++;
-			}
-			else
-			{
-				// Inside...
-				inside++;
-			}
-		}
-
-		if (inside == 6)
-		{
-			hitByProjectile = true;
-		}
+		return EntityStep::SweepCubeHitbox(sweepStart, sweepEnd, pProjectile->GetRadius(), projectileHitboxCenter, GetRotation(), halfLengths, pHitTime);
 	}
 
-	if (hitByProjectile)
+	return false;
+}
+
+void Player::HitByProjectile(Projectile* pProjectile)
+{
+	if (pProjectile->IsReturnToPlayer())
 	{
-		if (pProjectile->IsReturnToPlayer())
+		if (pProjectile->CanCatch())
 		{
-			if (pProjectile->CanCatch())
-			{
-				pProjectile->PlayerCatch();
+			pProjectile->PlayerCatch();
 
-				m_bCanThrowWeapon = true;
+			m_bCanThrowWeapon = true;
 
-				if (IsBoomerang())
-				{
-					m_pVoxelCharacter->SetRenderRightWeapon(true);
+			if (IsBoomerang())
+			{
+				m_pVoxelCharacter->SetRenderRightWeapon(true);
 
-					m_pVoxelCharacter->BlendIntoAnimation(AnimationSections_FullBody, true, AnimationSections_FullBody, "SwordAttack1", 0.01f);
-					m_pVoxelCharacter->BlendIntoAnimation(AnimationSections_Right_Arm_Hand, false, AnimationSections_Right_Arm_Hand, "SwordAttack1", 0.01f);
+				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections_FullBody, true, AnimationSections_FullBody, "SwordAttack1", 0.01f);
+				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections_Right_Arm_Hand, false, AnimationSections_Right_Arm_Hand, "SwordAttack1", 0.01f);
 
-					// Start weapon trails
-					if (m_pVoxelCharacter->GetRightWeapon())
+				// Start weapon trails
+				if (m_pVoxelCharacter->GetRightWeapon())
+				{
+					if (m_pVoxelCharacter->IsRightWeaponLoaded())
 					{
-						if (m_pVoxelCharacter->IsRightWeaponLoaded())
-						{
-							m_pVoxelCharacter->GetRightWeapon()->StartWeaponTrails();
-						}
+						m_pVoxelCharacter->GetRightWeapon()->StartWeaponTrails();
 					}
 				}
 			}
 		}
-		else
-		{
-			vec3 knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
-			knockbackDirection = normalize(knockbackDirection);
-			Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
+	}
+	else
+	{
+		vec3 knockbackDirection = (normalize(pProjectile->GetVelocity())*2.0f) + vec3(0.0f, 1.0f, 0.0f);
+		knockbackDirection = normalize(knockbackDirection);
+		Colour damageColour = Colour(1.0f, 1.0f, 1.0f);
 
-			float knockbackAmount = 16.0f;
-			DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false);
+		float knockbackAmount = 16.0f;
+		DoDamage(15.0f, damageColour, knockbackDirection, knockbackAmount, false);
 
-			pProjectile->Explode();
-		}
+		pProjectile->Explode();
 	}
 }
 
@@ -601,7 +568,7 @@ void Player::DoDamage(float amount, Colour textColour, vec3 knockbackDirection,
 		if (createParticleHit && m_health > 0.0f)
 		{
 			// Do a hit particle effect
-			vec3 hitParticlePos = GetCenter() - (normalize(knockbackDirection) * m_radius);
+			vec3 hitParticlePos = GetCenter() - (normalize(knockbackDirection) * m_body.m_radius);
 			unsigned int effectId = -1;
 			BlockParticleEffect* pBlockParticleEffect = VoxGame::GetInstance()->GetBlockParticleManager()->ImportParticleEffect("media/gamedata/particles/combat_hit.effect", hitParticlePos, &effectId);
 			pBlockParticleEffect->PlayEffect();
@@ -625,7 +592,7 @@ void Player::DoDamage(float amount, Colour textColour, vec3 knockbackDirection,
 
 	if (m_knockbackTimer <= 0.0f)
 	{
-		m_velocity += knockbackDirection * knockbackAmount;
+		m_body.m_velocity += knockbackDirection * knockbackAmount;
 
 		m_knockbackTimer = m_knockbackTime;
 	}
@@ -726,7 +693,8 @@ void Player::Respawn()
 		return;
 	}
 
-	m_position = m_respawnPosition;
+	m_body.m_position = m_respawnPosition;
+	m_previousSimulationPosition = m_body.m_position;
 	
 	// Make sure we create a chunk in the respawn position
 	UpdateGridPosition();
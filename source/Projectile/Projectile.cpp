@@ -17,6 +17,9 @@
 
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
 
 #include "../Lighting/LightingManager.h"
 #include "../Player/Player.h"
@@ -228,6 +231,7 @@ void Projectile::LoadItem(const char* objectFilename)
 void Projectile::SetPosition(vec3 pos)
 {
 	m_position = pos;
+	m_sweepStartPosition = pos;
 }
 
 vec3 Projectile::GetPosition()
@@ -285,6 +289,11 @@ vec3 Projectile::GetCenter()
 	return center;
 }
 
+vec3 Projectile::GetSweepStartCenter()
+{
+	return m_sweepStartPosition + vec3(0.0f, m_radius, 0.0f);
+}
+
 vec3 Projectile::GetForwardVector()
 {
 	return m_worldMatrix.GetForwardVector();
@@ -507,8 +516,30 @@ Chunk* Projectile::GetCachedGridChunkOrFromPosition(vec3 pos)
 }
 
 // Rendering Helpers
+void Projectile::StorePreviousSimulationPosition()
+{
+	m_previousSimulationPosition = m_position;
+}
+
+vec3 Projectile::GetInterpolatedPosition(float interpolation)
+{
+	if(interpolation >= 1.0f)
+	{
+		return m_position;
+	}
+
+	return m_previousSimulationPosition + (m_position - m_previousSimulationPosition) * interpolation;
+}
+
 void Projectile::CalculateWorldTransformMatrix()
 {
+	CalculateWorldTransformMatrix(1.0f);
+}
+
+void Projectile::CalculateWorldTransformMatrix(float interpolation)
+{
+	vec3 position = GetInterpolatedPosition(interpolation);
+
 	// Make sure we are always pointing towards our velocity
 	if(length(m_velocity) > 0.01f)
 	{
@@ -532,19 +563,21 @@ void Projectile::CalculateWorldTransformMatrix()
 
 	lUp = normalize(cross(lForward, lRight));
 
+	vec3 center = GetCenter() + (position - m_position);
+
 	float lMatrix[16] =
 	{
 		lRight.x, lRight.y, lRight.z, 0.0f,
 		lUp.x, lUp.y, lUp.z, 0.0f,
 		lForward.x, lForward.y, lForward.z, 0.0f,
-		GetCenter().x, GetCenter().y, GetCenter().z, 1.0f
+		center.x, center.y, center.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(lMatrix);
 }
 
 // Updating
-void Projectile::Update(float dt)
+void Projectile::Update(float dt, DeferredCommandBuffer* pCommands)
 {
 	if(m_pVoxeProjectile != NULL)
 	{
@@ -570,6 +603,9 @@ void Projectile::Update(float dt)
 	// Update grid position
 	UpdateGridPosition();
 
+	// The collisions sweep from here to where the projectile ends up, so it can't pass through anything in between
+	m_sweepStartPosition = m_position;
+
 	vec3 acceleration = (m_gravityDirection * 9.81f) * m_gravityMultiplier;
 
 	if(m_returnToPlayer)
@@ -598,12 +634,17 @@ void Projectile::Update(float dt)
 		m_velocity = normalize(pos1 - pos);
 	}
 
-	// Integrate velocity and position
-	m_velocity += acceleration * dt;
-	m_position += m_velocity * dt;
-
-	if(m_worldCollisionEnabled)
+	if(m_worldCollisionEnabled == false)
 	{
+		// Integrate velocity and position, exactly for the constant acceleration so the path is the same for any step length
+		SweptCollision::Integrate(&m_position, &m_velocity, acceleration, dt);
+	}
+	else
+	{
+		// The first block along the movement this step, the ray is the movement so the hit distance is the time of impact
+		VoxelRayHit hit;
+		bool hitBlock = EntityStep::MoveProjectile(m_sweepStartPosition, &m_position, &m_velocity, acceleration, dt, ChunkManager::_GetRayChunk, ChunkManager::_GetRayBlock, m_pChunkManager, &hit);
+
 		vec3 floorPosition;
 		if (m_pChunkManager->FindClosestFloor(GetCenter(), &floorPosition) == false)
 		{
@@ -611,8 +652,6 @@ void Projectile::Update(float dt)
 			{
 				if (m_returningDirectToPlayer == false)
 				{
-					Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_curveTimer);
-
 					// Go straight back to player
 					m_bezierStart_Left = m_pPlayer->GetCenter();
 					m_bezierEnd_Left = m_position;
@@ -620,54 +659,42 @@ void Projectile::Update(float dt)
 					m_curveTime = 1.0f;
 					m_curveTimer = 0.0f;
 					m_rightCurve = false;
-					Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
+					pCommands->AddCommand(_ReturnDirectToPlayerDeferred, this, NULL);
 
 					m_returningDirectToPlayer = true;
 				}
 			}
 			else
 			{
-				Explode();
+				pCommands->AddCommand(_ExplodeDeferred, this, NULL);
 			}
 		}
-		else
+		else if (hitBlock)
 		{
-			int blockX, blockY, blockZ;
-			vec3 blockPos;
-
-			Chunk* pChunk = GetCachedGridChunkOrFromPosition(m_position);
-			bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(m_position.x, m_position.y, m_position.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-
-			if (pChunk != 0 && active == true)
+			if (m_returnToPlayer)
 			{
-				if (m_returnToPlayer)
-				{
-					if (m_returningDirectToPlayer == false)
-					{
-						Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_curveTimer);
-
-						// Go straight back to player
-						m_bezierStart_Left = m_pPlayer->GetCenter();
-						m_bezierEnd_Left = m_position;
-						m_bezierControl_Left = m_position;
-						m_curveTime = 1.0f;
-						m_curveTimer = 0.0f;
-						m_rightCurve = false;
-						Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
-
-						m_returningDirectToPlayer = true;
-					}
-				}
-				else
+				if (m_returningDirectToPlayer == false)
 				{
-					// Roll back the integration, since we will intersect the block otherwise
-					m_position -= m_velocity * dt;
-
-					m_velocity = vec3(0.0f, 0.0f, 0.0f);
+					// Go straight back to player
+					m_bezierStart_Left = m_pPlayer->GetCenter();
+					m_bezierEnd_Left = m_position;
+					m_bezierControl_Left = m_position;
+					m_curveTime = 1.0f;
+					m_curveTimer = 0.0f;
+					m_rightCurve = false;
+					pCommands->AddCommand(_ReturnDirectToPlayerDeferred, this, NULL);
 
-					Explode();
+					m_returningDirectToPlayer = true;
 				}
 			}
+			else
+			{
+				// Stop where we hit the block
+				m_position = hit.m_hitPosition;
+				m_velocity = vec3(0.0f, 0.0f, 0.0f);
+
+				pCommands->AddCommand(_ExplodeDeferred, this, NULL);
+			}
 		}
 	}
 
@@ -867,3 +894,21 @@ void Projectile::RightCurveTimerFinished()
 
 	Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
 }
+
+void Projectile::_ExplodeDeferred(void *pObject, void *pData)
+{
+	Projectile* lpProjectile = (Projectile*)pObject;
+	lpProjectile->Explode();
+}
+
+void Projectile::_ReturnDirectToPlayerDeferred(void *pObject, void *pData)
+{
+	Projectile* lpProjectile = (Projectile*)pObject;
+	lpProjectile->ReturnDirectToPlayer();
+}
+
+void Projectile::ReturnDirectToPlayer()
+{
+	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_curveTimer);
+	Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
+}
@@ -22,6 +22,7 @@ class GameWindow;
 class NPC;
 class Enemy;
 class Player;
+class DeferredCommandBuffer;
 
 
 enum eProjectileHitboxType
@@ -63,6 +64,8 @@ public:
 	float GetRadius();
 	void UpdateRadius();
 	vec3 GetCenter();
+	// Where the center was at the start of the last update, the projectile moved from here to GetCenter() in that step
+	vec3 GetSweepStartCenter();
 	vec3 GetForwardVector();
 	vec3 GetRightVector();
 	vec3 GetUpVector();
@@ -97,10 +100,14 @@ public:
 	Chunk* GetCachedGridChunkOrFromPosition(vec3 pos);
 
 	// Rendering Helpers
+	void StorePreviousSimulationPosition();
+	vec3 GetInterpolatedPosition(float interpolation);
 	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolation);
 
 	// Updating
-	void Update(float dt);
+	// Only changes this projectile, so that it can run in parallel with the other projectiles, anything else is added to pCommands
+	void Update(float dt, DeferredCommandBuffer* pCommands);
 	void UpdateProjectileLights(float dt);
 	void UpdateProjectileParticleEffects(float dt);
 
@@ -116,6 +123,10 @@ protected:
 	static void _RightCurveTimerFinished(void *apData);
 	void RightCurveTimerFinished();
 
+	static void _ExplodeDeferred(void *pObject, void *pData);
+	static void _ReturnDirectToPlayerDeferred(void *pObject, void *pData);
+	void ReturnDirectToPlayer();
+
 private:
 	/* Private methods */
 
@@ -147,6 +158,8 @@ private:
 	// Projectile position and movement variables
 	vec3 m_position;
 	vec3 m_previousPosition;
+	vec3 m_previousSimulationPosition;
+	vec3 m_sweepStartPosition;
 	vec3 m_velocity;
 	vec3 m_gravityDirection;
 	float m_gravityMultiplier;
@@ -17,12 +17,19 @@
 
 #include "../Lighting/LightingManager.h"
 #include "../VoxGame.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/Profiler.h"
 
 
 ProjectileManager::ProjectileManager(Renderer* pRenderer, ChunkManager* pChunkManager)
 {
 	m_pRenderer = pRenderer;
 	m_pChunkManager = pChunkManager;
+	m_pSpatialGrid = NULL;
+	m_pParallelUpdate = NULL;
+
+	m_updateDeltaTime = 0.0f;
 
 	m_numRenderProjectiles = 0;
 }
@@ -52,6 +59,16 @@ void ProjectileManager::SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBi
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
 }
 
+void ProjectileManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+void ProjectileManager::SetParallelUpdate(ParallelUpdate* pParallelUpdate)
+{
+	m_pParallelUpdate = pParallelUpdate;
+}
+
 // Clearing
 void ProjectileManager::ClearProjectiles()
 {
@@ -65,6 +82,11 @@ void ProjectileManager::ClearProjectiles()
 	m_vpProjectileList.clear();
 	m_projectileMutex.unlock();
 
+	if(m_pSpatialGrid != NULL)
+	{
+		m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Projectile);
+	}
+
 	// Create list
 	m_projectileCreateMutex.lock();
 	for(unsigned int i = 0; i < m_vpProjectileCreateList.size(); i++)
@@ -113,6 +135,7 @@ Projectile* ProjectileManager::CreateProjectile(vec3 position, vec3 velocity, fl
 	pNewProjectile->SetPlayer(m_pPlayer);
 
 	pNewProjectile->SetPosition(position);
+	pNewProjectile->StorePreviousSimulationPosition();
 	pNewProjectile->SetVelocity(velocity);
 	pNewProjectile->SetRotation(rotation);
 
@@ -161,14 +184,26 @@ bool projectile_needs_erasing(Projectile* aProjectile)
 }
 
 // Rendering helpers
-void ProjectileManager::CalculateWorldTransformMatrix()
+void ProjectileManager::StorePreviousSimulationPositions()
 {
 	m_projectileMutex.lock();
 	for (unsigned int i = 0; i < m_vpProjectileList.size(); i++)
 	{
 		Projectile* pProjectile = m_vpProjectileList[i];
 
-		pProjectile->CalculateWorldTransformMatrix();
+		pProjectile->StorePreviousSimulationPosition();
+	}
+	m_projectileMutex.unlock();
+}
+
+void ProjectileManager::CalculateWorldTransformMatrix(float interpolation)
+{
+	m_projectileMutex.lock();
+	for (unsigned int i = 0; i < m_vpProjectileList.size(); i++)
+	{
+		Projectile* pProjectile = m_vpProjectileList[i];
+
+		pProjectile->CalculateWorldTransformMatrix(interpolation);
 	}
 	m_projectileMutex.unlock();
 }
@@ -176,6 +211,8 @@ void ProjectileManager::CalculateWorldTransformMatrix()
 // Updating
 void ProjectileManager::Update(float dt)
 {
+	PROFILE_ZONE("ProjectileManager::Update");
+
 	// Add any projectiles on the create list to the main list and then clear the create list
 	m_projectileCreateMutex.lock();
 	for(unsigned int i = 0; i < m_vpProjectileCreateList.size(); i++)
@@ -194,37 +231,63 @@ void ProjectileManager::Update(float dt)
 	m_vpProjectileList.erase( remove_if(m_vpProjectileList.begin(), m_vpProjectileList.end(), projectile_needs_erasing), m_vpProjectileList.end() );
 	m_projectileMutex.unlock();
 
-	// Update projectiles
+	// Update projectiles, in parallel
+	m_projectileMutex.lock();
+	m_updateDeltaTime = dt;
+	m_pParallelUpdate->Run((int)m_vpProjectileList.size(), _UpdateProjectileParallel, this);
+	m_projectileMutex.unlock();
+
+	// Register the projectiles with the spatial grid, after they have moved
+	UpdateSpatialGrid();
+}
+
+void ProjectileManager::_UpdateProjectileParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	ProjectileManager* pProjectileManager = (ProjectileManager*)pData;
+	Projectile* pProjectile = pProjectileManager->m_vpProjectileList[index];
+
+	pProjectile->Update(pProjectileManager->m_updateDeltaTime, pCommands);
+}
+
+void ProjectileManager::UpdateProjectileLights(float dt)
+{
 	m_projectileMutex.lock();
 	for(unsigned int i = 0; i < m_vpProjectileList.size(); i++)
 	{
 		Projectile* pProjectile = m_vpProjectileList[i];
 
-		pProjectile->Update(dt);
+		pProjectile->UpdateProjectileLights(dt);
 	}
 	m_projectileMutex.unlock();
 }
 
-void ProjectileManager::UpdateProjectileLights(float dt)
+void ProjectileManager::UpdateProjectileParticleEffects(float dt)
 {
 	m_projectileMutex.lock();
 	for(unsigned int i = 0; i < m_vpProjectileList.size(); i++)
 	{
 		Projectile* pProjectile = m_vpProjectileList[i];
 
-		pProjectile->UpdateProjectileLights(dt);
+		pProjectile->UpdateProjectileParticleEffects(dt);
 	}
 	m_projectileMutex.unlock();
 }
 
-void ProjectileManager::UpdateProjectileParticleEffects(float dt)
+void ProjectileManager::UpdateSpatialGrid()
 {
+	m_pSpatialGrid->ClearLayer(eSpatialGridLayer_Projectile);
+
 	m_projectileMutex.lock();
 	for(unsigned int i = 0; i < m_vpProjectileList.size(); i++)
 	{
 		Projectile* pProjectile = m_vpProjectileList[i];
 
-		pProjectile->UpdateProjectileParticleEffects(dt);
+		// Cover the whole movement of the last step, the hit checks sweep along it
+		vec3 sweepStart = pProjectile->GetSweepStartCenter();
+		vec3 sweepEnd = pProjectile->GetCenter();
+		float sweepRadius = pProjectile->GetRadius() + length(sweepEnd - sweepStart) * 0.5f;
+
+		m_pSpatialGrid->AddObject(eSpatialGridLayer_Projectile, pProjectile, (sweepStart + sweepEnd) * 0.5f, sweepRadius);
 	}
 	m_projectileMutex.unlock();
 }
@@ -232,6 +295,8 @@ void ProjectileManager::UpdateProjectileParticleEffects(float dt)
 // Rendering
 void ProjectileManager::Render()
 {
+	PROFILE_ZONE("ProjectileManager::Render");
+
 	m_numRenderProjectiles = 0;
 
 	m_projectileMutex.lock();
@@ -20,6 +20,9 @@
 
 class LightingManager;
 class GameWindow;
+class SpatialGrid;
+class ParallelUpdate;
+class DeferredCommandBuffer;
 
 typedef std::vector<Projectile*> ProjectileList;
 
@@ -34,6 +37,8 @@ public:
 	void SetBlockParticleManager(BlockParticleManager* pBlockParticleManager);
 	void SetPlayer(Player* pPlayer);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+	void SetParallelUpdate(ParallelUpdate* pParallelUpdate);
 
 	// Clearing
 	void ClearProjectiles();
@@ -51,7 +56,8 @@ public:
 	int GetNumRenderProjectiles();
 
 	// Rendering helpers
-	void CalculateWorldTransformMatrix();
+	void StorePreviousSimulationPositions();
+	void CalculateWorldTransformMatrix(float interpolation);
 
 	// Updating
 	void Update(float dt);
@@ -68,6 +74,8 @@ protected:
 
 private:
 	/* Private methods */
+	void UpdateSpatialGrid();
+	static void _UpdateProjectileParallel(void* pData, int index, DeferredCommandBuffer* pCommands);
 
 public:
 	/* Public members */
@@ -84,6 +92,11 @@ private:
 	BlockParticleManager* m_pBlockParticleManager;
 	Player* m_pPlayer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
+	SpatialGrid* m_pSpatialGrid;
+	ParallelUpdate* m_pParallelUpdate;
+
+	// Delta time for the parallel update jobs
+	float m_updateDeltaTime;
 
 	int m_numRenderProjectiles;
 
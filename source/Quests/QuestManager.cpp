@@ -18,6 +18,7 @@
 #include "../Inventory/InventoryManager.h"
 
 #include "../utils/Random.h"
+#include "../utils/Profiler.h"
 
 
 QuestManager::QuestManager()
@@ -96,5 +97,6 @@ Quest* QuestManager::GetQuest(string name)
 
 void QuestManager::Update(float dt)
 {
+	PROFILE_ZONE("QuestManager::Update");
 
 }
@@ -159,6 +159,13 @@ Renderer::~Renderer()
 	}
 	m_vFrameBuffers.clear();
 
+	// Delete the instance buffers
+	for (i = 0; i < m_instanceBuffers.size(); i++)
+	{
+		DeleteInstanceBuffer(i);
+	}
+	m_instanceBuffers.clear();
+
 	// Delete the shaders
 	for (i = 0; i < m_shaders.size(); i++)
 	{
@@ -1397,6 +1404,19 @@ void Renderer::SetTextureData(unsigned int id, int width, int height, unsigned c
 	glDisable(GL_TEXTURE_2D);
 }
 
+void Renderer::SetTextureFloatData(unsigned int id, int width, int height, float *texdata)
+{
+	// Unfiltered 32 bit floats, for data that the shaders read back exactly
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, m_textures[id]->GetId());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F_ARB, width, height, 0, GL_RGBA, GL_FLOAT, texdata);
+	glDisable(GL_TEXTURE_2D);
+}
+
 // Cube textures
 bool Renderer::LoadCubeTexture(int *width, int *height, string front, string back, string top, string bottom, string left, string right, unsigned int *pID)
 {
@@ -1963,128 +1983,111 @@ unsigned int Renderer::GetStride(VertexType type)
 	return totalStride;
 }
 
-// Mesh
-OpenGLTriangleMesh* Renderer::CreateMesh(OGLMeshType meshType)
+// Instance buffers
+bool Renderer::CreateInstanceBuffer(int floatsPerInstance, unsigned int *pID)
 {
-	OpenGLTriangleMesh* pNewMesh = new OpenGLTriangleMesh();
+	InstanceBuffer* pInstanceBuffer = new InstanceBuffer(floatsPerInstance);
+	glGenBuffers(1, &pInstanceBuffer->m_buffer);
 
-	pNewMesh->m_meshType = meshType;
+	m_instanceBuffers.push_back(pInstanceBuffer);
+	*pID = (int)m_instanceBuffers.size() - 1;
 
-	// Return the mesh pointer
-	return pNewMesh;
+	return true;
 }
 
-void Renderer::ClearMesh(OpenGLTriangleMesh* pMesh)
+void Renderer::DeleteInstanceBuffer(unsigned int id)
 {
-	pMesh->m_textureId = -1;
-	pMesh->m_materialId = -1;
-	//pMesh->m_staticMeshId = -1; // DON'T reset this! Else we end up create more and more and more static buffers and data
-
-	// Delete the vertices
-	for (unsigned int i = 0; i < pMesh->m_vertices.size(); i++)
+	if (m_instanceBuffers[id])
 	{
-		delete pMesh->m_vertices[i];
-		pMesh->m_vertices[i] = 0;
-	}
+		if (m_instanceBuffers[id]->m_buffer != -1)
+		{
+			glDeleteBuffers(1, &m_instanceBuffers[id]->m_buffer);
+		}
 
-	// Delete the texture coordinates
-	for (unsigned int i = 0; i < pMesh->m_textureCoordinates.size(); i++)
-	{
-		delete pMesh->m_textureCoordinates[i];
-		pMesh->m_textureCoordinates[i] = 0;
+		delete m_instanceBuffers[id];
+		m_instanceBuffers[id] = 0;
 	}
+}
 
-	// Delete the triangles
-	for (unsigned int i = 0; i < pMesh->m_triangles.size(); i++)
-	{
-		delete pMesh->m_triangles[i];
-		pMesh->m_triangles[i] = 0;
-	}
+float* Renderer::GetInstanceBufferData(unsigned int id, int numInstances)
+{
+	return m_instanceBuffers[id]->ReserveStaging(numInstances);
+}
 
-	pMesh->m_vertices.clear();
-	pMesh->m_textureCoordinates.clear();
-	pMesh->m_triangles.clear();
+void Renderer::UploadInstanceBuffer(unsigned int id, int numInstances)
+{
+	InstanceBuffer* pInstanceBuffer = m_instanceBuffers[id];
 
-	if (pMesh->m_staticMeshId != -1)
+	glBindBuffer(GL_ARRAY_BUFFER, pInstanceBuffer->m_buffer);
+
+	if (pInstanceBuffer->AllocateSlot(numInstances))
 	{
-		DeleteStaticBuffer(pMesh->m_staticMeshId);
+		// Only (re)allocate the storage when the slots need to grow, otherwise we write into the next slot of the existing buffer
+		glBufferData(GL_ARRAY_BUFFER, pInstanceBuffer->GetBufferBytes(), NULL, GL_STREAM_DRAW);
 	}
-	pMesh->m_staticMeshId = -1;
 
-	delete pMesh;
-	pMesh = NULL;
+	glBufferSubData(GL_ARRAY_BUFFER, pInstanceBuffer->GetSlotByteOffset(), pInstanceBuffer->GetUploadBytes(), pInstanceBuffer->GetStaging());
 }
 
-unsigned int Renderer::AddVertexToMesh(vec3 p, vec3 n, float r, float g, float b, float a, OpenGLTriangleMesh* pMesh)
+void Renderer::BindInstanceBufferAttribute(unsigned int id, int location, int numFloats, int floatOffset)
 {
-	OpenGLMesh_Vertex* pNewVertex = new OpenGLMesh_Vertex();
-	pNewVertex->vertexPosition[0] = p.x;
-	pNewVertex->vertexPosition[1] = p.y;
-	pNewVertex->vertexPosition[2] = p.z;
-
-	pNewVertex->vertexNormals[0] = n.x;
-	pNewVertex->vertexNormals[1] = n.y;
-	pNewVertex->vertexNormals[2] = n.z;
-
-	pNewVertex->vertexColour[0] = r;
-	pNewVertex->vertexColour[1] = g;
-	pNewVertex->vertexColour[2] = b;
-	pNewVertex->vertexColour[3] = a;
-
-	if (pMesh != NULL)
-	{
-		pMesh->m_vertices.push_back(pNewVertex);
+	InstanceBuffer* pInstanceBuffer = m_instanceBuffers[id];
 
-		unsigned int vertex_id = (int)pMesh->m_vertices.size() - 1;
+	glBindBuffer(GL_ARRAY_BUFFER, pInstanceBuffer->m_buffer);
 
-		return vertex_id;
-	}
-	else
-	{
-		return -1;
-	}
+	int offset = pInstanceBuffer->GetSlotByteOffset() + floatOffset * sizeof(float);
+	glVertexAttribPointer(location, numFloats, GL_FLOAT, GL_FALSE, pInstanceBuffer->GetInstanceStride(), reinterpret_cast<void *>(offset));
+	glEnableVertexAttribArray(location);
+	glVertexAttribDivisor(location, 1);
 }
 
-unsigned int Renderer::AddTextureCoordinatesToMesh(float s, float t, OpenGLTriangleMesh* pMesh)
+int Renderer::GetNumInstanceBufferBytes()
 {
-	OpenGLMesh_TextureCoordinate* pNewTextureCoordinate = new OpenGLMesh_TextureCoordinate();
-	pNewTextureCoordinate->s = s;
-	pNewTextureCoordinate->t = t;
-
-	if (pMesh != NULL)
+	int numBytes = 0;
+	for (unsigned int i = 0; i < m_instanceBuffers.size(); i++)
 	{
-		pMesh->m_textureCoordinates.push_back(pNewTextureCoordinate);
+		if (m_instanceBuffers[i])
+		{
+			numBytes += m_instanceBuffers[i]->GetNumFrameBytes();
+		}
+	}
 
-		unsigned int textureCoordinate_id = (int)pMesh->m_textureCoordinates.size() - 1;
+	return numBytes;
+}
 
-		return textureCoordinate_id;
-	}
-	else
+int Renderer::GetNumInstanceBufferAllocations()
+{
+	int numAllocations = 0;
+	for (unsigned int i = 0; i < m_instanceBuffers.size(); i++)
 	{
-		return -1;
+		if (m_instanceBuffers[i])
+		{
+			numAllocations += m_instanceBuffers[i]->GetNumFrameAllocations();
+		}
 	}
+
+	return numAllocations;
 }
 
-unsigned int Renderer::AddTriangleToMesh(unsigned int vertexId1, unsigned int vertexId2, unsigned int vertexId3, OpenGLTriangleMesh* pMesh)
+// Mesh, the vertex building is in RendererMesh.cpp
+void Renderer::ClearMesh(OpenGLTriangleMesh* pMesh)
 {
-	// Create the triangle
-	OpenGLMesh_Triangle* pTri = new OpenGLMesh_Triangle();
-	pTri->vertexIndices[0] = vertexId1;
-	pTri->vertexIndices[1] = vertexId2;
-	pTri->vertexIndices[2] = vertexId3;
-
-	if (pMesh != NULL)
-	{
-		pMesh->m_triangles.push_back(pTri);
+	pMesh->m_textureId = -1;
+	pMesh->m_materialId = -1;
+	//pMesh->m_staticMeshId = -1; // DON'T reset this! Else we end up create more and more and more static buffers and data
 
-		unsigned int tri_id = (int)pMesh->m_triangles.size() - 1;
+	pMesh->m_vertices.clear();
+	pMesh->m_textureCoordinates.clear();
+	pMesh->m_triangles.clear();
 
-		return tri_id;
-	}
-	else
+	if (pMesh->m_staticMeshId != -1)
 	{
-		return -1;
+		DeleteStaticBuffer(pMesh->m_staticMeshId);
 	}
+	pMesh->m_staticMeshId = -1;
+
+	delete pMesh;
+	pMesh = NULL;
 }
 
 void Renderer::ModifyMeshAlpha(float alpha, OpenGLTriangleMesh* pMesh)
@@ -2158,7 +2161,6 @@ void Renderer::ConvertMeshColour(float r, float g, float b, float matchR, float
 
 void Renderer::FinishMesh(unsigned int textureID, unsigned int materialID, OpenGLTriangleMesh* pMesh)
 {
-	unsigned int numTriangles = (int)pMesh->m_triangles.size();
 	unsigned int numVertices = (int)pMesh->m_vertices.size();
 	unsigned int numTextureCoordinates = (int)pMesh->m_textureCoordinates.size();
 	unsigned int numIndices = (int)pMesh->m_triangles.size() * 3;
@@ -2166,45 +2168,23 @@ void Renderer::FinishMesh(unsigned int textureID, unsigned int materialID, OpenG
 	pMesh->m_materialId = materialID;
 	pMesh->m_textureId = textureID;
 
-	// Vertices
-	OGLPositionNormalColourVertex* meshBuffer;
-	meshBuffer = new OGLPositionNormalColourVertex[numVertices];
-	for (unsigned int i = 0; i < numVertices; i++)
+	// The mesh data is already laid out the same as the static buffer vertices, texture coordinates and indices, so use it directly
+	const OGLPositionNormalColourVertex* meshBuffer = NULL;
+	if (numVertices > 0)
 	{
-		meshBuffer[i].x = pMesh->m_vertices[i]->vertexPosition[0];
-		meshBuffer[i].y = pMesh->m_vertices[i]->vertexPosition[1];
-		meshBuffer[i].z = pMesh->m_vertices[i]->vertexPosition[2];
-
-		meshBuffer[i].nx = pMesh->m_vertices[i]->vertexNormals[0];
-		meshBuffer[i].ny = pMesh->m_vertices[i]->vertexNormals[1];
-		meshBuffer[i].nz = pMesh->m_vertices[i]->vertexNormals[2];
-
-		meshBuffer[i].r = pMesh->m_vertices[i]->vertexColour[0];
-		meshBuffer[i].g = pMesh->m_vertices[i]->vertexColour[1];
-		meshBuffer[i].b = pMesh->m_vertices[i]->vertexColour[2];
-		meshBuffer[i].a = pMesh->m_vertices[i]->vertexColour[3];
+		meshBuffer = (const OGLPositionNormalColourVertex*)&pMesh->m_vertices[0];
 	}
 
-	// Texture coordinates
-	OGLUVCoordinate* textureCoordinatesBuffer;
-	textureCoordinatesBuffer = new OGLUVCoordinate[numTextureCoordinates];
-	for (unsigned int i = 0; i < numTextureCoordinates; i++)
+	const OGLUVCoordinate* textureCoordinatesBuffer = NULL;
+	if (numTextureCoordinates > 0)
 	{
-		textureCoordinatesBuffer[i].u = pMesh->m_textureCoordinates[i]->s;
-		textureCoordinatesBuffer[i].v = pMesh->m_textureCoordinates[i]->t;
+		textureCoordinatesBuffer = (const OGLUVCoordinate*)&pMesh->m_textureCoordinates[0];
 	}
 
-	// Indices
-	unsigned int* indicesBuffer;
-	indicesBuffer = new unsigned int[numIndices];
-	int lIndexCounter = 0;
-	for (unsigned int i = 0; i < numTriangles; i++)
+	const unsigned int* indicesBuffer = NULL;
+	if (numIndices > 0)
 	{
-		indicesBuffer[lIndexCounter] = pMesh->m_triangles[i]->vertexIndices[0];
-		indicesBuffer[lIndexCounter + 1] = pMesh->m_triangles[i]->vertexIndices[1];
-		indicesBuffer[lIndexCounter + 2] = pMesh->m_triangles[i]->vertexIndices[2];
-
-		lIndexCounter += 3;
+		indicesBuffer = &pMesh->m_triangles[0].vertexIndices[0];
 	}
 
 	if (pMesh->m_meshType == OGLMeshType_Colour)
@@ -2229,11 +2209,6 @@ void Renderer::FinishMesh(unsigned int textureID, unsigned int materialID, OpenG
 			RecreateStaticBuffer(pMesh->m_staticMeshId, VT_POSITION_NORMAL_UV_COLOUR, pMesh->m_materialId, pMesh->m_textureId, numVertices, numTextureCoordinates, numIndices, meshBuffer, textureCoordinatesBuffer, indicesBuffer);
 		}
 	}
-
-	// Delete temp data
-	delete[] meshBuffer;
-	delete[] textureCoordinatesBuffer;
-	delete[] indicesBuffer;
 }
 
 void Renderer::RenderMesh(OpenGLTriangleMesh* pMesh)
@@ -2262,12 +2237,6 @@ void Renderer::RenderMesh_NoColour(OpenGLTriangleMesh* pMesh)
 	PopMatrix();
 }
 
-void Renderer::GetMeshInformation(int *numVerts, int *numTris, OpenGLTriangleMesh* pMesh)
-{
-	*numVerts = (int)pMesh->m_vertices.size();
-	*numTris = (int)pMesh->m_triangles.size();
-}
-
 void Renderer::StartMeshRender()
 {
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -2289,77 +2258,6 @@ bool Renderer::MeshStaticBufferRender(OpenGLTriangleMesh* pMesh)
 	return RenderStaticBuffer(pMesh->m_staticMeshId);
 }
 
-// Name rendering and name picking
-void Renderer::InitNameStack()
-{
-	glInitNames();
-}
-
-void Renderer::LoadNameOntoStack(int lName)
-{
-	glPushName(lName);
-	//glLoadName(lName);
-}
-
-void Renderer::EndNameStack()
-{
-	glPopName();
-}
-
-void Renderer::StartNamePicking(unsigned int lViewportid, int lX, int lY)
-{
-	ClearScene(true, true, true);
-
-	glSelectBuffer(NAME_PICKING_BUFFER, m_SelectBuffer);
-
-	glRenderMode(GL_SELECT);
-
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-
-	int	viewportCoords[4] = { 0, 0, 0, 0 };
-	glGetIntegerv(GL_VIEWPORT, viewportCoords);
-	gluPickMatrix(lX, lY, 3, 3, viewportCoords);
-
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-
-	MultViewProjection();
-}
-
-int Renderer::GetPickedObject()
-{
-	int objectsFound = 0;
-	objectsFound = glRenderMode(GL_RENDER);
-
-	if (objectsFound > 0)
-	{
-		unsigned int lowestDepth = m_SelectBuffer[1];
-
-		int selectedObject = m_SelectBuffer[3];
-
-		// Any time that we find more than one named object, we choose the one with the lowest depth. i.e Closest to the screen
-		for (int i = 1; i < objectsFound; i++)
-		{
-			unsigned int lDepth = m_SelectBuffer[(i * 4) + 1];
-			int lname = m_SelectBuffer[(i * 4) + 3];
-
-			// Also make sure that a name of -1 doesnt ever take priority
-			if (lDepth < lowestDepth && lname != -1)
-			{
-				lowestDepth = m_SelectBuffer[(i * 4) + 1];
-
-				selectedObject = m_SelectBuffer[(i * 4) + 3];
-			}
-		}
-
-		return selectedObject;
-	}
-
-	//No objects found
-	return -1;
-}
-
 // Frustum
 Frustum* Renderer::GetFrustum(unsigned int frustumid)
 {
@@ -2600,6 +2498,14 @@ void Renderer::ResetRenderedStats()
 {
 	m_numRenderedVertices = 0;
 	m_numRenderedFaces = 0;
+
+	for (unsigned int i = 0; i < m_instanceBuffers.size(); i++)
+	{
+		if (m_instanceBuffers[i])
+		{
+			m_instanceBuffers[i]->ResetFrameStats();
+		}
+	}
 }
 
 int Renderer::GetNumRenderedVertices()
@@ -47,6 +47,7 @@ using namespace tthread;
 #include "material.h"
 #include "light.h"
 #include "framebuffer.h"
+#include "instancebuffer.h"
 
 
 enum ProjectionMode
@@ -318,6 +319,7 @@ public:
 	void BindRawTextureId(unsigned int textureId);
 	void GenerateEmptyTexture(unsigned int *pID);
 	void SetTextureData(unsigned int id, int width, int height, unsigned char *texdata);
+	void SetTextureFloatData(unsigned int id, int width, int height, float *texdata);
 
 	// Cube textures
 	bool LoadCubeTexture(int *width, int *height, string front, string back, string top, string bottom, string left, string right, unsigned int *pID);
@@ -334,9 +336,19 @@ public:
 	bool RenderFromArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices);
 	unsigned int GetStride(VertexType type);
 
+	// Instance buffers
+	bool CreateInstanceBuffer(int floatsPerInstance, unsigned int *pID);
+	void DeleteInstanceBuffer(unsigned int id);
+	float* GetInstanceBufferData(unsigned int id, int numInstances);
+	void UploadInstanceBuffer(unsigned int id, int numInstances);
+	void BindInstanceBufferAttribute(unsigned int id, int location, int numFloats, int floatOffset);
+	int GetNumInstanceBufferBytes();
+	int GetNumInstanceBufferAllocations();
+
 	// Mesh
 	OpenGLTriangleMesh* CreateMesh(OGLMeshType meshType);
 	void ClearMesh(OpenGLTriangleMesh* pMesh);
+	void ReserveMesh(int numVertices, int numTriangles, OpenGLTriangleMesh* pMesh);
 	unsigned int AddVertexToMesh(vec3 p, vec3 n, float r, float g, float b, float a, OpenGLTriangleMesh* pMesh);
 	unsigned int AddTextureCoordinatesToMesh(float s, float t, OpenGLTriangleMesh* pMesh);
 	unsigned int AddTriangleToMesh(unsigned int vertexId1, unsigned int vertexId2, unsigned int vertexId3, OpenGLTriangleMesh* pMesh);
@@ -351,13 +363,6 @@ public:
 	void EndMeshRender();
 	bool MeshStaticBufferRender(OpenGLTriangleMesh* pMesh);
 
-	// Name rendering and name picking
-	void InitNameStack();
-	void LoadNameOntoStack(int lName);
-	void EndNameStack();
-	void StartNamePicking(unsigned int lViewportid, int lX, int lY);
-	int  GetPickedObject();
-
 	// Frustum
 	Frustum* GetFrustum(unsigned int frustumid);
 	int PointInFrustum(unsigned int frustumid, const vec3 &point);
@@ -450,6 +455,9 @@ private:
 	// Frame buffers
 	vector<FrameBuffer*> m_vFrameBuffers;
 
+	// Instance buffers, for streaming per instance data
+	vector<InstanceBuffer*> m_instanceBuffers;
+
 	// Rendered information
 	int m_numRenderedVertices;
 	int m_numRenderedFaces;
@@ -465,10 +473,6 @@ private:
 
 	// Model stack
 	vector<Matrix4x4> m_modelStack;
-
-	// Name picking
-	static const int NAME_PICKING_BUFFER = 64;
-	unsigned int m_SelectBuffer[NAME_PICKING_BUFFER];
 };
 
 int CheckGLErrors(char *file, int line);
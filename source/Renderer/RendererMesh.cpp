@@ -0,0 +1,117 @@
+// ******************************************************************************
+// Filename:    RendererMesh.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The renderer functions that build up a mesh on the CPU, before it is
+//   finished into a static buffer. No GL is used, so the chunk meshing can
+//   be run headless with the same vertex building as the game.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "Renderer.h"
+
+
+// Mesh
+OpenGLTriangleMesh* Renderer::CreateMesh(OGLMeshType meshType)
+{
+	OpenGLTriangleMesh* pNewMesh = new OpenGLTriangleMesh();
+
+	pNewMesh->m_meshType = meshType;
+
+	// Return the mesh pointer
+	return pNewMesh;
+}
+
+void Renderer::ReserveMesh(int numVertices, int numTriangles, OpenGLTriangleMesh* pMesh)
+{
+	pMesh->m_vertices.reserve(numVertices);
+	pMesh->m_triangles.reserve(numTriangles);
+
+	if (pMesh->m_meshType == OGLMeshType_Textured)
+	{
+		pMesh->m_textureCoordinates.reserve(numVertices);
+	}
+}
+
+unsigned int Renderer::AddVertexToMesh(vec3 p, vec3 n, float r, float g, float b, float a, OpenGLTriangleMesh* pMesh)
+{
+	if (pMesh != NULL)
+	{
+		OpenGLMesh_Vertex vertex;
+		vertex.vertexPosition[0] = p.x;
+		vertex.vertexPosition[1] = p.y;
+		vertex.vertexPosition[2] = p.z;
+
+		vertex.vertexNormals[0] = n.x;
+		vertex.vertexNormals[1] = n.y;
+		vertex.vertexNormals[2] = n.z;
+
+		vertex.vertexColour[0] = r;
+		vertex.vertexColour[1] = g;
+		vertex.vertexColour[2] = b;
+		vertex.vertexColour[3] = a;
+
+		pMesh->m_vertices.push_back(vertex);
+
+		unsigned int vertex_id = (int)pMesh->m_vertices.size() - 1;
+
+		return vertex_id;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+unsigned int Renderer::AddTextureCoordinatesToMesh(float s, float t, OpenGLTriangleMesh* pMesh)
+{
+	if (pMesh != NULL)
+	{
+		OpenGLMesh_TextureCoordinate textureCoordinate;
+		textureCoordinate.s = s;
+		textureCoordinate.t = t;
+
+		pMesh->m_textureCoordinates.push_back(textureCoordinate);
+
+		unsigned int textureCoordinate_id = (int)pMesh->m_textureCoordinates.size() - 1;
+
+		return textureCoordinate_id;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+unsigned int Renderer::AddTriangleToMesh(unsigned int vertexId1, unsigned int vertexId2, unsigned int vertexId3, OpenGLTriangleMesh* pMesh)
+{
+	if (pMesh != NULL)
+	{
+		OpenGLMesh_Triangle triangle;
+		triangle.vertexIndices[0] = vertexId1;
+		triangle.vertexIndices[1] = vertexId2;
+		triangle.vertexIndices[2] = vertexId3;
+
+		pMesh->m_triangles.push_back(triangle);
+
+		unsigned int tri_id = (int)pMesh->m_triangles.size() - 1;
+
+		return tri_id;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+void Renderer::GetMeshInformation(int *numVerts, int *numTris, OpenGLTriangleMesh* pMesh)
+{
+	*numVerts = (int)pMesh->m_vertices.size();
+	*numTris = (int)pMesh->m_triangles.size();
+}
@@ -39,6 +39,21 @@ void Frustum::SetFrustum(float angle, float ratio, float nearD, float farD)
 	farWidth = farHeight * ratio;
 }
 
+void Frustum::SetOrthographicFrustum(float width, float height, float nearD, float farD)
+{
+	this->ratio = width / height;
+	this->angle = 0.0f;
+	this->nearDistance = nearD;
+	this->farDistance = farD;
+
+	// The near and far planes are the same size, so SetCamera() builds a box
+	tang = 0.0f;
+	nearHeight = height * 0.5f;
+	nearWidth = width * 0.5f;
+	farHeight = nearHeight;
+	farWidth = nearWidth;
+}
+
 void Frustum::SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up)
 {
 	vec3 dir, nc, fc, X, Y, Z;
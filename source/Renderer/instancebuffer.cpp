@@ -0,0 +1,135 @@
+// ******************************************************************************
+// Filename:  instancebuffer.cpp
+// Project:   Vox
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "instancebuffer.h"
+
+#include <string.h>
+
+
+InstanceBuffer::InstanceBuffer(int floatsPerInstance)
+{
+	m_buffer = -1;
+
+	m_floatsPerInstance = floatsPerInstance;
+
+	m_slot = 0;
+	m_slotCapacity = 0;
+	m_numUploadInstances = 0;
+
+	m_numFrameBytes = 0;
+	m_numFrameAllocations = 0;
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	/* Nothing */
+}
+
+int InstanceBuffer::GetFloatsPerInstance()
+{
+	return m_floatsPerInstance;
+}
+
+int InstanceBuffer::GetInstanceStride()
+{
+	return m_floatsPerInstance * sizeof(float);
+}
+
+// Staging
+float* InstanceBuffer::ReserveStaging(int numInstances)
+{
+	unsigned int numFloats = numInstances * m_floatsPerInstance;
+	if(m_vStaging.size() < numFloats)
+	{
+		// Grow by at least double, so that slowly rising instance counts don't allocate every frame
+		unsigned int newSize = m_vStaging.size() * 2;
+		if(newSize < numFloats)
+		{
+			newSize = numFloats;
+		}
+		m_vStaging.resize(newSize);
+
+		m_numFrameAllocations++;
+	}
+
+	return m_vStaging.empty() ? NULL : &m_vStaging[0];
+}
+
+float* InstanceBuffer::GetStaging()
+{
+	return m_vStaging.empty() ? NULL : &m_vStaging[0];
+}
+
+void InstanceBuffer::SetInstanceFloats(int instanceIndex, int floatOffset, const float* pData, int numFloats)
+{
+	memcpy(&m_vStaging[instanceIndex * m_floatsPerInstance + floatOffset], pData, numFloats * sizeof(float));
+}
+
+bool InstanceBuffer::AllocateSlot(int numInstances)
+{
+	bool reallocate = false;
+	if(numInstances > m_slotCapacity)
+	{
+		int newCapacity = (m_slotCapacity > 0) ? m_slotCapacity * 2 : MIN_SLOT_INSTANCES;
+		while(newCapacity < numInstances)
+		{
+			newCapacity *= 2;
+		}
+		m_slotCapacity = newCapacity;
+
+		m_numFrameAllocations++;
+		reallocate = true;
+	}
+
+	m_slot = (m_slot + 1) % NUM_RING_SLOTS;
+	m_numUploadInstances = numInstances;
+
+	m_numFrameBytes += GetUploadBytes();
+
+	return reallocate;
+}
+
+int InstanceBuffer::GetSlot()
+{
+	return m_slot;
+}
+
+int InstanceBuffer::GetSlotByteOffset()
+{
+	return m_slot * m_slotCapacity * GetInstanceStride();
+}
+
+int InstanceBuffer::GetUploadBytes()
+{
+	return m_numUploadInstances * GetInstanceStride();
+}
+
+int InstanceBuffer::GetBufferBytes()
+{
+	return NUM_RING_SLOTS * m_slotCapacity * GetInstanceStride();
+}
+
+// Frame stats
+void InstanceBuffer::ResetFrameStats()
+{
+	m_numFrameBytes = 0;
+	m_numFrameAllocations = 0;
+}
+
+int InstanceBuffer::GetNumFrameBytes()
+{
+	return m_numFrameBytes;
+}
+
+int InstanceBuffer::GetNumFrameAllocations()
+{
+	return m_numFrameAllocations;
+}
@@ -0,0 +1,71 @@
+// ******************************************************************************
+// Filename:  instancebuffer.h
+// Project:   Vox
+// Author:    Steven Ball
+//
+// Purpose:
+//   Per instance data (matrices, colours) that is streamed to the GPU every
+//   frame. The data is packed into a staging array that is kept between
+//   frames, and each upload goes into the next of three slots in a single GPU
+//   buffer, so that we never write into the part of the buffer that the
+//   previous draws might still be reading from. Both only grow, so once the
+//   instance counts settle no more allocations are made. This class only does
+//   the CPU side book keeping, the Renderer owns the GL buffer.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+
+class InstanceBuffer
+{
+public:
+	InstanceBuffer(int floatsPerInstance);
+	~InstanceBuffer();
+
+	int GetFloatsPerInstance();
+	int GetInstanceStride();
+
+	// Staging
+	float* ReserveStaging(int numInstances);
+	float* GetStaging();
+	void SetInstanceFloats(int instanceIndex, int floatOffset, const float* pData, int numFloats);
+
+	// Moves on to the next ring slot for an upload of numInstances, returns true if the GPU buffer needs to be (re)allocated first
+	bool AllocateSlot(int numInstances);
+	int GetSlot();
+	int GetSlotByteOffset();
+	int GetUploadBytes();
+	int GetBufferBytes();
+
+	// Frame stats
+	void ResetFrameStats();
+	int GetNumFrameBytes();
+	int GetNumFrameAllocations();
+
+public:
+	static const int NUM_RING_SLOTS = 3;
+	static const int MIN_SLOT_INSTANCES = 64;
+
+	// GL buffer name, created and deleted by the Renderer
+	unsigned int m_buffer;
+
+private:
+	int m_floatsPerInstance;
+
+	vector<float> m_vStaging;
+
+	int m_slot;
+	int m_slotCapacity;
+	int m_numUploadInstances;
+
+	int m_numFrameBytes;
+	int m_numFrameAllocations;
+};
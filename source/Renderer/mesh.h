@@ -55,9 +55,10 @@ public:
 	~OpenGLTriangleMesh();
 
 public:
-    vector<OpenGLMesh_Triangle*> m_triangles;
-	vector<OpenGLMesh_Vertex*> m_vertices;
-	vector<OpenGLMesh_TextureCoordinate*> m_textureCoordinates;
+	// Stored contiguously, so that they can be passed straight to the static buffer without any copying
+    vector<OpenGLMesh_Triangle> m_triangles;
+	vector<OpenGLMesh_Vertex> m_vertices;
+	vector<OpenGLMesh_TextureCoordinate> m_textureCoordinates;
 
     unsigned int m_staticMeshId;
 
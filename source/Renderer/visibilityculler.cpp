@@ -0,0 +1,170 @@
+// ******************************************************************************
+// Filename:  visibilityculler.cpp
+// Project:   Vox
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "visibilityculler.h"
+
+
+VisibilityCuller::VisibilityCuller()
+{
+	m_cameraAngle = 60.0f;
+	m_cameraRatio = 1.0f;
+	m_cameraNear = 0.1f;
+	m_cameraFar = 1000.0f;
+	m_cameraUp = vec3(0.0f, 1.0f, 0.0f);
+
+	m_waterHeight = 0.0f;
+
+	for (int i = 0; i < VisibilityType_NumTypes; i++)
+	{
+		m_typePasses[i] = ALL_PASSES;
+	}
+
+	StartFrame();
+}
+
+VisibilityCuller::~VisibilityCuller()
+{
+}
+
+void VisibilityCuller::StartFrame()
+{
+	for (int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_passEnabled[i] = false;
+
+		for (int j = 0; j < VisibilityType_NumTypes; j++)
+		{
+			m_numVisible[i][j] = 0;
+		}
+	}
+
+	for (int i = 0; i < VisibilityType_NumTypes; i++)
+	{
+		m_numCandidates[i] = 0;
+	}
+}
+
+void VisibilityCuller::SetCameraFrustum(float angle, float ratio, float nearD, float farD, const vec3 &pos, const vec3 &target, const vec3 &up)
+{
+	m_cameraAngle = angle;
+	m_cameraRatio = ratio;
+	m_cameraNear = nearD;
+	m_cameraFar = farD;
+	m_cameraPosition = pos;
+	m_cameraTarget = target;
+	m_cameraUp = up;
+
+	m_frustums[RenderPass_Main].SetFrustum(angle, ratio, nearD, farD);
+	m_frustums[RenderPass_Main].SetCamera(pos, target, up);
+	m_passEnabled[RenderPass_Main] = true;
+}
+
+void VisibilityCuller::SetShadowFrustum(float width, float height, float nearD, float farD, const vec3 &lightPos, const vec3 &target, const vec3 &up)
+{
+	m_frustums[RenderPass_Shadow].SetOrthographicFrustum(width, height, nearD, farD);
+	m_frustums[RenderPass_Shadow].SetCamera(lightPos, target, up);
+	m_passEnabled[RenderPass_Shadow] = true;
+}
+
+void VisibilityCuller::SetReflectionFrustum(float waterHeight)
+{
+	m_waterHeight = waterHeight;
+
+	// The reflection pass flips the world in the water plane and looks at it with the real camera, which sees the same objects as the mirrored camera looking at the real world
+	vec3 mirrorPosition = vec3(m_cameraPosition.x, (waterHeight*2.0f) - m_cameraPosition.y, m_cameraPosition.z);
+	vec3 mirrorTarget = vec3(m_cameraTarget.x, (waterHeight*2.0f) - m_cameraTarget.y, m_cameraTarget.z);
+	vec3 mirrorUp = vec3(m_cameraUp.x, -m_cameraUp.y, m_cameraUp.z);
+
+	m_frustums[RenderPass_Reflection].SetFrustum(m_cameraAngle, m_cameraRatio, m_cameraNear, m_cameraFar);
+	m_frustums[RenderPass_Reflection].SetCamera(mirrorPosition, mirrorTarget, mirrorUp);
+	m_passEnabled[RenderPass_Reflection] = true;
+}
+
+bool VisibilityCuller::IsPassEnabled(RenderPass pass)
+{
+	return m_passEnabled[pass];
+}
+
+Frustum* VisibilityCuller::GetFrustum(RenderPass pass)
+{
+	return &m_frustums[pass];
+}
+
+void VisibilityCuller::SetTypePasses(VisibilityType type, unsigned int passMask)
+{
+	m_typePasses[type] = passMask;
+}
+
+unsigned int VisibilityCuller::GetTypePasses(VisibilityType type)
+{
+	return m_typePasses[type];
+}
+
+unsigned int VisibilityCuller::CullSphere(VisibilityType type, const vec3 &center, float radius)
+{
+	m_numCandidates[type]++;
+
+	unsigned int passMask = 0;
+	for (int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		if (m_passEnabled[i] == false || (m_typePasses[type] & (1 << i)) == 0)
+		{
+			continue;
+		}
+
+		// The reflection pass clips everything below the water
+		if (i == RenderPass_Reflection && center.y + radius < m_waterHeight)
+		{
+			continue;
+		}
+
+		if (m_frustums[i].SphereInFrustum(center, radius) != Frustum::FRUSTUM_OUTSIDE)
+		{
+			passMask |= (1 << i);
+			m_numVisible[i][type]++;
+		}
+	}
+
+	return passMask;
+}
+
+// Counters
+int VisibilityCuller::GetNumCandidates(VisibilityType type)
+{
+	return m_numCandidates[type];
+}
+
+int VisibilityCuller::GetNumVisible(RenderPass pass, VisibilityType type)
+{
+	return m_numVisible[pass][type];
+}
+
+int VisibilityCuller::GetNumVisible(RenderPass pass)
+{
+	int numVisible = 0;
+	for (int i = 0; i < VisibilityType_NumTypes; i++)
+	{
+		numVisible += m_numVisible[pass][i];
+	}
+
+	return numVisible;
+}
+
+const char* VisibilityCuller::GetPassName(RenderPass pass)
+{
+	switch (pass)
+	{
+		case RenderPass_Main: { return "main"; }
+		case RenderPass_Shadow: { return "shadow"; }
+		case RenderPass_Reflection: { return "reflection"; }
+		default: { return "unknown"; }
+	}
+}
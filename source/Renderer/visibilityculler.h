@@ -0,0 +1,114 @@
+// ******************************************************************************
+// Filename:  visibilityculler.h
+// Project:   Vox
+// Author:    Steven Ball
+//
+// Purpose:
+//   Culls the scene once per frame for every render pass. Each pass has its
+//   own frustum, the camera for the main pass, the light's orthographic box
+//   for the shadow map and the camera mirrored in the water plane for the
+//   water reflections. The managers cull their objects against all of the
+//   passes in one go and keep a visible list for each pass, so the passes
+//   only walk the objects that they can actually see. No GL is used, so this
+//   also runs headless.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "frustum.h"
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+enum RenderPass
+{
+	RenderPass_Main = 0,
+	RenderPass_Shadow,
+	RenderPass_Reflection,
+
+	RenderPass_NumPasses,
+};
+
+enum VisibilityType
+{
+	VisibilityType_Chunk = 0,
+	VisibilityType_NPC,
+	VisibilityType_Enemy,
+	VisibilityType_Item,
+	VisibilityType_Scenery,
+
+	VisibilityType_NumTypes,
+};
+
+
+class VisibilityCuller
+{
+public:
+	/* Public methods */
+	VisibilityCuller();
+	~VisibilityCuller();
+
+	// Disables all of the passes and resets the counters, then the passes that are rendered this frame are setup
+	void StartFrame();
+
+	void SetCameraFrustum(float angle, float ratio, float nearD, float farD, const vec3 &pos, const vec3 &target, const vec3 &up);
+	void SetShadowFrustum(float width, float height, float nearD, float farD, const vec3 &lightPos, const vec3 &target, const vec3 &up);
+	// Mirrors the camera frustum in the water plane, call after SetCameraFrustum()
+	void SetReflectionFrustum(float waterHeight);
+
+	bool IsPassEnabled(RenderPass pass);
+	Frustum* GetFrustum(RenderPass pass);
+
+	// The passes that render a type of object, as a mask of (1 << RenderPass), all of them by default
+	void SetTypePasses(VisibilityType type, unsigned int passMask);
+	unsigned int GetTypePasses(VisibilityType type);
+
+	// Returns a mask of (1 << RenderPass) for the passes that render the type and can see the sphere
+	unsigned int CullSphere(VisibilityType type, const vec3 &center, float radius);
+
+	// Counters
+	int GetNumCandidates(VisibilityType type);
+	int GetNumVisible(RenderPass pass, VisibilityType type);
+	int GetNumVisible(RenderPass pass);
+
+	static const char* GetPassName(RenderPass pass);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+	static const unsigned int ALL_PASSES = (1 << RenderPass_NumPasses) - 1;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	Frustum m_frustums[RenderPass_NumPasses];
+	bool m_passEnabled[RenderPass_NumPasses];
+	unsigned int m_typePasses[VisibilityType_NumTypes];
+
+	// The camera, kept to build the reflection frustum
+	float m_cameraAngle;
+	float m_cameraRatio;
+	float m_cameraNear;
+	float m_cameraFar;
+	vec3 m_cameraPosition;
+	vec3 m_cameraTarget;
+	vec3 m_cameraUp;
+
+	// Only geometry above the water is reflected
+	float m_waterHeight;
+
+	int m_numCandidates[VisibilityType_NumTypes];
+	int m_numVisible[RenderPass_NumPasses][VisibilityType_NumTypes];
+};
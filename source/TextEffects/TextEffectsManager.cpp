@@ -2,6 +2,7 @@
 
 #include "../utils/Random.h"
 #include "../utils/Interpolator.h"
+#include "../utils/Profiler.h"
 
 
 TextEffectsManager::TextEffectsManager(Renderer* pRenderer)
@@ -113,6 +114,8 @@ AnimatedText* TextEffectsManager::CreateTextEffect(unsigned int lFontID, unsigne
 
 void TextEffectsManager::Update(float lDeltaTime)
 {
+	PROFILE_ZONE("TextEffectsManager::Update");
+
 	AnimatedTextList::iterator iterator;
 
 	// Update all effects
@@ -197,6 +200,8 @@ void TextEffectsManager::Update(float lDeltaTime)
 
 void TextEffectsManager::Render()
 {
+	PROFILE_ZONE("TextEffectsManager::Render");
+
 	AnimatedTextList::const_iterator iterator;
 
 	mpRenderer->PushMatrix();
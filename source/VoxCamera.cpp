@@ -305,65 +305,40 @@ void VoxGame::UpdateCameraClipping(float dt)
 
 	if (m_gameMode == GameMode_Game && m_cameraMode != CameraMode_Debug)
 	{
-		int numIterations = 0;
-		int maxNumIterations = 100;
-		vec3 basePos;
-		vec3 testPos;
-		vec3 cameraFacingUnit = normalize(m_pGameCamera->GetFacing());
-		bool collides = true;
-		int blockX, blockY, blockZ;
-		vec3 blockPos;
-		bool active = false;
-		vec3 toPlayer = ((m_pPlayer->GetCenter() + Player::PLAYER_CENTER_OFFSET) - m_pGameCamera->GetFakePosition());
-		float distance = length(toPlayer);
-		float incrementAmount = distance / maxNumIterations;
-		while (collides == true && numIterations < maxNumIterations)
+		// Cast out from the player's head to the camera, around the camera so that the view doesn't clip into the walls, and pull the camera in to the nearest hit
+		vec3 playerHead = m_pPlayer->GetCenter() + Player::PLAYER_CENTER_OFFSET;
+		vec3 toCamera = cameraPosition - playerHead;
+		float cameraDistance = length(toCamera);
+		if (cameraDistance > 0.0f)
 		{
-			collides = false;
-			basePos = cameraPosition;
-
-			vec3 playerRight = m_pPlayer->GetRightVector() * 0.25f;
-			testPos = basePos + playerRight;
-			Chunk* pChunk = NULL;
-			active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-			if (active)
+			vec3 toCameraUnit = toCamera / cameraDistance;
+			vec3 probeOffsets[4] =
 			{
-				collides = true;
-			}
-
-			playerRight = m_pPlayer->GetRightVector() * -0.25f;
-			testPos = basePos + playerRight;
-			pChunk = NULL;
-			active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-			if (active)
-			{
-				collides = true;
-			}
-
-			vec3 playerUp = m_pPlayer->GetUpVector() * -0.25f;
-			testPos = basePos + playerUp;
-			pChunk = NULL;
-			active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-			if (active)
-			{
-				collides = true;
-			}
-
-			playerUp = m_pPlayer->GetUpVector() * 0.25f;
-			testPos = basePos + playerUp;
-			pChunk = NULL;
-			active = m_pChunkManager->GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-			if (active)
-			{
-				collides = true;
-			}
-
-			if (collides == true)
+				m_pPlayer->GetRightVector() * 0.25f,
+				m_pPlayer->GetRightVector() * -0.25f,
+				m_pPlayer->GetUpVector() * -0.25f,
+				m_pPlayer->GetUpVector() * 0.25f,
+			};
+
+			float clippedDistance = cameraDistance;
+			for (int i = 0; i < 4; i++)
 			{
-				cameraPosition += m_pGameCamera->GetFacing() * incrementAmount;
+				VoxelRayHit hit;
+				if (m_pChunkManager->RayCast(playerHead + probeOffsets[i], toCameraUnit, clippedDistance, &hit) == false)
+				{
+					continue;
+				}
+
+				// Starting inside a block means the player is up against a wall, that probe can't tell where the camera fits
+				if (hit.m_distance == 0.0f)
+				{
+					continue;
+				}
+
+				clippedDistance = hit.m_distance;
 			}
 
-			numIterations++;
+			cameraPosition = playerHead + toCameraUnit * clippedDistance;
 		}
 	}
 
@@ -14,10 +14,10 @@
 // Controls
 void VoxGame::UpdateControls(float dt)
 {
+	// Mouse camera rotation is not part of this, it is updated every frame, see VoxGame::Update()
 	if (m_gamepadMovement == false)
 	{
 		UpdateKeyboardControls(dt);
-		UpdateMouseControls(dt);
 	}
 
 	if (m_keyboardMovement == false)
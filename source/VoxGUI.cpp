@@ -11,6 +11,12 @@
 
 #include "VoxGame.h"
 #include "utils/FileUtils.h"
+#include "utils/Profiler.h"
+
+// The profiler window shows the most expensive zones, one row per zone with the name, average, p99 and calls columns
+static const int PROFILER_NUM_ZONE_ROWS = 12;
+static const int PROFILER_NUM_COLUMNS = 4;
+static const int PROFILER_COLUMN_X[PROFILER_NUM_COLUMNS] = { 10, 250, 310, 370 };
 
 void VoxGame::CreateGUI()
 {
@@ -192,9 +198,59 @@ void VoxGame::CreateGUI()
 	m_pConsoleWindow->AddComponent(m_pConsoleTextbox);
 	m_pConsoleWindow->AddComponent(m_pConsoleScrollbar);
 
+	// Profiler window
+	m_pProfilerWindow = new GUIWindow(m_pRenderer, m_defaultFont, "Profiler");
+	m_pProfilerWindow->AllowMoving(true);
+	m_pProfilerWindow->AllowClosing(false);
+	m_pProfilerWindow->AllowMinimizing(true);
+	m_pProfilerWindow->AllowScrolling(true);
+	m_pProfilerWindow->SetRenderTitleBar(true);
+	m_pProfilerWindow->SetRenderWindowBackground(true);
+	m_pProfilerWindow->SetOutlineRender(true);
+	m_pProfilerWindow->SetDimensions(15, 190, 420, 240);
+	m_pProfilerWindow->SetApplicationDimensions(m_windowWidth, m_windowHeight);
+
+	m_pProfilerCheckBox = new CheckBox(m_pRenderer, m_defaultFont, "Enabled");
+	m_pProfilerCheckBox->SetDimensions(10, 218, 14, 14);
+	m_pProfilerCheckBox->SetCallBackFunction(_ProfilerCheckboxChanged);
+	m_pProfilerCheckBox->SetCallBackData(this);
+
+	m_pProfilerCaptureButton = new Button(m_pRenderer, m_defaultFont, "Capture");
+	m_pProfilerCaptureButton->SetDimensions(270, 212, 65, 25);
+	m_pProfilerCaptureButton->SetCallBackFunction(_ProfilerCapturePressed);
+	m_pProfilerCaptureButton->SetCallBackData(this);
+
+	m_pProfilerExportButton = new Button(m_pRenderer, m_defaultFont, "Export");
+	m_pProfilerExportButton->SetDimensions(345, 212, 65, 25);
+	m_pProfilerExportButton->SetCallBackFunction(_ProfilerExportPressed);
+	m_pProfilerExportButton->SetCallBackData(this);
+
+	m_pProfilerStatusLabel = new Label(m_pRenderer, m_defaultFont, "", Colour(1.0f, 1.0f, 1.0f));
+	m_pProfilerStatusLabel->SetLocation(90, 218);
+
+	const char* profilerHeadings[PROFILER_NUM_COLUMNS] = { "Zone", "Avg ms", "p99 ms", "Calls" };
+	for (int row = 0; row <= PROFILER_NUM_ZONE_ROWS; row++)
+	{
+		for (int column = 0; column < PROFILER_NUM_COLUMNS; column++)
+		{
+			// The first row is the headings
+			Label* pLabel = new Label(m_pRenderer, m_defaultFont, (row == 0) ? profilerHeadings[column] : "", (row == 0) ? Colour(1.0f, 1.0f, 0.0f) : Colour(1.0f, 1.0f, 1.0f));
+			pLabel->SetLocation(PROFILER_COLUMN_X[column], 190 - row * 14);
+
+			m_vpProfilerLabels.push_back(pLabel);
+			m_pProfilerWindow->AddComponent(pLabel);
+		}
+	}
+
+	m_pProfilerWindow->AddComponent(m_pProfilerCheckBox);
+	m_pProfilerWindow->AddComponent(m_pProfilerCaptureButton);
+	m_pProfilerWindow->AddComponent(m_pProfilerExportButton);
+	m_pProfilerWindow->AddComponent(m_pProfilerStatusLabel);
+
 	m_pGUI->AddWindow(m_pMainWindow);
 	m_pGUI->AddWindow(m_pGameWindow);
 	m_pGUI->AddWindow(m_pConsoleWindow);
+	m_pGUI->AddWindow(m_pProfilerWindow);
 
 	UpdateCharactersPulldown();
 	UpdateWeaponsPulldown();
@@ -218,6 +274,7 @@ void VoxGame::SetupGUI()
 	m_pDebugRenderCheckBox->SetToggled(m_pVoxSettings->m_debugRendering);
 	m_pFaceMergingCheckbox->SetToggled(m_pVoxSettings->m_faceMerging);
 	m_pStepUpdateCheckbox->SetToggled(m_pVoxSettings->m_stepUpdating);
+	m_pProfilerCheckBox->SetToggled(m_pVoxSettings->m_profiler);
 
 	// Debug GUI
 	if(m_pVoxSettings->m_showDebugGUI)
@@ -270,6 +327,7 @@ void VoxGame::SkinGUI()
 	m_pFrontendManager->SetCheckboxIcons(m_pUpdateCheckBox);
 	m_pFrontendManager->SetCheckboxIcons(m_pDebugRenderCheckBox);
 	m_pFrontendManager->SetCheckboxIcons(m_pInstanceRenderCheckBox);
+	m_pFrontendManager->SetCheckboxIcons(m_pProfilerCheckBox);
 
 	m_pFrontendManager->SetOptionboxIcons(m_pGameOptionBox);
 	m_pFrontendManager->SetOptionboxIcons(m_pDebugOptionBox);
@@ -287,6 +345,8 @@ void VoxGame::SkinGUI()
 
 	m_pFrontendManager->SetButtonIcons(m_pPlayAnimationButton, ButtonSize_85x25);
 	m_pFrontendManager->SetButtonIcons(m_pStepUpdateButton, ButtonSize_65x25);
+	m_pFrontendManager->SetButtonIcons(m_pProfilerCaptureButton, ButtonSize_65x25);
+	m_pFrontendManager->SetButtonIcons(m_pProfilerExportButton, ButtonSize_65x25);
 
 	// Also skin the frontend pages
 	m_pFrontendManager->SkinGUI();
@@ -314,6 +374,7 @@ void VoxGame::UnSkinGUI()
 	m_pUpdateCheckBox->SetDefaultIcons(m_pRenderer);
 	m_pDebugRenderCheckBox->SetDefaultIcons(m_pRenderer);
 	m_pInstanceRenderCheckBox->SetDefaultIcons(m_pRenderer);
+	m_pProfilerCheckBox->SetDefaultIcons(m_pRenderer);
 
 	m_pGameOptionBox->SetDefaultIcons(m_pRenderer);
 	m_pDebugOptionBox->SetDefaultIcons(m_pRenderer);
@@ -329,6 +390,8 @@ void VoxGame::UnSkinGUI()
 
 	m_pPlayAnimationButton->SetDefaultIcons(m_pRenderer);
 	m_pStepUpdateButton->SetDefaultIcons(m_pRenderer);
+	m_pProfilerCaptureButton->SetDefaultIcons(m_pRenderer);
+	m_pProfilerExportButton->SetDefaultIcons(m_pRenderer);
 
 	m_pConsoleScrollbar->SetDefaultIcons(m_pRenderer);
 
@@ -377,10 +440,23 @@ void VoxGame::DestroyGUI()
 	delete m_pConsoleTextbox;
 	ClearConsoleLabels();
 	delete m_pConsoleScrollbar;
+	delete m_pProfilerWindow;
+	delete m_pProfilerCheckBox;
+	delete m_pProfilerCaptureButton;
+	delete m_pProfilerExportButton;
+	delete m_pProfilerStatusLabel;
+	for (unsigned int i = 0; i < m_vpProfilerLabels.size(); i++)
+	{
+		delete m_vpProfilerLabels[i];
+		m_vpProfilerLabels[i] = 0;
+	}
+	m_vpProfilerLabels.clear();
 }
 
 void VoxGame::UpdateGUI(float dt)
 {
+	PROFILE_ZONE("VoxGame::UpdateGUI");
+
 	// Depending on if deferred rendering is enabled, allow or disallow certain other graphic features
 	if (m_deferredRendering)
 	{
@@ -454,6 +530,9 @@ void VoxGame::UpdateGUI(float dt)
 
 	// Update console
 	UpdateConsoleLabels();
+
+	// Update profiler
+	UpdateProfilerLabels();
 }
 
 void VoxGame::GUITurnOffCursor()
@@ -475,6 +554,10 @@ void VoxGame::ShowGUI()
 	{
 		m_pConsoleWindow->Show();
 	}
+	if (m_pProfilerWindow->IsVisible() == false)
+	{
+		m_pProfilerWindow->Show();
+	}
 }
 
 void VoxGame::HideGUI()
@@ -491,6 +574,10 @@ void VoxGame::HideGUI()
 	{
 		m_pConsoleWindow->Hide();
 	}
+	if (m_pProfilerWindow->IsVisible() == true)
+	{
+		m_pProfilerWindow->Hide();
+	}
 }
 
 void VoxGame::UpdateCharactersPulldown()
@@ -682,6 +769,53 @@ void VoxGame::UpdateConsoleLabels()
 	}
 }
 
+void VoxGame::UpdateProfilerLabels()
+{
+	if (m_pProfilerWindow->IsVisible() == false || m_pProfilerWindow->GetMinimized())
+	{
+		return;
+	}
+
+	Profiler* pProfiler = Profiler::GetInstance();
+
+	char lString[128];
+	if (pProfiler->IsCapturing())
+	{
+		sprintf(lString, "Capturing %i zones", pProfiler->GetNumCaptureEvents());
+	}
+	else
+	{
+		sprintf(lString, "Captured %i zones, %i dropped", pProfiler->GetNumCaptureEvents(), pProfiler->GetNumDroppedEvents());
+	}
+	m_pProfilerStatusLabel->SetText(lString);
+
+	ProfileZoneStatsList vpZoneStats;
+	pProfiler->GetSortedZoneStats(&vpZoneStats);
+	for (int row = 0; row < PROFILER_NUM_ZONE_ROWS; row++)
+	{
+		Label** ppRowLabels = &m_vpProfilerLabels[(row + 1) * PROFILER_NUM_COLUMNS];
+
+		if (row >= (int)vpZoneStats.size())
+		{
+			for (int column = 0; column < PROFILER_NUM_COLUMNS; column++)
+			{
+				ppRowLabels[column]->SetText("");
+			}
+
+			continue;
+		}
+
+		ProfileZoneStats* pZoneStats = vpZoneStats[row];
+		ppRowLabels[0]->SetText(pZoneStats->m_name);
+		sprintf(lString, "%.2f", pZoneStats->m_averageTime);
+		ppRowLabels[1]->SetText(lString);
+		sprintf(lString, "%.2f", pZoneStats->m_p99Time);
+		ppRowLabels[2]->SetText(lString);
+		sprintf(lString, "%i", pZoneStats->m_lastFrameCalls);
+		ppRowLabels[3]->SetText(lString);
+	}
+}
+
 void VoxGame::ToggleFullScreenPressed()
 {
 	m_fullscreen = !m_fullscreen;
@@ -862,6 +996,52 @@ void VoxGame::StepUpdatePressed()
 	m_pChunkManager->StepNextUpdate();
 }
 
+void VoxGame::_ProfilerCheckboxChanged(void *apData)
+{
+	VoxGame* lpVoxGame = (VoxGame*)apData;
+	lpVoxGame->ProfilerCheckboxChanged();
+}
+
+void VoxGame::ProfilerCheckboxChanged()
+{
+	Profiler::GetInstance()->SetEnabled(m_pProfilerCheckBox->GetToggled());
+}
+
+void VoxGame::_ProfilerCapturePressed(void *apData)
+{
+	VoxGame* lpVoxGame = (VoxGame*)apData;
+	lpVoxGame->ProfilerCapturePressed();
+}
+
+void VoxGame::ProfilerCapturePressed()
+{
+	// Capturing needs the zones to be recorded
+	m_pProfilerCheckBox->SetToggled(true);
+	Profiler::GetInstance()->SetEnabled(true);
+	Profiler::GetInstance()->StartCapture();
+}
+
+void VoxGame::_ProfilerExportPressed(void *apData)
+{
+	VoxGame* lpVoxGame = (VoxGame*)apData;
+	lpVoxGame->ProfilerExportPressed();
+}
+
+void VoxGame::ProfilerExportPressed()
+{
+	Profiler* pProfiler = Profiler::GetInstance();
+	pProfiler->StopCapture();
+
+	if (pProfiler->WriteChromeTrace("logs/profile.json") && pProfiler->WriteCSV("logs/profile.csv"))
+	{
+		AddConsoleLabel("Profile capture written to logs/profile.json and logs/profile.csv");
+	}
+	else
+	{
+		AddConsoleLabel("Failed to write the profile capture to the logs folder");
+	}
+}
+
 void VoxGame::_ConsoleReturnPressed(void *apData)
 {
 	VoxGame* lpVoxGame = (VoxGame*)apData;
@@ -13,6 +13,7 @@
 
 #include "VoxGame.h"
 #include "utils/Interpolator.h"
+#include "utils/Profiler.h"
 #include <glm/detail/func_geometric.hpp>
 
 #if defined(__linux__) || defined(__APPLE__)
@@ -56,6 +57,11 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_GUICreated = false;
 
 	m_pVoxSettings = pVoxSettings;
+
+	// Create the profiler before any of the other threads are started
+	Profiler::GetInstance()->SetEnabled(m_pVoxSettings->m_profiler);
+	PROFILE_THREAD_NAME("Main");
+
 	m_pVoxWindow = new VoxWindow(this, m_pVoxSettings);
 
 	// Create the window
@@ -75,6 +81,10 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_deltaTime = 0.0f;
 	m_fps = 0.0f;
 
+	/* Fixed simulation timestep */
+	m_pSimulationTimestep = new FixedTimestep(m_pVoxSettings->m_simulationTickRate);
+	m_cameraRenderInterpolationOffset = vec3(0.0f, 0.0f, 0.0f);
+
 	/* Mouse name picking */
 	m_pickedObject = -1;
 	m_bNamePickingSelected = false;
@@ -180,6 +190,7 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_shadowShader = -1;
 	m_waterShader = -1;
 	m_lightingShader = -1;
+	m_clusteredLightingShader = -1;
 	m_cubeMapShader = -1;
 	m_textureShader = -1;
 	m_fxaaShader = -1;
@@ -194,6 +205,7 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/SSAO.vertex", "media/shaders/fullscreen/SSAO.pixel", &m_SSAOShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/fxaa.vertex", "media/shaders/fullscreen/fxaa.pixel", &m_fxaaShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/lighting.vertex", "media/shaders/fullscreen/lighting.pixel", &m_lightingShader);
+	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/lighting_clustered.vertex", "media/shaders/fullscreen/lighting_clustered.pixel", &m_clusteredLightingShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/cube_map.vertex", "media/shaders/cube_map.pixel", &m_cubeMapShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/blur_vertical.vertex", "media/shaders/fullscreen/blur_vertical.pixel", &m_blurVerticalShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/blur_horizontal.vertex", "media/shaders/fullscreen/blur_horizontal.pixel", &m_blurHorizontalShader);
@@ -215,6 +227,7 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 
 	/* Create the biome manager */
 	m_pBiomeManager = new BiomeManager(m_pRenderer);
+	m_pBiomeManager->SetWorldSeed(m_pVoxSettings->m_worldSeed);
 
 	/* Create the lighting manager */
 	m_pLightingManager = new LightingManager(m_pRenderer);
@@ -235,6 +248,24 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	/* Create the instance manager */
 	m_pInstanceManager = new InstanceManager(m_pRenderer);
 
+	/* Create the visibility culler */
+	m_pVisibilityCuller = new VisibilityCuller();
+	// The water reflections only render the chunks and the player
+	unsigned int entityPasses = (1 << RenderPass_Main) | (1 << RenderPass_Shadow);
+	m_pVisibilityCuller->SetTypePasses(VisibilityType_NPC, entityPasses);
+	m_pVisibilityCuller->SetTypePasses(VisibilityType_Enemy, entityPasses);
+	m_pVisibilityCuller->SetTypePasses(VisibilityType_Item, entityPasses);
+	m_pVisibilityCuller->SetTypePasses(VisibilityType_Scenery, entityPasses);
+
+	/* Create the mouse picking hierarchy */
+	m_pPickingBVH = new PickingBVH();
+
+	/* Create the spatial grid, one cell per chunk column */
+	m_pSpatialGrid = new SpatialGrid(Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f);
+
+	/* Create the parallel entity update */
+	m_pEntityUpdate = new ParallelUpdate(m_pVoxSettings->m_entityUpdateThreads);
+
 	/* Create the player */
 	m_pPlayer = new Player(m_pRenderer, m_pChunkManager, m_pQubicleBinaryManager, m_pLightingManager, m_pBlockParticleManager);
 
@@ -302,6 +333,8 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_pNPCManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pNPCManager->SetProjectileManager(m_pProjectileManager);
 	m_pNPCManager->SetEnemyManager(m_pEnemyManager);
+	m_pNPCManager->SetSpatialGrid(m_pSpatialGrid);
+	m_pNPCManager->SetParallelUpdate(m_pEntityUpdate);
 	m_pEnemyManager->SetLightingManager(m_pLightingManager);
 	m_pEnemyManager->SetBlockParticleManager(m_pBlockParticleManager);
 	m_pEnemyManager->SetTextEffectsManager(m_pTextEffectsManager);
@@ -310,6 +343,8 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_pEnemyManager->SetHUD(m_pHUD);
 	m_pEnemyManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pEnemyManager->SetNPCManager(m_pNPCManager);
+	m_pEnemyManager->SetSpatialGrid(m_pSpatialGrid);
+	m_pEnemyManager->SetParallelUpdate(m_pEntityUpdate);
 	m_pInventoryManager->SetPlayer(m_pPlayer);
 	m_pInventoryManager->SetInventoryGUI(m_pInventoryGUI);
 	m_pInventoryManager->SetLootGUI(m_pLootGUI);
@@ -319,10 +354,14 @@ void VoxGame::Create(VoxSettings* pVoxSettings)
 	m_pItemManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pItemManager->SetInventoryManager(m_pInventoryManager);
 	m_pItemManager->SetNPCManager(m_pNPCManager);
+	m_pItemManager->SetSpatialGrid(m_pSpatialGrid);
+	m_pItemManager->SetParallelUpdate(m_pEntityUpdate);
 	m_pProjectileManager->SetLightingManager(m_pLightingManager);
 	m_pProjectileManager->SetBlockParticleManager(m_pBlockParticleManager);
 	m_pProjectileManager->SetPlayer(m_pPlayer);
 	m_pProjectileManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
+	m_pProjectileManager->SetSpatialGrid(m_pSpatialGrid);
+	m_pProjectileManager->SetParallelUpdate(m_pEntityUpdate);
 	m_pQuestManager->SetNPCManager(m_pNPCManager);
 	m_pQuestManager->SetInventoryManager(m_pInventoryManager);
 	m_pQuestManager->SetQuestJournal(m_pQuestJournal);
@@ -461,11 +500,16 @@ void VoxGame::Destroy()
 		delete m_pPlayer;
 		delete m_pNPCManager;
 		delete m_pEnemyManager;
+		delete m_pSpatialGrid;
+		delete m_pEntityUpdate;
+		delete m_pSimulationTimestep;
 		delete m_pLightingManager;
 		delete m_pSceneryManager;
 		delete m_pBlockParticleManager;
 		delete m_pTextEffectsManager;
 		delete m_pInstanceManager;
+		delete m_pVisibilityCuller;
+		delete m_pPickingBVH;
 		delete m_pBiomeManager;
 		delete m_pQubicleBinaryManager;
 		delete m_pModsManager;
@@ -484,6 +528,9 @@ void VoxGame::Destroy()
 
 		AudioManager::GetInstance()->Shutdown();
 
+		// All the threads that write profile zones have been joined by now
+		Profiler::GetInstance()->Destroy();
+
 		m_pVoxWindow->Destroy();
 
 		delete m_pVoxWindow;
@@ -40,6 +40,11 @@
 #include "Projectile/ProjectileManager.h"
 #include "TextEffects/TextEffectsManager.h"
 #include "Mods/ModsManager.h"
+#include "utils/SpatialGrid.h"
+#include "utils/ParallelUpdate.h"
+#include "utils/FixedTimestep.h"
+#include "Renderer/visibilityculler.h"
+#include "utils/PickingBVH.h"
 #include "AudioManager/AudioManager.h"
 #include "AudioManager/SoundEffectsEnum.h"
 #include "VoxWindow.h"
@@ -207,6 +212,8 @@ public:
 
 	// Updating
 	void Update();
+	void UpdateSimulation(float dt);
+	void StorePreviousSimulationPositions();
 	void UpdateNamePicking();
 	void UpdatePlayerAlpha(float dt);
 	void UpdateLights(float dt);
@@ -215,6 +222,9 @@ public:
 
 	// Rendering
 	void PreRender();
+	void ApplyCameraRenderInterpolation();
+	void RemoveCameraRenderInterpolation();
+	void CullScene();
 	void BeginShaderRender();
 	void EndShaderRender();
 	void Render();
@@ -223,6 +233,7 @@ public:
 	void RenderWaterReflections();
 	void RenderWater();
 	void RenderDeferredLighting();
+	void RenderClusteredDeferredLighting();
 	void RenderTransparency();
 	void RenderSSAOTexture();
 	void RenderFXAATexture();
@@ -259,6 +270,7 @@ public:
 	void AddConsoleLabel(string message);
 	void ClearConsoleLabels();
 	void UpdateConsoleLabels();
+	void UpdateProfilerLabels();
 	void ToggleFullScreenPressed();
 
 	// Accessors
@@ -313,6 +325,15 @@ protected:
 
 	static void _ConsoleReturnPressed(void *apData);
 	void ConsoleReturnPressed();
+
+	static void _ProfilerCheckboxChanged(void *apData);
+	void ProfilerCheckboxChanged();
+
+	static void _ProfilerCapturePressed(void *apData);
+	void ProfilerCapturePressed();
+
+	static void _ProfilerExportPressed(void *apData);
+	void ProfilerExportPressed();
 	
 private:
 	/* Private methods */
@@ -362,6 +383,12 @@ private:
 	// Projectile manager
 	ProjectileManager* m_pProjectileManager;
 
+	// Spatial grid, shared by the enemy, NPC, item and projectile managers
+	SpatialGrid* m_pSpatialGrid;
+
+	// Parallel update, shared by the enemy, NPC, item and projectile managers
+	ParallelUpdate* m_pEntityUpdate;
+
 	// Quest manager
 	QuestManager* m_pQuestManager;
 
@@ -392,6 +419,12 @@ private:
 	// Instance manager
 	InstanceManager* m_pInstanceManager;
 
+	// Per frame visibility lists for the render passes
+	VisibilityCuller* m_pVisibilityCuller;
+
+	// Mouse picking against the rendered NPCs
+	PickingBVH* m_pPickingBVH;
+
 	// Frontend manager
 	FrontendManager* m_pFrontendManager;
 
@@ -467,6 +500,7 @@ private:
 	unsigned int m_shadowShader;
 	unsigned int m_waterShader;
 	unsigned int m_lightingShader;
+	unsigned int m_clusteredLightingShader;
 	unsigned int m_cubeMapShader;
 	unsigned int m_textureShader;
 	unsigned int m_fxaaShader;
@@ -504,6 +538,10 @@ private:
 	float m_deltaTime;
 	float m_fps;
 
+	// Fixed simulation timestep, rendering interpolates between the last two simulation steps
+	FixedTimestep* m_pSimulationTimestep;
+	vec3 m_cameraRenderInterpolationOffset;
+
 	// Initial starting wait timer
 	float m_initialWaitTimer;
 	float m_initialWaitTime;
@@ -637,6 +675,12 @@ private:
 	vector<Label*> m_vpConsoleLabels;
 	vector<Label*> m_vpConsoleLabels_Add;
 	vector<string> m_vStringCache;
+	GUIWindow* m_pProfilerWindow;
+	CheckBox* m_pProfilerCheckBox;
+	Button* m_pProfilerCaptureButton;
+	Button* m_pProfilerExportButton;
+	Label* m_pProfilerStatusLabel;
+	vector<Label*> m_vpProfilerLabels;
 
 	// Toggle flags
 	bool m_deferredRendering;
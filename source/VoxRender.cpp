@@ -10,6 +10,7 @@
 // ******************************************************************************
 
 #include "VoxGame.h"
+#include "utils/Profiler.h"
 
 #include <glm/detail/func_geometric.hpp>
 
@@ -17,12 +18,69 @@
 // Rendering
 void VoxGame::PreRender()
 {
-	// Update matrices for game objects
-	m_pPlayer->CalculateWorldTransformMatrix();
-	m_pNPCManager->CalculateWorldTransformMatrix();
-	m_pEnemyManager->CalculateWorldTransformMatrix();
-	m_pItemManager->CalculateWorldTransformMatrix();
-	m_pProjectileManager->CalculateWorldTransformMatrix();
+	PROFILE_ZONE("VoxGame::PreRender");
+
+	// Update matrices for game objects, in between the last two simulation steps
+	float interpolation = m_pSimulationTimestep->GetInterpolation();
+	m_pPlayer->CalculateWorldTransformMatrix(interpolation);
+	m_pNPCManager->CalculateWorldTransformMatrix(interpolation);
+	m_pEnemyManager->CalculateWorldTransformMatrix(interpolation);
+	m_pItemManager->CalculateWorldTransformMatrix(interpolation);
+	m_pProjectileManager->CalculateWorldTransformMatrix(interpolation);
+}
+
+void VoxGame::ApplyCameraRenderInterpolation()
+{
+	m_cameraRenderInterpolationOffset = vec3(0.0f, 0.0f, 0.0f);
+
+	// The game cameras follow the player, so they need the same interpolation, otherwise the player jitters against the camera
+	if (m_gameMode == GameMode_Game && m_cameraMode != CameraMode_Debug)
+	{
+		float interpolation = m_pSimulationTimestep->GetInterpolation();
+		m_cameraRenderInterpolationOffset = m_pPlayer->GetInterpolatedPosition(interpolation) - m_pPlayer->GetPosition();
+	}
+
+	m_pGameCamera->SetPosition(m_pGameCamera->GetPosition() + m_cameraRenderInterpolationOffset);
+}
+
+void VoxGame::RemoveCameraRenderInterpolation()
+{
+	m_pGameCamera->SetPosition(m_pGameCamera->GetPosition() - m_cameraRenderInterpolationOffset);
+
+	m_cameraRenderInterpolationOffset = vec3(0.0f, 0.0f, 0.0f);
+}
+
+void VoxGame::CullScene()
+{
+	PROFILE_ZONE("VoxGame::CullScene");
+
+	m_pVisibilityCuller->StartFrame();
+
+	// Main pass, the same frustum that the game camera sets up in Look()
+	Frustum* pViewFrustum = m_pRenderer->GetFrustum(m_defaultViewport);
+	vec3 cameraPosition = m_pGameCamera->GetPosition();
+	m_pVisibilityCuller->SetCameraFrustum(pViewFrustum->angle, pViewFrustum->ratio, pViewFrustum->nearDistance, pViewFrustum->farDistance, cameraPosition, cameraPosition + m_pGameCamera->GetFacing(), m_pGameCamera->GetUp());
+
+	// Shadow pass, the same orthographic box that RenderShadows() renders
+	if (m_pVoxSettings->m_shadows)
+	{
+		float loaderRadius = m_pChunkManager->GetLoaderRadius();
+		vec3 lightPos = m_defaultLightPosition + m_pPlayer->GetCenter();
+		m_pVisibilityCuller->SetShadowFrustum(loaderRadius*2.0f, loaderRadius*2.0f, 0.01f, 1000.0f, lightPos, m_pPlayer->GetCenter(), vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	// Water reflection pass
+	if (m_pVoxSettings->m_waterRendering && m_pChunkManager->IsUnderWater(cameraPosition) == false && m_gameMode != GameMode_FrontEnd)
+	{
+		m_pVisibilityCuller->SetReflectionFrustum(m_pChunkManager->GetWaterHeight());
+	}
+
+	// Every manager culls its objects against all of the passes in one go
+	m_pChunkManager->CullChunks(m_pVisibilityCuller);
+	m_pNPCManager->CullNPCs(m_pVisibilityCuller);
+	m_pEnemyManager->CullEnemies(m_pVisibilityCuller);
+	m_pItemManager->CullItems(m_pVisibilityCuller);
+	m_pSceneryManager->CullScenery(m_pVisibilityCuller);
 }
 
 void VoxGame::BeginShaderRender()
@@ -77,12 +135,20 @@ void VoxGame::EndShaderRender()
 
 void VoxGame::Render()
 {
+	PROFILE_ZONE("VoxGame::Render");
+
 	if (m_pVoxWindow->GetMinimized())
 	{
 		// Don't call any render functions if minimized
 		return;
 	}
 
+	// Move the camera along with the rendered player
+	ApplyCameraRenderInterpolation();
+
+	// Build the visible lists for the shadow, reflection and main passes
+	CullScene();
+
 	// Begin rendering
 	m_pRenderer->BeginScene(true, true, true);
 
@@ -154,7 +220,7 @@ void VoxGame::Render()
 			BeginShaderRender();
 			{
 				// Render the chunks
-				m_pChunkManager->Render(false);
+				m_pChunkManager->Render(RenderPass_Main);
 			}
 			EndShaderRender();
 
@@ -410,6 +476,9 @@ void VoxGame::Render()
 	// End rendering
 	m_pRenderer->EndScene();
 
+	// Put the camera back to the simulation position, the updates work from there
+	RemoveCameraRenderInterpolation();
+
 
 	// Pass render call to the window class, allow to swap buffers
 	m_pVoxWindow->Render();
@@ -447,6 +516,8 @@ void VoxGame::RenderSkybox()
 
 void VoxGame::RenderShadows()
 {
+	PROFILE_ZONE("VoxGame::RenderShadows");
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->StartRenderingToFrameBuffer(m_shadowFrameBuffer);
 		m_pRenderer->SetColourMask(false, false, false, false);
@@ -460,7 +531,7 @@ void VoxGame::RenderShadows()
 			m_pRenderer->SetCullMode(CM_FRONT);
 
 			// Render the chunks
-			m_pChunkManager->Render(true);
+			m_pChunkManager->Render(RenderPass_Shadow);
 
 			if (m_gameMode != GameMode_FrontEnd)
 			{
@@ -504,6 +575,8 @@ void VoxGame::RenderShadows()
 
 void VoxGame::RenderWaterReflections()
 {
+	PROFILE_ZONE("VoxGame::RenderWaterReflections");
+
 	m_pRenderer->StartRenderingToFrameBuffer(m_waterReflectionFrameBuffer);
 
 	if (m_pChunkManager->IsUnderWater(m_pGameCamera->GetPosition()) == false)
@@ -518,7 +591,7 @@ void VoxGame::RenderWaterReflections()
 			m_pRenderer->EnableClipPlane(0, 0.0f, 1.0f, 0.0f, -m_pChunkManager->GetWaterHeight());
 
 			// Render the chunks
-			m_pChunkManager->Render(true);
+			m_pChunkManager->Render(RenderPass_Reflection);
 
 			// Player
 			if (m_gameMode != GameMode_FrontEnd)
@@ -560,6 +633,8 @@ void VoxGame::RenderWaterReflections()
 
 void VoxGame::RenderWater()
 {
+	PROFILE_ZONE("VoxGame::RenderWater");
+
 	m_pRenderer->PushMatrix();
 
 	m_pRenderer->BeginGLSLShader(m_waterShader);
@@ -621,6 +696,14 @@ void VoxGame::RenderWater()
 
 void VoxGame::RenderDeferredLighting()
 {
+	PROFILE_ZONE("VoxGame::RenderDeferredLighting");
+
+	if (m_pVoxSettings->m_clusteredLighting && m_clusteredLightingShader != -1)
+	{
+		RenderClusteredDeferredLighting();
+		return;
+	}
+
 	// Render deferred lighting to light frame buffer
 	m_pRenderer->PushMatrix();
 		m_pRenderer->StartRenderingToFrameBuffer(m_lightingFrameBuffer);
@@ -707,6 +790,98 @@ void VoxGame::RenderDeferredLighting()
 	m_pRenderer->PopMatrix();
 }
 
+void VoxGame::RenderClusteredDeferredLighting()
+{
+	PROFILE_ZONE("VoxGame::RenderClusteredDeferredLighting");
+
+	// Bin the lights for the same camera that rendered the G-buffer, then light every pixel in one full screen pass
+	Frustum* pViewFrustum = m_pRenderer->GetFrustum(m_defaultViewport);
+	vec3 cameraPosition = m_pGameCamera->GetPosition();
+	m_pLightingManager->BuildClusterGrid(m_windowWidth, m_windowHeight, pViewFrustum->angle, 1.0f, m_pChunkManager->GetLoaderRadius(), cameraPosition, cameraPosition + m_pGameCamera->GetFacing(), m_pGameCamera->GetUp());
+	m_pLightingManager->UploadClusterGrid();
+	LightClusterGrid* pClusterGrid = m_pLightingManager->GetClusterGrid();
+
+	m_pRenderer->PushMatrix();
+		m_pRenderer->StartRenderingToFrameBuffer(m_lightingFrameBuffer);
+
+		m_pRenderer->EnableTransparency(BF_ONE, BF_ONE);
+		m_pRenderer->DisableDepthTest();
+
+		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
+		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+		m_pRenderer->BeginGLSLShader(m_clusteredLightingShader);
+		glShader* pLightShader = m_pRenderer->GetShader(m_clusteredLightingShader);
+
+		unsigned int NormalsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "normals");
+		m_pRenderer->PrepareShaderTexture(0, NormalsID);
+		m_pRenderer->BindRawTextureId(m_pRenderer->GetNormalTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+		unsigned int PositionsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "positions");
+		m_pRenderer->PrepareShaderTexture(1, PositionsID);
+		m_pRenderer->BindRawTextureId(m_pRenderer->GetPositionTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+		unsigned int DepthsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "depths");
+		m_pRenderer->PrepareShaderTexture(2, DepthsID);
+		m_pRenderer->BindRawTextureId(m_pRenderer->GetDepthTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+		unsigned int LightsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "lights");
+		m_pRenderer->PrepareShaderTexture(3, LightsID);
+		m_pRenderer->BindTexture(m_pLightingManager->GetClusterLightsTexture());
+
+		unsigned int ClustersID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "clusters");
+		m_pRenderer->PrepareShaderTexture(4, ClustersID);
+		m_pRenderer->BindTexture(m_pLightingManager->GetClusterGridTexture());
+
+		unsigned int LightIndicesID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "lightIndices");
+		m_pRenderer->PrepareShaderTexture(5, LightIndicesID);
+		m_pRenderer->BindTexture(m_pLightingManager->GetClusterIndicesTexture());
+
+		pLightShader->setUniform1f("lightsHeight", (float)m_pLightingManager->GetClusterLightsTextureHeight());
+		pLightShader->setUniform1f("clustersHeight", (float)m_pLightingManager->GetClusterGridTextureHeight());
+		pLightShader->setUniform1f("lightIndicesHeight", (float)m_pLightingManager->GetClusterIndicesTextureHeight());
+
+		pLightShader->setUniform1f("tileSize", (float)pClusterGrid->GetTileSize());
+		pLightShader->setUniform1f("numTilesX", (float)pClusterGrid->GetNumTilesX());
+		pLightShader->setUniform1f("numTilesY", (float)pClusterGrid->GetNumTilesY());
+		pLightShader->setUniform1f("numSlices", (float)pClusterGrid->GetNumSlices());
+		pLightShader->setUniform1f("sliceScale", pClusterGrid->GetSliceScale());
+		pLightShader->setUniform1f("sliceBias", pClusterGrid->GetSliceBias());
+
+		pLightShader->setUniform1i("screenWidth", m_windowWidth);
+		pLightShader->setUniform1i("screenHeight", m_windowHeight);
+		pLightShader->setUniform1f("nearZ", 0.01f);
+		pLightShader->setUniform1f("farZ", 1000.0f);
+
+		m_pRenderer->SetRenderMode(RM_TEXTURED);
+		m_pRenderer->EnableImmediateMode(IM_QUADS);
+			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
+			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
+			m_pRenderer->ImmediateVertex((float)m_windowWidth, 0.0f, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
+			m_pRenderer->ImmediateVertex((float)m_windowWidth, (float)m_windowHeight, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
+			m_pRenderer->ImmediateVertex(0.0f, (float)m_windowHeight, 1.0f);
+		m_pRenderer->DisableImmediateMode();
+
+		m_pRenderer->EmptyTextureIndex(5);
+		m_pRenderer->EmptyTextureIndex(4);
+		m_pRenderer->EmptyTextureIndex(3);
+		m_pRenderer->EmptyTextureIndex(2);
+		m_pRenderer->EmptyTextureIndex(1);
+		m_pRenderer->EmptyTextureIndex(0);
+
+		m_pRenderer->EndGLSLShader(m_clusteredLightingShader);
+
+		m_pRenderer->DisableTransparency();
+		m_pRenderer->EnableDepthTest(DT_LESS);
+
+		m_pRenderer->StopRenderingToFrameBuffer(m_lightingFrameBuffer);
+
+	m_pRenderer->PopMatrix();
+}
+
 void VoxGame::RenderTransparency()
 {
 	m_pRenderer->PushMatrix();
@@ -753,6 +928,8 @@ void VoxGame::RenderTransparency()
 
 void VoxGame::RenderSSAOTexture()
 {
+	PROFILE_ZONE("VoxGame::RenderSSAOTexture");
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
 		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
@@ -833,6 +1010,8 @@ void VoxGame::RenderSSAOTexture()
 
 void VoxGame::RenderFXAATexture()
 {
+	PROFILE_ZONE("VoxGame::RenderFXAATexture");
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
 		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
@@ -972,6 +1151,8 @@ void VoxGame::RenderSecondPassFullScreen()
 
 void VoxGame::RenderGUI()
 {
+	PROFILE_ZONE("VoxGame::RenderGUI");
+
 	m_pRenderer->EmptyTextureIndex(0);
 
 	// Render the GUI
@@ -1397,9 +1578,16 @@ void VoxGame::RenderDebugInformation()
 		m_pGameCamera->GetZoomAmount());
 
 	char lDrawingBuff[256];
-	sprintf(lDrawingBuff, "Vertices: %i, Faces: %i", m_pRenderer->GetNumRenderedVertices(), m_pRenderer->GetNumRenderedFaces());
-	char lChunksBuff[256];
-	sprintf(lChunksBuff, "Chunks: %i, Render: %i", m_pChunkManager->GetNumChunksLoaded(), m_pChunkManager->GetNumChunksRender());
+	sprintf(lDrawingBuff, "Vertices: %i, Faces: %i, Instance uploads: %i bytes, %i allocations", m_pRenderer->GetNumRenderedVertices(), m_pRenderer->GetNumRenderedFaces(), m_pRenderer->GetNumInstanceBufferBytes(), m_pRenderer->GetNumInstanceBufferAllocations());
+	char lChunksBuff[512];
+	sprintf(lChunksBuff, "Chunks: %i, Render: %i, Workers: %i, Generated: %i (%.1f/s), Templates: %i hits, %i misses, Blocks: %.1f MB, Stored: %i edits %.1f KB, Applied: %i in %.1f ms", m_pChunkManager->GetNumChunksLoaded(), m_pChunkManager->GetNumChunksRender(), m_pChunkManager->GetNumChunkWorkers(), m_pChunkManager->GetNumChunksGenerated(), m_pChunkManager->GetChunksPerSecond(), m_pChunkManager->GetQubicleTemplateCache()->GetNumCacheHits(), m_pChunkManager->GetQubicleTemplateCache()->GetNumCacheMisses(), ChunkPaletteStorage::GetTotalMemoryBytes() / (1024.0f * 1024.0f), m_pChunkManager->GetChunkStorageTable()->GetNumEdits(), m_pChunkManager->GetChunkStorageTable()->GetMemoryBytes() / 1024.0f, m_pChunkManager->GetChunkStorageTable()->GetNumEditsApplied(), m_pChunkManager->GetChunkStorageTable()->GetApplyMilliseconds());
+	char lChunkLODBuff[256];
+	sprintf(lChunkLODBuff, "Chunk LOD: %s, Full: %i (%i tris), 2x: %i (%i tris), 4x: %i (%i tris), 8x: %i (%i tris)", m_pChunkManager->GetChunkLOD() ? "On" : "Off", m_pChunkManager->GetNumChunksRenderLOD(0), m_pChunkManager->GetNumTrianglesRenderLOD(0), m_pChunkManager->GetNumChunksRenderLOD(1), m_pChunkManager->GetNumTrianglesRenderLOD(1), m_pChunkManager->GetNumChunksRenderLOD(2), m_pChunkManager->GetNumTrianglesRenderLOD(2), m_pChunkManager->GetNumChunksRenderLOD(3), m_pChunkManager->GetNumTrianglesRenderLOD(3));
+	char lCullingBuff[256];
+	sprintf(lCullingBuff, "Culling: Main: %i, Shadow: %i, Reflection: %i (Chunks: %i, %i, %i)", m_pVisibilityCuller->GetNumVisible(RenderPass_Main), m_pVisibilityCuller->GetNumVisible(RenderPass_Shadow), m_pVisibilityCuller->GetNumVisible(RenderPass_Reflection), m_pVisibilityCuller->GetNumVisible(RenderPass_Main, VisibilityType_Chunk), m_pVisibilityCuller->GetNumVisible(RenderPass_Shadow, VisibilityType_Chunk), m_pVisibilityCuller->GetNumVisible(RenderPass_Reflection, VisibilityType_Chunk));
+	char lLightsBuff[256];
+	LightClusterGrid* pClusterGrid = m_pLightingManager->GetClusterGrid();
+	sprintf(lLightsBuff, "Lights: %i, Clustered: %i, Binned: %i, Cluster lights: %i, Max: %i, Overflows: %i", m_pLightingManager->GetNumLights(), m_pVoxSettings->m_clusteredLighting, pClusterGrid->GetNumLightsBinned(), pClusterGrid->GetNumIndices(), pClusterGrid->GetMaxClusterCount(), pClusterGrid->GetNumOverflowClusters());
 	char lParticlesBuff[256];
 	sprintf(lParticlesBuff, "Particles: %i, Render: %i, Emitters: %i, Effects: %i", m_pBlockParticleManager->GetNumBlockParticles(), m_pBlockParticleManager->GetNumRenderableParticles(false), m_pBlockParticleManager->GetNumBlockParticleEmitters(), m_pBlockParticleManager->GetNumBlockParticleEffects());
 	char lItemsBuff[256];
@@ -1410,6 +1598,8 @@ void VoxGame::RenderDebugInformation()
 	sprintf(lEnemiesBuff, "Enemies: %i, Render: %i", m_pEnemyManager->GetNumEnemies(), m_pEnemyManager->GetNumRenderEnemies());
 	char lProjectilesBuff[256];
 	sprintf(lProjectilesBuff, "Projectiles: %i, Render: %i", m_pProjectileManager->GetNumProjectiles(), m_pProjectileManager->GetNumRenderProjectiles());
+	char lEntityUpdateBuff[256];
+	sprintf(lEntityUpdateBuff, "Simulation: %i Hz, %i steps, Entity update: %i threads, %i updated, %i deferred", m_pSimulationTimestep->GetTickRate(), m_pSimulationTimestep->GetNumSteps(), m_pEntityUpdate->GetNumThreads(), m_pEntityUpdate->GetNumItemsUpdated(), m_pEntityUpdate->GetNumDeferredCommands());
 	char lInstancesBuff[256];
 	sprintf(lInstancesBuff,  "Instance Parents: %i, Instance Objects: %i, Instance Render: %i", m_pInstanceManager->GetNumInstanceParents(), m_pInstanceManager->GetTotalNumInstanceObjects(), m_pInstanceManager->GetTotalNumInstanceRenderObjects());
 
@@ -1445,12 +1635,16 @@ void VoxGame::RenderDebugInformation()
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 1) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lCameraBuff);
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight*2) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lDrawingBuff);
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 3) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lChunksBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 4) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lParticlesBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 5) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lItemsBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 6) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lNPCBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 7) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lEnemiesBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 8) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lProjectilesBuff);
-			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 9) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lInstancesBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 4) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lChunkLODBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 5) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lCullingBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 6) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lLightsBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 7) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lParticlesBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 8) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lItemsBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 9) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lNPCBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 10) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lEnemiesBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 11) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lProjectilesBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 12) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lEntityUpdateBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (l_nTextHeight * 13) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lInstancesBuff);
 		}
 
 		if (STEAM_BUILD == false)
@@ -53,8 +53,14 @@ void VoxSettings::LoadSettings()
 	m_msaa = reader.GetBoolean("Graphics", "MSAA", false);
 	m_instancedParticles = reader.GetBoolean("Graphics", "InstancedParticles", false);
 	m_faceMerging = reader.GetBoolean("Graphics", "FaceMerging", false);
+	m_greedyMeshing = reader.GetBoolean("Graphics", "GreedyMeshing", false);
+	m_chunkLOD = reader.GetBoolean("Graphics", "ChunkLOD", false);
+	m_chunkLODDistance = (float)reader.GetReal("Graphics", "ChunkLODDistance", 32.0f);
+	m_clusteredLighting = reader.GetBoolean("Graphics", "ClusteredLighting", false);
 
 	// Landscape generation
+	m_worldName = reader.Get("Landscape", "WorldName", "world");
+	m_worldSeed = (unsigned int)reader.GetInteger("Landscape", "WorldSeed", 0);
 	m_landscapeOctaves = (float)reader.GetReal("Landscape", "LandscapeOctaves", 4.0f);
 	m_landscapePersistence = (float)reader.GetReal("Landscape", "LandscapePersistance", 0.3f);
 	m_landscapeScale = (float)reader.GetReal("Landscape", "LandscapeScale", 0.01f);
@@ -63,12 +69,20 @@ void VoxSettings::LoadSettings()
 	m_mountainScale = (float)reader.GetReal("Landscape", "MountainScale", 0.0075f);
 	m_mountainMultiplier = (float)reader.GetReal("Landscape", "MountainMultiplier", 3.0f);
 
+	// Threading
+	m_chunkWorkerThreads = reader.GetInteger("Threading", "ChunkWorkerThreads", 0);
+	m_entityUpdateThreads = reader.GetInteger("Threading", "EntityUpdateThreads", 0);
+
+	// Simulation
+	m_simulationTickRate = reader.GetInteger("Simulation", "TickRate", 60);
+
 	// Debug
 	m_loaderRadius = (float)reader.GetReal("Debug", "LoaderRadius", 64.0f);
 	m_debugRendering = reader.GetBoolean("Debug", "DebugRendering", false);
 	m_stepUpdating = reader.GetBoolean("Debug", "StepUpdatng", false);
 	m_wireframeRendering = reader.GetBoolean("Debug", "WireframeRendering", false);
 	m_showDebugGUI = reader.GetBoolean("Debug", "ShowDebugGUI", true);
+	m_profiler = reader.GetBoolean("Debug", "Profiler", false);
 	m_gameMode = reader.Get("Debug", "GameMode", "Debug");
 	m_version = reader.Get("Debug", "Version", "1.0");
 }
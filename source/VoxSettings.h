@@ -90,8 +90,14 @@ public:
 	bool m_msaa;
 	bool m_instancedParticles;
 	bool m_faceMerging;
+	bool m_greedyMeshing;
+	bool m_chunkLOD;
+	float m_chunkLODDistance;
+	bool m_clusteredLighting;
 
 	// Landscape generation
+	string m_worldName;
+	unsigned int m_worldSeed;
 	float m_landscapeOctaves;
 	float m_landscapePersistence;
 	float m_landscapeScale;
@@ -100,12 +106,20 @@ public:
 	float m_mountainScale;
 	float m_mountainMultiplier;
 
+	// Threading
+	int m_chunkWorkerThreads;
+	int m_entityUpdateThreads;
+
+	// Simulation
+	int m_simulationTickRate;
+
 	// Debug
 	float m_loaderRadius;
 	bool m_debugRendering;
 	bool m_wireframeRendering;
 	bool m_stepUpdating;
 	bool m_showDebugGUI;
+	bool m_profiler;
 	string m_gameMode;
 	string m_version;
 
@@ -10,6 +10,7 @@
 // ******************************************************************************
 
 #include "VoxGame.h"
+#include "utils/Profiler.h"
 
 #include "utils/Interpolator.h"
 #include "utils/TimeManager.h"
@@ -22,6 +23,8 @@
 // Updating
 void VoxGame::Update()
 {
+	PROFILE_ZONE("VoxGame::Update");
+
 	// FPS
 #ifdef _WIN32
 	QueryPerformanceCounter(&m_fpsCurrentTicks);
@@ -83,64 +86,12 @@ void VoxGame::Update()
 	}
 	UpdateMusicVolume(0.0f);
 
-	// Main components update
-	if (m_bPaused == false && m_initialStartWait == false)
+	// Simulation, a fixed number of steps per second, or a single step of the frame time if there is no tick rate
+	m_pEntityUpdate->ResetCounters();
+	int numSimulationSteps = m_pSimulationTimestep->Update(m_deltaTime);
+	for (int i = 0; i < numSimulationSteps; i++)
 	{
-		// Update the lighting manager
-		m_pLightingManager->Update(m_deltaTime);
-
-		// Block particle manager
-		m_pBlockParticleManager->Update(m_deltaTime);
-
-		// Instance manager
-		m_pInstanceManager->Update(m_deltaTime);
-
-		// Scenery manager
-		m_pSceneryManager->Update(m_deltaTime);
-
-		// Inventory manager
-		m_pInventoryManager->Update(m_deltaTime);
-
-		// Item manager
-		m_pItemManager->Update(m_deltaTime);
-		m_pItemManager->UpdateItemLights(m_deltaTime);
-		m_pItemManager->UpdateItemParticleEffects(m_deltaTime);
-		m_interactItemMutex.lock();
-		m_pInteractItem = m_pItemManager->CheckItemPlayerInteraction();
-		m_interactItemMutex.unlock();
-
-		// Projectile manager
-		m_pProjectileManager->Update(m_deltaTime);
-		m_pProjectileManager->UpdateProjectileLights(m_deltaTime);
-		m_pProjectileManager->UpdateProjectileParticleEffects(m_deltaTime);
-
-		// Text effects manager
-		m_pTextEffectsManager->Update(m_deltaTime);
-
-		// Update the NPC manager
-		m_pNPCManager->Update(m_deltaTime);
-
-		// Update the enemy manager
-		m_pEnemyManager->Update(m_deltaTime);
-
-		// Update the biome manager
-		m_pBiomeManager->Update(m_deltaTime);
-
-		// Player
-		if (m_animationUpdate)
-		{
-			m_pPlayer->Update(m_deltaTime);
-		}
-
-		// Camera faked position
-		if (m_cameraMode == CameraMode_MouseRotate || m_cameraMode == CameraMode_AutoCamera || m_cameraMode == CameraMode_NPCDialog)
-		{
-			vec3 playerMovementChanged = m_pPlayer->GetPositionMovementAmount();
-			m_pGameCamera->SetFakePosition(m_pGameCamera->GetFakePosition() + playerMovementChanged);
-		}
-
-		// Water
-		m_elapsedWaterTime += m_deltaTime;
+		UpdateSimulation(m_pSimulationTimestep->GetStepTime());
 	}
 
 	// Update the chunk manager
@@ -165,8 +116,11 @@ void VoxGame::Update()
 		}
 	}
 
-	// Update controls
-	UpdateControls(m_deltaTime);
+	// Update mouse controls, the camera rotation follows the mouse every frame rather than every simulation step
+	if (m_gamepadMovement == false)
+	{
+		UpdateMouseControls(m_deltaTime);
+	}
 
 	// Update the camera based on movements
 	if (m_gameMode == GameMode_Game)
@@ -217,44 +171,115 @@ void VoxGame::Update()
 	m_pVoxWindow->Update(m_deltaTime);
 }
 
-void VoxGame::UpdateNamePicking()
+void VoxGame::UpdateSimulation(float dt)
 {
-	POINT lMouse = { float(VoxGame::GetInstance()->GetWindowCursorX()), float(m_windowHeight - VoxGame::GetInstance()->GetWindowCursorY()) };
+	PROFILE_ZONE("VoxGame::UpdateSimulation");
 
-	// Push attribs
-	glPushAttrib(GL_LIST_BIT | GL_CURRENT_BIT | GL_ENABLE_BIT | GL_TRANSFORM_BIT);
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);  // Disabled rendering
+	// Keep the positions from before this step, rendering interpolates from them
+	StorePreviousSimulationPositions();
 
-	// Set the projection mode
-	m_pRenderer->SetProjectionMode(PM_PERSPECTIVE, m_defaultViewport);
+	// Main components update
+	if (m_bPaused == false && m_initialStartWait == false)
+	{
+		// Update the lighting manager
+		m_pLightingManager->Update(dt);
 
-	// Init name picking
-	m_pRenderer->InitNameStack();
+		// Block particle manager
+		m_pBlockParticleManager->Update(dt);
 
-	// Start name picking
-	m_pRenderer->StartNamePicking(m_defaultViewport, lMouse.x, lMouse.y);
+		// Instance manager
+		m_pInstanceManager->Update(dt);
 
-	// Set the lookat camera
-	m_pGameCamera->Look();
+		// Scenery manager
+		m_pSceneryManager->Update(dt);
 
-	// Different sub-systems render name picking
-	{
-		m_pNPCManager->RenderNamePicking();
+		// Inventory manager
+		m_pInventoryManager->Update(dt);
+
+		// Item manager
+		m_pItemManager->Update(dt);
+		m_pItemManager->UpdateItemLights(dt);
+		m_pItemManager->UpdateItemParticleEffects(dt);
+		m_interactItemMutex.lock();
+		m_pInteractItem = m_pItemManager->CheckItemPlayerInteraction();
+		m_interactItemMutex.unlock();
+
+		// Projectile manager
+		m_pProjectileManager->Update(dt);
+		m_pProjectileManager->UpdateProjectileLights(dt);
+		m_pProjectileManager->UpdateProjectileParticleEffects(dt);
+
+		// Text effects manager
+		m_pTextEffectsManager->Update(dt);
+
+		// Update the NPC manager
+		m_pNPCManager->Update(dt);
+
+		// Update the enemy manager
+		m_pEnemyManager->Update(dt);
+
+		// Update the biome manager
+		m_pBiomeManager->Update(dt);
+
+		// Player
+		if (m_animationUpdate)
+		{
+			m_pPlayer->Update(dt);
+		}
+
+		// Camera faked position
+		if (m_cameraMode == CameraMode_MouseRotate || m_cameraMode == CameraMode_AutoCamera || m_cameraMode == CameraMode_NPCDialog)
+		{
+			vec3 playerMovementChanged = m_pPlayer->GetPositionMovementAmount();
+			m_pGameCamera->SetFakePosition(m_pGameCamera->GetFakePosition() + playerMovementChanged);
+		}
+
+		// Water
+		m_elapsedWaterTime += dt;
 	}
 
-	// End the name picking
-	m_pickedObject = m_pRenderer->GetPickedObject();
+	// Update keyboard and gamepad controls, these move the player so they are part of the simulation step
+	UpdateControls(dt);
+}
 
-	// Pop attribs
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);   // Enable rendering
-	glPopAttrib();
+void VoxGame::StorePreviousSimulationPositions()
+{
+	m_pPlayer->StorePreviousSimulationPosition();
+	m_pNPCManager->StorePreviousSimulationPositions();
+	m_pEnemyManager->StorePreviousSimulationPositions();
+	m_pItemManager->StorePreviousSimulationPositions();
+	m_pProjectileManager->StorePreviousSimulationPositions();
+}
 
-	if (m_pickedObject != -1)
+void VoxGame::UpdateNamePicking()
+{
+	PROFILE_ZONE("VoxGame::UpdateNamePicking");
+
+	// The ray under the mouse cursor, window coordinates start at the bottom left
+	float mouseX = (float)GetWindowCursorX();
+	float mouseY = (float)(m_windowHeight - GetWindowCursorY());
+	Frustum* pViewFrustum = m_pRenderer->GetFrustum(m_defaultViewport);
+	vec3 cameraPosition = m_pGameCamera->GetPosition();
+	vec3 rayOrigin;
+	vec3 rayDirection;
+	PickingBVH::GetScreenRay(mouseX, mouseY, m_windowWidth, m_windowHeight, pViewFrustum->angle, cameraPosition, cameraPosition + m_pGameCamera->GetFacing(), m_pGameCamera->GetUp(), &rayOrigin, &rayDirection);
+
+	// Different sub-systems add their pickable volumes
+	m_pPickingBVH->Clear();
 	{
+		m_pNPCManager->AddPickingVolumes(m_pPickingBVH);
+	}
+	m_pPickingBVH->Build();
+
+	PickingHit hit;
+	if (m_pPickingBVH->RayCast(rayOrigin, rayDirection, pViewFrustum->farDistance, &hit))
+	{
+		m_pickedObject = hit.m_id;
 		m_bNamePickingSelected = true;
 	}
 	else
 	{
+		m_pickedObject = -1;
 		m_bNamePickingSelected = false;
 	}
 }
@@ -287,6 +312,8 @@ void VoxGame::UpdateLights(float dt)
 
 void VoxGame::UpdateGameGUI(float dt)
 {
+	PROFILE_ZONE("VoxGame::UpdateGameGUI");
+
 	if (m_pInventoryGUI->IsLoaded())
 	{
 		m_pInventoryGUI->Update(dt);
@@ -0,0 +1,1310 @@
+// ******************************************************************************
+// Filename:    BenchEntityScenarios.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The spatial grid, block particles, instance buffers, the parallel entity
+//   update, the fixed simulation timestep, the render pass visibility culling,
+//   the clustered light grid and mouse picking.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchScenarios.h"
+
+#include "../utils/SpatialGrid.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/FixedTimestep.h"
+#include "../utils/PlayerStep.h"
+#include "../utils/RandomGenerator.h"
+#include "../Particles/BlockParticlePool.h"
+#include "../Renderer/instancebuffer.h"
+#include "../Renderer/visibilityculler.h"
+#include "../Lighting/LightClusterGrid.h"
+#include "../Lighting/DynamicLightSlotMap.h"
+#include "../utils/PickingBVH.h"
+#include "../blocks/Chunk.h"
+#include "BenchWorld.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+using namespace std;
+
+
+// Spatial grid
+class BenchGridObject
+{
+public:
+	vec3 m_position;
+	vec3 m_velocity;
+	float m_radius;
+};
+
+static void SetupGridObjects(RandomGenerator* pRandom, int numObjects, float worldSize, vector<BenchGridObject>* pvObjects)
+{
+	pvObjects->resize(numObjects);
+	for (int i = 0; i < numObjects; i++)
+	{
+		BenchGridObject* pObject = &(*pvObjects)[i];
+		pObject->m_position = vec3(pRandom->GetRandomNumber(0, (int)worldSize, 2), 0.0f, pRandom->GetRandomNumber(0, (int)worldSize, 2));
+		pObject->m_velocity = vec3(pRandom->GetRandomNumber(-3, 3, 2), 0.0f, pRandom->GetRandomNumber(-3, 3, 2));
+		pObject->m_radius = pRandom->GetRandomNumber(5, 15, 1) * 0.1f;
+	}
+}
+
+static bool InRadius(const BenchGridObject& object, vec3 center, float radius)
+{
+	// The same test as the spatial grid
+	float xDistance = object.m_position.x - center.x;
+	float zDistance = object.m_position.z - center.z;
+	float range = radius + object.m_radius;
+
+	return xDistance*xDistance + zDistance*zDistance <= range*range;
+}
+
+static bool InSegment(const BenchGridObject& object, vec3 start, vec3 end, float radius)
+{
+	float segmentX = end.x - start.x;
+	float segmentZ = end.z - start.z;
+	float segmentLengthSquared = segmentX*segmentX + segmentZ*segmentZ;
+
+	float t = 0.0f;
+	if (segmentLengthSquared > 0.0f)
+	{
+		t = ((object.m_position.x - start.x)*segmentX + (object.m_position.z - start.z)*segmentZ) / segmentLengthSquared;
+		if (t < 0.0f)
+		{
+			t = 0.0f;
+		}
+		else if (t > 1.0f)
+		{
+			t = 1.0f;
+		}
+	}
+
+	float xDistance = object.m_position.x - (start.x + segmentX*t);
+	float zDistance = object.m_position.z - (start.z + segmentZ*t);
+	float range = radius + object.m_radius;
+
+	return xDistance*xDistance + zDistance*zDistance <= range*range;
+}
+
+void BenchSpatialGrid(BenchReport* pReport, bool quick)
+{
+	int numEnemies = quick ? 2000 : 8000;
+	int numProjectiles = numEnemies / 4;
+	int numFrames = quick ? 5 : 10;
+	float worldSize = quick ? 256.0f : 512.0f;
+	float dt = 1.0f / 60.0f;
+
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 2, 0));
+	vector<BenchGridObject> vEnemies;
+	vector<BenchGridObject> vProjectiles;
+	SetupGridObjects(&random, numEnemies, worldSize, &vEnemies);
+	SetupGridObjects(&random, numProjectiles, worldSize, &vProjectiles);
+
+	SpatialGrid grid(Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f);
+	vector<void*> vpResults;
+
+	int gridPairs = 0;
+	int bruteForcePairs = 0;
+	int gridHits = 0;
+	int bruteForceHits = 0;
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		// Move everything and register it again, as the managers do every frame
+		double startTime = GetHighResolutionTime();
+		grid.ClearLayer(eSpatialGridLayer_Enemy);
+		for (int i = 0; i < numEnemies; i++)
+		{
+			vEnemies[i].m_position += vEnemies[i].m_velocity * dt;
+			grid.AddObject(eSpatialGridLayer_Enemy, &vEnemies[i], vEnemies[i].m_position, vEnemies[i].m_radius);
+		}
+		pReport->AddTiming("grid_update", GetElapsedMilliseconds(startTime));
+
+		// Enemy pushing, every enemy looks for the enemies touching it
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numEnemies; i++)
+		{
+			grid.RadiusQuery(eSpatialGridLayer_Enemy, vEnemies[i].m_position, vEnemies[i].m_radius, &vpResults);
+			gridPairs += (int)vpResults.size();
+		}
+		pReport->AddTiming("grid_radius_queries", GetElapsedMilliseconds(startTime));
+
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numEnemies; i++)
+		{
+			for (int j = 0; j < numEnemies; j++)
+			{
+				if (InRadius(vEnemies[j], vEnemies[i].m_position, vEnemies[i].m_radius))
+				{
+					bruteForcePairs++;
+				}
+			}
+		}
+		pReport->AddTiming("brute_force_radius_queries", GetElapsedMilliseconds(startTime));
+
+		// Projectiles, a swept segment over the frame against the enemies
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numProjectiles; i++)
+		{
+			vec3 start = vProjectiles[i].m_position;
+			vec3 end = start + vProjectiles[i].m_velocity * (dt * 20.0f);
+			grid.SegmentQuery(eSpatialGridLayer_Enemy, start, end, 0.25f, &vpResults);
+			gridHits += (int)vpResults.size();
+		}
+		pReport->AddTiming("grid_segment_queries", GetElapsedMilliseconds(startTime));
+
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numProjectiles; i++)
+		{
+			vec3 start = vProjectiles[i].m_position;
+			vec3 end = start + vProjectiles[i].m_velocity * (dt * 20.0f);
+			for (int j = 0; j < numEnemies; j++)
+			{
+				if (InSegment(vEnemies[j], start, end, 0.25f))
+				{
+					bruteForceHits++;
+				}
+			}
+		}
+		pReport->AddTiming("brute_force_segment_queries", GetElapsedMilliseconds(startTime));
+	}
+
+	pReport->AddValue("num_enemies", numEnemies);
+	pReport->AddValue("num_projectiles", numProjectiles);
+	pReport->AddValue("num_frames", numFrames);
+	pReport->AddValue("radius_pairs", gridPairs);
+	pReport->AddValue("segment_hits", gridHits);
+	pReport->AddCheck("grid_matches_brute_force", gridPairs == bruteForcePairs && gridHits == bruteForceHits);
+}
+
+// Block particles
+void BenchParticles(BenchReport* pReport, bool quick)
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	pReport->AddValue("integration", "sse2");
+#else
+	pReport->AddValue("integration", "scalar");
+#endif
+
+	int numFrames = 60;
+	int numCounts = quick ? 2 : 3;
+	const int counts[3] = { 10000, 100000, 1000000 };
+	for (int c = 0; c < numCounts; c++)
+	{
+		int numParticles = counts[c];
+
+		// No world collisions, the pool doesn't need a chunk manager then
+		BlockParticlePool* pPool = new BlockParticlePool(NULL, numParticles);
+
+		RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 3, c));
+		for (int i = 0; i < numParticles; i++)
+		{
+			vec3 position = vec3(random.GetRandomNumber(-50, 50, 2), random.GetRandomNumber(0, 50, 2), random.GetRandomNumber(-50, 50, 2));
+			vec3 velocity = vec3(random.GetRandomNumber(-5, 5, 2), random.GetRandomNumber(0, 10, 2), random.GetRandomNumber(-5, 5, 2));
+			vec3 rotation = vec3(random.GetRandomNumber(0, 360, 2), random.GetRandomNumber(0, 360, 2), random.GetRandomNumber(0, 360, 2));
+			vec3 angularVelocity = vec3(random.GetRandomNumber(-90, 90, 2), random.GetRandomNumber(-90, 90, 2), random.GetRandomNumber(-90, 90, 2));
+
+			// Long enough to live through all the frames
+			float lifetime = 10.0f + random.GetRandomNumber(0, 5, 2);
+			pPool->AddParticle(position, position, velocity, vec3(0.0f, -9.81f, 0.0f), rotation, angularVelocity,
+							   1.0f, 0.5f, 0.0f, 1.0f, 0.25f, 0.2f, 0.2f, 0.2f, 0.0f, 0.05f, lifetime);
+		}
+
+		double startTime = GetHighResolutionTime();
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			pPool->Update(1.0f / 60.0f);
+		}
+		double updateTime = GetElapsedMilliseconds(startTime);
+
+		char lName[64];
+		sprintf(lName, "update_%i", numParticles);
+		pReport->AddTiming(lName, updateTime);
+		sprintf(lName, "particles_per_ms_%i", numParticles);
+		pReport->AddValue(lName, ((double)numParticles * numFrames) / updateTime);
+
+		fprintf(stderr, "  %i particles: %.1f ms\n", numParticles, updateTime);
+
+		delete pPool;
+	}
+}
+
+// Instance buffers
+static void PackInstances(InstanceBuffer* pBuffer, int numInstances, int* pNumAllocations, int* pNumBytes)
+{
+	float instance[20];
+	for (int i = 0; i < 20; i++)
+	{
+		instance[i] = (float)i;
+	}
+
+	pBuffer->ResetFrameStats();
+	pBuffer->ReserveStaging(numInstances);
+	for (int i = 0; i < numInstances; i++)
+	{
+		pBuffer->SetInstanceFloats(i, 0, instance, pBuffer->GetFloatsPerInstance());
+	}
+	pBuffer->AllocateSlot(numInstances);
+
+	*pNumAllocations = pBuffer->GetNumFrameAllocations();
+	*pNumBytes = pBuffer->GetNumFrameBytes();
+}
+
+void BenchInstanceBuffer(BenchReport* pReport, bool quick)
+{
+	int numFrames = quick ? 300 : 1200;
+	int warmupFrames = 60;
+
+	// A matrix and colour per block particle, a matrix per instanced model
+	InstanceBuffer particleBuffer(20);
+	InstanceBuffer parentBuffer(16);
+
+	int warmupAllocations = 0;
+	int steadyAllocations = 0;
+	double totalBytes = 0.0;
+	double startTime = GetHighResolutionTime();
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		// The counts move around every frame like a busy particle scene, and never go above the warmup peak
+		int numParticles = 20000 + (int)(15000.0f * sinf(frame * 0.05f));
+		int numParents = 500 + (frame * 37) % 400;
+		if (frame < warmupFrames)
+		{
+			numParticles = 35000;
+			numParents = 900;
+		}
+
+		int numAllocations;
+		int numBytes;
+		PackInstances(&particleBuffer, numParticles, &numAllocations, &numBytes);
+		totalBytes += numBytes;
+		int frameAllocations = numAllocations;
+		PackInstances(&parentBuffer, numParents, &numAllocations, &numBytes);
+		totalBytes += numBytes;
+		frameAllocations += numAllocations;
+
+		if (frame < warmupFrames)
+		{
+			warmupAllocations += frameAllocations;
+		}
+		else
+		{
+			steadyAllocations += frameAllocations;
+		}
+	}
+	double packTime = GetElapsedMilliseconds(startTime);
+
+	pReport->AddTiming("pack_instances", packTime);
+	pReport->AddValue("num_frames", numFrames);
+	pReport->AddValue("ms_per_frame", packTime / numFrames);
+	pReport->AddValue("upload_bytes_per_frame", totalBytes / numFrames);
+	pReport->AddValue("warmup_allocations", warmupAllocations);
+	pReport->AddValue("steady_state_allocations", steadyAllocations);
+	pReport->AddCheck("no_steady_state_allocations", steadyAllocations == 0);
+}
+
+// Parallel update
+class BenchUpdateItems
+{
+public:
+	vector<float> m_vValues;
+	vector<int> m_vCommandOrder;
+};
+
+static void _RecordCommand(void* pObject, void* pData)
+{
+	BenchUpdateItems* pItems = (BenchUpdateItems*)pObject;
+
+	pItems->m_vCommandOrder.push_back((int)(size_t)pData);
+}
+
+static void _UpdateItemParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	BenchUpdateItems* pItems = (BenchUpdateItems*)pData;
+
+	// A fixed amount of work per item, roughly an enemy's animation and physics
+	float value = pItems->m_vValues[index];
+	for (int i = 0; i < 50; i++)
+	{
+		value = sinf(value) * 0.5f + cosf(value * 0.25f + (float)index) * 0.5f;
+	}
+	pItems->m_vValues[index] = value;
+
+	// Some items spawn things or touch the world, those have to go through the command buffer
+	if (index % 7 == 0)
+	{
+		pCommands->AddCommand(_RecordCommand, pItems, (void*)(size_t)index);
+	}
+}
+
+void BenchParallelUpdate(BenchReport* pReport, bool quick)
+{
+	int numItems = quick ? 2000 : 10000;
+	int numFrames = quick ? 10 : 20;
+
+	vector<int> vThreadCounts;
+	vThreadCounts.push_back(1);
+	vThreadCounts.push_back(2);
+	vThreadCounts.push_back(4);
+	if (JobPool::GetDefaultNumWorkers() + 1 > 4)
+	{
+		vThreadCounts.push_back(JobPool::GetDefaultNumWorkers() + 1);
+	}
+
+	BenchUpdateItems firstItems;
+	bool identical = true;
+	for (unsigned int t = 0; t < vThreadCounts.size(); t++)
+	{
+		ParallelUpdate* pParallelUpdate = new ParallelUpdate(vThreadCounts[t]);
+
+		BenchUpdateItems items;
+		items.m_vValues.resize(numItems);
+		for (int i = 0; i < numItems; i++)
+		{
+			items.m_vValues[i] = i * 0.001f;
+		}
+
+		double startTime = GetHighResolutionTime();
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			pParallelUpdate->Run(numItems, _UpdateItemParallel, &items);
+		}
+		double updateTime = GetElapsedMilliseconds(startTime);
+
+		char lName[64];
+		sprintf(lName, "update_%i_threads", pParallelUpdate->GetNumThreads());
+		pReport->AddTiming(lName, updateTime);
+		sprintf(lName, "items_per_second_%i_threads", pParallelUpdate->GetNumThreads());
+		pReport->AddValue(lName, ((double)numItems * numFrames) / (updateTime / 1000.0));
+
+		if (t == 0)
+		{
+			firstItems = items;
+		}
+		else if (items.m_vValues != firstItems.m_vValues || items.m_vCommandOrder != firstItems.m_vCommandOrder)
+		{
+			identical = false;
+		}
+
+		delete pParallelUpdate;
+	}
+
+	pReport->AddValue("num_items", numItems);
+	pReport->AddValue("num_commands", (int)firstItems.m_vCommandOrder.size());
+	pReport->AddCheck("same_results_for_all_thread_counts", identical);
+}
+
+// Fixed timestep
+// A floor, a ledge one block high at x = 4 and a wall at x = 10
+static bool _GetStepBlock(const vec3 &position, vec3* pBlockPos, bool* pLoaded, void* pData)
+{
+	*pBlockPos = vec3(floorf(position.x + 0.5f), floorf(position.y + 0.5f), floorf(position.z + 0.5f));
+	*pLoaded = true;
+
+	float x = pBlockPos->x;
+	float y = pBlockPos->y;
+
+	return (y <= 0.0f) || (x >= 4.0f && y <= 1.0f) || (x >= 10.0f && y <= 6.0f);
+}
+
+static bool _HasStepFloor(const vec3 &position, void* pData)
+{
+	return true;
+}
+
+static void RunFixedTimestep(float framesPerSecond, float seconds, vector<vec3>* pvTrajectory, bool* pInterpolationInRange)
+{
+	FixedTimestep timestep(60);
+
+	PlayerStepWorld world;
+	world.m_getBlock = _GetStepBlock;
+	world.m_hasFloor = _HasStepFloor;
+
+	// Dropped onto the floor, then walking into the ledge and the wall, with a jump against the wall
+	PlayerBody body;
+	body.m_radius = 0.08f / 0.14f;
+	body.m_position = vec3(0.0f, 1.5f, 0.0f);
+	body.m_previousPosition = body.GetCenter();
+
+	int jumpStep = (int)(timestep.GetTickRate() * seconds * 0.5f);
+	int step = 0;
+
+	int numFrames = (int)(framesPerSecond * seconds);
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		int numSteps = timestep.Update(1.0f / framesPerSecond);
+		for (int i = 0; i < numSteps; i++)
+		{
+			float dt = timestep.GetStepTime();
+
+			// The same order as the game, the player update and then the controls
+			PlayerStep::UpdatePhysics(world, &body, dt);
+			PlayerStep::Move(world, &body, vec3(1.0f, 0.0f, 0.0f), 10.0f * dt);
+
+			if (step == jumpStep && body.m_bCanJump && body.m_bIsOnGround)
+			{
+				body.m_bCanJump = false;
+				body.m_velocity += vec3(0.0f, 14.0f, 0.0f);
+			}
+			step++;
+
+			pvTrajectory->push_back(body.m_position);
+		}
+
+		float interpolation = timestep.GetInterpolation();
+		if (interpolation < 0.0f || interpolation > 1.0f)
+		{
+			*pInterpolationInRange = false;
+		}
+	}
+}
+
+void BenchFixedTimestep(BenchReport* pReport, bool quick)
+{
+	float seconds = quick ? 10.0f : 60.0f;
+
+	// The player step must not depend on the frame rate, only on the tick rate
+	vector<vec3> vSlow;
+	vector<vec3> vFast;
+	bool interpolationInRange = true;
+
+	double startTime = GetHighResolutionTime();
+	RunFixedTimestep(20.0f, seconds, &vSlow, &interpolationInRange);
+	pReport->AddTiming("simulate_20_fps", GetElapsedMilliseconds(startTime));
+
+	startTime = GetHighResolutionTime();
+	RunFixedTimestep(200.0f, seconds, &vFast, &interpolationInRange);
+	pReport->AddTiming("simulate_200_fps", GetElapsedMilliseconds(startTime));
+
+	// The accumulators can end a step apart, only compare the steps both ran
+	size_t numSteps = (vSlow.size() < vFast.size()) ? vSlow.size() : vFast.size();
+	bool identical = true;
+	for (size_t i = 0; i < numSteps; i++)
+	{
+		if (vSlow[i] != vFast[i])
+		{
+			identical = false;
+		}
+	}
+
+	// And the player has to have stepped up onto the ledge, been stopped by the wall and jumped
+	float highest = 0.0f;
+	for (size_t i = 0; i < vSlow.size(); i++)
+	{
+		if (vSlow[i].y > highest)
+		{
+			highest = vSlow[i].y;
+		}
+	}
+	vec3 end = vSlow.empty() ? vec3(0.0f, 0.0f, 0.0f) : vSlow.back();
+	bool onLedge = (end.y > 1.4f && end.y < 1.6f);
+	bool stoppedByWall = (end.x > 8.0f && end.x < 9.5f);
+	bool jumped = (highest > 2.5f && onLedge);
+
+	pReport->AddValue("end_x", (double)end.x);
+	pReport->AddValue("end_y", (double)end.y);
+	pReport->AddValue("highest_y", (double)highest);
+	pReport->AddValue("steps_20_fps", (int)vSlow.size());
+	pReport->AddValue("steps_200_fps", (int)vFast.size());
+	pReport->AddCheck("same_trajectory_at_20_and_200_fps", identical && numSteps > 0);
+	pReport->AddCheck("interpolation_in_range", interpolationInRange);
+	pReport->AddCheck("stepped_up_onto_ledge", onLedge);
+	pReport->AddCheck("stopped_by_wall", stoppedByWall);
+	pReport->AddCheck("jumped_and_landed", jumped);
+}
+
+
+// Visibility culling
+class BenchCullObject
+{
+public:
+	VisibilityType m_type;
+	vec3 m_center;
+	float m_radius;
+};
+
+static void AddCullObjects(RandomGenerator* pRandom, BenchWorld* pWorld, VisibilityType type, int numObjects, float radius, float worldSize, vector<BenchCullObject>* pvObjects)
+{
+	for (int i = 0; i < numObjects; i++)
+	{
+		int x = pRandom->GetRandomNumber(-(int)worldSize, (int)worldSize);
+		int z = pRandom->GetRandomNumber(-(int)worldSize, (int)worldSize);
+		int groundHeight = pWorld->GetGroundHeight(x, z);
+
+		BenchCullObject object;
+		object.m_type = type;
+		object.m_center = vec3((float)x, (float)(groundHeight > 0 ? groundHeight : 0) + radius, (float)z);
+		object.m_radius = radius;
+		pvObjects->push_back(object);
+	}
+}
+
+static bool InLightBox(const vec3& center, float radius, const vec3& lightPos, const vec3& target, float halfSize, float nearD, float farD)
+{
+	// The sphere in the light's view space, against the orthographic projection box
+	vec3 Z = normalize(lightPos - target);
+	vec3 X = normalize(cross(vec3(0.0f, 1.0f, 0.0f), Z));
+	vec3 Y = cross(Z, X);
+	vec3 toCenter = center - lightPos;
+	float x = dot(toCenter, X);
+	float y = dot(toCenter, Y);
+	float depth = -dot(toCenter, Z);
+
+	return fabs(x) <= halfSize + radius && fabs(y) <= halfSize + radius && depth >= nearD - radius && depth <= farD + radius;
+}
+
+void BenchVisibility(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 6 : 10;
+	int numFrames = quick ? 60 : 240;
+	int entityScale = quick ? 1 : 2;
+	float chunkSize = Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f;
+	float loaderRadius = radius * chunkSize;
+
+	// The same values as the game, the default viewport, the shadow box and the water
+	float fov = 60.0f;
+	float aspect = 16.0f / 9.0f;
+	float nearD = 0.1f;
+	float farD = 10000.0f;
+	float shadowNear = 0.01f;
+	float shadowFar = 1000.0f;
+	vec3 lightOffset = vec3(300.0f, 300.0f, 300.0f);
+	float waterHeight = 1.3f;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+
+	// The chunks that the game would render, the empty ones are never culled
+	vector<BenchCullObject> vObjects;
+	BenchChunkList* pChunkList = world.GetChunkList();
+	for (unsigned int i = 0; i < pChunkList->size(); i++)
+	{
+		BenchChunk* pChunk = (*pChunkList)[i];
+
+		bool empty = true;
+		for (int j = 0; j < Chunk::CHUNK_SIZE_CUBED && empty; j++)
+		{
+			empty = (pChunk->m_colour[j] == 0);
+		}
+		if (empty)
+		{
+			continue;
+		}
+
+		BenchCullObject object;
+		object.m_type = VisibilityType_Chunk;
+		object.m_center = vec3(pChunk->m_gridX*chunkSize, pChunk->m_gridY*chunkSize, pChunk->m_gridZ*chunkSize) + vec3(chunkSize*0.5f - Chunk::BLOCK_RENDER_SIZE, chunkSize*0.5f - Chunk::BLOCK_RENDER_SIZE, chunkSize*0.5f - Chunk::BLOCK_RENDER_SIZE);
+		object.m_radius = Chunk::CHUNK_RADIUS;
+		vObjects.push_back(object);
+	}
+	int numChunks = (int)vObjects.size();
+
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 8, 0));
+	AddCullObjects(&random, &world, VisibilityType_NPC, 50 * entityScale, 1.0f, loaderRadius, &vObjects);
+	AddCullObjects(&random, &world, VisibilityType_Enemy, 200 * entityScale, 1.0f, loaderRadius, &vObjects);
+	AddCullObjects(&random, &world, VisibilityType_Item, 300 * entityScale, 0.5f, loaderRadius, &vObjects);
+	AddCullObjects(&random, &world, VisibilityType_Scenery, 100 * entityScale, 3.0f, loaderRadius, &vObjects);
+	int numObjects = (int)vObjects.size();
+
+	// The water reflections only render the chunks, like the game
+	VisibilityCuller culler;
+	unsigned int entityPasses = (1 << RenderPass_Main) | (1 << RenderPass_Shadow);
+	culler.SetTypePasses(VisibilityType_NPC, entityPasses);
+	culler.SetTypePasses(VisibilityType_Enemy, entityPasses);
+	culler.SetTypePasses(VisibilityType_Item, entityPasses);
+	culler.SetTypePasses(VisibilityType_Scenery, entityPasses);
+
+	vec3 playerCenter = vec3(0.0f, (float)world.GetGroundHeight(0, 0) + 1.0f, 0.0f);
+	vec3 lightPos = lightOffset + playerCenter;
+
+	long long numBefore[RenderPass_NumPasses] = { 0, 0, 0 };
+	long long numAfter[RenderPass_NumPasses] = { 0, 0, 0 };
+	int numShadowMismatches = 0;
+	int numReflectionMismatches = 0;
+	bool playerVisible = true;
+	bool behindCulled = true;
+	double cullTime = 0.0;
+
+	Frustum cameraFrustum;
+	cameraFrustum.SetFrustum(fov, aspect, nearD, farD);
+
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		// A third person camera circling the player
+		float angle = (float)frame / numFrames * 6.2831853f;
+		vec3 cameraPosition = playerCenter + vec3(-cos(angle)*12.0f, 6.0f, -sin(angle)*12.0f);
+		vec3 cameraTarget = playerCenter;
+		vec3 cameraUp = vec3(0.0f, 1.0f, 0.0f);
+
+		// The single culling stage for all of the passes
+		double startTime = GetHighResolutionTime();
+		culler.StartFrame();
+		culler.SetCameraFrustum(fov, aspect, nearD, farD, cameraPosition, cameraTarget, cameraUp);
+		culler.SetShadowFrustum(loaderRadius*2.0f, loaderRadius*2.0f, shadowNear, shadowFar, lightPos, playerCenter, cameraUp);
+		culler.SetReflectionFrustum(waterHeight);
+
+		vector<unsigned int> vPassMasks(numObjects);
+		for (int i = 0; i < numObjects; i++)
+		{
+			vPassMasks[i] = culler.CullSphere(vObjects[i].m_type, vObjects[i].m_center, vObjects[i].m_radius);
+		}
+		cullTime += GetElapsedMilliseconds(startTime);
+
+		for (int i = 0; i < RenderPass_NumPasses; i++)
+		{
+			numAfter[i] += culler.GetNumVisible((RenderPass)i);
+		}
+
+		// Before, the main pass tested the camera frustum for everything except the scenery, the shadow pass took everything and the reflection pass took every chunk
+		cameraFrustum.SetCamera(cameraPosition, cameraTarget, cameraUp);
+		for (int i = 0; i < numObjects; i++)
+		{
+			const BenchCullObject& object = vObjects[i];
+
+			bool inCamera = cameraFrustum.SphereInFrustum(object.m_center, object.m_radius) != Frustum::FRUSTUM_OUTSIDE;
+			if (object.m_type == VisibilityType_Scenery || inCamera)
+			{
+				numBefore[RenderPass_Main]++;
+			}
+			numBefore[RenderPass_Shadow]++;
+			if (object.m_type == VisibilityType_Chunk)
+			{
+				numBefore[RenderPass_Reflection]++;
+			}
+
+			// The shadow pass must keep everything inside the light's projection box
+			bool inShadow = (vPassMasks[i] & (1 << RenderPass_Shadow)) != 0;
+			if (inShadow != InLightBox(object.m_center, object.m_radius, lightPos, playerCenter, loaderRadius, shadowNear, shadowFar))
+			{
+				numShadowMismatches++;
+			}
+
+			// The reflection pass renders the world flipped in the water with the real camera
+			if (object.m_type == VisibilityType_Chunk)
+			{
+				vec3 mirrorCenter = vec3(object.m_center.x, (waterHeight*2.0f) - object.m_center.y, object.m_center.z);
+				bool expected = (object.m_center.y + object.m_radius >= waterHeight) && cameraFrustum.SphereInFrustum(mirrorCenter, object.m_radius) != Frustum::FRUSTUM_OUTSIDE;
+				bool inReflection = (vPassMasks[i] & (1 << RenderPass_Reflection)) != 0;
+				if (inReflection != expected)
+				{
+					numReflectionMismatches++;
+				}
+			}
+		}
+
+		// What the camera is looking at must be kept, and what is behind it must go
+		unsigned int playerMask = culler.CullSphere(VisibilityType_NPC, playerCenter, 1.0f);
+		if ((playerMask & (1 << RenderPass_Main)) == 0 || (playerMask & (1 << RenderPass_Shadow)) == 0)
+		{
+			playerVisible = false;
+		}
+		vec3 behindCamera = cameraPosition + normalize(cameraPosition - cameraTarget) * 30.0f;
+		if (culler.CullSphere(VisibilityType_NPC, behindCamera, 1.0f) & (1 << RenderPass_Main))
+		{
+			behindCulled = false;
+		}
+	}
+
+	pReport->AddTiming("cull_all_passes", cullTime);
+	pReport->AddValue("cull_per_frame_ms", cullTime / numFrames);
+	pReport->AddValue("num_chunks", numChunks);
+	pReport->AddValue("num_objects", numObjects);
+
+	bool noMoreThanBefore = true;
+	for (int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		char name[64];
+		const char* passName = VisibilityCuller::GetPassName((RenderPass)i);
+		sprintf(name, "%s_submitted_before", passName);
+		pReport->AddValue(name, (double)numBefore[i] / numFrames);
+		sprintf(name, "%s_submitted_after", passName);
+		pReport->AddValue(name, (double)numAfter[i] / numFrames);
+
+		if (numAfter[i] > numBefore[i])
+		{
+			noMoreThanBefore = false;
+		}
+	}
+
+	pReport->AddValue("shadow_mismatches", numShadowMismatches);
+	pReport->AddValue("reflection_mismatches", numReflectionMismatches);
+	pReport->AddCheck("culled_no_more_than_before", noMoreThanBefore);
+	pReport->AddCheck("shadow_matches_light_box", numShadowMismatches == 0);
+	pReport->AddCheck("reflection_matches_mirrored_camera", numReflectionMismatches == 0);
+	pReport->AddCheck("player_visible", playerVisible);
+	pReport->AddCheck("behind_camera_culled", behindCulled);
+}
+
+
+// Clustered lighting
+void BenchLights(BenchReport* pReport, bool quick)
+{
+	const int NUM_LIGHT_COUNTS = 4;
+	int lightCounts[NUM_LIGHT_COUNTS] = { 1000, 2500, 5000, 10000 };
+	int numFrames = quick ? 10 : 60;
+	int numSamples = quick ? 2000 : 10000;
+
+	// A 720p view, the game's field of view and slices out to the loader radius
+	int screenWidth = 1280;
+	int screenHeight = 720;
+	float fov = 60.0f;
+	float clusterNear = 1.0f;
+	float clusterFar = 128.0f;
+	float tanHalfFovY = (float)tan(fov * 0.5f * 3.14159265f / 180.0f);
+	float tanHalfFovX = tanHalfFovY * ((float)screenWidth / (float)screenHeight);
+
+	bool binningConservative = true;
+	bool fewerLightsPerPixel = true;
+
+	for (int countIndex = 0; countIndex < NUM_LIGHT_COUNTS; countIndex++)
+	{
+		int numLights = lightCounts[countIndex];
+
+		// Weapon, projectile and spell lights scattered around the player
+		RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 9, numLights));
+		vector<vec4> vLights(numLights);
+		for (int i = 0; i < numLights; i++)
+		{
+			float x = random.GetRandomNumber(-100, 100, 2);
+			float y = random.GetRandomNumber(0, 30, 2);
+			float z = random.GetRandomNumber(-100, 100, 2);
+			float radius = random.GetRandomNumber(1, 8, 2);
+			vLights[i] = vec4(x, y, z, radius);
+		}
+
+		LightClusterGrid grid;
+		grid.SetView(screenWidth, screenHeight, fov, clusterNear, clusterFar);
+
+		double buildTime = 0.0;
+		long long numIndices = 0;
+		long long numSampleLights = 0;
+		int numBinned = 0;
+		int numOverflowClusters = 0;
+		int maxClusterCount = 0;
+		int numMissed = 0;
+		int numSamplesChecked = 0;
+
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			// A third person camera circling the player
+			float angle = (float)frame / numFrames * 6.2831853f;
+			vec3 playerCenter = vec3(0.0f, 10.0f, 0.0f);
+			vec3 cameraPosition = playerCenter + vec3(-cos(angle)*12.0f, 6.0f, -sin(angle)*12.0f);
+
+			double startTime = GetHighResolutionTime();
+			grid.SetCamera(cameraPosition, playerCenter, vec3(0.0f, 1.0f, 0.0f));
+			grid.Build(vLights);
+			buildTime += GetElapsedMilliseconds(startTime);
+
+			numIndices += grid.GetNumIndices();
+			numBinned += grid.GetNumLightsBinned();
+			numOverflowClusters += grid.GetNumOverflowClusters();
+			if (grid.GetMaxClusterCount() > maxClusterCount)
+			{
+				maxClusterCount = grid.GetMaxClusterCount();
+			}
+
+			// Every light that reaches a pixel must be in the pixel's cluster, unless the cluster was full
+			if (frame == 0)
+			{
+				vector<vec3> vViewLights(numLights);
+				for (int i = 0; i < numLights; i++)
+				{
+					vViewLights[i] = grid.GetViewPosition(vec3(vLights[i]));
+				}
+
+				const vector<unsigned int>& vLightIndices = grid.GetLightIndices();
+				for (int i = 0; i < numSamples; i++)
+				{
+					float pixelX = random.GetRandomNumber(0, screenWidth - 1, 0) + 0.5f;
+					float pixelY = random.GetRandomNumber(0, screenHeight - 1, 0) + 0.5f;
+					float depth = random.GetRandomNumber(1, 150, 2) * 0.5f + 0.1f;
+					vec3 pixelPosition = vec3(((pixelX / screenWidth)*2.0f - 1.0f) * tanHalfFovX * depth, ((pixelY / screenHeight)*2.0f - 1.0f) * tanHalfFovY * depth, -depth);
+
+					int cluster = grid.GetCluster(pixelX, pixelY, depth);
+					unsigned int offset = grid.GetClusterOffset(cluster);
+					unsigned int count = grid.GetClusterCount(cluster);
+					numSampleLights += count;
+					if (count >= (unsigned int)LightClusterGrid::MAX_CLUSTER_LIGHTS)
+					{
+						continue;
+					}
+					numSamplesChecked++;
+
+					for (int j = 0; j < numLights; j++)
+					{
+						if (length(vViewLights[j] - pixelPosition) >= vLights[j].w)
+						{
+							continue;
+						}
+
+						bool found = false;
+						for (unsigned int k = 0; k < count && found == false; k++)
+						{
+							found = (vLightIndices[offset + k] == (unsigned int)j);
+						}
+						if (found == false)
+						{
+							numMissed++;
+						}
+					}
+				}
+			}
+		}
+
+		double averageSampleLights = (double)numSampleLights / numSamples;
+
+		char name[64];
+		sprintf(name, "build_%i", numLights);
+		pReport->AddTiming(name, buildTime);
+		sprintf(name, "build_per_frame_ms_%i", numLights);
+		pReport->AddValue(name, buildTime / numFrames);
+		sprintf(name, "lights_binned_%i", numLights);
+		pReport->AddValue(name, numBinned / numFrames);
+		sprintf(name, "cluster_lights_%i", numLights);
+		pReport->AddValue(name, (int)(numIndices / numFrames));
+		sprintf(name, "lights_per_pixel_%i", numLights);
+		pReport->AddValue(name, averageSampleLights);
+		sprintf(name, "max_cluster_lights_%i", numLights);
+		pReport->AddValue(name, maxClusterCount);
+		sprintf(name, "overflow_clusters_%i", numLights);
+		pReport->AddValue(name, numOverflowClusters / numFrames);
+		sprintf(name, "samples_checked_%i", numLights);
+		pReport->AddValue(name, numSamplesChecked);
+		sprintf(name, "missed_lights_%i", numLights);
+		pReport->AddValue(name, numMissed);
+
+		// Before, every light was a sphere draw with its own uniforms, now it is one full screen pass and three texture uploads
+		sprintf(name, "draws_before_%i", numLights);
+		pReport->AddValue(name, numLights);
+		sprintf(name, "uniform_sets_before_%i", numLights);
+		pReport->AddValue(name, numLights * 3);
+		sprintf(name, "draws_after_%i", numLights);
+		pReport->AddValue(name, 1);
+		sprintf(name, "upload_bytes_%i", numLights);
+		pReport->AddValue(name, (int)((numLights*2 + grid.GetNumClusters() + numIndices / numFrames) * 4 * sizeof(float)));
+
+		if (numMissed != 0)
+		{
+			binningConservative = false;
+		}
+		if (averageSampleLights >= numLights)
+		{
+			fewerLightsPerPixel = false;
+		}
+	}
+
+	pReport->AddCheck("binning_conservative", binningConservative);
+	pReport->AddCheck("fewer_lights_per_pixel", fewerLightsPerPixel);
+
+	// The slot map against the old linear search by id
+	int numLights = quick ? 1000 : 10000;
+	int numLookups = quick ? 100000 : 1000000;
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 10, 0));
+
+	DynamicLightSlotMap slotMap;
+	vector<DynamicLight*> vpLinearLights;
+	vector<unsigned int> vLightIds;
+	for (int i = 0; i < numLights; i++)
+	{
+		DynamicLight* pLight = new DynamicLight();
+		vLightIds.push_back(slotMap.Add(pLight));
+
+		DynamicLight* pLinearLight = new DynamicLight();
+		pLinearLight->m_lightId = i;
+		vpLinearLights.push_back(pLinearLight);
+	}
+
+	// Remove and add back half of the lights, so that slots are reused
+	vector<unsigned int> vStaleIds;
+	for (int i = 0; i < numLights; i += 2)
+	{
+		slotMap.Remove(vLightIds[i]);
+		vStaleIds.push_back(vLightIds[i]);
+	}
+	for (int i = 0; i < numLights; i += 2)
+	{
+		vLightIds[i] = slotMap.Add(new DynamicLight());
+	}
+
+	bool idsFound = (slotMap.GetNumLights() == numLights);
+	for (int i = 0; i < numLights && idsFound; i++)
+	{
+		DynamicLight* pLight = slotMap.Get(vLightIds[i]);
+		idsFound = (pLight != NULL && pLight->m_lightId == vLightIds[i]);
+	}
+	bool staleIdsRejected = (slotMap.Get((unsigned int)-1) == NULL);
+	for (unsigned int i = 0; i < vStaleIds.size() && staleIdsRejected; i++)
+	{
+		staleIdsRejected = (slotMap.Get(vStaleIds[i]) == NULL);
+	}
+
+	int numFound = 0;
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numLookups; i++)
+	{
+		if (slotMap.Get(vLightIds[random.GetRandomNumber(0, numLights - 1)]) != NULL)
+		{
+			numFound++;
+		}
+	}
+	double slotMapTime = GetElapsedMilliseconds(startTime);
+
+	int numLinearLookups = numLookups / 100;
+	int numLinearFound = 0;
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numLinearLookups; i++)
+	{
+		unsigned int lightId = (unsigned int)random.GetRandomNumber(0, numLights - 1);
+		for (unsigned int j = 0; j < vpLinearLights.size(); j++)
+		{
+			if (vpLinearLights[j]->m_lightId == lightId)
+			{
+				numLinearFound++;
+				break;
+			}
+		}
+	}
+	double linearTime = GetElapsedMilliseconds(startTime);
+
+	for (unsigned int i = 0; i < vpLinearLights.size(); i++)
+	{
+		delete vpLinearLights[i];
+	}
+
+	pReport->AddTiming("slot_map_lookups", slotMapTime);
+	pReport->AddTiming("linear_lookups", linearTime);
+	pReport->AddValue("slot_map_lookup_ns", slotMapTime * 1000000.0 / numLookups);
+	pReport->AddValue("linear_lookup_ns", linearTime * 1000000.0 / numLinearLookups);
+	pReport->AddCheck("slot_map_ids_found", idsFound && numFound == numLookups && numLinearFound == numLinearLookups);
+	pReport->AddCheck("slot_map_stale_ids_rejected", staleIdsRejected);
+}
+
+
+// Mouse picking
+class BenchPickingPart
+{
+public:
+	vec3 m_offset;
+	int m_sizeX;
+	int m_sizeY;
+	int m_sizeZ;
+	vector<unsigned int> m_vVoxels;
+};
+
+class BenchPickingInput
+{
+public:
+	vec3 m_cameraPosition;
+	vec3 m_cameraTarget;
+	float m_mouseX;
+	float m_mouseY;
+};
+
+// Solid voxels in the ellipsoid that fits the grid, so the corners of the grid are empty
+static void FillEllipsoid(BenchPickingPart* pPart, int sizeX, int sizeY, int sizeZ, const vec3& offset)
+{
+	pPart->m_offset = offset;
+	pPart->m_sizeX = sizeX;
+	pPart->m_sizeY = sizeY;
+	pPart->m_sizeZ = sizeZ;
+	pPart->m_vVoxels.assign(sizeX*sizeY*sizeZ, 0);
+
+	for (int x = 0; x < sizeX; x++)
+	{
+		for (int y = 0; y < sizeY; y++)
+		{
+			for (int z = 0; z < sizeZ; z++)
+			{
+				float dx = (x + 0.5f - sizeX*0.5f) / (sizeX*0.5f);
+				float dy = (y + 0.5f - sizeY*0.5f) / (sizeY*0.5f);
+				float dz = (z + 0.5f - sizeZ*0.5f) / (sizeZ*0.5f);
+				if (dx*dx + dy*dy + dz*dz <= 1.0f)
+				{
+					pPart->m_vVoxels[x + sizeX * (y + sizeY * z)] = 0xFF808080;
+				}
+			}
+		}
+	}
+}
+
+// Like NPC::AddPickingVolumes(), every matrix of every character is a voxel volume with the character's id
+static void AddPickingCharacter(PickingBVH* pPicking, const vector<BenchPickingPart>& vParts, int id, const vec3& position, float rotation, float scale)
+{
+	Matrix4x4 rotationMatrix;
+	rotationMatrix.SetYRotation(rotation);
+	Matrix4x4 scaleMatrix;
+	scaleMatrix.SetScale(vec3(scale, scale, scale));
+	Matrix4x4 characterMatrix;
+	Matrix4x4::Multiply(rotationMatrix, scaleMatrix, characterMatrix);
+
+	for (unsigned int i = 0; i < vParts.size(); i++)
+	{
+		vec3 partOffset;
+		Matrix4x4::Multiply(characterMatrix, vParts[i].m_offset, partOffset);
+
+		Matrix4x4 partMatrix = characterMatrix;
+		partMatrix.SetTranslation(position + partOffset);
+		pPicking->AddVoxels(id, partMatrix, &vParts[i].m_vVoxels[0], vParts[i].m_sizeX, vParts[i].m_sizeY, vParts[i].m_sizeZ);
+	}
+}
+
+// The first solid voxel along the ray by small steps, to check the voxel walk
+static bool MarchVoxels(const BenchPickingPart& part, const vec3& origin, const vec3& direction, float maxDistance, float* pDistance)
+{
+	for (float distance = 0.0f; distance <= maxDistance; distance += 0.001f)
+	{
+		vec3 position = origin + direction * distance;
+		int x = (int)floor(position.x + 0.5f);
+		int y = (int)floor(position.y + 0.5f);
+		int z = (int)floor(position.z + 0.5f);
+		if (x >= 0 && x < part.m_sizeX && y >= 0 && y < part.m_sizeY && z >= 0 && z < part.m_sizeZ && part.m_vVoxels[x + part.m_sizeX * (y + part.m_sizeY * z)] != 0)
+		{
+			*pDistance = distance;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Where a point is on the screen, the inverse of PickingBVH::GetScreenRay()
+static bool ProjectToScreen(const vec3& position, int screenWidth, int screenHeight, float fov, const vec3& cameraPos, const vec3& cameraTarget, float* pScreenX, float* pScreenY)
+{
+	vec3 forward = normalize(cameraTarget - cameraPos);
+	vec3 right = normalize(cross(forward, vec3(0.0f, 1.0f, 0.0f)));
+	vec3 up = cross(right, forward);
+
+	vec3 toPosition = position - cameraPos;
+	float depth = dot(toPosition, forward);
+	if (depth <= 0.0f)
+	{
+		return false;
+	}
+
+	float tanHalfFovY = (float)tan(fov * 0.5f * 3.14159265f / 180.0f);
+	float tanHalfFovX = tanHalfFovY * ((float)screenWidth / (float)screenHeight);
+	float ndcX = dot(toPosition, right) / (depth * tanHalfFovX);
+	float ndcY = dot(toPosition, up) / (depth * tanHalfFovY);
+	if (ndcX < -1.0f || ndcX > 1.0f || ndcY < -1.0f || ndcY > 1.0f)
+	{
+		return false;
+	}
+
+	*pScreenX = (ndcX * 0.5f + 0.5f) * screenWidth;
+	*pScreenY = (ndcY * 0.5f + 0.5f) * screenHeight;
+
+	return true;
+}
+
+void BenchPicking(BenchReport* pReport, bool quick)
+{
+	const int NUM_CHARACTER_COUNTS = 2;
+	int characterCounts[NUM_CHARACTER_COUNTS] = { 200, 2000 };
+	int numFrames = quick ? 200 : 2000;
+	int numBuilds = quick ? 5 : 20;
+
+	int screenWidth = 1280;
+	int screenHeight = 720;
+	float fov = 60.0f;
+	float farDistance = 500.0f;
+	float characterScale = 0.08f;
+	float worldSize = 200.0f;
+
+	// A body, head and two legs, in voxels before the character scale
+	vector<BenchPickingPart> vParts(4);
+	FillEllipsoid(&vParts[0], 10, 12, 8, vec3(-5.0f, 8.0f, -4.0f));
+	FillEllipsoid(&vParts[1], 10, 10, 10, vec3(-5.0f, 20.0f, -5.0f));
+	FillEllipsoid(&vParts[2], 4, 8, 4, vec3(-4.0f, 0.0f, -2.0f));
+	FillEllipsoid(&vParts[3], 4, 8, 4, vec3(1.0f, 0.0f, -2.0f));
+
+	bool matchesBruteForce = true;
+	bool fewerTests = true;
+	bool charactersPicked = true;
+
+	for (int countIndex = 0; countIndex < NUM_CHARACTER_COUNTS; countIndex++)
+	{
+		int numCharacters = characterCounts[countIndex];
+
+		RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 11, numCharacters));
+		vector<vec3> vPositions(numCharacters);
+		vector<float> vRotations(numCharacters);
+		for (int i = 0; i < numCharacters; i++)
+		{
+			vPositions[i] = vec3(random.GetRandomNumber(0, (int)worldSize, 2), random.GetRandomNumber(0, 4, 2), random.GetRandomNumber(0, (int)worldSize, 2));
+			vRotations[i] = random.GetRandomNumber(0, 628, 2) * 0.01f;
+		}
+
+		// The recorded input, a camera orbiting the crowd and the mouse moving around the screen, every other frame it is over a character
+		vector<BenchPickingInput> vInputs(numFrames);
+		for (int i = 0; i < numFrames; i++)
+		{
+			float angle = (float)i / numFrames * 6.2831853f;
+			vec3 center = vec3(worldSize*0.5f, 0.0f, worldSize*0.5f);
+			vInputs[i].m_cameraPosition = center + vec3(cos(angle)*worldSize*0.6f, 20.0f, sin(angle)*worldSize*0.6f);
+			vInputs[i].m_cameraTarget = center + vec3(random.GetRandomNumber(-50, 50, 2), 0.0f, random.GetRandomNumber(-50, 50, 2));
+			vInputs[i].m_mouseX = (float)random.GetRandomNumber(0, screenWidth - 1);
+			vInputs[i].m_mouseY = (float)random.GetRandomNumber(0, screenHeight - 1);
+
+			vec3 characterCenter = vPositions[random.GetRandomNumber(0, numCharacters - 1)] + vec3(0.0f, 13.5f * characterScale, 0.0f);
+			float screenX;
+			float screenY;
+			if ((i % 2) == 1 && ProjectToScreen(characterCenter, screenWidth, screenHeight, fov, vInputs[i].m_cameraPosition, vInputs[i].m_cameraTarget, &screenX, &screenY))
+			{
+				vInputs[i].m_mouseX = screenX;
+				vInputs[i].m_mouseY = screenY;
+			}
+		}
+
+		// Rebuilt every frame in the game, since the characters move
+		PickingBVH picking;
+		double startTime = GetHighResolutionTime();
+		for (int build = 0; build < numBuilds; build++)
+		{
+			picking.Clear();
+			for (int i = 0; i < numCharacters; i++)
+			{
+				AddPickingCharacter(&picking, vParts, i, vPositions[i], vRotations[i], characterScale);
+			}
+			picking.Build();
+		}
+		double buildTime = GetElapsedMilliseconds(startTime);
+
+		vector<vec3> vOrigins(numFrames);
+		vector<vec3> vDirections(numFrames);
+		for (int i = 0; i < numFrames; i++)
+		{
+			PickingBVH::GetScreenRay(vInputs[i].m_mouseX, vInputs[i].m_mouseY, screenWidth, screenHeight, fov, vInputs[i].m_cameraPosition, vInputs[i].m_cameraTarget, vec3(0.0f, 1.0f, 0.0f), &vOrigins[i], &vDirections[i]);
+		}
+
+		vector<PickingHit> vHits(numFrames);
+		vector<bool> vHitFound(numFrames);
+		long long numNodeTests = 0;
+		long long numVolumeTests = 0;
+		int numHits = 0;
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numFrames; i++)
+		{
+			vHitFound[i] = picking.RayCast(vOrigins[i], vDirections[i], farDistance, &vHits[i]);
+			numNodeTests += picking.GetNumNodeTests();
+			numVolumeTests += picking.GetNumVolumeTests();
+			if (vHitFound[i])
+			{
+				numHits++;
+			}
+		}
+		double rayCastTime = GetElapsedMilliseconds(startTime);
+
+		int numMismatches = 0;
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numFrames; i++)
+		{
+			PickingHit hit;
+			bool found = picking.RayCastBruteForce(vOrigins[i], vDirections[i], farDistance, &hit);
+			if (found != vHitFound[i] || (found && (hit.m_id != vHits[i].m_id || fabs(hit.m_distance - vHits[i].m_distance) > 0.0001f)))
+			{
+				numMismatches++;
+			}
+		}
+		double bruteForceTime = GetElapsedMilliseconds(startTime);
+
+		char name[64];
+		sprintf(name, "build_%i", numCharacters);
+		pReport->AddTiming(name, buildTime);
+		sprintf(name, "build_per_frame_ms_%i", numCharacters);
+		pReport->AddValue(name, buildTime / numBuilds);
+		sprintf(name, "ray_casts_%i", numCharacters);
+		pReport->AddTiming(name, rayCastTime);
+		sprintf(name, "brute_force_ray_casts_%i", numCharacters);
+		pReport->AddTiming(name, bruteForceTime);
+		sprintf(name, "ray_cast_us_%i", numCharacters);
+		pReport->AddValue(name, rayCastTime * 1000.0 / numFrames);
+		sprintf(name, "volumes_%i", numCharacters);
+		pReport->AddValue(name, picking.GetNumVolumes());
+		sprintf(name, "nodes_%i", numCharacters);
+		pReport->AddValue(name, picking.GetNumNodes());
+		sprintf(name, "node_tests_per_ray_%i", numCharacters);
+		pReport->AddValue(name, (double)numNodeTests / numFrames);
+		sprintf(name, "volume_tests_per_ray_%i", numCharacters);
+		pReport->AddValue(name, (double)numVolumeTests / numFrames);
+		sprintf(name, "hits_%i", numCharacters);
+		pReport->AddValue(name, numHits);
+		sprintf(name, "mismatches_%i", numCharacters);
+		pReport->AddValue(name, numMismatches);
+
+		if (numMismatches != 0)
+		{
+			matchesBruteForce = false;
+		}
+		if (numVolumeTests >= (long long)picking.GetNumVolumes() * numFrames)
+		{
+			fewerTests = false;
+		}
+		if (numHits < numFrames / 4)
+		{
+			charactersPicked = false;
+		}
+	}
+
+	pReport->AddCheck("matches_brute_force", matchesBruteForce);
+	pReport->AddCheck("fewer_volume_tests", fewerTests);
+	pReport->AddCheck("characters_picked", charactersPicked);
+
+	// A camera looking straight at a character away from the crowd picks it with the middle of the screen
+	PickingBVH picking;
+	vec3 targetPosition = vec3(-50.0f, 0.0f, -50.0f);
+	AddPickingCharacter(&picking, vParts, 7, targetPosition, 0.5f, characterScale);
+	AddPickingCharacter(&picking, vParts, 8, vec3(100.0f, 0.0f, 100.0f), 0.0f, characterScale);
+	picking.Build();
+
+	vec3 bodyCenter = targetPosition + vec3(0.0f, 13.5f * characterScale, 0.0f);
+	vec3 origin;
+	vec3 direction;
+	PickingBVH::GetScreenRay(screenWidth * 0.5f, screenHeight * 0.5f, screenWidth, screenHeight, fov, bodyCenter + vec3(0.0f, 1.0f, 5.0f), bodyCenter, vec3(0.0f, 1.0f, 0.0f), &origin, &direction);
+	PickingHit hit;
+	bool centreHit = picking.RayCast(origin, direction, farDistance, &hit) && hit.m_id == 7;
+
+	// Through the empty corner of a voxel grid, inside its box
+	PickingBVH cornerPicking;
+	Matrix4x4 identity;
+	cornerPicking.AddVoxels(1, identity, &vParts[1].m_vVoxels[0], vParts[1].m_sizeX, vParts[1].m_sizeY, vParts[1].m_sizeZ);
+	cornerPicking.AddBox(2, identity, vec3(20.0f, -0.5f, -0.5f), vec3(21.0f, 0.5f, 0.5f));
+	cornerPicking.Build();
+	bool emptyMissed = (cornerPicking.RayCast(vec3(-0.3f, -0.3f, -5.0f), vec3(0.0f, 0.0f, 1.0f), farDistance, &hit) == false);
+	bool boxHit = cornerPicking.RayCast(vec3(20.5f, 0.0f, -5.0f), vec3(0.0f, 0.0f, 1.0f), farDistance, &hit) && hit.m_id == 2 && fabs(hit.m_distance - 4.5f) < 0.0001f;
+
+	// The voxel walk against small steps along random rays through the grid
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 12, 0));
+	PickingBVH voxelPicking;
+	voxelPicking.AddVoxels(1, identity, &vParts[0].m_vVoxels[0], vParts[0].m_sizeX, vParts[0].m_sizeY, vParts[0].m_sizeZ);
+	voxelPicking.Build();
+	int numWalkRays = quick ? 200 : 1000;
+	int numWalkMismatches = 0;
+	for (int i = 0; i < numWalkRays; i++)
+	{
+		vec3 rayOrigin = vec3(random.GetRandomNumber(-10, 20, 2), random.GetRandomNumber(-10, 22, 2), random.GetRandomNumber(-10, 18, 2));
+		vec3 rayTarget = vec3(random.GetRandomNumber(0, 9, 2), random.GetRandomNumber(0, 11, 2), random.GetRandomNumber(0, 7, 2));
+		vec3 rayDirection = normalize(rayTarget - rayOrigin);
+
+		float marchDistance = 0.0f;
+		bool marchHit = MarchVoxels(vParts[0], rayOrigin, rayDirection, 50.0f, &marchDistance);
+		bool walkHit = voxelPicking.RayCast(rayOrigin, rayDirection, 50.0f, &hit);
+		if (marchHit != walkHit || (walkHit && fabs(hit.m_distance - marchDistance) > 0.002f))
+		{
+			numWalkMismatches++;
+		}
+	}
+	pReport->AddValue("voxel_walk_mismatches", numWalkMismatches);
+
+	pReport->AddCheck("centre_of_screen_picks_target", centreHit);
+	pReport->AddCheck("empty_voxels_missed", emptyMissed);
+	pReport->AddCheck("box_hit_distance", boxHit);
+	pReport->AddCheck("voxel_walk_matches_march", numWalkMismatches == 0);
+}
@@ -0,0 +1,804 @@
+// ******************************************************************************
+// Filename:    BenchGameplayScenarios.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Scripted scenarios that drive several subsystems together, the way a
+//   frame of the game would: walking across the world, blowing holes in the
+//   terrain, a crowd of enemies and projectiles fired at a thin wall and
+//   small enemies.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchScenarios.h"
+#include "BenchWorld.h"
+
+#include "../utils/JobPool.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/ParallelUpdate.h"
+#include "../utils/FixedTimestep.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/SweptCollision.h"
+#include "../utils/EntityStep.h"
+#include "../Particles/BlockParticlePool.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+
+// Meshes all the chunks that need a rebuild, returns how many were meshed
+static int RemeshChunks(BenchWorld* pWorld, ChunkMesher* pMesher, ChunkMeshQuadList* pQuads, int* pNumQuads)
+{
+	int numMeshed = 0;
+
+	BenchChunkList* pChunkList = pWorld->GetChunkList();
+	for (unsigned int i = 0; i < pChunkList->size(); i++)
+	{
+		BenchChunk* pChunk = (*pChunkList)[i];
+		if (pChunk->m_needsRebuild)
+		{
+			*pNumQuads += pWorld->MeshChunk(pChunk, pMesher, pQuads, true);
+			numMeshed++;
+		}
+	}
+
+	return numMeshed;
+}
+
+// Walk 500 blocks
+void BenchWalk500Blocks(BenchReport* pReport, bool quick)
+{
+	int loaderRadius = quick ? 3 : 5;
+	float walkSpeed = 10.0f;
+	float walkDistance = 500.0f;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	JobPool* pJobPool = new JobPool(0);
+	ChunkMesher mesher;
+	ChunkMeshQuadList quads;
+	FixedTimestep timestep(60);
+
+	vec3 position = vec3(0.0f, 0.0f, 0.0f);
+	float velocityY = 0.0f;
+	int loaderGridX = 0x7FFFFFFF;
+	int loaderGridZ = 0x7FFFFFFF;
+
+	int numChunksGenerated = 0;
+	int numChunksMeshed = 0;
+	int numQuads = 0;
+	int numSteps = 0;
+	int numClimbs = 0;
+	bool firstLoad = true;
+	while (position.x < walkDistance)
+	{
+		// Load the chunks around the player whenever we cross into a new chunk column
+		int gridX = BenchWorld::GetGridCoordinate((int)floor(position.x + 0.5f));
+		int gridZ = BenchWorld::GetGridCoordinate((int)floor(position.z + 0.5f));
+		if (gridX != loaderGridX || gridZ != loaderGridZ)
+		{
+			loaderGridX = gridX;
+			loaderGridZ = gridZ;
+
+			double startTime = GetHighResolutionTime();
+			numChunksGenerated += world.CreateChunks(gridX - loaderRadius, 0, gridZ - loaderRadius, gridX + loaderRadius, BenchWorld::MAX_TERRAIN_GRID_Y, gridZ + loaderRadius, pJobPool);
+			pReport->AddTiming("generation", GetElapsedMilliseconds(startTime));
+
+			startTime = GetHighResolutionTime();
+			numChunksMeshed += RemeshChunks(&world, &mesher, &quads, &numQuads);
+			pReport->AddTiming("meshing", GetElapsedMilliseconds(startTime));
+
+			if (firstLoad)
+			{
+				// Start standing on the ground
+				position.y = (float)world.GetGroundHeight(0, 0);
+				firstLoad = false;
+			}
+		}
+
+		// A frame of simulation, every step walks forwards and does the player's gravity and ground check
+		double startTime = GetHighResolutionTime();
+		int steps = timestep.Update(1.0f / 60.0f);
+		for (int i = 0; i < steps; i++)
+		{
+			float dt = timestep.GetStepTime();
+
+			position.x += walkSpeed * dt;
+			velocityY += -9.81f * 4.0f * dt;
+			position.y += velocityY * dt;
+
+			int groundHeight = world.GetGroundHeight((int)floor(position.x + 0.5f), (int)floor(position.z + 0.5f));
+			if (position.y < groundHeight)
+			{
+				// More than a block up and we need to jump
+				if (groundHeight - position.y > 1.0f)
+				{
+					numClimbs++;
+				}
+
+				position.y = (float)groundHeight;
+				velocityY = 0.0f;
+			}
+
+			numSteps++;
+		}
+		pReport->AddTiming("physics", GetElapsedMilliseconds(startTime));
+	}
+
+	delete pJobPool;
+
+	pReport->AddValue("loader_radius", loaderRadius);
+	pReport->AddValue("chunks_generated", numChunksGenerated);
+	pReport->AddValue("chunks_meshed", numChunksMeshed);
+	pReport->AddValue("quads", numQuads);
+	pReport->AddValue("simulation_steps", numSteps);
+	pReport->AddValue("climbs", numClimbs);
+	pReport->AddValue("final_height", position.y);
+	pReport->AddCheck("walked_500_blocks", position.x >= walkDistance);
+}
+
+// Explode 50 spheres
+void BenchExplode50Spheres(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 3 : 5;
+	int numExplosions = 50;
+	int framesBetweenExplosions = 10;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	JobPool* pJobPool = new JobPool(0);
+	ChunkMesher mesher;
+	ChunkMeshQuadList quads;
+
+	double startTime = GetHighResolutionTime();
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, pJobPool);
+	pReport->AddTiming("generation", GetElapsedMilliseconds(startTime));
+	delete pJobPool;
+
+	int numQuads = 0;
+	startTime = GetHighResolutionTime();
+	RemeshChunks(&world, &mesher, &quads, &numQuads);
+	pReport->AddTiming("initial_meshing", GetElapsedMilliseconds(startTime));
+
+	// No world collisions for the debris, the pool doesn't need a chunk manager then
+	BlockParticlePool* pPool = new BlockParticlePool(NULL, 100000);
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 4, 0));
+	vector<vec3> vRemovedPositions;
+	vector<unsigned int> vRemovedColours;
+
+	int worldBlocks = (radius*2 + 1) * Chunk::CHUNK_SIZE;
+	int numBlocksRemoved = 0;
+	int numChunksRemeshed = 0;
+	int numDebris = 0;
+	int maxParticles = 0;
+	for (int explosion = 0; explosion < numExplosions; explosion++)
+	{
+		// Somewhere on the surface, away from the edges of the loaded area
+		int x = random.GetRandomNumber(-worldBlocks/2 + 8, worldBlocks/2 - 8);
+		int z = random.GetRandomNumber(-worldBlocks/2 + 8, worldBlocks/2 - 8);
+		float sphereRadius = random.GetRandomNumber(3, 6, 1);
+		vec3 center = vec3((float)x, (float)world.GetGroundHeight(x, z), (float)z);
+
+		vRemovedPositions.clear();
+		vRemovedColours.clear();
+		startTime = GetHighResolutionTime();
+		numBlocksRemoved += world.CarveSphere(center, sphereRadius, &vRemovedPositions, &vRemovedColours);
+		pReport->AddTiming("carve", GetElapsedMilliseconds(startTime));
+
+		startTime = GetHighResolutionTime();
+		numChunksRemeshed += RemeshChunks(&world, &mesher, &quads, &numQuads);
+		pReport->AddTiming("remesh", GetElapsedMilliseconds(startTime));
+
+		// A debris particle for every removed block, thrown out from the center
+		startTime = GetHighResolutionTime();
+		for (unsigned int i = 0; i < vRemovedPositions.size(); i++)
+		{
+			vec3 direction = vRemovedPositions[i] - center;
+			if (length(direction) > 0.0f)
+			{
+				direction = normalize(direction);
+			}
+			vec3 velocity = direction * random.GetRandomNumber(5, 15, 2) + vec3(0.0f, 5.0f, 0.0f);
+			vec3 angularVelocity = vec3(random.GetRandomNumber(-180, 180, 2), random.GetRandomNumber(-180, 180, 2), random.GetRandomNumber(-180, 180, 2));
+
+			unsigned int colour = vRemovedColours[i];
+			float r = (colour & 0xFF) / 255.0f;
+			float g = ((colour >> 8) & 0xFF) / 255.0f;
+			float b = ((colour >> 16) & 0xFF) / 255.0f;
+			if (pPool->AddParticle(vRemovedPositions[i], vRemovedPositions[i], velocity, vec3(0.0f, -9.81f, 0.0f), vec3(0.0f, 0.0f, 0.0f), angularVelocity,
+								   r, g, b, 1.0f, 0.5f, r, g, b, 0.0f, 0.5f, random.GetRandomNumber(1, 3, 2)) != NULL)
+			{
+				numDebris++;
+			}
+		}
+		pReport->AddTiming("spawn_debris", GetElapsedMilliseconds(startTime));
+
+		startTime = GetHighResolutionTime();
+		for (int frame = 0; frame < framesBetweenExplosions; frame++)
+		{
+			pPool->Update(1.0f / 60.0f);
+
+			if (pPool->GetNumParticles() > maxParticles)
+			{
+				maxParticles = pPool->GetNumParticles();
+			}
+		}
+		pReport->AddTiming("particles", GetElapsedMilliseconds(startTime));
+	}
+
+	delete pPool;
+
+	pReport->AddValue("num_chunks", world.GetNumChunks());
+	pReport->AddValue("blocks_removed", numBlocksRemoved);
+	pReport->AddValue("chunks_remeshed", numChunksRemeshed);
+	pReport->AddValue("debris_particles", numDebris);
+	pReport->AddValue("max_particles", maxParticles);
+	pReport->AddCheck("terrain_was_carved", numBlocksRemoved > 0);
+}
+
+// Spawn 200 enemies
+class BenchEnemy
+{
+public:
+	// The feet, like Enemy::GetPosition(), the center is a radius above
+	vec3 m_position;
+	vec3 m_target;
+	float m_velocityY;
+	float m_radius;
+};
+
+class BenchEnemyCrowd
+{
+public:
+	BenchWorld* m_pWorld;
+	SpatialGrid* m_pSpatialGrid;
+	vector<BenchEnemy> m_vEnemies;
+
+	// Only used from the deferred commands, so that the targets come out in the same order on any number of threads
+	RandomGenerator* m_pTargetRandom;
+	int m_worldBlocks;
+	int m_numNewTargets;
+
+	float m_dt;
+};
+
+static void _NewEnemyTarget(void* pObject, void* pData)
+{
+	BenchEnemyCrowd* pCrowd = (BenchEnemyCrowd*)pObject;
+	BenchEnemy* pEnemy = &pCrowd->m_vEnemies[(int)(size_t)pData];
+
+	int halfSize = pCrowd->m_worldBlocks / 2 - 4;
+	pEnemy->m_target = vec3((float)pCrowd->m_pTargetRandom->GetRandomNumber(-halfSize, halfSize), 0.0f, (float)pCrowd->m_pTargetRandom->GetRandomNumber(-halfSize, halfSize));
+	pCrowd->m_numNewTargets++;
+}
+
+static void _UpdateEnemyParallel(void* pData, int index, DeferredCommandBuffer* pCommands)
+{
+	BenchEnemyCrowd* pCrowd = (BenchEnemyCrowd*)pData;
+	BenchEnemy* pEnemy = &pCrowd->m_vEnemies[index];
+	float dt = pCrowd->m_dt;
+
+	// Walk towards the target
+	vec3 toTarget = pEnemy->m_target - pEnemy->m_position;
+	toTarget.y = 0.0f;
+	float distance = length(toTarget);
+	if (distance < 1.0f)
+	{
+		pCommands->AddCommand(_NewEnemyTarget, pCrowd, (void*)(size_t)index);
+	}
+	else
+	{
+		pEnemy->m_position += (toTarget / distance) * 4.0f * dt;
+	}
+
+	// Gravity and the ground
+	pEnemy->m_velocityY += -9.81f * 4.0f * dt;
+	pEnemy->m_position.y += pEnemy->m_velocityY * dt;
+	int groundHeight = pCrowd->m_pWorld->GetGroundHeight((int)floor(pEnemy->m_position.x + 0.5f), (int)floor(pEnemy->m_position.z + 0.5f));
+	if (pEnemy->m_position.y < groundHeight)
+	{
+		pEnemy->m_position.y = (float)groundHeight;
+		pEnemy->m_velocityY = 0.0f;
+	}
+}
+
+static vec3 GetEnemyCenter(BenchEnemy* pEnemy)
+{
+	return pEnemy->m_position + vec3(0.0f, pEnemy->m_radius, 0.0f);
+}
+
+// EnemyManager::PushCollisions(), the enemy pushes the others it touches out of the way
+static void PushEnemies(BenchEnemyCrowd* pCrowd, BenchEnemy* pPushingEnemy)
+{
+	vec3 center = GetEnemyCenter(pPushingEnemy);
+
+	vector<void*> vpNearby;
+	pCrowd->m_pSpatialGrid->RadiusQuery(eSpatialGridLayer_Enemy, center, pPushingEnemy->m_radius, &vpNearby);
+	for (unsigned int i = 0; i < vpNearby.size(); i++)
+	{
+		BenchEnemy* pEnemy = (BenchEnemy*)vpNearby[i];
+		if (pEnemy == pPushingEnemy)
+		{
+			continue;
+		}
+
+		vec3 pushVector;
+		if (EntityStep::GetPushVector(center, pPushingEnemy->m_radius, GetEnemyCenter(pEnemy), pEnemy->m_radius, &pushVector))
+		{
+			pEnemy->m_position += pushVector;
+
+			pCrowd->m_pSpatialGrid->AddObject(eSpatialGridLayer_Enemy, pEnemy, GetEnemyCenter(pEnemy), pEnemy->m_radius);
+		}
+	}
+}
+
+static double SimulateEnemyCrowd(BenchWorld* pWorld, int worldBlocks, int numEnemies, int numSteps, int numThreads, BenchReport* pReport, int* pNumNewTargets)
+{
+	SpatialGrid spatialGrid(Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f);
+	ParallelUpdate parallelUpdate(numThreads);
+	RandomGenerator targetRandom(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 5, 1));
+
+	BenchEnemyCrowd crowd;
+	crowd.m_pWorld = pWorld;
+	crowd.m_pSpatialGrid = &spatialGrid;
+	crowd.m_pTargetRandom = &targetRandom;
+	crowd.m_worldBlocks = worldBlocks;
+	crowd.m_numNewTargets = 0;
+	crowd.m_dt = 1.0f / 60.0f;
+
+	// Spawn them all in a crowd in the middle of the world
+	RandomGenerator spawnRandom(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 5, 0));
+	crowd.m_vEnemies.resize(numEnemies);
+	for (int i = 0; i < numEnemies; i++)
+	{
+		BenchEnemy* pEnemy = &crowd.m_vEnemies[i];
+		int x = spawnRandom.GetRandomNumber(-20, 20);
+		int z = spawnRandom.GetRandomNumber(-20, 20);
+		pEnemy->m_position = vec3((float)x, (float)pWorld->GetGroundHeight(x, z), (float)z);
+		pEnemy->m_target = pEnemy->m_position;
+		pEnemy->m_velocityY = 0.0f;
+		pEnemy->m_radius = 0.75f;
+	}
+
+	for (int step = 0; step < numSteps; step++)
+	{
+		double startTime = GetHighResolutionTime();
+		spatialGrid.ClearLayer(eSpatialGridLayer_Enemy);
+		for (int i = 0; i < numEnemies; i++)
+		{
+			BenchEnemy* pEnemy = &crowd.m_vEnemies[i];
+			spatialGrid.AddObject(eSpatialGridLayer_Enemy, pEnemy, GetEnemyCenter(pEnemy), pEnemy->m_radius);
+		}
+		if (pReport != NULL)
+		{
+			pReport->AddTiming("spatial_grid", GetElapsedMilliseconds(startTime));
+		}
+
+		startTime = GetHighResolutionTime();
+		parallelUpdate.Run(numEnemies, _UpdateEnemyParallel, &crowd);
+		if (pReport != NULL)
+		{
+			pReport->AddTiming("enemy_update", GetElapsedMilliseconds(startTime));
+		}
+
+		// Then one at a time, like EnemyManager::Update(), since the pushes move the other enemies
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numEnemies; i++)
+		{
+			BenchEnemy* pEnemy = &crowd.m_vEnemies[i];
+
+			spatialGrid.AddObject(eSpatialGridLayer_Enemy, pEnemy, GetEnemyCenter(pEnemy), pEnemy->m_radius);
+			PushEnemies(&crowd, pEnemy);
+		}
+		if (pReport != NULL)
+		{
+			pReport->AddTiming("enemy_push", GetElapsedMilliseconds(startTime));
+		}
+	}
+
+	*pNumNewTargets = crowd.m_numNewTargets;
+
+	// Sum of the positions, to compare the runs
+	double positionSum = 0.0;
+	for (int i = 0; i < numEnemies; i++)
+	{
+		positionSum += crowd.m_vEnemies[i].m_position.x + crowd.m_vEnemies[i].m_position.y * 1000.0 + crowd.m_vEnemies[i].m_position.z * 1000000.0;
+	}
+
+	return positionSum;
+}
+
+void BenchSpawn200Enemies(BenchReport* pReport, bool quick)
+{
+	int radius = 3;
+	int numEnemies = 200;
+	int numSteps = 600;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	JobPool* pJobPool = new JobPool(0);
+	double startTime = GetHighResolutionTime();
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, pJobPool);
+	pReport->AddTiming("generation", GetElapsedMilliseconds(startTime));
+	delete pJobPool;
+
+	int worldBlocks = (radius*2 + 1) * Chunk::CHUNK_SIZE;
+
+	// Timed on all the threads, then again on the calling thread only to make sure the threads don't change the result
+	int numNewTargets = 0;
+	double parallelSum = SimulateEnemyCrowd(&world, worldBlocks, numEnemies, numSteps, 0, pReport, &numNewTargets);
+
+	int serialNewTargets = 0;
+	startTime = GetHighResolutionTime();
+	double serialSum = SimulateEnemyCrowd(&world, worldBlocks, numEnemies, numSteps, 1, NULL, &serialNewTargets);
+	pReport->AddTiming("enemy_simulation_1_thread", GetElapsedMilliseconds(startTime));
+
+	pReport->AddValue("num_enemies", numEnemies);
+	pReport->AddValue("simulation_steps", numSteps);
+	pReport->AddValue("simulated_seconds", numSteps / 60.0);
+	pReport->AddValue("new_targets", numNewTargets);
+	pReport->AddCheck("same_result_on_1_thread", parallelSum == serialSum && numNewTargets == serialNewTargets);
+}
+
+
+// Projectiles
+static const float BENCH_PROJECTILE_RADIUS = 0.25f;
+static const float BENCH_PROJECTILE_FLIGHT_TIME = 2.0f;
+
+class BenchShot
+{
+public:
+	// The bottom of the projectile like Projectile::m_position, the center is a radius above
+	vec3 m_position;
+	vec3 m_velocity;
+
+	bool m_stopped;
+	int m_targetHit;
+	vec3 m_impact;
+};
+
+class BenchShotTarget
+{
+public:
+	vec3 m_center;
+	float m_radius;
+};
+
+// One step of Projectile::Update() against the blocks, then the targets like the enemy manager, earliest hit first
+static void StepSweptShot(BenchWorld* pWorld, BenchShot* pShot, vec3 acceleration, float dt, const vector<BenchShotTarget> &vTargets, int* pNumBlocksVisited)
+{
+	vec3 sweepStart = pShot->m_position;
+
+	VoxelRayHit hit;
+	if (EntityStep::MoveProjectile(sweepStart, &pShot->m_position, &pShot->m_velocity, acceleration, dt, BenchWorld::_GetRayChunk, BenchWorld::_GetRayBlock, pWorld, &hit))
+	{
+		pShot->m_position = hit.m_hitPosition;
+		pShot->m_velocity = vec3(0.0f, 0.0f, 0.0f);
+		pShot->m_stopped = true;
+		pShot->m_impact = hit.m_hitPosition;
+	}
+	*pNumBlocksVisited += hit.m_numBlocksVisited;
+
+	vec3 up = vec3(0.0f, BENCH_PROJECTILE_RADIUS, 0.0f);
+	vector<SweptHit> vHits;
+	for (unsigned int i = 0; i < vTargets.size(); i++)
+	{
+		SweptHit targetHit;
+		if (SweptCollision::SphereSphere(sweepStart + up, pShot->m_position + up, BENCH_PROJECTILE_RADIUS, vTargets[i].m_center, vTargets[i].m_radius, &targetHit.m_time))
+		{
+			targetHit.m_pObject = (void*)&vTargets[i];
+			targetHit.m_pOther = pShot;
+			vHits.push_back(targetHit);
+		}
+	}
+
+	if (vHits.size() > 0)
+	{
+		stable_sort(vHits.begin(), vHits.end(), SweptHit::EarliestFirst);
+		pShot->m_targetHit = (int)((BenchShotTarget*)vHits[0].m_pObject - &vTargets[0]);
+		pShot->m_impact = sweepStart + (pShot->m_position - sweepStart) * vHits[0].m_time;
+		pShot->m_stopped = true;
+	}
+}
+
+// The old step, integrate and then look at the one block and the targets where the projectile ends up
+static void StepPointShot(BenchWorld* pWorld, BenchShot* pShot, vec3 acceleration, float dt, const vector<BenchShotTarget> &vTargets)
+{
+	pShot->m_velocity += acceleration * dt;
+	pShot->m_position += pShot->m_velocity * dt;
+
+	if (pWorld->GetBlockActiveFromPosition(pShot->m_position))
+	{
+		pShot->m_position -= pShot->m_velocity * dt;
+		pShot->m_velocity = vec3(0.0f, 0.0f, 0.0f);
+		pShot->m_stopped = true;
+		pShot->m_impact = pShot->m_position;
+	}
+
+	vec3 center = pShot->m_position + vec3(0.0f, BENCH_PROJECTILE_RADIUS, 0.0f);
+	for (unsigned int i = 0; i < vTargets.size() && pShot->m_targetHit == -1; i++)
+	{
+		if (length(vTargets[i].m_center - center) < vTargets[i].m_radius + BENCH_PROJECTILE_RADIUS)
+		{
+			pShot->m_targetHit = i;
+			pShot->m_impact = pShot->m_position;
+			pShot->m_stopped = true;
+		}
+	}
+}
+
+static void FlyShot(BenchWorld* pWorld, BenchShot* pShot, vec3 acceleration, float dt, const vector<BenchShotTarget> &vTargets, bool swept, int* pNumBlocksVisited)
+{
+	int numSteps = (int)ceil(BENCH_PROJECTILE_FLIGHT_TIME / dt);
+	for (int i = 0; i < numSteps && pShot->m_stopped == false; i++)
+	{
+		if (swept)
+		{
+			StepSweptShot(pWorld, pShot, acceleration, dt, vTargets, pNumBlocksVisited);
+		}
+		else
+		{
+			StepPointShot(pWorld, pShot, acceleration, dt, vTargets);
+		}
+	}
+}
+
+// Whether the center is inside the box grown by the radius, what the cube hitboxes tested at the end of each step before
+static bool InsideGrownBox(vec3 point, float radius, vec3 boxCenter, const vec3 axes[3], vec3 halfLengths)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		if (fabs(dot(point - boxCenter, axes[i])) > halfLengths[i] + radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BenchProjectiles(BenchReport* pReport, bool quick)
+{
+	int numShots = quick ? 200 : 1000;
+
+	// An empty arena, 64 blocks long, with a one block thick wall across it
+	const int WALL_X = 40;
+	BenchWorld world(BENCH_WORLD_SEED, false);
+	for (int x = 0; x < 4; x++)
+	{
+		for (int y = 0; y < 2; y++)
+		{
+			for (int z = 0; z < 2; z++)
+			{
+				BenchChunk* pChunk = world.CreateChunk(x, y, z);
+				memset(pChunk->m_colour, 0, sizeof(pChunk->m_colour));
+				world.AddChunk(pChunk);
+			}
+		}
+	}
+	int arenaSize = Chunk::CHUNK_SIZE * 2;
+	for (int y = 0; y < arenaSize; y++)
+	{
+		for (int z = 0; z < arenaSize; z++)
+		{
+			BenchChunk* pChunk = world.GetChunk(WALL_X / Chunk::CHUNK_SIZE, y / Chunk::CHUNK_SIZE, z / Chunk::CHUNK_SIZE);
+			pChunk->m_colour[(WALL_X % Chunk::CHUNK_SIZE) + (y % Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE + (z % Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE_SQUARED] = 0x808080FF;
+		}
+	}
+	float wallFace = WALL_X - Chunk::BLOCK_RENDER_SIZE;
+
+	// From a 240Hz tick to a frame that hit the 0.25 second limit
+	const int NUM_STEP_LENGTHS = 6;
+	const char* stepNames[NUM_STEP_LENGTHS] = { "240hz", "120hz", "60hz", "30hz", "10hz", "4hz" };
+	float stepLengths[NUM_STEP_LENGTHS] = { 1.0f / 240.0f, 1.0f / 120.0f, 1.0f / 60.0f, 1.0f / 30.0f, 0.1f, 0.25f };
+
+	// Arrows and fireballs fired at the wall, straight and in an arc that lands on a known height on the wall.
+	// The gravity is the same as Projectile::Update() with its default multiplier.
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 14, 0));
+	vec3 gravity = vec3(0.0f, -9.81f * 2.5f, 0.0f);
+	vector<vec3> vStarts(numShots);
+	vector<vec3> vVelocities(numShots);
+	vector<bool> vArcs(numShots);
+	vector<float> vWallHeights(numShots);
+	for (int i = 0; i < numShots; i++)
+	{
+		vStarts[i] = vec3(random.GetRandomNumber(2, 8, 2), random.GetRandomNumber(10, 22, 2), random.GetRandomNumber(10, 22, 2));
+		vec3 direction = normalize(vec3(1.0f, random.GetRandomNumber(-20, 20, 2) * 0.01f, random.GetRandomNumber(-20, 20, 2) * 0.01f));
+		vVelocities[i] = direction * random.GetRandomNumber(20, 80, 2);
+
+		// Every other shot is an arc, aimed up so that the exact curve reaches the wall at the wall height
+		vArcs[i] = (i % 2) == 1;
+		float timeToWall = (wallFace - vStarts[i].x) / vVelocities[i].x;
+		vWallHeights[i] = vStarts[i].y + vVelocities[i].y * timeToWall;
+		if (vArcs[i])
+		{
+			vWallHeights[i] = random.GetRandomNumber(4, 28, 2);
+			vVelocities[i].y = (vWallHeights[i] - vStarts[i].y - 0.5f * gravity.y * timeToWall * timeToWall) / timeToWall;
+		}
+	}
+
+	vector<BenchShotTarget> vNoTargets;
+	bool neverTunnels = true;
+	bool arcsOnCurve = true;
+	float maxStraightDifference = 0.0f;
+	vector<vec3> vReferenceImpacts(numShots);
+	for (int step = 0; step < NUM_STEP_LENGTHS; step++)
+	{
+		float dt = stepLengths[step];
+		float maxChordGap = -gravity.y * dt * dt / 8.0f;
+
+		int numPointTunnels = 0;
+		double startTime = GetHighResolutionTime();
+		for (int i = 0; i < numShots; i++)
+		{
+			BenchShot shot = { vStarts[i], vVelocities[i], false, -1, vec3(0.0f, 0.0f, 0.0f) };
+			FlyShot(&world, &shot, vArcs[i] ? gravity : vec3(0.0f, 0.0f, 0.0f), dt, vNoTargets, false, NULL);
+			if (shot.m_stopped == false)
+			{
+				numPointTunnels++;
+			}
+		}
+		double pointTime = GetElapsedMilliseconds(startTime);
+
+		int numSweptTunnels = 0;
+		int numBlocksVisited = 0;
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numShots; i++)
+		{
+			BenchShot shot = { vStarts[i], vVelocities[i], false, -1, vec3(0.0f, 0.0f, 0.0f) };
+			FlyShot(&world, &shot, vArcs[i] ? gravity : vec3(0.0f, 0.0f, 0.0f), dt, vNoTargets, true, &numBlocksVisited);
+
+			if (shot.m_stopped == false || fabs(shot.m_impact.x - wallFace) > 0.001f)
+			{
+				numSweptTunnels++;
+				continue;
+			}
+
+			// The steps end on the exact curve, so the impact can only be off by how far the chord between them sags from the curve
+			if (vArcs[i])
+			{
+				if (fabs(shot.m_impact.y - vWallHeights[i]) > maxChordGap + 0.001f)
+				{
+					arcsOnCurve = false;
+				}
+			}
+			else
+			{
+				if (step == 0)
+				{
+					vReferenceImpacts[i] = shot.m_impact;
+				}
+				float difference = length(shot.m_impact - vReferenceImpacts[i]);
+				maxStraightDifference = (difference > maxStraightDifference) ? difference : maxStraightDifference;
+			}
+		}
+		double sweptTime = GetElapsedMilliseconds(startTime);
+
+		neverTunnels = neverTunnels && (numSweptTunnels == 0);
+
+		char name[64];
+		sprintf(name, "wall_point_test_%s", stepNames[step]);
+		pReport->AddTiming(name, pointTime);
+		sprintf(name, "wall_swept_%s", stepNames[step]);
+		pReport->AddTiming(name, sweptTime);
+		sprintf(name, "wall_tunnels_point_test_%s", stepNames[step]);
+		pReport->AddValue(name, numPointTunnels);
+		sprintf(name, "wall_tunnels_swept_%s", stepNames[step]);
+		pReport->AddValue(name, numSweptTunnels);
+		sprintf(name, "blocks_per_shot_swept_%s", stepNames[step]);
+		pReport->AddValue(name, (double)numBlocksVisited / numShots);
+	}
+	pReport->AddValue("max_straight_impact_difference", (double)maxStraightDifference);
+
+	// Three bat sized enemies in a row in front of the wall, on the line of each straight shot, the nearest one must be hit
+	bool nearestTargetHit = true;
+	float maxTargetDifference = 0.0f;
+	vector<vec3> vReferenceTargetImpacts(numShots);
+	for (int step = 0; step < NUM_STEP_LENGTHS; step++)
+	{
+		float dt = stepLengths[step];
+		int numPointMisses = 0;
+
+		for (int i = 0; i < numShots; i++)
+		{
+			vec3 direction = normalize(vVelocities[i]);
+			vec3 startCenter = vStarts[i] + vec3(0.0f, BENCH_PROJECTILE_RADIUS, 0.0f);
+			vector<BenchShotTarget> vTargets(3);
+			for (int j = 0; j < 3; j++)
+			{
+				// Off the line by up to most of the combined radius, so some of the hits only clip the edge
+				float along = 8.0f + j * 6.0f;
+				vec3 offset = vec3(0.0f, ((i * 7 + j * 3) % 11 - 5) * 0.1f, 0.0f);
+				vTargets[2 - j].m_center = startCenter + direction * along + offset;
+				vTargets[2 - j].m_radius = 0.3f;
+			}
+
+			BenchShot pointShot = { vStarts[i], vVelocities[i], false, -1, vec3(0.0f, 0.0f, 0.0f) };
+			FlyShot(&world, &pointShot, vec3(0.0f, 0.0f, 0.0f), dt, vTargets, false, NULL);
+			if (pointShot.m_targetHit != 2)
+			{
+				numPointMisses++;
+			}
+
+			int numBlocksVisited = 0;
+			BenchShot shot = { vStarts[i], vVelocities[i], false, -1, vec3(0.0f, 0.0f, 0.0f) };
+			FlyShot(&world, &shot, vec3(0.0f, 0.0f, 0.0f), dt, vTargets, true, &numBlocksVisited);
+			if (shot.m_targetHit != 2)
+			{
+				nearestTargetHit = false;
+				continue;
+			}
+
+			if (step == 0)
+			{
+				vReferenceTargetImpacts[i] = shot.m_impact;
+			}
+			float difference = length(shot.m_impact - vReferenceTargetImpacts[i]);
+			maxTargetDifference = (difference > maxTargetDifference) ? difference : maxTargetDifference;
+		}
+
+		char name[64];
+		sprintf(name, "nearest_target_missed_point_test_%s", stepNames[step]);
+		pReport->AddValue(name, numPointMisses);
+	}
+	pReport->AddValue("max_target_impact_difference", (double)maxTargetDifference);
+
+	// The sphere and box sweeps against the first of 1000 points along the segment that is inside the old end of step tests
+	const int NUM_SAMPLES = 1000;
+	int numSweepErrors = 0;
+	for (int i = 0; i < numShots; i++)
+	{
+		vec3 start = vec3(random.GetRandomNumber(-300, 300, 2), random.GetRandomNumber(-300, 300, 2), random.GetRandomNumber(-300, 300, 2)) * 0.01f;
+		vec3 end = vec3(random.GetRandomNumber(-300, 300, 2), random.GetRandomNumber(-300, 300, 2), random.GetRandomNumber(-300, 300, 2)) * 0.01f;
+		float radius = random.GetRandomNumber(5, 50, 2) * 0.01f;
+
+		float sphereRadius = random.GetRandomNumber(20, 150, 2) * 0.01f;
+		float rotationDegrees = random.GetRandomNumber(0, 360, 2);
+		float rotation = rotationDegrees * 3.14159265f / 180.0f;
+		vec3 axes[3] = { vec3(cos(rotation), 0.0f, -sin(rotation)), vec3(0.0f, 1.0f, 0.0f), vec3(sin(rotation), 0.0f, cos(rotation)) };
+		vec3 halfLengths = vec3(random.GetRandomNumber(20, 150, 2), random.GetRandomNumber(20, 150, 2), random.GetRandomNumber(20, 150, 2)) * 0.01f;
+
+		int firstSphereSample = -1;
+		int firstBoxSample = -1;
+		for (int j = 0; j <= NUM_SAMPLES; j++)
+		{
+			vec3 point = start + (end - start) * ((float)j / NUM_SAMPLES);
+			if (firstSphereSample == -1 && length(point) < radius + sphereRadius)
+			{
+				firstSphereSample = j;
+			}
+			if (firstBoxSample == -1 && InsideGrownBox(point, radius, vec3(0.0f, 0.0f, 0.0f), axes, halfLengths))
+			{
+				firstBoxSample = j;
+			}
+		}
+
+		float sphereTime;
+		bool sphereHit = SweptCollision::SphereSphere(start, end, radius, vec3(0.0f, 0.0f, 0.0f), sphereRadius, &sphereTime);
+		if (firstSphereSample != -1 && (sphereHit == false || sphereTime > (float)firstSphereSample / NUM_SAMPLES + 0.0001f || sphereTime < (float)(firstSphereSample - 1) / NUM_SAMPLES - 0.0001f))
+		{
+			numSweepErrors++;
+		}
+
+		float boxTime;
+		bool boxHit = EntityStep::SweepCubeHitbox(start, end, radius, vec3(0.0f, 0.0f, 0.0f), rotationDegrees, halfLengths, &boxTime);
+		if (firstBoxSample != -1 && (boxHit == false || boxTime > (float)firstBoxSample / NUM_SAMPLES + 0.0001f || boxTime < (float)(firstBoxSample - 1) / NUM_SAMPLES - 0.0001f))
+		{
+			numSweepErrors++;
+		}
+	}
+	pReport->AddValue("sweep_errors", numSweepErrors);
+
+	pReport->AddCheck("swept_never_tunnels_through_wall", neverTunnels);
+	pReport->AddCheck("straight_impact_same_for_every_step", maxStraightDifference < 0.001f);
+	pReport->AddCheck("arc_impact_on_curve", arcsOnCurve);
+	pReport->AddCheck("nearest_target_hit_every_step", nearestTargetHit);
+	pReport->AddCheck("target_impact_same_for_every_step", maxTargetDifference < 0.001f);
+	pReport->AddCheck("sweeps_find_first_overlap", numSweepErrors == 0);
+}
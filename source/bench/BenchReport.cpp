@@ -0,0 +1,208 @@
+// ******************************************************************************
+// Filename:    BenchReport.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchReport.h"
+
+#include "../utils/TimeUtils.h"
+#include "../tinythread/tinythread.h"
+
+#include <math.h>
+
+
+BenchReport::BenchReport()
+{
+	m_pCurrentScenario = NULL;
+	m_scenarioStartTime = 0.0;
+
+	m_failedChecks = false;
+}
+
+BenchReport::~BenchReport()
+{
+	m_vScenarios.clear();
+}
+
+void BenchReport::BeginScenario(const char* name)
+{
+	BenchScenarioResult scenario;
+	scenario.m_name = name;
+	scenario.m_totalTime = 0.0;
+	m_vScenarios.push_back(scenario);
+
+	m_pCurrentScenario = &m_vScenarios.back();
+	m_scenarioStartTime = GetHighResolutionTime();
+}
+
+void BenchReport::EndScenario()
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	m_pCurrentScenario->m_totalTime = (GetHighResolutionTime() - m_scenarioStartTime) * 1000.0;
+	m_pCurrentScenario = NULL;
+}
+
+void BenchReport::AddTiming(const char* subsystem, double milliseconds)
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	for (unsigned int i = 0; i < m_pCurrentScenario->m_vTimings.size(); i++)
+	{
+		BenchValue* pTiming = &m_pCurrentScenario->m_vTimings[i];
+		if (pTiming->m_name == subsystem)
+		{
+			pTiming->m_value = FormatDouble(atof(pTiming->m_value.c_str()) + milliseconds);
+			return;
+		}
+	}
+
+	SetValue(&m_pCurrentScenario->m_vTimings, subsystem, FormatDouble(milliseconds));
+}
+
+void BenchReport::AddValue(const char* name, int value)
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	char lValue[32];
+	sprintf(lValue, "%i", value);
+	SetValue(&m_pCurrentScenario->m_vValues, name, lValue);
+}
+
+void BenchReport::AddValue(const char* name, double value)
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	SetValue(&m_pCurrentScenario->m_vValues, name, FormatDouble(value));
+}
+
+void BenchReport::AddValue(const char* name, bool value)
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	SetValue(&m_pCurrentScenario->m_vValues, name, value ? "true" : "false");
+}
+
+void BenchReport::AddValue(const char* name, const char* value)
+{
+	if (m_pCurrentScenario == NULL)
+	{
+		return;
+	}
+
+	SetValue(&m_pCurrentScenario->m_vValues, name, FormatString(value));
+}
+
+void BenchReport::AddCheck(const char* name, bool passed)
+{
+	if (passed == false)
+	{
+		m_failedChecks = true;
+	}
+
+	AddValue(name, passed);
+}
+
+bool BenchReport::HasFailedChecks()
+{
+	return m_failedChecks;
+}
+
+void BenchReport::WriteJSON(FILE* pFile)
+{
+	fprintf(pFile, "{\n");
+	fprintf(pFile, "  \"hardware_threads\": %i,\n", (int)tthread::thread::hardware_concurrency());
+	fprintf(pFile, "  \"failed_checks\": %s,\n", m_failedChecks ? "true" : "false");
+	fprintf(pFile, "  \"scenarios\": [\n");
+	for (unsigned int i = 0; i < m_vScenarios.size(); i++)
+	{
+		BenchScenarioResult* pScenario = &m_vScenarios[i];
+
+		fprintf(pFile, "    {\n");
+		fprintf(pFile, "      \"name\": %s,\n", FormatString(pScenario->m_name.c_str()).c_str());
+		fprintf(pFile, "      \"total_ms\": %s,\n", FormatDouble(pScenario->m_totalTime).c_str());
+		WriteValues(pFile, "timings_ms", pScenario->m_vTimings);
+		fprintf(pFile, ",\n");
+		WriteValues(pFile, "values", pScenario->m_vValues);
+		fprintf(pFile, "\n    }%s\n", (i + 1 < m_vScenarios.size()) ? "," : "");
+	}
+	fprintf(pFile, "  ]\n");
+	fprintf(pFile, "}\n");
+}
+
+void BenchReport::SetValue(BenchValueList* pValues, const char* name, const string& value)
+{
+	for (unsigned int i = 0; i < pValues->size(); i++)
+	{
+		if ((*pValues)[i].m_name == name)
+		{
+			(*pValues)[i].m_value = value;
+			return;
+		}
+	}
+
+	BenchValue benchValue;
+	benchValue.m_name = name;
+	benchValue.m_value = value;
+	pValues->push_back(benchValue);
+}
+
+string BenchReport::FormatDouble(double value)
+{
+	// JSON has no infinity or NaN
+	if (value != value || fabs(value) > 1.0e300)
+	{
+		return "null";
+	}
+
+	char lValue[64];
+	sprintf(lValue, "%.4f", value);
+	return lValue;
+}
+
+string BenchReport::FormatString(const char* value)
+{
+	string formatted = "\"";
+	for (const char* pChar = value; *pChar != 0; pChar++)
+	{
+		if (*pChar == '"' || *pChar == '\\')
+		{
+			formatted += '\\';
+		}
+		formatted += *pChar;
+	}
+	formatted += "\"";
+
+	return formatted;
+}
+
+void BenchReport::WriteValues(FILE* pFile, const char* name, const BenchValueList& values)
+{
+	fprintf(pFile, "      \"%s\": {", name);
+	for (unsigned int i = 0; i < values.size(); i++)
+	{
+		fprintf(pFile, "%s\n        %s: %s", (i > 0) ? "," : "", FormatString(values[i].m_name.c_str()).c_str(), values[i].m_value.c_str());
+	}
+	fprintf(pFile, "%s}", values.empty() ? "" : "\n      ");
+}
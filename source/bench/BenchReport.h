@@ -0,0 +1,97 @@
+// ******************************************************************************
+// Filename:    BenchReport.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Collects the results of the benchmark scenarios, per subsystem timings in
+//   milliseconds and any other values (counts, rates, pass/fail checks), and
+//   writes them out as JSON.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+using namespace std;
+
+
+class BenchValue
+{
+public:
+	string m_name;
+
+	// Already formatted as a JSON value
+	string m_value;
+};
+
+typedef vector<BenchValue> BenchValueList;
+
+class BenchScenarioResult
+{
+public:
+	string m_name;
+	double m_totalTime;
+	BenchValueList m_vTimings;
+	BenchValueList m_vValues;
+};
+
+typedef vector<BenchScenarioResult> BenchScenarioResultList;
+
+
+class BenchReport
+{
+public:
+	/* Public methods */
+	BenchReport();
+	~BenchReport();
+
+	void BeginScenario(const char* name);
+	void EndScenario();
+
+	// Time spent in a subsystem during the current scenario, adding the same subsystem again adds to its time
+	void AddTiming(const char* subsystem, double milliseconds);
+
+	void AddValue(const char* name, int value);
+	void AddValue(const char* name, double value);
+	void AddValue(const char* name, bool value);
+	void AddValue(const char* name, const char* value);
+
+	// Any failed check makes vox_bench return an error code
+	void AddCheck(const char* name, bool passed);
+	bool HasFailedChecks();
+
+	void WriteJSON(FILE* pFile);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	static void SetValue(BenchValueList* pValues, const char* name, const string& value);
+	static string FormatDouble(double value);
+	static string FormatString(const char* value);
+	static void WriteValues(FILE* pFile, const char* name, const BenchValueList& values);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	BenchScenarioResultList m_vScenarios;
+
+	BenchScenarioResult* m_pCurrentScenario;
+	double m_scenarioStartTime;
+
+	bool m_failedChecks;
+};
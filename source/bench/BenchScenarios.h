@@ -0,0 +1,72 @@
+// ******************************************************************************
+// Filename:    BenchScenarios.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The scenarios that vox_bench can run. Each scenario drives one or more of
+//   the headless subsystems and adds its timings, counters and checks to the
+//   report. Quick runs use smaller worlds and fewer frames.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "BenchReport.h"
+
+#include "../utils/TimeUtils.h"
+
+typedef void(*BenchScenarioFunction)(BenchReport* pReport, bool quick);
+
+class BenchScenario
+{
+public:
+	const char* m_name;
+	const char* m_description;
+	BenchScenarioFunction m_function;
+};
+
+// Milliseconds since a GetHighResolutionTime() start time
+inline double GetElapsedMilliseconds(double startTime)
+{
+	return (GetHighResolutionTime() - startTime) * 1000.0;
+}
+
+// The world seed all the scenarios use, so that runs on different machines generate the same terrain
+static const unsigned int BENCH_WORLD_SEED = 1234;
+
+// World subsystems
+void BenchChunkGeneration(BenchReport* pReport, bool quick);
+void BenchChunkHashTable(BenchReport* pReport, bool quick);
+void BenchMeshing(BenchReport* pReport, bool quick);
+void BenchChunkLOD(BenchReport* pReport, bool quick);
+void BenchBlockEdits(BenchReport* pReport, bool quick);
+void BenchChunkStorage(BenchReport* pReport, bool quick);
+void BenchPendingEdits(BenchReport* pReport, bool quick);
+void BenchNoise(BenchReport* pReport, bool quick);
+void BenchRayCast(BenchReport* pReport, bool quick);
+void BenchRegionFiles(BenchReport* pReport, bool quick);
+
+// Entity and rendering subsystems
+void BenchSpatialGrid(BenchReport* pReport, bool quick);
+void BenchParticles(BenchReport* pReport, bool quick);
+void BenchInstanceBuffer(BenchReport* pReport, bool quick);
+void BenchParallelUpdate(BenchReport* pReport, bool quick);
+void BenchFixedTimestep(BenchReport* pReport, bool quick);
+void BenchVisibility(BenchReport* pReport, bool quick);
+void BenchLights(BenchReport* pReport, bool quick);
+void BenchPicking(BenchReport* pReport, bool quick);
+
+// Scripted gameplay
+void BenchWalk500Blocks(BenchReport* pReport, bool quick);
+void BenchExplode50Spheres(BenchReport* pReport, bool quick);
+void BenchSpawn200Enemies(BenchReport* pReport, bool quick);
+void BenchProjectiles(BenchReport* pReport, bool quick);
+
+// Engine tools
+void BenchProfiler(BenchReport* pReport, bool quick);
+void BenchJobPool(BenchReport* pReport, bool quick);
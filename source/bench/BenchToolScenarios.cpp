@@ -0,0 +1,261 @@
+// ******************************************************************************
+// Filename:    BenchToolScenarios.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The cost of the engine's own tools, the zone profiler and the job pool.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchScenarios.h"
+
+#include "../utils/Profiler.h"
+#include "../utils/JobPool.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <vector>
+using namespace std;
+
+
+// Profiler
+static int RunProfileZones(int numZones, int zonesPerFrame)
+{
+	// Nested zones, like the manager updates inside VoxGame::Update
+	int total = 0;
+	for (int i = 0; i < numZones; i += 2)
+	{
+		{
+			PROFILE_ZONE("BenchProfiler::Outer");
+			{
+				PROFILE_ZONE("BenchProfiler::Inner");
+				total += i;
+			}
+		}
+
+		if ((i + 2) % zonesPerFrame == 0)
+		{
+			Profiler::GetInstance()->EndFrame();
+		}
+	}
+
+	return total;
+}
+
+static void _ProfileZoneJob(void* pData)
+{
+	PROFILE_ZONE("BenchProfiler::Job");
+}
+
+static ProfileZoneStats* FindZoneStats(const char* pZoneName)
+{
+	ProfileZoneStatsList vpZoneStats;
+	Profiler::GetInstance()->GetSortedZoneStats(&vpZoneStats);
+	for (unsigned int i = 0; i < vpZoneStats.size(); i++)
+	{
+		if (vpZoneStats[i]->m_name == pZoneName)
+		{
+			return vpZoneStats[i];
+		}
+	}
+
+	return NULL;
+}
+
+void BenchProfiler(BenchReport* pReport, bool quick)
+{
+	int numZones = quick ? 200000 : 2000000;
+	int zonesPerFrame = 1000;
+	Profiler* pProfiler = Profiler::GetInstance();
+	bool wasEnabled = pProfiler->IsEnabled();
+	int numDroppedEvents = pProfiler->GetNumDroppedEvents();
+
+	// Disabled, which is what every zone in the game costs normally
+	pProfiler->SetEnabled(false);
+	double startTime = GetHighResolutionTime();
+	int disabledTotal = RunProfileZones(numZones, zonesPerFrame);
+	double disabledTime = GetElapsedMilliseconds(startTime);
+	pReport->AddTiming("disabled_zones", disabledTime);
+
+	// Enabled, including collecting the zones at the end of each frame
+	pProfiler->SetEnabled(true);
+	startTime = GetHighResolutionTime();
+	int enabledTotal = RunProfileZones(numZones, zonesPerFrame);
+	double enabledTime = GetElapsedMilliseconds(startTime);
+	pReport->AddTiming("enabled_zones", enabledTime);
+
+	ProfileZoneStats* pInnerStats = FindZoneStats("BenchProfiler::Inner");
+	int innerCalls = (pInnerStats != NULL) ? pInnerStats->m_lastFrameCalls : 0;
+
+	// Zones from the job pool workers are collected by the thread that calls EndFrame()
+	int numJobs = 500;
+	JobPool* pJobPool = new JobPool(0);
+	pProfiler->StartCapture();
+	for (int i = 0; i < numJobs; i++)
+	{
+		pJobPool->AddJob(_ProfileZoneJob, NULL, 0.0f);
+	}
+	pJobPool->WaitForAllJobs();
+	pProfiler->EndFrame();
+	pProfiler->StopCapture();
+	delete pJobPool;
+
+	ProfileZoneStats* pJobStats = FindZoneStats("BenchProfiler::Job");
+
+	pProfiler->SetEnabled(wasEnabled);
+
+	pReport->AddValue("num_zones", numZones);
+	pReport->AddValue("disabled_ns_per_zone", (disabledTime * 1000000.0) / numZones);
+	pReport->AddValue("enabled_ns_per_zone", (enabledTime * 1000000.0) / numZones);
+	pReport->AddCheck("same_work_enabled_and_disabled", disabledTotal == enabledTotal);
+	pReport->AddCheck("zones_collected_every_frame", innerCalls == zonesPerFrame / 2);
+	pReport->AddCheck("job_zones_collected", pJobStats != NULL && pJobStats->m_lastFrameCalls == numJobs);
+	pReport->AddCheck("job_zones_captured", pProfiler->GetNumCaptureEvents() == numJobs);
+	pReport->AddCheck("no_dropped_events", pProfiler->GetNumDroppedEvents() == numDroppedEvents);
+}
+
+
+// Job pool
+class BenchGateJob
+{
+public:
+	std::atomic<bool> m_started;
+	std::atomic<bool> m_released;
+};
+
+class BenchOrderJob
+{
+public:
+	int m_priority;
+	tthread::mutex* m_pOrderLock;
+	vector<int>* m_pvOrder;
+};
+
+static void _GateJob(void* pData)
+{
+	BenchGateJob* pGate = (BenchGateJob*)pData;
+
+	pGate->m_started = true;
+	while (pGate->m_released == false)
+	{
+		tthread::this_thread::yield();
+	}
+}
+
+static void _OrderJob(void* pData)
+{
+	BenchOrderJob* pJob = (BenchOrderJob*)pData;
+
+	pJob->m_pOrderLock->lock();
+	pJob->m_pvOrder->push_back(pJob->m_priority);
+	pJob->m_pOrderLock->unlock();
+}
+
+static void _CountJob(void* pData)
+{
+	std::atomic<int>* pCount = (std::atomic<int>*)pData;
+
+	pCount->fetch_add(1, std::memory_order_relaxed);
+}
+
+void BenchJobPool(BenchReport* pReport, bool quick)
+{
+	// Two workers held on gate jobs, while the jobs are dealt out round robin between their queues, evens to one and odds to the other
+	JobPool* pJobPool = new JobPool(2);
+	BenchGateJob gates[2];
+	for (int i = 0; i < 2; i++)
+	{
+		gates[i].m_started = false;
+		gates[i].m_released = false;
+		pJobPool->AddJob(_GateJob, &gates[i], 0.0f);
+	}
+	while (gates[0].m_started == false || gates[1].m_started == false)
+	{
+		tthread::this_thread::yield();
+	}
+
+	int numOrderJobs = 64;
+	tthread::mutex orderLock;
+	vector<int> vOrder;
+	vector<BenchOrderJob> vOrderJobs(numOrderJobs);
+	for (int i = 0; i < numOrderJobs; i++)
+	{
+		vOrderJobs[i].m_priority = i;
+		vOrderJobs[i].m_pOrderLock = &orderLock;
+		vOrderJobs[i].m_pvOrder = &vOrder;
+		pJobPool->AddJob(_OrderJob, &vOrderJobs[i], (float)i);
+	}
+	bool allPending = (pJobPool->GetNumPendingJobs() == numOrderJobs + 2);
+
+	// Just one worker free, it should run every job in priority order, taking from the other queue whenever its front is more urgent
+	gates[0].m_released = true;
+	while (true)
+	{
+		orderLock.lock();
+		int numRun = (int)vOrder.size();
+		orderLock.unlock();
+
+		if (numRun == numOrderJobs)
+		{
+			break;
+		}
+		tthread::this_thread::yield();
+	}
+	gates[1].m_released = true;
+	pJobPool->WaitForAllJobs();
+
+	bool priorityOrder = true;
+	for (int i = 0; i < numOrderJobs; i++)
+	{
+		if (vOrder[i] != i)
+		{
+			priorityOrder = false;
+		}
+	}
+	int numStolen = pJobPool->GetNumJobsStolen();
+	bool noneLeft = (pJobPool->GetNumPendingJobs() == 0);
+	delete pJobPool;
+
+	// Throughput of tiny jobs, which is mostly the cost of queueing, taking and counting them
+	int numJobs = quick ? 100000 : 1000000;
+	bool allCompleted = true;
+	int workerCounts[3] = { 1, 2, 4 };
+	for (int i = 0; i < 3; i++)
+	{
+		std::atomic<int> count(0);
+		pJobPool = new JobPool(workerCounts[i]);
+
+		double startTime = GetHighResolutionTime();
+		for (int j = 0; j < numJobs; j++)
+		{
+			pJobPool->AddJob(_CountJob, &count, (float)(j & 255));
+		}
+		pJobPool->WaitForAllJobs();
+		double elapsed = GetElapsedMilliseconds(startTime);
+
+		if (count != numJobs || pJobPool->GetNumJobsCompleted() != numJobs)
+		{
+			allCompleted = false;
+		}
+		delete pJobPool;
+
+		char name[64];
+		sprintf(name, "jobs_%i_workers", workerCounts[i]);
+		pReport->AddTiming(name, elapsed);
+		sprintf(name, "ns_per_job_%i_workers", workerCounts[i]);
+		pReport->AddValue(name, (elapsed * 1000000.0) / numJobs);
+	}
+
+	pReport->AddValue("num_jobs", numJobs);
+	pReport->AddValue("jobs_stolen", numStolen);
+	pReport->AddCheck("pending_counts_queued_jobs", allPending);
+	pReport->AddCheck("most_urgent_job_first_across_queues", priorityOrder);
+	pReport->AddCheck("urgent_jobs_stolen", numStolen >= numOrderJobs / 2);
+	pReport->AddCheck("nothing_pending_after_wait", noneLeft);
+	pReport->AddCheck("all_jobs_completed", allCompleted);
+}
@@ -0,0 +1,415 @@
+// ******************************************************************************
+// Filename:    BenchWorld.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchWorld.h"
+
+#include "../utils/JobPool.h"
+#include "../utils/RandomGenerator.h"
+
+#include <math.h>
+#include <string.h>
+
+// The grassland boundaries from the BiomeManager, upper boundary then the two colours
+static const float GRASSLAND_BOUNDARIES[4][7] =
+{
+	{ -0.50f, 0.50f, 0.50f, 0.50f, 0.35f, 0.40f, 0.37f },
+	{ 0.00f, 0.94f, 0.74f, 0.34f, 0.50f, 0.29f, 0.20f },
+	{ 0.50f, 0.00f, 0.56f, 0.26f, 0.75f, 0.90f, 0.00f },
+	{ 1.00f, 0.85f, 0.85f, 0.85f, 0.77f, 0.65f, 0.80f },
+};
+
+static const unsigned int TREE_TRUNK_COLOUR = 0xFF1E3C5A;
+static const int TREE_TRUNK_HEIGHT = 6;
+
+
+BenchWorld::BenchWorld(unsigned int worldSeed, bool useColumnCache)
+{
+	m_worldSeed = worldSeed;
+
+	m_pColumnCache = NULL;
+	if (useColumnCache)
+	{
+		m_pColumnCache = new ChunkColumnCache();
+	}
+
+	m_terrainGenerator.SetWorldSeed(m_worldSeed);
+	m_terrainGenerator.SetBiomeFunctions(_GetTerrainBiome, _GetTerrainTownMultiplier, _GetTerrainBlockColour, this);
+	m_terrainGenerator.SetColumnCache(m_pColumnCache);
+}
+
+BenchWorld::~BenchWorld()
+{
+	ClearChunks();
+
+	delete m_pColumnCache;
+}
+
+void BenchWorld::ClearChunks()
+{
+	for (unsigned int i = 0; i < m_vpChunkList.size(); i++)
+	{
+		BenchChunk* pChunk = m_vpChunkList[i];
+
+		m_chunkTable.Remove(pChunk->m_gridX, pChunk->m_gridY, pChunk->m_gridZ);
+		delete pChunk;
+	}
+	m_vpChunkList.clear();
+}
+
+// Generation
+BenchChunk* BenchWorld::CreateChunk(int gridX, int gridY, int gridZ)
+{
+	BenchChunk* pChunk = new BenchChunk();
+	pChunk->m_gridX = gridX;
+	pChunk->m_gridY = gridY;
+	pChunk->m_gridZ = gridZ;
+	pChunk->m_needsRebuild = true;
+	pChunk->m_numQuads = 0;
+
+	GenerateTerrain(pChunk);
+
+	return pChunk;
+}
+
+void BenchWorld::AddChunk(BenchChunk* pChunk)
+{
+	m_chunkTable.Insert(pChunk->m_gridX, pChunk->m_gridY, pChunk->m_gridZ, (Chunk*)pChunk);
+	m_vpChunkList.push_back(pChunk);
+}
+
+int BenchWorld::CreateChunks(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, JobPool* pJobPool)
+{
+	m_vGenerateJobs.clear();
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int z = minZ; z <= maxZ; z++)
+		{
+			for (int y = minY; y <= maxY; y++)
+			{
+				if (GetChunk(x, y, z) == NULL)
+				{
+					BenchGenerateJob job;
+					job.m_pWorld = this;
+					job.m_gridX = x;
+					job.m_gridY = y;
+					job.m_gridZ = z;
+					job.m_pChunk = NULL;
+					m_vGenerateJobs.push_back(job);
+				}
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < m_vGenerateJobs.size(); i++)
+	{
+		if (pJobPool != NULL)
+		{
+			pJobPool->AddJob(_GenerateChunkJob, &m_vGenerateJobs[i], 0.0f);
+		}
+		else
+		{
+			_GenerateChunkJob(&m_vGenerateJobs[i]);
+		}
+	}
+	if (pJobPool != NULL)
+	{
+		pJobPool->WaitForAllJobs();
+	}
+
+	// Adding to the world isn't thread safe, so it is done once all the chunks are generated
+	for (unsigned int i = 0; i < m_vGenerateJobs.size(); i++)
+	{
+		AddChunk(m_vGenerateJobs[i].m_pChunk);
+	}
+
+	return (int)m_vGenerateJobs.size();
+}
+
+void BenchWorld::_GenerateChunkJob(void* pData)
+{
+	BenchGenerateJob* pJob = (BenchGenerateJob*)pData;
+
+	pJob->m_pChunk = pJob->m_pWorld->CreateChunk(pJob->m_gridX, pJob->m_gridY, pJob->m_gridZ);
+}
+
+BenchChunk* BenchWorld::GetChunk(int gridX, int gridY, int gridZ)
+{
+	return (BenchChunk*)m_chunkTable.Find(gridX, gridY, gridZ);
+}
+
+int BenchWorld::GetNumChunks()
+{
+	return (int)m_vpChunkList.size();
+}
+
+BenchChunkList* BenchWorld::GetChunkList()
+{
+	return &m_vpChunkList;
+}
+
+// Blocks
+unsigned int BenchWorld::GetBlockColour(int x, int y, int z)
+{
+	int gridX = GetGridCoordinate(x);
+	int gridY = GetGridCoordinate(y);
+	int gridZ = GetGridCoordinate(z);
+
+	BenchChunk* pChunk = GetChunk(gridX, gridY, gridZ);
+	if (pChunk == NULL)
+	{
+		return 0;
+	}
+
+	int blockX = x - gridX*Chunk::CHUNK_SIZE;
+	int blockY = y - gridY*Chunk::CHUNK_SIZE;
+	int blockZ = z - gridZ*Chunk::CHUNK_SIZE;
+
+	return pChunk->m_colour[blockX + blockY*Chunk::CHUNK_SIZE + blockZ*Chunk::CHUNK_SIZE_SQUARED];
+}
+
+bool BenchWorld::GetBlockActive(int x, int y, int z)
+{
+	return GetBlockColour(x, y, z) != 0;
+}
+
+int BenchWorld::CarveSphere(vec3 center, float radius, vector<vec3>* pvRemovedPositions, vector<unsigned int>* pvRemovedColours)
+{
+	int numRemoved = 0;
+
+	int minX = (int)floor(center.x - radius);
+	int minY = (int)floor(center.y - radius);
+	int minZ = (int)floor(center.z - radius);
+	int maxX = (int)ceil(center.x + radius);
+	int maxY = (int)ceil(center.y + radius);
+	int maxZ = (int)ceil(center.z + radius);
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
+		{
+			for (int z = minZ; z <= maxZ; z++)
+			{
+				vec3 distance = vec3((float)x, (float)y, (float)z) - center;
+				if (dot(distance, distance) > radius*radius)
+				{
+					continue;
+				}
+
+				int gridX = GetGridCoordinate(x);
+				int gridY = GetGridCoordinate(y);
+				int gridZ = GetGridCoordinate(z);
+
+				BenchChunk* pChunk = GetChunk(gridX, gridY, gridZ);
+				if (pChunk == NULL)
+				{
+					continue;
+				}
+
+				int index = (x - gridX*Chunk::CHUNK_SIZE) + (y - gridY*Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE + (z - gridZ*Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE_SQUARED;
+				if (pChunk->m_colour[index] == 0)
+				{
+					continue;
+				}
+
+				if (pvRemovedPositions != NULL)
+				{
+					pvRemovedPositions->push_back(vec3((float)x, (float)y, (float)z));
+				}
+				if (pvRemovedColours != NULL)
+				{
+					pvRemovedColours->push_back(pChunk->m_colour[index]);
+				}
+
+				pChunk->m_colour[index] = 0;
+				pChunk->m_needsRebuild = true;
+				numRemoved++;
+
+				// Blocks on the chunk border change the neighbour's faces as well
+				int blockX = x - gridX*Chunk::CHUNK_SIZE;
+				int blockY = y - gridY*Chunk::CHUNK_SIZE;
+				int blockZ = z - gridZ*Chunk::CHUNK_SIZE;
+				BenchChunk* pNeighbours[6] =
+				{
+					(blockX == 0) ? GetChunk(gridX - 1, gridY, gridZ) : NULL,
+					(blockX == Chunk::CHUNK_SIZE - 1) ? GetChunk(gridX + 1, gridY, gridZ) : NULL,
+					(blockY == 0) ? GetChunk(gridX, gridY - 1, gridZ) : NULL,
+					(blockY == Chunk::CHUNK_SIZE - 1) ? GetChunk(gridX, gridY + 1, gridZ) : NULL,
+					(blockZ == 0) ? GetChunk(gridX, gridY, gridZ - 1) : NULL,
+					(blockZ == Chunk::CHUNK_SIZE - 1) ? GetChunk(gridX, gridY, gridZ + 1) : NULL,
+				};
+				for (int i = 0; i < 6; i++)
+				{
+					if (pNeighbours[i] != NULL)
+					{
+						pNeighbours[i]->m_needsRebuild = true;
+					}
+				}
+			}
+		}
+	}
+
+	return numRemoved;
+}
+
+int BenchWorld::GetGroundHeight(int x, int z)
+{
+	int gridX = GetGridCoordinate(x);
+	int gridZ = GetGridCoordinate(z);
+	int blockX = x - gridX*Chunk::CHUNK_SIZE;
+	int blockZ = z - gridZ*Chunk::CHUNK_SIZE;
+
+	for (int gridY = MAX_TERRAIN_GRID_Y; gridY >= 0; gridY--)
+	{
+		BenchChunk* pChunk = GetChunk(gridX, gridY, gridZ);
+		if (pChunk == NULL)
+		{
+			continue;
+		}
+
+		for (int y = Chunk::CHUNK_SIZE - 1; y >= 0; y--)
+		{
+			if (pChunk->m_colour[blockX + y*Chunk::CHUNK_SIZE + blockZ*Chunk::CHUNK_SIZE_SQUARED] != 0)
+			{
+				return gridY*Chunk::CHUNK_SIZE + y + 1;
+			}
+		}
+	}
+
+	return -1;
+}
+
+// Ray casts
+bool BenchWorld::RayCast(vec3 origin, vec3 direction, float maxDistance, VoxelRayHit* pHit)
+{
+	return VoxelRayCast::Cast(origin, direction, maxDistance, _GetRayChunk, _GetRayBlock, this, pHit);
+}
+
+void* BenchWorld::_GetRayChunk(void* pData, int gridX, int gridY, int gridZ)
+{
+	BenchWorld* pWorld = (BenchWorld*)pData;
+
+	return pWorld->GetChunk(gridX, gridY, gridZ);
+}
+
+bool BenchWorld::_GetRayBlock(void* pData, void* pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType)
+{
+	BenchChunk* pRayChunk = (BenchChunk*)pChunk;
+
+	// Bench chunks don't keep block types
+	*pBlockType = BlockType_Default;
+
+	return pRayChunk->m_colour[blockX + blockY*Chunk::CHUNK_SIZE + blockZ*Chunk::CHUNK_SIZE_SQUARED] != 0;
+}
+
+bool BenchWorld::GetBlockActiveFromPosition(vec3 position)
+{
+	return GetBlockActive(VoxelRayCast::GetBlockCoordinate(position.x), VoxelRayCast::GetBlockCoordinate(position.y), VoxelRayCast::GetBlockCoordinate(position.z));
+}
+
+// Meshing
+int BenchWorld::MeshChunk(BenchChunk* pChunk, ChunkMesher* pMesher, ChunkMeshQuadList* pQuads, bool faceMerging)
+{
+	pQuads->clear();
+
+	pMesher->SetupOccupancy(pChunk->m_colour);
+	pMesher->CreateQuads(faceMerging, pQuads);
+
+	pChunk->m_needsRebuild = false;
+	pChunk->m_numQuads = (int)pQuads->size();
+
+	return pChunk->m_numQuads;
+}
+
+unsigned long long BenchWorld::GetWorldHash()
+{
+	// Each chunk is hashed on its own and then combined with an add, so that the order doesn't matter
+	unsigned long long worldHash = 0;
+	for (unsigned int i = 0; i < m_vpChunkList.size(); i++)
+	{
+		BenchChunk* pChunk = m_vpChunkList[i];
+
+		unsigned long long chunkHash = RandomGenerator::HashSeed(m_worldSeed, pChunk->m_gridX, pChunk->m_gridY, pChunk->m_gridZ);
+		for (int j = 0; j < Chunk::CHUNK_SIZE_CUBED; j++)
+		{
+			chunkHash = (chunkHash ^ pChunk->m_colour[j]) * 0x100000001B3ULL;
+		}
+
+		worldHash += chunkHash;
+	}
+
+	return worldHash;
+}
+
+ChunkColumnCache* BenchWorld::GetColumnCache()
+{
+	return m_pColumnCache;
+}
+
+int BenchWorld::GetGridCoordinate(int blockPosition)
+{
+	if (blockPosition < 0)
+	{
+		return ((blockPosition + 1) / Chunk::CHUNK_SIZE) - 1;
+	}
+
+	return blockPosition / Chunk::CHUNK_SIZE;
+}
+
+void BenchWorld::GenerateTerrain(BenchChunk* pChunk)
+{
+	BlockType blockTypes[Chunk::CHUNK_SIZE_CUBED];
+	TerrainTreeList vTrees;
+	m_terrainGenerator.GenerateChunk(pChunk->m_gridX, pChunk->m_gridY, pChunk->m_gridZ, 0, pChunk->m_colour, blockTypes, &vTrees);
+
+	// The game imports a qubicle model for each tree, we just add a trunk that is clipped to this chunk
+	int chunkX = pChunk->m_gridX*Chunk::CHUNK_SIZE;
+	int chunkY = pChunk->m_gridY*Chunk::CHUNK_SIZE;
+	int chunkZ = pChunk->m_gridZ*Chunk::CHUNK_SIZE;
+	for (unsigned int i = 0; i < vTrees.size(); i++)
+	{
+		int x = (int)vTrees[i].m_position.x - chunkX;
+		int z = (int)vTrees[i].m_position.z - chunkZ;
+		int treeBase = (int)vTrees[i].m_position.y;
+		for (int y = treeBase; y < treeBase + TREE_TRUNK_HEIGHT; y++)
+		{
+			if (y >= chunkY && y < chunkY + Chunk::CHUNK_SIZE)
+			{
+				pChunk->m_colour[x + (y - chunkY)*Chunk::CHUNK_SIZE + z*Chunk::CHUNK_SIZE_SQUARED] = TREE_TRUNK_COLOUR;
+			}
+		}
+	}
+}
+
+// Terrain callbacks, there is no biome manager so every column is grassland without towns
+Biome BenchWorld::_GetTerrainBiome(void* pData, float xPosition, float zPosition)
+{
+	return Biome_GrassLand;
+}
+
+float BenchWorld::_GetTerrainTownMultiplier(void* pData, float xPosition, float zPosition)
+{
+	return 1.0f;
+}
+
+void BenchWorld::_GetTerrainBlockColour(void* pData, Biome biome, float noise, float colourNoise, float *r, float *g, float *b, BlockType *blockType)
+{
+	int boundary = 0;
+	while (boundary < 3 && noise > GRASSLAND_BOUNDARIES[boundary][0])
+	{
+		boundary++;
+	}
+	const float* pBoundary = GRASSLAND_BOUNDARIES[boundary];
+
+	*r = pBoundary[1] + ((pBoundary[4] - pBoundary[1]) * colourNoise);
+	*g = pBoundary[2] + ((pBoundary[5] - pBoundary[2]) * colourNoise);
+	*b = pBoundary[3] + ((pBoundary[6] - pBoundary[3]) * colourNoise);
+	*blockType = BlockType_Default;
+}
@@ -0,0 +1,150 @@
+// ******************************************************************************
+// Filename:    BenchWorld.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   A headless stand-in for the chunk manager, used by vox_bench. Chunks are
+//   plain colour arrays, generated by the same TerrainGenerator as the game's
+//   chunks, stored in a ChunkHashTable and meshed with the ChunkMesher. There
+//   is no renderer, no biome manager and no qubicle imports, so every column
+//   is grassland and trees are simple trunks.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../blocks/ChunkMesher.h"
+#include "../blocks/ChunkHashTable.h"
+#include "../blocks/ChunkColumnCache.h"
+#include "../blocks/TerrainGenerator.h"
+#include "../blocks/VoxelRayCast.h"
+
+#include <vector>
+using namespace std;
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+class JobPool;
+class BenchWorld;
+
+class BenchChunk
+{
+public:
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+
+	// Indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED], 0 is an empty block
+	unsigned int m_colour[Chunk::CHUNK_SIZE_CUBED];
+
+	bool m_needsRebuild;
+	int m_numQuads;
+};
+
+typedef vector<BenchChunk*> BenchChunkList;
+
+class BenchGenerateJob
+{
+public:
+	BenchWorld* m_pWorld;
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+	BenchChunk* m_pChunk;
+};
+
+typedef vector<BenchGenerateJob> BenchGenerateJobList;
+
+
+class BenchWorld
+{
+public:
+	/* Public methods */
+	BenchWorld(unsigned int worldSeed, bool useColumnCache);
+	~BenchWorld();
+
+	void ClearChunks();
+
+	// Generation, CreateChunk() is thread safe, adding the chunk to the world is not
+	BenchChunk* CreateChunk(int gridX, int gridY, int gridZ);
+	void AddChunk(BenchChunk* pChunk);
+
+	// Creates and adds all the missing chunks in the box of grid co-ordinates, INCLUSIVE. Returns how many were created.
+	// The chunks are generated on the job pool's workers, or on the calling thread when it is NULL
+	int CreateChunks(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, JobPool* pJobPool);
+	static void _GenerateChunkJob(void* pData);
+
+	BenchChunk* GetChunk(int gridX, int gridY, int gridZ);
+	int GetNumChunks();
+	BenchChunkList* GetChunkList();
+
+	// Blocks, in world co-ordinates
+	unsigned int GetBlockColour(int x, int y, int z);
+	bool GetBlockActive(int x, int y, int z);
+
+	// Removes the blocks inside the sphere and flags the chunks for rebuild, the removed block positions and colours are added to the lists
+	int CarveSphere(vec3 center, float radius, vector<vec3>* pvRemovedPositions, vector<unsigned int>* pvRemovedColours);
+
+	// The y position on top of the highest block in the column, or -1 if the column is empty
+	int GetGroundHeight(int x, int z);
+
+	// Ray casts, the same traversal as ChunkManager::RayCast(), the hit chunk is a BenchChunk*
+	bool RayCast(vec3 origin, vec3 direction, float maxDistance, VoxelRayHit* pHit);
+	static void* _GetRayChunk(void* pData, int gridX, int gridY, int gridZ);
+	static bool _GetRayBlock(void* pData, void* pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType);
+
+	// One probe of the old step marching, a chunk lookup for the block at a world position like ChunkManager::GetBlockActiveFrom3DPosition()
+	bool GetBlockActiveFromPosition(vec3 position);
+
+	// Meshing, returns the number of quads
+	int MeshChunk(BenchChunk* pChunk, ChunkMesher* pMesher, ChunkMeshQuadList* pQuads, bool faceMerging);
+
+	// Hash of every block in every chunk, independent of the order the chunks were created in
+	unsigned long long GetWorldHash();
+
+	ChunkColumnCache* GetColumnCache();
+
+	static int GetGridCoordinate(int blockPosition);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void GenerateTerrain(BenchChunk* pChunk);
+
+	static Biome _GetTerrainBiome(void* pData, float xPosition, float zPosition);
+	static float _GetTerrainTownMultiplier(void* pData, float xPosition, float zPosition);
+	static void _GetTerrainBlockColour(void* pData, Biome biome, float noise, float colourNoise, float *r, float *g, float *b, BlockType *blockType);
+
+public:
+	/* Public members */
+	// The landscape is at most CHUNK_SIZE times the mountain multiplier high, plus the trees
+	static const int MAX_TERRAIN_GRID_Y = 3;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	unsigned int m_worldSeed;
+
+	// NULL when the column cache is turned off
+	ChunkColumnCache* m_pColumnCache;
+
+	// The defaults are the VoxSettings defaults
+	TerrainGenerator m_terrainGenerator;
+
+	// The hash table only stores Chunk pointers, bench chunks are cast in and out
+	ChunkHashTable m_chunkTable;
+	BenchChunkList m_vpChunkList;
+
+	// Kept between calls, so that the job data doesn't move while the workers use it
+	BenchGenerateJobList m_vGenerateJobs;
+};
@@ -0,0 +1,1925 @@
+// ******************************************************************************
+// Filename:    BenchWorldScenarios.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Chunk generation, the chunk hash table, meshing, level of detail meshes,
+//   remeshing after block edits, chunk storage, the pending edits for unloaded
+//   chunks, noise, ray casts through the blocks and the region files.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchScenarios.h"
+#include "BenchWorld.h"
+#include "NullBackend.h"
+
+#include "../blocks/ChunkManager.h"
+#include "../blocks/ChunkPaletteStorage.h"
+#include "../blocks/ChunkStorageTable.h"
+#include "../blocks/RegionFile.h"
+#include "../utils/JobPool.h"
+#include "../utils/RandomGenerator.h"
+#include "../simplex/simplexnoise.h"
+#include "../tinythread/tinythread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+
+// Chunk generation
+void BenchChunkGeneration(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 4 : 8;
+
+	vector<int> vWorkerCounts;
+	vWorkerCounts.push_back(1);
+	vWorkerCounts.push_back(2);
+	vWorkerCounts.push_back(4);
+	if (JobPool::GetDefaultNumWorkers() > 4)
+	{
+		vWorkerCounts.push_back(JobPool::GetDefaultNumWorkers());
+	}
+
+	// The same area with more and more workers, the world must come out the same every time, whatever order the chunks finish in
+	unsigned long long firstHash = 0;
+	bool deterministic = true;
+	for (unsigned int i = 0; i < vWorkerCounts.size(); i++)
+	{
+		int numWorkers = vWorkerCounts[i];
+
+		BenchWorld world(BENCH_WORLD_SEED, true);
+
+		JobPool* pJobPool = new JobPool(numWorkers);
+		double startTime = GetHighResolutionTime();
+		int numChunks = world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, pJobPool);
+		double generationTime = GetElapsedMilliseconds(startTime);
+		delete pJobPool;
+
+		unsigned long long worldHash = world.GetWorldHash();
+		if (i == 0)
+		{
+			firstHash = worldHash;
+		}
+		else if (worldHash != firstHash)
+		{
+			deterministic = false;
+		}
+
+		char lName[64];
+		sprintf(lName, "generation_%i_workers", numWorkers);
+		pReport->AddTiming(lName, generationTime);
+		sprintf(lName, "chunks_per_second_%i_workers", numWorkers);
+		pReport->AddValue(lName, numChunks / (generationTime / 1000.0));
+
+		fprintf(stderr, "  %i workers: %.1f ms\n", numWorkers, generationTime);
+	}
+
+	char lHash[32];
+	sprintf(lHash, "%016llx", firstHash);
+	pReport->AddValue("num_chunks", (2*radius + 1) * (2*radius + 1) * (BenchWorld::MAX_TERRAIN_GRID_Y + 1));
+	pReport->AddValue("world_hash", lHash);
+	pReport->AddCheck("same_world_for_all_worker_counts", deterministic);
+
+	// With and without the column cache, on the calling thread
+	unsigned long long columnHashes[2] = { 0, 0 };
+	for (int useCache = 0; useCache < 2; useCache++)
+	{
+		BenchWorld world(BENCH_WORLD_SEED, useCache == 1);
+
+		double startTime = GetHighResolutionTime();
+		world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+		pReport->AddTiming((useCache == 1) ? "generation_column_cache" : "generation_no_column_cache", GetElapsedMilliseconds(startTime));
+
+		columnHashes[useCache] = world.GetWorldHash();
+
+		if (useCache == 1)
+		{
+			pReport->AddValue("column_cache_hits", world.GetColumnCache()->GetNumCacheHits());
+			pReport->AddValue("column_cache_misses", world.GetColumnCache()->GetNumCacheMisses());
+		}
+	}
+	pReport->AddCheck("column_cache_matches_uncached", columnHashes[0] == columnHashes[1] && columnHashes[0] == firstHash);
+}
+
+// Chunk hash table
+class BenchHashWriter
+{
+public:
+	ChunkHashTable* m_pTable;
+	std::atomic<bool> m_stop;
+	int m_numOperations;
+	int m_offsetX;
+};
+
+static void _HashWriterThread(void* pData)
+{
+	BenchHashWriter* pWriter = (BenchHashWriter*)pData;
+
+	// Keeps adding and removing chunks next to the area being read, like the chunk thread loading and unloading
+	int column = 0;
+	while (pWriter->m_stop.load() == false)
+	{
+		int x = pWriter->m_offsetX + (column % 64);
+		for (int y = 0; y < 4; y++)
+		{
+			for (int z = 0; z < 32; z++)
+			{
+				pWriter->m_pTable->Insert(x, y, z, (Chunk*)(size_t)(1 + x + y*1024 + z*1048576));
+				pWriter->m_numOperations++;
+			}
+		}
+		if (column >= 32)
+		{
+			int removeX = pWriter->m_offsetX + ((column - 32) % 64);
+			for (int y = 0; y < 4; y++)
+			{
+				for (int z = 0; z < 32; z++)
+				{
+					pWriter->m_pTable->Remove(removeX, y, z);
+					pWriter->m_numOperations++;
+				}
+			}
+		}
+		column++;
+	}
+}
+
+static Chunk* GetFakeChunk(int x, int y, int z)
+{
+	return (Chunk*)(size_t)(1 + (x + 64) + y*1024 + (z + 64)*1048576);
+}
+
+static bool RunHashLookups(ChunkHashTable* pTable, int numLookups, int size)
+{
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 1, 0));
+
+	// A quarter of the lookups are outside of the area and must miss
+	bool correct = true;
+	for (int i = 0; i < numLookups; i++)
+	{
+		int x = random.GetRandomNumber(-size, size + size/2);
+		int y = random.GetRandomNumber(0, 7);
+		int z = random.GetRandomNumber(-size, size);
+
+		Chunk* pChunk = pTable->Find(x, y, z);
+		Chunk* pExpected = (x <= size) ? GetFakeChunk(x, y, z) : NULL;
+		if (pChunk != pExpected)
+		{
+			correct = false;
+		}
+	}
+
+	return correct;
+}
+
+void BenchChunkHashTable(BenchReport* pReport, bool quick)
+{
+	int size = 32;
+	int numLookups = quick ? 2000000 : 10000000;
+
+	// The chunk pointers are never used, so fake ones that encode the grid position are enough
+	ChunkHashTable table;
+	double startTime = GetHighResolutionTime();
+	for (int x = -size; x <= size; x++)
+	{
+		for (int y = 0; y < 8; y++)
+		{
+			for (int z = -size; z <= size; z++)
+			{
+				table.Insert(x, y, z, GetFakeChunk(x, y, z));
+			}
+		}
+	}
+	pReport->AddTiming("insert", GetElapsedMilliseconds(startTime));
+	pReport->AddValue("num_chunks", table.GetNumChunks());
+
+	startTime = GetHighResolutionTime();
+	bool correct = RunHashLookups(&table, numLookups, size);
+	double lookupTime = GetElapsedMilliseconds(startTime);
+	pReport->AddTiming("lookup", lookupTime);
+	pReport->AddValue("lookups_per_second", numLookups / (lookupTime / 1000.0));
+	pReport->AddCheck("lookups_correct", correct);
+
+	// Again while another thread writes to the table
+	BenchHashWriter writer;
+	writer.m_pTable = &table;
+	writer.m_stop = false;
+	writer.m_numOperations = 0;
+	writer.m_offsetX = size*4;
+	tthread::thread writerThread(_HashWriterThread, &writer);
+
+	startTime = GetHighResolutionTime();
+	correct = RunHashLookups(&table, numLookups, size);
+	lookupTime = GetElapsedMilliseconds(startTime);
+
+	writer.m_stop = true;
+	writerThread.join();
+
+	pReport->AddTiming("lookup_with_writer", lookupTime);
+	pReport->AddValue("lookups_per_second_with_writer", numLookups / (lookupTime / 1000.0));
+	pReport->AddValue("writer_operations", writer.m_numOperations);
+	pReport->AddCheck("lookups_correct_with_writer", correct);
+}
+
+// Meshing
+// Splits the quads of a chunk mesh back into single block faces, so that meshes merged in different ways can be compared.
+// Each face is packed as the direction, the block and the colour.
+static void GetMeshBlockFaces(OpenGLTriangleMesh* pMesh, vector<unsigned long long>* pFaces)
+{
+	pFaces->clear();
+	if (pMesh == NULL)
+	{
+		return;
+	}
+
+	// Both of the chunk meshers add 4 vertices for every quad
+	for (unsigned int i = 0; i + 3 < pMesh->m_vertices.size(); i += 4)
+	{
+		const OpenGLMesh_Vertex* pVertices = &pMesh->m_vertices[i];
+
+		int normalAxis = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (pVertices[0].vertexNormals[axis] != 0.0f)
+			{
+				normalAxis = axis;
+			}
+		}
+		bool positive = pVertices[0].vertexNormals[normalAxis] > 0.0f;
+		int direction = normalAxis * 2 + (positive ? 1 : 0);
+
+		float minCorner[3];
+		float maxCorner[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minCorner[axis] = pVertices[0].vertexPosition[axis];
+			maxCorner[axis] = pVertices[0].vertexPosition[axis];
+			for (int j = 1; j < 4; j++)
+			{
+				if (pVertices[j].vertexPosition[axis] < minCorner[axis])
+				{
+					minCorner[axis] = pVertices[j].vertexPosition[axis];
+				}
+				if (pVertices[j].vertexPosition[axis] > maxCorner[axis])
+				{
+					maxCorner[axis] = pVertices[j].vertexPosition[axis];
+				}
+			}
+		}
+
+		// The blocks are centred on whole numbers, the face plane is half a block out from the block
+		int start[3];
+		int end[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (axis == normalAxis)
+			{
+				start[axis] = (int)floorf(minCorner[axis] + (positive ? -Chunk::BLOCK_RENDER_SIZE : Chunk::BLOCK_RENDER_SIZE) + 0.5f);
+				end[axis] = start[axis];
+			}
+			else
+			{
+				start[axis] = (int)floorf(minCorner[axis] + Chunk::BLOCK_RENDER_SIZE + 0.5f);
+				end[axis] = (int)floorf(maxCorner[axis] - Chunk::BLOCK_RENDER_SIZE + 0.5f);
+			}
+		}
+
+		unsigned long long red = (unsigned long long)(pVertices[0].vertexColour[0] * 255.0f + 0.5f);
+		unsigned long long green = (unsigned long long)(pVertices[0].vertexColour[1] * 255.0f + 0.5f);
+		unsigned long long blue = (unsigned long long)(pVertices[0].vertexColour[2] * 255.0f + 0.5f);
+		unsigned long long colour = red | (green << 8) | (blue << 16);
+
+		for (int x = start[0]; x <= end[0]; x++)
+		{
+			for (int y = start[1]; y <= end[1]; y++)
+			{
+				for (int z = start[2]; z <= end[2]; z++)
+				{
+					unsigned long long block = (unsigned long long)(x + y*Chunk::CHUNK_SIZE + z*Chunk::CHUNK_SIZE_SQUARED);
+					pFaces->push_back(((unsigned long long)direction << 56) | (block << 24) | colour);
+				}
+			}
+		}
+	}
+
+	sort(pFaces->begin(), pFaces->end());
+}
+
+void BenchMeshing(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 3 : 6;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+	BenchChunkList* pChunkList = world.GetChunkList();
+	int numChunks = (int)pChunkList->size();
+
+	ChunkMesher mesher;
+	ChunkMeshQuadList quads;
+
+	// Warm up first, otherwise whichever mode is timed first also pays for the chunks coming into the cache
+	for (int i = 0; i < numChunks; i++)
+	{
+		world.MeshChunk((*pChunkList)[i], &mesher, &quads, true);
+	}
+
+	// Greedy meshing against a quad per visible block face
+	for (int faceMerging = 1; faceMerging >= 0; faceMerging--)
+	{
+		int numQuads = 0;
+		double startTime = GetHighResolutionTime();
+		for (int i = 0; i < numChunks; i++)
+		{
+			numQuads += world.MeshChunk((*pChunkList)[i], &mesher, &quads, faceMerging == 1);
+		}
+		double meshTime = GetElapsedMilliseconds(startTime);
+
+		pReport->AddTiming((faceMerging == 1) ? "greedy_meshing" : "per_block_meshing", meshTime);
+		pReport->AddValue((faceMerging == 1) ? "greedy_quads" : "per_block_quads", numQuads);
+		pReport->AddValue((faceMerging == 1) ? "greedy_us_per_chunk" : "per_block_us_per_chunk", (meshTime * 1000.0) / numChunks);
+	}
+	pReport->AddValue("num_chunks", numChunks);
+
+	// The quad storage, a new list for every chunk against one list that is reused
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numChunks; i++)
+	{
+		ChunkMeshQuadList freshQuads;
+		world.MeshChunk((*pChunkList)[i], &mesher, &freshQuads, true);
+	}
+	pReport->AddTiming("greedy_meshing_fresh_quad_list", GetElapsedMilliseconds(startTime));
+
+	ChunkMeshQuadList reusedQuads;
+	int numGrowths = 0;
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numChunks; i++)
+	{
+		size_t capacity = reusedQuads.capacity();
+		world.MeshChunk((*pChunkList)[i], &mesher, &reusedQuads, true);
+		if (reusedQuads.capacity() != capacity)
+		{
+			numGrowths++;
+		}
+	}
+	pReport->AddTiming("greedy_meshing_reused_quad_list", GetElapsedMilliseconds(startTime));
+	pReport->AddValue("reused_quad_list_growths", numGrowths);
+
+	// The real chunks, rebuilt through Chunk::CreateMesh() with the per block mesher and with greedy meshing.
+	// The null renderer keeps the finished meshes, so the faces from both can be checked against each other.
+	// There are no neighbouring chunks here, so neither mesher adds faces on the chunk borders.
+	Renderer renderer(0, 0, 0, 0);
+	ChunkManager chunkManager(&renderer, NULL, NULL);
+
+	vector<Chunk*> vpChunks;
+	for (int i = 0; i < numChunks; i++)
+	{
+		BenchChunk* pBenchChunk = (*pChunkList)[i];
+		Chunk* pChunk = new Chunk(&renderer, &chunkManager, NULL);
+		for (int index = 0; index < Chunk::CHUNK_SIZE_CUBED; index++)
+		{
+			if (pBenchChunk->m_colour[index] != 0)
+			{
+				pChunk->SetColour(index % Chunk::CHUNK_SIZE, (index / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE, index / Chunk::CHUNK_SIZE_SQUARED, pBenchChunk->m_colour[index]);
+			}
+		}
+		vpChunks.push_back(pChunk);
+	}
+
+	vector<vector<unsigned long long> > vPerBlockFaces(numChunks);
+	vector<unsigned long long> greedyFaces;
+	for (int faceMerging = 1; faceMerging >= 0; faceMerging--)
+	{
+		chunkManager.SetFaceMerging(faceMerging == 1);
+
+		bool facesMatch = true;
+		for (int greedy = 0; greedy <= 1; greedy++)
+		{
+			chunkManager.SetGreedyMeshing(greedy == 1);
+
+			// A warm up pass, so that the timed pass reserves the same as a rebuild in the game
+			double buildTime = 0.0;
+			int numQuads = 0;
+			for (int pass = 0; pass < 2; pass++)
+			{
+				startTime = GetHighResolutionTime();
+				for (int i = 0; i < numChunks; i++)
+				{
+					vpChunks[i]->SetNeedsRebuild(true, false);
+					vpChunks[i]->RebuildMesh();
+					vpChunks[i]->CompleteMesh();
+
+					if (pass == 1)
+					{
+						numQuads += vpChunks[i]->GetNumMeshVertices() / 4;
+
+						if (greedy == 0)
+						{
+							GetMeshBlockFaces(NullBackend::GetLastFinishedMesh(), &vPerBlockFaces[i]);
+						}
+						else
+						{
+							GetMeshBlockFaces(NullBackend::GetLastFinishedMesh(), &greedyFaces);
+							if (greedyFaces != vPerBlockFaces[i])
+							{
+								facesMatch = false;
+							}
+						}
+					}
+				}
+				buildTime = GetElapsedMilliseconds(startTime);
+			}
+
+			string name = string("chunk_mesh_") + ((greedy == 1) ? "greedy" : "per_block") + ((faceMerging == 1) ? "" : "_unmerged");
+			pReport->AddTiming(name.c_str(), buildTime);
+			pReport->AddValue((name + "_us_per_chunk").c_str(), (buildTime * 1000.0) / numChunks);
+			pReport->AddValue((name + "_quads").c_str(), numQuads);
+		}
+
+		pReport->AddCheck((faceMerging == 1) ? "chunk_mesh_greedy_faces_match" : "chunk_mesh_greedy_faces_match_unmerged", facesMatch);
+	}
+
+	for (int i = 0; i < numChunks; i++)
+	{
+		delete vpChunks[i];
+	}
+}
+
+// Level of detail
+void BenchChunkLOD(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 3 : 6;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+	BenchChunkList* pChunkList = world.GetChunkList();
+	int numChunks = (int)pChunkList->size();
+
+	ChunkMesher mesher;
+	ChunkMeshQuadList quads;
+	static const char* LOD_NAMES[ChunkMesher::NUM_LOD_LEVELS] = { "lod_full", "lod_2x", "lod_4x", "lod_8x" };
+
+	// Every chunk at every level, the full detail mesh also gets the border walls so the levels compare like for like
+	int levelQuads[ChunkMesher::NUM_LOD_LEVELS];
+	for (int lodLevel = 0; lodLevel < ChunkMesher::NUM_LOD_LEVELS; lodLevel++)
+	{
+		levelQuads[lodLevel] = 0;
+		double startTime = GetHighResolutionTime();
+		for (int i = 0; i < numChunks; i++)
+		{
+			quads.clear();
+			mesher.SetupLODOccupancy((*pChunkList)[i]->m_colour, lodLevel);
+			mesher.CreateQuads(true, &quads);
+			levelQuads[lodLevel] += (int)quads.size();
+		}
+		double meshTime = GetElapsedMilliseconds(startTime);
+
+		char name[64];
+		pReport->AddTiming(LOD_NAMES[lodLevel], meshTime);
+		sprintf(name, "%s_vertices", LOD_NAMES[lodLevel]);
+		pReport->AddValue(name, levelQuads[lodLevel] * 4);
+		sprintf(name, "%s_triangles", LOD_NAMES[lodLevel]);
+		pReport->AddValue(name, levelQuads[lodLevel] * 2);
+		if (lodLevel > 0)
+		{
+			sprintf(name, "%s_triangle_reduction", LOD_NAMES[lodLevel]);
+			pReport->AddValue(name, (double)levelQuads[0] / (levelQuads[lodLevel] > 0 ? levelQuads[lodLevel] : 1));
+		}
+	}
+	pReport->AddValue("num_chunks", numChunks);
+
+	// The full detail mesh the game uses next to the player, without the border walls
+	int greedyQuads = 0;
+	for (int i = 0; i < numChunks; i++)
+	{
+		greedyQuads += world.MeshChunk((*pChunkList)[i], &mesher, &quads, true);
+	}
+	pReport->AddValue("greedy_triangles", greedyQuads * 2);
+
+	bool fewerQuads = true;
+	for (int lodLevel = 1; lodLevel < ChunkMesher::NUM_LOD_LEVELS; lodLevel++)
+	{
+		if (levelQuads[lodLevel] >= levelQuads[0])
+		{
+			fewerQuads = false;
+		}
+	}
+	pReport->AddCheck("lod_fewer_triangles", fewerQuads);
+
+	// Reducing to full detail changes nothing
+	bool fullDetailMatches = true;
+	unsigned int reducedColours[Chunk::CHUNK_SIZE_CUBED];
+	for (int i = 0; i < numChunks && fullDetailMatches; i++)
+	{
+		ChunkMesher::ReduceColours((*pChunkList)[i]->m_colour, 0, reducedColours);
+		fullDetailMatches = (memcmp(reducedColours, (*pChunkList)[i]->m_colour, sizeof(reducedColours)) == 0);
+	}
+	pReport->AddCheck("lod_full_detail_unchanged", fullDetailMatches);
+
+	// A solid chunk is a single box at every level
+	unsigned int solidColours[Chunk::CHUNK_SIZE_CUBED];
+	for (int i = 0; i < Chunk::CHUNK_SIZE_CUBED; i++)
+	{
+		solidColours[i] = 0xFF336699;
+	}
+	bool solidBox = true;
+	for (int lodLevel = 0; lodLevel < ChunkMesher::NUM_LOD_LEVELS; lodLevel++)
+	{
+		quads.clear();
+		mesher.SetupLODOccupancy(solidColours, lodLevel);
+		mesher.CreateQuads(true, &quads);
+		solidBox = solidBox && (quads.size() == ChunkMeshFace_NumFaces);
+	}
+	pReport->AddCheck("lod_solid_chunk_is_a_box", solidBox);
+
+	// A chunk just past a boundary keeps its level until it is past the hysteresis
+	float lodDistance = 32.0f;
+	float hysteresis = 8.0f;
+	bool hysteresisHolds = (ChunkMesher::SelectLODLevel(lodDistance + 4.0f, 0, lodDistance, hysteresis) == 0) &&
+		(ChunkMesher::SelectLODLevel(lodDistance + 12.0f, 0, lodDistance, hysteresis) == 1) &&
+		(ChunkMesher::SelectLODLevel(lodDistance - 4.0f, 1, lodDistance, hysteresis) == 1) &&
+		(ChunkMesher::SelectLODLevel(lodDistance - 12.0f, 1, lodDistance, hysteresis) == 0) &&
+		(ChunkMesher::SelectLODLevel(lodDistance * 100.0f, 0, lodDistance, hysteresis) == ChunkMesher::NUM_LOD_LEVELS - 1) &&
+		(ChunkMesher::SelectLODLevel(lodDistance * 100.0f, 0, 0.0f, hysteresis) == 0);
+	pReport->AddCheck("lod_selection_hysteresis", hysteresisHolds);
+}
+
+// Block edits
+static bool QuadsMatch(const ChunkMeshQuadList& quads1, const ChunkMeshQuadList& quads2)
+{
+	if (quads1.size() != quads2.size())
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < quads1.size(); i++)
+	{
+		const ChunkMeshQuad& quad1 = quads1[i];
+		const ChunkMeshQuad& quad2 = quads2[i];
+		if (quad1.m_x != quad2.m_x || quad1.m_y != quad2.m_y || quad1.m_z != quad2.m_z || quad1.m_width != quad2.m_width ||
+			quad1.m_height != quad2.m_height || quad1.m_face != quad2.m_face || quad1.m_colour != quad2.m_colour)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BenchBlockEdits(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 3 : 6;
+	int numEdits = quick ? 1000 : 4000;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+	BenchChunkList* pChunkList = world.GetChunkList();
+	int numChunks = (int)pChunkList->size();
+
+	// Every chunk keeps the quads of its first mesh, like the game does
+	ChunkMesher mesher;
+	map<BenchChunk*, ChunkMeshQuadCache*> quadCaches;
+	int cacheBytes = 0;
+	for (int i = 0; i < numChunks; i++)
+	{
+		BenchChunk* pChunk = (*pChunkList)[i];
+		ChunkMeshQuadCache* pCache = new ChunkMeshQuadCache();
+		mesher.SetupOccupancy(pChunk->m_colour);
+		mesher.CreateQuads(true, pCache);
+		quadCaches[pChunk] = pCache;
+		cacheBytes += pCache->GetMemoryBytes();
+	}
+
+	// Mining the top block of a column and building on top of one, one block at a time
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 7, 0));
+	int worldMin = -radius * Chunk::CHUNK_SIZE;
+	int worldMax = (radius + 1) * Chunk::CHUNK_SIZE - 1;
+	int worldHeight = (BenchWorld::MAX_TERRAIN_GRID_Y + 1) * Chunk::CHUNK_SIZE;
+
+	ChunkMeshQuadList quads;
+	double fullTime = 0.0;
+	double incrementalTime = 0.0;
+	int numFullRebuilds = 0;
+	int numIncrementalRebuilds = 0;
+	int numSlices = 0;
+	int numBorderEdits = 0;
+	int editsDone = 0;
+	for (int i = 0; i < numEdits; i++)
+	{
+		int x = random.GetRandomNumber(worldMin, worldMax);
+		int z = random.GetRandomNumber(worldMin, worldMax);
+		int groundHeight = world.GetGroundHeight(x, z);
+		bool mining = (i % 2) == 0;
+		int y = mining ? groundHeight - 1 : groundHeight;
+		if (y < 0 || y >= worldHeight)
+		{
+			continue;
+		}
+
+		int gridX = BenchWorld::GetGridCoordinate(x);
+		int gridY = BenchWorld::GetGridCoordinate(y);
+		int gridZ = BenchWorld::GetGridCoordinate(z);
+		BenchChunk* pChunk = world.GetChunk(gridX, gridY, gridZ);
+		if (pChunk == NULL)
+		{
+			continue;
+		}
+
+		int blockX = x - gridX*Chunk::CHUNK_SIZE;
+		int blockY = y - gridY*Chunk::CHUNK_SIZE;
+		int blockZ = z - gridZ*Chunk::CHUNK_SIZE;
+		pChunk->m_colour[blockX + blockY*Chunk::CHUNK_SIZE + blockZ*Chunk::CHUNK_SIZE_SQUARED] = mining ? 0 : (0xFF000000 | (unsigned int)random.GetRandomNumber(0, 0xFFFFFF));
+		editsDone++;
+
+		// The neighbours, in the same order as the faces, so that neighbour n shares our face n
+		BenchChunk* pNeighbours[ChunkMeshFace_NumFaces];
+		pNeighbours[ChunkMeshFace_Front] = world.GetChunk(gridX, gridY, gridZ + 1);
+		pNeighbours[ChunkMeshFace_Back] = world.GetChunk(gridX, gridY, gridZ - 1);
+		pNeighbours[ChunkMeshFace_Right] = world.GetChunk(gridX + 1, gridY, gridZ);
+		pNeighbours[ChunkMeshFace_Left] = world.GetChunk(gridX - 1, gridY, gridZ);
+		pNeighbours[ChunkMeshFace_Top] = world.GetChunk(gridX, gridY + 1, gridZ);
+		pNeighbours[ChunkMeshFace_Bottom] = world.GetChunk(gridX, gridY - 1, gridZ);
+
+		// Every edit remeshing the whole chunk and all of its neighbours
+		double startTime = GetHighResolutionTime();
+		world.MeshChunk(pChunk, &mesher, &quads, true);
+		numFullRebuilds++;
+		for (int face = 0; face < ChunkMeshFace_NumFaces; face++)
+		{
+			if (pNeighbours[face] != NULL)
+			{
+				world.MeshChunk(pNeighbours[face], &mesher, &quads, true);
+				numFullRebuilds++;
+			}
+		}
+		fullTime += GetElapsedMilliseconds(startTime);
+
+		// Only the slices around the edit, and the neighbours' shared border when the edit is on it
+		startTime = GetHighResolutionTime();
+		ChunkMeshRegion editedRegion;
+		editedRegion.AddBlock(blockX, blockY, blockZ);
+		mesher.SetupOccupancy(pChunk->m_colour);
+		numSlices += mesher.UpdateQuads(editedRegion, 0, quadCaches[pChunk]);
+		numIncrementalRebuilds++;
+
+		bool borderEdit = false;
+		for (int face = 0; face < ChunkMeshFace_NumFaces; face++)
+		{
+			int border = ChunkMesher::GetBorderSlice((ChunkMeshFace)face);
+			int blockSlice = (face == ChunkMeshFace_Right || face == ChunkMeshFace_Left) ? blockX : ((face == ChunkMeshFace_Top || face == ChunkMeshFace_Bottom) ? blockY : blockZ);
+			if (pNeighbours[face] != NULL && blockSlice == border)
+			{
+				ChunkMeshRegion noEdits;
+				mesher.SetupOccupancy(pNeighbours[face]->m_colour);
+				numSlices += mesher.UpdateQuads(noEdits, 1 << ChunkMesher::GetOppositeFace((ChunkMeshFace)face), quadCaches[pNeighbours[face]]);
+				numIncrementalRebuilds++;
+				borderEdit = true;
+			}
+		}
+		incrementalTime += GetElapsedMilliseconds(startTime);
+
+		if (borderEdit)
+		{
+			numBorderEdits++;
+		}
+	}
+
+	pReport->AddTiming("full_remesh", fullTime);
+	pReport->AddTiming("incremental_remesh", incrementalTime);
+	pReport->AddValue("num_chunks", numChunks);
+	pReport->AddValue("num_edits", editsDone);
+	pReport->AddValue("border_edits", numBorderEdits);
+	pReport->AddValue("full_chunk_rebuilds", numFullRebuilds);
+	pReport->AddValue("incremental_chunk_rebuilds", numIncrementalRebuilds);
+	pReport->AddValue("slices_per_rebuild", (double)numSlices / (numIncrementalRebuilds > 0 ? numIncrementalRebuilds : 1));
+	pReport->AddValue("full_edits_per_second", (fullTime > 0.0) ? (editsDone * 1000.0) / fullTime : 0.0);
+	pReport->AddValue("incremental_edits_per_second", (incrementalTime > 0.0) ? (editsDone * 1000.0) / incrementalTime : 0.0);
+	pReport->AddValue("speedup", (incrementalTime > 0.0) ? fullTime / incrementalTime : 0.0);
+	pReport->AddValue("quad_cache_bytes_per_chunk", cacheBytes / numChunks);
+
+	// The patched quads have to be exactly what meshing the chunk from scratch gives
+	bool quadsMatch = true;
+	for (int i = 0; i < numChunks; i++)
+	{
+		BenchChunk* pChunk = (*pChunkList)[i];
+		world.MeshChunk(pChunk, &mesher, &quads, true);
+		quadsMatch = quadsMatch && QuadsMatch(quads, quadCaches[pChunk]->m_vQuads);
+	}
+	pReport->AddCheck("incremental_matches_full_mesh", quadsMatch);
+	pReport->AddCheck("fewer_chunk_rebuilds", numIncrementalRebuilds < numFullRebuilds);
+	pReport->AddCheck("incremental_faster", incrementalTime < fullTime);
+
+	for (map<BenchChunk*, ChunkMeshQuadCache*>::iterator iter = quadCaches.begin(); iter != quadCaches.end(); ++iter)
+	{
+		delete iter->second;
+	}
+}
+
+// Chunk storage
+static BlockType GetBenchBlockType(unsigned int colour)
+{
+	// The bench world has no block colour matching, just tell empty and solid blocks apart
+	return (colour == 0) ? BlockType_Default : BlockType_Grass;
+}
+
+static bool StorageMatchesChunk(ChunkPaletteStorage* pStorage, BenchChunk* pChunk)
+{
+	unsigned int colours[Chunk::CHUNK_SIZE_CUBED];
+	BlockType blockTypes[Chunk::CHUNK_SIZE_CUBED];
+	pStorage->GetBlocks(colours, blockTypes);
+
+	for (int i = 0; i < Chunk::CHUNK_SIZE_CUBED; i++)
+	{
+		if (colours[i] != pChunk->m_colour[i] || blockTypes[i] != GetBenchBlockType(pChunk->m_colour[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Reads from several threads at once, the way the chunk workers, the parallel entity update and the ray casts all read blocks
+class BenchStorageReader
+{
+public:
+	vector<ChunkPaletteStorage*>* m_pvpStorages;
+	vector<int>* m_pvReadChunks;
+	vector<int>* m_pvReadIndices;
+	unsigned int m_sum;
+
+	// Storages that another thread keeps writing to, every colour it writes has the top 16 bits set to 0xFF00
+	vector<ChunkPaletteStorage*>* m_pvpChurnStorages;
+	bool m_churnReadsValid;
+};
+
+static void _StorageReaderThread(void* pData)
+{
+	BenchStorageReader* pReader = (BenchStorageReader*)pData;
+
+	unsigned int sum = 0;
+	bool churnReadsValid = true;
+	for (unsigned int i = 0; i < pReader->m_pvReadChunks->size(); i++)
+	{
+		ChunkPaletteStorage* pStorage = (*pReader->m_pvpStorages)[(*pReader->m_pvReadChunks)[i]];
+		int index = (*pReader->m_pvReadIndices)[i];
+		for (int j = 0; j < 64; j++)
+		{
+			sum += pStorage->GetColour(index + j);
+		}
+
+		if (pReader->m_pvpChurnStorages != NULL)
+		{
+			ChunkPaletteStorage* pChurnStorage = (*pReader->m_pvpChurnStorages)[i % pReader->m_pvpChurnStorages->size()];
+			if ((pChurnStorage->GetColour(index) & 0xFFFF0000) != 0xFF000000)
+			{
+				churnReadsValid = false;
+			}
+		}
+	}
+
+	pReader->m_sum = sum;
+	pReader->m_churnReadsValid = churnReadsValid;
+}
+
+class BenchStorageWriter
+{
+public:
+	vector<ChunkPaletteStorage*>* m_pvpStorages;
+	std::atomic<bool> m_stop;
+	int m_numWrites;
+};
+
+static void _StorageWriterThread(void* pData)
+{
+	BenchStorageWriter* pWriter = (BenchStorageWriter*)pData;
+
+	// Enough different colours to widen the indices all the way, with compacting in between so that the palettes get rebuilt and reused
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 15, 0));
+	int numWrites = 0;
+	while (pWriter->m_stop.load() == false)
+	{
+		ChunkPaletteStorage* pStorage = (*pWriter->m_pvpStorages)[numWrites % pWriter->m_pvpStorages->size()];
+		unsigned int colour = 0xFF000000 | (unsigned int)random.GetRandomNumber(0, 5000);
+		pStorage->SetBlock(random.GetRandomNumber(0, Chunk::CHUNK_SIZE_CUBED - 1), colour, BlockType_Default);
+
+		numWrites++;
+		if ((numWrites % 2000) == 0)
+		{
+			pStorage->Compact();
+		}
+		if ((numWrites % 10000) == 0)
+		{
+			pStorage->Fill(0xFF000000, BlockType_Default);
+		}
+	}
+
+	pWriter->m_numWrites = numWrites;
+}
+
+// Runs the readers on their own threads and returns the reads per second over all of them
+static double RunStorageReaders(int numThreads, BenchStorageReader* pReaderTemplate, bool* pSumsMatch, bool* pChurnReadsValid, unsigned int expectedSum)
+{
+	vector<BenchStorageReader> vReaders(numThreads, *pReaderTemplate);
+	vector<tthread::thread*> vpThreads;
+
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numThreads; i++)
+	{
+		vpThreads.push_back(new tthread::thread(_StorageReaderThread, &vReaders[i]));
+	}
+	for (int i = 0; i < numThreads; i++)
+	{
+		vpThreads[i]->join();
+		delete vpThreads[i];
+	}
+	double readTime = GetElapsedMilliseconds(startTime);
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		if (vReaders[i].m_sum != expectedSum)
+		{
+			*pSumsMatch = false;
+		}
+		if (vReaders[i].m_churnReadsValid == false)
+		{
+			*pChurnReadsValid = false;
+		}
+	}
+
+	double numReads = (double)numThreads * pReaderTemplate->m_pvReadChunks->size() * 64;
+	return numReads / (readTime / 1000.0);
+}
+
+void BenchChunkStorage(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 4 : 8;
+	int numReads = quick ? 2000000 : 20000000;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+	BenchChunkList* pChunkList = world.GetChunkList();
+	int numChunks = (int)pChunkList->size();
+
+	int numStartStorages = ChunkPaletteStorage::GetNumStorages();
+	long long startTotalBytes = ChunkPaletteStorage::GetTotalMemoryBytes();
+
+	// Written a block at a time, the same way Chunk::Setup generates into an empty chunk
+	vector<ChunkPaletteStorage*> vpStorages;
+	map<BenchChunk*, ChunkPaletteStorage*> storageMap;
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numChunks; i++)
+	{
+		BenchChunk* pChunk = (*pChunkList)[i];
+		ChunkPaletteStorage* pStorage = new ChunkPaletteStorage();
+		for (int index = 0; index < Chunk::CHUNK_SIZE_CUBED; index++)
+		{
+			pStorage->SetBlock(index, pChunk->m_colour[index], GetBenchBlockType(pChunk->m_colour[index]));
+		}
+
+		vpStorages.push_back(pStorage);
+		storageMap[pChunk] = pStorage;
+	}
+	pReport->AddTiming("block_writes", GetElapsedMilliseconds(startTime));
+
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numChunks; i++)
+	{
+		vpStorages[i]->Compact();
+	}
+	pReport->AddTiming("compact", GetElapsedMilliseconds(startTime));
+
+	// Memory, against the colour and block type arrays every chunk used to have
+	long long paletteBytes = 0;
+	int numUniform = 0;
+	int bitsCounts[ChunkPaletteStorage::MAX_BITS_PER_BLOCK + 1] = { 0 };
+	bool roundTrip = true;
+	for (int i = 0; i < numChunks; i++)
+	{
+		paletteBytes += vpStorages[i]->GetMemoryBytes();
+		bitsCounts[vpStorages[i]->GetBitsPerBlock()]++;
+		if (vpStorages[i]->IsUniform())
+		{
+			numUniform++;
+		}
+		if (StorageMatchesChunk(vpStorages[i], (*pChunkList)[i]) == false)
+		{
+			roundTrip = false;
+		}
+	}
+	long long arrayBytes = (long long)numChunks * Chunk::CHUNK_SIZE_CUBED * (sizeof(unsigned int) + sizeof(BlockType));
+
+	pReport->AddValue("num_chunks", numChunks);
+	pReport->AddValue("array_bytes_per_chunk", (double)arrayBytes / numChunks);
+	pReport->AddValue("palette_bytes_per_chunk", (double)paletteBytes / numChunks);
+	pReport->AddValue("memory_reduction", (double)arrayBytes / paletteBytes);
+	pReport->AddValue("uniform_chunks", numUniform);
+	for (int bits = 1; bits <= ChunkPaletteStorage::MAX_BITS_PER_BLOCK; bits *= 2)
+	{
+		char lName[64];
+		sprintf(lName, "chunks_%i_bits_per_block", bits);
+		pReport->AddValue(lName, bitsCounts[bits]);
+	}
+	pReport->AddCheck("round_trip_matches_arrays", roundTrip);
+	pReport->AddCheck("memory_counter_matches", ChunkPaletteStorage::GetTotalMemoryBytes() - startTotalBytes == paletteBytes);
+
+	// Random reads, against reading the arrays directly
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 5, 0));
+	vector<int> vReadChunks(numReads / 64);
+	vector<int> vReadIndices(numReads / 64);
+	for (unsigned int i = 0; i < vReadChunks.size(); i++)
+	{
+		vReadChunks[i] = random.GetRandomNumber(0, numChunks - 1);
+		vReadIndices[i] = random.GetRandomNumber(0, Chunk::CHUNK_SIZE_CUBED - 64);
+	}
+
+	unsigned int arraySum = 0;
+	startTime = GetHighResolutionTime();
+	for (unsigned int i = 0; i < vReadChunks.size(); i++)
+	{
+		const unsigned int* pColours = (*pChunkList)[vReadChunks[i]]->m_colour;
+		for (int j = 0; j < 64; j++)
+		{
+			arraySum += pColours[vReadIndices[i] + j];
+		}
+	}
+	double arrayReadTime = GetElapsedMilliseconds(startTime);
+
+	unsigned int paletteSum = 0;
+	startTime = GetHighResolutionTime();
+	for (unsigned int i = 0; i < vReadChunks.size(); i++)
+	{
+		ChunkPaletteStorage* pStorage = vpStorages[vReadChunks[i]];
+		for (int j = 0; j < 64; j++)
+		{
+			paletteSum += pStorage->GetColour(vReadIndices[i] + j);
+		}
+	}
+	double paletteReadTime = GetElapsedMilliseconds(startTime);
+
+	pReport->AddTiming("array_reads", arrayReadTime);
+	pReport->AddTiming("palette_reads", paletteReadTime);
+	pReport->AddValue("palette_ns_per_read", (paletteReadTime * 1000000.0) / (vReadChunks.size() * 64));
+	pReport->AddCheck("palette_reads_match_arrays", arraySum == paletteSum);
+
+	// The same reads from more threads, reads don't take a lock so they should scale up to the hardware threads
+	BenchStorageReader readerTemplate;
+	readerTemplate.m_pvpStorages = &vpStorages;
+	readerTemplate.m_pvReadChunks = &vReadChunks;
+	readerTemplate.m_pvReadIndices = &vReadIndices;
+	readerTemplate.m_sum = 0;
+	readerTemplate.m_pvpChurnStorages = NULL;
+	readerTemplate.m_churnReadsValid = true;
+
+	int numHardwareThreads = (int)tthread::thread::hardware_concurrency();
+	if (numHardwareThreads < 1)
+	{
+		numHardwareThreads = 1;
+	}
+
+	bool threadedSumsMatch = true;
+	bool churnReadsValid = true;
+	double singleThreadReadsPerSecond = 0.0;
+	bool readsScale = true;
+	for (int numThreads = 1; numThreads <= 4; numThreads *= 2)
+	{
+		double readsPerSecond = RunStorageReaders(numThreads, &readerTemplate, &threadedSumsMatch, &churnReadsValid, paletteSum);
+		if (numThreads == 1)
+		{
+			singleThreadReadsPerSecond = readsPerSecond;
+		}
+
+		char lName[64];
+		sprintf(lName, "reads_per_second_%i_threads", numThreads);
+		pReport->AddValue(lName, readsPerSecond);
+
+		// Allow for the machine being busy, a lock would serialise the threads and stay near the single thread rate
+		int expectedSpeedup = (numThreads < numHardwareThreads) ? numThreads : numHardwareThreads;
+		if (readsPerSecond < singleThreadReadsPerSecond * expectedSpeedup * 0.5)
+		{
+			readsScale = false;
+		}
+	}
+	pReport->AddCheck("threaded_reads_match_arrays", threadedSumsMatch);
+	pReport->AddCheck("reads_scale_with_threads", readsScale);
+
+	// And while another thread keeps changing the palettes of other chunks, so snapshots are published and freed under the readers
+	vector<ChunkPaletteStorage*> vpChurnStorages;
+	for (int i = 0; i < 4; i++)
+	{
+		ChunkPaletteStorage* pStorage = new ChunkPaletteStorage();
+		pStorage->Fill(0xFF000000, BlockType_Default);
+		vpChurnStorages.push_back(pStorage);
+	}
+	readerTemplate.m_pvpChurnStorages = &vpChurnStorages;
+
+	BenchStorageWriter writer;
+	writer.m_pvpStorages = &vpChurnStorages;
+	writer.m_stop = false;
+	writer.m_numWrites = 0;
+	tthread::thread writerThread(_StorageWriterThread, &writer);
+
+	int numReaderThreads = (numHardwareThreads < 4) ? 4 : numHardwareThreads;
+	double readsPerSecondWithWriter = RunStorageReaders(numReaderThreads, &readerTemplate, &threadedSumsMatch, &churnReadsValid, paletteSum);
+
+	writer.m_stop = true;
+	writerThread.join();
+
+	pReport->AddValue("reads_per_second_with_writer", readsPerSecondWithWriter);
+	pReport->AddValue("writer_block_writes", writer.m_numWrites);
+	pReport->AddCheck("reads_with_writer_match_arrays", threadedSumsMatch);
+	pReport->AddCheck("reads_during_palette_changes_valid", churnReadsValid);
+
+	for (unsigned int i = 0; i < vpChurnStorages.size(); i++)
+	{
+		delete vpChurnStorages[i];
+	}
+
+	// Carving holes adds the empty block back into the palettes of solid chunks
+	int worldBlocks = (radius*2 + 1) * Chunk::CHUNK_SIZE;
+	vector<vec3> vRemovedPositions;
+	int numBlocksRemoved = 0;
+	for (int i = 0; i < 50; i++)
+	{
+		int x = random.GetRandomNumber(-worldBlocks/2 + 8, worldBlocks/2 - 8);
+		int z = random.GetRandomNumber(-worldBlocks/2 + 8, worldBlocks/2 - 8);
+		vec3 center = vec3((float)x, (float)(world.GetGroundHeight(x, z) - 4), (float)z);
+		numBlocksRemoved += world.CarveSphere(center, 6.0f, &vRemovedPositions, NULL);
+	}
+
+	startTime = GetHighResolutionTime();
+	for (unsigned int i = 0; i < vRemovedPositions.size(); i++)
+	{
+		int x = (int)vRemovedPositions[i].x;
+		int y = (int)vRemovedPositions[i].y;
+		int z = (int)vRemovedPositions[i].z;
+		int gridX = BenchWorld::GetGridCoordinate(x);
+		int gridY = BenchWorld::GetGridCoordinate(y);
+		int gridZ = BenchWorld::GetGridCoordinate(z);
+
+		ChunkPaletteStorage* pStorage = storageMap[world.GetChunk(gridX, gridY, gridZ)];
+		int index = (x - gridX*Chunk::CHUNK_SIZE) + (y - gridY*Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE + (z - gridZ*Chunk::CHUNK_SIZE)*Chunk::CHUNK_SIZE_SQUARED;
+		pStorage->SetBlock(index, 0, BlockType_Default);
+	}
+	pReport->AddTiming("carve_writes", GetElapsedMilliseconds(startTime));
+
+	bool carvedMatch = true;
+	for (int i = 0; i < numChunks; i++)
+	{
+		if (StorageMatchesChunk(vpStorages[i], (*pChunkList)[i]) == false)
+		{
+			carvedMatch = false;
+		}
+	}
+	pReport->AddValue("blocks_carved", numBlocksRemoved);
+	pReport->AddCheck("carved_storage_matches_arrays", carvedMatch);
+
+	for (int i = 0; i < numChunks; i++)
+	{
+		delete vpStorages[i];
+	}
+	pReport->AddCheck("storages_released", ChunkPaletteStorage::GetNumStorages() == numStartStorages && ChunkPaletteStorage::GetTotalMemoryBytes() == startTotalBytes);
+}
+
+// Pending edits
+// The storage every unloaded chunk used to get, a block set flag and colour for every block, found with a linear search
+class BenchDenseStorage
+{
+public:
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+
+	bool m_blockSet[Chunk::CHUNK_SIZE_CUBED];
+	unsigned int m_colour[Chunk::CHUNK_SIZE_CUBED];
+};
+
+static int GetBenchGridCoordinate(int blockPosition)
+{
+	return (blockPosition >= 0) ? (blockPosition / Chunk::CHUNK_SIZE) : ((blockPosition + 1) / Chunk::CHUNK_SIZE - 1);
+}
+
+static bool BenchImportLowestSourceFirst(const ChunkStorageEditRequestList &lhs, const ChunkStorageEditRequestList &rhs)
+{
+	// An import can come out empty, all of its blocks in one import share the same source
+	unsigned long long lhsSource = lhs.empty() ? 0 : lhs.front().m_sourceKey;
+	unsigned long long rhsSource = rhs.empty() ? 0 : rhs.front().m_sourceKey;
+
+	return lhsSource < rhsSource;
+}
+
+static void ApplyBenchStorage(ChunkStorageLoader* pStorage, unsigned int* pColours)
+{
+	// The same order as Chunk::ApplyChunkStorage
+	stable_sort(pStorage->m_vEdits.begin(), pStorage->m_vEdits.end(), ChunkStorageEdit::LowestSourceFirst);
+
+	memset(pColours, 0, Chunk::CHUNK_SIZE_CUBED * sizeof(unsigned int));
+	for (unsigned int i = 0; i < pStorage->m_vEdits.size(); i++)
+	{
+		pColours[pStorage->m_vEdits[i].m_index] = pStorage->m_vEdits[i].m_colour;
+	}
+}
+
+void BenchPendingEdits(BenchReport* pReport, bool quick)
+{
+	int numImports = quick ? 500 : 1000;
+	int worldBlocks = 32 * Chunk::CHUNK_SIZE;
+
+	// Trees and scenery dropped all over an area where none of the chunks are loaded yet
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 6, 0));
+	vector<ChunkStorageEditRequestList> vImports(numImports);
+	int numBlocks = 0;
+	for (int i = 0; i < numImports; i++)
+	{
+		int startX = random.GetRandomNumber(-worldBlocks/2, worldBlocks/2);
+		int startY = random.GetRandomNumber(0, 48);
+		int startZ = random.GetRandomNumber(-worldBlocks/2, worldBlocks/2);
+		unsigned int colour = 0xFF000000 | (unsigned int)random.GetRandomNumber(0, 0xFFFFFF);
+		unsigned long long sourceKey = ChunkStorageTable::PackKey(GetBenchGridCoordinate(startX), GetBenchGridCoordinate(startY), GetBenchGridCoordinate(startZ));
+
+		// A 7x10x7 crown, about half full, going through the blocks a column at a time like the template import
+		for (int x = 0; x < 7; x++)
+		{
+			for (int z = 0; z < 7; z++)
+			{
+				for (int y = 0; y < 10; y++)
+				{
+					if (random.GetRandomNumber(0, 1) == 0)
+					{
+						continue;
+					}
+
+					ChunkStorageEditRequest request;
+					request.m_gridX = GetBenchGridCoordinate(startX + x);
+					request.m_gridY = GetBenchGridCoordinate(startY + y);
+					request.m_gridZ = GetBenchGridCoordinate(startZ + z);
+					request.m_blockX = (startX + x) - request.m_gridX*Chunk::CHUNK_SIZE;
+					request.m_blockY = (startY + y) - request.m_gridY*Chunk::CHUNK_SIZE;
+					request.m_blockZ = (startZ + z) - request.m_gridZ*Chunk::CHUNK_SIZE;
+					request.m_colour = colour;
+					request.m_sourceKey = sourceKey;
+
+					vImports[i].push_back(request);
+					numBlocks++;
+				}
+			}
+		}
+	}
+
+	// The dense storage has no sources and the last edit wins, so the imports are made in the order of their source, which is the order the chunks apply them in
+	stable_sort(vImports.begin(), vImports.end(), BenchImportLowestSourceFirst);
+
+	// Dense storages, a linear search for every block
+	vector<BenchDenseStorage*> vpDenseStorages;
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numImports; i++)
+	{
+		for (unsigned int j = 0; j < vImports[i].size(); j++)
+		{
+			const ChunkStorageEditRequest& request = vImports[i][j];
+
+			BenchDenseStorage* pStorage = NULL;
+			for (unsigned int k = 0; k < vpDenseStorages.size() && pStorage == NULL; k++)
+			{
+				if (vpDenseStorages[k]->m_gridX == request.m_gridX && vpDenseStorages[k]->m_gridY == request.m_gridY && vpDenseStorages[k]->m_gridZ == request.m_gridZ)
+				{
+					pStorage = vpDenseStorages[k];
+				}
+			}
+			if (pStorage == NULL)
+			{
+				pStorage = new BenchDenseStorage();
+				pStorage->m_gridX = request.m_gridX;
+				pStorage->m_gridY = request.m_gridY;
+				pStorage->m_gridZ = request.m_gridZ;
+				memset(pStorage->m_blockSet, 0, sizeof(pStorage->m_blockSet));
+				memset(pStorage->m_colour, 0, sizeof(pStorage->m_colour));
+				vpDenseStorages.push_back(pStorage);
+			}
+
+			int index = request.m_blockX + request.m_blockY*Chunk::CHUNK_SIZE + request.m_blockZ*Chunk::CHUNK_SIZE_SQUARED;
+			pStorage->m_blockSet[index] = true;
+			pStorage->m_colour[index] = request.m_colour;
+		}
+	}
+	double denseTime = GetElapsedMilliseconds(startTime);
+
+	// The storage table, each import added in one go
+	ChunkStorageTable table;
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numImports; i++)
+	{
+		table.AddEdits(vImports[i]);
+	}
+	double tableTime = GetElapsedMilliseconds(startTime);
+
+	long long denseBytes = (long long)vpDenseStorages.size() * sizeof(BenchDenseStorage);
+
+	pReport->AddTiming("dense_linear_search_edits", denseTime);
+	pReport->AddTiming("table_edits", tableTime);
+	pReport->AddValue("num_imports", numImports);
+	pReport->AddValue("num_blocks", numBlocks);
+	pReport->AddValue("num_storages", table.GetNumStorages());
+	pReport->AddValue("num_stored_edits", table.GetNumEdits());
+	pReport->AddValue("dense_bytes_per_storage", (double)denseBytes / vpDenseStorages.size());
+	pReport->AddValue("table_bytes_per_storage", (double)table.GetMemoryBytes() / table.GetNumStorages());
+	pReport->AddValue("memory_reduction", (double)denseBytes / table.GetMemoryBytes());
+	pReport->AddCheck("same_storages", table.GetNumStorages() == (int)vpDenseStorages.size());
+
+	// Every chunk takes its storage and applies it, the result must be the same as the dense storage
+	bool sameBlocks = true;
+	int numApplied = 0;
+	unsigned int colours[Chunk::CHUNK_SIZE_CUBED];
+	startTime = GetHighResolutionTime();
+	for (unsigned int i = 0; i < vpDenseStorages.size(); i++)
+	{
+		BenchDenseStorage* pDenseStorage = vpDenseStorages[i];
+		ChunkStorageLoader* pStorage = table.TakeStorage(pDenseStorage->m_gridX, pDenseStorage->m_gridY, pDenseStorage->m_gridZ);
+		if (pStorage == NULL)
+		{
+			sameBlocks = false;
+			continue;
+		}
+
+		ApplyBenchStorage(pStorage, colours);
+		numApplied += (int)pStorage->m_vEdits.size();
+
+		if (memcmp(colours, pDenseStorage->m_colour, sizeof(colours)) != 0)
+		{
+			sameBlocks = false;
+		}
+
+		delete pStorage;
+	}
+	double applyTime = GetElapsedMilliseconds(startTime);
+	table.AddApplied(numApplied, applyTime / 1000.0);
+
+	pReport->AddTiming("take_and_apply", applyTime);
+	pReport->AddCheck("applied_blocks_match_dense", sameBlocks);
+	pReport->AddCheck("table_empty_after_taking", table.GetNumStorages() == 0 && table.GetNumEdits() == 0 && table.GetMemoryBytes() == 0);
+	pReport->AddCheck("applied_counter", table.GetNumEditsApplied() == numApplied);
+
+	// The chunks can be generated in any order, the chunks the other way round must give the same blocks. A chunk's
+	// own trees are always imported in the same order, so only the order of the sources changes.
+	ChunkStorageTable reverseTable;
+	int sourceEnd = numImports;
+	while (sourceEnd > 0)
+	{
+		int sourceStart = sourceEnd - 1;
+		while (sourceStart > 0 && BenchImportLowestSourceFirst(vImports[sourceStart - 1], vImports[sourceEnd - 1]) == false)
+		{
+			sourceStart--;
+		}
+		for (int i = sourceStart; i < sourceEnd; i++)
+		{
+			reverseTable.AddEdits(vImports[i]);
+		}
+		sourceEnd = sourceStart;
+	}
+	bool sameReverseBlocks = true;
+	for (unsigned int i = 0; i < vpDenseStorages.size(); i++)
+	{
+		BenchDenseStorage* pDenseStorage = vpDenseStorages[i];
+		ChunkStorageLoader* pStorage = reverseTable.TakeStorage(pDenseStorage->m_gridX, pDenseStorage->m_gridY, pDenseStorage->m_gridZ);
+		if (pStorage == NULL)
+		{
+			sameReverseBlocks = false;
+			continue;
+		}
+
+		ApplyBenchStorage(pStorage, colours);
+		if (memcmp(colours, pDenseStorage->m_colour, sizeof(colours)) != 0)
+		{
+			sameReverseBlocks = false;
+		}
+
+		delete pStorage;
+	}
+	pReport->AddCheck("reverse_order_blocks_match", sameReverseBlocks);
+
+	for (unsigned int i = 0; i < vpDenseStorages.size(); i++)
+	{
+		delete vpDenseStorages[i];
+	}
+}
+
+// Noise
+static const char* GetNoiseBatchModeName(NoiseBatchMode mode)
+{
+	switch (mode)
+	{
+		case NoiseBatchMode_Scalar: { return "scalar"; }
+		case NoiseBatchMode_SSE2: { return "sse2"; }
+		case NoiseBatchMode_AVX2: { return "avx2"; }
+	}
+
+	return "unknown";
+}
+
+void BenchNoise(BenchReport* pReport, bool quick)
+{
+	int size = quick ? 64 : 128;
+	int numSamples = size * size * size;
+
+	vector<float> vX(numSamples);
+	vector<float> vY(numSamples);
+	vector<float> vZ(numSamples);
+	for (int i = 0; i < numSamples; i++)
+	{
+		vX[i] = (float)(i % size);
+		vY[i] = (float)((i / size) % size);
+		vZ[i] = (float)(i / (size * size));
+	}
+
+	// The per point noise, as the terrain generation used to call it
+	vector<float> vScalar(numSamples);
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numSamples; i++)
+	{
+		vScalar[i] = octave_noise_3d(4.0f, 0.3f, 0.005f, vX[i], vY[i], vZ[i]);
+	}
+	double scalarTime = GetElapsedMilliseconds(startTime);
+	pReport->AddTiming("octave_noise_3d", scalarTime);
+	pReport->AddValue("num_samples", numSamples);
+	pReport->AddValue("samples_per_second_octave_noise_3d", numSamples / (scalarTime / 1000.0));
+
+	NoiseBatchMode bestMode = get_best_noise_batch_mode();
+	pReport->AddValue("best_batch_mode", GetNoiseBatchModeName(bestMode));
+
+	vector<float> vBatch(numSamples);
+	bool batchMatches = true;
+	for (int mode = NoiseBatchMode_Scalar; mode <= bestMode; mode++)
+	{
+		set_noise_batch_mode((NoiseBatchMode)mode);
+
+		char lName[64];
+		startTime = GetHighResolutionTime();
+		octave_noise_3d_batch(4.0f, 0.3f, 0.005f, &vX[0], &vY[0], &vZ[0], numSamples, &vBatch[0]);
+		double batchTime = GetElapsedMilliseconds(startTime);
+		sprintf(lName, "batch_%s", GetNoiseBatchModeName((NoiseBatchMode)mode));
+		pReport->AddTiming(lName, batchTime);
+		sprintf(lName, "samples_per_second_batch_%s", GetNoiseBatchModeName((NoiseBatchMode)mode));
+		pReport->AddValue(lName, numSamples / (batchTime / 1000.0));
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			if (fabs(vBatch[i] - vScalar[i]) > 1.0e-4f)
+			{
+				batchMatches = false;
+			}
+		}
+
+		startTime = GetHighResolutionTime();
+		octave_noise_3d_grid(4.0f, 0.3f, 0.005f, 0.0f, 0.0f, 0.0f, size, size, size, &vBatch[0]);
+		double gridTime = GetElapsedMilliseconds(startTime);
+		sprintf(lName, "grid_%s", GetNoiseBatchModeName((NoiseBatchMode)mode));
+		pReport->AddTiming(lName, gridTime);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			if (fabs(vBatch[i] - vScalar[i]) > 1.0e-4f)
+			{
+				batchMatches = false;
+			}
+		}
+	}
+	set_noise_batch_mode(bestMode);
+
+	pReport->AddCheck("batch_matches_octave_noise_3d", batchMatches);
+}
+
+
+// Ray casts
+class BenchRayBlock
+{
+public:
+	int m_x;
+	int m_y;
+	int m_z;
+};
+
+// Records every block that a ray visits in world block co-ordinates, missing chunks are an empty chunk so that their blocks are recorded too
+class BenchRayRecorder
+{
+public:
+	BenchWorld* m_pWorld;
+	BenchChunk m_emptyChunk;
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+	vector<BenchRayBlock> m_vBlocks;
+};
+
+static void* _GetRecordedRayChunk(void* pData, int gridX, int gridY, int gridZ)
+{
+	BenchRayRecorder* pRecorder = (BenchRayRecorder*)pData;
+	pRecorder->m_gridX = gridX;
+	pRecorder->m_gridY = gridY;
+	pRecorder->m_gridZ = gridZ;
+
+	BenchChunk* pChunk = pRecorder->m_pWorld->GetChunk(gridX, gridY, gridZ);
+
+	return (pChunk != NULL) ? pChunk : &pRecorder->m_emptyChunk;
+}
+
+static bool _GetRecordedRayBlock(void* pData, void* pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType)
+{
+	BenchRayRecorder* pRecorder = (BenchRayRecorder*)pData;
+
+	BenchRayBlock block;
+	block.m_x = pRecorder->m_gridX*Chunk::CHUNK_SIZE + blockX;
+	block.m_y = pRecorder->m_gridY*Chunk::CHUNK_SIZE + blockY;
+	block.m_z = pRecorder->m_gridZ*Chunk::CHUNK_SIZE + blockZ;
+	pRecorder->m_vBlocks.push_back(block);
+
+	return BenchWorld::_GetRayBlock(pRecorder->m_pWorld, pChunk, blockX, blockY, blockZ, pBlockType);
+}
+
+// The old fixed step march, the first probe inside a block
+static bool StepMarch(BenchWorld* pWorld, vec3 origin, vec3 direction, float stepSize, int numSteps, float* pDistance, int* pNumProbes)
+{
+	for (int i = 0; i < numSteps; i++)
+	{
+		(*pNumProbes)++;
+		if (pWorld->GetBlockActiveFromPosition(origin + direction * (stepSize * i)))
+		{
+			*pDistance = stepSize * i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// The old camera clipping, moving the camera in towards the player until none of the four probes around it are in a block
+static vec3 StepMarchCameraClipping(BenchWorld* pWorld, vec3 playerHead, vec3 camera, vec3 probeOffsets[4], int* pNumProbes)
+{
+	vec3 cameraPosition = camera;
+	vec3 toPlayer = playerHead - camera;
+	vec3 cameraFacing = normalize(toPlayer);
+	float incrementAmount = length(toPlayer) / 100;
+
+	bool collides = true;
+	for (int i = 0; i < 100 && collides; i++)
+	{
+		collides = false;
+		for (int j = 0; j < 4; j++)
+		{
+			(*pNumProbes)++;
+			if (pWorld->GetBlockActiveFromPosition(cameraPosition + probeOffsets[j]))
+			{
+				collides = true;
+			}
+		}
+
+		if (collides)
+		{
+			cameraPosition += cameraFacing * incrementAmount;
+		}
+	}
+
+	return cameraPosition;
+}
+
+// The same as VoxGame::UpdateCameraClipping()
+static vec3 RayCastCameraClipping(BenchWorld* pWorld, vec3 playerHead, vec3 camera, vec3 probeOffsets[4], int* pNumBlocksVisited)
+{
+	vec3 toCamera = camera - playerHead;
+	float cameraDistance = length(toCamera);
+	vec3 toCameraUnit = toCamera / cameraDistance;
+
+	float clippedDistance = cameraDistance;
+	for (int i = 0; i < 4; i++)
+	{
+		VoxelRayHit hit;
+		bool collides = pWorld->RayCast(playerHead + probeOffsets[i], toCameraUnit, clippedDistance, &hit);
+		(*pNumBlocksVisited) += hit.m_numBlocksVisited;
+		if (collides && hit.m_distance > 0.0f)
+		{
+			clippedDistance = hit.m_distance;
+		}
+	}
+
+	return playerHead + toCameraUnit * clippedDistance;
+}
+
+// Whether there is a block between the player and the camera, for the probes that don't start inside a block
+static bool CameraBlocked(BenchWorld* pWorld, vec3 playerHead, vec3 camera, vec3 probeOffsets[4])
+{
+	vec3 toCamera = camera - playerHead;
+	float cameraDistance = length(toCamera);
+	if (cameraDistance < 0.01f)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		vec3 probeStart = playerHead + probeOffsets[i];
+		if (pWorld->GetBlockActiveFromPosition(probeStart))
+		{
+			continue;
+		}
+
+		float distance;
+		int numProbes = 0;
+		if (StepMarch(pWorld, probeStart, toCamera / cameraDistance, 0.01f, (int)((cameraDistance - 0.01f) / 0.01f), &distance, &numProbes))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void BenchRayCast(BenchReport* pReport, bool quick)
+{
+	int radius = quick ? 3 : 6;
+	int numQueries = quick ? 2000 : 10000;
+
+	BenchWorld world(BENCH_WORLD_SEED, true);
+	world.CreateChunks(-radius, 0, -radius, radius, BenchWorld::MAX_TERRAIN_GRID_Y, radius, NULL);
+
+	RandomGenerator random(RandomGenerator::HashSeed(BENCH_WORLD_SEED, 0, 13, 0));
+	int worldMin = -radius * Chunk::CHUNK_SIZE + 8;
+	int worldMax = (radius + 1) * Chunk::CHUNK_SIZE - 9;
+
+	// Players standing on the terrain, looking around
+	vector<vec3> vHeads(numQueries);
+	vector<vec3> vDirections(numQueries);
+	vector<int> vGroundHeights(numQueries);
+	for (int i = 0; i < numQueries; i++)
+	{
+		int x = random.GetRandomNumber(worldMin, worldMax);
+		int z = random.GetRandomNumber(worldMin, worldMax);
+		vGroundHeights[i] = world.GetGroundHeight(x, z);
+		vHeads[i] = vec3(x + random.GetRandomNumber(-40, 40, 2) * 0.01f, vGroundHeights[i] + 1.525f, z + random.GetRandomNumber(-40, 40, 2) * 0.01f);
+
+		vec3 direction = vec3(random.GetRandomNumber(-100, 100, 2), random.GetRandomNumber(-100, 30, 2), random.GetRandomNumber(-100, 100, 2));
+		vDirections[i] = (length(direction) > 0.01f) ? normalize(direction) : vec3(0.0f, -1.0f, 0.0f);
+	}
+
+	// FindClosestFloor(), half block steps down against one ray straight down, from up to 20 blocks above the ground
+	vector<vec3> vFloorStarts(numQueries);
+	for (int i = 0; i < numQueries; i++)
+	{
+		vFloorStarts[i] = vHeads[i] + vec3(0.0f, (float)random.GetRandomNumber(0, 20), 0.0f);
+	}
+
+	int numMarchProbes = 0;
+	vector<float> vMarchFloors(numQueries, -1000.0f);
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numQueries; i++)
+	{
+		vec3 startPos = vFloorStarts[i] - vec3(0.0f, 0.5f, 0.0f);
+		float distance;
+		if (StepMarch(&world, startPos, vec3(0.0f, -1.0f, 0.0f), 0.5f, 99, &distance, &numMarchProbes))
+		{
+			vMarchFloors[i] = VoxelRayCast::GetBlockCoordinate(startPos.y - distance) + 0.5f;
+		}
+	}
+	double floorMarchTime = GetElapsedMilliseconds(startTime);
+
+	int numBlocksVisited = 0;
+	int numChunkLookups = 0;
+	vector<float> vRayFloors(numQueries, -1000.0f);
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numQueries; i++)
+	{
+		VoxelRayHit hit;
+		if (world.RayCast(vFloorStarts[i] - vec3(0.0f, 0.5f, 0.0f), vec3(0.0f, -1.0f, 0.0f), 49.0f, &hit))
+		{
+			vRayFloors[i] = hit.m_blockPosition.y + 0.5f;
+		}
+		numBlocksVisited += hit.m_numBlocksVisited;
+		numChunkLookups += hit.m_numChunkLookups;
+	}
+	double floorRayTime = GetElapsedMilliseconds(startTime);
+
+	int numFloorMismatches = 0;
+	for (int i = 0; i < numQueries; i++)
+	{
+		if (vMarchFloors[i] != vRayFloors[i] || vRayFloors[i] != vGroundHeights[i] - 0.5f)
+		{
+			numFloorMismatches++;
+		}
+	}
+
+	pReport->AddTiming("floor_step_march", floorMarchTime);
+	pReport->AddTiming("floor_ray_cast", floorRayTime);
+	pReport->AddValue("floor_probes_per_query_march", (double)numMarchProbes / numQueries);
+	pReport->AddValue("floor_blocks_per_query_ray", (double)numBlocksVisited / numQueries);
+	pReport->AddValue("floor_chunk_lookups_per_query_ray", (double)numChunkLookups / numQueries);
+	pReport->AddValue("floor_mismatches", numFloorMismatches);
+
+	// Block selection, 0.025 steps out to the selection distance, and long rays in 0.1 steps
+	const int NUM_RAY_KINDS = 2;
+	const char* rayKindNames[NUM_RAY_KINDS] = { "selection", "long" };
+	float rayStepSizes[NUM_RAY_KINDS] = { 0.025f, 0.1f };
+	int rayNumSteps[NUM_RAY_KINDS] = { 110, 480 };
+
+	bool neverBehindMarch = true;
+	bool hitsAreSolid = true;
+	for (int kind = 0; kind < NUM_RAY_KINDS; kind++)
+	{
+		float maxDistance = rayStepSizes[kind] * (rayNumSteps[kind] - 1);
+
+		numMarchProbes = 0;
+		vector<float> vMarchDistances(numQueries, -1.0f);
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numQueries; i++)
+		{
+			StepMarch(&world, vHeads[i], vDirections[i], rayStepSizes[kind], rayNumSteps[kind], &vMarchDistances[i], &numMarchProbes);
+		}
+		double marchTime = GetElapsedMilliseconds(startTime);
+
+		numBlocksVisited = 0;
+		numChunkLookups = 0;
+		vector<VoxelRayHit> vHits(numQueries);
+		vector<bool> vHitFound(numQueries);
+		startTime = GetHighResolutionTime();
+		for (int i = 0; i < numQueries; i++)
+		{
+			vHitFound[i] = world.RayCast(vHeads[i], vDirections[i], maxDistance, &vHits[i]);
+			numBlocksVisited += vHits[i].m_numBlocksVisited;
+			numChunkLookups += vHits[i].m_numChunkLookups;
+		}
+		double rayTime = GetElapsedMilliseconds(startTime);
+
+		int numMarchHits = 0;
+		int numRayHits = 0;
+		int numSameBlock = 0;
+		int numCornersSkipped = 0;
+		for (int i = 0; i < numQueries; i++)
+		{
+			bool marchHit = (vMarchDistances[i] >= 0.0f);
+			numMarchHits += marchHit ? 1 : 0;
+			numRayHits += vHitFound[i] ? 1 : 0;
+
+			if (vHitFound[i])
+			{
+				vec3 blockPosition = vHits[i].m_blockPosition;
+				if (world.GetBlockActive((int)blockPosition.x, (int)blockPosition.y, (int)blockPosition.z) == false)
+				{
+					hitsAreSolid = false;
+				}
+			}
+
+			if (marchHit)
+			{
+				// The march can only find a block that the ray reaches at the same point or later
+				if (vHitFound[i] == false || vHits[i].m_distance > vMarchDistances[i] + 0.0001f)
+				{
+					neverBehindMarch = false;
+				}
+				else
+				{
+					vec3 marchPosition = vHeads[i] + vDirections[i] * vMarchDistances[i];
+					if (VoxelRayCast::GetBlockCoordinate(marchPosition.x) == (int)vHits[i].m_blockPosition.x && VoxelRayCast::GetBlockCoordinate(marchPosition.y) == (int)vHits[i].m_blockPosition.y && VoxelRayCast::GetBlockCoordinate(marchPosition.z) == (int)vHits[i].m_blockPosition.z)
+					{
+						numSameBlock++;
+					}
+					else
+					{
+						numCornersSkipped++;
+					}
+				}
+			}
+			else if (vHitFound[i])
+			{
+				numCornersSkipped++;
+			}
+		}
+
+		char name[64];
+		sprintf(name, "%s_step_march", rayKindNames[kind]);
+		pReport->AddTiming(name, marchTime);
+		sprintf(name, "%s_ray_cast", rayKindNames[kind]);
+		pReport->AddTiming(name, rayTime);
+		sprintf(name, "%s_probes_per_query_march", rayKindNames[kind]);
+		pReport->AddValue(name, (double)numMarchProbes / numQueries);
+		sprintf(name, "%s_blocks_per_query_ray", rayKindNames[kind]);
+		pReport->AddValue(name, (double)numBlocksVisited / numQueries);
+		sprintf(name, "%s_chunk_lookups_per_query_ray", rayKindNames[kind]);
+		pReport->AddValue(name, (double)numChunkLookups / numQueries);
+		sprintf(name, "%s_hits_march", rayKindNames[kind]);
+		pReport->AddValue(name, numMarchHits);
+		sprintf(name, "%s_hits_ray", rayKindNames[kind]);
+		pReport->AddValue(name, numRayHits);
+		sprintf(name, "%s_same_block", rayKindNames[kind]);
+		pReport->AddValue(name, numSameBlock);
+		sprintf(name, "%s_corners_skipped_by_march", rayKindNames[kind]);
+		pReport->AddValue(name, numCornersSkipped);
+	}
+
+	// Camera clipping, a third person camera behind the player
+	numMarchProbes = 0;
+	numBlocksVisited = 0;
+	vector<vec3> vCameras(numQueries);
+	vector<vec3> vProbeOffsets(numQueries * 4);
+	for (int i = 0; i < numQueries; i++)
+	{
+		vec3 back = vec3(-vDirections[i].x, 0.0f, -vDirections[i].z);
+		back = (length(back) > 0.01f) ? normalize(back) : vec3(0.0f, 0.0f, 1.0f);
+		vCameras[i] = vHeads[i] + back * (float)random.GetRandomNumber(4, 10) + vec3(0.0f, (float)random.GetRandomNumber(1, 4), 0.0f);
+
+		vec3 right = normalize(cross(vec3(0.0f, 1.0f, 0.0f), back));
+		vProbeOffsets[i*4 + 0] = right * 0.25f;
+		vProbeOffsets[i*4 + 1] = right * -0.25f;
+		vProbeOffsets[i*4 + 2] = vec3(0.0f, -0.25f, 0.0f);
+		vProbeOffsets[i*4 + 3] = vec3(0.0f, 0.25f, 0.0f);
+	}
+
+	vector<vec3> vMarchCameras(numQueries);
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numQueries; i++)
+	{
+		vMarchCameras[i] = StepMarchCameraClipping(&world, vHeads[i], vCameras[i], &vProbeOffsets[i*4], &numMarchProbes);
+	}
+	double cameraMarchTime = GetElapsedMilliseconds(startTime);
+
+	vector<vec3> vClippedCameras(numQueries);
+	startTime = GetHighResolutionTime();
+	for (int i = 0; i < numQueries; i++)
+	{
+		vClippedCameras[i] = RayCastCameraClipping(&world, vHeads[i], vCameras[i], &vProbeOffsets[i*4], &numBlocksVisited);
+	}
+	double cameraRayTime = GetElapsedMilliseconds(startTime);
+
+	// The old clipping only looked around the camera, so it could leave the camera behind a wall
+	int numBlockedCameras = 0;
+	int numBlockedMarchCameras = 0;
+	int numClippedCameras = 0;
+	for (int i = 0; i < numQueries; i++)
+	{
+		if (length(vClippedCameras[i] - vHeads[i]) < length(vCameras[i] - vHeads[i]) - 0.0001f)
+		{
+			numClippedCameras++;
+		}
+		if (CameraBlocked(&world, vHeads[i], vClippedCameras[i], &vProbeOffsets[i*4]))
+		{
+			numBlockedCameras++;
+		}
+		if (CameraBlocked(&world, vHeads[i], vMarchCameras[i], &vProbeOffsets[i*4]))
+		{
+			numBlockedMarchCameras++;
+		}
+	}
+
+	pReport->AddTiming("camera_step_march", cameraMarchTime);
+	pReport->AddTiming("camera_ray_cast", cameraRayTime);
+	pReport->AddValue("camera_probes_per_query_march", (double)numMarchProbes / numQueries);
+	pReport->AddValue("camera_blocks_per_query_ray", (double)numBlocksVisited / numQueries);
+	pReport->AddValue("cameras_clipped", numClippedCameras);
+	pReport->AddValue("cameras_blocked_march", numBlockedMarchCameras);
+	pReport->AddValue("cameras_blocked_ray", numBlockedCameras);
+
+	// Every block along the ray once, each one sharing a face with the one before
+	int numTraversalErrors = 0;
+	BenchRayRecorder* pRecorder = new BenchRayRecorder();
+	pRecorder->m_pWorld = &world;
+	memset(pRecorder->m_emptyChunk.m_colour, 0, sizeof(pRecorder->m_emptyChunk.m_colour));
+	for (int i = 0; i < numQueries / 10; i++)
+	{
+		pRecorder->m_vBlocks.clear();
+		VoxelRayHit hit;
+		VoxelRayCast::Cast(vHeads[i] + vec3(0.0f, 20.0f, 0.0f), vDirections[i], 40.0f, _GetRecordedRayChunk, _GetRecordedRayBlock, pRecorder, &hit);
+
+		if ((int)pRecorder->m_vBlocks.size() != hit.m_numBlocksVisited)
+		{
+			numTraversalErrors++;
+		}
+
+		for (unsigned int j = 1; j < pRecorder->m_vBlocks.size(); j++)
+		{
+			const BenchRayBlock& previous = pRecorder->m_vBlocks[j - 1];
+			const BenchRayBlock& block = pRecorder->m_vBlocks[j];
+			int steps = abs(block.m_x - previous.m_x) + abs(block.m_y - previous.m_y) + abs(block.m_z - previous.m_z);
+			if (steps != 1)
+			{
+				numTraversalErrors++;
+			}
+		}
+	}
+	delete pRecorder;
+	pReport->AddValue("traversal_errors", numTraversalErrors);
+
+	pReport->AddCheck("floor_matches_step_march_and_ground", numFloorMismatches == 0);
+	pReport->AddCheck("ray_never_behind_step_march", neverBehindMarch);
+	pReport->AddCheck("ray_hits_are_solid", hitsAreSolid);
+	pReport->AddCheck("clipped_camera_unobstructed", numBlockedCameras == 0);
+	pReport->AddCheck("blocks_visited_once_face_to_face", numTraversalErrors == 0);
+}
+
+
+// Region files
+static unsigned int RegionChunkValue(int chunk, int i)
+{
+	return (unsigned int)(chunk * 2654435761u) ^ (unsigned int)(i * 40503);
+}
+
+void BenchRegionFiles(BenchReport* pReport, bool quick)
+{
+	const char* saveFolder = "bench_regions";
+	int maxOpenRegionFiles = 4;
+	int numRegions = quick ? 12 : 48;
+	int chunksPerRegion = 8;
+	int numChunks = numRegions * chunksPerRegion;
+
+	// One row of regions either side of 0, each chunk at a different spot in its region
+	vector<int> vGridX(numChunks);
+	vector<int> vGridZ(numChunks);
+	vector<vector<unsigned int> > vChunkData(numChunks);
+	for (int i = 0; i < numChunks; i++)
+	{
+		int region = (i % numRegions) - (numRegions / 2);
+		int local = i / numRegions;
+		vGridX[i] = region * RegionFile::REGION_SIZE + local;
+		vGridZ[i] = local * 2;
+
+		vChunkData[i].resize(64 + (i % 7) * 16);
+		for (int j = 0; j < (int)vChunkData[i].size(); j++)
+		{
+			vChunkData[i][j] = RegionChunkValue(i, j);
+		}
+	}
+
+	// Saving cycles through every region in turn, so the open region files are always being closed
+	RegionFileManager* pRegionFileManager = new RegionFileManager(saveFolder);
+	pRegionFileManager->SetMaxOpenRegionFiles(maxOpenRegionFiles);
+
+	int maxOpen = 0;
+	double startTime = GetHighResolutionTime();
+	for (int i = 0; i < numChunks; i++)
+	{
+		pRegionFileManager->SaveChunkData(vGridX[i], 0, vGridZ[i], vChunkData[i]);
+		int numOpen = pRegionFileManager->GetNumOpenRegionFiles();
+		if (numOpen > maxOpen)
+		{
+			maxOpen = numOpen;
+		}
+	}
+	pRegionFileManager->FlushPendingWrites();
+	double saveTime = GetElapsedMilliseconds(startTime);
+
+	bool allSaved = (pRegionFileManager->GetNumChunksSaved() == numChunks);
+	int numClosed = pRegionFileManager->GetNumRegionFilesClosed();
+	bool withinLimit = (pRegionFileManager->GetNumOpenRegionFiles() <= maxOpenRegionFiles);
+	delete pRegionFileManager;
+
+	// Load them back in the opposite order from a fresh manager
+	pRegionFileManager = new RegionFileManager(saveFolder);
+	pRegionFileManager->SetMaxOpenRegionFiles(maxOpenRegionFiles);
+
+	int numMismatches = 0;
+	startTime = GetHighResolutionTime();
+	for (int i = numChunks - 1; i >= 0; i--)
+	{
+		vector<unsigned int> data;
+		if (pRegionFileManager->LoadChunkData(vGridX[i], 0, vGridZ[i], &data) == false || data != vChunkData[i])
+		{
+			numMismatches++;
+		}
+		int numOpen = pRegionFileManager->GetNumOpenRegionFiles();
+		if (numOpen > maxOpen)
+		{
+			maxOpen = numOpen;
+		}
+	}
+	double loadTime = GetElapsedMilliseconds(startTime);
+
+	numClosed += pRegionFileManager->GetNumRegionFilesClosed();
+	withinLimit = withinLimit && (pRegionFileManager->GetNumOpenRegionFiles() <= maxOpenRegionFiles);
+	delete pRegionFileManager;
+
+	for (int i = 0; i < numRegions; i++)
+	{
+		char regionFilename[256];
+		sprintf(regionFilename, "%s/region_%i_%i_%i.region", saveFolder, i - (numRegions / 2), 0, 0);
+		remove(regionFilename);
+	}
+	remove(saveFolder);
+
+	pReport->AddTiming("save_chunks", saveTime);
+	pReport->AddTiming("load_chunks", loadTime);
+	pReport->AddValue("num_chunks", numChunks);
+	pReport->AddValue("num_regions", numRegions);
+	pReport->AddValue("peak_open_region_files", maxOpen);
+	pReport->AddValue("num_region_files_closed", numClosed);
+	// A region can be opened by a read or write just before the least recently used one is closed
+	pReport->AddCheck("open_region_files_bounded", maxOpen <= maxOpenRegionFiles + 1);
+	pReport->AddCheck("open_region_files_within_limit_when_idle", withinLimit);
+	pReport->AddCheck("region_files_closed", numClosed > 0);
+	pReport->AddCheck("all_chunks_saved", allSaved);
+	pReport->AddCheck("chunks_round_trip", numMismatches == 0);
+}
@@ -0,0 +1,275 @@
+// ******************************************************************************
+// Filename:    NullBackend.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   A renderer and chunk manager with nothing behind them, so that vox_bench
+//   can link the real Chunk and build its meshes. The mesh building itself is
+//   the real one from RendererMesh.cpp, only the GL upload and the drawing
+//   are empty here. There is no world around the chunks, so GetChunk() never
+//   finds a neighbour, and nothing is saved, loaded or imported.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "NullBackend.h"
+
+#include "../blocks/Chunk.h"
+#include "../blocks/ChunkManager.h"
+#include "../blocks/BiomeManager.h"
+#include "../blocks/RegionFile.h"
+#include "../Renderer/Renderer.h"
+#include "../Renderer/camera.h"
+#include "../Player/Player.h"
+#include "../Items/Item.h"
+
+
+static OpenGLTriangleMesh* s_pLastFinishedMesh = NULL;
+
+OpenGLTriangleMesh* NullBackend::GetLastFinishedMesh()
+{
+	return s_pLastFinishedMesh;
+}
+
+// Renderer
+Renderer::Renderer(int width, int height, int depthBits, int stencilBits)
+{
+	m_windowWidth = width;
+	m_windowHeight = height;
+}
+
+Renderer::~Renderer()
+{
+}
+
+glShaderManager::glShaderManager()
+{
+}
+
+glShaderManager::~glShaderManager()
+{
+}
+
+void Renderer::ClearMesh(OpenGLTriangleMesh* pMesh)
+{
+	if (s_pLastFinishedMesh == pMesh)
+	{
+		s_pLastFinishedMesh = NULL;
+	}
+
+	delete pMesh;
+}
+
+void Renderer::FinishMesh(unsigned int textureID, unsigned int materialID, OpenGLTriangleMesh* pMesh)
+{
+	pMesh->m_materialId = materialID;
+	pMesh->m_textureId = textureID;
+
+	s_pLastFinishedMesh = pMesh;
+}
+
+bool Renderer::MeshStaticBufferRender(OpenGLTriangleMesh* pMesh)
+{
+	return false;
+}
+
+void Renderer::SetRenderMode(RenderMode mode)
+{
+}
+
+void Renderer::SetCullMode(CullMode mode)
+{
+}
+
+void Renderer::SetLineWidth(float width)
+{
+}
+
+bool Renderer::SetProjectionMode(ProjectionMode mode, int viewPort)
+{
+	return false;
+}
+
+void Renderer::SetLookAtCamera(vec3 pos, vec3 target, vec3 up)
+{
+}
+
+void Renderer::PushMatrix()
+{
+}
+
+void Renderer::PopMatrix()
+{
+}
+
+void Renderer::GetModelMatrix(Matrix4x4 *pMat)
+{
+}
+
+void Renderer::MultiplyWorldMatrix(const Matrix4x4 &mat)
+{
+}
+
+void Renderer::TranslateWorldMatrix(float x, float y, float z)
+{
+}
+
+void Renderer::PushTextureMatrix()
+{
+}
+
+void Renderer::PopTextureMatrix()
+{
+}
+
+void Renderer::EnableImmediateMode(ImmediateModePrimitive mode)
+{
+}
+
+void Renderer::ImmediateVertex(float x, float y, float z)
+{
+}
+
+void Renderer::ImmediateNormal(float x, float y, float z)
+{
+}
+
+void Renderer::ImmediateColourAlpha(float r, float g, float b, float a)
+{
+}
+
+void Renderer::DisableImmediateMode()
+{
+}
+
+bool Renderer::RenderFreeTypeText(unsigned int fontID, float x, float y, float z, Colour colour, float scale, const char *inText, ...)
+{
+	return false;
+}
+
+void Renderer::GetScreenCoordinatesFromWorldPosition(vec3 pos, int *x, int *y)
+{
+	*x = 0;
+	*y = 0;
+}
+
+void Camera::Look() const
+{
+}
+
+// Chunk manager
+ChunkManager::ChunkManager(Renderer* pRenderer, VoxSettings* pVoxSettings, QubicleBinaryManager* pQubicleBinaryManager)
+{
+	m_pRenderer = pRenderer;
+	m_pVoxSettings = pVoxSettings;
+	m_pQubicleBinaryManager = pQubicleBinaryManager;
+	m_pRegionFileManager = NULL;
+	m_pChunkColumnCache = NULL;
+	m_pChunkJobPool = NULL;
+	m_pUpdatingChunksThread = NULL;
+
+	// The same defaults as the game
+	m_chunkMaterialID = 0;
+	m_faceMerging = true;
+	m_greedyMeshing = false;
+}
+
+ChunkManager::~ChunkManager()
+{
+}
+
+Chunk* ChunkManager::GetChunk(int aX, int aY, int aZ)
+{
+	return NULL;
+}
+
+bool ChunkManager::GetBlockActiveFrom3DPosition(float x, float y, float z, vec3 *blockPos, int* blockX, int* blockY, int* blockZ, Chunk** pChunk)
+{
+	*pChunk = NULL;
+
+	return false;
+}
+
+
+bool ChunkManager::ImportQubicleBinary(const char* filename, vec3 position, QubicleImportDirection direction, unsigned long long sourceKey)
+{
+	return false;
+}
+
+unsigned int ChunkManager::GetChunkMaterialID()
+{
+	return m_chunkMaterialID;
+}
+
+TerrainGenerator* ChunkManager::GetTerrainGenerator()
+{
+	return &m_terrainGenerator;
+}
+
+ChunkStorageTable* ChunkManager::GetChunkStorageTable()
+{
+	return &m_chunkStorageTable;
+}
+
+RegionFileManager* ChunkManager::GetRegionFileManager()
+{
+	return m_pRegionFileManager;
+}
+
+BlockType ChunkManager::SetBlockTypeBasedOnColour(int r, int g, int b)
+{
+	return BlockType_Default;
+}
+
+void ChunkManager::SetFaceMerging(bool faceMerge)
+{
+	m_faceMerging = faceMerge;
+}
+
+bool ChunkManager::GetFaceMerging()
+{
+	return m_faceMerging;
+}
+
+void ChunkManager::SetGreedyMeshing(bool greedyMeshing)
+{
+	m_greedyMeshing = greedyMeshing;
+}
+
+bool ChunkManager::GetGreedyMeshing()
+{
+	return m_greedyMeshing;
+}
+
+// Game objects that a chunk can point to
+int BiomeManager::GetTerrainVersion()
+{
+	return 0;
+}
+
+int Player::GetGridX() const
+{
+	return 0;
+}
+
+int Player::GetGridY() const
+{
+	return 0;
+}
+
+int Player::GetGridZ() const
+{
+	return 0;
+}
+
+void Item::SetErase(bool erase)
+{
+}
+
+void Item::SetChunk(Chunk* pChunk)
+{
+}
@@ -0,0 +1,26 @@
+// ******************************************************************************
+// Filename:    NullBackend.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   What the null renderer has seen, so that the scenarios can look at the
+//   meshes that the real chunks build.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+class OpenGLTriangleMesh;
+
+
+class NullBackend
+{
+public:
+	// The last mesh given to Renderer::FinishMesh(), it keeps its vertices and triangles until it is cleared
+	static OpenGLTriangleMesh* GetLastFinishedMesh();
+};
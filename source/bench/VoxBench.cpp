@@ -0,0 +1,143 @@
+// ******************************************************************************
+// Filename:    VoxBench.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   vox_bench, runs the simulation scenarios without a window, a GL context
+//   or audio and prints the per subsystem timings as JSON on stdout.
+//
+//   vox_bench [--quick] [--list] [scenario ...]
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "BenchScenarios.h"
+
+#include "../utils/Profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+using namespace std;
+
+
+static const BenchScenario SCENARIOS[] =
+{
+	{ "chunk_generation", "Chunk generation on 1, 2, 4 and all job pool workers, with and without the column cache", BenchChunkGeneration },
+	{ "chunk_hash_table", "Chunk lookups, on their own and with another thread adding and removing chunks", BenchChunkHashTable },
+	{ "meshing", "Greedy and per block meshing of generated terrain", BenchMeshing },
+	{ "chunk_lod", "Terrain meshed at full detail and at 2x, 4x and 8x level of detail", BenchChunkLOD },
+	{ "block_edits", "Single block mining and building, remeshing the edited slices against remeshing the chunk and its neighbours", BenchBlockEdits },
+	{ "chunk_storage", "Palette compressed chunk storage, memory against the plain block arrays, reads and carving", BenchChunkStorage },
+	{ "pending_edits", "Trees imported into unloaded chunks, the storage table against dense storage found with a linear search", BenchPendingEdits },
+	{ "noise", "Per point octave noise against the batched noise in every supported mode", BenchNoise },
+	{ "raycast", "Block ray casts against the old step marching, for floors, block selection, long rays and camera clipping", BenchRayCast },
+	{ "region_files", "Saving and loading chunks across more regions than can be open at once", BenchRegionFiles },
+	{ "spatial_grid", "Enemy push and projectile queries, spatial grid against brute force", BenchSpatialGrid },
+	{ "particles", "Block particle pool updates at 10k, 100k and 1M particles", BenchParticles },
+	{ "instance_buffer", "Per frame instance packing, the allocations must stop after warming up", BenchInstanceBuffer },
+	{ "parallel_update", "Entity updates with deferred commands on 1 to all threads", BenchParallelUpdate },
+	{ "fixed_timestep", "The same simulation at 20 and 200 frames per second", BenchFixedTimestep },
+	{ "visibility", "Culling chunks and entities for the main, shadow and water reflection passes in one stage", BenchVisibility },
+	{ "lights", "Binning 1k to 10k dynamic lights into the clustered light grid, and light lookups by id", BenchLights },
+	{ "picking", "Mouse picking rays against 200 and 2000 voxel characters, checked against testing every volume", BenchPicking },
+	{ "walk_500_blocks", "Walk 500 blocks, loading, generating and meshing chunks on the way", BenchWalk500Blocks },
+	{ "explode_50_spheres", "Blow 50 holes in the terrain, remeshing and throwing debris particles", BenchExplode50Spheres },
+	{ "spawn_200_enemies", "200 enemies wandering and pushing each other for 10 seconds", BenchSpawn200Enemies },
+	{ "projectiles", "Projectiles fired at a one block wall and small enemies with 1/240 to 0.25 second steps, swept against the old end of step test", BenchProjectiles },
+	{ "profiler", "The cost of a profile zone, disabled and enabled, and collecting zones from worker threads", BenchProfiler },
+	{ "job_pool", "Job throughput for each worker count, and workers taking the most urgent job from all the queues", BenchJobPool },
+};
+
+static const int NUM_SCENARIOS = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: vox_bench [--quick] [--list] [scenario ...]\n");
+	fprintf(stderr, "  --quick  smaller worlds and fewer frames\n");
+	fprintf(stderr, "  --list   list the scenarios\n");
+	fprintf(stderr, "All the scenarios are run when none are given. The results are written to stdout as JSON.\n");
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	vector<const BenchScenario*> vpScenarios;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--quick") == 0)
+		{
+			quick = true;
+		}
+		else if (strcmp(argv[i], "--list") == 0)
+		{
+			for (int j = 0; j < NUM_SCENARIOS; j++)
+			{
+				printf("%-20s %s\n", SCENARIOS[j].m_name, SCENARIOS[j].m_description);
+			}
+			return 0;
+		}
+		else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		else
+		{
+			const BenchScenario* pScenario = NULL;
+			for (int j = 0; j < NUM_SCENARIOS; j++)
+			{
+				if (strcmp(argv[i], SCENARIOS[j].m_name) == 0)
+				{
+					pScenario = &SCENARIOS[j];
+				}
+			}
+
+			if (pScenario == NULL)
+			{
+				fprintf(stderr, "Unknown scenario '%s'\n", argv[i]);
+				PrintUsage();
+				return 2;
+			}
+
+			vpScenarios.push_back(pScenario);
+		}
+	}
+
+	if (vpScenarios.empty())
+	{
+		for (int i = 0; i < NUM_SCENARIOS; i++)
+		{
+			vpScenarios.push_back(&SCENARIOS[i]);
+		}
+	}
+
+	// The job pool workers name themselves in the profiler, so create it on this thread first
+	Profiler::GetInstance();
+
+	BenchReport report;
+	for (unsigned int i = 0; i < vpScenarios.size(); i++)
+	{
+		const BenchScenario* pScenario = vpScenarios[i];
+
+		// Progress goes to stderr, so that stdout is just the JSON
+		fprintf(stderr, "%s\n", pScenario->m_name);
+
+		report.BeginScenario(pScenario->m_name);
+		pScenario->m_function(&report, quick);
+		report.EndScenario();
+	}
+
+	report.WriteJSON(stdout);
+
+	Profiler::GetInstance()->Destroy();
+
+	return report.HasFailedChecks() ? 1 : 0;
+}
@@ -11,6 +11,7 @@
 
 #include "BiomeManager.h"
 #include "ChunkManager.h"
+#include "../utils/Profiler.h"
 
 #include "noise/noise.h"
 #include "noiseutils.h"
@@ -52,6 +53,9 @@ BiomeManager::BiomeManager(Renderer* pRenderer)
 	// Biome regions	
 	biomeRegions.SetFrequency(0.005f);
 	biomeRegions.SetSeed(2);
+
+	// Terrain version
+	m_terrainVersion = 0;
 }
 
 BiomeManager::~BiomeManager()
@@ -83,6 +87,8 @@ void BiomeManager::ClearTownData()
 		m_vpTownsList[i] = 0;
 	}
 	m_vpTownsList.clear();
+
+	m_terrainVersion++;
 }
 
 void BiomeManager::ClearSafeZoneData()
@@ -120,6 +126,8 @@ void BiomeManager::AddTown(vec3 townCenter, float radius)
 	pNewTown->m_radius = radius;
 
 	m_vpTownsList.push_back(pNewTown);
+
+	m_terrainVersion++;
 }
 
 void BiomeManager::AddTown(vec3 townCenter, float length, float height, float width)
@@ -136,6 +144,8 @@ void BiomeManager::AddTown(vec3 townCenter, float length, float height, float wi
 	pNewTown->UpdatePlanes(transformMatrix);
 
 	m_vpTownsList.push_back(pNewTown);
+
+	m_terrainVersion++;
 }
 
 void BiomeManager::AddSafeZone(vec3 safeZoneCenter, float radius)
@@ -164,6 +174,21 @@ void BiomeManager::AddSafeZone(vec3 safeZoneCenter, float length, float height,
 	m_vpSafeZonesList.push_back(pNewSafeZone);
 }
 
+// World seed
+void BiomeManager::SetWorldSeed(unsigned int worldSeed)
+{
+	// Seed 0 keeps the original biome layout
+	biomeRegions.SetSeed(2 + (int)worldSeed);
+
+	m_terrainVersion++;
+}
+
+// Terrain version
+int BiomeManager::GetTerrainVersion()
+{
+	return m_terrainVersion;
+}
+
 // Get biome
 Biome BiomeManager::GetBiome(vec3 position)
 {
@@ -316,6 +341,11 @@ void BiomeManager::GetChunkColourAndBlockType(float xPos, float yPos, float zPos
 {
 	Biome biome = GetBiome(vec3(xPos, yPos, zPos));
 
+	GetChunkColourAndBlockType(biome, noiseValue, landscapeGradient, r, g, b, blockType);
+}
+
+void BiomeManager::GetChunkColourAndBlockType(Biome biome, float noiseValue, float landscapeGradient, float *r, float *g, float *b, BlockType *blockType)
+{
 	float red1 = 0.0f;
 	float green1 = 0.0f;
 	float blue1 = 0.0f;
@@ -368,6 +398,7 @@ void BiomeManager::GetChunkColourAndBlockType(float xPos, float yPos, float zPos
 // Update
 void BiomeManager::Update(float dt)
 {
+	PROFILE_ZONE("BiomeManager::Update");
 }
 
 // Render
@@ -91,6 +91,12 @@ public:
 	void AddSafeZone(vec3 safeZoneCenter, float radius);
 	void AddSafeZone(vec3 safeZoneCenter, float length, float height, float width);
 
+	// World seed
+	void SetWorldSeed(unsigned int worldSeed);
+
+	// Terrain version, changes whenever the towns or the world seed change so that cached terrain columns know they are stale
+	int GetTerrainVersion();
+
 	// Get biome
 	Biome GetBiome(vec3 position);
 
@@ -103,6 +109,7 @@ public:
 
 	// Check chunk and block type
 	void GetChunkColourAndBlockType(float xPos, float yPos, float zPos, float noiseValue, float landscapeGradient, float *r, float *g, float *b, BlockType *blockType);
+	void GetChunkColourAndBlockType(Biome biome, float noiseValue, float landscapeGradient, float *r, float *g, float *b, BlockType *blockType);
 
 	// Update
 	void Update(float dt);
@@ -139,4 +146,7 @@ private:
 
 	// Safe zones
 	ZoneDataList m_vpSafeZonesList;
+
+	// Terrain version
+	int m_terrainVersion;
 };
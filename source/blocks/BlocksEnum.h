@@ -4,7 +4,8 @@
 // Author:      Steven Ball
 //
 // Purpose:
-//   An enum list of all of the block types
+//   An enum list of all of the block types, and the directions that qubicle
+//   files can be imported into the world with
 //
 // Revision History:
 //   Initial Revision - 12/03/16
@@ -29,4 +30,22 @@ enum BlockType
 	BlockType_Leaf,
 	BlockType_CustomColour,
 	BlockType_NumTypes,
-};
\ No newline at end of file
+};
+
+enum QubicleImportDirection
+{
+	QubicleImportDirection_Normal = 0,
+	QubicleImportDirection_MirrorX,
+	QubicleImportDirection_MirrorY,
+	QubicleImportDirection_MirrorZ,
+	QubicleImportDirection_RotateY90,
+	QubicleImportDirection_RotateY180,
+	QubicleImportDirection_RotateY270,
+	QubicleImportDirection_RotateX90,
+	QubicleImportDirection_RotateX180,
+	QubicleImportDirection_RotateX270,
+	QubicleImportDirection_RotateZ90,
+	QubicleImportDirection_RotateZ180,
+	QubicleImportDirection_RotateZ270,
+	QubicleImportDirection_NumDirections,
+};
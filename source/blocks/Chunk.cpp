@@ -13,16 +13,20 @@
 
 #include "Chunk.h"
 #include "ChunkManager.h"
+#include "ChunkMesher.h"
 #include "BiomeManager.h"
 #include "BlocksEnum.h"
+#include "RegionFile.h"
 #include "../Player/Player.h"
 #include "../scenery/SceneryManager.h"
 #include "../models/QubicleBinary.h"
 #include "../utils/Random.h"
+#include "../utils/TimeUtils.h"
 #include "../simplex/simplexnoise.h"
 #include "../VoxSettings.h"
 #include "../VoxGame.h"
 #include "../Items/ItemManager.h"
+#include "../utils/Profiler.h"
 
 // A chunk cube is double this render size, since we create from - to + for each axis.
 const float Chunk::BLOCK_RENDER_SIZE = 0.5f;
@@ -43,9 +47,6 @@ Chunk::Chunk(Renderer* pRenderer, ChunkManager* pChunkManager, VoxSettings* pVox
 Chunk::~Chunk()
 {
 	Unload();
-
-	delete m_colour;
-	delete m_blockType;
 }
 
 // Player pointer
@@ -104,22 +105,31 @@ void Chunk::Initialize()
 	m_rebuildNeighours = false;
 	m_isRebuildingMesh = false;
 	m_deleteCachedMesh = false;
+	m_needsSaving = false;
+	m_jobQueued = false;
+
+	// Dirty regions
+	m_editedRegion.Reset();
+	m_dirtyBorderFaces = 0;
+	m_rebuildFullMesh = false;
+	m_pMeshQuadCache = NULL;
 
 	// Counters
 	m_numRebuilds = 0;
+	m_numIncrementalRebuilds = 0;
+	m_numMeshVertices = 0;
+	m_numMeshTriangles = 0;
+
+	// Level of detail
+	m_lodLevel = 0;
+	m_meshLODLevel = 0;
 
 	// Mesh
 	m_pMesh = NULL;
 	m_pCachedMesh = NULL;
 
 	// Blocks data
-	m_colour = new unsigned int[CHUNK_SIZE_CUBED];
-	m_blockType = new BlockType[CHUNK_SIZE_CUBED];
-	for (int i = 0; i < CHUNK_SIZE_CUBED; i++)
-	{
-		m_colour[i] = 0;
-		m_blockType[i] = BlockType_Default;
-	}
+	m_blocks.Fill(0, BlockType_Default);
 }
 
 // Creation and destruction
@@ -143,6 +153,8 @@ void Chunk::Unload()
 		m_pMesh = NULL;
 	}
 
+	FreeMeshQuadCache();
+
 	if (m_setup == true)
 	{
 		// If we are already setup, when we unload, also tell our neighbours to update their flags
@@ -172,132 +184,109 @@ void Chunk::Unload()
 
 void Chunk::Setup()
 {
-	ChunkStorageLoader* pChunkStorage = m_pChunkManager->GetChunkStorage(m_gridX, m_gridY, m_gridZ, false);
+	PROFILE_ZONE("Chunk::Setup");
 
-	for (int x = 0; x < CHUNK_SIZE; x++)
+	// If we have been saved before, load from the region file instead of generating
+	if (LoadChunk() == false)
 	{
-		for (int z = 0; z < CHUNK_SIZE; z++)
-		{
-			float xPosition = m_position.x + x;
-			float zPosition = m_position.z + z;
+		GenerateTerrain();
+		m_needsSaving = true;
+	}
 
-			Biome biome = VoxGame::GetInstance()->GetBiomeManager()->GetBiome(vec3(xPosition, 0.0f, zPosition));
+	// Generating can leave unused palette entries behind, and indices wider than the final palette needs.
+	// This has to be done before we are added to the storage table, after that other workers can write into us.
+	m_blocks.Compact();
 
-			// Get the 
-			float noise = octave_noise_2d(m_pVoxSettings->m_landscapeOctaves, m_pVoxSettings->m_landscapePersistence, m_pVoxSettings->m_landscapeScale, xPosition, zPosition);
-			float noiseNormalized = ((noise + 1.0f) * 0.5f);
-			float noiseHeight = noiseNormalized * CHUNK_SIZE;
+	// Apply what we and our neighbours generated into us, on top of our own terrain. The storage table sends us any later edits directly.
+	m_pChunkManager->GetChunkStorageTable()->AddChunk(this);
 
-			// Multiple by mountain ratio
-			float mountainNoise = octave_noise_2d(m_pVoxSettings->m_mountainOctaves, m_pVoxSettings->m_mountainPersistence, m_pVoxSettings->m_mountainScale, xPosition, zPosition);
-			float mountainNoiseNormalise = (mountainNoise + 1.0f) * 0.5f;
-			float mountainMultiplier = m_pVoxSettings->m_mountainMultiplier * mountainNoiseNormalise;
-			noiseHeight *= mountainMultiplier;
+	m_setup = true;
 
-			// Smooth out for towns
-			float townMultiplier = VoxGame::GetInstance()->GetBiomeManager()->GetTowMultiplier(vec3(xPosition, 0.0f, zPosition));
-			noiseHeight *= townMultiplier;
+	SetNeedsRebuild(true, true);
+}
 
-			if (m_gridY < 0)
-			{
-				noiseHeight = CHUNK_SIZE;
-			}
+void Chunk::ApplyChunkStorage(ChunkStorageLoader* pChunkStorage)
+{
+	// Applied in the order of their source, not the order the neighbours happened to be generated in. The sort is
+	// stable, so the edits from the same source stay in the order they were made, and the last one to a block wins.
+	stable_sort(pChunkStorage->m_vEdits.begin(), pChunkStorage->m_vEdits.end(), ChunkStorageEdit::LowestSourceFirst);
 
-			for (int y = 0; y < CHUNK_SIZE; y++)
-			{
-				float yPosition = m_position.y + y;
+	for (unsigned int i = 0; i < pChunkStorage->m_vEdits.size(); i++)
+	{
+		const ChunkStorageEdit& edit = pChunkStorage->m_vEdits[i];
+		int x = edit.m_index % CHUNK_SIZE;
+		int y = (edit.m_index / CHUNK_SIZE) % CHUNK_SIZE;
+		int z = edit.m_index / CHUNK_SIZE_SQUARED;
 
-				if (pChunkStorage != NULL && pChunkStorage->m_blockSet[x][y][z] == true)
-				{
-					SetColour(x, y, z, pChunkStorage->m_colour[x][y][z]);
-				}
-				else
-				{
-					if (y + (m_gridY*CHUNK_SIZE) < noiseHeight)
-					{
-						float colorNoise = octave_noise_3d(4.0f, 0.3f, 0.005f, xPosition, yPosition, zPosition);
-						float colorNoiseNormalized = ((colorNoise + 1.0f) * 0.5f);
-
-						float red = 0.65f;
-						float green = 0.80f;
-						float blue = 0.00f;
-						float alpha = 1.0f;
-						BlockType blockType = BlockType_Default;
-
-						m_pBiomeManager->GetChunkColourAndBlockType(xPosition, yPosition, zPosition, noise, colorNoiseNormalized, &red, &green, &blue, &blockType);
-						
-						SetColour(x, y, z, red, green, blue, alpha);
-						SetBlockType(x, y, z, blockType);
-					}
-				}
-			}
+		ApplyStorageEdit(x, y, z, edit.m_colour, edit.m_sourceKey);
+	}
+}
 
-			// Tree generation
-			if (m_gridY >= 0) // Only above ground
-			{
-				// Trees
-				if ((GetRandomNumber(0, 2000) >= 2000))
-				{
-					float minTreeHeight = 0.0f;
-					if (biome == Biome_GrassLand)
-					{
-						minTreeHeight = 0.5f;
-					}
-					else if (biome == Biome_Desert)
-					{
-						minTreeHeight = 0.0f;
-					}
-					else if (biome == Biome_AshLand)
-					{
-						minTreeHeight = 0.25f;
-					}
+void Chunk::ApplyStorageEdit(int x, int y, int z, unsigned int colour, unsigned long long sourceKey)
+{
+	unsigned short index = (unsigned short)(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED);
 
-					if (noiseNormalized >= minTreeHeight)
-					{
-						vec3 treePos = vec3(xPosition, noiseHeight, zPosition);
+	// A neighbour that is generated after us can still write into us, it mustn't overwrite a block from a higher source
+	unsigned long long& blockSource = m_editSources[index];
+	if (blockSource > sourceKey)
+	{
+		return;
+	}
+	blockSource = sourceKey;
 
-						if (biome == Biome_GrassLand)
-						{
-							m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/plains/smalltree.qb", treePos, QubicleImportDirection_Normal);
-						}
-						else if (biome == Biome_Desert)
-						{
-							m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/desert/cactus1.qb", treePos, QubicleImportDirection_Normal);
-						}
-						else if (biome == Biome_Tundra)
-						{
-							m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/tundra/tundra_tree1.qb", treePos, QubicleImportDirection_Normal);
-						}
-						else if (biome == Biome_AshLand)
-						{
-							m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/ashlands/ashtree1.qb", treePos, QubicleImportDirection_Normal);
-						}
-					}
-				}
+	// Same as importing straight into a loaded chunk, the block type comes from the colour
+	SetColour(x, y, z, colour, true);
+}
 
-				// Scenery
-				// TODO : Create scenery using poisson disc and also using instance manager.
-				//if ((GetRandomNumber(0, 1000) >= 995))
-				//{
-				//	if (noiseNormalized >= 0.5f)
-				//	{
-				//		vec3 pos = vec3(xPosition, noiseHeight, zPosition);
-				//		m_pSceneryManager->AddSceneryObject("flower", "media/gamedata/terrain/plains/flower1.qb", pos, vec3(0.0f, 0.0f, 0.0f), QubicleImportDirection_Normal, QubicleImportDirection_Normal, 0.08f, GetRandomNumber(0, 360, 2));
-				//	}
-				//}
-			}
+void Chunk::GenerateTerrain()
+{
+	unsigned int colours[CHUNK_SIZE_CUBED];
+	BlockType blockTypes[CHUNK_SIZE_CUBED];
+	TerrainTreeList vTrees;
+	m_pChunkManager->GetTerrainGenerator()->GenerateChunk(m_gridX, m_gridY, m_gridZ, m_pBiomeManager->GetTerrainVersion(), colours, blockTypes, &vTrees);
+
+	for (int i = 0; i < CHUNK_SIZE_CUBED; i++)
+	{
+		if (colours[i] != 0)
+		{
+			m_blocks.SetBlock(i, colours[i], blockTypes[i]);
 		}
 	}
 
-	// Remove the chunk storage loader since we no longer need it
-	if (pChunkStorage != NULL)
+	// Our trees are imported through the chunk storage, like the ones our neighbours put in us, so they all land in the same order
+	unsigned long long sourceKey = ChunkStorageTable::PackKey(m_gridX, m_gridY, m_gridZ);
+	for (unsigned int i = 0; i < vTrees.size(); i++)
 	{
-		m_pChunkManager->RemoveChunkStorageLoader(pChunkStorage);
-	}
+		const TerrainTree& tree = vTrees[i];
 
-	m_setup = true;
+		if (tree.m_biome == Biome_GrassLand)
+		{
+			m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/plains/smalltree.qb", tree.m_position, QubicleImportDirection_Normal, sourceKey);
+		}
+		else if (tree.m_biome == Biome_Desert)
+		{
+			m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/desert/cactus1.qb", tree.m_position, QubicleImportDirection_Normal, sourceKey);
+		}
+		else if (tree.m_biome == Biome_Tundra)
+		{
+			m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/tundra/tundra_tree1.qb", tree.m_position, QubicleImportDirection_Normal, sourceKey);
+		}
+		else if (tree.m_biome == Biome_AshLand)
+		{
+			m_pChunkManager->ImportQubicleBinary("media/gamedata/terrain/ashlands/ashtree1.qb", tree.m_position, QubicleImportDirection_Normal, sourceKey);
+		}
+	}
 
-	SetNeedsRebuild(true, true);
+	// Scenery
+	// TODO : Create scenery using poisson disc and also using instance manager.
+	//if ((chunkRandom.GetRandomNumber(0, 1000) >= 995))
+	//{
+	//	if (noiseNormalized >= 0.5f)
+	//	{
+	//		vec3 pos = vec3(xPosition, noiseHeight, zPosition);
+	//		m_pSceneryManager->AddSceneryObject("flower", "media/gamedata/terrain/plains/flower1.qb", pos, vec3(0.0f, 0.0f, 0.0f), QubicleImportDirection_Normal, QubicleImportDirection_Normal, 0.08f, chunkRandom.GetRandomNumber(0, 360, 2));
+	//	}
+	//}
 }
 
 bool Chunk::IsSetup()
@@ -313,12 +302,76 @@ bool Chunk::IsUnloading()
 // Saving and loading
 void Chunk::SaveChunk()
 {
-	// TODO : Write Chunk::SaveChunk()
+	if (m_setup == false || m_needsSaving == false)
+	{
+		return;
+	}
+
+	unsigned int colours[CHUNK_SIZE_CUBED];
+	BlockType blockTypes[CHUNK_SIZE_CUBED];
+	m_blocks.GetBlocks(colours, blockTypes);
+
+	// Run length encode the colour and block type data together, chunks are mostly made up of long runs of the same block
+	vector<unsigned int> data;
+	int index = 0;
+	while (index < CHUNK_SIZE_CUBED)
+	{
+		unsigned int colour = colours[index];
+		BlockType blockType = blockTypes[index];
+
+		unsigned int count = 1;
+		while (index + (int)count < CHUNK_SIZE_CUBED && colours[index + count] == colour && blockTypes[index + count] == blockType)
+		{
+			count++;
+		}
+
+		data.push_back(count);
+		data.push_back(colour);
+		data.push_back((unsigned int)blockType);
+
+		index += count;
+	}
+
+	m_pChunkManager->GetRegionFileManager()->SaveChunkData(m_gridX, m_gridY, m_gridZ, data);
+
+	m_needsSaving = false;
 }
 
-void Chunk::LoadChunk()
+bool Chunk::LoadChunk()
 {
-	// TODO : Write Chunk::LoadChunk()
+	vector<unsigned int> data;
+	if (m_pChunkManager->GetRegionFileManager()->LoadChunkData(m_gridX, m_gridY, m_gridZ, &data) == false)
+	{
+		return false;
+	}
+
+	int index = 0;
+	for (unsigned int i = 0; i + 2 < data.size(); i += 3)
+	{
+		unsigned int count = data[i];
+		unsigned int colour = data[i + 1];
+		BlockType blockType = (BlockType)data[i + 2];
+
+		if (index + (int)count > CHUNK_SIZE_CUBED)
+		{
+			break;
+		}
+
+		m_blocks.FillRange(index, count, colour, blockType);
+		index += count;
+	}
+
+	if (index != CHUNK_SIZE_CUBED)
+	{
+		// Corrupt chunk data, clear what we have read and let the chunk be generated instead
+		m_blocks.Fill(0, BlockType_Default);
+
+		return false;
+	}
+
+	m_needsSaving = false;
+
+	return true;
 }
 
 // Position
@@ -436,25 +489,15 @@ void Chunk::StopBatchUpdate()
 {
 	if (m_chunkChangedDuringBatchUpdate)
 	{
-		SetNeedsRebuild(true, true);
+		// The edited region is already stored, the rebuild only remeshes around it and only tells the neighbours that share an edited border
+		m_rebuild = true;
 	}
 }
 
 // Active
 bool Chunk::GetActive(int x, int y, int z)
 {
-	unsigned colour = m_colour[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED];
-	unsigned int alpha = (colour & 0xFF000000) >> 24;
-	unsigned int blue = (colour & 0x00FF0000) >> 16;
-	unsigned int green = (colour & 0x0000FF00) >> 8;
-	unsigned int red = (colour & 0x000000FF);
-
-	if (alpha == 0)
-	{
-		return false;
-	}
-
-	return true;
+	return m_blocks.GetActive(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED);
 }
 
 // Inside chunk
@@ -528,7 +571,7 @@ void Chunk::GetColour(int x, int y, int z, float* r, float* g, float* b, float*
 	if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE)
 		return;
 
-	unsigned int colour = m_colour[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED];
+	unsigned int colour = m_blocks.GetColour(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED);
 	unsigned int alpha = (colour & 0xFF000000) >> 24;
 	unsigned int blue = (colour & 0x00FF0000) >> 16;
 	unsigned int green = (colour & 0x0000FF00) >> 8;
@@ -545,38 +588,64 @@ void Chunk::SetColour(int x, int y, int z, unsigned int colour, bool setBlockTyp
 	if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE)
 		return;
 
-	bool changed = ((m_colour[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED] == colour) == false);
-
-	if (changed)
-	{
-		m_chunkChangedDuringBatchUpdate = true;
-	}
-
-	m_colour[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED] = colour;
+	int index = x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED;
+	bool changed;
 
 	if (setBlockType)
 	{
 		unsigned int blockB = (colour & 0x00FF0000) >> 16;
 		unsigned int blockG = (colour & 0x0000FF00) >> 8;
 		unsigned int blockR = (colour & 0x000000FF);
-		m_blockType[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED] = m_pChunkManager->SetBlockTypeBasedOnColour(blockR, blockG, blockB);
+		BlockType blockType = m_pChunkManager->SetBlockTypeBasedOnColour(blockR, blockG, blockB);
+
+		// Only a colour change marks the chunk as changed, like before the block type was stored with the colour
+		changed = (m_blocks.GetColour(index) != colour);
+		m_blocks.SetBlock(index, colour, blockType);
+	}
+	else
+	{
+		changed = m_blocks.SetColour(index, colour);
+	}
+
+	if (changed)
+	{
+		m_chunkChangedDuringBatchUpdate = true;
+		m_needsSaving = true;
+
+		// Before we are setup our first mesh is a full mesh anyway
+		if (m_setup)
+		{
+			m_dirtyRegionLock.lock();
+			m_editedRegion.AddBlock(x, y, z);
+			m_dirtyRegionLock.unlock();
+		}
 	}
 }
 
 unsigned int Chunk::GetColour(int x, int y, int z)
 {
-	return m_colour[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED];
+	return m_blocks.GetColour(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED);
+}
+
+void Chunk::CopyColours(unsigned int* pColours)
+{
+	m_blocks.GetBlocks(pColours, NULL);
+}
+
+int Chunk::GetBlockMemoryBytes()
+{
+	return m_blocks.GetMemoryBytes();
 }
 
 // Block type
 BlockType Chunk::GetBlockType(int x, int y, int z)
 {
-	return m_blockType[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED];
+	return m_blocks.GetBlockType(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED);
 }
 
 void Chunk::SetBlockType(int x, int y, int z, BlockType blockType)
 {
-	m_blockType[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED] = blockType;
+	m_blocks.SetBlockType(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED, blockType);
 }
 
 // Flags
@@ -726,14 +795,73 @@ void Chunk::UpdateEmptyFlag()
 	}
 }
 
+// Level of detail
+void Chunk::SetLODLevel(int lodLevel)
+{
+	m_lodLevel = lodLevel;
+}
+
+int Chunk::GetLODLevel()
+{
+	return m_lodLevel;
+}
+
+int Chunk::GetMeshLODLevel()
+{
+	return m_meshLODLevel;
+}
+
+int Chunk::GetNumMeshVertices()
+{
+	return m_numMeshVertices;
+}
+
+int Chunk::GetNumMeshTriangles()
+{
+	return m_numMeshTriangles;
+}
+
+int Chunk::GetNumRebuilds()
+{
+	return m_numRebuilds;
+}
+
+int Chunk::GetNumIncrementalRebuilds()
+{
+	return m_numIncrementalRebuilds;
+}
+
 // Create mesh
-void Chunk::CreateMesh()
+void Chunk::CreateMesh(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, bool fullMesh)
 {
+	PROFILE_ZONE("Chunk::CreateMesh");
+
 	if (m_pMesh == NULL)
 	{
 		m_pMesh = m_pRenderer->CreateMesh(OGLMeshType_Textured);
+
+		// Reserve enough space for what our last mesh used, chunks rarely change much between rebuilds
+		m_pRenderer->ReserveMesh(m_numMeshVertices, m_numMeshTriangles, m_pMesh);
+	}
+
+	// Read the level once, the chunk updating thread can change it for the next rebuild while we are meshing
+	int lodLevel = m_lodLevel;
+	m_meshLODLevel = lodLevel;
+	if (lodLevel > 0)
+	{
+		FreeMeshQuadCache();
+		CreateLODMesh(lodLevel);
+		return;
+	}
+
+	if (m_pChunkManager->GetGreedyMeshing())
+	{
+		CreateGreedyMesh(editedRegion, dirtyBorderFaces, fullMesh);
+		return;
 	}
 
+	FreeMeshQuadCache();
+
 	int *l_merged;
 	l_merged = new int[CHUNK_SIZE_CUBED];
 
@@ -1067,12 +1195,138 @@ void Chunk::CreateMesh()
 	}
 
 	// Delete the merged array
-	delete l_merged;
+	delete[] l_merged;
+}
+
+// Greedy meshing
+void Chunk::CreateGreedyMesh(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, bool fullMesh)
+{
+	// Look up the neighbours once, rather than for every block on the chunk border
+	Chunk* pxMinus = m_pChunkManager->GetChunk(m_gridX - 1, m_gridY, m_gridZ);
+	Chunk* pxPlus = m_pChunkManager->GetChunk(m_gridX + 1, m_gridY, m_gridZ);
+	Chunk* pyMinus = m_pChunkManager->GetChunk(m_gridX, m_gridY - 1, m_gridZ);
+	Chunk* pyPlus = m_pChunkManager->GetChunk(m_gridX, m_gridY + 1, m_gridZ);
+	Chunk* pzMinus = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ - 1);
+	Chunk* pzPlus = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ + 1);
+
+	ChunkMesher mesher;
+	mesher.SetupOccupancy(this, pxMinus, pxPlus, pyMinus, pyPlus, pzMinus, pzPlus);
+
+	// Keep the quads, so that the next edit only has to remesh the slices around it
+	bool faceMerging = m_pChunkManager->GetFaceMerging();
+	if (fullMesh || m_pMeshQuadCache == NULL || m_pMeshQuadCache->m_faceMerging != faceMerging)
+	{
+		if (m_pMeshQuadCache == NULL)
+		{
+			m_pMeshQuadCache = new ChunkMeshQuadCache();
+		}
+
+		m_pMeshQuadCache->m_vQuads.reserve(m_numMeshVertices / 4);
+		mesher.CreateQuads(faceMerging, m_pMeshQuadCache);
+	}
+	else
+	{
+		mesher.UpdateQuads(editedRegion, dirtyBorderFaces, m_pMeshQuadCache);
+		m_numIncrementalRebuilds++;
+	}
+
+	const ChunkMeshQuadList& quads = m_pMeshQuadCache->m_vQuads;
+	for (unsigned int i = 0; i < quads.size(); i++)
+	{
+		AddMeshQuad(quads[i]);
+	}
+}
+
+void Chunk::FreeMeshQuadCache()
+{
+	delete m_pMeshQuadCache;
+	m_pMeshQuadCache = NULL;
+}
+
+void Chunk::CreateLODMesh(int lodLevel)
+{
+	unsigned int colours[CHUNK_SIZE_CUBED];
+	CopyColours(colours);
+
+	ChunkMesher mesher;
+	mesher.SetupLODOccupancy(colours, lodLevel);
+
+	// Reduced meshes are always merged, that is most of the saving
+	ChunkMeshQuadList quads;
+	quads.reserve(m_numMeshVertices / 4);
+	mesher.CreateQuads(true, &quads);
+
+	for (unsigned int i = 0; i < quads.size(); i++)
+	{
+		AddMeshQuad(quads[i]);
+	}
+}
+
+void Chunk::AddMeshQuad(const ChunkMeshQuad& quad)
+{
+	// The last block covered by the quad
+	int endX = quad.m_x;
+	int endY = quad.m_y;
+	int endZ = quad.m_z;
+	switch (quad.m_face)
+	{
+	case ChunkMeshFace_Front:
+	case ChunkMeshFace_Back: { endX += quad.m_width - 1; endY += quad.m_height - 1; } break;
+	case ChunkMeshFace_Right:
+	case ChunkMeshFace_Left: { endZ += quad.m_width - 1; endY += quad.m_height - 1; } break;
+	case ChunkMeshFace_Top:
+	case ChunkMeshFace_Bottom: { endX += quad.m_width - 1; endZ += quad.m_height - 1; } break;
+	default: break;
+	}
+
+	// Same corners as the per block mesher, stretched over the merged blocks
+	vec3 p1(quad.m_x - BLOCK_RENDER_SIZE, quad.m_y - BLOCK_RENDER_SIZE, endZ + BLOCK_RENDER_SIZE);
+	vec3 p2(endX + BLOCK_RENDER_SIZE, quad.m_y - BLOCK_RENDER_SIZE, endZ + BLOCK_RENDER_SIZE);
+	vec3 p3(endX + BLOCK_RENDER_SIZE, endY + BLOCK_RENDER_SIZE, endZ + BLOCK_RENDER_SIZE);
+	vec3 p4(quad.m_x - BLOCK_RENDER_SIZE, endY + BLOCK_RENDER_SIZE, endZ + BLOCK_RENDER_SIZE);
+	vec3 p5(endX + BLOCK_RENDER_SIZE, quad.m_y - BLOCK_RENDER_SIZE, quad.m_z - BLOCK_RENDER_SIZE);
+	vec3 p6(quad.m_x - BLOCK_RENDER_SIZE, quad.m_y - BLOCK_RENDER_SIZE, quad.m_z - BLOCK_RENDER_SIZE);
+	vec3 p7(quad.m_x - BLOCK_RENDER_SIZE, endY + BLOCK_RENDER_SIZE, quad.m_z - BLOCK_RENDER_SIZE);
+	vec3 p8(endX + BLOCK_RENDER_SIZE, endY + BLOCK_RENDER_SIZE, quad.m_z - BLOCK_RENDER_SIZE);
+
+	vec3 n1;
+	vec3 c1, c2, c3, c4;
+	switch (quad.m_face)
+	{
+	case ChunkMeshFace_Front: { n1 = vec3(0.0f, 0.0f, 1.0f); c1 = p1; c2 = p2; c3 = p3; c4 = p4; } break;
+	case ChunkMeshFace_Back: { n1 = vec3(0.0f, 0.0f, -1.0f); c1 = p5; c2 = p6; c3 = p7; c4 = p8; } break;
+	case ChunkMeshFace_Right: { n1 = vec3(1.0f, 0.0f, 0.0f); c1 = p2; c2 = p5; c3 = p8; c4 = p3; } break;
+	case ChunkMeshFace_Left: { n1 = vec3(-1.0f, 0.0f, 0.0f); c1 = p6; c2 = p1; c3 = p4; c4 = p7; } break;
+	case ChunkMeshFace_Top: { n1 = vec3(0.0f, 1.0f, 0.0f); c1 = p4; c2 = p3; c3 = p8; c4 = p7; } break;
+	case ChunkMeshFace_Bottom: { n1 = vec3(0.0f, -1.0f, 0.0f); c1 = p6; c2 = p5; c3 = p2; c4 = p1; } break;
+	default: break;
+	}
+
+	float r = (float)((quad.m_colour & 0x000000FF) / 255.0f);
+	float g = (float)(((quad.m_colour & 0x0000FF00) >> 8) / 255.0f);
+	float b = (float)(((quad.m_colour & 0x00FF0000) >> 16) / 255.0f);
+	float a = 1.0f;
+
+	unsigned int v1, v2, v3, v4;
+	v1 = m_pRenderer->AddVertexToMesh(c1, n1, r, g, b, a, m_pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+	v2 = m_pRenderer->AddVertexToMesh(c2, n1, r, g, b, a, m_pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+	v3 = m_pRenderer->AddVertexToMesh(c3, n1, r, g, b, a, m_pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+	v4 = m_pRenderer->AddVertexToMesh(c4, n1, r, g, b, a, m_pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+	m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+	m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 }
 
 void Chunk::CompleteMesh()
 {
+	PROFILE_ZONE("Chunk::CompleteMesh");
+
 	m_pRenderer->FinishMesh(-1, m_pChunkManager->GetChunkMaterialID(), m_pMesh);
+	m_pRenderer->GetMeshInformation(&m_numMeshVertices, &m_numMeshTriangles, m_pMesh);
 
 	UpdateEmptyFlag();
 
@@ -1426,6 +1680,21 @@ void Chunk::UpdateMergedSide(int *merged, int blockx, int blocky, int blockz, in
 // Rebuild
 void Chunk::RebuildMesh()
 {
+	PROFILE_ZONE("Chunk::RebuildMesh");
+
+	// Clear the rebuild flag before we start, so that any edits made while we are building the mesh request another rebuild
+	m_rebuild = false;
+
+	// Take what has changed since the last rebuild, edits made while we are meshing are kept for the next rebuild
+	m_dirtyRegionLock.lock();
+	ChunkMeshRegion editedRegion = m_editedRegion;
+	unsigned int dirtyBorderFaces = m_dirtyBorderFaces;
+	bool fullMesh = m_rebuildFullMesh;
+	m_editedRegion.Reset();
+	m_dirtyBorderFaces = 0;
+	m_rebuildFullMesh = false;
+	m_dirtyRegionLock.unlock();
+
 	m_isRebuildingMesh = true;
 	if (m_pMesh != NULL)
 	{
@@ -1433,7 +1702,7 @@ void Chunk::RebuildMesh()
 		m_pMesh = NULL;
 	}
 
-	CreateMesh();
+	CreateMesh(editedRegion, dirtyBorderFaces, fullMesh);
 
 	// Update our wall flags, so that our neighbors can check if they are surrounded
 	UpdateWallFlags();
@@ -1459,35 +1728,54 @@ void Chunk::RebuildMesh()
 	if (pChunkZPlus != NULL && pChunkZPlus->IsSetup() == true)
 		pChunkZPlus->UpdateSurroundedFlag();
 
-	// Rebuild neighbours
-	if (m_rebuildNeighours)
-	{
-		if (pChunkXMinus != NULL && pChunkXMinus->IsSetup() == true)
-			pChunkXMinus->SetNeedsRebuild(true, false);
-		if (pChunkXPlus != NULL && pChunkXPlus->IsSetup() == true)
-			pChunkXPlus->SetNeedsRebuild(true, false);
-		if (pChunkYMinus != NULL && pChunkYMinus->IsSetup() == true)
-			pChunkYMinus->SetNeedsRebuild(true, false);
-		if (pChunkYPlus != NULL && pChunkYPlus->IsSetup() == true)
-			pChunkYPlus->SetNeedsRebuild(true, false);
-		if (pChunkZMinus != NULL && pChunkZMinus->IsSetup() == true)
-			pChunkZMinus->SetNeedsRebuild(true, false);
-		if (pChunkZPlus != NULL && pChunkZPlus->IsSetup() == true)
-			pChunkZPlus->SetNeedsRebuild(true, false);
+	// Rebuild neighbours, only the border that they share with us can change, and after an edit only if the edit touched that border
+	bool rebuildNeighbours = m_rebuildNeighours;
+	m_rebuildNeighours = false;
 
-		m_rebuildNeighours = false;
-	}
+	if (pChunkXMinus != NULL && pChunkXMinus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_minX == 0))
+		pChunkXMinus->AddDirtyBorderFaces(1 << ChunkMeshFace_Right);
+	if (pChunkXPlus != NULL && pChunkXPlus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_maxX == CHUNK_SIZE - 1))
+		pChunkXPlus->AddDirtyBorderFaces(1 << ChunkMeshFace_Left);
+	if (pChunkYMinus != NULL && pChunkYMinus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_minY == 0))
+		pChunkYMinus->AddDirtyBorderFaces(1 << ChunkMeshFace_Top);
+	if (pChunkYPlus != NULL && pChunkYPlus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_maxY == CHUNK_SIZE - 1))
+		pChunkYPlus->AddDirtyBorderFaces(1 << ChunkMeshFace_Bottom);
+	if (pChunkZMinus != NULL && pChunkZMinus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_minZ == 0))
+		pChunkZMinus->AddDirtyBorderFaces(1 << ChunkMeshFace_Front);
+	if (pChunkZPlus != NULL && pChunkZPlus->IsSetup() == true && (rebuildNeighbours || editedRegion.m_maxZ == CHUNK_SIZE - 1))
+		pChunkZPlus->AddDirtyBorderFaces(1 << ChunkMeshFace_Back);
 
 	m_numRebuilds++;
-	m_rebuild = false;
 }
 
 void Chunk::SetNeedsRebuild(bool rebuild, bool rebuildNeighours)
 {
+	if (rebuild)
+	{
+		m_dirtyRegionLock.lock();
+		m_rebuildFullMesh = true;
+		m_dirtyRegionLock.unlock();
+	}
+
 	m_rebuild = rebuild;
 	m_rebuildNeighours = rebuildNeighours;
 }
 
+void Chunk::AddDirtyBorderFaces(unsigned int faceMask)
+{
+	// Reduced meshes don't look at the neighbours
+	if (m_meshLODLevel > 0 && m_lodLevel == m_meshLODLevel)
+	{
+		return;
+	}
+
+	m_dirtyRegionLock.lock();
+	m_dirtyBorderFaces |= faceMask;
+	m_dirtyRegionLock.unlock();
+
+	m_rebuild = true;
+}
+
 bool Chunk::NeedsRebuild()
 {
 	return m_rebuild;
@@ -1498,6 +1786,16 @@ bool Chunk::IsRebuildingMesh()
 	return m_isRebuildingMesh;
 }
 
+void Chunk::SetJobQueued(bool queued)
+{
+	m_jobQueued = queued;
+}
+
+bool Chunk::IsJobQueued()
+{
+	return m_jobQueued;
+}
+
 void Chunk::SwitchToCachedMesh()
 {
 	m_pCachedMesh = m_pMesh;
@@ -5,10 +5,11 @@
 //
 // Purpose:
 //   A chunk is a collection of voxel blocks that are arranged together for
-//   easier manipulation and management, when a single voxel in a chunk is
-//   modified the whole chunk is refreshed. Chunks are rendered together
-//   as a single vertex buffer and thus each chunk can be considered a single
-//   draw call to render many voxels.
+//   easier manipulation and management. Chunks are rendered together as a
+//   single vertex buffer and thus each chunk can be considered a single
+//   draw call to render many voxels. When a voxel in a chunk is modified the
+//   chunk remembers the region that was edited, and the next rebuild only
+//   remeshes the slices of the chunk that region touches.
 //
 // Revision History:
 //   Initial Revision - 01/11/15
@@ -19,24 +20,85 @@
 #pragma once
 
 #include "BlocksEnum.h"
+#include "ChunkPaletteStorage.h"
 #include "../Renderer/Renderer.h"
 #include "../Renderer/camera.h"
 
 #include <vector>
+#include <atomic>
+#include <unordered_map>
 using namespace std;
 
 #include "../tinythread/tinythread.h"
+#include "../tinythread/fast_mutex.h"
 using namespace tthread;
 
 class ChunkManager;
+class ChunkStorageLoader;
 class Player;
 class SceneryManager;
 class VoxSettings;
 class Item;
 class BiomeManager;
+class ChunkMeshQuad;
+class ChunkMeshQuadCache;
 
 typedef vector<Item*> ItemList;
 
+// The source of the last storage edit to each block, keyed by the block index
+typedef unordered_map<unsigned short, unsigned long long> ChunkEditSourceMap;
+
+// A box of blocks in chunk co-ordinates, INCLUSIVE, that has changed since the chunk was last meshed
+class ChunkMeshRegion
+{
+public:
+	int m_minX;
+	int m_minY;
+	int m_minZ;
+	int m_maxX;
+	int m_maxY;
+	int m_maxZ;
+
+	ChunkMeshRegion()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		m_minX = m_minY = m_minZ = 0x7FFFFFFF;
+		m_maxX = m_maxY = m_maxZ = -1;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_maxX < m_minX;
+	}
+
+	void AddBlock(int x, int y, int z)
+	{
+		AddBox(x, y, z, x, y, z);
+	}
+
+	void AddBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ)
+	{
+		if (minX < m_minX) m_minX = minX;
+		if (minY < m_minY) m_minY = minY;
+		if (minZ < m_minZ) m_minZ = minZ;
+		if (maxX > m_maxX) m_maxX = maxX;
+		if (maxY > m_maxY) m_maxY = maxY;
+		if (maxZ > m_maxZ) m_maxZ = maxZ;
+	}
+
+	void AddRegion(const ChunkMeshRegion& region)
+	{
+		if (region.IsEmpty() == false)
+		{
+			AddBox(region.m_minX, region.m_minY, region.m_minZ, region.m_maxX, region.m_maxY, region.m_maxZ);
+		}
+	}
+};
+
 class Chunk
 {
 public:
@@ -66,7 +128,11 @@ public:
 
 	// Saving and loading
 	void SaveChunk();
-	void LoadChunk();
+	bool LoadChunk();
+
+	// Chunk storage, called by the chunk storage table with its lock held
+	void ApplyChunkStorage(ChunkStorageLoader* pChunkStorage);
+	void ApplyStorageEdit(int x, int y, int z, unsigned int colour, unsigned long long sourceKey);
 
 	// Position
 	void SetPosition(vec3 pos);
@@ -115,6 +181,12 @@ public:
 	void SetColour(int x, int y, int z, unsigned int colour, bool setBlockType = false);
 	unsigned int GetColour(int x, int y, int z);
 
+	// Unpacks all of the block colours, indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED]
+	void CopyColours(unsigned int* pColours);
+
+	// Block storage memory, in bytes
+	int GetBlockMemoryBytes();
+
 	// Block type
 	BlockType GetBlockType(int x, int y, int z);
 	void SetBlockType(int x, int y, int z, BlockType blockType);
@@ -126,16 +198,28 @@ public:
 	bool UpdateSurroundedFlag();
 	void UpdateEmptyFlag();
 
+	// Level of detail, set before the mesh is rebuilt
+	void SetLODLevel(int lodLevel);
+	int GetLODLevel();
+	int GetMeshLODLevel();
+	int GetNumMeshVertices();
+	int GetNumMeshTriangles();
+	int GetNumRebuilds();
+	int GetNumIncrementalRebuilds();
+
 	// Create mesh
-	void CreateMesh();
+	void CreateMesh(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, bool fullMesh);
 	void CompleteMesh();
 	void UpdateMergedSide(int *merged, int blockx, int blocky, int blockz, int width, int height, vec3 *p1, vec3 *p2, vec3 *p3, vec3 *p4, int startX, int startY, int maxX, int maxY, bool positive, bool zFace, bool xFace, bool yFace);
 
 	// Rebuild
 	void RebuildMesh();
 	void SetNeedsRebuild(bool rebuild, bool rebuildNeighours);
+	void AddDirtyBorderFaces(unsigned int faceMask);
 	bool NeedsRebuild();
 	bool IsRebuildingMesh();
+	void SetJobQueued(bool queued);
+	bool IsJobQueued();
 	void SwitchToCachedMesh();
 	void UndoCachedMesh();
 
@@ -156,6 +240,13 @@ protected:
 
 private:
 	/* Private methods */
+	void GenerateTerrain();
+
+	// Greedy meshing
+	void CreateGreedyMesh(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, bool fullMesh);
+	void CreateLODMesh(int lodLevel);
+	void FreeMeshQuadCache();
+	void AddMeshQuad(const ChunkMeshQuad& quad);
 
 public:
 	/* Public members */
@@ -205,9 +296,30 @@ private:
 	bool m_rebuildNeighours;
 	bool m_isRebuildingMesh;
 	bool m_deleteCachedMesh;
+	bool m_needsSaving;
+
+	// Set by the updating thread when it queues a setup or rebuild job for us, and cleared by the job when it is done with us
+	std::atomic<bool> m_jobQueued;
+
+	// What changed since the last rebuild: the blocks that were edited, the border faces (1 << ChunkMeshFace) that edits in the
+	// neighbours can change, and whether the whole mesh needs rebuilding
+	tthread::fast_mutex m_dirtyRegionLock;
+	ChunkMeshRegion m_editedRegion;
+	unsigned int m_dirtyBorderFaces;
+	bool m_rebuildFullMesh;
+
+	// The quads of the last greedy mesh, NULL when the last mesh was built some other way
+	ChunkMeshQuadCache* m_pMeshQuadCache;
 
 	// Counters
 	int m_numRebuilds;
+	int m_numIncrementalRebuilds;
+	int m_numMeshVertices;
+	int m_numMeshTriangles;
+
+	// Level of detail, the one we want and the one the current mesh was built at
+	int m_lodLevel;
+	int m_meshLODLevel;
 
 	// Flags for empty chunk and completely surrounded
 	bool m_emptyChunk;
@@ -221,11 +333,11 @@ private:
 	bool m_z_minus_full;
 	bool m_z_plus_full;
 
-	// The blocks colour data
-	unsigned int *m_colour;
+	// The blocks colour and block type data
+	ChunkPaletteStorage m_blocks;
 
-	// Block type
-	BlockType *m_blockType;
+	// Which source wrote the blocks that came from storage edits, so an edit that arrives late still only wins over lower sources
+	ChunkEditSourceMap m_editSources;
 
 	// Item list
 	tthread::mutex m_itemMutexLock;
@@ -0,0 +1,130 @@
+// ******************************************************************************
+// Filename:    ChunkColumnCache.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ChunkColumnCache.h"
+
+
+ChunkColumnCache::ChunkColumnCache()
+{
+	m_maxColumns = 256;
+
+	m_numCacheHits = 0;
+	m_numCacheMisses = 0;
+}
+
+ChunkColumnCache::~ChunkColumnCache()
+{
+	ClearColumns();
+}
+
+void ChunkColumnCache::ClearColumns()
+{
+	m_columnsLock.lock();
+	for (ChunkColumnList::iterator it = m_vpColumnList.begin(); it != m_vpColumnList.end(); it++)
+	{
+		delete *it;
+	}
+	m_vpColumnList.clear();
+	m_columnMap.clear();
+	m_columnsLock.unlock();
+}
+
+void ChunkColumnCache::SetMaxColumns(int maxColumns)
+{
+	m_columnsLock.lock();
+	m_maxColumns = maxColumns;
+	if (m_maxColumns < 1)
+	{
+		m_maxColumns = 1;
+	}
+	EvictColumns();
+	m_columnsLock.unlock();
+}
+
+int ChunkColumnCache::GetMaxColumns()
+{
+	return m_maxColumns;
+}
+
+bool ChunkColumnCache::GetColumn(int gridX, int gridZ, int terrainVersion, ChunkColumn* pColumn)
+{
+	m_columnsLock.lock();
+
+	ChunkColumnMap::iterator it = m_columnMap.find(make_pair(gridX, gridZ));
+	if (it == m_columnMap.end() || (*it->second)->m_terrainVersion != terrainVersion)
+	{
+		m_numCacheMisses++;
+		m_columnsLock.unlock();
+
+		return false;
+	}
+
+	// Move to the front of the list, as the most recently used
+	m_vpColumnList.splice(m_vpColumnList.begin(), m_vpColumnList, it->second);
+
+	*pColumn = *(*it->second);
+	m_numCacheHits++;
+
+	m_columnsLock.unlock();
+
+	return true;
+}
+
+void ChunkColumnCache::AddColumn(const ChunkColumn& column)
+{
+	m_columnsLock.lock();
+
+	// Another worker might have added the same column while we were making ours, just replace it
+	ChunkColumnMap::iterator it = m_columnMap.find(make_pair(column.m_gridX, column.m_gridZ));
+	if (it != m_columnMap.end())
+	{
+		*(*it->second) = column;
+		m_vpColumnList.splice(m_vpColumnList.begin(), m_vpColumnList, it->second);
+	}
+	else
+	{
+		m_vpColumnList.push_front(new ChunkColumn(column));
+		m_columnMap[make_pair(column.m_gridX, column.m_gridZ)] = m_vpColumnList.begin();
+
+		EvictColumns();
+	}
+
+	m_columnsLock.unlock();
+}
+
+// Counters
+int ChunkColumnCache::GetNumColumns()
+{
+	return (int)m_columnMap.size();
+}
+
+int ChunkColumnCache::GetNumCacheHits()
+{
+	return m_numCacheHits;
+}
+
+int ChunkColumnCache::GetNumCacheMisses()
+{
+	return m_numCacheMisses;
+}
+
+void ChunkColumnCache::EvictColumns()
+{
+	// Throw away the least recently used columns, the caller must hold the lock
+	while ((int)m_vpColumnList.size() > m_maxColumns)
+	{
+		ChunkColumn* pColumn = m_vpColumnList.back();
+		m_columnMap.erase(make_pair(pColumn->m_gridX, pColumn->m_gridZ));
+		m_vpColumnList.pop_back();
+
+		delete pColumn;
+	}
+}
@@ -0,0 +1,100 @@
+// ******************************************************************************
+// Filename:    ChunkColumnCache.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The terrain data that only depends on the x and z of a block (the landscape
+//   noise, heightmap, biome and the town and mountain multipliers) worked out
+//   once per chunk column, and shared by all of the chunks stacked in that
+//   column. The cache keeps the most recently used columns, the least recently
+//   used column is thrown away once the cache is full.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "Chunk.h"
+#include "BiomeManager.h"
+
+#include <list>
+#include <map>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+class ChunkColumn
+{
+public:
+	int m_gridX;
+	int m_gridZ;
+
+	// The biome manager's terrain version the column was made with
+	int m_terrainVersion;
+
+	// Per block column, indexed [x + z*CHUNK_SIZE]
+	float m_landscapeNoise[Chunk::CHUNK_SIZE_SQUARED];
+	float m_mountainMultiplier[Chunk::CHUNK_SIZE_SQUARED];
+	float m_townMultiplier[Chunk::CHUNK_SIZE_SQUARED];
+	float m_noiseHeight[Chunk::CHUNK_SIZE_SQUARED];
+	Biome m_biome[Chunk::CHUNK_SIZE_SQUARED];
+
+	float m_maxNoiseHeight;
+};
+
+typedef list<ChunkColumn*> ChunkColumnList;
+typedef map<pair<int, int>, ChunkColumnList::iterator> ChunkColumnMap;
+
+
+class ChunkColumnCache
+{
+public:
+	/* Public methods */
+	ChunkColumnCache();
+	~ChunkColumnCache();
+
+	void ClearColumns();
+
+	void SetMaxColumns(int maxColumns);
+	int GetMaxColumns();
+
+	// Copies the cached column into pColumn, returns false if it isn't cached or was made with an older terrain version
+	bool GetColumn(int gridX, int gridZ, int terrainVersion, ChunkColumn* pColumn);
+	void AddColumn(const ChunkColumn& column);
+
+	// Counters
+	int GetNumColumns();
+	int GetNumCacheHits();
+	int GetNumCacheMisses();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void EvictColumns();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	tthread::mutex m_columnsLock;
+
+	// Most recently used at the front
+	ChunkColumnList m_vpColumnList;
+	ChunkColumnMap m_columnMap;
+
+	int m_maxColumns;
+
+	// Counters
+	int m_numCacheHits;
+	int m_numCacheMisses;
+};
@@ -0,0 +1,273 @@
+// ******************************************************************************
+// Filename:    ChunkHashTable.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ChunkHashTable.h"
+#include "../tinythread/tinythread.h"
+
+
+ChunkHashTable::ChunkHashTable()
+{
+	m_numUsedSlots = 0;
+	m_numChunks = 0;
+
+	m_generation.store(0);
+	m_numReaders[0].store(0);
+	m_numReaders[1].store(0);
+
+	m_pTableData.store(CreateTableData(MIN_CAPACITY));
+}
+
+ChunkHashTable::~ChunkHashTable()
+{
+	DeleteTableData(m_pTableData.load());
+	m_pTableData.store(NULL);
+}
+
+// Lock free
+Chunk* ChunkHashTable::Find(int x, int y, int z)
+{
+	// Register as a reader of the current generation. If a rehash moved on before we were counted it might not wait
+	// for us, so try again in the new generation.
+	unsigned int generation;
+	while (true)
+	{
+		generation = m_generation.load(std::memory_order_seq_cst);
+		m_numReaders[generation & 1].fetch_add(1, std::memory_order_seq_cst);
+		if (m_generation.load(std::memory_order_seq_cst) == generation)
+		{
+			break;
+		}
+		m_numReaders[generation & 1].fetch_sub(1, std::memory_order_release);
+	}
+
+	ChunkHashTableData* pTableData = m_pTableData.load(std::memory_order_acquire);
+
+	unsigned long long key = PackKey(x, y, z);
+	int mask = pTableData->m_capacity - 1;
+	int index = HashKey(key) & mask;
+
+	Chunk* pChunk = NULL;
+	for (int i = 0; i < pTableData->m_capacity; i++)
+	{
+		ChunkHashTableSlot* pSlot = &pTableData->m_pSlots[index];
+		unsigned long long slotKey = pSlot->m_key.load(std::memory_order_acquire);
+
+		if (slotKey == key)
+		{
+			pChunk = pSlot->m_pChunk.load(std::memory_order_acquire);
+			break;
+		}
+		if (slotKey == EMPTY_KEY)
+		{
+			break;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	m_numReaders[generation & 1].fetch_sub(1, std::memory_order_release);
+
+	return pChunk;
+}
+
+// Writing
+void ChunkHashTable::Insert(int x, int y, int z, Chunk* pChunk)
+{
+	ChunkHashTableData* pTableData = m_pTableData.load(std::memory_order_relaxed);
+
+	// Keep the table at most half full, removed chunks still use up their slot until we rehash
+	if ((m_numUsedSlots + 1) * 2 > pTableData->m_capacity)
+	{
+		int newCapacity = MIN_CAPACITY;
+		while (newCapacity < (m_numChunks + 1) * 4)
+		{
+			newCapacity *= 2;
+		}
+
+		Rehash(newCapacity);
+		pTableData = m_pTableData.load(std::memory_order_relaxed);
+	}
+
+	unsigned long long key = PackKey(x, y, z);
+	int mask = pTableData->m_capacity - 1;
+	int index = HashKey(key) & mask;
+
+	while (true)
+	{
+		ChunkHashTableSlot* pSlot = &pTableData->m_pSlots[index];
+		unsigned long long slotKey = pSlot->m_key.load(std::memory_order_relaxed);
+
+		if (slotKey == key)
+		{
+			if (pSlot->m_pChunk.load(std::memory_order_relaxed) == NULL)
+			{
+				m_numChunks++;
+			}
+			pSlot->m_pChunk.store(pChunk, std::memory_order_release);
+
+			return;
+		}
+		if (slotKey == EMPTY_KEY)
+		{
+			// Set the chunk before the key, so that a reader that finds the key always sees the chunk
+			pSlot->m_pChunk.store(pChunk, std::memory_order_relaxed);
+			pSlot->m_key.store(key, std::memory_order_release);
+
+			m_numUsedSlots++;
+			m_numChunks++;
+
+			return;
+		}
+
+		index = (index + 1) & mask;
+	}
+}
+
+bool ChunkHashTable::Remove(int x, int y, int z)
+{
+	ChunkHashTableData* pTableData = m_pTableData.load(std::memory_order_relaxed);
+
+	unsigned long long key = PackKey(x, y, z);
+	int mask = pTableData->m_capacity - 1;
+	int index = HashKey(key) & mask;
+
+	for (int i = 0; i < pTableData->m_capacity; i++)
+	{
+		ChunkHashTableSlot* pSlot = &pTableData->m_pSlots[index];
+		unsigned long long slotKey = pSlot->m_key.load(std::memory_order_relaxed);
+
+		if (slotKey == key)
+		{
+			if (pSlot->m_pChunk.load(std::memory_order_relaxed) == NULL)
+			{
+				return false;
+			}
+
+			pSlot->m_pChunk.store(NULL, std::memory_order_release);
+			m_numChunks--;
+
+			return true;
+		}
+		if (slotKey == EMPTY_KEY)
+		{
+			return false;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return false;
+}
+
+// Iterating over the slots
+int ChunkHashTable::GetCapacity()
+{
+	return m_pTableData.load(std::memory_order_relaxed)->m_capacity;
+}
+
+Chunk* ChunkHashTable::GetSlotChunk(int index)
+{
+	return m_pTableData.load(std::memory_order_relaxed)->m_pSlots[index].m_pChunk.load(std::memory_order_relaxed);
+}
+
+int ChunkHashTable::GetNumChunks()
+{
+	return m_numChunks;
+}
+
+unsigned long long ChunkHashTable::PackKey(int x, int y, int z)
+{
+	// 21 bits for each grid co-ordinate, the top bit is never set so a packed key can't be the empty key
+	unsigned long long packedX = (unsigned long long)(x & 0x1FFFFF);
+	unsigned long long packedY = (unsigned long long)(y & 0x1FFFFF);
+	unsigned long long packedZ = (unsigned long long)(z & 0x1FFFFF);
+
+	return (packedX << 42) | (packedY << 21) | packedZ;
+}
+
+unsigned int ChunkHashTable::HashKey(unsigned long long key)
+{
+	// Fibonacci hashing, spreads neighbouring grid co-ordinates across the whole table
+	return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+ChunkHashTableData* ChunkHashTable::CreateTableData(int capacity)
+{
+	ChunkHashTableData* pTableData = new ChunkHashTableData();
+	pTableData->m_capacity = capacity;
+	pTableData->m_pSlots = new ChunkHashTableSlot[capacity];
+
+	for (int i = 0; i < capacity; i++)
+	{
+		pTableData->m_pSlots[i].m_key.store(EMPTY_KEY, std::memory_order_relaxed);
+		pTableData->m_pSlots[i].m_pChunk.store(NULL, std::memory_order_relaxed);
+	}
+
+	return pTableData;
+}
+
+void ChunkHashTable::DeleteTableData(ChunkHashTableData* pTableData)
+{
+	if (pTableData != NULL)
+	{
+		delete[] pTableData->m_pSlots;
+		delete pTableData;
+	}
+}
+
+void ChunkHashTable::Rehash(int capacity)
+{
+	ChunkHashTableData* pOldTableData = m_pTableData.load(std::memory_order_relaxed);
+	ChunkHashTableData* pNewTableData = CreateTableData(capacity);
+
+	// Copy across the loaded chunks, dropping the slots of removed chunks
+	int mask = capacity - 1;
+	int numUsedSlots = 0;
+	for (int i = 0; i < pOldTableData->m_capacity; i++)
+	{
+		unsigned long long key = pOldTableData->m_pSlots[i].m_key.load(std::memory_order_relaxed);
+		Chunk* pChunk = pOldTableData->m_pSlots[i].m_pChunk.load(std::memory_order_relaxed);
+
+		if (key == EMPTY_KEY || pChunk == NULL)
+		{
+			continue;
+		}
+
+		int index = HashKey(key) & mask;
+		while (pNewTableData->m_pSlots[index].m_key.load(std::memory_order_relaxed) != EMPTY_KEY)
+		{
+			index = (index + 1) & mask;
+		}
+
+		pNewTableData->m_pSlots[index].m_key.store(key, std::memory_order_relaxed);
+		pNewTableData->m_pSlots[index].m_pChunk.store(pChunk, std::memory_order_relaxed);
+		numUsedSlots++;
+	}
+
+	// Publish the new table, readers that already loaded the old one can keep using it
+	m_pTableData.store(pNewTableData, std::memory_order_seq_cst);
+	m_numUsedSlots = numUsedSlots;
+
+	// Readers from now on find the new table, once the ones from the old generation are done the old table can go
+	unsigned int oldGeneration = m_generation.fetch_add(1, std::memory_order_seq_cst);
+	WaitForReaders(oldGeneration);
+
+	DeleteTableData(pOldTableData);
+}
+
+void ChunkHashTable::WaitForReaders(unsigned int generation)
+{
+	// Finds are only a few probes long, so this is short unless a reader thread was descheduled
+	while (m_numReaders[generation & 1].load(std::memory_order_acquire) != 0)
+	{
+		tthread::this_thread::yield();
+	}
+}
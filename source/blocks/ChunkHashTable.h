@@ -0,0 +1,94 @@
+// ******************************************************************************
+// Filename:    ChunkHashTable.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   An open addressing hash table of loaded chunks, keyed by the packed chunk
+//   grid co-ordinates. Finding a chunk never takes a lock, so the collision,
+//   meshing and particle code can look up chunks per block without fighting
+//   the chunk updating thread. Adding and removing chunks must be serialised
+//   by the caller.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+
+class Chunk;
+
+class ChunkHashTableSlot
+{
+public:
+	// A slot's key never changes once it has been set, removing a chunk just clears the chunk pointer
+	std::atomic<unsigned long long> m_key;
+	std::atomic<Chunk*> m_pChunk;
+};
+
+class ChunkHashTableData
+{
+public:
+	int m_capacity;
+	ChunkHashTableSlot* m_pSlots;
+};
+
+
+class ChunkHashTable
+{
+public:
+	/* Public methods */
+	ChunkHashTable();
+	~ChunkHashTable();
+
+	// Lock free
+	Chunk* Find(int x, int y, int z);
+
+	// Writing, must be serialised by the caller
+	void Insert(int x, int y, int z, Chunk* pChunk);
+	bool Remove(int x, int y, int z);
+
+	// Iterating over the slots, must be serialised with writing
+	int GetCapacity();
+	Chunk* GetSlotChunk(int index);
+
+	int GetNumChunks();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	static unsigned long long PackKey(int x, int y, int z);
+	static unsigned int HashKey(unsigned long long key);
+
+	ChunkHashTableData* CreateTableData(int capacity);
+	void DeleteTableData(ChunkHashTableData* pTableData);
+	void Rehash(int capacity);
+	void WaitForReaders(unsigned int generation);
+
+public:
+	/* Public members */
+	static const unsigned long long EMPTY_KEY = 0xFFFFFFFFFFFFFFFFULL;
+	static const int MIN_CAPACITY = 1024;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	std::atomic<ChunkHashTableData*> m_pTableData;
+
+	// Readers register in the count for the current generation before they load the table. A rehash moves on to the
+	// next generation and waits for the count of the old one to drain, then nobody can still be probing the old table.
+	std::atomic<unsigned int> m_generation;
+	std::atomic<int> m_numReaders[2];
+
+	int m_numUsedSlots;
+	int m_numChunks;
+};
@@ -19,7 +19,9 @@
 #include "../VoxSettings.h"
 #include "../VoxGame.h"
 #include "../utils/Random.h"
+#include "../utils/TimeUtils.h"
 #include "../models/QubicleBinaryManager.h"
+#include "../utils/Profiler.h"
 
 #include <algorithm>
 
@@ -57,6 +59,28 @@ ChunkManager::ChunkManager(Renderer* pRenderer, VoxSettings* pVoxSettings, Qubic
 	// Loader radius
 	m_loaderRadius = m_pVoxSettings->m_loaderRadius;
 
+	// World generation seed, each seed samples the terrain noise from a different offset. Seed 0 is the original world.
+	m_worldSeed = m_pVoxSettings->m_worldSeed;
+
+	// Region files, a folder for each world and seed so that saved chunks never get mixed into a different world
+	char regionFolder[256];
+	sprintf(regionFolder, "saves/%s_%u", m_pVoxSettings->m_worldName.c_str(), m_worldSeed);
+	m_pRegionFileManager = new RegionFileManager(regionFolder);
+
+	// Chunk columns, sized to the loader radius
+	m_pChunkColumnCache = new ChunkColumnCache();
+	UpdateChunkColumnCacheSize();
+
+	// Terrain generation, the biomes come from the biome manager
+	m_terrainGenerator.SetWorldSeed(m_worldSeed);
+	m_terrainGenerator.SetLandscape(m_pVoxSettings->m_landscapeOctaves, m_pVoxSettings->m_landscapePersistence, m_pVoxSettings->m_landscapeScale);
+	m_terrainGenerator.SetMountains(m_pVoxSettings->m_mountainOctaves, m_pVoxSettings->m_mountainPersistence, m_pVoxSettings->m_mountainScale, m_pVoxSettings->m_mountainMultiplier);
+	m_terrainGenerator.SetBiomeFunctions(_GetTerrainBiome, _GetTerrainTownMultiplier, _GetTerrainBlockColour, this);
+	m_terrainGenerator.SetColumnCache(m_pChunkColumnCache);
+
+	// Qubicle templates
+	m_pQubicleTemplateCache = new QubicleTemplateCache();
+
 	// Water
 	m_waterHeight = 0.0f;
 
@@ -67,12 +91,26 @@ ChunkManager::ChunkManager(Renderer* pRenderer, VoxSettings* pVoxSettings, Qubic
 	// Rendering modes
 	m_wireframeRender = false;
 	m_faceMerging = true;
+	m_greedyMeshing = m_pVoxSettings->m_greedyMeshing;
+
+	// Level of detail
+	m_chunkLOD = m_pVoxSettings->m_chunkLOD;
+	m_lodDistance = m_pVoxSettings->m_chunkLODDistance;
 
 	// Chunk counters
 	m_numChunksLoaded = 0;
 	m_numChunksRender = 0;
+	for (int i = 0; i < ChunkMesher::NUM_LOD_LEVELS; i++)
+	{
+		m_numChunksRenderLOD[i] = 0;
+		m_numTrianglesRenderLOD[i] = 0;
+	}
+	m_numChunksGenerated = 0;
+	m_chunkGenerationTime = 0.0;
+	m_generationStartTime = 0.0;
 
 	// Threading
+	m_pChunkJobPool = new JobPool(m_pVoxSettings->m_chunkWorkerThreads);
 	m_updateThreadActive = true;
 	m_updateThreadFinished = false;
 	m_pUpdatingChunksThread = new thread(_UpdatingChunksThread, this);
@@ -106,6 +144,20 @@ ChunkManager::~ChunkManager()
 #else
 	usleep(200000);
 #endif
+
+	delete m_pChunkJobPool;
+	m_pChunkJobPool = NULL;
+
+	// Save out the chunks that are still loaded, deleting the region file manager waits for all the writes to finish
+	SaveAllChunks();
+	delete m_pRegionFileManager;
+	m_pRegionFileManager = NULL;
+
+	delete m_pQubicleTemplateCache;
+	m_pQubicleTemplateCache = NULL;
+
+	delete m_pChunkColumnCache;
+	m_pChunkColumnCache = NULL;
 }
 
 // Linkage
@@ -169,10 +221,42 @@ int ChunkManager::GetNumChunksRender()
 	return m_numChunksRender;
 }
 
+int ChunkManager::GetNumChunksRenderLOD(int lodLevel)
+{
+	return m_numChunksRenderLOD[lodLevel];
+}
+
+int ChunkManager::GetNumTrianglesRenderLOD(int lodLevel)
+{
+	return m_numTrianglesRenderLOD[lodLevel];
+}
+
+int ChunkManager::GetNumChunksGenerated()
+{
+	return m_numChunksGenerated;
+}
+
+float ChunkManager::GetChunksPerSecond()
+{
+	if (m_chunkGenerationTime <= 0.0)
+	{
+		return 0.0f;
+	}
+
+	return (float)(m_numChunksGenerated / m_chunkGenerationTime);
+}
+
+int ChunkManager::GetNumChunkWorkers()
+{
+	return m_pChunkJobPool->GetNumWorkers();
+}
+
 // Loader radius
 void ChunkManager::SetLoaderRadius(float radius)
 {
 	m_loaderRadius = radius;
+
+	UpdateChunkColumnCacheSize();
 }
 
 float ChunkManager::GetLoaderRadius()
@@ -193,6 +277,15 @@ void ChunkManager::StepNextUpdate()
 
 // Chunk Creation
 void ChunkManager::CreateNewChunk(int x, int y, int z)
+{
+	Chunk* pNewChunk = AllocateNewChunk(x, y, z);
+
+	_SetupChunkJob(pNewChunk);
+
+	UpdateChunkNeighbours(pNewChunk, x, y, z);
+}
+
+Chunk* ChunkManager::AllocateNewChunk(int x, int y, int z)
 {
 	ChunkCoordKeys coordKeys;
 	coordKeys.x = x;
@@ -212,17 +305,20 @@ void ChunkManager::CreateNewChunk(int x, int y, int z)
 	pNewChunk->SetPosition(vec3(xPos, yPos, zPos));
 	pNewChunk->SetGrid(coordKeys.x, coordKeys.y, coordKeys.z);
 
+	// Far chunks start at their level of detail, so they don't get meshed twice
+	if (m_chunkLOD && m_pPlayer != NULL)
+	{
+		vec3 chunkCenter = vec3(xPos, yPos, zPos) + vec3(Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE, Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE, Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE);
+		float lengthValue = length(chunkCenter - m_pPlayer->GetCenter());
+		pNewChunk->SetLODLevel(ChunkMesher::SelectLODLevel(lengthValue, 0, m_lodDistance, 0.0f));
+	}
+
+	// Add to the map before setup, so that the chunk isn't created again while it is being generated
 	m_ChunkMapMutexLock.lock();
-	m_chunksMap[coordKeys] = pNewChunk;
+	m_chunksTable.Insert(coordKeys.x, coordKeys.y, coordKeys.z, pNewChunk);
 	m_ChunkMapMutexLock.unlock();
 
-	pNewChunk->Setup();
-	pNewChunk->SetNeedsRebuild(false, true);
-	pNewChunk->RebuildMesh();
-	pNewChunk->CompleteMesh();
-	pNewChunk->SetCreated(true);
-
-	UpdateChunkNeighbours(pNewChunk, x, y, z);
+	return pNewChunk;
 }
 
 void ChunkManager::UpdateChunkNeighbours(Chunk* pChunk, int x, int y, int z)
@@ -361,12 +457,13 @@ void ChunkManager::UnloadChunk(Chunk* pChunk)
 		}
 	}
 
-	// Remove from map
+	// Remove from map, and from the visible lists that the render passes use
 	m_ChunkMapMutexLock.lock();
-	map<ChunkCoordKeys, Chunk*>::iterator it = m_chunksMap.find(coordKeys);
-	if (it != m_chunksMap.end())
+	m_chunksTable.Remove(coordKeys.x, coordKeys.y, coordKeys.z);
+	for (int i = 0; i < RenderPass_NumPasses; i++)
 	{
-		m_chunksMap.erase(coordKeys);
+		ChunkList& vpVisibleChunks = m_vpVisibleChunks[i];
+		vpVisibleChunks.erase(remove(vpVisibleChunks.begin(), vpVisibleChunks.end(), pChunk), vpVisibleChunks.end());
 	}
 	m_ChunkMapMutexLock.unlock();
 
@@ -393,11 +490,74 @@ void ChunkManager::UnloadChunk(Chunk* pChunk)
 	}
 	m_updateThreadFlagLock.unlock();
 
-	// Unload and delete
+	// Edits that are imported into us from now on are stored, so they aren't lost after we save
+	m_chunkStorageTable.RemoveChunk(pChunk);
+
+	// Save, unload and delete
+	pChunk->SaveChunk();
 	pChunk->Unload();
 	delete pChunk;
 }
 
+// Chunk saving and loading
+RegionFileManager* ChunkManager::GetRegionFileManager()
+{
+	return m_pRegionFileManager;
+}
+
+void ChunkManager::SaveAllChunks()
+{
+	m_ChunkMapMutexLock.lock();
+	for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
+	{
+		Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
+
+		if (pChunk != NULL)
+		{
+			pChunk->SaveChunk();
+		}
+	}
+	m_ChunkMapMutexLock.unlock();
+}
+
+// World generation seed
+unsigned int ChunkManager::GetWorldSeed()
+{
+	return m_worldSeed;
+}
+
+// Terrain generation
+TerrainGenerator* ChunkManager::GetTerrainGenerator()
+{
+	return &m_terrainGenerator;
+}
+
+Biome ChunkManager::_GetTerrainBiome(void* pData, float xPosition, float zPosition)
+{
+	ChunkManager* pChunkManager = (ChunkManager*)pData;
+
+	return pChunkManager->m_pBiomeManager->GetBiome(vec3(xPosition, 0.0f, zPosition));
+}
+
+float ChunkManager::_GetTerrainTownMultiplier(void* pData, float xPosition, float zPosition)
+{
+	ChunkManager* pChunkManager = (ChunkManager*)pData;
+
+	return pChunkManager->m_pBiomeManager->GetTowMultiplier(vec3(xPosition, 0.0f, zPosition));
+}
+
+void ChunkManager::_GetTerrainBlockColour(void* pData, Biome biome, float noise, float colourNoise, float *r, float *g, float *b, BlockType *blockType)
+{
+	ChunkManager* pChunkManager = (ChunkManager*)pData;
+
+	pChunkManager->m_pBiomeManager->GetChunkColourAndBlockType(biome, noise, colourNoise, r, g, b, blockType);
+}
+
+ChunkColumnCache* ChunkManager::GetChunkColumnCache()
+{
+	return m_pChunkColumnCache;
+}
+
 // Getting chunk and positional information
 void ChunkManager::GetGridFromPosition(vec3 position, int* gridX, int* gridY, int* gridZ)
 {
@@ -431,53 +591,27 @@ Chunk* ChunkManager::GetChunkFromPosition(float posX, float posY, float posZ)
 
 Chunk* ChunkManager::GetChunk(int aX, int aY, int aZ)
 {
-	ChunkCoordKeys chunkKey;
-	chunkKey.x = aX;
-	chunkKey.y = aY;
-	chunkKey.z = aZ;
-
-	m_ChunkMapMutexLock.lock();
-	map<ChunkCoordKeys, Chunk*>::iterator it = m_chunksMap.find(chunkKey);
-	if (it != m_chunksMap.end())
-	{
-		Chunk* lpReturn = m_chunksMap[chunkKey];
-		m_ChunkMapMutexLock.unlock();
-		return lpReturn;
-	}
-	m_ChunkMapMutexLock.unlock();
-
-	return NULL;
+	// Lock free lookup, this is called per block from collision, meshing and particles
+	return m_chunksTable.Find(aX, aY, aZ);
 }
 
 bool ChunkManager::FindClosestFloor(vec3 position, vec3* floorPosition)
 {
-	int blockX, blockY, blockZ;
-	vec3 blockPos;
+	// Straight down from half a block below the position, for just under 50 blocks
+	vec3 startPos = position - vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f);
+	float maxDistance = Chunk::BLOCK_RENDER_SIZE * 98.0f;
 
-	bool collides = false;
-	int iterations = 1;
-	while (collides == false && iterations < 100)
+	VoxelRayHit hit;
+	if (RayCast(startPos, vec3(0.0f, -1.0f, 0.0f), maxDistance, &hit, true))
 	{
-		vec3 testPos = position - (vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f) * (float)iterations);
-
-		Chunk* pChunk = NULL;
-		bool active = GetBlockActiveFrom3DPosition(testPos.x, testPos.y, testPos.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
+		*floorPosition = hit.m_blockPosition + vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f);
+		(*floorPosition).x = position.x;
+		(*floorPosition).z = position.z;
 
-		if (pChunk != NULL && pChunk->IsSetup() && pChunk->NeedsRebuild() == false && active == true)
-		{
-			collides = true;
-
-			*floorPosition = blockPos + vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f);
-			(*floorPosition).x = position.x;
-			(*floorPosition).z = position.z;
-
-			return true;
-		}
-
-		iterations++;
+		return true;
 	}
 
-	return collides;
+	return false;
 }
 
 // Getting the active block state given a position and chunk information
@@ -548,6 +682,50 @@ bool ChunkManager::GetBlockActiveFrom3DPosition(float x, float y, float z, vec3
 	return (*pChunk)->GetActive((*blockX), (*blockY), (*blockZ));
 }
 
+bool ChunkManager::RayCast(vec3 origin, vec3 direction, float maxDistance, VoxelRayHit* pHit, bool onlyReadyChunks)
+{
+	if (onlyReadyChunks)
+	{
+		return VoxelRayCast::Cast(origin, direction, maxDistance, _GetReadyRayChunk, _GetRayBlock, this, pHit);
+	}
+
+	return VoxelRayCast::Cast(origin, direction, maxDistance, _GetRayChunk, _GetRayBlock, this, pHit);
+}
+
+void* ChunkManager::_GetRayChunk(void* pData, int gridX, int gridY, int gridZ)
+{
+	ChunkManager* pChunkManager = (ChunkManager*)pData;
+
+	return pChunkManager->GetChunk(gridX, gridY, gridZ);
+}
+
+void* ChunkManager::_GetReadyRayChunk(void* pData, int gridX, int gridY, int gridZ)
+{
+	ChunkManager* pChunkManager = (ChunkManager*)pData;
+
+	Chunk* pChunk = pChunkManager->GetChunk(gridX, gridY, gridZ);
+	if (pChunk == NULL || pChunk->IsSetup() == false || pChunk->NeedsRebuild())
+	{
+		return NULL;
+	}
+
+	return pChunk;
+}
+
+bool ChunkManager::_GetRayBlock(void* pData, void* pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType)
+{
+	Chunk* pRayChunk = (Chunk*)pChunk;
+
+	if (pRayChunk->GetActive(blockX, blockY, blockZ) == false)
+	{
+		return false;
+	}
+
+	*pBlockType = pRayChunk->GetBlockType(blockX, blockY, blockZ);
+
+	return true;
+}
+
 void ChunkManager::GetBlockGridFrom3DPositionChunkStorage(float x, float y, float z, int* blockX, int* blockY, int* blockZ, ChunkStorageLoader* ChunkStorage)
 {
 	(*blockX) = (int)((abs(x) + Chunk::BLOCK_RENDER_SIZE) / (Chunk::BLOCK_RENDER_SIZE*2.0f));
@@ -591,51 +769,9 @@ void ChunkManager::GetBlockGridFrom3DPositionChunkStorage(float x, float y, floa
 }
 
 // Adding to chunk storage for parts of the world generation that are outside of loaded chunks
-ChunkStorageLoader* ChunkManager::GetChunkStorage(int aX, int aY, int aZ, bool CreateIfNotExist)
+ChunkStorageTable* ChunkManager::GetChunkStorageTable()
 {
-	m_chunkStorageListLock.lock();
-	for (unsigned int i = 0; i < m_vpChunkStorageList.size(); i++)
-	{
-		if (m_vpChunkStorageList[i]->m_gridX == aX && m_vpChunkStorageList[i]->m_gridY == aY && m_vpChunkStorageList[i]->m_gridZ == aZ)
-		{
-			m_chunkStorageListLock.unlock();
-
-			// Found and existing chunk storage, return it
-			return m_vpChunkStorageList[i];
-		}
-	}
-	m_chunkStorageListLock.unlock();
-
-	// No storage found, create a new one
-	if (CreateIfNotExist)
-	{
-		ChunkStorageLoader* pNewStorage = new ChunkStorageLoader(aX, aY, aZ);
-		pNewStorage->m_gridX = aX;
-		pNewStorage->m_gridY = aY;
-		pNewStorage->m_gridZ = aZ;
-
-		m_chunkStorageListLock.lock();
-		m_vpChunkStorageList.push_back(pNewStorage);
-		m_chunkStorageListLock.unlock();
-
-		return pNewStorage;
-	}
-
-	return NULL;
-}
-
-void ChunkManager::RemoveChunkStorageLoader(ChunkStorageLoader* pChunkStorage)
-{
-	m_chunkStorageListLock.lock();
-	ChunkStorageLoaderList::iterator iter = std::find(m_vpChunkStorageList.begin(), m_vpChunkStorageList.end(), pChunkStorage);
-	if (iter != m_vpChunkStorageList.end())
-	{
-		m_vpChunkStorageList.erase(iter);
-	}
-	m_chunkStorageListLock.unlock();
-
-	delete pChunkStorage;
-	pChunkStorage = NULL;
+	return &m_chunkStorageTable;
 }
 
 
@@ -689,169 +825,37 @@ BlockType ChunkManager::SetBlockTypeBasedOnColour(int r, int g, int b)
 // Importing into the world chunks
 void ChunkManager::ImportQubicleBinaryMatrix(QubicleMatrix* pMatrix, vec3 position, QubicleImportDirection direction)
 {
-	bool mirrorX = false;
-	bool mirrorY = false;
-	bool mirrorZ = false;
-	bool flipXZ = false;
-	bool flipXY = false;
-	bool flipYZ = false;
+	QubicleTemplateMatrix templateMatrix;
+	QubicleTemplate::CreateTemplateMatrix(pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, pMatrix->m_matrixSizeZ, pMatrix->m_pColour, direction, &templateMatrix);
 
-	switch (direction)
-	{
-	case QubicleImportDirection_Normal: {  } break;
-	case QubicleImportDirection_MirrorX: { mirrorX = true; } break;
-	case QubicleImportDirection_MirrorY: { mirrorY = true; } break;
-	case QubicleImportDirection_MirrorZ: { mirrorZ = true; } break;
-	case QubicleImportDirection_RotateY90: { mirrorX = true; flipXZ = true; } break;
-	case QubicleImportDirection_RotateY180: { mirrorX = true; mirrorZ = true; } break;
-	case QubicleImportDirection_RotateY270: { mirrorZ = true; flipXZ = true; } break;
-	case QubicleImportDirection_RotateX90: { mirrorZ = true; flipYZ = true; } break;
-	case QubicleImportDirection_RotateX180: { mirrorZ = true; mirrorY = true; } break;
-	case QubicleImportDirection_RotateX270: { mirrorY = true; flipYZ = true; } break;
-	case QubicleImportDirection_RotateZ90: { mirrorY = true; flipXY = true; } break;
-	case QubicleImportDirection_RotateZ180: { mirrorX = true; mirrorY = true; } break;
-	case QubicleImportDirection_RotateZ270: { mirrorX = true; flipXY = true; } break;
-	}
-
-	ChunkList vChunkBatchUpdateList;
-
-	float r = 1.0f;
-	float g = 1.0f;
-	float b = 1.0f;
-	float a = 1.0f;
+	ImportQubicleTemplateMatrix(&templateMatrix, position);
+}
 
-	unsigned int xValueToUse = pMatrix->m_matrixSizeX;
-	unsigned int yValueToUse = pMatrix->m_matrixSizeY;
-	unsigned int zValueToUse = pMatrix->m_matrixSizeZ;
-	if (flipXZ)
-	{
-		xValueToUse = pMatrix->m_matrixSizeZ;
-		zValueToUse = pMatrix->m_matrixSizeX;
-	}
-	if (flipXY)
-	{
-		xValueToUse = pMatrix->m_matrixSizeY;
-		yValueToUse = pMatrix->m_matrixSizeX;
-	}
-	if (flipYZ)
-	{
-		yValueToUse = pMatrix->m_matrixSizeZ;
-		zValueToUse = pMatrix->m_matrixSizeY;
-	}
+void ChunkManager::ImportQubicleTemplateMatrix(const QubicleTemplateMatrix* pTemplateMatrix, vec3 position, unsigned long long sourceKey)
+{
+	ChunkStorageEditRequestList vStorageEdits;
+	vStorageEdits.reserve(pTemplateMatrix->m_vBlocks.size());
 
-	int xPosition = 0;
-	if (mirrorX)
-		xPosition = xValueToUse - 1;
+	vec3 startPos = position - vec3((pTemplateMatrix->m_sizeX + 0.05f)*0.5f, 0.0f, (pTemplateMatrix->m_sizeZ + 0.05f)*0.5f);
 
-	for (unsigned int x = 0; x < xValueToUse; x++)
+	for (unsigned int i = 0; i < pTemplateMatrix->m_vBlocks.size(); i++)
 	{
-		int yPosition = 0;
-		if (mirrorY)
-			yPosition = yValueToUse - 1;
-
-		for (unsigned int y = 0; y < yValueToUse; y++)
-		{
-			int zPosition = 0;
-			if (mirrorZ)
-				zPosition = zValueToUse - 1;
-
-			for (unsigned int z = 0; z < zValueToUse; z++)
-			{
-				int xPosition_modified = xPosition;
-				int yPosition_modified = yPosition;
-				int zPosition_modified = zPosition;
-				if (flipXZ)
-				{
-					xPosition_modified = zPosition;
-					zPosition_modified = xPosition;
-				}
-				if (flipXY)
-				{
-					xPosition_modified = yPosition;
-					yPosition_modified = xPosition;
-				}
-				if (flipYZ)
-				{
-					yPosition_modified = zPosition;
-					zPosition_modified = yPosition;
-				}
-
-				if (pMatrix->GetActive(xPosition_modified, yPosition_modified, zPosition_modified) == false)
-				{
-					// Do nothing
-				}
-				else
-				{
-					unsigned int colour = pMatrix->GetColourCompact(xPosition_modified, yPosition_modified, zPosition_modified);
-
-					vec3 blockPos = position - vec3((xValueToUse + 0.05f)*0.5f, 0.0f, (zValueToUse + 0.05f)*0.5f) + vec3(x*Chunk::BLOCK_RENDER_SIZE*2.0f, y*Chunk::BLOCK_RENDER_SIZE*2.0f, z*Chunk::BLOCK_RENDER_SIZE*2.0f);
-
-					vec3 blockPosition;
-					int blockX, blockY, blockZ;
-					Chunk* pChunk = NULL;
-					bool blockActive = GetBlockActiveFrom3DPosition(blockPos.x, blockPos.y, blockPos.z, &blockPosition, &blockX, &blockY, &blockZ, &pChunk);
-
-					if (pChunk != NULL)
-					{
-						// Set the block colour (and also set the block type since we are importing a world scenery object)
-						pChunk->SetColour(blockX, blockY, blockZ, colour, true);
-
-						// Add to batch update list (no duplicates)
-						bool found = false;
-						for (int i = 0; i < (int)vChunkBatchUpdateList.size() && found == false; i++)
-						{
-							if (vChunkBatchUpdateList[i] == pChunk)
-							{
-								found = true;
-							}
-						}
-						if (found == false)
-						{
-							vChunkBatchUpdateList.push_back(pChunk);
-							pChunk->StartBatchUpdate();
-						}
-					}
-					else
-					{
-						// Add to the chunk storage
-						int gridX;
-						int gridY;
-						int gridZ;
-						GetGridFromPosition(blockPos, &gridX, &gridY, &gridZ);
-						ChunkStorageLoader* pStorage = GetChunkStorage(gridX, gridY, gridZ, true);
-
-						if (pStorage != NULL)
-						{
-							GetBlockGridFrom3DPositionChunkStorage(blockPos.x, blockPos.y, blockPos.z, &blockX, &blockY, &blockZ, pStorage);
-
-							pStorage->SetBlockColour(blockX, blockY, blockZ, colour);
-						}
-					}
-				}
+		const QubicleTemplateBlock& block = pTemplateMatrix->m_vBlocks[i];
 
-				if (mirrorZ)
-					zPosition--;
-				else
-					zPosition++;
-			}
+		vec3 blockPos = startPos + vec3(block.m_x*Chunk::BLOCK_RENDER_SIZE*2.0f, block.m_y*Chunk::BLOCK_RENDER_SIZE*2.0f, block.m_z*Chunk::BLOCK_RENDER_SIZE*2.0f);
 
-			if (mirrorY)
-				yPosition--;
-			else
-				yPosition++;
-		}
+		// Loaded or not, every block goes through the chunk storage table. It writes into the chunks that are setup, and stores
+		// the rest until their chunk is setup, so a chunk always gets the imported blocks on top of its terrain, in order of source.
+		ChunkStorageEditRequest request;
+		GetGridFromPosition(blockPos, &request.m_gridX, &request.m_gridY, &request.m_gridZ);
+		GetBlockGridFrom3DPositionChunkStorage(blockPos.x, blockPos.y, blockPos.z, &request.m_blockX, &request.m_blockY, &request.m_blockZ, NULL);
+		request.m_colour = block.m_colour;
+		request.m_sourceKey = sourceKey;
 
-		if (mirrorX)
-			xPosition--;
-		else
-			xPosition++;
+		vStorageEdits.push_back(request);
 	}
 
-	for (int i = 0; i < (int)vChunkBatchUpdateList.size(); i++)
-	{
-		vChunkBatchUpdateList[i]->StopBatchUpdate();
-	}
-	vChunkBatchUpdateList.clear();
+	m_chunkStorageTable.AddEdits(vStorageEdits);
 }
 
 QubicleBinary* ChunkManager::ImportQubicleBinary(QubicleBinary* qubicleBinaryFile, vec3 position, QubicleImportDirection direction)
@@ -868,15 +872,28 @@ QubicleBinary* ChunkManager::ImportQubicleBinary(QubicleBinary* qubicleBinaryFil
 	return qubicleBinaryFile;
 }
 
-QubicleBinary* ChunkManager::ImportQubicleBinary(const char* filename, vec3 position, QubicleImportDirection direction)
+bool ChunkManager::ImportQubicleBinary(const char* filename, vec3 position, QubicleImportDirection direction, unsigned long long sourceKey)
 {
-	QubicleBinary* qubicleBinaryFile = m_pQubicleBinaryManager->GetQubicleBinaryFile(filename, true);
-	if (qubicleBinaryFile != NULL)
+	// Templates are immutable once loaded, and the chunk storage table has its own lock, so imports don't need to lock anything else
+	QubicleTemplate* pTemplate = m_pQubicleTemplateCache->GetTemplate(filename);
+	if (pTemplate == NULL)
 	{
-		return ImportQubicleBinary(qubicleBinaryFile, position, direction);
+		return false;
+	}
+
+	int numMatrices = pTemplate->GetNumMatrices(direction);
+	for (int i = 0; i < numMatrices; i++)
+	{
+		ImportQubicleTemplateMatrix(pTemplate->GetMatrix(direction, i), position, sourceKey);
 	}
 
-	return NULL;
+	return true;
+}
+
+// Qubicle templates
+QubicleTemplateCache* ChunkManager::GetQubicleTemplateCache()
+{
+	return m_pQubicleTemplateCache;
 }
 
 // Explosions
@@ -1064,10 +1081,42 @@ bool ChunkManager::GetFaceMerging()
 	return m_faceMerging;
 }
 
+void ChunkManager::SetGreedyMeshing(bool greedyMeshing)
+{
+	m_greedyMeshing = greedyMeshing;
+}
+
+bool ChunkManager::GetGreedyMeshing()
+{
+	return m_greedyMeshing;
+}
+
+void ChunkManager::SetChunkLOD(bool chunkLOD)
+{
+	m_chunkLOD = chunkLOD;
+}
+
+bool ChunkManager::GetChunkLOD()
+{
+	return m_chunkLOD;
+}
+
+void ChunkManager::SetLODDistance(float distance)
+{
+	m_lodDistance = distance;
+}
+
+float ChunkManager::GetLODDistance()
+{
+	return m_lodDistance;
+}
+
 // Updating
 void ChunkManager::Update(float dt)
 {
-	m_numChunksLoaded = (int)m_chunksMap.size();
+	PROFILE_ZONE("ChunkManager::Update");
+
+	m_numChunksLoaded = m_chunksTable.GetNumChunks();
 }
 
 void ChunkManager::_UpdatingChunksThread(void* pData)
@@ -1078,8 +1127,16 @@ void ChunkManager::_UpdatingChunksThread(void* pData)
 
 void ChunkManager::UpdatingChunksThread()
 {
+	PROFILE_THREAD_NAME("Chunk updating");
+
 	while (m_updateThreadActive)
 	{
+#ifdef _WIN32
+		Sleep(10);
+#else
+		usleep(10000);
+#endif
+
 		while (m_pPlayer == NULL)
 		{
 #ifdef _WIN32
@@ -1098,24 +1155,34 @@ void ChunkManager::UpdatingChunksThread()
 #endif
 		}
 
+		// Sleeping and waiting are done above, so this only times the work
+		PROFILE_ZONE("ChunkManager::UpdatingChunksThread");
+
+		// Link up the new chunks that have finished their setup since the last update
+		FinishChunkJobs();
+
 		ChunkList updateChunkList;
 		ChunkCoordKeysList addChunkList;
+		ChunkList newChunkList;
 		ChunkList rebuildChunkList;
 		ChunkList unloadChunkList;
 
 		m_ChunkMapMutexLock.lock();
-		typedef map<ChunkCoordKeys, Chunk*>::iterator it_type;
-		for (it_type iterator = m_chunksMap.begin(); iterator != m_chunksMap.end(); iterator++)
+		for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
 		{
-			Chunk* pChunk = iterator->second;
+			Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
 
-			updateChunkList.push_back(pChunk);
+			if (pChunk != NULL)
+			{
+				updateChunkList.push_back(pChunk);
+			}
 		}
 		m_ChunkMapMutexLock.unlock();
 
-		// Updating chunks
-		int numAddedChunks = 0;
-		int MAX_NUM_CHUNKS_ADD = 10;
+		// Updating chunks, the number of chunks being added and rebuilt at a time scales with the number of chunk workers
+		int numWorkers = m_pChunkJobPool->GetNumWorkers();
+		int numAddedChunks = (int)m_vpSetupChunks.size();
+		int MAX_NUM_CHUNKS_ADD = 10 * numWorkers;
 		sort(updateChunkList.begin(), updateChunkList.end(), Chunk::ClosestToCamera);
 		for (unsigned int i = 0; i < (int)updateChunkList.size(); i++)
 		{
@@ -1143,7 +1210,19 @@ void ChunkManager::UpdatingChunksThread()
 				}
 				else
 				{
-					if (numAddedChunks < MAX_NUM_CHUNKS_ADD)
+					// Level of detail, the half chunk of hysteresis stops chunks on a boundary from flipping back and forth as the player moves
+					float hysteresis = Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE;
+					int lodLevel = m_chunkLOD ? ChunkMesher::SelectLODLevel(lengthValue, pChunk->GetLODLevel(), m_lodDistance, hysteresis) : 0;
+					if (lodLevel != pChunk->GetLODLevel() && pChunk->IsSetup())
+					{
+						pChunk->SetLODLevel(lodLevel);
+						if (pChunk->NeedsRebuild() == false)
+						{
+							pChunk->SetNeedsRebuild(true, false);
+						}
+					}
+
+					if (numAddedChunks < MAX_NUM_CHUNKS_ADD && pChunk->IsCreated())
 					{
 						// Check neighbours
 						if (pChunk->GetNumNeighbours() < 6 && (pChunk->IsEmpty() == false) || (gridY == 0))
@@ -1275,7 +1354,7 @@ void ChunkManager::UpdatingChunksThread()
 		}
 		updateChunkList.clear();
 
-		// Adding chunks
+		// Adding chunks, allocate all the new chunks first and then generate them on the job pool
 		for (unsigned int i = 0; i < (int)addChunkList.size(); i++)
 		{
 			ChunkCoordKeys coordKey = addChunkList[i];
@@ -1283,33 +1362,47 @@ void ChunkManager::UpdatingChunksThread()
 
 			if (pChunk == NULL)
 			{
-				CreateNewChunk(coordKey.x, coordKey.y, coordKey.z);
-			}
-			else
-			{
-				UpdateChunkNeighbours(pChunk, coordKey.x, coordKey.y, coordKey.z);
+				pChunk = AllocateNewChunk(coordKey.x, coordKey.y, coordKey.z);
+				newChunkList.push_back(pChunk);
 			}
 		}
+		if (newChunkList.empty() == false && m_vpSetupChunks.empty())
+		{
+			m_generationStartTime = GetHighResolutionTime();
+		}
+		for (unsigned int i = 0; i < newChunkList.size(); i++)
+		{
+			Chunk* pChunk = newChunkList[i];
+
+			pChunk->SetJobQueued(true);
+			m_vpChunkJobs.push_back(pChunk);
+			m_vpSetupChunks.push_back(pChunk);
+			m_pChunkJobPool->AddJob(_SetupChunkJob, pChunk, GetChunkDistanceToPlayer(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ()));
+		}
+		newChunkList.clear();
 		addChunkList.clear();
 
-		// Unloading chunks
+		// Unloading chunks, a chunk that a job can still reach is left for a later update
 		for (unsigned int i = 0; i < (int)unloadChunkList.size(); i++)
 		{
 			Chunk* pChunk = unloadChunkList[i];
 
-			UnloadChunk(pChunk);
+			if (IsNearChunkJob(pChunk) == false)
+			{
+				UnloadChunk(pChunk);
+			}
 		}
 		unloadChunkList.clear();
 
 		// Check for rebuild chunks
 		m_ChunkMapMutexLock.lock();
-		for (it_type iterator = m_chunksMap.begin(); iterator != m_chunksMap.end(); iterator++)
+		for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
 		{
-			Chunk* pChunk = iterator->second;
+			Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
 
 			if (pChunk != NULL)
 			{
-				if (pChunk->NeedsRebuild())
+				if (pChunk->NeedsRebuild() && pChunk->IsJobQueued() == false)
 				{
 					rebuildChunkList.push_back(pChunk);
 				}
@@ -1317,17 +1410,17 @@ void ChunkManager::UpdatingChunksThread()
 		}
 		m_ChunkMapMutexLock.unlock();
 
-		// Rebuilding chunks
-		int numRebuildChunks = 0;
-		int MAX_NUM_CHUNKS_REBUILD = 30;
+		// Rebuilding chunks, closest chunks first. They are queued behind any setups still running, without waiting for them.
+		int numRebuildChunks = (int)(m_vpChunkJobs.size() - m_vpSetupChunks.size());
+		int MAX_NUM_CHUNKS_REBUILD = 30 * numWorkers;
+		sort(rebuildChunkList.begin(), rebuildChunkList.end(), Chunk::ClosestToCamera);
 		for (unsigned int i = 0; i < (int)rebuildChunkList.size() && numRebuildChunks < MAX_NUM_CHUNKS_REBUILD; i++)
 		{
 			Chunk* pChunk = rebuildChunkList[i];
 
-			pChunk->SwitchToCachedMesh();
-			pChunk->RebuildMesh();
-			pChunk->CompleteMesh();
-			pChunk->UndoCachedMesh();
+			pChunk->SetJobQueued(true);
+			m_vpChunkJobs.push_back(pChunk);
+			m_pChunkJobPool->AddJob(_RebuildChunkJob, pChunk, GetChunkDistanceToPlayer(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ()));
 
 			numRebuildChunks++;
 		}
@@ -1337,23 +1430,161 @@ void ChunkManager::UpdatingChunksThread()
 		{
 			m_updateStepLock = true;
 		}
-
-#ifdef _WIN32
-		Sleep(10);
-#else
-		usleep(10000);
-#endif
 	}
 
+	// Nothing can be unloaded while a job is still using it
+	m_pChunkJobPool->WaitForAllJobs();
+	FinishChunkJobs();
+
 	m_updateThreadFinished = true;
 }
 
+void ChunkManager::_SetupChunkJob(void* pData)
+{
+	Chunk* pChunk = (Chunk*)pData;
+
+	pChunk->Setup();
+	pChunk->SetNeedsRebuild(false, true);
+	pChunk->RebuildMesh();
+	pChunk->CompleteMesh();
+	pChunk->SetCreated(true);
+	pChunk->SetJobQueued(false);
+}
+
+void ChunkManager::_RebuildChunkJob(void* pData)
+{
+	Chunk* pChunk = (Chunk*)pData;
+
+	pChunk->SwitchToCachedMesh();
+	pChunk->RebuildMesh();
+	pChunk->CompleteMesh();
+	pChunk->UndoCachedMesh();
+	pChunk->SetJobQueued(false);
+}
+
+void ChunkManager::FinishChunkJobs()
+{
+	for (unsigned int i = 0; i < m_vpSetupChunks.size();)
+	{
+		Chunk* pChunk = m_vpSetupChunks[i];
+
+		if (pChunk->IsJobQueued())
+		{
+			i++;
+			continue;
+		}
+
+		UpdateChunkNeighbours(pChunk, pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ());
+		m_numChunksGenerated++;
+
+		m_vpSetupChunks[i] = m_vpSetupChunks.back();
+		m_vpSetupChunks.pop_back();
+	}
+
+	// Generation is timed from the first setup being queued until there are none left
+	if (m_vpSetupChunks.empty() && m_generationStartTime > 0.0)
+	{
+		m_chunkGenerationTime += GetHighResolutionTime() - m_generationStartTime;
+		m_generationStartTime = 0.0;
+	}
+
+	for (unsigned int i = 0; i < m_vpChunkJobs.size();)
+	{
+		if (m_vpChunkJobs[i]->IsJobQueued() || find(m_vpSetupChunks.begin(), m_vpSetupChunks.end(), m_vpChunkJobs[i]) != m_vpSetupChunks.end())
+		{
+			i++;
+			continue;
+		}
+
+		m_vpChunkJobs[i] = m_vpChunkJobs.back();
+		m_vpChunkJobs.pop_back();
+	}
+}
+
+bool ChunkManager::IsNearChunkJob(Chunk* pChunk)
+{
+	// A job reads the neighbours of its chunk, and the neighbours of those when it updates their surrounded flags
+	for (unsigned int i = 0; i < m_vpChunkJobs.size(); i++)
+	{
+		Chunk* pJobChunk = m_vpChunkJobs[i];
+
+		int distance = abs(pJobChunk->GetGridX() - pChunk->GetGridX()) + abs(pJobChunk->GetGridY() - pChunk->GetGridY()) + abs(pJobChunk->GetGridZ() - pChunk->GetGridZ());
+		if (distance <= 2)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+float ChunkManager::GetChunkDistanceToPlayer(int gridX, int gridY, int gridZ)
+{
+	float xPos = gridX * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
+	float yPos = gridY * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
+	float zPos = gridZ * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
+
+	vec3 chunkCenter = vec3(xPos, yPos, zPos) + vec3(Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE, Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE, Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE);
+	vec3 distanceVec = chunkCenter - m_pPlayer->GetCenter();
+
+	return length(distanceVec);
+}
+
+void ChunkManager::UpdateChunkColumnCacheSize()
+{
+	// Enough columns for the square around the loader radius, plus a ring either side for chunks waiting to unload
+	float chunkWidth = Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
+	int columnsAcross = ((int)ceil(m_loaderRadius / chunkWidth) * 2) + 3;
+
+	m_pChunkColumnCache->SetMaxColumns(columnsAcross * columnsAcross);
+}
+
 // Rendering
-void ChunkManager::Render(bool shadowRender)
+void ChunkManager::CullChunks(VisibilityCuller* pVisibilityCuller)
 {
-	if (shadowRender == false)
+	PROFILE_ZONE("ChunkManager::CullChunks");
+
+	m_ChunkMapMutexLock.lock();
+	for (int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleChunks[i].clear();
+	}
+
+	for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
+	{
+		Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
+
+		if (pChunk != NULL && pChunk->IsCreated() && pChunk->IsSetup() && pChunk->IsUnloading() == false && pChunk->IsEmpty() == false && pChunk->IsSurrounded() == false)
+		{
+			vec3 chunkCenter = pChunk->GetPosition() + vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
+
+			unsigned int passMask = pVisibilityCuller->CullSphere(VisibilityType_Chunk, chunkCenter, Chunk::CHUNK_RADIUS);
+			for (int j = 0; j < RenderPass_NumPasses; j++)
+			{
+				if (passMask & (1 << j))
+				{
+					m_vpVisibleChunks[j].push_back(pChunk);
+				}
+			}
+		}
+	}
+	m_ChunkMapMutexLock.unlock();
+}
+
+void ChunkManager::Render(RenderPass renderPass)
+{
+	PROFILE_ZONE("ChunkManager::Render");
+
+	bool mainRender = (renderPass == RenderPass_Main);
+
+	if (mainRender)
 	{
 		m_numChunksRender = 0;
+		for (int i = 0; i < ChunkMesher::NUM_LOD_LEVELS; i++)
+		{
+			m_numChunksRenderLOD[i] = 0;
+			m_numTrianglesRenderLOD[i] = 0;
+		}
 	}
 
 	m_pRenderer->StartMeshRender();
@@ -1372,43 +1603,38 @@ void ChunkManager::Render(bool shadowRender)
 	}
 
 	m_pRenderer->PushMatrix();
+		// The chunks were culled against this pass's frustum in CullChunks()
 		m_ChunkMapMutexLock.lock();
-		typedef map<ChunkCoordKeys, Chunk*>::iterator it_type;
-		for (it_type iterator = m_chunksMap.begin(); iterator != m_chunksMap.end(); iterator++)
+		ChunkList& vpVisibleChunks = m_vpVisibleChunks[renderPass];
+		for (unsigned int i = 0; i < vpVisibleChunks.size(); i++)
 		{
-			Chunk* pChunk = iterator->second;
+			Chunk* pChunk = vpVisibleChunks[i];
 
-			if (pChunk != NULL && pChunk->IsCreated() && pChunk->IsSetup() && pChunk->IsUnloading() == false && pChunk->IsEmpty() == false && pChunk->IsSurrounded() == false)
+			// Fog
+			if (VoxGame::GetInstance()->GetGameMode() != GameMode_FrontEnd)
 			{
 				vec3 chunkCenter = pChunk->GetPosition() + vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
-
-				if (shadowRender == true || m_pRenderer->SphereInFrustum(VoxGame::GetInstance()->GetDefaultViewport(), chunkCenter, Chunk::CHUNK_RADIUS))
+				float toCamera = length(VoxGame::GetInstance()->GetGameCamera()->GetPosition() - chunkCenter);
+				if (toCamera > GetLoaderRadius() + (Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE*5.0f))
 				{
-					// Fog
-					if (VoxGame::GetInstance()->GetGameMode() != GameMode_FrontEnd)
-					{
-						vec3 chunkCenter = pChunk->GetPosition() + vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
-						float toCamera = length(VoxGame::GetInstance()->GetGameCamera()->GetPosition() - chunkCenter);
-						if (toCamera > GetLoaderRadius() + (Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE*5.0f))
-						{
-							continue;
-						}
-						if (toCamera > GetLoaderRadius() - Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE*3.0f)
-						{
-							m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
-						}
-					}
-
-					pChunk->Render();
+					continue;
+				}
+				if (toCamera > GetLoaderRadius() - Chunk::CHUNK_SIZE*Chunk::BLOCK_RENDER_SIZE*3.0f)
+				{
+					m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+				}
+			}
 
-					if (shadowRender == false)
-					{
-						m_numChunksRender++;
-					}
+			pChunk->Render();
 
-					m_pRenderer->DisableTransparency();
-				}
+			if (mainRender)
+			{
+				m_numChunksRender++;
+				m_numChunksRenderLOD[pChunk->GetMeshLODLevel()]++;
+				m_numTrianglesRenderLOD[pChunk->GetMeshLODLevel()] += pChunk->GetNumMeshTriangles();
 			}
+
+			m_pRenderer->DisableTransparency();
 		}
 		m_ChunkMapMutexLock.unlock();
 	m_pRenderer->PopMatrix();
@@ -1421,6 +1647,8 @@ void ChunkManager::Render(bool shadowRender)
 
 void ChunkManager::RenderWater()
 {
+	PROFILE_ZONE("ChunkManager::RenderWater");
+
 	m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
 	m_pRenderer->EnableMaterial(m_chunkMaterialID);
 
@@ -1446,10 +1674,9 @@ void ChunkManager::RenderDebug()
 	m_pRenderer->SetRenderMode(RM_SOLID);
 
 	m_ChunkMapMutexLock.lock();
-	typedef map<ChunkCoordKeys, Chunk*>::iterator it_type;
-	for (it_type iterator = m_chunksMap.begin(); iterator != m_chunksMap.end(); iterator++)
+	for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
 	{
-		Chunk* pChunk = iterator->second;
+		Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
 
 		if (pChunk != NULL && pChunk->IsCreated())
 		{
@@ -1462,10 +1689,9 @@ void ChunkManager::RenderDebug()
 void ChunkManager::Render2D(Camera* pCamera, unsigned int viewport, unsigned int font)
 {
 	m_ChunkMapMutexLock.lock();
-	typedef map<ChunkCoordKeys, Chunk*>::iterator it_type;
-	for (it_type iterator = m_chunksMap.begin(); iterator != m_chunksMap.end(); iterator++)
+	for (int i = 0; i < m_chunksTable.GetCapacity(); i++)
 	{
-		Chunk* pChunk = iterator->second;
+		Chunk* pChunk = m_chunksTable.GetSlotChunk(i);
 
 		if (pChunk != NULL && pChunk->IsCreated())
 		{
@@ -27,6 +27,17 @@ using namespace std;
 #include "../tinythread/tinythread.h"
 using namespace tthread;
 
+#include "../utils/JobPool.h"
+#include "RegionFile.h"
+#include "ChunkHashTable.h"
+#include "QubicleTemplate.h"
+#include "ChunkColumnCache.h"
+#include "TerrainGenerator.h"
+#include "ChunkStorageTable.h"
+#include "ChunkMesher.h"
+#include "VoxelRayCast.h"
+#include "../Renderer/visibilityculler.h"
+
 class Player;
 class NPCManager;
 class EnemyManager;
@@ -63,70 +74,7 @@ inline bool const operator<(const ChunkCoordKeys& l, const ChunkCoordKeys& r) {
 typedef std::vector<Chunk*> ChunkList;
 typedef std::vector<ChunkCoordKeys> ChunkCoordKeysList;
 
-enum QubicleImportDirection
-{
-	QubicleImportDirection_Normal = 0,
-	QubicleImportDirection_MirrorX,
-	QubicleImportDirection_MirrorY,
-	QubicleImportDirection_MirrorZ,
-	QubicleImportDirection_RotateY90,
-	QubicleImportDirection_RotateY180,
-	QubicleImportDirection_RotateY270,
-	QubicleImportDirection_RotateX90,
-	QubicleImportDirection_RotateX180,
-	QubicleImportDirection_RotateX270,
-	QubicleImportDirection_RotateZ90,
-	QubicleImportDirection_RotateZ180,
-	QubicleImportDirection_RotateZ270,
-};
-
-
-class ChunkStorageLoader
-{
-public:
-	int m_gridX;
-	int m_gridY;
-	int m_gridZ;
-
-	vec3 m_position;
-
-	bool m_blockSet[Chunk::CHUNK_SIZE][Chunk::CHUNK_SIZE][Chunk::CHUNK_SIZE];
-	unsigned int m_colour[Chunk::CHUNK_SIZE][Chunk::CHUNK_SIZE][Chunk::CHUNK_SIZE];
-
-	ChunkStorageLoader(int x, int y, int z)
-	{
-		m_gridX = x;
-		m_gridY = y;
-		m_gridZ = z;
-
-		float xPos = x * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
-		float yPos = y * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
-		float zPos = z * Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
-
-		m_position = vec3(xPos, yPos, zPos);
-
-		// Reset initial arrays
-		for (int x = 0; x < Chunk::CHUNK_SIZE; x++)
-		{
-			for (int y = 0; y < Chunk::CHUNK_SIZE; y++)
-			{
-				for (int z = 0; z < Chunk::CHUNK_SIZE; z++)
-				{
-					m_blockSet[x][y][z] = false;
-					m_colour[x][y][z] = 0;
-				}
-			}
-		}
-	}
-
-	void SetBlockColour(int x, int y, int z, unsigned int colour)
-	{
-		m_blockSet[x][y][z] = true;
-		m_colour[x][y][z] = colour;
-	}
-};
 
-typedef std::vector<ChunkStorageLoader*> ChunkStorageLoaderList;
 
 class BlockColourTypeMatch
 {
@@ -169,6 +117,11 @@ public:
 	// Chunk counters
 	int GetNumChunksLoaded();
 	int GetNumChunksRender();
+	int GetNumChunksRenderLOD(int lodLevel);
+	int GetNumTrianglesRenderLOD(int lodLevel);
+	int GetNumChunksGenerated();
+	float GetChunksPerSecond();
+	int GetNumChunkWorkers();
 
 	// Loader radius
 	void SetLoaderRadius(float radius);
@@ -180,9 +133,26 @@ public:
 
 	// Chunk Creation
 	void CreateNewChunk(int x, int y, int z);
+	Chunk* AllocateNewChunk(int x, int y, int z);
 	void UnloadChunk(Chunk* pChunk);
 	void UpdateChunkNeighbours(Chunk* pChunk, int x, int y, int z);
 
+	// Chunk saving and loading
+	RegionFileManager* GetRegionFileManager();
+	void SaveAllChunks();
+
+	// World generation seed
+	unsigned int GetWorldSeed();
+
+	// Terrain generation, the biome functions forward to the biome manager
+	TerrainGenerator* GetTerrainGenerator();
+	static Biome _GetTerrainBiome(void* pData, float xPosition, float zPosition);
+	static float _GetTerrainTownMultiplier(void* pData, float xPosition, float zPosition);
+	static void _GetTerrainBlockColour(void* pData, Biome biome, float noise, float colourNoise, float *r, float *g, float *b, BlockType *blockType);
+
+	// Chunk columns, the terrain data shared by all the chunks in a column
+	ChunkColumnCache* GetChunkColumnCache();
+
 	// Getting chunk and positional information
 	void GetGridFromPosition(vec3 position, int* gridX, int* gridY, int* gridZ);
 	Chunk* GetChunkFromPosition(float posX, float posY, float posZ);
@@ -193,9 +163,14 @@ public:
 	bool GetBlockActiveFrom3DPosition(float x, float y, float z, vec3 *blockPos, int* blockX, int* blockY, int* blockZ, Chunk** pChunk);
 	void GetBlockGridFrom3DPositionChunkStorage(float x, float y, float z, int* blockX, int* blockY, int* blockZ, ChunkStorageLoader* ChunkStorage);
 
+	// Ray casts through the blocks, the hit chunk is a Chunk*. With onlyReadyChunks the chunks that are still being set up or rebuilt are passed through.
+	bool RayCast(vec3 origin, vec3 direction, float maxDistance, VoxelRayHit* pHit, bool onlyReadyChunks = false);
+	static void* _GetRayChunk(void* pData, int gridX, int gridY, int gridZ);
+	static void* _GetReadyRayChunk(void* pData, int gridX, int gridY, int gridZ);
+	static bool _GetRayBlock(void* pData, void* pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType);
+
 	// Adding to chunk storage for parts of the world generation that are outside of loaded chunks
-	ChunkStorageLoader* GetChunkStorage(int aX, int aY, int aZ, bool CreateIfNotExist);
-	void RemoveChunkStorageLoader(ChunkStorageLoader* pChunkStorage);
+	ChunkStorageTable* GetChunkStorageTable();
 
 	// Block colour to block type matching
 	void AddBlockColourBlockTypeMatching(int r, int g, int b, BlockType blockType);
@@ -205,7 +180,12 @@ public:
 	// Importing into the world chunks
 	void ImportQubicleBinaryMatrix(QubicleMatrix* pMatrix, vec3 position, QubicleImportDirection direction);
 	QubicleBinary* ImportQubicleBinary(QubicleBinary* qubicleBinaryFile, vec3 position, QubicleImportDirection direction);
-	QubicleBinary* ImportQubicleBinary(const char* filename, vec3 position, QubicleImportDirection direction);
+	// World generation passes the grid of the generating chunk as the source, see ChunkStorageTable
+	void ImportQubicleTemplateMatrix(const QubicleTemplateMatrix* pTemplateMatrix, vec3 position, unsigned long long sourceKey = ChunkStorageTable::IMPORT_SOURCE_KEY);
+	bool ImportQubicleBinary(const char* filename, vec3 position, QubicleImportDirection direction, unsigned long long sourceKey = ChunkStorageTable::IMPORT_SOURCE_KEY);
+
+	// Qubicle templates
+	QubicleTemplateCache* GetQubicleTemplateCache();
 
 	// Explosions
 	void CreateBlockDestroyParticleEffect(float r, float g, float b, float a, vec3 blockPosition);
@@ -223,14 +203,27 @@ public:
 	void SetWireframeRender(bool wireframe);
 	void SetFaceMerging(bool faceMerge);
 	bool GetFaceMerging();
+	void SetGreedyMeshing(bool greedyMeshing);
+	bool GetGreedyMeshing();
+
+	// Level of detail for far chunks
+	void SetChunkLOD(bool chunkLOD);
+	bool GetChunkLOD();
+	void SetLODDistance(float distance);
+	float GetLODDistance();
 
 	// Updating
 	void Update(float dt);
 	static void _UpdatingChunksThread(void* pData);
 	void UpdatingChunksThread();
+	static void _SetupChunkJob(void* pData);
+	static void _RebuildChunkJob(void* pData);
+
+	// Culling, builds the visible chunk list for each render pass
+	void CullChunks(VisibilityCuller* pVisibilityCuller);
 
 	// Rendering
-	void Render(bool shadowRender);
+	void Render(RenderPass renderPass);
 	void RenderWater();
 	void RenderDebug();
 	void Render2D(Camera* pCamera, unsigned int viewport, unsigned int font);
@@ -240,6 +233,10 @@ protected:
 
 private:
 	/* Private methods */
+	float GetChunkDistanceToPlayer(int gridX, int gridY, int gridZ);
+	void UpdateChunkColumnCacheSize();
+	void FinishChunkJobs();
+	bool IsNearChunkJob(Chunk* pChunk);
 
 public:
 	/* Public members */
@@ -260,6 +257,21 @@ private:
 	EnemyManager* m_pEnemyManager;
 	NPCManager* m_pNPCManager;
 
+	// Region files, for saving and loading chunks
+	RegionFileManager* m_pRegionFileManager;
+
+	// Qubicle templates, for stamping scenery into the world generation
+	QubicleTemplateCache* m_pQubicleTemplateCache;
+
+	// World generation seed
+	unsigned int m_worldSeed;
+
+	// Chunk columns
+	ChunkColumnCache* m_pChunkColumnCache;
+
+	// Terrain generation
+	TerrainGenerator m_terrainGenerator;
+
 	// Chunk Material
 	unsigned int m_chunkMaterialID;
 
@@ -276,13 +288,20 @@ private:
 	// Render modes
 	bool m_wireframeRender;
 	bool m_faceMerging;
+	bool m_greedyMeshing;
+
+	// Level of detail
+	bool m_chunkLOD;
+	float m_lodDistance;
 
 	// Chunks storage
-	map<ChunkCoordKeys, Chunk*> m_chunksMap;
+	ChunkHashTable m_chunksTable;
 
 	// Storage for modifications to chunks that are not loaded yet
-	ChunkStorageLoaderList m_vpChunkStorageList;
-	tthread::mutex m_chunkStorageListLock;
+	ChunkStorageTable m_chunkStorageTable;
+
+	// The chunks that each render pass can see, only used with the chunk map lock held
+	ChunkList m_vpVisibleChunks[RenderPass_NumPasses];
 
 	// Block colour to type matching boundaries
 	BlockColourTypeMatchList m_vpBlockColourTypeMatchList;
@@ -290,8 +309,19 @@ private:
 	// Chunk counters
 	int m_numChunksLoaded;
 	int m_numChunksRender;
+	int m_numChunksRenderLOD[ChunkMesher::NUM_LOD_LEVELS];
+	int m_numTrianglesRenderLOD[ChunkMesher::NUM_LOD_LEVELS];
+	int m_numChunksGenerated;
+	double m_chunkGenerationTime;
+	double m_generationStartTime;
 
 	// Threading
+	JobPool* m_pChunkJobPool;
+
+	// Chunks with a setup or rebuild job on the pool, and the new chunks that get linked to their neighbours when their setup is done.
+	// Only used by the updating thread.
+	ChunkList m_vpChunkJobs;
+	ChunkList m_vpSetupChunks;
 	thread* m_pUpdatingChunksThread;
 	tthread::mutex m_ChunkMapMutexLock;
 	bool m_updateThreadActive;
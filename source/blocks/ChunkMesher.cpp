@@ -0,0 +1,528 @@
+// ******************************************************************************
+// Filename:    ChunkMesher.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include <string.h>
+#include <algorithm>
+
+#include "ChunkMesher.h"
+
+static const unsigned int FULL_ROW = (1u << Chunk::CHUNK_SIZE) - 1;
+
+
+ChunkMesher::ChunkMesher()
+{
+	memset(m_occupancyX, 0, sizeof(m_occupancyX));
+	memset(m_occupancyZ, 0, sizeof(m_occupancyZ));
+	memset(m_colours, 0, sizeof(m_colours));
+	m_mergeBorderQuads = false;
+}
+
+ChunkMesher::~ChunkMesher()
+{
+}
+
+// Copy the chunk and its neighbour borders into the occupancy masks
+void ChunkMesher::SetupOccupancy(Chunk* pChunk, Chunk* pxMinus, Chunk* pxPlus, Chunk* pyMinus, Chunk* pyPlus, Chunk* pzMinus, Chunk* pzPlus)
+{
+	const int size = Chunk::CHUNK_SIZE;
+
+	memset(m_occupancyX, 0, sizeof(m_occupancyX));
+	memset(m_occupancyZ, 0, sizeof(m_occupancyZ));
+	m_mergeBorderQuads = false;
+
+	// Unpack the palette storage once, rather than locking it for every block
+	unsigned int colours[Chunk::CHUNK_SIZE_CUBED];
+	pChunk->CopyColours(colours);
+
+	SetupBlocks(colours);
+
+	// The one block border from each neighbour
+	for (int i = 0; i < size; i++)
+	{
+		m_occupancyX[0][i + 1] = GetNeighbourRow(pzMinus, 0, i, size - 1, 1, 0, 0);
+		m_occupancyX[size + 1][i + 1] = GetNeighbourRow(pzPlus, 0, i, 0, 1, 0, 0);
+		m_occupancyX[i + 1][0] = GetNeighbourRow(pyMinus, 0, size - 1, i, 1, 0, 0);
+		m_occupancyX[i + 1][size + 1] = GetNeighbourRow(pyPlus, 0, 0, i, 1, 0, 0);
+		m_occupancyZ[0][i] = GetNeighbourRow(pxMinus, size - 1, i, 0, 0, 0, 1);
+		m_occupancyZ[size + 1][i] = GetNeighbourRow(pxPlus, 0, i, 0, 0, 0, 1);
+	}
+}
+
+// Copy a colour array into the occupancy masks, without any neighbours
+void ChunkMesher::SetupOccupancy(const unsigned int* pColours)
+{
+	const int size = Chunk::CHUNK_SIZE;
+
+	memset(m_occupancyX, 0, sizeof(m_occupancyX));
+	memset(m_occupancyZ, 0, sizeof(m_occupancyZ));
+	m_mergeBorderQuads = false;
+
+	SetupBlocks(pColours);
+
+	// Same as a NULL neighbour, the borders hide the faces
+	for (int i = 0; i < size; i++)
+	{
+		m_occupancyX[0][i + 1] = FULL_ROW;
+		m_occupancyX[size + 1][i + 1] = FULL_ROW;
+		m_occupancyX[i + 1][0] = FULL_ROW;
+		m_occupancyX[i + 1][size + 1] = FULL_ROW;
+		m_occupancyZ[0][i] = FULL_ROW;
+		m_occupancyZ[size + 1][i] = FULL_ROW;
+	}
+}
+
+// Reduce the colour array to the level of detail and copy it into the occupancy masks, with every neighbour treated as empty
+void ChunkMesher::SetupLODOccupancy(const unsigned int* pColours, int lodLevel)
+{
+	// Every block in a cell gets the cell's colour, so the faces only appear on the cell boundaries and the greedy merging does the rest
+	unsigned int reducedColours[Chunk::CHUNK_SIZE_CUBED];
+	ReduceColours(pColours, lodLevel, reducedColours);
+
+	memset(m_occupancyX, 0, sizeof(m_occupancyX));
+	memset(m_occupancyZ, 0, sizeof(m_occupancyZ));
+	m_mergeBorderQuads = true;
+
+	SetupBlocks(reducedColours);
+
+	// The borders are left empty, the neighbours can be at a different level of detail
+}
+
+// Create the quads for all the visible faces
+void ChunkMesher::CreateQuads(bool faceMerging, ChunkMeshQuadList* pQuads)
+{
+	for (int face = 0; face < ChunkMeshFace_NumFaces; face++)
+	{
+		for (int slice = 0; slice < Chunk::CHUNK_SIZE; slice++)
+		{
+			CreateSliceQuads((ChunkMeshFace)face, slice, faceMerging, pQuads);
+		}
+	}
+}
+
+void ChunkMesher::CreateQuads(bool faceMerging, ChunkMeshQuadCache* pCache)
+{
+	pCache->m_vQuads.clear();
+	pCache->m_faceMerging = faceMerging;
+
+	for (int face = 0; face < ChunkMeshFace_NumFaces; face++)
+	{
+		for (int slice = 0; slice < Chunk::CHUNK_SIZE; slice++)
+		{
+			pCache->m_sliceStart[face * Chunk::CHUNK_SIZE + slice] = (unsigned short)pCache->m_vQuads.size();
+			CreateSliceQuads((ChunkMeshFace)face, slice, faceMerging, &pCache->m_vQuads);
+		}
+	}
+	pCache->m_sliceStart[ChunkMeshFace_NumFaces * Chunk::CHUNK_SIZE] = (unsigned short)pCache->m_vQuads.size();
+}
+
+// Incremental meshing
+int ChunkMesher::UpdateQuads(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, ChunkMeshQuadCache* pCache)
+{
+	int numSlices = 0;
+
+	m_vUpdateQuads.clear();
+	m_vUpdateQuads.reserve(pCache->m_vQuads.size() + Chunk::CHUNK_SIZE);
+
+	for (int face = 0; face < ChunkMeshFace_NumFaces; face++)
+	{
+		int startSlice;
+		int endSlice;
+		GetDirtySlices((ChunkMeshFace)face, editedRegion, &startSlice, &endSlice);
+		int borderSlice = ((dirtyBorderFaces & (1 << face)) != 0) ? GetBorderSlice((ChunkMeshFace)face) : -1;
+
+		for (int slice = 0; slice < Chunk::CHUNK_SIZE; slice++)
+		{
+			int sliceIndex = face * Chunk::CHUNK_SIZE + slice;
+			int start = pCache->m_sliceStart[sliceIndex];
+			int end = pCache->m_sliceStart[sliceIndex + 1];
+
+			// Where this slice starts in the new list, the old start is still needed for the next slice's range
+			pCache->m_sliceStart[sliceIndex] = (unsigned short)m_vUpdateQuads.size();
+
+			if ((slice >= startSlice && slice <= endSlice) || slice == borderSlice)
+			{
+				CreateSliceQuads((ChunkMeshFace)face, slice, pCache->m_faceMerging, &m_vUpdateQuads);
+				numSlices++;
+			}
+			else
+			{
+				m_vUpdateQuads.insert(m_vUpdateQuads.end(), pCache->m_vQuads.begin() + start, pCache->m_vQuads.begin() + end);
+			}
+		}
+	}
+	pCache->m_sliceStart[ChunkMeshFace_NumFaces * Chunk::CHUNK_SIZE] = (unsigned short)m_vUpdateQuads.size();
+
+	pCache->m_vQuads.swap(m_vUpdateQuads);
+
+	return numSlices;
+}
+
+void ChunkMesher::GetDirtySlices(ChunkMeshFace face, const ChunkMeshRegion& editedRegion, int* pStartSlice, int* pEndSlice)
+{
+	if (editedRegion.IsEmpty())
+	{
+		*pStartSlice = 0;
+		*pEndSlice = -1;
+		return;
+	}
+
+	// Front and back faces are sliced along z, right and left along x and top and bottom along y
+	int minSlice = editedRegion.m_minZ;
+	int maxSlice = editedRegion.m_maxZ;
+	if (face == ChunkMeshFace_Right || face == ChunkMeshFace_Left)
+	{
+		minSlice = editedRegion.m_minX;
+		maxSlice = editedRegion.m_maxX;
+	}
+	else if (face == ChunkMeshFace_Top || face == ChunkMeshFace_Bottom)
+	{
+		minSlice = editedRegion.m_minY;
+		maxSlice = editedRegion.m_maxY;
+	}
+
+	*pStartSlice = std::max(minSlice - 1, 0);
+	*pEndSlice = std::min(maxSlice + 1, Chunk::CHUNK_SIZE - 1);
+}
+
+ChunkMeshFace ChunkMesher::GetOppositeFace(ChunkMeshFace face)
+{
+	// The faces are in +/- pairs
+	return (ChunkMeshFace)(face ^ 1);
+}
+
+int ChunkMesher::GetBorderSlice(ChunkMeshFace face)
+{
+	// The positive faces are on the last slice
+	return ((face & 1) == 0) ? Chunk::CHUNK_SIZE - 1 : 0;
+}
+
+// Level of detail
+void ChunkMesher::ReduceColours(const unsigned int* pColours, int lodLevel, unsigned int* pReducedColours)
+{
+	const int size = Chunk::CHUNK_SIZE;
+
+	if (lodLevel <= 0)
+	{
+		memcpy(pReducedColours, pColours, Chunk::CHUNK_SIZE_CUBED * sizeof(unsigned int));
+		return;
+	}
+	if (lodLevel >= NUM_LOD_LEVELS)
+	{
+		lodLevel = NUM_LOD_LEVELS - 1;
+	}
+
+	int cellSize = 1 << lodLevel;
+	int cellVolume = cellSize * cellSize * cellSize;
+
+	// The active blocks of a cell, colour in the top half and scan order in the bottom half. Sorted so that the same colours are
+	// next to each other, the scan goes from the top of the cell down so the order breaks ties in favour of the highest block.
+	const int maxCellSize = 1 << (NUM_LOD_LEVELS - 1);
+	unsigned long long cellColours[maxCellSize * maxCellSize * maxCellSize];
+
+	for (int cellZ = 0; cellZ < size; cellZ += cellSize)
+	{
+		for (int cellY = 0; cellY < size; cellY += cellSize)
+		{
+			for (int cellX = 0; cellX < size; cellX += cellSize)
+			{
+				int numActive = 0;
+				for (int y = cellY + cellSize - 1; y >= cellY; y--)
+				{
+					for (int z = cellZ; z < cellZ + cellSize; z++)
+					{
+						for (int x = cellX; x < cellX + cellSize; x++)
+						{
+							unsigned int colour = pColours[x + y * size + z * Chunk::CHUNK_SIZE_SQUARED];
+							if ((colour & 0xFF000000) != 0)
+							{
+								cellColours[numActive] = ((unsigned long long)colour << 32) | (unsigned int)numActive;
+								numActive++;
+							}
+						}
+					}
+				}
+
+				unsigned int cellColour = 0;
+				if (numActive * 2 >= cellVolume)
+				{
+					sort(cellColours, cellColours + numActive);
+
+					int bestCount = 0;
+					unsigned int bestOrder = 0;
+					int runStart = 0;
+					for (int i = 1; i <= numActive; i++)
+					{
+						if (i == numActive || (cellColours[i] >> 32) != (cellColours[runStart] >> 32))
+						{
+							int count = i - runStart;
+							unsigned int order = (unsigned int)(cellColours[runStart] & 0xFFFFFFFF);
+							if (count > bestCount || (count == bestCount && order < bestOrder))
+							{
+								bestCount = count;
+								bestOrder = order;
+								cellColour = (unsigned int)(cellColours[runStart] >> 32);
+							}
+							runStart = i;
+						}
+					}
+				}
+
+				for (int z = cellZ; z < cellZ + cellSize; z++)
+				{
+					for (int y = cellY; y < cellY + cellSize; y++)
+					{
+						for (int x = cellX; x < cellX + cellSize; x++)
+						{
+							pReducedColours[x + y * size + z * Chunk::CHUNK_SIZE_SQUARED] = cellColour;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+int ChunkMesher::SelectLODLevel(float distance, int currentLevel, float lodDistance, float hysteresis)
+{
+	if (lodDistance <= 0.0f)
+	{
+		return 0;
+	}
+
+	// Level n starts at lodDistance * 2^(n-1)
+	int level = 0;
+	float levelStart = lodDistance;
+	while (level < NUM_LOD_LEVELS - 1)
+	{
+		// Stay on the side of the boundary that we are already on, until we are past it by the hysteresis
+		float boundary = levelStart;
+		if (currentLevel > level)
+		{
+			boundary -= hysteresis;
+		}
+		else
+		{
+			boundary += hysteresis;
+		}
+
+		if (distance < boundary)
+		{
+			break;
+		}
+
+		level++;
+		levelStart *= 2.0f;
+	}
+
+	return level;
+}
+
+unsigned int ChunkMesher::GetNeighbourRow(Chunk* pNeighbour, int x, int y, int z, int stepX, int stepY, int stepZ)
+{
+	// Same rules as the per block mesher: no neighbour hides the face, a neighbour that isn't setup yet shows it
+	if (pNeighbour == NULL)
+	{
+		return FULL_ROW;
+	}
+	if (pNeighbour->IsSetup() == false)
+	{
+		return 0;
+	}
+
+	unsigned int row = 0;
+	for (int i = 0; i < Chunk::CHUNK_SIZE; i++)
+	{
+		if (pNeighbour->GetActive(x + i * stepX, y + i * stepY, z + i * stepZ))
+		{
+			row |= (1u << i);
+		}
+	}
+
+	return row;
+}
+
+void ChunkMesher::SetupBlocks(const unsigned int* pColours)
+{
+	const int size = Chunk::CHUNK_SIZE;
+
+	// A row along x is built up in a local and stored once, this runs for every block of every chunk that is meshed
+	for (int z = 0; z < size; z++)
+	{
+		for (int y = 0; y < size; y++)
+		{
+			int rowStart = y * size + z * Chunk::CHUNK_SIZE_SQUARED;
+			const unsigned int* pRowColours = &pColours[rowStart];
+			unsigned int* pMesherColours = &m_colours[rowStart];
+			unsigned int row = 0;
+
+			for (int x = 0; x < size; x++)
+			{
+				unsigned int colour = pRowColours[x];
+				pMesherColours[x] = colour & 0x00FFFFFF;
+
+				if ((colour & 0xFF000000) != 0)
+				{
+					row |= (1u << x);
+					m_occupancyZ[x + 1][y] |= (1u << z);
+				}
+			}
+
+			m_occupancyX[z + 1][y + 1] = row;
+		}
+	}
+}
+
+void ChunkMesher::CreateSliceQuads(ChunkMeshFace face, int slice, bool faceMerging, ChunkMeshQuadList* pQuads)
+{
+	const int size = Chunk::CHUNK_SIZE;
+
+	// Each slice is walked as rows (v) of bits (u), the strides map u, v and the slice back to a block index
+	int strideU = 1;
+	int strideV = size;
+	int strideSlice = Chunk::CHUNK_SIZE_SQUARED;
+	bool borderSlice = false;
+	bool rowMajor = false;
+	switch (face)
+	{
+	case ChunkMeshFace_Front:
+	case ChunkMeshFace_Back:
+	{
+		borderSlice = (face == ChunkMeshFace_Front) ? (slice == size - 1) : (slice == 0);
+	}
+	break;
+	case ChunkMeshFace_Right:
+	case ChunkMeshFace_Left:
+	{
+		strideU = Chunk::CHUNK_SIZE_SQUARED;
+		strideSlice = 1;
+		borderSlice = (face == ChunkMeshFace_Right) ? (slice == size - 1) : (slice == 0);
+		rowMajor = true;
+	}
+	break;
+	case ChunkMeshFace_Top:
+	case ChunkMeshFace_Bottom:
+	{
+		strideV = Chunk::CHUNK_SIZE_SQUARED;
+		strideSlice = size;
+		borderSlice = (face == ChunkMeshFace_Top) ? (slice == size - 1) : (slice == 0);
+	}
+	break;
+	default:
+		return;
+	}
+
+	// A face is visible when the block is active and the block in front of it isn't
+	unsigned int activeRows[Chunk::CHUNK_SIZE];
+	unsigned int faceRows[Chunk::CHUNK_SIZE];
+	unsigned int anyFaces = 0;
+	for (int v = 0; v < size; v++)
+	{
+		switch (face)
+		{
+		case ChunkMeshFace_Front:  { activeRows[v] = m_occupancyX[slice + 1][v + 1]; faceRows[v] = activeRows[v] & ~m_occupancyX[slice + 2][v + 1]; } break;
+		case ChunkMeshFace_Back:   { activeRows[v] = m_occupancyX[slice + 1][v + 1]; faceRows[v] = activeRows[v] & ~m_occupancyX[slice][v + 1]; } break;
+		case ChunkMeshFace_Right:  { activeRows[v] = m_occupancyZ[slice + 1][v]; faceRows[v] = activeRows[v] & ~m_occupancyZ[slice + 2][v]; } break;
+		case ChunkMeshFace_Left:   { activeRows[v] = m_occupancyZ[slice + 1][v]; faceRows[v] = activeRows[v] & ~m_occupancyZ[slice][v]; } break;
+		case ChunkMeshFace_Top:    { activeRows[v] = m_occupancyX[v + 1][slice + 1]; faceRows[v] = activeRows[v] & ~m_occupancyX[v + 1][slice + 2]; } break;
+		case ChunkMeshFace_Bottom: { activeRows[v] = m_occupancyX[v + 1][slice + 1]; faceRows[v] = activeRows[v] & ~m_occupancyX[v + 1][slice]; } break;
+		default: break;
+		}
+
+		anyFaces |= faceRows[v];
+	}
+
+	if (anyFaces == 0)
+	{
+		return;
+	}
+
+	// The merging is order dependant, so visit the starting blocks in the same order as the per block mesher's x, y, z loops
+	unsigned int merged[Chunk::CHUNK_SIZE];
+	memset(merged, 0, sizeof(merged));
+
+	for (int outer = 0; outer < size; outer++)
+	{
+		for (int inner = 0; inner < size; inner++)
+		{
+			int u = rowMajor ? inner : outer;
+			int v = rowMajor ? outer : inner;
+
+			if (((faceRows[v] & ~merged[v]) & (1u << u)) == 0)
+			{
+				continue;
+			}
+
+			unsigned int colour = m_colours[u * strideU + v * strideV + slice * strideSlice];
+			int width = 1;
+			int height = 1;
+
+			if (faceMerging)
+			{
+				// Grow along the row while the faces are visible, not merged and the same colour. Quads on the chunk
+				// border are never widened, unless this is a reduced mesh.
+				if (borderSlice == false || m_mergeBorderQuads)
+				{
+					unsigned int available = faceRows[v] & ~merged[v];
+					while (u + width < size && (available & (1u << (u + width))) != 0 && m_colours[(u + width) * strideU + v * strideV + slice * strideSlice] == colour)
+					{
+						width++;
+					}
+				}
+
+				// Then grow over the following rows while the whole width matches. On the chunk border this only looks
+				// for active blocks, since the per block mesher doesn't check the neighbour chunk when merging.
+				unsigned int widthMask = ((1u << width) - 1) << u;
+				unsigned int* pHeightRows = (borderSlice && m_mergeBorderQuads == false) ? activeRows : faceRows;
+				while (v + height < size)
+				{
+					int row = v + height;
+					if (((pHeightRows[row] & ~merged[row]) & widthMask) != widthMask)
+					{
+						break;
+					}
+
+					bool sameColour = true;
+					for (int i = u; i < u + width && sameColour; i++)
+					{
+						sameColour = (m_colours[i * strideU + row * strideV + slice * strideSlice] == colour);
+					}
+					if (sameColour == false)
+					{
+						break;
+					}
+
+					merged[row] |= widthMask;
+					height++;
+				}
+
+				merged[v] |= widthMask;
+			}
+
+			ChunkMeshQuad quad;
+			quad.m_width = width;
+			quad.m_height = height;
+			quad.m_face = face;
+			quad.m_colour = colour;
+			switch (face)
+			{
+			case ChunkMeshFace_Front:
+			case ChunkMeshFace_Back:   { quad.m_x = u; quad.m_y = v; quad.m_z = slice; } break;
+			case ChunkMeshFace_Right:
+			case ChunkMeshFace_Left:   { quad.m_x = slice; quad.m_y = v; quad.m_z = u; } break;
+			case ChunkMeshFace_Top:
+			case ChunkMeshFace_Bottom: { quad.m_x = u; quad.m_y = slice; quad.m_z = v; } break;
+			default: break;
+			}
+
+			pQuads->push_back(quad);
+		}
+	}
+}
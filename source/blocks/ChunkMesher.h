@@ -0,0 +1,162 @@
+// ******************************************************************************
+// Filename:    ChunkMesher.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Greedy chunk mesher. The chunk's blocks are first packed into occupancy
+//   bitmasks, one bit per block, with a one block border copied from the
+//   neighbouring chunks. The visible faces of a whole row are then found with
+//   a single mask operation and merged together into quads, slice by slice.
+//   The quads match exactly what the per block mesher in Chunk::CreateMesh
+//   produces, the mesher only outputs quads so that it can run headless.
+//
+//   The quads come out in face and slice order, so a chunk can keep them and
+//   when a few blocks are edited only the slices next to the edited region
+//   are remeshed, the quads from every other slice are copied across.
+//
+//   Far away chunks can be meshed at a lower level of detail, where the blocks
+//   are first reduced into 2, 4 or 8 block cells. The reduced mesh always has
+//   faces on the chunk border, so that the walls hide the cracks between
+//   chunks at different levels of detail.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "Chunk.h"
+
+#include <vector>
+using namespace std;
+
+enum ChunkMeshFace
+{
+	ChunkMeshFace_Front = 0,	// +z
+	ChunkMeshFace_Back,			// -z
+	ChunkMeshFace_Right,		// +x
+	ChunkMeshFace_Left,			// -x
+	ChunkMeshFace_Top,			// +y
+	ChunkMeshFace_Bottom,		// -y
+
+	ChunkMeshFace_NumFaces,
+};
+
+class ChunkMeshQuad
+{
+public:
+	// The starting block of the quad
+	int m_x;
+	int m_y;
+	int m_z;
+
+	// Size in blocks, front/back faces span x by y, right/left faces span z by y and top/bottom faces span x by z
+	int m_width;
+	int m_height;
+
+	ChunkMeshFace m_face;
+	unsigned int m_colour;
+};
+
+typedef vector<ChunkMeshQuad> ChunkMeshQuadList;
+
+// The quads of a chunk's last mesh, and where each slice's quads start
+class ChunkMeshQuadCache
+{
+public:
+	ChunkMeshQuadList m_vQuads;
+
+	// The quads of slice s of face f are [m_sliceStart[f*CHUNK_SIZE + s], m_sliceStart[f*CHUNK_SIZE + s + 1])
+	unsigned short m_sliceStart[ChunkMeshFace_NumFaces * Chunk::CHUNK_SIZE + 1];
+
+	bool m_faceMerging;
+
+	int GetMemoryBytes()
+	{
+		return (int)(sizeof(ChunkMeshQuadCache) + m_vQuads.capacity() * sizeof(ChunkMeshQuad));
+	}
+};
+
+
+class ChunkMesher
+{
+public:
+	/* Public methods */
+	ChunkMesher();
+	~ChunkMesher();
+
+	// Copy the chunk and its neighbour borders into the occupancy masks, a NULL neighbour is treated as solid
+	void SetupOccupancy(Chunk* pChunk, Chunk* pxMinus, Chunk* pxPlus, Chunk* pyMinus, Chunk* pyPlus, Chunk* pzMinus, Chunk* pzPlus);
+
+	// Same from a colour array indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED], with every neighbour treated as solid
+	void SetupOccupancy(const unsigned int* pColours);
+
+	// Reduce the colour array to the level of detail and copy it into the occupancy masks, with every neighbour treated as empty
+	void SetupLODOccupancy(const unsigned int* pColours, int lodLevel);
+
+	// Create the quads for all the visible faces
+	void CreateQuads(bool faceMerging, ChunkMeshQuadList* pQuads);
+
+	// Same, keeping where each slice starts in the cache
+	void CreateQuads(bool faceMerging, ChunkMeshQuadCache* pCache);
+
+	// Only remesh the slices that the edited region can change, and the border slices of the dirty border faces (1 << ChunkMeshFace)
+	// that edits in the neighbours can change. The cache must be from the same chunk. Returns the number of slices that were remeshed.
+	int UpdateQuads(const ChunkMeshRegion& editedRegion, unsigned int dirtyBorderFaces, ChunkMeshQuadCache* pCache);
+
+	// The slices of a face that an edit to the region can change, INCLUSIVE. A block's faces depend on the block next to it,
+	// so the slices either side of the region are included.
+	static void GetDirtySlices(ChunkMeshFace face, const ChunkMeshRegion& editedRegion, int* pStartSlice, int* pEndSlice);
+
+	// The border face of the neighbour that shares the chunk's face, e.g. our right border is the left border of the chunk on our right
+	static ChunkMeshFace GetOppositeFace(ChunkMeshFace face);
+
+	// The slice on the chunk border that the face points out of
+	static int GetBorderSlice(ChunkMeshFace face);
+
+	// Level of detail, 0 is full detail and each level halves the resolution. Cells of (1 << lodLevel) blocks are solid
+	// when at least half of their blocks are, and take the most common colour, the highest block wins a tie.
+	static void ReduceColours(const unsigned int* pColours, int lodLevel, unsigned int* pReducedColours);
+
+	// The level of detail for a chunk at this distance. Each level starts twice as far away as the last one, and a chunk
+	// has to move the hysteresis distance past a boundary before its level changes, so it doesn't keep flipping.
+	static int SelectLODLevel(float distance, int currentLevel, float lodDistance, float hysteresis);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void SetupBlocks(const unsigned int* pColours);
+	static unsigned int GetNeighbourRow(Chunk* pNeighbour, int x, int y, int z, int stepX, int stepY, int stepZ);
+
+	void CreateSliceQuads(ChunkMeshFace face, int slice, bool faceMerging, ChunkMeshQuadList* pQuads);
+
+public:
+	/* Public members */
+	static const int PADDED_CHUNK_SIZE = Chunk::CHUNK_SIZE + 2;
+	static const int NUM_LOD_LEVELS = 4;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	// Occupancy rows along x (bit x), indexed [z+1][y+1] so that the neighbour borders are included
+	unsigned int m_occupancyX[PADDED_CHUNK_SIZE][PADDED_CHUNK_SIZE];
+
+	// Occupancy rows along z (bit z), indexed [x+1][y] so that the x neighbour borders are included
+	unsigned int m_occupancyZ[PADDED_CHUNK_SIZE][Chunk::CHUNK_SIZE];
+
+	// Block colours without the alpha, the per block mesher ignores alpha when merging
+	unsigned int m_colours[Chunk::CHUNK_SIZE_CUBED];
+
+	// Quads on the chunk border are only widened in reduced meshes, full detail meshes match the per block mesher
+	bool m_mergeBorderQuads;
+
+	// Scratch list for UpdateQuads(), swapped with the cache's list
+	ChunkMeshQuadList m_vUpdateQuads;
+};
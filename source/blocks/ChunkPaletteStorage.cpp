@@ -0,0 +1,535 @@
+// ******************************************************************************
+// Filename:    ChunkPaletteStorage.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ChunkPaletteStorage.h"
+#include "../tinythread/tinythread.h"
+
+#include <string.h>
+
+
+std::atomic<long long> ChunkPaletteStorage::c_totalMemoryBytes(0);
+std::atomic<int> ChunkPaletteStorage::c_numStorages(0);
+
+ChunkPaletteStorage::ChunkPaletteStorage()
+{
+	m_memoryBytes = 0;
+
+	m_generation.store(0);
+	m_numReaders[0].store(0);
+	m_numReaders[1].store(0);
+	m_pSnapshot.store(NULL);
+
+	c_numStorages++;
+
+	// Empty air
+	FillLocked(0, BlockType_Default);
+}
+
+ChunkPaletteStorage::~ChunkPaletteStorage()
+{
+	DeleteSnapshot(m_pSnapshot.load());
+	m_pSnapshot.store(NULL);
+
+	c_totalMemoryBytes -= m_memoryBytes;
+	c_numStorages--;
+}
+
+// Blocks
+unsigned int ChunkPaletteStorage::GetColour(int index)
+{
+	unsigned int generation;
+	const ChunkPaletteSnapshot* pSnapshot = BeginRead(&generation);
+	unsigned int colour = pSnapshot->m_pColours[GetPaletteIndex(pSnapshot, index)];
+	EndRead(generation);
+
+	return colour;
+}
+
+BlockType ChunkPaletteStorage::GetBlockType(int index)
+{
+	unsigned int generation;
+	const ChunkPaletteSnapshot* pSnapshot = BeginRead(&generation);
+	BlockType blockType = pSnapshot->m_pBlockTypes[GetPaletteIndex(pSnapshot, index)];
+	EndRead(generation);
+
+	return blockType;
+}
+
+bool ChunkPaletteStorage::GetActive(int index)
+{
+	// Blocks with a zero alpha are empty
+	return (GetColour(index) & 0xFF000000) != 0;
+}
+
+bool ChunkPaletteStorage::SetBlock(int index, unsigned int colour, BlockType blockType)
+{
+	m_lock.lock();
+	bool changed = SetBlockLocked(index, colour, blockType);
+	m_lock.unlock();
+
+	return changed;
+}
+
+bool ChunkPaletteStorage::SetColour(int index, unsigned int colour)
+{
+	m_lock.lock();
+	bool changed = SetBlockLocked(index, colour, m_vPalette[GetPaletteIndex(m_pSnapshot.load(std::memory_order_relaxed), index)].m_blockType);
+	m_lock.unlock();
+
+	return changed;
+}
+
+bool ChunkPaletteStorage::SetBlockType(int index, BlockType blockType)
+{
+	m_lock.lock();
+	bool changed = SetBlockLocked(index, m_vPalette[GetPaletteIndex(m_pSnapshot.load(std::memory_order_relaxed), index)].m_colour, blockType);
+	m_lock.unlock();
+
+	return changed;
+}
+
+void ChunkPaletteStorage::Fill(unsigned int colour, BlockType blockType)
+{
+	m_lock.lock();
+	FillLocked(colour, blockType);
+	m_lock.unlock();
+}
+
+void ChunkPaletteStorage::FillRange(int index, int numBlocks, unsigned int colour, BlockType blockType)
+{
+	m_lock.lock();
+	if (index == 0 && numBlocks == NUM_BLOCKS)
+	{
+		FillLocked(colour, blockType);
+	}
+	else
+	{
+		for (int i = index; i < index + numBlocks; i++)
+		{
+			SetBlockLocked(i, colour, blockType);
+		}
+	}
+	m_lock.unlock();
+}
+
+void ChunkPaletteStorage::GetBlocks(unsigned int* pColours, BlockType* pBlockTypes)
+{
+	unsigned int generation;
+	const ChunkPaletteSnapshot* pSnapshot = BeginRead(&generation);
+	for (int i = 0; i < NUM_BLOCKS; i++)
+	{
+		int paletteIndex = GetPaletteIndex(pSnapshot, i);
+		if (pColours != NULL)
+		{
+			pColours[i] = pSnapshot->m_pColours[paletteIndex];
+		}
+		if (pBlockTypes != NULL)
+		{
+			pBlockTypes[i] = pSnapshot->m_pBlockTypes[paletteIndex];
+		}
+	}
+	EndRead(generation);
+}
+
+void ChunkPaletteStorage::Compact()
+{
+	m_lock.lock();
+	if (m_pSnapshot.load(std::memory_order_relaxed)->m_pIndices != NULL)
+	{
+		// Move the used entries down to the start of the palette
+		vector<int> vRemap(m_vPalette.size(), 0);
+		int numEntries = 0;
+		for (unsigned int i = 0; i < m_vPalette.size(); i++)
+		{
+			if (m_vPalette[i].m_numBlocks > 0)
+			{
+				vRemap[i] = numEntries;
+				m_vPalette[numEntries] = m_vPalette[i];
+				numEntries++;
+			}
+		}
+
+		int bitsPerBlock = 1;
+		while ((1 << bitsPerBlock) < numEntries)
+		{
+			bitsPerBlock *= 2;
+		}
+
+		if (numEntries == 1)
+		{
+			FillLocked(m_vPalette[0].m_colour, m_vPalette[0].m_blockType);
+		}
+		else
+		{
+			// Shrink the palette to fit
+			ChunkPaletteEntryList vPalette(m_vPalette.begin(), m_vPalette.begin() + numEntries);
+			m_vPalette.swap(vPalette);
+			m_lastPaletteIndex = 0;
+
+			PublishSnapshot(bitsPerBlock, &vRemap[0]);
+		}
+	}
+	m_lock.unlock();
+}
+
+// Counters
+bool ChunkPaletteStorage::IsUniform()
+{
+	m_lock.lock();
+	bool uniform = (m_pSnapshot.load(std::memory_order_relaxed)->m_pIndices == NULL);
+	m_lock.unlock();
+
+	return uniform;
+}
+
+int ChunkPaletteStorage::GetNumPaletteEntries()
+{
+	m_lock.lock();
+	int numEntries = m_numUsedEntries;
+	m_lock.unlock();
+
+	return numEntries;
+}
+
+int ChunkPaletteStorage::GetBitsPerBlock()
+{
+	m_lock.lock();
+	int bitsPerBlock = m_pSnapshot.load(std::memory_order_relaxed)->m_bitsPerBlock;
+	m_lock.unlock();
+
+	return bitsPerBlock;
+}
+
+int ChunkPaletteStorage::GetMemoryBytes()
+{
+	m_lock.lock();
+	int memoryBytes = m_memoryBytes;
+	m_lock.unlock();
+
+	return memoryBytes;
+}
+
+long long ChunkPaletteStorage::GetTotalMemoryBytes()
+{
+	return c_totalMemoryBytes;
+}
+
+int ChunkPaletteStorage::GetNumStorages()
+{
+	return c_numStorages;
+}
+
+// Palette indices
+int ChunkPaletteStorage::GetPaletteIndex(const ChunkPaletteSnapshot* pSnapshot, int index)
+{
+	if (pSnapshot->m_pIndices == NULL)
+	{
+		return 0;
+	}
+
+	// Acquire, so that a palette entry added for this index is seen as well
+	unsigned int word = pSnapshot->m_pIndices[index >> pSnapshot->m_blocksPerWordShift].load(std::memory_order_acquire);
+	int shift = (index & ((1 << pSnapshot->m_blocksPerWordShift) - 1)) * pSnapshot->m_bitsPerBlock;
+
+	return (int)((word >> shift) & pSnapshot->m_indexMask);
+}
+
+void ChunkPaletteStorage::SetPaletteIndex(int index, int paletteIndex)
+{
+	ChunkPaletteSnapshot* pSnapshot = m_pSnapshot.load(std::memory_order_relaxed);
+	std::atomic<unsigned int>* pWord = &pSnapshot->m_pIndices[index >> pSnapshot->m_blocksPerWordShift];
+	int shift = (index & ((1 << pSnapshot->m_blocksPerWordShift) - 1)) * pSnapshot->m_bitsPerBlock;
+
+	// Only the writer holding the lock changes the words, so this doesn't need to be a compare and swap
+	unsigned int word = pWord->load(std::memory_order_relaxed);
+	pWord->store((word & ~(pSnapshot->m_indexMask << shift)) | ((unsigned int)paletteIndex << shift), std::memory_order_release);
+}
+
+int ChunkPaletteStorage::FindOrAddPaletteEntry(unsigned int colour, BlockType blockType)
+{
+	const ChunkPaletteEntry& lastEntry = m_vPalette[m_lastPaletteIndex];
+	if (lastEntry.m_colour == colour && lastEntry.m_blockType == blockType)
+	{
+		return m_lastPaletteIndex;
+	}
+
+	int freeIndex = -1;
+	for (unsigned int i = 0; i < m_vPalette.size(); i++)
+	{
+		if (m_vPalette[i].m_colour == colour && m_vPalette[i].m_blockType == blockType)
+		{
+			m_lastPaletteIndex = i;
+			return i;
+		}
+
+		if (freeIndex == -1 && m_vPalette[i].m_numBlocks == 0)
+		{
+			freeIndex = i;
+		}
+	}
+
+	ChunkPaletteSnapshot* pSnapshot = m_pSnapshot.load(std::memory_order_relaxed);
+	int numEntries = (int)m_vPalette.size();
+	int maxEntries = (pSnapshot->m_pIndices == NULL) ? 1 : (int)pSnapshot->m_indexMask + 1;
+
+	ChunkPaletteEntry entry;
+	entry.m_colour = colour;
+	entry.m_blockType = blockType;
+	entry.m_numBlocks = 0;
+
+	if (numEntries < maxEntries && (numEntries < NUM_BLOCKS || freeIndex == -1))
+	{
+		// A new entry that no index points to yet, readers can't see it until an index does
+		m_vPalette.push_back(entry);
+		freeIndex = numEntries;
+
+		if (freeIndex < pSnapshot->m_paletteCapacity)
+		{
+			pSnapshot->m_pColours[freeIndex] = colour;
+			pSnapshot->m_pBlockTypes[freeIndex] = blockType;
+			UpdateMemoryBytes();
+		}
+		else
+		{
+			PublishSnapshot(pSnapshot->m_bitsPerBlock, NULL);
+		}
+	}
+	else if (freeIndex != -1)
+	{
+		// A reader can still have an index to the unused entry, so it can't be changed in place
+		m_vPalette[freeIndex] = entry;
+		PublishSnapshot(pSnapshot->m_bitsPerBlock, NULL);
+	}
+	else
+	{
+		// Widen the indices when the palette outgrows them
+		m_vPalette.push_back(entry);
+		freeIndex = numEntries;
+		PublishSnapshot((pSnapshot->m_bitsPerBlock == 0) ? 1 : pSnapshot->m_bitsPerBlock * 2, NULL);
+	}
+
+	m_lastPaletteIndex = freeIndex;
+
+	return freeIndex;
+}
+
+bool ChunkPaletteStorage::SetBlockLocked(int index, unsigned int colour, BlockType blockType)
+{
+	int oldPaletteIndex = GetPaletteIndex(m_pSnapshot.load(std::memory_order_relaxed), index);
+	if (m_vPalette[oldPaletteIndex].m_colour == colour && m_vPalette[oldPaletteIndex].m_blockType == blockType)
+	{
+		return false;
+	}
+
+	int newPaletteIndex = FindOrAddPaletteEntry(colour, blockType);
+
+	m_vPalette[oldPaletteIndex].m_numBlocks--;
+	if (m_vPalette[oldPaletteIndex].m_numBlocks == 0)
+	{
+		m_numUsedEntries--;
+	}
+	if (m_vPalette[newPaletteIndex].m_numBlocks == 0)
+	{
+		m_numUsedEntries++;
+	}
+	m_vPalette[newPaletteIndex].m_numBlocks++;
+
+	if (m_vPalette[newPaletteIndex].m_numBlocks == NUM_BLOCKS)
+	{
+		// Every block is the same again
+		FillLocked(colour, blockType);
+	}
+	else
+	{
+		SetPaletteIndex(index, newPaletteIndex);
+	}
+
+	return true;
+}
+
+void ChunkPaletteStorage::FillLocked(unsigned int colour, BlockType blockType)
+{
+	ChunkPaletteEntry entry;
+	entry.m_colour = colour;
+	entry.m_blockType = blockType;
+	entry.m_numBlocks = NUM_BLOCKS;
+
+	ChunkPaletteEntryList vPalette(1, entry);
+	m_vPalette.swap(vPalette);
+	m_numUsedEntries = 1;
+	m_lastPaletteIndex = 0;
+
+	PublishSnapshot(0, NULL);
+}
+
+void ChunkPaletteStorage::UpdateMemoryBytes()
+{
+	int memoryBytes = (int)sizeof(ChunkPaletteStorage) + (int)(m_vPalette.capacity() * sizeof(ChunkPaletteEntry));
+	memoryBytes += GetSnapshotMemoryBytes(m_pSnapshot.load(std::memory_order_relaxed));
+
+	c_totalMemoryBytes += memoryBytes - m_memoryBytes;
+	m_memoryBytes = memoryBytes;
+}
+
+// Snapshots
+ChunkPaletteSnapshot* ChunkPaletteStorage::CreateSnapshot(int bitsPerBlock, int paletteCapacity)
+{
+	ChunkPaletteSnapshot* pSnapshot = new ChunkPaletteSnapshot();
+	pSnapshot->m_paletteCapacity = paletteCapacity;
+	pSnapshot->m_pColours = new unsigned int[paletteCapacity];
+	pSnapshot->m_pBlockTypes = new BlockType[paletteCapacity];
+
+	pSnapshot->m_pIndices = NULL;
+	pSnapshot->m_bitsPerBlock = bitsPerBlock;
+	pSnapshot->m_blocksPerWordShift = 0;
+	pSnapshot->m_indexMask = 0;
+
+	if (bitsPerBlock > 0)
+	{
+		while ((1 << pSnapshot->m_blocksPerWordShift) * bitsPerBlock < 32)
+		{
+			pSnapshot->m_blocksPerWordShift++;
+		}
+		pSnapshot->m_indexMask = (1u << bitsPerBlock) - 1;
+
+		int numWords = NUM_BLOCKS >> pSnapshot->m_blocksPerWordShift;
+		pSnapshot->m_pIndices = new std::atomic<unsigned int>[numWords];
+		for (int i = 0; i < numWords; i++)
+		{
+			pSnapshot->m_pIndices[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	return pSnapshot;
+}
+
+void ChunkPaletteStorage::DeleteSnapshot(ChunkPaletteSnapshot* pSnapshot)
+{
+	if (pSnapshot != NULL)
+	{
+		delete [] pSnapshot->m_pColours;
+		delete [] pSnapshot->m_pBlockTypes;
+		delete [] pSnapshot->m_pIndices;
+		delete pSnapshot;
+	}
+}
+
+int ChunkPaletteStorage::GetSnapshotMemoryBytes(const ChunkPaletteSnapshot* pSnapshot)
+{
+	int memoryBytes = (int)sizeof(ChunkPaletteSnapshot) + pSnapshot->m_paletteCapacity * (int)(sizeof(unsigned int) + sizeof(BlockType));
+	if (pSnapshot->m_pIndices != NULL)
+	{
+		memoryBytes += (NUM_BLOCKS >> pSnapshot->m_blocksPerWordShift) * (int)sizeof(unsigned int);
+	}
+
+	return memoryBytes;
+}
+
+void ChunkPaletteStorage::PublishSnapshot(int bitsPerBlock, const int* pRemap)
+{
+	ChunkPaletteSnapshot* pOldSnapshot = m_pSnapshot.load(std::memory_order_relaxed);
+
+	// Leave room to add entries in place, up to what the bit width can index
+	int numEntries = (int)m_vPalette.size();
+	int paletteCapacity = 1;
+	if (bitsPerBlock > 0)
+	{
+		paletteCapacity = 4;
+		while (paletteCapacity < numEntries * 2)
+		{
+			paletteCapacity *= 2;
+		}
+		if (paletteCapacity > (1 << bitsPerBlock))
+		{
+			paletteCapacity = 1 << bitsPerBlock;
+		}
+	}
+
+	ChunkPaletteSnapshot* pNewSnapshot = CreateSnapshot(bitsPerBlock, paletteCapacity);
+	for (int i = 0; i < numEntries; i++)
+	{
+		pNewSnapshot->m_pColours[i] = m_vPalette[i].m_colour;
+		pNewSnapshot->m_pBlockTypes[i] = m_vPalette[i].m_blockType;
+	}
+
+	// Copy the old indices across, every index was zero if we didn't have any
+	if (pNewSnapshot->m_pIndices != NULL && pOldSnapshot != NULL && pOldSnapshot->m_pIndices != NULL)
+	{
+		int shift = 0;
+		int wordIndex = 0;
+		unsigned int word = 0;
+		for (int i = 0; i < NUM_BLOCKS; i++)
+		{
+			int paletteIndex = GetPaletteIndex(pOldSnapshot, i);
+			if (pRemap != NULL)
+			{
+				paletteIndex = pRemap[paletteIndex];
+			}
+
+			word |= (unsigned int)paletteIndex << shift;
+			shift += bitsPerBlock;
+			if (shift == 32 || i == NUM_BLOCKS - 1)
+			{
+				pNewSnapshot->m_pIndices[wordIndex].store(word, std::memory_order_relaxed);
+				wordIndex++;
+				word = 0;
+				shift = 0;
+			}
+		}
+	}
+
+	// Readers from now on find the new snapshot, once the ones from the old generation are done the old one can go
+	m_pSnapshot.store(pNewSnapshot, std::memory_order_seq_cst);
+	if (pOldSnapshot != NULL)
+	{
+		unsigned int oldGeneration = m_generation.fetch_add(1, std::memory_order_seq_cst);
+		WaitForReaders(oldGeneration);
+
+		DeleteSnapshot(pOldSnapshot);
+	}
+
+	UpdateMemoryBytes();
+}
+
+const ChunkPaletteSnapshot* ChunkPaletteStorage::BeginRead(unsigned int* pGeneration)
+{
+	// Register as a reader of the current generation. If a writer moved on before we were counted it might not wait
+	// for us, so try again in the new generation.
+	unsigned int generation;
+	while (true)
+	{
+		generation = m_generation.load(std::memory_order_seq_cst);
+		m_numReaders[generation & 1].fetch_add(1, std::memory_order_seq_cst);
+		if (m_generation.load(std::memory_order_seq_cst) == generation)
+		{
+			break;
+		}
+		m_numReaders[generation & 1].fetch_sub(1, std::memory_order_release);
+	}
+
+	*pGeneration = generation;
+
+	return m_pSnapshot.load(std::memory_order_acquire);
+}
+
+void ChunkPaletteStorage::EndRead(unsigned int generation)
+{
+	m_numReaders[generation & 1].fetch_sub(1, std::memory_order_release);
+}
+
+void ChunkPaletteStorage::WaitForReaders(unsigned int generation)
+{
+	// Reads are a single lookup, or one pass over the chunk for GetBlocks(), so this is short unless a reader was descheduled
+	while (m_numReaders[generation & 1].load(std::memory_order_acquire) != 0)
+	{
+		tthread::this_thread::yield();
+	}
+}
@@ -0,0 +1,158 @@
+// ******************************************************************************
+// Filename:    ChunkPaletteStorage.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Palette compressed block storage for a chunk. Every different colour and
+//   block type pair in the chunk is stored once in a palette, and each block
+//   just stores its palette index, packed using as few bits as the palette
+//   size needs (1, 2, 4, 8 or 16). A chunk that is all one block, like the
+//   empty air chunks and solid underground chunks, has no indices at all.
+//
+//   A chunk can be written by its own generation job, by the neighbouring
+//   chunks generating into it and by the main thread, so writes take the
+//   storage's lock. Reads never do, they are on the collision, ray cast,
+//   particle and meshing paths of several threads at once. The palette and
+//   the indices are published together as a snapshot, a write that keeps the
+//   palette and the bit width changes an index in place, any other write
+//   publishes a new snapshot and frees the old one once its readers are
+//   done, the same way as the chunk hash table frees its old tables.
+//   Use GetBlocks() to read a whole chunk in one go.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "BlocksEnum.h"
+
+#include <atomic>
+#include <vector>
+using namespace std;
+
+#include "../tinythread/fast_mutex.h"
+
+class ChunkPaletteEntry
+{
+public:
+	unsigned int m_colour;
+	BlockType m_blockType;
+
+	// How many blocks use this entry, unused entries are reused once the palette is full for the bit width
+	int m_numBlocks;
+};
+
+typedef vector<ChunkPaletteEntry> ChunkPaletteEntryList;
+
+// What the readers see, never changed once published except for the index words and the entries past the end of the palette
+class ChunkPaletteSnapshot
+{
+public:
+	int m_paletteCapacity;
+	unsigned int* m_pColours;
+	BlockType* m_pBlockTypes;
+
+	// Packed palette indices, NULL when every block uses the first palette entry
+	std::atomic<unsigned int>* m_pIndices;
+	int m_bitsPerBlock;
+	int m_blocksPerWordShift;
+	unsigned int m_indexMask;
+};
+
+
+class ChunkPaletteStorage
+{
+public:
+	/* Public methods */
+	ChunkPaletteStorage();
+	~ChunkPaletteStorage();
+
+	// Blocks, indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED]. Lock free.
+	unsigned int GetColour(int index);
+	BlockType GetBlockType(int index);
+	bool GetActive(int index);
+
+	// Return true if the block changed
+	bool SetBlock(int index, unsigned int colour, BlockType blockType);
+	bool SetColour(int index, unsigned int colour);
+	bool SetBlockType(int index, BlockType blockType);
+
+	// Sets every block, freeing the indices
+	void Fill(unsigned int colour, BlockType blockType);
+
+	// Sets numBlocks blocks starting from index
+	void FillRange(int index, int numBlocks, unsigned int colour, BlockType blockType);
+
+	// Unpacks every block, either list can be NULL. Lock free.
+	void GetBlocks(unsigned int* pColours, BlockType* pBlockTypes);
+
+	// Throws away the unused palette entries and packs the indices as small as they will go
+	void Compact();
+
+	// Counters
+	bool IsUniform();
+	int GetNumPaletteEntries();
+	int GetBitsPerBlock();
+	int GetMemoryBytes();
+
+	// All of the storage that currently exists
+	static long long GetTotalMemoryBytes();
+	static int GetNumStorages();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	static int GetPaletteIndex(const ChunkPaletteSnapshot* pSnapshot, int index);
+	void SetPaletteIndex(int index, int paletteIndex);
+	int FindOrAddPaletteEntry(unsigned int colour, BlockType blockType);
+	bool SetBlockLocked(int index, unsigned int colour, BlockType blockType);
+	void FillLocked(unsigned int colour, BlockType blockType);
+	void UpdateMemoryBytes();
+
+	// Snapshots
+	static ChunkPaletteSnapshot* CreateSnapshot(int bitsPerBlock, int paletteCapacity);
+	static void DeleteSnapshot(ChunkPaletteSnapshot* pSnapshot);
+	static int GetSnapshotMemoryBytes(const ChunkPaletteSnapshot* pSnapshot);
+	void PublishSnapshot(int bitsPerBlock, const int* pRemap);
+	const ChunkPaletteSnapshot* BeginRead(unsigned int* pGeneration);
+	void EndRead(unsigned int generation);
+	void WaitForReaders(unsigned int generation);
+
+public:
+	/* Public members */
+	static const int NUM_BLOCKS = 16 * 16 * 16;
+	static const int MAX_BITS_PER_BLOCK = 16;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	// Only taken by the writers
+	tthread::fast_mutex m_lock;
+
+	// The writers' copy of the palette, with the block counts
+	ChunkPaletteEntryList m_vPalette;
+	int m_numUsedEntries;
+
+	// Consecutive blocks are usually the same, so check the last entry we found first
+	int m_lastPaletteIndex;
+
+	std::atomic<ChunkPaletteSnapshot*> m_pSnapshot;
+
+	// Readers register in the count for the current generation before they load the snapshot. Publishing moves on to
+	// the next generation and waits for the count of the old one to drain, then nobody can still be reading the old snapshot.
+	std::atomic<unsigned int> m_generation;
+	std::atomic<int> m_numReaders[2];
+
+	int m_memoryBytes;
+
+	static std::atomic<long long> c_totalMemoryBytes;
+	static std::atomic<int> c_numStorages;
+};
@@ -0,0 +1,220 @@
+// ******************************************************************************
+// Filename:    ChunkStorageTable.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ChunkStorageTable.h"
+#include "../utils/TimeUtils.h"
+
+#include <algorithm>
+
+
+ChunkStorageTable::ChunkStorageTable()
+{
+	m_numStorages = 0;
+	m_numEdits = 0;
+	m_memoryBytes = 0;
+	m_numEditsApplied = 0;
+	m_applyTime = 0.0;
+}
+
+ChunkStorageTable::~ChunkStorageTable()
+{
+	ClearStorage();
+}
+
+void ChunkStorageTable::ClearStorage()
+{
+	// Anything that was stored for chunks that never got loaded
+	m_storageLock.lock();
+	for (ChunkStorageLoaderMap::iterator iter = m_storageMap.begin(); iter != m_storageMap.end(); ++iter)
+	{
+		delete iter->second;
+	}
+	m_storageMap.clear();
+
+	m_numStorages = 0;
+	m_numEdits = 0;
+	m_memoryBytes = 0;
+	m_storageLock.unlock();
+}
+
+void ChunkStorageTable::AddEdits(const ChunkStorageEditRequestList& vEdits)
+{
+	if (vEdits.size() == 0)
+	{
+		return;
+	}
+
+	// Hold the lock for all the edits, so that two chunk workers can't create the same storage and a chunk can't be added half way through
+	m_storageLock.lock();
+	ChunkStorageLoader* pStorage = NULL;
+	Chunk* pChunk = NULL;
+	vector<Chunk*> vpBatchUpdateChunks;
+	for (unsigned int i = 0; i < vEdits.size(); i++)
+	{
+		const ChunkStorageEditRequest& request = vEdits[i];
+
+		// Imports go through the blocks column by column, so consecutive edits are usually for the same chunk
+		bool sameChunk = (pChunk != NULL && pChunk->GetGridX() == request.m_gridX && pChunk->GetGridY() == request.m_gridY && pChunk->GetGridZ() == request.m_gridZ);
+		bool sameStorage = (pStorage != NULL && pStorage->m_gridX == request.m_gridX && pStorage->m_gridY == request.m_gridY && pStorage->m_gridZ == request.m_gridZ);
+		if (sameChunk == false && sameStorage == false)
+		{
+			unsigned long long key = PackKey(request.m_gridX, request.m_gridY, request.m_gridZ);
+			pChunk = NULL;
+			pStorage = NULL;
+
+			// The chunk has already applied its storage, so anything stored for it now would never be applied
+			ChunkStorageChunkMap::iterator chunkIter = m_chunkMap.find(key);
+			if (chunkIter != m_chunkMap.end())
+			{
+				pChunk = chunkIter->second;
+				if (find(vpBatchUpdateChunks.begin(), vpBatchUpdateChunks.end(), pChunk) == vpBatchUpdateChunks.end())
+				{
+					vpBatchUpdateChunks.push_back(pChunk);
+					pChunk->StartBatchUpdate();
+				}
+			}
+			else
+			{
+				ChunkStorageLoader*& pMapStorage = m_storageMap[key];
+				if (pMapStorage == NULL)
+				{
+					pMapStorage = new ChunkStorageLoader(request.m_gridX, request.m_gridY, request.m_gridZ);
+					m_memoryBytes += pMapStorage->GetMemoryBytes();
+					m_numStorages++;
+				}
+				pStorage = pMapStorage;
+			}
+		}
+
+		if (pChunk != NULL)
+		{
+			pChunk->ApplyStorageEdit(request.m_blockX, request.m_blockY, request.m_blockZ, request.m_colour, request.m_sourceKey);
+			continue;
+		}
+
+		int numEdits = (int)pStorage->m_vEdits.size();
+		int memoryBytes = pStorage->GetMemoryBytes();
+
+		pStorage->SetBlockColour(request.m_blockX, request.m_blockY, request.m_blockZ, request.m_colour, request.m_sourceKey);
+
+		m_numEdits += (int)pStorage->m_vEdits.size() - numEdits;
+		m_memoryBytes += pStorage->GetMemoryBytes() - memoryBytes;
+	}
+
+	for (unsigned int i = 0; i < vpBatchUpdateChunks.size(); i++)
+	{
+		vpBatchUpdateChunks[i]->StopBatchUpdate();
+	}
+	m_storageLock.unlock();
+}
+
+void ChunkStorageTable::AddChunk(Chunk* pChunk)
+{
+	m_storageLock.lock();
+	unsigned long long key = PackKey(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ());
+
+	ChunkStorageLoader* pStorage = TakeStorageLocked(key);
+	if (pStorage != NULL)
+	{
+		double startTime = GetHighResolutionTime();
+		pChunk->ApplyChunkStorage(pStorage);
+
+		m_numEditsApplied += (int)pStorage->m_vEdits.size();
+		m_applyTime += GetHighResolutionTime() - startTime;
+
+		delete pStorage;
+	}
+
+	m_chunkMap[key] = pChunk;
+	m_storageLock.unlock();
+}
+
+void ChunkStorageTable::RemoveChunk(Chunk* pChunk)
+{
+	m_storageLock.lock();
+	ChunkStorageChunkMap::iterator iter = m_chunkMap.find(PackKey(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ()));
+	if (iter != m_chunkMap.end() && iter->second == pChunk)
+	{
+		m_chunkMap.erase(iter);
+	}
+	m_storageLock.unlock();
+}
+
+ChunkStorageLoader* ChunkStorageTable::TakeStorage(int gridX, int gridY, int gridZ)
+{
+	m_storageLock.lock();
+	ChunkStorageLoader* pStorage = TakeStorageLocked(PackKey(gridX, gridY, gridZ));
+	m_storageLock.unlock();
+
+	return pStorage;
+}
+
+ChunkStorageLoader* ChunkStorageTable::TakeStorageLocked(unsigned long long key)
+{
+	ChunkStorageLoaderMap::iterator iter = m_storageMap.find(key);
+	if (iter == m_storageMap.end())
+	{
+		return NULL;
+	}
+
+	ChunkStorageLoader* pStorage = iter->second;
+	m_storageMap.erase(iter);
+
+	m_numStorages--;
+	m_numEdits -= (int)pStorage->m_vEdits.size();
+	m_memoryBytes -= pStorage->GetMemoryBytes();
+
+	return pStorage;
+}
+
+void ChunkStorageTable::AddApplied(int numEdits, double applyTime)
+{
+	m_storageLock.lock();
+	m_numEditsApplied += numEdits;
+	m_applyTime += applyTime;
+	m_storageLock.unlock();
+}
+
+// Counters
+int ChunkStorageTable::GetNumStorages()
+{
+	return m_numStorages;
+}
+
+int ChunkStorageTable::GetNumEdits()
+{
+	return m_numEdits;
+}
+
+int ChunkStorageTable::GetMemoryBytes()
+{
+	return m_memoryBytes;
+}
+
+int ChunkStorageTable::GetNumEditsApplied()
+{
+	return m_numEditsApplied;
+}
+
+float ChunkStorageTable::GetApplyMilliseconds()
+{
+	return (float)(m_applyTime * 1000.0);
+}
+
+unsigned long long ChunkStorageTable::PackKey(int x, int y, int z)
+{
+	// 21 bits for each grid co-ordinate, the same packing as the chunk hash table
+	unsigned long long packedX = (unsigned long long)(x & 0x1FFFFF);
+	unsigned long long packedY = (unsigned long long)(y & 0x1FFFFF);
+	unsigned long long packedZ = (unsigned long long)(z & 0x1FFFFF);
+
+	return (packedX << 42) | (packedY << 21) | packedZ;
+}
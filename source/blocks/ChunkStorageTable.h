@@ -0,0 +1,176 @@
+// ******************************************************************************
+// Filename:    ChunkStorageTable.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The blocks that were generated or imported into chunks that are not loaded
+//   yet, like the leaves of a tree that spill over into the next chunk. Each
+//   chunk only gets a short list of edits, and the lists are kept in a hash
+//   map keyed by the chunk grid, so finding a chunk's storage doesn't depend on
+//   how many other chunks have something stored. A chunk is added to the table
+//   when it is setup, which applies all of its stored edits in one go, and any
+//   edits for it after that go straight into the chunk until it is removed.
+//   Every edit keeps the chunk that generated it, and where two edits overlap
+//   the one from the higher source wins, so the world comes out the same
+//   whichever order the chunks were generated in.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "Chunk.h"
+
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+// A block that was generated or imported into a chunk before the chunk was loaded
+class ChunkStorageEdit
+{
+public:
+	// Indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED]
+	unsigned short m_index;
+	unsigned int m_colour;
+
+	// The packed grid of the chunk that generated the edit
+	unsigned long long m_sourceKey;
+
+	static bool LowestSourceFirst(const ChunkStorageEdit &lhs, const ChunkStorageEdit &rhs)
+	{
+		return lhs.m_sourceKey < rhs.m_sourceKey;
+	}
+};
+
+typedef vector<ChunkStorageEdit> ChunkStorageEditList;
+
+class ChunkStorageLoader
+{
+public:
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+
+	// In the order they were made, the chunk sorts them by source when they are applied
+	ChunkStorageEditList m_vEdits;
+
+	ChunkStorageLoader(int x, int y, int z)
+	{
+		m_gridX = x;
+		m_gridY = y;
+		m_gridZ = z;
+	}
+
+	void SetBlockColour(int x, int y, int z, unsigned int colour, unsigned long long sourceKey)
+	{
+		ChunkStorageEdit edit;
+		edit.m_index = (unsigned short)(x + y * Chunk::CHUNK_SIZE + z * Chunk::CHUNK_SIZE_SQUARED);
+		edit.m_colour = colour;
+		edit.m_sourceKey = sourceKey;
+
+		// The same block twice in a row is common when imports overlap, just replace it
+		if (m_vEdits.size() > 0 && m_vEdits.back().m_index == edit.m_index && m_vEdits.back().m_sourceKey == sourceKey)
+		{
+			m_vEdits.back().m_colour = colour;
+		}
+		else
+		{
+			m_vEdits.push_back(edit);
+		}
+	}
+
+	int GetMemoryBytes()
+	{
+		return (int)(sizeof(ChunkStorageLoader) + m_vEdits.capacity() * sizeof(ChunkStorageEdit));
+	}
+};
+
+// Keyed by the packed chunk grid co-ordinates
+typedef unordered_map<unsigned long long, ChunkStorageLoader*> ChunkStorageLoaderMap;
+typedef unordered_map<unsigned long long, Chunk*> ChunkStorageChunkMap;
+
+// An edit that is worked out without holding the table lock, and then added in bulk
+class ChunkStorageEditRequest
+{
+public:
+	int m_gridX;
+	int m_gridY;
+	int m_gridZ;
+	int m_blockX;
+	int m_blockY;
+	int m_blockZ;
+	unsigned int m_colour;
+	unsigned long long m_sourceKey;
+};
+
+typedef vector<ChunkStorageEditRequest> ChunkStorageEditRequestList;
+
+
+class ChunkStorageTable
+{
+public:
+	/* Public methods */
+	static unsigned long long PackKey(int x, int y, int z);
+
+	ChunkStorageTable();
+	~ChunkStorageTable();
+
+	void ClearStorage();
+
+	// Adds all of the edits with the lock held once, edits for chunks that have been added go straight into the chunk
+	void AddEdits(const ChunkStorageEditRequestList& vEdits);
+
+	// Applies whatever was stored for the chunk and then sends it any later edits, with the lock held for both so nothing is missed in between
+	void AddChunk(Chunk* pChunk);
+	// Later edits for the chunk are stored again, call this before the chunk is saved for the last time
+	void RemoveChunk(Chunk* pChunk);
+
+	// Removes the chunk's storage and hands it to the caller to apply and delete, NULL if nothing was stored for the chunk
+	ChunkStorageLoader* TakeStorage(int gridX, int gridY, int gridZ);
+
+	// Called once a chunk has applied its storage
+	void AddApplied(int numEdits, double applyTime);
+
+	// Counters
+	int GetNumStorages();
+	int GetNumEdits();
+	int GetMemoryBytes();
+	int GetNumEditsApplied();
+	float GetApplyMilliseconds();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	ChunkStorageLoader* TakeStorageLocked(unsigned long long key);
+
+public:
+	/* Public members */
+	// The source of imports that aren't part of world generation, higher than any chunk so they win over generated blocks
+	static const unsigned long long IMPORT_SOURCE_KEY = 0xFFFFFFFFFFFFFFFFULL;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	ChunkStorageLoaderMap m_storageMap;
+	tthread::mutex m_storageLock;
+
+	// The chunks that have applied their storage, and that edits are now written into
+	ChunkStorageChunkMap m_chunkMap;
+
+	// Only changed with the storage lock held
+	int m_numStorages;
+	int m_numEdits;
+	int m_memoryBytes;
+	int m_numEditsApplied;
+	double m_applyTime;
+};
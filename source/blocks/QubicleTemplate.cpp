@@ -0,0 +1,294 @@
+// ******************************************************************************
+// Filename:    QubicleTemplate.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include <stdio.h>
+
+#include "QubicleTemplate.h"
+#include "../models/QubicleBinary.h"
+#include "../utils/FileUtils.h"
+
+
+QubicleTemplate::QubicleTemplate()
+{
+}
+
+QubicleTemplate::~QubicleTemplate()
+{
+}
+
+bool QubicleTemplate::Load(const char* filename)
+{
+	m_filename = filename;
+
+	FILE* pQBfile = NULL;
+	fopen_s(&pQBfile, filename, "rb");
+
+	if (pQBfile == NULL)
+	{
+		return false;
+	}
+
+	char version[4];
+	unsigned int colourFormat = 0;
+	unsigned int zAxisOrientation = 0;
+	unsigned int compressed = 0;
+	unsigned int visibilityMaskEncoded = 0;
+	unsigned int numMatrices = 0;
+
+	bool ok = fread(&version[0], sizeof(char) * 4, 1, pQBfile) == 1;
+	ok = ok && fread(&colourFormat, sizeof(unsigned int), 1, pQBfile) == 1;
+	ok = ok && fread(&zAxisOrientation, sizeof(unsigned int), 1, pQBfile) == 1;
+	ok = ok && fread(&compressed, sizeof(unsigned int), 1, pQBfile) == 1;
+	ok = ok && fread(&visibilityMaskEncoded, sizeof(unsigned int), 1, pQBfile) == 1;
+	ok = ok && fread(&numMatrices, sizeof(unsigned int), 1, pQBfile) == 1;
+
+	for (unsigned int i = 0; i < numMatrices && ok; i++)
+	{
+		unsigned char nameLength = 0;
+		char name[256];
+		unsigned int sizeX = 0;
+		unsigned int sizeY = 0;
+		unsigned int sizeZ = 0;
+		int posX = 0;
+		int posY = 0;
+		int posZ = 0;
+
+		ok = fread(&nameLength, sizeof(char), 1, pQBfile) == 1;
+		ok = ok && (nameLength == 0 || fread(&name[0], sizeof(char) * nameLength, 1, pQBfile) == 1);
+		ok = ok && fread(&sizeX, sizeof(unsigned int), 1, pQBfile) == 1;
+		ok = ok && fread(&sizeY, sizeof(unsigned int), 1, pQBfile) == 1;
+		ok = ok && fread(&sizeZ, sizeof(unsigned int), 1, pQBfile) == 1;
+		ok = ok && fread(&posX, sizeof(int), 1, pQBfile) == 1;
+		ok = ok && fread(&posY, sizeof(int), 1, pQBfile) == 1;
+		ok = ok && fread(&posZ, sizeof(int), 1, pQBfile) == 1;
+
+		if (ok == false)
+		{
+			break;
+		}
+
+		vector<unsigned int> colours(sizeX * sizeY * sizeZ, 0);
+		ok = colours.empty() || QubicleBinary::ReadMatrixColours(pQBfile, compressed, sizeX, sizeY, sizeZ, &colours[0]);
+
+		if (ok)
+		{
+			// Work out every import direction now, so that stamping never has to
+			for (int direction = 0; direction < QubicleImportDirection_NumDirections; direction++)
+			{
+				QubicleTemplateMatrix templateMatrix;
+				CreateTemplateMatrix(sizeX, sizeY, sizeZ, colours.empty() ? NULL : &colours[0], (QubicleImportDirection)direction, &templateMatrix);
+
+				m_vMatrices[direction].push_back(templateMatrix);
+			}
+		}
+	}
+
+	fclose(pQBfile);
+
+	return ok;
+}
+
+string QubicleTemplate::GetFilename()
+{
+	return m_filename;
+}
+
+int QubicleTemplate::GetNumMatrices(QubicleImportDirection direction)
+{
+	return (int)m_vMatrices[direction].size();
+}
+
+const QubicleTemplateMatrix* QubicleTemplate::GetMatrix(QubicleImportDirection direction, int index)
+{
+	return &m_vMatrices[direction][index];
+}
+
+void QubicleTemplate::CreateTemplateMatrix(unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ, const unsigned int* pColour, QubicleImportDirection direction, QubicleTemplateMatrix* pTemplateMatrix)
+{
+	bool mirrorX = false;
+	bool mirrorY = false;
+	bool mirrorZ = false;
+	bool flipXZ = false;
+	bool flipXY = false;
+	bool flipYZ = false;
+
+	switch (direction)
+	{
+	case QubicleImportDirection_Normal: {  } break;
+	case QubicleImportDirection_MirrorX: { mirrorX = true; } break;
+	case QubicleImportDirection_MirrorY: { mirrorY = true; } break;
+	case QubicleImportDirection_MirrorZ: { mirrorZ = true; } break;
+	case QubicleImportDirection_RotateY90: { mirrorX = true; flipXZ = true; } break;
+	case QubicleImportDirection_RotateY180: { mirrorX = true; mirrorZ = true; } break;
+	case QubicleImportDirection_RotateY270: { mirrorZ = true; flipXZ = true; } break;
+	case QubicleImportDirection_RotateX90: { mirrorZ = true; flipYZ = true; } break;
+	case QubicleImportDirection_RotateX180: { mirrorZ = true; mirrorY = true; } break;
+	case QubicleImportDirection_RotateX270: { mirrorY = true; flipYZ = true; } break;
+	case QubicleImportDirection_RotateZ90: { mirrorY = true; flipXY = true; } break;
+	case QubicleImportDirection_RotateZ180: { mirrorX = true; mirrorY = true; } break;
+	case QubicleImportDirection_RotateZ270: { mirrorX = true; flipXY = true; } break;
+	default: break;
+	}
+
+	unsigned int xValueToUse = sizeX;
+	unsigned int yValueToUse = sizeY;
+	unsigned int zValueToUse = sizeZ;
+	if (flipXZ)
+	{
+		xValueToUse = sizeZ;
+		zValueToUse = sizeX;
+	}
+	if (flipXY)
+	{
+		xValueToUse = sizeY;
+		yValueToUse = sizeX;
+	}
+	if (flipYZ)
+	{
+		yValueToUse = sizeZ;
+		zValueToUse = sizeY;
+	}
+
+	pTemplateMatrix->m_sizeX = xValueToUse;
+	pTemplateMatrix->m_sizeY = yValueToUse;
+	pTemplateMatrix->m_sizeZ = zValueToUse;
+	pTemplateMatrix->m_vBlocks.clear();
+
+	int xPosition = 0;
+	if (mirrorX)
+		xPosition = xValueToUse - 1;
+
+	for (unsigned int x = 0; x < xValueToUse; x++)
+	{
+		int yPosition = 0;
+		if (mirrorY)
+			yPosition = yValueToUse - 1;
+
+		for (unsigned int y = 0; y < yValueToUse; y++)
+		{
+			int zPosition = 0;
+			if (mirrorZ)
+				zPosition = zValueToUse - 1;
+
+			for (unsigned int z = 0; z < zValueToUse; z++)
+			{
+				int xPosition_modified = xPosition;
+				int yPosition_modified = yPosition;
+				int zPosition_modified = zPosition;
+				if (flipXZ)
+				{
+					xPosition_modified = zPosition;
+					zPosition_modified = xPosition;
+				}
+				if (flipXY)
+				{
+					xPosition_modified = yPosition;
+					yPosition_modified = xPosition;
+				}
+				if (flipYZ)
+				{
+					yPosition_modified = zPosition;
+					zPosition_modified = yPosition;
+				}
+
+				unsigned int colour = pColour[xPosition_modified + sizeX * (yPosition_modified + sizeY * zPosition_modified)];
+				if ((colour & 0xFF000000) != 0)
+				{
+					QubicleTemplateBlock block;
+					block.m_x = x;
+					block.m_y = y;
+					block.m_z = z;
+					block.m_colour = colour;
+
+					pTemplateMatrix->m_vBlocks.push_back(block);
+				}
+
+				if (mirrorZ)
+					zPosition--;
+				else
+					zPosition++;
+			}
+
+			if (mirrorY)
+				yPosition--;
+			else
+				yPosition++;
+		}
+
+		if (mirrorX)
+			xPosition--;
+		else
+			xPosition++;
+	}
+}
+
+
+QubicleTemplateCache::QubicleTemplateCache()
+{
+	m_numCacheHits = 0;
+	m_numCacheMisses = 0;
+}
+
+QubicleTemplateCache::~QubicleTemplateCache()
+{
+	ClearTemplates();
+}
+
+void QubicleTemplateCache::ClearTemplates()
+{
+	m_templatesLock.lock();
+	for (QubicleTemplateMap::iterator it = m_templates.begin(); it != m_templates.end(); it++)
+	{
+		delete it->second;
+	}
+	m_templates.clear();
+	m_templatesLock.unlock();
+}
+
+QubicleTemplate* QubicleTemplateCache::GetTemplate(const char* filename)
+{
+	m_templatesLock.lock();
+
+	QubicleTemplateMap::iterator it = m_templates.find(filename);
+	if (it != m_templates.end())
+	{
+		m_numCacheHits++;
+		QubicleTemplate* pTemplate = it->second;
+		m_templatesLock.unlock();
+
+		return pTemplate;
+	}
+
+	// Load while holding the lock, so that two workers asking for the same new template only read the file once
+	m_numCacheMisses++;
+	QubicleTemplate* pTemplate = new QubicleTemplate();
+	if (pTemplate->Load(filename) == false)
+	{
+		delete pTemplate;
+		pTemplate = NULL;
+	}
+	m_templates[filename] = pTemplate;
+
+	m_templatesLock.unlock();
+
+	return pTemplate;
+}
+
+// Counters
+int QubicleTemplateCache::GetNumCacheHits()
+{
+	return m_numCacheHits;
+}
+
+int QubicleTemplateCache::GetNumCacheMisses()
+{
+	return m_numCacheMisses;
+}
@@ -0,0 +1,135 @@
+// ******************************************************************************
+// Filename:    QubicleTemplate.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Qubicle templates are the voxel data of a qubicle binary file, read once
+//   and kept for stamping into the world chunks (trees, cacti, etc). Unlike a
+//   QubicleBinary a template has no render mesh, and all of the import
+//   directions are worked out when the template is loaded, so stamping it is
+//   just a walk over a list of blocks. Templates never change once they are
+//   loaded and can be shared between all of the chunk workers.
+//   The template cache owns the loaded templates, keyed by filename.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "BlocksEnum.h"
+
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+class QubicleTemplateBlock
+{
+public:
+	// Block position inside the (rotated) matrix
+	int m_x;
+	int m_y;
+	int m_z;
+
+	unsigned int m_colour;
+};
+
+typedef vector<QubicleTemplateBlock> QubicleTemplateBlockList;
+
+class QubicleTemplateMatrix
+{
+public:
+	// Matrix dimensions after applying the import direction, the matrix is centered on x and z when stamped
+	unsigned int m_sizeX;
+	unsigned int m_sizeY;
+	unsigned int m_sizeZ;
+
+	// Only the active blocks
+	QubicleTemplateBlockList m_vBlocks;
+};
+
+typedef vector<QubicleTemplateMatrix> QubicleTemplateMatrixList;
+
+
+class QubicleTemplate
+{
+public:
+	/* Public methods */
+	QubicleTemplate();
+	~QubicleTemplate();
+
+	bool Load(const char* filename);
+
+	string GetFilename();
+
+	int GetNumMatrices(QubicleImportDirection direction);
+	const QubicleTemplateMatrix* GetMatrix(QubicleImportDirection direction, int index);
+
+	// Build the blocks of a matrix for an import direction, also used for importing from a live QubicleBinary
+	static void CreateTemplateMatrix(unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ, const unsigned int* pColour, QubicleImportDirection direction, QubicleTemplateMatrix* pTemplateMatrix);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	string m_filename;
+
+	QubicleTemplateMatrixList m_vMatrices[QubicleImportDirection_NumDirections];
+};
+
+typedef map<string, QubicleTemplate*> QubicleTemplateMap;
+
+
+class QubicleTemplateCache
+{
+public:
+	/* Public methods */
+	QubicleTemplateCache();
+	~QubicleTemplateCache();
+
+	void ClearTemplates();
+
+	// Returns NULL if the file can't be loaded, failed loads are remembered so the file isn't read again
+	QubicleTemplate* GetTemplate(const char* filename);
+
+	// Counters
+	int GetNumCacheHits();
+	int GetNumCacheMisses();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	tthread::mutex m_templatesLock;
+	QubicleTemplateMap m_templates;
+
+	// Counters
+	int m_numCacheHits;
+	int m_numCacheMisses;
+};
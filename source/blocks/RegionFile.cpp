@@ -0,0 +1,439 @@
+// ******************************************************************************
+// Filename:    RegionFile.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif //_WIN32
+#include <string.h>
+
+#include "RegionFile.h"
+#include "../utils/FileUtils.h"
+
+// Region file header is the 4 character file identifier, the version and then the offset table
+static const char REGION_FILE_IDENTIFIER[4] = { 'V', 'R', 'G', 'N' };
+static const int REGION_FILE_HEADER_SIZE = 2 + (RegionFile::REGION_SIZE_CUBED * 3);
+
+
+RegionFile::RegionFile(const char* filename, const RegionGridKeys& regionKey)
+{
+	m_pFile = NULL;
+	m_regionKey = regionKey;
+	m_fileSize = REGION_FILE_HEADER_SIZE;
+
+	for (int i = 0; i < REGION_SIZE_CUBED; i++)
+	{
+		m_offsetTable[i].m_offset = 0;
+		m_offsetTable[i].m_size = 0;
+		m_offsetTable[i].m_capacity = 0;
+	}
+
+	// Try to open an existing region file first
+	fopen_s(&m_pFile, filename, "r+b");
+	if (m_pFile != NULL)
+	{
+		char identifier[4];
+		unsigned int version = 0;
+		bool ok = fread(&identifier[0], sizeof(char) * 4, 1, m_pFile) == 1;
+		ok = ok && fread(&version, sizeof(unsigned int), 1, m_pFile) == 1;
+		ok = ok && memcmp(identifier, REGION_FILE_IDENTIFIER, 4) == 0 && version == REGION_FILE_VERSION;
+		ok = ok && fread(&m_offsetTable[0], sizeof(RegionFileEntry), REGION_SIZE_CUBED, m_pFile) == REGION_SIZE_CUBED;
+
+		if (ok)
+		{
+			fseek(m_pFile, 0, SEEK_END);
+			m_fileSize = (unsigned int)(ftell(m_pFile) / sizeof(unsigned int));
+
+			return;
+		}
+
+		// Not a valid region file, so start again with a fresh one
+		fclose(m_pFile);
+		m_pFile = NULL;
+
+		for (int i = 0; i < REGION_SIZE_CUBED; i++)
+		{
+			m_offsetTable[i].m_offset = 0;
+			m_offsetTable[i].m_size = 0;
+			m_offsetTable[i].m_capacity = 0;
+		}
+	}
+
+	fopen_s(&m_pFile, filename, "w+b");
+	if (m_pFile != NULL)
+	{
+		unsigned int version = REGION_FILE_VERSION;
+		fwrite(&REGION_FILE_IDENTIFIER[0], sizeof(char) * 4, 1, m_pFile);
+		fwrite(&version, sizeof(unsigned int), 1, m_pFile);
+		fwrite(&m_offsetTable[0], sizeof(RegionFileEntry), REGION_SIZE_CUBED, m_pFile);
+		fflush(m_pFile);
+	}
+}
+
+RegionFile::~RegionFile()
+{
+	if (m_pFile != NULL)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+}
+
+bool RegionFile::IsOpen()
+{
+	return m_pFile != NULL;
+}
+
+const RegionGridKeys& RegionFile::GetRegionKey()
+{
+	return m_regionKey;
+}
+
+// Chunk data
+bool RegionFile::ReadChunk(int index, vector<unsigned int>* pData)
+{
+	if (m_pFile == NULL || m_offsetTable[index].m_size == 0)
+	{
+		return false;
+	}
+
+	pData->resize(m_offsetTable[index].m_size);
+
+	fseek(m_pFile, m_offsetTable[index].m_offset * sizeof(unsigned int), SEEK_SET);
+	return fread(&(*pData)[0], sizeof(unsigned int), m_offsetTable[index].m_size, m_pFile) == m_offsetTable[index].m_size;
+}
+
+bool RegionFile::WriteChunk(int index, const vector<unsigned int>& data)
+{
+	if (m_pFile == NULL || data.empty())
+	{
+		return false;
+	}
+
+	unsigned int size = (unsigned int)data.size();
+
+	// Reuse the chunk's existing space if the new data fits, otherwise append it to the end of the file
+	if (size > m_offsetTable[index].m_capacity)
+	{
+		m_offsetTable[index].m_offset = m_fileSize;
+		m_offsetTable[index].m_capacity = size;
+		m_fileSize += size;
+	}
+	m_offsetTable[index].m_size = size;
+
+	fseek(m_pFile, m_offsetTable[index].m_offset * sizeof(unsigned int), SEEK_SET);
+	bool ok = fwrite(&data[0], sizeof(unsigned int), size, m_pFile) == size;
+	ok = ok && WriteOffsetTableEntry(index);
+	fflush(m_pFile);
+
+	return ok;
+}
+
+bool RegionFile::WriteOffsetTableEntry(int index)
+{
+	fseek(m_pFile, (2 + index * 3) * sizeof(unsigned int), SEEK_SET);
+	return fwrite(&m_offsetTable[index], sizeof(RegionFileEntry), 1, m_pFile) == 1;
+}
+
+
+RegionFileManager::RegionFileManager(const char* saveFolder)
+{
+	m_saveFolder = saveFolder;
+
+#ifdef _WIN32
+	_mkdir(saveFolder);
+#else
+	mkdir(saveFolder, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+#endif //_WIN32
+
+	m_maxOpenRegionFiles = 16;
+
+	m_writeInProgress = false;
+	m_shutdown = false;
+
+	m_numChunksSaved = 0;
+	m_numChunksLoaded = 0;
+	m_numRegionFilesClosed = 0;
+
+	m_pIOThread = new tthread::thread(_IOThread, this);
+}
+
+RegionFileManager::~RegionFileManager()
+{
+	// Make sure everything is written out before we close the region files
+	m_pendingWritesLock.lock();
+	m_shutdown = true;
+	m_pendingWritesAvailable.notify_all();
+	m_pendingWritesLock.unlock();
+
+	m_pIOThread->join();
+	delete m_pIOThread;
+	m_pIOThread = NULL;
+
+	for (RegionFileList::iterator it = m_vpRegionFileList.begin(); it != m_vpRegionFileList.end(); it++)
+	{
+		delete *it;
+	}
+	m_vpRegionFileList.clear();
+	m_regionFiles.clear();
+}
+
+// Chunk saving and loading
+void RegionFileManager::SaveChunkData(int gridX, int gridY, int gridZ, const vector<unsigned int>& data)
+{
+	RegionGridKeys chunkKey;
+	chunkKey.x = gridX;
+	chunkKey.y = gridY;
+	chunkKey.z = gridZ;
+
+	// If this chunk already has a write queued then just replace the data, only the latest version is written
+	m_pendingWritesLock.lock();
+	m_pendingWrites[chunkKey] = data;
+	m_pendingWritesAvailable.notify_one();
+	m_pendingWritesLock.unlock();
+}
+
+bool RegionFileManager::LoadChunkData(int gridX, int gridY, int gridZ, vector<unsigned int>* pData)
+{
+	RegionGridKeys chunkKey;
+	chunkKey.x = gridX;
+	chunkKey.y = gridY;
+	chunkKey.z = gridZ;
+
+	// A chunk that is still waiting to be written is loaded straight from the queue
+	m_pendingWritesLock.lock();
+	PendingChunkWriteMap::iterator it = m_pendingWrites.find(chunkKey);
+	if (it != m_pendingWrites.end())
+	{
+		*pData = it->second;
+		m_numChunksLoaded++;
+		m_pendingWritesLock.unlock();
+
+		return true;
+	}
+	m_pendingWritesLock.unlock();
+
+	m_regionFileLock.lock();
+	int chunkIndex = 0;
+	RegionFile* pRegionFile = GetRegionFile(gridX, gridY, gridZ, &chunkIndex);
+	bool loaded = pRegionFile->ReadChunk(chunkIndex, pData);
+	m_regionFileLock.unlock();
+
+	m_pendingWritesLock.lock();
+	if (loaded)
+	{
+		m_numChunksLoaded++;
+	}
+	m_regionFileLock.lock();
+	EvictRegionFiles();
+	m_regionFileLock.unlock();
+	m_pendingWritesLock.unlock();
+
+	return loaded;
+}
+
+void RegionFileManager::FlushPendingWrites()
+{
+	m_pendingWritesLock.lock();
+	while (m_pendingWrites.empty() == false || m_writeInProgress == true)
+	{
+		m_pendingWritesFlushed.wait(m_pendingWritesLock);
+	}
+	m_pendingWritesLock.unlock();
+}
+
+void RegionFileManager::SetMaxOpenRegionFiles(int maxOpenRegionFiles)
+{
+	m_pendingWritesLock.lock();
+	m_regionFileLock.lock();
+	m_maxOpenRegionFiles = maxOpenRegionFiles;
+	EvictRegionFiles();
+	m_regionFileLock.unlock();
+	m_pendingWritesLock.unlock();
+}
+
+int RegionFileManager::GetMaxOpenRegionFiles()
+{
+	return m_maxOpenRegionFiles;
+}
+
+// Counters
+int RegionFileManager::GetNumChunksSaved()
+{
+	return m_numChunksSaved;
+}
+
+int RegionFileManager::GetNumChunksLoaded()
+{
+	return m_numChunksLoaded;
+}
+
+int RegionFileManager::GetNumPendingWrites()
+{
+	m_pendingWritesLock.lock();
+	int numPendingWrites = (int)m_pendingWrites.size();
+	m_pendingWritesLock.unlock();
+
+	return numPendingWrites;
+}
+
+int RegionFileManager::GetNumOpenRegionFiles()
+{
+	m_regionFileLock.lock();
+	int numOpenRegionFiles = (int)m_vpRegionFileList.size();
+	m_regionFileLock.unlock();
+
+	return numOpenRegionFiles;
+}
+
+int RegionFileManager::GetNumRegionFilesClosed()
+{
+	return m_numRegionFilesClosed;
+}
+
+// IO thread
+void RegionFileManager::_IOThread(void* pData)
+{
+	RegionFileManager* lpRegionFileManager = (RegionFileManager*)pData;
+	lpRegionFileManager->IOThread();
+}
+
+void RegionFileManager::IOThread()
+{
+	while (true)
+	{
+		m_pendingWritesLock.lock();
+		while (m_pendingWrites.empty() && m_shutdown == false)
+		{
+			m_pendingWritesAvailable.wait(m_pendingWritesLock);
+		}
+
+		if (m_pendingWrites.empty() && m_shutdown == true)
+		{
+			m_pendingWritesLock.unlock();
+			break;
+		}
+
+		PendingChunkWriteMap::iterator it = m_pendingWrites.begin();
+		RegionGridKeys chunkKey = it->first;
+		vector<unsigned int> data;
+		data.swap(it->second);
+		m_pendingWrites.erase(it);
+		m_writeInProgress = true;
+
+		// Take the region lock before releasing the pending writes, so that a load can never see
+		// this chunk missing from both the queue and the region file
+		m_regionFileLock.lock();
+		m_pendingWritesLock.unlock();
+
+		int chunkIndex = 0;
+		RegionFile* pRegionFile = GetRegionFile(chunkKey.x, chunkKey.y, chunkKey.z, &chunkIndex);
+		bool saved = pRegionFile->WriteChunk(chunkIndex, data);
+		m_regionFileLock.unlock();
+
+		m_pendingWritesLock.lock();
+		if (saved)
+		{
+			m_numChunksSaved++;
+		}
+		m_regionFileLock.lock();
+		EvictRegionFiles();
+		m_regionFileLock.unlock();
+		m_writeInProgress = false;
+		if (m_pendingWrites.empty())
+		{
+			m_pendingWritesFlushed.notify_all();
+		}
+		m_pendingWritesLock.unlock();
+	}
+}
+
+RegionGridKeys RegionFileManager::GetRegionKey(int gridX, int gridY, int gridZ, int* chunkIndex)
+{
+	// Round towards negative infinity, so that negative chunk grids map to the correct region
+	RegionGridKeys regionKey;
+	regionKey.x = (gridX >= 0) ? (gridX / RegionFile::REGION_SIZE) : ((gridX + 1) / RegionFile::REGION_SIZE) - 1;
+	regionKey.y = (gridY >= 0) ? (gridY / RegionFile::REGION_SIZE) : ((gridY + 1) / RegionFile::REGION_SIZE) - 1;
+	regionKey.z = (gridZ >= 0) ? (gridZ / RegionFile::REGION_SIZE) : ((gridZ + 1) / RegionFile::REGION_SIZE) - 1;
+
+	int localX = gridX - (regionKey.x * RegionFile::REGION_SIZE);
+	int localY = gridY - (regionKey.y * RegionFile::REGION_SIZE);
+	int localZ = gridZ - (regionKey.z * RegionFile::REGION_SIZE);
+	*chunkIndex = localX + localY * RegionFile::REGION_SIZE + localZ * RegionFile::REGION_SIZE_SQUARED;
+
+	return regionKey;
+}
+
+// Must be called with the region file lock held
+RegionFile* RegionFileManager::GetRegionFile(int gridX, int gridY, int gridZ, int* chunkIndex)
+{
+	RegionGridKeys regionKey = GetRegionKey(gridX, gridY, gridZ, chunkIndex);
+
+	RegionFileMap::iterator it = m_regionFiles.find(regionKey);
+	if (it != m_regionFiles.end())
+	{
+		// Move to the front of the list, as the most recently used
+		m_vpRegionFileList.splice(m_vpRegionFileList.begin(), m_vpRegionFileList, it->second);
+
+		return *it->second;
+	}
+
+	char regionFilename[256];
+	sprintf(regionFilename, "%s/region_%i_%i_%i.region", m_saveFolder.c_str(), regionKey.x, regionKey.y, regionKey.z);
+
+	RegionFile* pRegionFile = new RegionFile(regionFilename, regionKey);
+	m_vpRegionFileList.push_front(pRegionFile);
+	m_regionFiles[regionKey] = m_vpRegionFileList.begin();
+
+	return pRegionFile;
+}
+
+// Must be called with the pending writes lock and then the region file lock held
+void RegionFileManager::EvictRegionFiles()
+{
+	// Close the least recently used region files, writing out any chunks still queued for them first
+	// so the region isn't opened again straight away just to take them
+	while ((int)m_vpRegionFileList.size() > m_maxOpenRegionFiles)
+	{
+		RegionFile* pRegionFile = m_vpRegionFileList.back();
+		RegionGridKeys regionKey = pRegionFile->GetRegionKey();
+
+		PendingChunkWriteMap::iterator it = m_pendingWrites.begin();
+		while (it != m_pendingWrites.end())
+		{
+			int chunkIndex = 0;
+			RegionGridKeys chunkRegionKey = GetRegionKey(it->first.x, it->first.y, it->first.z, &chunkIndex);
+			if (chunkRegionKey < regionKey || regionKey < chunkRegionKey)
+			{
+				it++;
+				continue;
+			}
+
+			if (pRegionFile->WriteChunk(chunkIndex, it->second))
+			{
+				m_numChunksSaved++;
+			}
+			m_pendingWrites.erase(it++);
+		}
+		if (m_pendingWrites.empty() && m_writeInProgress == false)
+		{
+			m_pendingWritesFlushed.notify_all();
+		}
+
+		m_regionFiles.erase(regionKey);
+		m_vpRegionFileList.pop_back();
+		m_numRegionFilesClosed++;
+
+		// Closing the file flushes it
+		delete pRegionFile;
+	}
+}
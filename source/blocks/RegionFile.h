@@ -0,0 +1,177 @@
+// ******************************************************************************
+// Filename:    RegionFile.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Region files group together REGION_SIZE^3 chunks into a single file on
+//   disk. Each region file starts with an offset table that stores where each
+//   chunk's (compressed) data lives in the file, so that a single chunk can be
+//   read or rewritten without touching the rest of the region.
+//   The region file manager keeps a small number of region files open, closing
+//   the least recently used, and a background IO thread that performs the chunk
+//   writes, so that unloading chunks never waits on the disk.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+struct RegionGridKeys {
+	int x;
+	int y;
+	int z;
+};
+
+inline bool const operator<(const RegionGridKeys& l, const RegionGridKeys& r) {
+	if (l.x < r.x)  return true;
+	if (l.x > r.x)  return false;
+
+	if (l.y < r.y)  return true;
+	if (l.y > r.y)  return false;
+
+	if (l.z < r.z)  return true;
+	if (l.z > r.z)  return false;
+
+	return false;
+};
+
+class RegionFileEntry
+{
+public:
+	unsigned int m_offset;
+	unsigned int m_size;
+	unsigned int m_capacity;
+};
+
+class RegionFile
+{
+public:
+	/* Public methods */
+	RegionFile(const char* filename, const RegionGridKeys& regionKey);
+	~RegionFile();
+
+	const RegionGridKeys& GetRegionKey();
+
+	bool IsOpen();
+
+	// Chunk data, the index is the chunk's local index inside the region
+	bool ReadChunk(int index, vector<unsigned int>* pData);
+	bool WriteChunk(int index, const vector<unsigned int>& data);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	bool WriteOffsetTableEntry(int index);
+
+public:
+	/* Public members */
+	static const int REGION_SIZE = 16;
+	static const int REGION_SIZE_SQUARED = REGION_SIZE * REGION_SIZE;
+	static const int REGION_SIZE_CUBED = REGION_SIZE * REGION_SIZE * REGION_SIZE;
+
+	static const unsigned int REGION_FILE_VERSION = 1;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	FILE* m_pFile;
+
+	RegionGridKeys m_regionKey;
+
+	// Offsets and sizes are in unsigned ints, not bytes
+	RegionFileEntry m_offsetTable[REGION_SIZE_CUBED];
+	unsigned int m_fileSize;
+};
+
+// Open region files, the most recently used at the front of the list
+typedef list<RegionFile*> RegionFileList;
+typedef map<RegionGridKeys, RegionFileList::iterator> RegionFileMap;
+typedef map<RegionGridKeys, vector<unsigned int> > PendingChunkWriteMap;
+
+
+class RegionFileManager
+{
+public:
+	/* Public methods */
+	RegionFileManager(const char* saveFolder);
+	~RegionFileManager();
+
+	// Chunk saving and loading, writes are queued and performed on the IO thread
+	void SaveChunkData(int gridX, int gridY, int gridZ, const vector<unsigned int>& data);
+	bool LoadChunkData(int gridX, int gridY, int gridZ, vector<unsigned int>* pData);
+
+	// Block until all the queued writes have hit the disk
+	void FlushPendingWrites();
+
+	// The most region files kept open at once
+	void SetMaxOpenRegionFiles(int maxOpenRegionFiles);
+	int GetMaxOpenRegionFiles();
+
+	// Counters
+	int GetNumChunksSaved();
+	int GetNumChunksLoaded();
+	int GetNumPendingWrites();
+	int GetNumOpenRegionFiles();
+	int GetNumRegionFilesClosed();
+
+	// IO thread
+	static void _IOThread(void* pData);
+	void IOThread();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	static RegionGridKeys GetRegionKey(int gridX, int gridY, int gridZ, int* chunkIndex);
+	RegionFile* GetRegionFile(int gridX, int gridY, int gridZ, int* chunkIndex);
+	void EvictRegionFiles();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	string m_saveFolder;
+
+	// Open region files, protected by the region file lock
+	tthread::mutex m_regionFileLock;
+	RegionFileList m_vpRegionFileList;
+	RegionFileMap m_regionFiles;
+	int m_maxOpenRegionFiles;
+
+	// Queued chunk writes, protected by the pending writes lock
+	tthread::mutex m_pendingWritesLock;
+	tthread::condition_variable m_pendingWritesAvailable;
+	tthread::condition_variable m_pendingWritesFlushed;
+	PendingChunkWriteMap m_pendingWrites;
+	bool m_writeInProgress;
+	bool m_shutdown;
+
+	// Counters
+	int m_numChunksSaved;
+	int m_numChunksLoaded;
+	int m_numRegionFilesClosed;
+
+	tthread::thread* m_pIOThread;
+};
@@ -0,0 +1,286 @@
+// ******************************************************************************
+// Filename:    TerrainGenerator.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "TerrainGenerator.h"
+
+#include "../utils/RandomGenerator.h"
+#include "../utils/Profiler.h"
+#include "../simplex/simplexnoise.h"
+
+#include <string.h>
+
+
+TerrainGenerator::TerrainGenerator()
+{
+	m_worldSeed = 0;
+	m_worldNoiseOffset = vec3(0.0f, 0.0f, 0.0f);
+
+	// The defaults from VoxSettings
+	m_landscapeOctaves = 4.0f;
+	m_landscapePersistence = 0.3f;
+	m_landscapeScale = 0.00725f;
+	m_mountainOctaves = 2.0f;
+	m_mountainPersistence = 0.3f;
+	m_mountainScale = 0.0072f;
+	m_mountainMultiplier = 3.0f;
+
+	m_getBiome = NULL;
+	m_getTownMultiplier = NULL;
+	m_getBlockColour = NULL;
+	m_pBiomeData = NULL;
+
+	m_pColumnCache = NULL;
+}
+
+TerrainGenerator::~TerrainGenerator()
+{
+}
+
+// World seed
+void TerrainGenerator::SetWorldSeed(unsigned int worldSeed)
+{
+	m_worldSeed = worldSeed;
+
+	// Each seed samples a different part of the noise
+	m_worldNoiseOffset = vec3(0.0f, 0.0f, 0.0f);
+	if (m_worldSeed != 0)
+	{
+		RandomGenerator worldRandom(RandomGenerator::HashSeed(m_worldSeed, 0, 0, 0));
+		m_worldNoiseOffset.x = (float)worldRandom.GetRandomNumber(-65536, 65536);
+		m_worldNoiseOffset.y = (float)worldRandom.GetRandomNumber(-65536, 65536);
+		m_worldNoiseOffset.z = (float)worldRandom.GetRandomNumber(-65536, 65536);
+	}
+}
+
+unsigned int TerrainGenerator::GetWorldSeed()
+{
+	return m_worldSeed;
+}
+
+vec3 TerrainGenerator::GetWorldNoiseOffset()
+{
+	return m_worldNoiseOffset;
+}
+
+// Landscape settings
+void TerrainGenerator::SetLandscape(float octaves, float persistence, float scale)
+{
+	m_landscapeOctaves = octaves;
+	m_landscapePersistence = persistence;
+	m_landscapeScale = scale;
+}
+
+void TerrainGenerator::SetMountains(float octaves, float persistence, float scale, float multiplier)
+{
+	m_mountainOctaves = octaves;
+	m_mountainPersistence = persistence;
+	m_mountainScale = scale;
+	m_mountainMultiplier = multiplier;
+}
+
+// Biomes
+void TerrainGenerator::SetBiomeFunctions(TerrainGetBiomeFunction getBiome, TerrainGetTownMultiplierFunction getTownMultiplier, TerrainGetBlockColourFunction getBlockColour, void* pData)
+{
+	m_getBiome = getBiome;
+	m_getTownMultiplier = getTownMultiplier;
+	m_getBlockColour = getBlockColour;
+	m_pBiomeData = pData;
+}
+
+// Column cache
+void TerrainGenerator::SetColumnCache(ChunkColumnCache* pColumnCache)
+{
+	m_pColumnCache = pColumnCache;
+}
+
+ChunkColumnCache* TerrainGenerator::GetColumnCache()
+{
+	return m_pColumnCache;
+}
+
+// Columns
+void TerrainGenerator::GetChunkColumn(int gridX, int gridZ, int terrainVersion, ChunkColumn* pColumn)
+{
+	if (m_pColumnCache != NULL && m_pColumnCache->GetColumn(gridX, gridZ, terrainVersion, pColumn))
+	{
+		return;
+	}
+
+	// Made outside of the cache lock, two workers can both miss on the same column but they will make the same data
+	CreateChunkColumn(gridX, gridZ, pColumn);
+	pColumn->m_terrainVersion = terrainVersion;
+
+	if (m_pColumnCache != NULL)
+	{
+		m_pColumnCache->AddColumn(*pColumn);
+	}
+}
+
+void TerrainGenerator::CreateChunkColumn(int gridX, int gridZ, ChunkColumn* pColumn)
+{
+	PROFILE_ZONE("TerrainGenerator::CreateChunkColumn");
+
+	pColumn->m_gridX = gridX;
+	pColumn->m_gridZ = gridZ;
+
+	float xPos = gridX * (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f);
+	float zPos = gridZ * (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f);
+
+	// The batched noise over the whole column. The column position and the noise offset are whole numbers, so the
+	// grids sample exactly the same points as the per block noise did.
+	float mountainNoise[Chunk::CHUNK_SIZE_SQUARED];
+	octave_noise_2d_grid(m_landscapeOctaves, m_landscapePersistence, m_landscapeScale, xPos + m_worldNoiseOffset.x, zPos + m_worldNoiseOffset.z, Chunk::CHUNK_SIZE, Chunk::CHUNK_SIZE, pColumn->m_landscapeNoise);
+	octave_noise_2d_grid(m_mountainOctaves, m_mountainPersistence, m_mountainScale, xPos + m_worldNoiseOffset.x, zPos + m_worldNoiseOffset.z, Chunk::CHUNK_SIZE, Chunk::CHUNK_SIZE, mountainNoise);
+
+	pColumn->m_maxNoiseHeight = 0.0f;
+	for (int x = 0; x < Chunk::CHUNK_SIZE; x++)
+	{
+		for (int z = 0; z < Chunk::CHUNK_SIZE; z++)
+		{
+			int index = x + z*Chunk::CHUNK_SIZE;
+			float xPosition = xPos + x;
+			float zPosition = zPos + z;
+
+			pColumn->m_biome[index] = m_getBiome(m_pBiomeData, xPosition, zPosition);
+
+			float noiseNormalized = ((pColumn->m_landscapeNoise[index] + 1.0f) * 0.5f);
+			float noiseHeight = noiseNormalized * Chunk::CHUNK_SIZE;
+
+			// Multiple by mountain ratio
+			float mountainNoiseNormalise = (mountainNoise[index] + 1.0f) * 0.5f;
+			pColumn->m_mountainMultiplier[index] = m_mountainMultiplier * mountainNoiseNormalise;
+			noiseHeight *= pColumn->m_mountainMultiplier[index];
+
+			// Smooth out for towns
+			pColumn->m_townMultiplier[index] = m_getTownMultiplier(m_pBiomeData, xPosition, zPosition);
+			noiseHeight *= pColumn->m_townMultiplier[index];
+
+			pColumn->m_noiseHeight[index] = noiseHeight;
+			if (noiseHeight > pColumn->m_maxNoiseHeight)
+			{
+				pColumn->m_maxNoiseHeight = noiseHeight;
+			}
+		}
+	}
+}
+
+// Chunks
+void TerrainGenerator::GenerateChunk(int gridX, int gridY, int gridZ, int terrainVersion, unsigned int* pColours, BlockType* pBlockTypes, TerrainTreeList* pvTrees)
+{
+	memset(pColours, 0, Chunk::CHUNK_SIZE_CUBED * sizeof(unsigned int));
+	for (int i = 0; i < Chunk::CHUNK_SIZE_CUBED; i++)
+	{
+		pBlockTypes[i] = BlockType_Default;
+	}
+
+	RandomGenerator chunkRandom(RandomGenerator::HashSeed(m_worldSeed, gridX, gridY, gridZ));
+
+	// The heightmap, biomes and multipliers only depend on x and z, so they are shared by every chunk in our column
+	ChunkColumn column;
+	GetChunkColumn(gridX, gridZ, terrainVersion, &column);
+
+	float chunkWidth = Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE*2.0f;
+	vec3 chunkPosition = vec3(gridX*chunkWidth, gridY*chunkWidth, gridZ*chunkWidth);
+	int chunkY = gridY*Chunk::CHUNK_SIZE;
+
+	float maxNoiseHeight = column.m_maxNoiseHeight;
+	if (gridY < 0)
+	{
+		maxNoiseHeight = Chunk::CHUNK_SIZE;
+	}
+
+	// The colour noise is only needed up to the highest column, chunks up in the air don't need any
+	int numColourLayers = 0;
+	while (numColourLayers < Chunk::CHUNK_SIZE && numColourLayers + chunkY < maxNoiseHeight)
+	{
+		numColourLayers++;
+	}
+	float colourNoise[Chunk::CHUNK_SIZE_CUBED];
+	octave_noise_3d_grid(4.0f, 0.3f, 0.005f, chunkPosition.x + m_worldNoiseOffset.x, chunkPosition.y + m_worldNoiseOffset.y, chunkPosition.z + m_worldNoiseOffset.z, Chunk::CHUNK_SIZE, numColourLayers, Chunk::CHUNK_SIZE, colourNoise);
+
+	for (int x = 0; x < Chunk::CHUNK_SIZE; x++)
+	{
+		for (int z = 0; z < Chunk::CHUNK_SIZE; z++)
+		{
+			Biome biome = column.m_biome[x + z*Chunk::CHUNK_SIZE];
+
+			float noise = column.m_landscapeNoise[x + z*Chunk::CHUNK_SIZE];
+			float noiseNormalized = ((noise + 1.0f) * 0.5f);
+			float noiseHeight = column.m_noiseHeight[x + z*Chunk::CHUNK_SIZE];
+			if (gridY < 0)
+			{
+				noiseHeight = Chunk::CHUNK_SIZE;
+			}
+
+			// Above the colour layers is always above the column height
+			for (int y = 0; y < numColourLayers; y++)
+			{
+				if (y + chunkY < noiseHeight)
+				{
+					float colourNoiseNormalized = ((colourNoise[x + Chunk::CHUNK_SIZE*(y + numColourLayers*z)] + 1.0f) * 0.5f);
+
+					float red = 0.65f;
+					float green = 0.80f;
+					float blue = 0.00f;
+					BlockType blockType = BlockType_Default;
+					m_getBlockColour(m_pBiomeData, biome, noise, colourNoiseNormalized, &red, &green, &blue, &blockType);
+
+					int index = x + y*Chunk::CHUNK_SIZE + z*Chunk::CHUNK_SIZE_SQUARED;
+					pColours[index] = PackColour(red, green, blue);
+					pBlockTypes[index] = blockType;
+				}
+			}
+
+			// Trees, only above ground
+			if (gridY >= 0)
+			{
+				if (chunkRandom.GetRandomNumber(0, 2000) >= 2000)
+				{
+					float minTreeHeight = 0.0f;
+					if (biome == Biome_GrassLand)
+					{
+						minTreeHeight = 0.5f;
+					}
+					else if (biome == Biome_AshLand)
+					{
+						minTreeHeight = 0.25f;
+					}
+
+					if (noiseNormalized >= minTreeHeight)
+					{
+						TerrainTree tree;
+						tree.m_biome = biome;
+						tree.m_position = vec3(chunkPosition.x + x, noiseHeight, chunkPosition.z + z);
+						pvTrees->push_back(tree);
+					}
+				}
+			}
+		}
+	}
+}
+
+unsigned int TerrainGenerator::PackColour(float r, float g, float b)
+{
+	if (r > 1.0f) r = 1.0f;
+	if (g > 1.0f) g = 1.0f;
+	if (b > 1.0f) b = 1.0f;
+	if (r < 0.0f) r = 0.0f;
+	if (g < 0.0f) g = 0.0f;
+	if (b < 0.0f) b = 0.0f;
+
+	// Opaque, the same packing as Chunk::SetColour()
+	unsigned int alpha = 255 << 24;
+	unsigned int blue = (int)(b * 255) << 16;
+	unsigned int green = (int)(g * 255) << 8;
+	unsigned int red = (int)(r * 255);
+
+	return red + green + blue + alpha;
+}
@@ -0,0 +1,112 @@
+// ******************************************************************************
+// Filename:    TerrainGenerator.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The world generation for a chunk, without the chunk. The column noise,
+//   the colour noise and the trees are worked out from the world seed and the
+//   chunk grid into plain block arrays, so the chunk workers and vox_bench
+//   both generate the terrain with this same code. The biomes and towns come
+//   through callbacks, the chunk manager forwards them to the biome manager.
+//   No GL is used.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "ChunkColumnCache.h"
+
+#include <vector>
+using namespace std;
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+// The biome at a world position
+typedef Biome(*TerrainGetBiomeFunction)(void *pData, float xPosition, float zPosition);
+// How much the height is flattened for towns at a world position, 1 outside of towns
+typedef float(*TerrainGetTownMultiplierFunction)(void *pData, float xPosition, float zPosition);
+// The block colour and type for the biome, at the landscape noise value and the 0 to 1 colour noise
+typedef void(*TerrainGetBlockColourFunction)(void *pData, Biome biome, float noise, float colourNoise, float *r, float *g, float *b, BlockType *blockType);
+
+// A tree the terrain wants at the bottom of its trunk, the caller imports the model for the biome
+class TerrainTree
+{
+public:
+	Biome m_biome;
+	vec3 m_position;
+};
+
+typedef vector<TerrainTree> TerrainTreeList;
+
+
+class TerrainGenerator
+{
+public:
+	/* Public methods */
+	TerrainGenerator();
+	~TerrainGenerator();
+
+	// World seed, 0 keeps the noise unshifted like before there were seeds
+	void SetWorldSeed(unsigned int worldSeed);
+	unsigned int GetWorldSeed();
+	vec3 GetWorldNoiseOffset();
+
+	// Landscape settings
+	void SetLandscape(float octaves, float persistence, float scale);
+	void SetMountains(float octaves, float persistence, float scale, float multiplier);
+
+	// Biomes
+	void SetBiomeFunctions(TerrainGetBiomeFunction getBiome, TerrainGetTownMultiplierFunction getTownMultiplier, TerrainGetBlockColourFunction getBlockColour, void* pData);
+
+	// Column cache, NULL to make every column from scratch
+	void SetColumnCache(ChunkColumnCache* pColumnCache);
+	ChunkColumnCache* GetColumnCache();
+
+	// Columns, the cached column is only used if it was made with the same terrain version
+	void GetChunkColumn(int gridX, int gridZ, int terrainVersion, ChunkColumn* pColumn);
+	void CreateChunkColumn(int gridX, int gridZ, ChunkColumn* pColumn);
+
+	// Fills the blocks, indexed [x + y*CHUNK_SIZE + z*CHUNK_SIZE_SQUARED], a colour of 0 is an empty block. The trees are added to the list.
+	// All the randomness comes from the seed and the grid, so a chunk comes out the same on any thread, in any order.
+	void GenerateChunk(int gridX, int gridY, int gridZ, int terrainVersion, unsigned int* pColours, BlockType* pBlockTypes, TerrainTreeList* pvTrees);
+
+	static unsigned int PackColour(float r, float g, float b);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	unsigned int m_worldSeed;
+	vec3 m_worldNoiseOffset;
+
+	float m_landscapeOctaves;
+	float m_landscapePersistence;
+	float m_landscapeScale;
+	float m_mountainOctaves;
+	float m_mountainPersistence;
+	float m_mountainScale;
+	float m_mountainMultiplier;
+
+	TerrainGetBiomeFunction m_getBiome;
+	TerrainGetTownMultiplierFunction m_getTownMultiplier;
+	TerrainGetBlockColourFunction m_getBlockColour;
+	void* m_pBiomeData;
+
+	ChunkColumnCache* m_pColumnCache;
+};
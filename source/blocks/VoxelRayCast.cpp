@@ -0,0 +1,126 @@
+// ******************************************************************************
+// Filename:    VoxelRayCast.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "VoxelRayCast.h"
+#include "Chunk.h"
+
+#include <float.h>
+#include <math.h>
+
+
+// The chunk that a world block co-ordinate is in, rounding down for negative blocks
+static int GetChunkCoordinate(int block)
+{
+	return (block >= 0) ? (block / Chunk::CHUNK_SIZE) : ((block + 1) / Chunk::CHUNK_SIZE - 1);
+}
+
+bool VoxelRayCast::Cast(const vec3 &origin, const vec3 &direction, float maxDistance, VoxelRayGetChunkFunction getChunk, VoxelRayGetBlockFunction getBlock, void* pData, VoxelRayHit* pHit)
+{
+	// In block space each block is a unit cube starting at its co-ordinate, distances along the ray stay the same
+	float blockSize = Chunk::BLOCK_RENDER_SIZE*2.0f;
+	vec3 start = origin / blockSize + vec3(0.5f, 0.5f, 0.5f);
+	vec3 blockDirection = direction / blockSize;
+
+	int block[3];
+	int step[3];
+	float nextBoundary[3];
+	float boundaryStep[3];
+	for (int i = 0; i < 3; i++)
+	{
+		block[i] = (int)floor(start[i]);
+
+		if (blockDirection[i] > 0.0f)
+		{
+			step[i] = 1;
+			nextBoundary[i] = (block[i] + 1.0f - start[i]) / blockDirection[i];
+			boundaryStep[i] = 1.0f / blockDirection[i];
+		}
+		else if (blockDirection[i] < 0.0f)
+		{
+			step[i] = -1;
+			nextBoundary[i] = (block[i] - start[i]) / blockDirection[i];
+			boundaryStep[i] = -1.0f / blockDirection[i];
+		}
+		else
+		{
+			step[i] = 0;
+			nextBoundary[i] = FLT_MAX;
+			boundaryStep[i] = FLT_MAX;
+		}
+	}
+
+	pHit->m_numBlocksVisited = 0;
+	pHit->m_numChunkLookups = 0;
+
+	// The chunk of the last block, only looked up again when the ray leaves it
+	void* pChunk = NULL;
+	int chunkGrid[3] = { 0, 0, 0 };
+	bool chunkLookedUp = false;
+
+	float distance = 0.0f;
+	int enteredAxis = -1;
+	while (distance <= maxDistance)
+	{
+		int grid[3];
+		for (int i = 0; i < 3; i++)
+		{
+			grid[i] = GetChunkCoordinate(block[i]);
+		}
+
+		if (chunkLookedUp == false || grid[0] != chunkGrid[0] || grid[1] != chunkGrid[1] || grid[2] != chunkGrid[2])
+		{
+			pChunk = getChunk(pData, grid[0], grid[1], grid[2]);
+			chunkGrid[0] = grid[0];
+			chunkGrid[1] = grid[1];
+			chunkGrid[2] = grid[2];
+			chunkLookedUp = true;
+			pHit->m_numChunkLookups++;
+		}
+
+		pHit->m_numBlocksVisited++;
+
+		int blockX = block[0] - grid[0]*Chunk::CHUNK_SIZE;
+		int blockY = block[1] - grid[1]*Chunk::CHUNK_SIZE;
+		int blockZ = block[2] - grid[2]*Chunk::CHUNK_SIZE;
+		BlockType blockType = BlockType_Default;
+		if (pChunk != NULL && getBlock(pData, pChunk, blockX, blockY, blockZ, &blockType))
+		{
+			pHit->m_hitPosition = origin + direction * distance;
+			pHit->m_distance = distance;
+			pHit->m_normal = vec3(0.0f, 0.0f, 0.0f);
+			if (enteredAxis != -1)
+			{
+				pHit->m_normal[enteredAxis] = (float)-step[enteredAxis];
+			}
+			pHit->m_blockPosition = vec3(block[0] * blockSize, block[1] * blockSize, block[2] * blockSize);
+			pHit->m_pChunk = pChunk;
+			pHit->m_blockX = blockX;
+			pHit->m_blockY = blockY;
+			pHit->m_blockZ = blockZ;
+			pHit->m_blockType = blockType;
+
+			return true;
+		}
+
+		// Into the next block through the nearest boundary
+		enteredAxis = (nextBoundary[0] < nextBoundary[1]) ? ((nextBoundary[0] < nextBoundary[2]) ? 0 : 2) : ((nextBoundary[1] < nextBoundary[2]) ? 1 : 2);
+		distance = nextBoundary[enteredAxis];
+		nextBoundary[enteredAxis] += boundaryStep[enteredAxis];
+		block[enteredAxis] += step[enteredAxis];
+	}
+
+	return false;
+}
+
+int VoxelRayCast::GetBlockCoordinate(float position)
+{
+	return (int)floor(position / (Chunk::BLOCK_RENDER_SIZE*2.0f) + 0.5f);
+}
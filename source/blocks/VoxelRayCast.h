@@ -0,0 +1,65 @@
+// ******************************************************************************
+// Filename:    VoxelRayCast.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Ray casts through the block grid. The ray walks from block to block with
+//   a 3D DDA (Amanatides and Woo), so every block that the ray passes through
+//   is looked at exactly once, and none are skipped at the corners like with
+//   fixed size steps. The chunk is only looked up when the ray crosses into a
+//   new one. The chunks are reached through callbacks, so the same traversal
+//   runs on the chunk manager and on the headless bench world.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "BlocksEnum.h"
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+// The chunk at the grid co-ordinates, or NULL when there isn't one
+typedef void*(*VoxelRayGetChunkFunction)(void *pData, int gridX, int gridY, int gridZ);
+// Whether the block in the chunk is solid, and its type when it is
+typedef bool(*VoxelRayGetBlockFunction)(void *pData, void *pChunk, int blockX, int blockY, int blockZ, BlockType* pBlockType);
+
+class VoxelRayHit
+{
+public:
+	// Where the ray hits the block face, and how far along the ray that is
+	vec3 m_hitPosition;
+	float m_distance;
+
+	// The face that was hit, zero when the ray starts inside the block
+	vec3 m_normal;
+
+	// The center of the block, the same as GetBlockActiveFrom3DPosition() gives
+	vec3 m_blockPosition;
+	void* m_pChunk;
+	int m_blockX;
+	int m_blockY;
+	int m_blockZ;
+	BlockType m_blockType;
+
+	// Filled in for misses too
+	int m_numBlocksVisited;
+	int m_numChunkLookups;
+};
+
+
+class VoxelRayCast
+{
+public:
+	// The first solid block along the ray, up to maxDistance. Blocks in missing chunks are empty.
+	// Distances are in lengths of the direction, so a unit direction gives world distances.
+	static bool Cast(const vec3 &origin, const vec3 &direction, float maxDistance, VoxelRayGetChunkFunction getChunk, VoxelRayGetBlockFunction getBlock, void* pData, VoxelRayHit* pHit);
+
+	// The block that a world position is in, in world block co-ordinates
+	static int GetBlockCoordinate(float position);
+};
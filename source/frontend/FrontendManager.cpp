@@ -20,6 +20,7 @@
 #include "Pages/OptionsMenu.h"
 #include "Pages/Credits.h"
 #include "../VoxGame.h"
+#include "../utils/Profiler.h"
 
 #include <iostream>
 #include "ini/INIReader.h"
@@ -825,6 +826,8 @@ float FrontendManager::GetToolTipAppearDelay()
 // Updating
 void FrontendManager::Update(float dt)
 {
+	PROFILE_ZONE("FrontendManager::Update");
+
 	if (m_currentPage != NULL)
 	{
 		m_currentPage->Update(dt);
@@ -868,6 +871,8 @@ void FrontendManager::UpdateFrontEndCamera(float dt)
 // Rendering
 void FrontendManager::Render()
 {
+	PROFILE_ZONE("FrontendManager::Render");
+
 	if (m_currentPage != NULL)
 	{
 		m_currentPage->Render();
@@ -876,6 +881,8 @@ void FrontendManager::Render()
 
 void FrontendManager::Render2D()
 {
+	PROFILE_ZONE("FrontendManager::Render2D");
+
 	if (m_currentPage != NULL)
 	{
 		m_currentPage->Render2D();
@@ -15,6 +15,7 @@
 // ******************************************************************************
 
 #include "VoxGame.h"
+#include "utils/Profiler.h"
 
 int main(void)
 {
@@ -44,6 +45,9 @@ int main(void)
 
 		/* Render */
 		pVoxGame->Render();
+
+		/* Collect this frame's profile zones */
+		Profiler::GetInstance()->EndFrame();
 	}
 
 	/* Cleanup */
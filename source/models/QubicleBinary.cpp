@@ -163,9 +163,6 @@ bool QubicleBinary::Import(const char* fileName, bool faceMerging)
 	FILE* pQBfile = NULL;
 	fopen_s(&pQBfile, qbFilename, "rb");
 
-	const unsigned int CODEFLAG = 2;
-	const unsigned int NEXTSLICEFLAG = 6;
-
 	if (pQBfile != NULL)
 	{
 		int ok = 0;
@@ -205,81 +202,93 @@ bool QubicleBinary::Import(const char* fileName, bool faceMerging)
 
 			pNewMatrix->m_pColour = new unsigned int[pNewMatrix->m_matrixSizeX * pNewMatrix->m_matrixSizeY * pNewMatrix->m_matrixSizeZ];
 
-			if(m_compressed == 0)
+			ok = ReadMatrixColours(pQBfile, m_compressed, pNewMatrix->m_matrixSizeX, pNewMatrix->m_matrixSizeY, pNewMatrix->m_matrixSizeZ, pNewMatrix->m_pColour);
+
+			m_vpMatrices.push_back(pNewMatrix);
+		}
+
+		fclose(pQBfile);
+
+		CreateMesh(faceMerging);
+
+		m_loaded = true;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool QubicleBinary::ReadMatrixColours(FILE* pQBfile, unsigned int compressed, unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ, unsigned int* pColour)
+{
+	const unsigned int CODEFLAG = 2;
+	const unsigned int NEXTSLICEFLAG = 6;
+
+	bool ok = true;
+
+	if(compressed == 0)
+	{
+		for(unsigned int z = 0; z < sizeZ; z++)
+		{
+			for(unsigned int y = 0; y < sizeY; y++)
 			{
-				for(unsigned int z = 0; z < pNewMatrix->m_matrixSizeZ; z++)
+				for(unsigned int x = 0; x < sizeX; x++)
 				{
-					for(unsigned int y = 0; y < pNewMatrix->m_matrixSizeY; y++)
-					{
-						for(unsigned int x = 0; x < pNewMatrix->m_matrixSizeX; x++)
-						{
-							unsigned int colour = 0;
-							ok = fread(&colour, sizeof(unsigned int), 1, pQBfile) == 1;
+					unsigned int colour = 0;
+					ok = fread(&colour, sizeof(unsigned int), 1, pQBfile) == 1;
 
-							pNewMatrix->m_pColour[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = colour;
-						}
-					}
+					pColour[x + sizeX * (y + sizeY * z)] = colour;
 				}
 			}
-			else
+		}
+	}
+	else
+	{
+		unsigned int z = 0;
+
+		while (z < sizeZ)
+		{
+			unsigned int index = 0;
+
+			while(true)
 			{
-				unsigned int z = 0;
+				unsigned int data = 0;
+				ok = fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
 
-				while (z < pNewMatrix->m_matrixSizeZ) 
+				if (ok == false || data == NEXTSLICEFLAG)
+					break;
+				else if (data == CODEFLAG)
 				{
-					unsigned int index = 0;
+					unsigned int count = 0;
+					ok = fread(&count, sizeof(unsigned int), 1, pQBfile) == 1;
+					ok = fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
 
-					while(true)
+					for(unsigned int j = 0; j < count; j++)
 					{
-						unsigned int data = 0;
-						ok = fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
-
-						if (data == NEXTSLICEFLAG)
-							break;
-						else if (data == CODEFLAG) 
-						{
-							unsigned int count = 0;
-							ok = fread(&count, sizeof(unsigned int), 1, pQBfile) == 1;
-							ok = fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
-
-							for(unsigned int j = 0; j < count; j++) 
-							{
-								unsigned int x = index % pNewMatrix->m_matrixSizeX;
-								unsigned int y = index / pNewMatrix->m_matrixSizeX;
-
-								pNewMatrix->m_pColour[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = data;
+						unsigned int x = index % sizeX;
+						unsigned int y = index / sizeX;
 
-								index++;
-							}
-						}
-						else
-						{
-							unsigned int x = index % pNewMatrix->m_matrixSizeX;
-							unsigned int y = index / pNewMatrix->m_matrixSizeX;
+						pColour[x + sizeX * (y + sizeY * z)] = data;
 
-							pNewMatrix->m_pColour[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = data;
-
-							index++;
-						}
+						index++;
 					}
+				}
+				else
+				{
+					unsigned int x = index % sizeX;
+					unsigned int y = index / sizeX;
+
+					pColour[x + sizeX * (y + sizeY * z)] = data;
 
-					z++;
+					index++;
 				}
 			}
 
-			m_vpMatrices.push_back(pNewMatrix);
+			z++;
 		}
-
-		fclose(pQBfile);
-
-		CreateMesh(faceMerging);
-
-		m_loaded = true;
-
-		return true;
 	}
 
-	return false;
+	return ok;
 }
 
 bool QubicleBinary::Export(const char* fileName)
@@ -466,12 +475,6 @@ void QubicleBinary::SetMeshSingleColour(float r, float g, float b)
 }
 
 
-bool IsMergedXNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_X_Negative) == MergedSide_X_Negative; }
-bool IsMergedXPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_X_Positive) == MergedSide_X_Positive; }
-bool IsMergedYNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Y_Negative) == MergedSide_Y_Negative; }
-bool IsMergedYPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Y_Positive) == MergedSide_Y_Positive; }
-bool IsMergedZNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Z_Negative) == MergedSide_Z_Negative; }
-bool IsMergedZPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Z_Positive) == MergedSide_Z_Positive; }
 
 void QubicleBinary::CreateMesh(bool lDoFaceMerging)
 {
@@ -1390,7 +1393,7 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 	m_pRenderer->PopMatrix();
 }
 
-void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking)
+void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour)
 {
 	if(pVoxelCharacter == NULL)
 	{
@@ -1407,11 +1410,6 @@ void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter*
 				continue;
 			}
 
-			if(subSelectionNamePicking)
-			{
-				m_pRenderer->LoadNameOntoStack(SUBSELECTION_NAMEPICKING_OFFSET + i);
-			}
-
 			m_pRenderer->PushMatrix();
 				MS3DAnimator* pSkeletonToUse = pSkeleton[AnimationSections_FullBody];			
 				if(m_vpMatrices[i]->m_boneIndex == pVoxelCharacter->GetHeadBoneIndex() ||
@@ -1623,11 +1621,6 @@ void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter*
 						m_pRenderer->EnableDepthTest(DT_LESS);
 					}
 				m_pRenderer->PopMatrix();
-
-				if(subSelectionNamePicking)
-				{
-					m_pRenderer->EndNameStack();
-				}
 			m_pRenderer->PopMatrix();
 		}
 
@@ -1810,6 +1803,9 @@ void QubicleBinary::RenderSingleMatrix(MS3DAnimator** pSkeleton, VoxelCharacter*
 					m_pRenderer->SetRenderMode(RM_SOLID);
 				}
 
+				// Store the model matrix, the mouse picking uses it for the sub selection parts
+				m_pRenderer->GetModelMatrix(&m_vpMatrices[matrixIndex]->m_modelMatrix);
+
 				// Texture manipulation (for shadow rendering)
 				{
 					Matrix4x4 worldMatrix;
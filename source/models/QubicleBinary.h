@@ -30,12 +30,12 @@ enum MergedSide
 	MergedSide_Z_Negative = 32,
 };
 
-bool IsMergedXNegative(int *merged, int x, int y, int z, int width, int height);
-bool IsMergedXPositive(int *merged, int x, int y, int z, int width, int height);
-bool IsMergedYNegative(int *merged, int x, int y, int z, int width, int height);
-bool IsMergedYPositive(int *merged, int x, int y, int z, int width, int height);
-bool IsMergedZNegative(int *merged, int x, int y, int z, int width, int height);
-bool IsMergedZPositive(int *merged, int x, int y, int z, int width, int height);
+inline bool IsMergedXNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_X_Negative) == MergedSide_X_Negative; }
+inline bool IsMergedXPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_X_Positive) == MergedSide_X_Positive; }
+inline bool IsMergedYNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Y_Negative) == MergedSide_Y_Negative; }
+inline bool IsMergedYPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Y_Positive) == MergedSide_Y_Positive; }
+inline bool IsMergedZNegative(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Z_Negative) == MergedSide_Z_Negative; }
+inline bool IsMergedZPositive(int *merged, int x, int y, int z, int width, int height) { return (merged[x + y*width + z*width*height] & MergedSide_Z_Positive) == MergedSide_Z_Positive; }
 
 class QubicleMatrix
 {
@@ -132,6 +132,9 @@ public:
 	bool Import(const char* fileName, bool faceMerging);
 	bool Export(const char* fileName);
 
+	// Read a single matrix's colour data, shared with the world generation templates which don't need a mesh
+	static bool ReadMatrixColours(FILE* pQBfile, unsigned int compressed, unsigned int sizeX, unsigned int sizeY, unsigned int sizeZ, unsigned int* pColour);
+
 	void GetColour(int matrixIndex, int x, int y, int z, float* r, float* g, float* b, float* a);
 	unsigned int GetColourCompact(int matrixIndex, int x, int y, int z);
 	bool GetSingleMeshColour(float* r, float* g, float* b, float* a);
@@ -173,7 +176,7 @@ public:
 
 	// Rendering
 	void Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour);
-	void RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking);
+	void RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour);
 	void RenderSingleMatrix(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, string matrixName, bool renderOutline, bool silhouette, Colour OutlineColour);
 	void RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale = true, bool useTranslate = true);
 	void RenderPaperdoll(MS3DAnimator* pSkeleton_Left, MS3DAnimator* pSkeleton_Right, VoxelCharacter* pVoxelCharacter);
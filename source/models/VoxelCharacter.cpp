@@ -15,6 +15,8 @@
 
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/ParallelUpdate.h"
 
 #include <glm/detail/func_geometric.hpp>
 
@@ -30,6 +32,8 @@ VoxelCharacter::VoxelCharacter(Renderer* pRenderer, QubicleBinaryManager* pQubic
 	m_pRenderer = pRenderer;
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
 
+	m_pRandomGenerator = new RandomGenerator(rand());
+
 	Reset();
 }
 
@@ -37,6 +41,8 @@ VoxelCharacter::~VoxelCharacter()
 {
 	UnloadCharacter();
 	Reset();
+
+	delete m_pRandomGenerator;
 }
 
 void VoxelCharacter::Reset()
@@ -78,7 +84,7 @@ void VoxelCharacter::Reset()
 	m_breathingHandsYOffset = 0.0f;
 	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_breathingBodyYOffset);
 	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_breathingHandsYOffset);
-	m_breathingAnimationInitialWaitTime = GetRandomNumber(0, 100, 2) * 0.01f;
+	m_breathingAnimationInitialWaitTime = m_pRandomGenerator->GetRandomNumber(0, 100, 2) * 0.01f;
 
 	// Facial expressions
 	m_numFacialExpressions = 0;
@@ -120,7 +126,7 @@ void VoxelCharacter::Reset()
 	m_bWinkAnimationEnabled = false;
 	m_faceEyesWinkTexture = -1;
 	m_wink = false;
-	m_winkWaitTimer = 4.0f + GetRandomNumber(-2, 2, 2);
+	m_winkWaitTimer = 4.0f + m_pRandomGenerator->GetRandomNumber(-2, 2, 2);
 	m_winkStayTime = 0.15f;
 
 	// Talking animation
@@ -949,7 +955,7 @@ void VoxelCharacter::UpdateWinkAnimation(float dt)
 	m_winkWaitTimer -= dt;
 	if(m_winkWaitTimer <= 0.0f)
 	{
-		m_winkWaitTimer = 4.0f + GetRandomNumber(-2, 2, 2);
+		m_winkWaitTimer = 4.0f + m_pRandomGenerator->GetRandomNumber(-2, 2, 2);
 		m_wink = false;
 
 		// Return eyes back to whatever they were before the wink
@@ -1000,7 +1006,7 @@ void VoxelCharacter::UpdateTalkingAnimation(float dt)
 		if(m_randomMouthSelection)
 		{
 			// Random mouth selection
-			m_currentTalkingTexture = GetRandomNumber(0, m_numTalkingMouths-1);
+			m_currentTalkingTexture = m_pRandomGenerator->GetRandomNumber(0, m_numTalkingMouths-1);
 		}
 		else
 		{
@@ -1017,15 +1023,15 @@ void VoxelCharacter::UpdateTalkingAnimation(float dt)
 		if(m_talkingPauseMouthCounter == m_talkingPauseMouthAmount)
 		{
 			m_talkingPauseMouthCounter = 0;
-			m_talkingPauseMouthAmount = 6 + GetRandomNumber(-2, 5);
+			m_talkingPauseMouthAmount = 6 + m_pRandomGenerator->GetRandomNumber(-2, 5);
 
-			float randomTimeAddtion = GetRandomNumber(-25, 40, 2) * 0.01f;
+			float randomTimeAddtion = m_pRandomGenerator->GetRandomNumber(-25, 40, 2) * 0.01f;
 			m_talkingPauseTimer = m_talkingPauseTime + randomTimeAddtion;
 		}
 
 		if(m_talkingPauseTimer > 0.0f)
 		{
-			if(GetRandomNumber(0, 100, 1) > 50)
+			if(m_pRandomGenerator->GetRandomNumber(0, 100, 1) > 50)
 			{
 				// Revert back to the face pose mouth
 				m_faceMouthTexture = m_pFacialExpressions[m_currentFacialExpression].m_mouthTexture;
@@ -1039,7 +1045,7 @@ void VoxelCharacter::UpdateTalkingAnimation(float dt)
 		{
 			m_faceMouthTexture = m_pTalkingAnimations[m_currentTalkingTexture].m_talkingAnimationTexture;
 
-			float randomTimeAddtion = GetRandomNumber(-10, 50, 2) * 0.00225f;
+			float randomTimeAddtion = m_pRandomGenerator->GetRandomNumber(-10, 50, 2) * 0.00225f;
 			m_talkingWaitTimer = m_talkingWaitTime + randomTimeAddtion;
 		}
 	}
@@ -1582,6 +1588,11 @@ string VoxelCharacter::GetSubSelectionName(int pickingId)
 
 // Update
 void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS])
+{
+	Update(dt, animationSpeed, NULL);
+}
+
+void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS], DeferredCommandBuffer* pCommands)
 {
 	if(m_loaded == false)
 	{
@@ -1618,7 +1629,14 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 	{
 		if(m_breathingAnimationInitialWaitTime <= 0.0f) // So we have an initial delay, do all characters are not in sync
 		{
-			StartBreathAnimation();
+			if(pCommands != NULL)
+			{
+				pCommands->AddCommand(_StartBreathAnimationDeferred, this, NULL);
+			}
+			else
+			{
+				StartBreathAnimation();
+			}
 		}
 		else
 		{
@@ -1645,7 +1663,7 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 	{
 		if(m_bRandomLookDirectionEnabled)
 		{
-			m_faceTargetDirection = vec3(GetRandomNumber(-1, 1, 2)*0.65f, GetRandomNumber(-1, 1, 2)*0.175f, GetRandomNumber(0, 3, 2)+0.35f);
+			m_faceTargetDirection = vec3(m_pRandomGenerator->GetRandomNumber(-1, 1, 2)*0.65f, m_pRandomGenerator->GetRandomNumber(-1, 1, 2)*0.175f, m_pRandomGenerator->GetRandomNumber(0, 3, 2)+0.35f);
 			m_faceTargetDirection = normalize(m_faceTargetDirection);
 		}
 	}
@@ -1729,13 +1747,13 @@ void VoxelCharacter::SetWeaponTrailsOriginMatrix(float dt, Matrix4x4 originMatri
 }
 
 // Rendering
-void VoxelCharacter::Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking)
+void VoxelCharacter::Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour)
 {
 	if(m_pVoxelModel != NULL)
 	{
 		m_pRenderer->PushMatrix();
 			m_pRenderer->ScaleWorldMatrix(m_characterScale, m_characterScale, m_characterScale);
-			m_pVoxelModel->RenderWithAnimator(m_pCharacterAnimator, this, renderOutline, reflection, silhouette, OutlineColour, subSelectionNamePicking);
+			m_pVoxelModel->RenderWithAnimator(m_pCharacterAnimator, this, renderOutline, reflection, silhouette, OutlineColour);
 		m_pRenderer->PopMatrix();
 	}
 }
@@ -2061,6 +2079,12 @@ void VoxelCharacter::RenderWeaponsPaperdoll()
 	}
 }
 
+void VoxelCharacter::_StartBreathAnimationDeferred(void *pObject, void *pData)
+{
+	VoxelCharacter* lpVoxelCharacter = (VoxelCharacter*)pObject;
+	lpVoxelCharacter->StartBreathAnimation();
+}
+
 void VoxelCharacter::_BreathAnimationFinished(void *apData)
 {
 	VoxelCharacter* lpVoxelCharacter = (VoxelCharacter*)apData;
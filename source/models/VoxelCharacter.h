@@ -16,6 +16,8 @@
 #include "modelloader.h"
 #include "QubicleBinaryManager.h"
 
+class DeferredCommandBuffer;
+class RandomGenerator;
 
 // Facial expression
 typedef struct FacialExpression
@@ -215,10 +217,12 @@ public:
 
 	// Update
 	void Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS]);
+	// Used from the parallel entity update, anything that touches shared state is added to pCommands instead
+	void Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS], DeferredCommandBuffer* pCommands);
 	void SetWeaponTrailsOriginMatrix(float dt, Matrix4x4 originMatrix);
 
 	// Rendering
-	void Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking);
+	void Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour);
 	void RenderSubSelection(string subSelection, bool renderOutline, bool silhouette, Colour OutlineColour);
 	void RenderBones();
 	void RenderFace();
@@ -236,6 +240,7 @@ protected:
 	/* Protected methods */
 	static void _BreathAnimationFinished(void *apData);
 	void BreathAnimationFinished();
+	static void _StartBreathAnimationDeferred(void *pObject, void *pData);
 
 private:
 	/* Private methods */
@@ -251,6 +256,9 @@ private:
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 
+	// Each character has its own random numbers, so that the updates don't depend on the order characters are updated in
+	RandomGenerator* m_pRandomGenerator;
+
 	// Loaded flags
 	bool m_loaded;
 	bool m_loadedFaces;
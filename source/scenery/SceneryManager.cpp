@@ -12,6 +12,7 @@
 // ******************************************************************************
 
 #include "SceneryManager.h"
+#include "../utils/Profiler.h"
 
 #include <vector>
 #include <algorithm>
@@ -41,6 +42,11 @@ void SceneryManager::ClearSceneryObjects()
 		m_vpSceneryObjectList[i] = 0;
 	}
 	m_vpSceneryObjectList.clear();
+
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleSceneryObjects[i].clear();
+	}
 }
 
 int SceneryManager::GetNumSceneryObjects()
@@ -152,6 +158,12 @@ void SceneryManager::DeleteSceneryObject(string name)
 		m_vpSceneryObjectList.erase(iter);
 	}
 
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		SceneryObjectList& vpVisibleSceneryObjects = m_vpVisibleSceneryObjects[i];
+		vpVisibleSceneryObjects.erase(std::remove(vpVisibleSceneryObjects.begin(), vpVisibleSceneryObjects.end(), pDeleteObject), vpVisibleSceneryObjects.end());
+	}
+
 	// Delete
 	if(pDeleteObject != NULL)
 	{
@@ -218,15 +230,67 @@ void SceneryManager::SetRenderLabels(bool labels)
 // Updating
 void SceneryManager::Update(float dt)
 {
+	PROFILE_ZONE("SceneryManager::Update");
 }
 
 // Rendering
-void SceneryManager::Render(bool reflection, bool silhouette, bool shadow, bool renderOnlyOutline, bool renderOnlyNormal)
+// Culling
+void SceneryManager::GetSceneryObjectBounds(SceneryObject* pSceneryObject, vec3* pCenter, float* pRadius)
+{
+	// Matches the transforms in RenderSceneryObject()
+	float scaledHeight = pSceneryObject->m_height*0.5f*pSceneryObject->m_scale;
+	float objectRadius = length(vec3(pSceneryObject->m_length, pSceneryObject->m_height, pSceneryObject->m_width)*0.5f) * pSceneryObject->m_scale;
+
+	if(pSceneryObject->m_parentImportDirection == QubicleImportDirection_Normal)
+	{
+		*pCenter = pSceneryObject->m_worldFileOffset + pSceneryObject->m_positionOffset + vec3(0.0f, scaledHeight - Chunk::BLOCK_RENDER_SIZE, 0.0f);
+		*pRadius = objectRadius;
+	}
+	else
+	{
+		// The parent direction moves the object around the world file origin, so just bound every direction it could go
+		*pCenter = pSceneryObject->m_worldFileOffset;
+		*pRadius = length(pSceneryObject->m_positionOffset) + fabs(scaledHeight - Chunk::BLOCK_RENDER_SIZE) + objectRadius;
+	}
+}
+
+void SceneryManager::CullScenery(VisibilityCuller* pVisibilityCuller)
 {
+	for(int i = 0; i < RenderPass_NumPasses; i++)
+	{
+		m_vpVisibleSceneryObjects[i].clear();
+	}
+
 	for(unsigned int i = 0; i < m_vpSceneryObjectList.size(); i++)
 	{
 		SceneryObject* pSceneryObject = m_vpSceneryObjectList[i];
 
+		vec3 center;
+		float radius;
+		GetSceneryObjectBounds(pSceneryObject, &center, &radius);
+
+		unsigned int passMask = pVisibilityCuller->CullSphere(VisibilityType_Scenery, center, radius);
+		for(int j = 0; j < RenderPass_NumPasses; j++)
+		{
+			if(passMask & (1 << j))
+			{
+				m_vpVisibleSceneryObjects[j].push_back(pSceneryObject);
+			}
+		}
+	}
+}
+
+void SceneryManager::Render(bool reflection, bool silhouette, bool shadow, bool renderOnlyOutline, bool renderOnlyNormal)
+{
+	PROFILE_ZONE("SceneryManager::Render");
+
+	// Only the scenery that CullScenery() found in this pass's frustum
+	SceneryObjectList& vpVisibleSceneryObjects = m_vpVisibleSceneryObjects[shadow ? RenderPass_Shadow : RenderPass_Main];
+
+	for(unsigned int i = 0; i < vpVisibleSceneryObjects.size(); i++)
+	{
+		SceneryObject* pSceneryObject = vpVisibleSceneryObjects[i];
+
 		if(silhouette && (pSceneryObject->m_outlineRender == false && pSceneryObject->m_hoverRender == false))
 		{
 			continue; // Don't render silhouette unless we are rendering outline
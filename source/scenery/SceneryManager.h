@@ -77,6 +77,10 @@ public:
 	// Updating
 	void Update(float dt);
 
+	// Culling
+	void GetSceneryObjectBounds(SceneryObject* pSceneryObject, vec3* pCenter, float* pRadius);
+	void CullScenery(VisibilityCuller* pVisibilityCuller);
+
 	// Rendering
 	void Render(bool reflection, bool silhouette, bool shadow, bool renderOnlyOutline, bool renderOnlyNormal);
 	void RenderDebug();
@@ -102,6 +106,9 @@ private:
 
 	SceneryObjectList m_vpSceneryObjectList;
 
+	// The scenery that each render pass can see, rebuilt every frame
+	SceneryObjectList m_vpVisibleSceneryObjects[RenderPass_NumPasses];
+
 	int m_numRenderScenery;
 
 	bool m_renderOutlines;
@@ -120,6 +120,61 @@ float raw_noise_3d(const float x, const float y, const float z);
 float raw_noise_4d(const float x, const float y, const float, const float w);
 
 
+// Batched Simplex noise
+// Evaluates many points in one call, using SSE2 or AVX2 lanes when the CPU supports them. The results match the
+// single point functions above to within float rounding.
+enum NoiseBatchMode {
+    NoiseBatchMode_Scalar = 0,
+    NoiseBatchMode_SSE2,
+    NoiseBatchMode_AVX2,
+};
+
+// The best mode the CPU supports is selected on first use, it can be lowered for comparing against the scalar path.
+NoiseBatchMode get_noise_batch_mode();
+NoiseBatchMode get_best_noise_batch_mode();
+void set_noise_batch_mode(const NoiseBatchMode mode);
+
+void raw_noise_2d_batch(const float* x, const float* y, const int count, float* result);
+void raw_noise_3d_batch(const float* x, const float* y, const float* z, const int count, float* result);
+
+void octave_noise_2d_batch(const float octaves,
+                    const float persistence,
+                    const float scale,
+                    const float* x,
+                    const float* y,
+                    const int count,
+                    float* result);
+void octave_noise_3d_batch(const float octaves,
+                    const float persistence,
+                    const float scale,
+                    const float* x,
+                    const float* y,
+                    const float* z,
+                    const int count,
+                    float* result);
+
+// Grids of unit spaced points starting at (x, y) and (x, y, z).
+// The 2D result is indexed [i + sizeX*j] and the 3D result [i + sizeX*(j + sizeY*k)].
+void octave_noise_2d_grid(const float octaves,
+                    const float persistence,
+                    const float scale,
+                    const float x,
+                    const float y,
+                    const int sizeX,
+                    const int sizeY,
+                    float* result);
+void octave_noise_3d_grid(const float octaves,
+                    const float persistence,
+                    const float scale,
+                    const float x,
+                    const float y,
+                    const float z,
+                    const int sizeX,
+                    const int sizeY,
+                    const int sizeZ,
+                    float* result);
+
+
 int fastfloor(const float x);
 
 float dot(const int* g, const float x, const float y);
@@ -0,0 +1,277 @@
+// ******************************************************************************
+// Filename:    simplexnoisebatch.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Batched simplex noise. Picks the widest set of lanes the CPU supports,
+//   AVX2 (in simplexnoisebatch_avx2.cpp), SSE2 or the scalar functions from
+//   simplexnoise.cpp, and runs whole arrays and grids of points through it.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include <atomic>
+#include <math.h>
+#include <vector>
+using namespace std;
+
+#include "simplexnoise.h"
+#include "simplexnoiselanes.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMPLEX_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// From simplexnoisebatch_avx2.cpp
+bool noise_batch_avx2_built();
+bool octave_noise_2d_batch_avx2(const float octaves, const float persistence, const float scale, const float* x, const float* y, const int count, float* result);
+bool octave_noise_3d_batch_avx2(const float octaves, const float persistence, const float scale, const float* x, const float* y, const float* z, const int count, float* result);
+
+
+#if defined(SIMPLEX_BATCH_SSE2)
+namespace {
+
+struct NoiseLanesSSE2 {
+    typedef __m128 Float;
+    typedef __m128i Int;
+
+    static const int Width = 4;
+
+    static inline Float Load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void Store(float* p, const Float a) { _mm_storeu_ps(p, a); }
+    static inline Float Set(const float a) { return _mm_set1_ps(a); }
+    static inline Int SetInt(const int a) { return _mm_set1_epi32(a); }
+
+    static inline Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+    static inline Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+    static inline Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+    static inline Float Div(const Float a, const Float b) { return _mm_div_ps(a, b); }
+
+    static inline Int AddInt(const Int a, const Int b) { return _mm_add_epi32(a, b); }
+    static inline Int SubInt(const Int a, const Int b) { return _mm_sub_epi32(a, b); }
+    static inline Int AndInt(const Int a, const Int b) { return _mm_and_si128(a, b); }
+    static inline Int OrInt(const Int a, const Int b) { return _mm_or_si128(a, b); }
+    static inline Int AndNotInt(const Int a, const Int b) { return _mm_andnot_si128(a, b); }
+
+    static inline Int Greater(const Float a, const Float b) { return _mm_castps_si128(_mm_cmpgt_ps(a, b)); }
+    static inline Int GreaterEqual(const Float a, const Float b) { return _mm_castps_si128(_mm_cmpge_ps(a, b)); }
+    static inline Float Mask(const Float a, const Int mask) { return _mm_and_ps(a, _mm_castsi128_ps(mask)); }
+
+    static inline Float ToFloat(const Int a) { return _mm_cvtepi32_ps(a); }
+
+    // Same as fastfloor(), truncate and take one off anything that isn't positive
+    static inline Int FastFloor(const Float a) {
+        Int notPositive = _mm_castps_si128(_mm_cmple_ps(a, _mm_setzero_ps()));
+        return _mm_add_epi32(_mm_cvttps_epi32(a), notPositive);
+    }
+
+    // SSE2 has no gathers, so look the lanes up one at a time
+    static inline Int Gather(const int* table, const Int index) {
+        int lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, index);
+        return _mm_set_epi32(table[lanes[3]], table[lanes[2]], table[lanes[1]], table[lanes[0]]);
+    }
+    static inline Float GatherFloat(const float* table, const Int index) {
+        int lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, index);
+        return _mm_set_ps(table[lanes[3]], table[lanes[2]], table[lanes[1]], table[lanes[0]]);
+    }
+};
+
+}
+#endif
+
+
+// Lookup tables shared by all of the lanes
+const NoiseBatchTables* get_noise_batch_tables() {
+    struct TablesBuilder {
+        NoiseBatchTables m_tables;
+
+        TablesBuilder() {
+            m_tables.F2 = 0.5 * (sqrtf(3.0) - 1.0);
+            m_tables.G2 = (3.0 - sqrtf(3.0)) / 6.0;
+
+            for( int i = 0; i < 512; i++ ) {
+                int gi = perm[i] % 12;
+                m_tables.perm[i] = perm[i];
+                m_tables.gradX[i] = (float)grad3[gi][0];
+                m_tables.gradY[i] = (float)grad3[gi][1];
+                m_tables.gradZ[i] = (float)grad3[gi][2];
+            }
+        }
+    };
+
+    static const TablesBuilder builder;
+
+    return &builder.m_tables;
+}
+
+
+// Batch mode selection
+static bool cpu_supports_avx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if( info[0] < 7 ) return false;
+
+    // The OS has to save the AVX registers as well
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if( osxsave == false || avx == false ) return false;
+    if( (_xgetbv(0) & 6) != 6 ) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+NoiseBatchMode get_best_noise_batch_mode() {
+    static const NoiseBatchMode bestMode =
+        (noise_batch_avx2_built() && cpu_supports_avx2()) ? NoiseBatchMode_AVX2 :
+#if defined(SIMPLEX_BATCH_SSE2)
+        NoiseBatchMode_SSE2;
+#else
+        NoiseBatchMode_Scalar;
+#endif
+
+    return bestMode;
+}
+
+// -1 uses the best mode. The chunk generation workers all read this, so it is atomic and only set_noise_batch_mode() writes it.
+static std::atomic<int> noiseBatchMode(-1);
+
+NoiseBatchMode get_noise_batch_mode() {
+    int mode = noiseBatchMode.load(std::memory_order_relaxed);
+    if( mode == -1 ) {
+        return get_best_noise_batch_mode();
+    }
+
+    return (NoiseBatchMode)mode;
+}
+
+void set_noise_batch_mode(const NoiseBatchMode mode) {
+    // Never go above what the CPU can run
+    NoiseBatchMode bestMode = get_best_noise_batch_mode();
+    noiseBatchMode.store((mode > bestMode) ? bestMode : mode, std::memory_order_relaxed);
+}
+
+
+// Batched raw Simplex noise, a single octave at a scale of 1 is exactly the raw noise
+void raw_noise_2d_batch( const float* x, const float* y, const int count, float* result ) {
+    if( get_noise_batch_mode() == NoiseBatchMode_Scalar ) {
+        for( int i = 0; i < count; i++ ) {
+            result[i] = raw_noise_2d(x[i], y[i]);
+        }
+        return;
+    }
+
+    octave_noise_2d_batch(1, 1, 1, x, y, count, result);
+}
+
+void raw_noise_3d_batch( const float* x, const float* y, const float* z, const int count, float* result ) {
+    if( get_noise_batch_mode() == NoiseBatchMode_Scalar ) {
+        for( int i = 0; i < count; i++ ) {
+            result[i] = raw_noise_3d(x[i], y[i], z[i]);
+        }
+        return;
+    }
+
+    octave_noise_3d_batch(1, 1, 1, x, y, z, count, result);
+}
+
+
+// Batched Multi-octave Simplex noise
+void octave_noise_2d_batch( const float octaves, const float persistence, const float scale, const float* x, const float* y, const int count, float* result ) {
+    switch( get_noise_batch_mode() ) {
+    case NoiseBatchMode_AVX2:
+        if( octave_noise_2d_batch_avx2(octaves, persistence, scale, x, y, count, result) ) {
+            return;
+        }
+        // Fall through
+    case NoiseBatchMode_SSE2:
+#if defined(SIMPLEX_BATCH_SSE2)
+        octave_noise_2d_lanes<NoiseLanesSSE2>(octaves, persistence, scale, x, y, count, result);
+        return;
+#endif
+        // Fall through
+    default:
+        for( int i = 0; i < count; i++ ) {
+            result[i] = octave_noise_2d(octaves, persistence, scale, x[i], y[i]);
+        }
+    }
+}
+
+void octave_noise_3d_batch( const float octaves, const float persistence, const float scale, const float* x, const float* y, const float* z, const int count, float* result ) {
+    switch( get_noise_batch_mode() ) {
+    case NoiseBatchMode_AVX2:
+        if( octave_noise_3d_batch_avx2(octaves, persistence, scale, x, y, z, count, result) ) {
+            return;
+        }
+        // Fall through
+    case NoiseBatchMode_SSE2:
+#if defined(SIMPLEX_BATCH_SSE2)
+        octave_noise_3d_lanes<NoiseLanesSSE2>(octaves, persistence, scale, x, y, z, count, result);
+        return;
+#endif
+        // Fall through
+    default:
+        for( int i = 0; i < count; i++ ) {
+            result[i] = octave_noise_3d(octaves, persistence, scale, x[i], y[i], z[i]);
+        }
+    }
+}
+
+
+// Grids of Multi-octave Simplex noise
+void octave_noise_2d_grid( const float octaves, const float persistence, const float scale, const float x, const float y, const int sizeX, const int sizeY, float* result ) {
+    int count = sizeX * sizeY;
+    vector<float> xPoints(count);
+    vector<float> yPoints(count);
+
+    for( int j = 0; j < sizeY; j++ ) {
+        for( int i = 0; i < sizeX; i++ ) {
+            xPoints[i + sizeX*j] = x + i;
+            yPoints[i + sizeX*j] = y + j;
+        }
+    }
+
+    if( count > 0 ) {
+        octave_noise_2d_batch(octaves, persistence, scale, &xPoints[0], &yPoints[0], count, result);
+    }
+}
+
+void octave_noise_3d_grid( const float octaves, const float persistence, const float scale, const float x, const float y, const float z, const int sizeX, const int sizeY, const int sizeZ, float* result ) {
+    int count = sizeX * sizeY * sizeZ;
+    vector<float> xPoints(count);
+    vector<float> yPoints(count);
+    vector<float> zPoints(count);
+
+    for( int k = 0; k < sizeZ; k++ ) {
+        for( int j = 0; j < sizeY; j++ ) {
+            for( int i = 0; i < sizeX; i++ ) {
+                xPoints[i + sizeX*(j + sizeY*k)] = x + i;
+                yPoints[i + sizeX*(j + sizeY*k)] = y + j;
+                zPoints[i + sizeX*(j + sizeY*k)] = z + k;
+            }
+        }
+    }
+
+    if( count > 0 ) {
+        octave_noise_3d_batch(octaves, persistence, scale, &xPoints[0], &yPoints[0], &zPoints[0], count, result);
+    }
+}
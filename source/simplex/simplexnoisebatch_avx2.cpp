@@ -0,0 +1,95 @@
+// ******************************************************************************
+// Filename:    simplexnoisebatch_avx2.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The AVX2 lanes for the batched simplex noise, 8 points at a time. This is
+//   the only source built with AVX2 enabled, and it is only called once the
+//   CPU has been checked for AVX2 support. Keep the includes in here to the
+//   intrinsics only, any inline function from a shared header that gets
+//   built with AVX2 could be picked by the linker for the rest of the game.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "simplexnoiselanes.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+
+struct NoiseLanesAVX2 {
+    typedef __m256 Float;
+    typedef __m256i Int;
+
+    static const int Width = 8;
+
+    static inline Float Load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void Store(float* p, const Float a) { _mm256_storeu_ps(p, a); }
+    static inline Float Set(const float a) { return _mm256_set1_ps(a); }
+    static inline Int SetInt(const int a) { return _mm256_set1_epi32(a); }
+
+    static inline Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+    static inline Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+    static inline Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+    static inline Float Div(const Float a, const Float b) { return _mm256_div_ps(a, b); }
+
+    static inline Int AddInt(const Int a, const Int b) { return _mm256_add_epi32(a, b); }
+    static inline Int SubInt(const Int a, const Int b) { return _mm256_sub_epi32(a, b); }
+    static inline Int AndInt(const Int a, const Int b) { return _mm256_and_si256(a, b); }
+    static inline Int OrInt(const Int a, const Int b) { return _mm256_or_si256(a, b); }
+    static inline Int AndNotInt(const Int a, const Int b) { return _mm256_andnot_si256(a, b); }
+
+    static inline Int Greater(const Float a, const Float b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+    static inline Int GreaterEqual(const Float a, const Float b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+    static inline Float Mask(const Float a, const Int mask) { return _mm256_and_ps(a, _mm256_castsi256_ps(mask)); }
+
+    static inline Float ToFloat(const Int a) { return _mm256_cvtepi32_ps(a); }
+
+    // Same as fastfloor(), truncate and take one off anything that isn't positive
+    static inline Int FastFloor(const Float a) {
+        Int notPositive = _mm256_castps_si256(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_LE_OQ));
+        return _mm256_add_epi32(_mm256_cvttps_epi32(a), notPositive);
+    }
+
+    static inline Int Gather(const int* table, const Int index) { return _mm256_i32gather_epi32(table, index, 4); }
+    static inline Float GatherFloat(const float* table, const Int index) { return _mm256_i32gather_ps(table, index, 4); }
+};
+
+}
+
+bool noise_batch_avx2_built() {
+    return true;
+}
+
+bool octave_noise_2d_batch_avx2(const float octaves, const float persistence, const float scale, const float* x, const float* y, const int count, float* result) {
+    octave_noise_2d_lanes<NoiseLanesAVX2>(octaves, persistence, scale, x, y, count, result);
+    return true;
+}
+
+bool octave_noise_3d_batch_avx2(const float octaves, const float persistence, const float scale, const float* x, const float* y, const float* z, const int count, float* result) {
+    octave_noise_3d_lanes<NoiseLanesAVX2>(octaves, persistence, scale, x, y, z, count, result);
+    return true;
+}
+
+#else
+
+// Not built with AVX2, the caller falls back to the SSE2 lanes
+bool noise_batch_avx2_built() {
+    return false;
+}
+
+bool octave_noise_2d_batch_avx2(const float, const float, const float, const float*, const float*, const int, float*) {
+    return false;
+}
+
+bool octave_noise_3d_batch_avx2(const float, const float, const float, const float*, const float*, const float*, const int, float*) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,263 @@
+// ******************************************************************************
+// Filename:    simplexnoiselanes.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The 2D and 3D simplex noise, written once against a set of SIMD lanes and
+//   included by each of the batched noise sources. The lanes class L provides
+//   the float and int vector types and the handful of operations the noise
+//   needs (arithmetic, compares, floor and table gathers). The steps follow
+//   raw_noise_2d() and raw_noise_3d() in simplexnoise.cpp one for one, only
+//   the branches are replaced with masks.
+//
+//   L must be a type local to the including source file, so that the kernels
+//   built with different instruction sets never get merged by the linker.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#ifndef SIMPLEX_LANES_H_
+#define SIMPLEX_LANES_H_
+
+// The permutation table, and the gradients of grad3[perm[i] % 12] so that a corner's gradient is a single gather.
+// The 2D skew factors are worked out with sqrtf() in simplexnoisebatch.cpp, this header has no includes on purpose.
+struct NoiseBatchTables {
+    float F2;
+    float G2;
+    int perm[512];
+    float gradX[512];
+    float gradY[512];
+    float gradZ[512];
+};
+
+const NoiseBatchTables* get_noise_batch_tables();
+
+
+// 2D corner contribution
+template <class L>
+static inline typename L::Float noise_corner_2d_lanes(const NoiseBatchTables* tables, const typename L::Int g, const typename L::Float x, const typename L::Float y) {
+    typedef typename L::Float Float;
+
+    Float t = L::Sub(L::Sub(L::Set(0.5f), L::Mul(x, x)), L::Mul(y, y));
+    Float dot = L::Add(L::Mul(L::GatherFloat(tables->gradX, g), x), L::Mul(L::GatherFloat(tables->gradY, g), y));
+
+    Float t2 = L::Mul(t, t);
+    Float n = L::Mul(L::Mul(t2, t2), dot);
+
+    return L::Mask(n, L::GreaterEqual(t, L::Set(0.0f)));
+}
+
+// 3D corner contribution
+template <class L>
+static inline typename L::Float noise_corner_3d_lanes(const NoiseBatchTables* tables, const typename L::Int g, const typename L::Float x, const typename L::Float y, const typename L::Float z) {
+    typedef typename L::Float Float;
+
+    Float t = L::Sub(L::Sub(L::Sub(L::Set(0.6f), L::Mul(x, x)), L::Mul(y, y)), L::Mul(z, z));
+    Float dot = L::Add(L::Add(L::Mul(L::GatherFloat(tables->gradX, g), x), L::Mul(L::GatherFloat(tables->gradY, g), y)), L::Mul(L::GatherFloat(tables->gradZ, g), z));
+
+    Float t2 = L::Mul(t, t);
+    Float n = L::Mul(L::Mul(t2, t2), dot);
+
+    return L::Mask(n, L::GreaterEqual(t, L::Set(0.0f)));
+}
+
+
+// 2D raw Simplex noise
+template <class L>
+static inline typename L::Float raw_noise_2d_lanes(const NoiseBatchTables* tables, const typename L::Float x, const typename L::Float y) {
+    typedef typename L::Float Float;
+    typedef typename L::Int Int;
+
+    const float F2 = tables->F2;
+    const float G2 = tables->G2;
+    const Int one = L::SetInt(1);
+
+    // Skew the input space to determine which simplex cell we're in
+    Float s = L::Mul(L::Add(x, y), L::Set(F2));
+    Int i = L::FastFloor(L::Add(x, s));
+    Int j = L::FastFloor(L::Add(y, s));
+
+    // Unskew the cell origin back to (x,y) space
+    Float t = L::Mul(L::ToFloat(L::AddInt(i, j)), L::Set(G2));
+    Float x0 = L::Sub(x, L::Sub(L::ToFloat(i), t));
+    Float y0 = L::Sub(y, L::Sub(L::ToFloat(j), t));
+
+    // Lower triangle (1,0), upper triangle (0,1)
+    Int lower = L::Greater(x0, y0);
+    Int i1 = L::AndInt(lower, one);
+    Int j1 = L::AndNotInt(lower, one);
+
+    Float x1 = L::Add(L::Sub(x0, L::ToFloat(i1)), L::Set(G2));
+    Float y1 = L::Add(L::Sub(y0, L::ToFloat(j1)), L::Set(G2));
+    Float x2 = L::Add(L::Sub(x0, L::Set(1.0f)), L::Set(2.0f * G2));
+    Float y2 = L::Add(L::Sub(y0, L::Set(1.0f)), L::Set(2.0f * G2));
+
+    // Hashed gradients of the three corners
+    Int ii = L::AndInt(i, L::SetInt(255));
+    Int jj = L::AndInt(j, L::SetInt(255));
+    Int g0 = L::AddInt(ii, L::Gather(tables->perm, jj));
+    Int g1 = L::AddInt(L::AddInt(ii, i1), L::Gather(tables->perm, L::AddInt(jj, j1)));
+    Int g2 = L::AddInt(L::AddInt(ii, one), L::Gather(tables->perm, L::AddInt(jj, one)));
+
+    Float n0 = noise_corner_2d_lanes<L>(tables, g0, x0, y0);
+    Float n1 = noise_corner_2d_lanes<L>(tables, g1, x1, y1);
+    Float n2 = noise_corner_2d_lanes<L>(tables, g2, x2, y2);
+
+    return L::Mul(L::Set(70.0f), L::Add(L::Add(n0, n1), n2));
+}
+
+// 3D raw Simplex noise
+template <class L>
+static inline typename L::Float raw_noise_3d_lanes(const NoiseBatchTables* tables, const typename L::Float x, const typename L::Float y, const typename L::Float z) {
+    typedef typename L::Float Float;
+    typedef typename L::Int Int;
+
+    const float F3 = 1.0/3.0;
+    const float G3 = 1.0/6.0;
+    const Int one = L::SetInt(1);
+    const Int two = L::SetInt(2);
+
+    // Skew the input space to determine which simplex cell we're in
+    Float s = L::Mul(L::Add(L::Add(x, y), z), L::Set(F3));
+    Int i = L::FastFloor(L::Add(x, s));
+    Int j = L::FastFloor(L::Add(y, s));
+    Int k = L::FastFloor(L::Add(z, s));
+
+    // Unskew the cell origin back to (x,y,z) space
+    Float t = L::Mul(L::ToFloat(L::AddInt(L::AddInt(i, j), k)), L::Set(G3));
+    Float x0 = L::Sub(x, L::Sub(L::ToFloat(i), t));
+    Float y0 = L::Sub(y, L::Sub(L::ToFloat(j), t));
+    Float z0 = L::Sub(z, L::Sub(L::ToFloat(k), t));
+
+    // The six orderings of x0, y0 and z0 pick the second and third corners, exactly one of i1, j1, k1 is set
+    // and exactly two of i2, j2, k2.
+    Int xy = L::GreaterEqual(x0, y0);
+    Int yz = L::GreaterEqual(y0, z0);
+    Int xz = L::GreaterEqual(x0, z0);
+    Int i1 = L::AndInt(L::AndInt(xy, L::OrInt(yz, xz)), one);
+    Int j1 = L::AndInt(L::AndNotInt(xy, yz), one);
+    Int k1 = L::SubInt(L::SubInt(one, i1), j1);
+    Int i2 = L::AndInt(L::OrInt(xy, L::AndInt(yz, xz)), one);
+    Int j2 = L::OrInt(L::AndNotInt(xy, one), L::AndInt(yz, one));
+    Int k2 = L::SubInt(L::SubInt(two, i2), j2);
+
+    Float x1 = L::Add(L::Sub(x0, L::ToFloat(i1)), L::Set(G3));
+    Float y1 = L::Add(L::Sub(y0, L::ToFloat(j1)), L::Set(G3));
+    Float z1 = L::Add(L::Sub(z0, L::ToFloat(k1)), L::Set(G3));
+    Float x2 = L::Add(L::Sub(x0, L::ToFloat(i2)), L::Set(2.0f * G3));
+    Float y2 = L::Add(L::Sub(y0, L::ToFloat(j2)), L::Set(2.0f * G3));
+    Float z2 = L::Add(L::Sub(z0, L::ToFloat(k2)), L::Set(2.0f * G3));
+    Float x3 = L::Add(L::Sub(x0, L::Set(1.0f)), L::Set(3.0f * G3));
+    Float y3 = L::Add(L::Sub(y0, L::Set(1.0f)), L::Set(3.0f * G3));
+    Float z3 = L::Add(L::Sub(z0, L::Set(1.0f)), L::Set(3.0f * G3));
+
+    // Hashed gradients of the four corners
+    Int ii = L::AndInt(i, L::SetInt(255));
+    Int jj = L::AndInt(j, L::SetInt(255));
+    Int kk = L::AndInt(k, L::SetInt(255));
+    Int g0 = L::AddInt(ii, L::Gather(tables->perm, L::AddInt(jj, L::Gather(tables->perm, kk))));
+    Int g1 = L::AddInt(L::AddInt(ii, i1), L::Gather(tables->perm, L::AddInt(L::AddInt(jj, j1), L::Gather(tables->perm, L::AddInt(kk, k1)))));
+    Int g2 = L::AddInt(L::AddInt(ii, i2), L::Gather(tables->perm, L::AddInt(L::AddInt(jj, j2), L::Gather(tables->perm, L::AddInt(kk, k2)))));
+    Int g3 = L::AddInt(L::AddInt(ii, one), L::Gather(tables->perm, L::AddInt(L::AddInt(jj, one), L::Gather(tables->perm, L::AddInt(kk, one)))));
+
+    Float n0 = noise_corner_3d_lanes<L>(tables, g0, x0, y0, z0);
+    Float n1 = noise_corner_3d_lanes<L>(tables, g1, x1, y1, z1);
+    Float n2 = noise_corner_3d_lanes<L>(tables, g2, x2, y2, z2);
+    Float n3 = noise_corner_3d_lanes<L>(tables, g3, x3, y3, z3);
+
+    return L::Mul(L::Set(32.0f), L::Add(L::Add(L::Add(n0, n1), n2), n3));
+}
+
+
+// Multi-octave noise over arrays of points, L::Width points at a time. A short last batch is padded out.
+template <class L>
+static inline void octave_noise_2d_lanes(const float octaves, const float persistence, const float scale, const float* x, const float* y, const int count, float* result) {
+    typedef typename L::Float Float;
+
+    const NoiseBatchTables* tables = get_noise_batch_tables();
+
+    for( int start = 0; start < count; start += L::Width ) {
+        int lanes = count - start;
+        if( lanes > L::Width ) lanes = L::Width;
+
+        float xLanes[L::Width];
+        float yLanes[L::Width];
+        for( int l = 0; l < L::Width; l++ ) {
+            xLanes[l] = (l < lanes) ? x[start + l] : 0.0f;
+            yLanes[l] = (l < lanes) ? y[start + l] : 0.0f;
+        }
+        Float px = L::Load(xLanes);
+        Float py = L::Load(yLanes);
+
+        Float total = L::Set(0.0f);
+        float frequency = scale;
+        float amplitude = 1;
+        float maxAmplitude = 0;
+
+        for( int i=0; i < octaves; i++ ) {
+            Float f = L::Set(frequency);
+            total = L::Add(total, L::Mul(raw_noise_2d_lanes<L>(tables, L::Mul(px, f), L::Mul(py, f)), L::Set(amplitude)));
+
+            frequency *= 2;
+            maxAmplitude += amplitude;
+            amplitude *= persistence;
+        }
+
+        float resultLanes[L::Width];
+        L::Store(resultLanes, L::Div(total, L::Set(maxAmplitude)));
+        for( int l = 0; l < lanes; l++ ) {
+            result[start + l] = resultLanes[l];
+        }
+    }
+}
+
+template <class L>
+static inline void octave_noise_3d_lanes(const float octaves, const float persistence, const float scale, const float* x, const float* y, const float* z, const int count, float* result) {
+    typedef typename L::Float Float;
+
+    const NoiseBatchTables* tables = get_noise_batch_tables();
+
+    for( int start = 0; start < count; start += L::Width ) {
+        int lanes = count - start;
+        if( lanes > L::Width ) lanes = L::Width;
+
+        float xLanes[L::Width];
+        float yLanes[L::Width];
+        float zLanes[L::Width];
+        for( int l = 0; l < L::Width; l++ ) {
+            xLanes[l] = (l < lanes) ? x[start + l] : 0.0f;
+            yLanes[l] = (l < lanes) ? y[start + l] : 0.0f;
+            zLanes[l] = (l < lanes) ? z[start + l] : 0.0f;
+        }
+        Float px = L::Load(xLanes);
+        Float py = L::Load(yLanes);
+        Float pz = L::Load(zLanes);
+
+        Float total = L::Set(0.0f);
+        float frequency = scale;
+        float amplitude = 1;
+        float maxAmplitude = 0;
+
+        for( int i=0; i < octaves; i++ ) {
+            Float f = L::Set(frequency);
+            total = L::Add(total, L::Mul(raw_noise_3d_lanes<L>(tables, L::Mul(px, f), L::Mul(py, f), L::Mul(pz, f)), L::Set(amplitude)));
+
+            frequency *= 2;
+            maxAmplitude += amplitude;
+            amplitude *= persistence;
+        }
+
+        float resultLanes[L::Width];
+        L::Store(resultLanes, L::Div(total, L::Set(maxAmplitude)));
+        for( int l = 0; l < lanes; l++ ) {
+            result[start + l] = resultLanes[l];
+        }
+    }
+}
+
+
+#endif /*SIMPLEX_LANES_H_*/
@@ -0,0 +1,53 @@
+// ******************************************************************************
+// Filename:    EntityStep.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "EntityStep.h"
+#include "SweptCollision.h"
+
+#include "../Maths/3dmaths.h"
+
+#include <glm/glm.hpp>
+
+
+bool EntityStep::MoveProjectile(const vec3 &sweepStart, vec3* pPosition, vec3* pVelocity, const vec3 &acceleration, float dt, VoxelRayGetChunkFunction getChunk, VoxelRayGetBlockFunction getBlock, void* pData, VoxelRayHit* pHit)
+{
+	SweptCollision::Integrate(pPosition, pVelocity, acceleration, dt);
+
+	return VoxelRayCast::Cast(sweepStart, (*pPosition) - sweepStart, 1.0f, getChunk, getBlock, pData, pHit);
+}
+
+bool EntityStep::SweepCubeHitbox(const vec3 &sweepStart, const vec3 &sweepEnd, float radius, const vec3 &hitboxCenter, float yRotation, const vec3 &halfLengths, float* pTime)
+{
+	Matrix4x4 rotationMatrix;
+	rotationMatrix.SetYRotation(DegToRad(yRotation));
+	vec3 xAxis = rotationMatrix * vec3(1.0f, 0.0f, 0.0f);
+	vec3 yAxis = rotationMatrix * vec3(0.0f, 1.0f, 0.0f);
+	vec3 zAxis = rotationMatrix * vec3(0.0f, 0.0f, 1.0f);
+
+	return SweptCollision::SphereBox(sweepStart, sweepEnd, radius, hitboxCenter, xAxis, yAxis, zAxis, halfLengths, pTime);
+}
+
+bool EntityStep::GetPushVector(const vec3 &center, float radius, const vec3 &otherCenter, float otherRadius, vec3* pPush)
+{
+	vec3 distance = otherCenter - center;
+	float overlap = length(distance) - radius - otherRadius;
+	if (overlap >= 0.0f)
+	{
+		return false;
+	}
+
+	// Scaled by the distance as well as the overlap, the push the managers have always used
+	vec3 pushVector = distance;
+	pushVector.y = 0.0f;
+	*pPush = -(pushVector * overlap);
+
+	return true;
+}
@@ -0,0 +1,39 @@
+// ******************************************************************************
+// Filename:    EntityStep.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The parts of the enemy, NPC, player and projectile updates that move
+//   entities and test them against each other, without the entities. The
+//   game objects call these with their own members, and vox_bench calls the
+//   same functions with its stand-ins, so the bench measures the game's
+//   stepping code rather than a copy of it. No GL is used.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../blocks/VoxelRayCast.h"
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+
+class EntityStep
+{
+public:
+	// Moves a projectile over the step, then casts along the segment from the sweep start to where it ended up.
+	// The ray is the movement, so the hit distance is the time of impact. The position is left at the end of the step.
+	static bool MoveProjectile(const vec3 &sweepStart, vec3* pPosition, vec3* pVelocity, const vec3 &acceleration, float dt, VoxelRayGetChunkFunction getChunk, VoxelRayGetBlockFunction getBlock, void* pData, VoxelRayHit* pHit);
+
+	// A projectile sweep against a cube hitbox, turned around y by the rotation in degrees
+	static bool SweepCubeHitbox(const vec3 &sweepStart, const vec3 &sweepEnd, float radius, const vec3 &hitboxCenter, float yRotation, const vec3 &halfLengths, float* pTime);
+
+	// How far to move the other entity so that it stops overlapping, never in y. False when they don't touch.
+	static bool GetPushVector(const vec3 &center, float radius, const vec3 &otherCenter, float otherRadius, vec3* pPush);
+};
@@ -0,0 +1,99 @@
+// ******************************************************************************
+// Filename:    FixedTimestep.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "FixedTimestep.h"
+
+
+FixedTimestep::FixedTimestep(int tickRate)
+{
+	m_stepTime = 0.0f;
+	m_interpolation = 1.0f;
+	m_numSteps = 0;
+
+	SetTickRate(tickRate);
+}
+
+FixedTimestep::~FixedTimestep()
+{
+}
+
+void FixedTimestep::SetTickRate(int tickRate)
+{
+	if (tickRate < 0)
+	{
+		tickRate = 0;
+	}
+
+	m_tickRate = tickRate;
+	m_fixedStepTime = (m_tickRate > 0) ? 1.0f / m_tickRate : 0.0f;
+	m_accumulator = 0.0;
+}
+
+int FixedTimestep::GetTickRate()
+{
+	return m_tickRate;
+}
+
+bool FixedTimestep::IsFixed()
+{
+	return m_tickRate > 0;
+}
+
+int FixedTimestep::Update(float frameDeltaTime)
+{
+	if (IsFixed() == false)
+	{
+		m_stepTime = frameDeltaTime;
+		m_interpolation = 1.0f;
+		m_numSteps = 1;
+
+		return m_numSteps;
+	}
+
+	m_accumulator += frameDeltaTime;
+
+	m_stepTime = m_fixedStepTime;
+	m_numSteps = (int)(m_accumulator / m_fixedStepTime);
+	if (m_numSteps > MAX_STEPS_PER_FRAME)
+	{
+		m_numSteps = MAX_STEPS_PER_FRAME;
+		m_accumulator = m_fixedStepTime * MAX_STEPS_PER_FRAME;
+	}
+
+	m_accumulator -= m_fixedStepTime * m_numSteps;
+	if (m_accumulator < 0.0)
+	{
+		m_accumulator = 0.0;
+	}
+
+	m_interpolation = (float)(m_accumulator / m_fixedStepTime);
+	if (m_interpolation > 1.0f)
+	{
+		m_interpolation = 1.0f;
+	}
+
+	return m_numSteps;
+}
+
+float FixedTimestep::GetStepTime()
+{
+	return m_stepTime;
+}
+
+float FixedTimestep::GetInterpolation()
+{
+	return m_interpolation;
+}
+
+int FixedTimestep::GetNumSteps()
+{
+	return m_numSteps;
+}
@@ -0,0 +1,68 @@
+// ******************************************************************************
+// Filename:    FixedTimestep.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Splits the variable frame time into fixed size simulation steps. The frame
+//   time is added to an accumulator and as many whole steps as fit are taken
+//   out of it. The time left over is returned as an interpolation amount, so
+//   that rendering can blend between the previous and the current simulation
+//   state. A tick rate of 0 turns this off, and every frame is a single step of
+//   the frame time, which is how the game used to update.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+
+class FixedTimestep
+{
+public:
+	/* Public methods */
+	FixedTimestep(int tickRate);
+	~FixedTimestep();
+
+	void SetTickRate(int tickRate);
+	int GetTickRate();
+	bool IsFixed();
+
+	// Adds the frame time and returns how many simulation steps to run this frame
+	int Update(float frameDeltaTime);
+
+	// The delta time to pass to each simulation step
+	float GetStepTime();
+
+	// How far we are between the previous and the current simulation step, 0.0 to 1.0
+	float GetInterpolation();
+
+	int GetNumSteps();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+	// If we fall further behind than this the extra time is dropped, otherwise a slow frame makes the next frame even slower
+	static const int MAX_STEPS_PER_FRAME = 10;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_tickRate;
+	float m_fixedStepTime;
+
+	double m_accumulator;
+	float m_stepTime;
+	float m_interpolation;
+	int m_numSteps;
+};
@@ -0,0 +1,303 @@
+// ******************************************************************************
+// Filename:    JobPool.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "JobPool.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+
+// Min-heap ordering, so that the lowest priority value sits at the front of the queue
+static bool JobPriorityCompare(const Job& lhs, const Job& rhs)
+{
+	return lhs.m_priority > rhs.m_priority;
+}
+
+JobPool::JobPool(int numWorkers)
+{
+	if (numWorkers <= 0)
+	{
+		numWorkers = GetDefaultNumWorkers();
+	}
+
+	m_nextQueue = 0;
+	m_numSleepingWorkers = 0;
+	m_numWaitingThreads = 0;
+	m_shutdown = false;
+
+	for (int i = 0; i < numWorkers; i++)
+	{
+		JobQueue* pQueue = new JobQueue();
+		pQueue->m_numJobs = 0;
+		pQueue->m_frontPriority = 0.0f;
+		pQueue->m_numActiveJobs = 0;
+		pQueue->m_numJobsCompleted = 0;
+		pQueue->m_numJobsStolen = 0;
+		m_vpJobQueues.push_back(pQueue);
+	}
+
+	// Create the queues before any worker starts, since workers steal from all the queues
+	for (int i = 0; i < numWorkers; i++)
+	{
+		JobWorker* pWorker = new JobWorker();
+		pWorker->m_pJobPool = this;
+		pWorker->m_workerIndex = i;
+		pWorker->m_pThread = NULL;
+		m_vpJobWorkers.push_back(pWorker);
+	}
+
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_vpJobWorkers[i]->m_pThread = new tthread::thread(_WorkerThread, m_vpJobWorkers[i]);
+	}
+}
+
+JobPool::~JobPool()
+{
+	// Let the workers finish off any remaining jobs and then exit
+	m_jobsLock.lock();
+	m_shutdown = true;
+	m_jobsAvailable.notify_all();
+	m_jobsLock.unlock();
+
+	for (unsigned int i = 0; i < m_vpJobWorkers.size(); i++)
+	{
+		m_vpJobWorkers[i]->m_pThread->join();
+		delete m_vpJobWorkers[i]->m_pThread;
+		delete m_vpJobWorkers[i];
+		m_vpJobWorkers[i] = 0;
+	}
+	m_vpJobWorkers.clear();
+
+	for (unsigned int i = 0; i < m_vpJobQueues.size(); i++)
+	{
+		delete m_vpJobQueues[i];
+		m_vpJobQueues[i] = 0;
+	}
+	m_vpJobQueues.clear();
+}
+
+// Workers
+int JobPool::GetNumWorkers()
+{
+	return (int)m_vpJobWorkers.size();
+}
+
+int JobPool::GetDefaultNumWorkers()
+{
+	// Leave a hardware thread free for the calling (main) thread
+	int numWorkers = (int)tthread::thread::hardware_concurrency() - 1;
+	if (numWorkers < 1)
+	{
+		numWorkers = 1;
+	}
+
+	return numWorkers;
+}
+
+// Jobs
+void JobPool::AddJob(JobFunction function, void* pData, float priority)
+{
+	Job job;
+	job.m_function = function;
+	job.m_pData = pData;
+	job.m_priority = priority;
+
+	int queueIndex = (int)(m_nextQueue++ % (unsigned int)m_vpJobQueues.size());
+
+	JobQueue* pQueue = m_vpJobQueues[queueIndex];
+	pQueue->m_queueLock.lock();
+	pQueue->m_jobs.push_back(job);
+	push_heap(pQueue->m_jobs.begin(), pQueue->m_jobs.end(), JobPriorityCompare);
+	pQueue->m_frontPriority = pQueue->m_jobs.front().m_priority;
+	pQueue->m_numJobs++;
+	pQueue->m_queueLock.unlock();
+
+	// A worker counts itself as sleeping before it checks the queues for the last time, so either it sees this job or we see it
+	if (m_numSleepingWorkers > 0)
+	{
+		m_jobsLock.lock();
+		m_jobsAvailable.notify_one();
+		m_jobsLock.unlock();
+	}
+}
+
+void JobPool::WaitForAllJobs()
+{
+	m_jobsLock.lock();
+	m_numWaitingThreads++;
+	while (GetNumPendingJobs() > 0)
+	{
+		m_jobsFinished.wait(m_jobsLock);
+	}
+	m_numWaitingThreads--;
+	m_jobsLock.unlock();
+}
+
+int JobPool::GetNumPendingJobs()
+{
+	// A popped job is counted as active before it leaves its queue, so count all the queues before the active jobs
+	int numPending = GetNumQueuedJobs();
+	for (unsigned int i = 0; i < m_vpJobQueues.size(); i++)
+	{
+		numPending += m_vpJobQueues[i]->m_numActiveJobs;
+	}
+
+	return numPending;
+}
+
+// Counters
+int JobPool::GetNumJobsCompleted()
+{
+	int numCompleted = 0;
+	for (unsigned int i = 0; i < m_vpJobQueues.size(); i++)
+	{
+		numCompleted += m_vpJobQueues[i]->m_numJobsCompleted.load(std::memory_order_relaxed);
+	}
+
+	return numCompleted;
+}
+
+int JobPool::GetNumJobsStolen()
+{
+	int numStolen = 0;
+	for (unsigned int i = 0; i < m_vpJobQueues.size(); i++)
+	{
+		numStolen += m_vpJobQueues[i]->m_numJobsStolen.load(std::memory_order_relaxed);
+	}
+
+	return numStolen;
+}
+
+// Worker threads
+void JobPool::_WorkerThread(void* pData)
+{
+	JobWorker* pWorker = (JobWorker*)pData;
+	pWorker->m_pJobPool->WorkerThread(pWorker->m_workerIndex);
+}
+
+void JobPool::WorkerThread(int workerIndex)
+{
+	char lThreadName[32];
+	sprintf(lThreadName, "Job worker %i", workerIndex);
+	PROFILE_THREAD_NAME(lThreadName);
+
+	JobQueue* pOwnQueue = m_vpJobQueues[workerIndex];
+
+	while (true)
+	{
+		Job job;
+		if (PopJob(workerIndex, &job))
+		{
+			job.m_function(job.m_pData);
+
+			pOwnQueue->m_numJobsCompleted.fetch_add(1, std::memory_order_relaxed);
+			pOwnQueue->m_numActiveJobs--;
+
+			// Only the last job to finish finds nothing pending, and it only takes the lock if somebody is waiting
+			if (m_numWaitingThreads > 0 && GetNumPendingJobs() == 0)
+			{
+				m_jobsLock.lock();
+				m_jobsFinished.notify_all();
+				m_jobsLock.unlock();
+			}
+
+			continue;
+		}
+
+		// Nothing to do, sleep until a job is added or we are shut down
+		m_jobsLock.lock();
+		m_numSleepingWorkers++;
+		while (GetNumQueuedJobs() == 0 && m_shutdown == false)
+		{
+			m_jobsAvailable.wait(m_jobsLock);
+		}
+		m_numSleepingWorkers--;
+		bool exit = (GetNumQueuedJobs() == 0 && m_shutdown == true);
+		m_jobsLock.unlock();
+
+		if (exit)
+		{
+			break;
+		}
+	}
+}
+
+bool JobPool::PopJob(int workerIndex, Job* pJob)
+{
+	int numQueues = (int)m_vpJobQueues.size();
+
+	while (true)
+	{
+		// Find the queue with the most urgent job at its front, starting with our own so that it wins a tie
+		int bestQueueIndex = -1;
+		float bestPriority = 0.0f;
+		for (int i = 0; i < numQueues; i++)
+		{
+			int queueIndex = (workerIndex + i) % numQueues;
+			JobQueue* pQueue = m_vpJobQueues[queueIndex];
+
+			if (pQueue->m_numJobs > 0)
+			{
+				float priority = pQueue->m_frontPriority.load(std::memory_order_relaxed);
+				if (bestQueueIndex == -1 || priority < bestPriority)
+				{
+					bestQueueIndex = queueIndex;
+					bestPriority = priority;
+				}
+			}
+		}
+
+		if (bestQueueIndex == -1)
+		{
+			return false;
+		}
+
+		// Another worker can empty the queue before we lock it, then look again
+		JobQueue* pQueue = m_vpJobQueues[bestQueueIndex];
+		pQueue->m_queueLock.lock();
+		if (pQueue->m_jobs.empty() == false)
+		{
+			pop_heap(pQueue->m_jobs.begin(), pQueue->m_jobs.end(), JobPriorityCompare);
+			*pJob = pQueue->m_jobs.back();
+			pQueue->m_jobs.pop_back();
+			if (pQueue->m_jobs.empty() == false)
+			{
+				pQueue->m_frontPriority = pQueue->m_jobs.front().m_priority;
+			}
+
+			// Active before it leaves the queue, so that the job is never missing from the pending count
+			m_vpJobQueues[workerIndex]->m_numActiveJobs++;
+			pQueue->m_numJobs--;
+			pQueue->m_queueLock.unlock();
+
+			if (bestQueueIndex != workerIndex)
+			{
+				m_vpJobQueues[workerIndex]->m_numJobsStolen.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			return true;
+		}
+		pQueue->m_queueLock.unlock();
+	}
+}
+
+int JobPool::GetNumQueuedJobs()
+{
+	int numQueued = 0;
+	for (unsigned int i = 0; i < m_vpJobQueues.size(); i++)
+	{
+		numQueued += m_vpJobQueues[i]->m_numJobs;
+	}
+
+	return numQueued;
+}
@@ -0,0 +1,124 @@
+// ******************************************************************************
+// Filename:    JobPool.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//	 A pool of worker threads that execute small independent jobs. Each worker
+//	 owns a prioritized job queue and jobs are handed out round robin. A worker
+//	 takes the highest priority job at the front of all the queues, its own
+//	 queue wins a tie, so a worker steals from the others when they hold more
+//	 urgent work. Lower priority values are executed first. The job counts are
+//	 kept per queue, the pool lock is only taken to sleep and wake workers and
+//	 waiters.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+#include <atomic>
+
+typedef void(*JobFunction)(void *pData);
+
+class Job
+{
+public:
+	JobFunction m_function;
+	void* m_pData;
+	float m_priority;
+};
+
+class JobQueue
+{
+public:
+	tthread::mutex m_queueLock;
+	vector<Job> m_jobs;
+
+	// Read without the queue lock to pick a queue, the front priority is only a hint until the queue is locked
+	std::atomic<int> m_numJobs;
+	std::atomic<float> m_frontPriority;
+
+	// Counters for the worker that owns this queue
+	std::atomic<int> m_numActiveJobs;
+	std::atomic<int> m_numJobsCompleted;
+	std::atomic<int> m_numJobsStolen;
+};
+
+class JobPool;
+
+class JobWorker
+{
+public:
+	JobPool* m_pJobPool;
+	int m_workerIndex;
+	tthread::thread* m_pThread;
+};
+
+typedef vector<JobQueue*> JobQueueList;
+typedef vector<JobWorker*> JobWorkerList;
+
+
+class JobPool
+{
+public:
+	/* Public methods */
+	// If numWorkers is 0 or less, a worker is created for every hardware thread except the calling one
+	JobPool(int numWorkers);
+	~JobPool();
+
+	// Workers
+	int GetNumWorkers();
+	static int GetDefaultNumWorkers();
+
+	// Jobs
+	void AddJob(JobFunction function, void* pData, float priority);
+	void WaitForAllJobs();
+	int GetNumPendingJobs();
+
+	// Counters
+	int GetNumJobsCompleted();
+	int GetNumJobsStolen();
+
+	// Worker threads
+	static void _WorkerThread(void* pData);
+	void WorkerThread(int workerIndex);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	bool PopJob(int workerIndex, Job* pJob);
+	int GetNumQueuedJobs();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	JobQueueList m_vpJobQueues;
+	JobWorkerList m_vpJobWorkers;
+
+	// Round robin queue to add the next job to
+	std::atomic<unsigned int> m_nextQueue;
+
+	// Sleeping workers and threads waiting for all the jobs, the counts let AddJob and the workers skip the lock when nobody is waiting
+	tthread::mutex m_jobsLock;
+	tthread::condition_variable m_jobsAvailable;
+	tthread::condition_variable m_jobsFinished;
+	std::atomic<int> m_numSleepingWorkers;
+	std::atomic<int> m_numWaitingThreads;
+	std::atomic<bool> m_shutdown;
+};
@@ -0,0 +1,193 @@
+// ******************************************************************************
+// Filename:    ParallelUpdate.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ParallelUpdate.h"
+#include "Profiler.h"
+
+
+// Deferred command buffer
+DeferredCommandBuffer::DeferredCommandBuffer()
+{
+}
+
+DeferredCommandBuffer::~DeferredCommandBuffer()
+{
+	m_vCommands.clear();
+}
+
+void DeferredCommandBuffer::AddCommand(DeferredCommandFunction function, void* pObject, void* pData)
+{
+	DeferredCommand command;
+	command.m_function = function;
+	command.m_pObject = pObject;
+	command.m_pData = pData;
+
+	m_vCommands.push_back(command);
+}
+
+void DeferredCommandBuffer::ExecuteCommands()
+{
+	for (unsigned int i = 0; i < m_vCommands.size(); i++)
+	{
+		m_vCommands[i].m_function(m_vCommands[i].m_pObject, m_vCommands[i].m_pData);
+	}
+
+	m_vCommands.clear();
+}
+
+int DeferredCommandBuffer::GetNumCommands()
+{
+	return (int)m_vCommands.size();
+}
+
+// Parallel update
+ParallelUpdate::ParallelUpdate(int numThreads)
+{
+	m_pJobPool = NULL;
+
+	if (numThreads != 1)
+	{
+		m_pJobPool = new JobPool(numThreads);
+		numThreads = m_pJobPool->GetNumWorkers();
+	}
+
+	m_numThreads = numThreads;
+
+	m_function = NULL;
+	m_pFunctionData = NULL;
+
+	ResetCounters();
+}
+
+ParallelUpdate::~ParallelUpdate()
+{
+	delete m_pJobPool;
+	m_pJobPool = NULL;
+
+	for (unsigned int i = 0; i < m_vpBatches.size(); i++)
+	{
+		delete m_vpBatches[i];
+		m_vpBatches[i] = 0;
+	}
+	m_vpBatches.clear();
+}
+
+int ParallelUpdate::GetNumThreads()
+{
+	return m_numThreads;
+}
+
+void ParallelUpdate::Run(int numItems, ParallelUpdateFunction function, void* pData)
+{
+	if (numItems <= 0)
+	{
+		return;
+	}
+
+	m_function = function;
+	m_pFunctionData = pData;
+
+	// Work out the batches, small lists are not worth handing out to the workers
+	int numBatches = 1;
+	if (m_pJobPool != NULL)
+	{
+		numBatches = m_numThreads * BATCHES_PER_THREAD;
+		if (numBatches > numItems / MIN_BATCH_SIZE)
+		{
+			numBatches = numItems / MIN_BATCH_SIZE;
+		}
+		if (numBatches < 1)
+		{
+			numBatches = 1;
+		}
+	}
+
+	while ((int)m_vpBatches.size() < numBatches)
+	{
+		ParallelUpdateBatch* pBatch = new ParallelUpdateBatch();
+		pBatch->m_pParallelUpdate = this;
+		m_vpBatches.push_back(pBatch);
+	}
+
+	int batchSize = (numItems + numBatches - 1) / numBatches;
+	for (int i = 0; i < numBatches; i++)
+	{
+		ParallelUpdateBatch* pBatch = m_vpBatches[i];
+		pBatch->m_start = i * batchSize;
+		pBatch->m_end = pBatch->m_start + batchSize;
+		if (pBatch->m_end > numItems)
+		{
+			pBatch->m_end = numItems;
+		}
+	}
+
+	if (numBatches == 1)
+	{
+		BatchJob(m_vpBatches[0]);
+	}
+	else
+	{
+		for (int i = 0; i < numBatches; i++)
+		{
+			// Earlier batches first, their commands are executed first
+			m_pJobPool->AddJob(_BatchJob, m_vpBatches[i], (float)i);
+		}
+
+		m_pJobPool->WaitForAllJobs();
+	}
+
+	// Execute the deferred commands, in the same order that a single thread would have created them
+	for (int i = 0; i < numBatches; i++)
+	{
+		m_numDeferredCommands += m_vpBatches[i]->m_commands.GetNumCommands();
+
+		m_vpBatches[i]->m_commands.ExecuteCommands();
+	}
+
+	m_numItemsUpdated += numItems;
+
+	m_function = NULL;
+	m_pFunctionData = NULL;
+}
+
+// Counters
+void ParallelUpdate::ResetCounters()
+{
+	m_numItemsUpdated = 0;
+	m_numDeferredCommands = 0;
+}
+
+int ParallelUpdate::GetNumItemsUpdated()
+{
+	return m_numItemsUpdated;
+}
+
+int ParallelUpdate::GetNumDeferredCommands()
+{
+	return m_numDeferredCommands;
+}
+
+// Batch jobs
+void ParallelUpdate::_BatchJob(void* pData)
+{
+	ParallelUpdateBatch* pBatch = (ParallelUpdateBatch*)pData;
+	pBatch->m_pParallelUpdate->BatchJob(pBatch);
+}
+
+void ParallelUpdate::BatchJob(ParallelUpdateBatch* pBatch)
+{
+	PROFILE_ZONE("ParallelUpdate::BatchJob");
+
+	for (int i = pBatch->m_start; i < pBatch->m_end; i++)
+	{
+		m_function(m_pFunctionData, i, &pBatch->m_commands);
+	}
+}
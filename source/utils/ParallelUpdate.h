@@ -0,0 +1,139 @@
+// ******************************************************************************
+// Filename:    ParallelUpdate.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Runs an update function over a list of independent objects (enemies,
+//   NPCs, items, projectiles) on a pool of worker threads. The list is split
+//   into contiguous batches. While the batches run, the objects may only
+//   change their own state and read the world. Anything that touches shared
+//   state (damage, spawning, particles, lights, interpolations) is recorded
+//   into the batch's DeferredCommandBuffer instead. Once every batch has
+//   finished the commands are executed on the calling thread, in batch order,
+//   so the results do not depend on how many threads were used.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "JobPool.h"
+
+typedef void(*DeferredCommandFunction)(void *pObject, void *pData);
+
+class DeferredCommand
+{
+public:
+	DeferredCommandFunction m_function;
+	void* m_pObject;
+	void* m_pData;
+};
+
+class DeferredCommandBuffer
+{
+public:
+	/* Public methods */
+	DeferredCommandBuffer();
+	~DeferredCommandBuffer();
+
+	void AddCommand(DeferredCommandFunction function, void* pObject, void* pData);
+
+	// Executes the commands in the order they were added, and then clears the buffer
+	void ExecuteCommands();
+
+	int GetNumCommands();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<DeferredCommand> m_vCommands;
+};
+
+typedef void(*ParallelUpdateFunction)(void *pData, int index, DeferredCommandBuffer* pCommands);
+
+class ParallelUpdate;
+
+class ParallelUpdateBatch
+{
+public:
+	ParallelUpdate* m_pParallelUpdate;
+	int m_start;
+	int m_end;
+	DeferredCommandBuffer m_commands;
+};
+
+typedef vector<ParallelUpdateBatch*> ParallelUpdateBatchList;
+
+
+class ParallelUpdate
+{
+public:
+	/* Public methods */
+	// A thread count of 1 runs everything on the calling thread, 0 or less uses a worker for every hardware thread except the calling one
+	ParallelUpdate(int numThreads);
+	~ParallelUpdate();
+
+	int GetNumThreads();
+
+	// Calls function for each index from 0 to numItems-1 and then executes the deferred commands. Must be called from one thread only
+	void Run(int numItems, ParallelUpdateFunction function, void* pData);
+
+	// Counters
+	void ResetCounters();
+	int GetNumItemsUpdated();
+	int GetNumDeferredCommands();
+
+	// Batch jobs
+	static void _BatchJob(void* pData);
+	void BatchJob(ParallelUpdateBatch* pBatch);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+	static const int BATCHES_PER_THREAD = 4;
+	static const int MIN_BATCH_SIZE = 8;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numThreads;
+
+	// NULL when running on the calling thread only
+	JobPool* m_pJobPool;
+
+	// Batches are kept between runs, so that the command buffers keep their storage
+	ParallelUpdateBatchList m_vpBatches;
+
+	// The function for the current run
+	ParallelUpdateFunction m_function;
+	void* m_pFunctionData;
+
+	// Counters
+	int m_numItemsUpdated;
+	int m_numDeferredCommands;
+};
@@ -0,0 +1,405 @@
+// ******************************************************************************
+// Filename:    PickingBVH.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "PickingBVH.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+// Deep enough for any hierarchy built from MAX_LEAF_VOLUMES sized leaves
+static const int MAX_TRAVERSAL_STACK = 64;
+
+
+// Ray against an axis aligned box, the entry and exit distances along the ray
+static bool RayBox(const vec3 &origin, const vec3 &inverseDirection, const vec3 &boxMin, const vec3 &boxMax, float* pEnter, float* pExit)
+{
+	float enter = -FLT_MAX;
+	float exit = FLT_MAX;
+	for (int i = 0; i < 3; i++)
+	{
+		float t1 = (boxMin[i] - origin[i]) * inverseDirection[i];
+		float t2 = (boxMax[i] - origin[i]) * inverseDirection[i];
+		if (t1 > t2)
+		{
+			Swap(t1, t2);
+		}
+		// NaN from a zero direction inside the slab keeps the old value
+		enter = (t1 > enter) ? t1 : enter;
+		exit = (t2 < exit) ? t2 : exit;
+	}
+
+	*pEnter = enter;
+	*pExit = exit;
+
+	return enter <= exit;
+}
+
+static vec3 GetInverseDirection(const vec3 &direction)
+{
+	return vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+}
+
+class PickingCentroidCompare
+{
+public:
+	PickingCentroidCompare(const vector<PickingVolume>* pvVolumes, int axis) { m_pvVolumes = pvVolumes; m_axis = axis; }
+
+	bool operator()(int a, int b) const
+	{
+		const PickingVolume& volumeA = (*m_pvVolumes)[a];
+		const PickingVolume& volumeB = (*m_pvVolumes)[b];
+		return (volumeA.m_worldMin[m_axis] + volumeA.m_worldMax[m_axis]) < (volumeB.m_worldMin[m_axis] + volumeB.m_worldMax[m_axis]);
+	}
+
+	const vector<PickingVolume>* m_pvVolumes;
+	int m_axis;
+};
+
+
+PickingBVH::PickingBVH()
+{
+	m_numNodeTests = 0;
+	m_numVolumeTests = 0;
+}
+
+PickingBVH::~PickingBVH()
+{
+}
+
+void PickingBVH::Clear()
+{
+	m_vVolumes.clear();
+	m_vVolumeOrder.clear();
+	m_vNodes.clear();
+}
+
+void PickingBVH::AddBox(int id, const Matrix4x4 &transform, const vec3 &localMin, const vec3 &localMax)
+{
+	PickingVolume volume;
+	volume.m_id = id;
+	volume.m_transform = transform;
+	volume.m_inverseTransform = transform.GetInverse();
+	volume.m_localMin = localMin;
+	volume.m_localMax = localMax;
+	volume.m_pVoxels = NULL;
+	volume.m_sizeX = 0;
+	volume.m_sizeY = 0;
+	volume.m_sizeZ = 0;
+
+	// The world box around the eight transformed corners
+	volume.m_worldMin = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	volume.m_worldMax = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (int i = 0; i < 8; i++)
+	{
+		vec3 corner = vec3((i & 1) ? localMax.x : localMin.x, (i & 2) ? localMax.y : localMin.y, (i & 4) ? localMax.z : localMin.z);
+		vec3 worldCorner;
+		Matrix4x4::Multiply(transform, corner, worldCorner);
+		volume.m_worldMin = min(volume.m_worldMin, worldCorner);
+		volume.m_worldMax = max(volume.m_worldMax, worldCorner);
+	}
+
+	m_vVolumes.push_back(volume);
+}
+
+void PickingBVH::AddVoxels(int id, const Matrix4x4 &transform, const unsigned int* pVoxels, int sizeX, int sizeY, int sizeZ)
+{
+	AddBox(id, transform, vec3(-0.5f, -0.5f, -0.5f), vec3(sizeX - 0.5f, sizeY - 0.5f, sizeZ - 0.5f));
+
+	PickingVolume* pVolume = &m_vVolumes.back();
+	pVolume->m_pVoxels = pVoxels;
+	pVolume->m_sizeX = sizeX;
+	pVolume->m_sizeY = sizeY;
+	pVolume->m_sizeZ = sizeZ;
+}
+
+void PickingBVH::Build()
+{
+	m_vNodes.clear();
+	m_vVolumeOrder.resize(m_vVolumes.size());
+	for (unsigned int i = 0; i < m_vVolumes.size(); i++)
+	{
+		m_vVolumeOrder[i] = i;
+	}
+
+	if (m_vVolumes.size() > 0)
+	{
+		m_vNodes.reserve(m_vVolumes.size() * 2);
+		BuildNode(0, (int)m_vVolumes.size());
+	}
+}
+
+bool PickingBVH::RayCast(const vec3 &origin, const vec3 &direction, float maxDistance, PickingHit* pHit)
+{
+	m_numNodeTests = 0;
+	m_numVolumeTests = 0;
+
+	if (m_vNodes.size() == 0)
+	{
+		return false;
+	}
+
+	vec3 inverseDirection = GetInverseDirection(direction);
+	float closestDistance = maxDistance;
+	int closestVolume = -1;
+
+	int stack[MAX_TRAVERSAL_STACK];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const PickingBVHNode& node = m_vNodes[stack[--stackSize]];
+
+		float enter;
+		float exit;
+		m_numNodeTests++;
+		if (RayBox(origin, inverseDirection, node.m_min, node.m_max, &enter, &exit) == false || exit < 0.0f || enter > closestDistance)
+		{
+			continue;
+		}
+
+		if (node.m_left == -1)
+		{
+			for (int i = node.m_first; i < node.m_first + node.m_count; i++)
+			{
+				float distance;
+				m_numVolumeTests++;
+				if (RayVolume(m_vVolumes[m_vVolumeOrder[i]], origin, direction, closestDistance, &distance))
+				{
+					closestDistance = distance;
+					closestVolume = m_vVolumeOrder[i];
+				}
+			}
+		}
+		else if (stackSize + 2 <= MAX_TRAVERSAL_STACK)
+		{
+			// Visit the nearer child first, so that the further one is more likely to be pruned
+			const PickingBVHNode& left = m_vNodes[node.m_left];
+			const PickingBVHNode& right = m_vNodes[node.m_right];
+			vec3 toLeft = (left.m_min + left.m_max) * 0.5f - origin;
+			vec3 toRight = (right.m_min + right.m_max) * 0.5f - origin;
+			if (dot(toLeft, direction) < dot(toRight, direction))
+			{
+				stack[stackSize++] = node.m_right;
+				stack[stackSize++] = node.m_left;
+			}
+			else
+			{
+				stack[stackSize++] = node.m_left;
+				stack[stackSize++] = node.m_right;
+			}
+		}
+	}
+
+	if (closestVolume == -1)
+	{
+		return false;
+	}
+
+	pHit->m_id = m_vVolumes[closestVolume].m_id;
+	pHit->m_distance = closestDistance;
+	pHit->m_position = origin + direction * closestDistance;
+
+	return true;
+}
+
+bool PickingBVH::RayCastBruteForce(const vec3 &origin, const vec3 &direction, float maxDistance, PickingHit* pHit)
+{
+	float closestDistance = maxDistance;
+	int closestVolume = -1;
+
+	for (unsigned int i = 0; i < m_vVolumes.size(); i++)
+	{
+		float distance;
+		if (RayVolume(m_vVolumes[i], origin, direction, closestDistance, &distance))
+		{
+			closestDistance = distance;
+			closestVolume = i;
+		}
+	}
+
+	if (closestVolume == -1)
+	{
+		return false;
+	}
+
+	pHit->m_id = m_vVolumes[closestVolume].m_id;
+	pHit->m_distance = closestDistance;
+	pHit->m_position = origin + direction * closestDistance;
+
+	return true;
+}
+
+void PickingBVH::GetScreenRay(float screenX, float screenY, int screenWidth, int screenHeight, float fov, const vec3 &cameraPos, const vec3 &cameraTarget, const vec3 &cameraUp, vec3* pOrigin, vec3* pDirection)
+{
+	// The same camera as gluPerspective() and gluLookAt()
+	vec3 forward = normalize(cameraTarget - cameraPos);
+	vec3 right = normalize(cross(forward, cameraUp));
+	vec3 up = cross(right, forward);
+
+	float tanHalfFovY = tan(DegToRad(fov) * 0.5f);
+	float tanHalfFovX = tanHalfFovY * ((float)screenWidth / (float)screenHeight);
+	float ndcX = (screenX / screenWidth) * 2.0f - 1.0f;
+	float ndcY = (screenY / screenHeight) * 2.0f - 1.0f;
+
+	*pOrigin = cameraPos;
+	*pDirection = normalize(forward + right * (ndcX * tanHalfFovX) + up * (ndcY * tanHalfFovY));
+}
+
+// Counters
+int PickingBVH::GetNumVolumes()
+{
+	return (int)m_vVolumes.size();
+}
+
+int PickingBVH::GetNumNodes()
+{
+	return (int)m_vNodes.size();
+}
+
+int PickingBVH::GetNumNodeTests()
+{
+	return m_numNodeTests;
+}
+
+int PickingBVH::GetNumVolumeTests()
+{
+	return m_numVolumeTests;
+}
+
+int PickingBVH::BuildNode(int first, int count)
+{
+	int nodeIndex = (int)m_vNodes.size();
+	m_vNodes.push_back(PickingBVHNode());
+
+	vec3 boundsMin = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	vec3 boundsMax = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	vec3 centroidMin = boundsMin;
+	vec3 centroidMax = boundsMax;
+	for (int i = first; i < first + count; i++)
+	{
+		const PickingVolume& volume = m_vVolumes[m_vVolumeOrder[i]];
+		boundsMin = min(boundsMin, volume.m_worldMin);
+		boundsMax = max(boundsMax, volume.m_worldMax);
+		vec3 centroid = (volume.m_worldMin + volume.m_worldMax) * 0.5f;
+		centroidMin = min(centroidMin, centroid);
+		centroidMax = max(centroidMax, centroid);
+	}
+
+	PickingBVHNode node;
+	node.m_min = boundsMin;
+	node.m_max = boundsMax;
+	node.m_left = -1;
+	node.m_right = -1;
+	node.m_first = first;
+	node.m_count = count;
+
+	if (count > MAX_LEAF_VOLUMES)
+	{
+		// Split at the median along the longest axis of the centroids
+		vec3 extent = centroidMax - centroidMin;
+		int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : ((extent.y > extent.z) ? 1 : 2);
+		int half = count / 2;
+		nth_element(m_vVolumeOrder.begin() + first, m_vVolumeOrder.begin() + first + half, m_vVolumeOrder.begin() + first + count, PickingCentroidCompare(&m_vVolumes, axis));
+
+		node.m_left = BuildNode(first, half);
+		node.m_right = BuildNode(first + half, count - half);
+		node.m_count = 0;
+	}
+
+	m_vNodes[nodeIndex] = node;
+
+	return nodeIndex;
+}
+
+bool PickingBVH::RayVolume(const PickingVolume &volume, const vec3 &origin, const vec3 &direction, float maxDistance, float* pDistance)
+{
+	// Into local space, the direction isn't normalized so that distances along the ray stay the same
+	vec3 localOrigin;
+	vec3 localEnd;
+	Matrix4x4::Multiply(volume.m_inverseTransform, origin, localOrigin);
+	Matrix4x4::Multiply(volume.m_inverseTransform, origin + direction, localEnd);
+	vec3 localDirection = localEnd - localOrigin;
+	vec3 inverseDirection = GetInverseDirection(localDirection);
+
+	float enter;
+	float exit;
+	if (RayBox(localOrigin, inverseDirection, volume.m_localMin, volume.m_localMax, &enter, &exit) == false || exit < 0.0f || enter > maxDistance)
+	{
+		return false;
+	}
+
+	enter = (enter < 0.0f) ? 0.0f : enter;
+	exit = (exit > maxDistance) ? maxDistance : exit;
+
+	if (volume.m_pVoxels == NULL)
+	{
+		*pDistance = enter;
+		return true;
+	}
+
+	// Walk the voxels from where the ray enters the grid
+	int size[3] = { volume.m_sizeX, volume.m_sizeY, volume.m_sizeZ };
+	vec3 start = localOrigin + localDirection * enter;
+	int voxel[3];
+	int step[3];
+	float nextBoundary[3];
+	float boundaryStep[3];
+	for (int i = 0; i < 3; i++)
+	{
+		voxel[i] = (int)floor(start[i] + 0.5f);
+		voxel[i] = (voxel[i] < 0) ? 0 : ((voxel[i] >= size[i]) ? size[i] - 1 : voxel[i]);
+
+		if (localDirection[i] > 0.0f)
+		{
+			step[i] = 1;
+			nextBoundary[i] = (voxel[i] + 0.5f - localOrigin[i]) * inverseDirection[i];
+			boundaryStep[i] = inverseDirection[i];
+		}
+		else if (localDirection[i] < 0.0f)
+		{
+			step[i] = -1;
+			nextBoundary[i] = (voxel[i] - 0.5f - localOrigin[i]) * inverseDirection[i];
+			boundaryStep[i] = -inverseDirection[i];
+		}
+		else
+		{
+			step[i] = 0;
+			nextBoundary[i] = FLT_MAX;
+			boundaryStep[i] = FLT_MAX;
+		}
+	}
+
+	float distance = enter;
+	while (distance <= exit)
+	{
+		unsigned int colour = volume.m_pVoxels[voxel[0] + volume.m_sizeX * (voxel[1] + volume.m_sizeY * voxel[2])];
+		if ((colour & 0xFF000000) != 0)
+		{
+			*pDistance = distance;
+			return true;
+		}
+
+		int axis = (nextBoundary[0] < nextBoundary[1]) ? ((nextBoundary[0] < nextBoundary[2]) ? 0 : 2) : ((nextBoundary[1] < nextBoundary[2]) ? 1 : 2);
+		distance = nextBoundary[axis];
+		nextBoundary[axis] += boundaryStep[axis];
+		voxel[axis] += step[axis];
+		if (voxel[axis] < 0 || voxel[axis] >= size[axis])
+		{
+			break;
+		}
+	}
+
+	return false;
+}
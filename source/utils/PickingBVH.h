@@ -0,0 +1,135 @@
+// ******************************************************************************
+// Filename:    PickingBVH.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Mouse picking on the CPU. Each pickable part is an oriented box, the
+//   bounds of a voxel model matrix in the world, with an optional voxel grid
+//   so that a ray only hits the solid voxels. The boxes are kept in a bounding
+//   volume hierarchy, and a ray cast returns the id of the nearest hit. This
+//   replaces picking with GL_SELECT, which re-rendered the pickable objects
+//   and stalled the pipeline every frame. No GL is used, so this also runs
+//   headless.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Maths/3dmaths.h"
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+#include <vector>
+using namespace std;
+
+
+class PickingVolume
+{
+public:
+	int m_id;
+
+	// Local space to world space, and back
+	Matrix4x4 m_transform;
+	Matrix4x4 m_inverseTransform;
+
+	// The box in local space
+	vec3 m_localMin;
+	vec3 m_localMax;
+
+	// The axis aligned box around it in world space
+	vec3 m_worldMin;
+	vec3 m_worldMax;
+
+	// Optional voxels, laid out like a qubicle matrix, voxel (x, y, z) is the unit cube around that local position and is solid when its alpha isn't 0
+	const unsigned int* m_pVoxels;
+	int m_sizeX;
+	int m_sizeY;
+	int m_sizeZ;
+};
+
+class PickingBVHNode
+{
+public:
+	vec3 m_min;
+	vec3 m_max;
+
+	// Children for an inner node, -1 for a leaf
+	int m_left;
+	int m_right;
+
+	// The leaf's volumes in the volume order
+	int m_first;
+	int m_count;
+};
+
+class PickingHit
+{
+public:
+	int m_id;
+	float m_distance;
+	vec3 m_position;
+};
+
+
+class PickingBVH
+{
+public:
+	/* Public methods */
+	PickingBVH();
+	~PickingBVH();
+
+	void Clear();
+
+	// A solid box, min and max are in the local space of the transform
+	void AddBox(int id, const Matrix4x4 &transform, const vec3 &localMin, const vec3 &localMax);
+	// A voxel grid, the voxels are not copied and must stay alive until the next Clear()
+	void AddVoxels(int id, const Matrix4x4 &transform, const unsigned int* pVoxels, int sizeX, int sizeY, int sizeZ);
+
+	// Call after adding the volumes and before casting rays
+	void Build();
+
+	// The nearest hit along the ray, up to maxDistance
+	bool RayCast(const vec3 &origin, const vec3 &direction, float maxDistance, PickingHit* pHit);
+	// The same result by testing every volume, for checking the hierarchy
+	bool RayCastBruteForce(const vec3 &origin, const vec3 &direction, float maxDistance, PickingHit* pHit);
+
+	// The ray through a point on the screen, the point starts at the bottom left like window coordinates
+	static void GetScreenRay(float screenX, float screenY, int screenWidth, int screenHeight, float fov, const vec3 &cameraPos, const vec3 &cameraTarget, const vec3 &cameraUp, vec3* pOrigin, vec3* pDirection);
+
+	// Counters
+	int GetNumVolumes();
+	int GetNumNodes();
+	int GetNumNodeTests();
+	int GetNumVolumeTests();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	int BuildNode(int first, int count);
+	bool RayVolume(const PickingVolume &volume, const vec3 &origin, const vec3 &direction, float maxDistance, float* pDistance);
+
+public:
+	/* Public members */
+	static const int MAX_LEAF_VOLUMES = 2;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<PickingVolume> m_vVolumes;
+	vector<int> m_vVolumeOrder;
+	vector<PickingBVHNode> m_vNodes;
+
+	// For the last ray cast
+	int m_numNodeTests;
+	int m_numVolumeTests;
+};
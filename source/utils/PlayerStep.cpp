@@ -0,0 +1,350 @@
+// ******************************************************************************
+// Filename:    PlayerStep.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "PlayerStep.h"
+
+#include "../blocks/Chunk.h"
+#include "../Maths/3dGeometry.h"
+
+#include <glm/glm.hpp>
+
+
+const float PlayerStep::STEP_UP_HEIGHT = Chunk::BLOCK_RENDER_SIZE*2.2f;
+const float PlayerStep::STEP_UP_TIME = 0.1f;
+const float PlayerStep::STEP_UP_OFFSET_TIME = 0.125f;
+
+
+PlayerStepWorld::PlayerStepWorld()
+{
+	m_getBlock = NULL;
+	m_hasFloor = NULL;
+	m_checkOtherCollisions = NULL;
+	m_isUnderWater = NULL;
+	m_pData = NULL;
+}
+
+
+PlayerBody::PlayerBody()
+{
+	m_gravityDirection = vec3(0.0f, -1.0f, 0.0f);
+	m_radius = 1.0f;
+
+	m_bIsOnGround = false;
+	m_groundCheckTimer = 0.0f;
+
+	m_bCanJump = true;
+
+	m_bDoStepUp = false;
+	m_stepUpElapsed = PlayerStep::STEP_UP_OFFSET_TIME;
+	m_stepUpPrevious = 0.0f;
+}
+
+vec3 PlayerBody::GetCenter() const
+{
+	return m_position + vec3(0.0f, m_radius - GetStepUpOffset(), 0.0f);
+}
+
+float PlayerBody::GetStepUpOffset() const
+{
+	if (m_bDoStepUp || m_stepUpElapsed >= PlayerStep::STEP_UP_OFFSET_TIME)
+	{
+		return 0.0f;
+	}
+
+	// Eases out from the full step height, the same curve as a -100 easing interpolation
+	float remaining = 1.0f - (m_stepUpElapsed / PlayerStep::STEP_UP_OFFSET_TIME);
+
+	return PlayerStep::STEP_UP_HEIGHT * remaining * remaining;
+}
+
+bool PlayerBody::IsSteppingUp() const
+{
+	return m_bDoStepUp;
+}
+
+
+vec3 PlayerStep::Move(const PlayerStepWorld &world, PlayerBody* pBody, const vec3 &direction, float speed)
+{
+	vec3 totalAmountMoved;
+
+	vec3 movement = direction;
+	vec3 movementAmount = direction*speed;
+	vec3 pNormal;
+	int numberDivision = 1;
+	while (length(movementAmount) >= 1.0f)
+	{
+		numberDivision++;
+		movementAmount = direction*(speed / numberDivision);
+	}
+	for (int i = 0; i < numberDivision; i++)
+	{
+		float speedToUse = (speed / numberDivision) + ((speed / numberDivision) * i);
+		vec3 posToCheck = pBody->GetCenter() + movement*speedToUse;
+
+		if (pBody->m_bDoStepUp == false)
+		{
+			bool stepUp = false;
+			if (CheckCollisions(world, posToCheck, pBody->m_previousPosition, pBody->m_radius, &pNormal, &movement, &stepUp))
+			{
+				// Only allow step ups when we are on the ground and also when we can jump. i.e not in air.
+				if (pBody->m_bIsOnGround == true && pBody->m_bCanJump == true && stepUp)
+				{
+					pBody->m_bDoStepUp = true;
+					pBody->m_stepUpElapsed = 0.0f;
+					pBody->m_stepUpPrevious = 0.0f;
+				}
+			}
+		}
+
+		pBody->m_position += (movement * speedToUse);
+
+		totalAmountMoved += (movement * speedToUse);
+	}
+
+	return totalAmountMoved;
+}
+
+bool PlayerStep::UpdatePhysics(const PlayerStepWorld &world, PlayerBody* pBody, float dt)
+{
+	bool landed = false;
+
+	pBody->m_positionMovementAmount = vec3(0.0f, 0.0f, 0.0f);
+
+	if (pBody->m_groundCheckTimer >= 0.0f)
+	{
+		pBody->m_groundCheckTimer -= dt;
+	}
+	if (pBody->m_groundCheckTimer <= 0.0f)
+	{
+		pBody->m_bIsOnGround = false;
+	}
+
+	// Step up, raised over the step up time and then eased in with the offset
+	float stepUpAddition = 0.0f;
+	if (pBody->m_stepUpElapsed < STEP_UP_OFFSET_TIME)
+	{
+		pBody->m_stepUpElapsed += dt;
+	}
+	if (pBody->m_bDoStepUp)
+	{
+		float stepUpRatio = pBody->m_stepUpElapsed / STEP_UP_TIME;
+		if (stepUpRatio >= 1.0f)
+		{
+			stepUpRatio = 1.0f;
+			pBody->m_bDoStepUp = false;
+		}
+
+		float stepUpAmount = STEP_UP_HEIGHT * stepUpRatio;
+		stepUpAddition = stepUpAmount - pBody->m_stepUpPrevious;
+		pBody->m_position.y += stepUpAddition;
+
+		pBody->m_stepUpPrevious = stepUpAmount;
+	}
+
+	// Gravity multiplier
+	float gravityMultiplier = 4.0f;
+	if (world.m_isUnderWater != NULL && world.m_isUnderWater(pBody->GetCenter(), world.m_pData))
+	{
+		gravityMultiplier = 0.5f;
+	}
+
+	// Integrate velocity
+	vec3 acceleration = pBody->m_force + (pBody->m_gravityDirection * 9.81f)*gravityMultiplier;
+	pBody->m_velocity += acceleration * dt;
+
+	// Check collision
+	vec3 velocityToUse = pBody->m_velocity;
+	vec3 velAmount = velocityToUse*dt;
+	vec3 pNormal;
+	int numberDivision = 1;
+	while (length(velAmount) >= 1.0f)
+	{
+		numberDivision++;
+		velAmount = velocityToUse*(dt / numberDivision);
+	}
+	for (int i = 0; i < numberDivision; i++)
+	{
+		float dtToUse = (dt / numberDivision) + ((dt / numberDivision) * i);
+		vec3 posToCheck = pBody->GetCenter() + velocityToUse*dtToUse;
+		bool stepUp = false;
+		if (CheckCollisions(world, posToCheck, pBody->m_previousPosition, pBody->m_radius, &pNormal, &velAmount, &stepUp))
+		{
+			// Reset velocity, we don't have any bounce
+			pBody->m_velocity = vec3(0.0f, 0.0f, 0.0f);
+			velocityToUse = vec3(0.0f, 0.0f, 0.0f);
+
+			pBody->m_bIsOnGround = true;
+			pBody->m_groundCheckTimer = 0.1f;
+
+			if (pBody->m_bCanJump == false)
+			{
+				pBody->m_bCanJump = true;
+
+				landed = true;
+			}
+		}
+	}
+
+	// Integrate position
+	pBody->m_position += velocityToUse * dt;
+
+	pBody->m_positionMovementAmount += vec3(0.0f, stepUpAddition, 0.0f);
+	pBody->m_positionMovementAmount += velocityToUse * dt;
+
+	// Store previous position
+	pBody->m_previousPosition = pBody->GetCenter();
+
+	return landed;
+}
+
+bool PlayerStep::CheckCollisions(const PlayerStepWorld &world, const vec3 &positionCheck, const vec3 &previousPosition, float radius, vec3* pNormal, vec3* pMovement, bool* pStepUpBlock)
+{
+	vec3 movementCache = *pMovement;
+
+	// Item collisions
+	bool otherCollision = false;
+	if (world.m_checkOtherCollisions != NULL)
+	{
+		otherCollision = world.m_checkOtherCollisions(positionCheck, previousPosition, radius, pNormal, pMovement, world.m_pData);
+	}
+
+	// World collision
+	bool worldCollision = false;
+
+	if (world.m_hasFloor(positionCheck, world.m_pData) == false)
+	{
+		*pMovement = vec3(0.0f, 0.0f, 0.0f);
+		return true;
+	}
+
+	const float blockSize = Chunk::BLOCK_RENDER_SIZE*2.0f;
+
+	Plane3D planes[6];
+	planes[0] = Plane3D(vec3(-1.0f, 0.0f, 0.0f), vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
+	planes[1] = Plane3D(vec3(1.0f, 0.0f, 0.0f), vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
+	planes[2] = Plane3D(vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
+	planes[3] = Plane3D(vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
+	planes[4] = Plane3D(vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
+	planes[5] = Plane3D(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
+
+	vec3 blockPos;
+	vec3 blockPosAbove;
+	int numChecks = 1 + (int)(radius / blockSize);
+	bool canAllStepUp = false;
+	bool firstStepUp = true;
+	for (int x = -numChecks; x <= numChecks; x++)
+	{
+		for (int y = -numChecks; y <= numChecks; y++)
+		{
+			for (int z = -numChecks; z <= numChecks; z++)
+			{
+				*pNormal = vec3(0.0f, 0.0f, 0.0f);
+
+				bool loaded = true;
+				bool active = world.m_getBlock(positionCheck + vec3(blockSize*x, blockSize*y, blockSize*z), &blockPos, &loaded, world.m_pData);
+
+				if (active == false)
+				{
+					if (loaded == false)
+					{
+						*pMovement = vec3(0.0f, 0.0f, 0.0f);
+						worldCollision = true;
+					}
+
+					continue;
+				}
+
+				float distance;
+				int inside = 0;
+				bool insideCache[6];
+
+				for (int i = 0; i < 6; i++)
+				{
+					vec3 pointToCheck = blockPos - previousPosition;
+					distance = planes[i].GetPointDistance(pointToCheck);
+
+					// Intersecting or inside
+					insideCache[i] = (distance >= -radius);
+				}
+
+				for (int i = 0; i < 6; i++)
+				{
+					vec3 pointToCheck = blockPos - positionCheck;
+					distance = planes[i].GetPointDistance(pointToCheck);
+
+					if (distance >= -radius)
+					{
+						// Intersecting or inside
+						inside++;
+						if (insideCache[i] == false)
+						{
+							*pNormal += planes[i].mNormal;
+						}
+					}
+				}
+
+				if (inside == 6)
+				{
+					if (y == 0) // We only want to check on the same y-level as the players position.
+					{
+						vec3 posCheck1 = vec3(positionCheck.x + (blockSize*x), positionCheck.y + blockSize, positionCheck.z + (blockSize*z));
+						vec3 posCheck2 = vec3(positionCheck.x + (blockSize*x), positionCheck.y + (blockSize*2.0f), positionCheck.z + (blockSize*z));
+
+						bool loadedAbove = true;
+						bool activeAbove = world.m_getBlock(posCheck1, &blockPosAbove, &loadedAbove, world.m_pData);
+						bool activeAbove2 = world.m_getBlock(posCheck2, &blockPosAbove, &loadedAbove, world.m_pData);
+
+						if ((activeAbove == false) && (activeAbove2 == false))
+						{
+							if (firstStepUp)
+							{
+								canAllStepUp = true;
+							}
+						}
+						else
+						{
+							canAllStepUp = false;
+						}
+
+						firstStepUp = false;
+					}
+
+					if (length(*pNormal) <= 1.0f)
+					{
+						if (length(*pNormal) > 0.0f)
+						{
+							*pNormal = normalize(*pNormal);
+						}
+
+						float dotResult = dot(*pNormal, *pMovement);
+						*pNormal *= dotResult;
+
+						*pMovement -= *pNormal;
+
+						worldCollision = true;
+					}
+				}
+			}
+		}
+	}
+
+	*pStepUpBlock = canAllStepUp;
+
+	if (otherCollision)
+		return true;
+
+	if (worldCollision)
+		return true;
+
+	*pMovement = movementCache;
+
+	return false;
+}
@@ -0,0 +1,104 @@
+// ******************************************************************************
+// Filename:    PlayerStep.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   The player's movement and physics step: walking with collision against
+//   the world blocks, stepping up single blocks, gravity and landing. The
+//   Player keeps its body here and runs the step with the chunk manager and
+//   items as the world, vox_bench runs the same step against its own blocks.
+//   The step up is timed by the simulation step and not the frame, so a
+//   trajectory doesn't depend on the frame rate. No GL is used.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+// Whether the block at the world position is active, and its center. pLoaded is false when its chunk isn't there or isn't setup yet.
+typedef bool(*PlayerStepBlockFunction)(const vec3 &position, vec3* pBlockPos, bool* pLoaded, void* pData);
+
+// Whether there is any floor below the position, the player doesn't move where there is none
+typedef bool(*PlayerStepFloorFunction)(const vec3 &position, void* pData);
+
+// Collision with things that aren't world blocks, adjusting the movement like the block collision does
+typedef bool(*PlayerStepCollisionFunction)(const vec3 &position, const vec3 &previousPosition, float radius, vec3* pNormal, vec3* pMovement, void* pData);
+
+// Whether the position is under water
+typedef bool(*PlayerStepWaterFunction)(const vec3 &position, void* pData);
+
+
+class PlayerStepWorld
+{
+public:
+	PlayerStepWorld();
+
+	PlayerStepBlockFunction m_getBlock;
+	PlayerStepFloorFunction m_hasFloor;
+	PlayerStepCollisionFunction m_checkOtherCollisions;	// Optional
+	PlayerStepWaterFunction m_isUnderWater;	// Optional
+	void* m_pData;
+};
+
+
+class PlayerBody
+{
+public:
+	PlayerBody();
+
+	vec3 GetCenter() const;
+
+	// How far the model is drawn below the body just after a step up, so that it eases up onto the block
+	float GetStepUpOffset() const;
+
+	bool IsSteppingUp() const;
+
+	vec3 m_position;
+	vec3 m_velocity;
+	vec3 m_force;
+	vec3 m_gravityDirection;
+	float m_radius;
+
+	// The center at the end of the last physics step, used for the collision normals
+	vec3 m_previousPosition;
+
+	// How much the last physics step moved the player
+	vec3 m_positionMovementAmount;
+
+	// Ground flag, kept for a short time after touching the ground
+	bool m_bIsOnGround;
+	float m_groundCheckTimer;
+
+	// Flag to control if we are allowed to jump or not, reset when landing
+	bool m_bCanJump;
+
+	// Stepping up single world blocks by walking into them
+	bool m_bDoStepUp;
+	float m_stepUpElapsed;
+	float m_stepUpPrevious;
+};
+
+
+class PlayerStep
+{
+public:
+	// Moves the player along the direction by the speed, sliding along the blocks and starting a step up when walking into a single block
+	static vec3 Move(const PlayerStepWorld &world, PlayerBody* pBody, const vec3 &direction, float speed);
+
+	// Gravity, step up and velocity for one simulation step. Returns true when the player lands.
+	static bool UpdatePhysics(const PlayerStepWorld &world, PlayerBody* pBody, float dt);
+
+	// Removes the part of the movement that goes into the blocks and items around the position
+	static bool CheckCollisions(const PlayerStepWorld &world, const vec3 &positionCheck, const vec3 &previousPosition, float radius, vec3* pNormal, vec3* pMovement, bool* pStepUpBlock);
+
+	static const float STEP_UP_HEIGHT;
+	static const float STEP_UP_TIME;
+	static const float STEP_UP_OFFSET_TIME;
+};
@@ -0,0 +1,355 @@
+// ******************************************************************************
+// Filename:    Profiler.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "Profiler.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+
+// Initialize the singleton instance
+Profiler *Profiler::c_instance = 0;
+
+std::atomic<bool> Profiler::c_enabled(false);
+PROFILER_THREAD_LOCAL ProfileThreadBuffer* Profiler::t_pThreadBuffer = NULL;
+
+double ProfileZone::GetZoneTime()
+{
+	return GetHighResolutionTime();
+}
+
+Profiler* Profiler::GetInstance()
+{
+	if(c_instance == 0)
+		c_instance = new Profiler;
+
+	return c_instance;
+}
+
+void Profiler::Destroy()
+{
+	if(c_instance)
+	{
+		c_enabled = false;
+
+		for(unsigned int i = 0; i < m_vpThreadBuffers.size(); i++)
+		{
+			delete [] m_vpThreadBuffers[i]->m_pEvents;
+			delete m_vpThreadBuffers[i];
+			m_vpThreadBuffers[i] = 0;
+		}
+		m_vpThreadBuffers.clear();
+		t_pThreadBuffer = NULL;
+
+		for(unsigned int i = 0; i < m_vpZoneStats.size(); i++)
+		{
+			delete m_vpZoneStats[i];
+			m_vpZoneStats[i] = 0;
+		}
+		m_vpZoneStats.clear();
+		m_zoneStatsMap.clear();
+
+		m_vCaptureEvents.clear();
+
+		delete c_instance;
+		c_instance = 0;
+	}
+}
+
+Profiler::Profiler()
+{
+	m_numDroppedEvents = 0;
+	m_capturing = false;
+	m_startTime = GetHighResolutionTime();
+}
+
+// Enabling
+void Profiler::SetEnabled(bool enabled)
+{
+	c_enabled = enabled;
+}
+
+bool Profiler::IsEnabled()
+{
+	return c_enabled;
+}
+
+bool Profiler::IsZoneEnabled()
+{
+	return c_enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* threadName)
+{
+	ProfileThreadBuffer* pThreadBuffer = GetThreadBuffer();
+
+	m_threadBuffersLock.lock();
+	pThreadBuffer->m_threadName = threadName;
+	m_threadBuffersLock.unlock();
+}
+
+// Zones
+ProfileThreadBuffer* Profiler::BeginZone()
+{
+	ProfileThreadBuffer* pThreadBuffer = GetThreadBuffer();
+	pThreadBuffer->m_depth++;
+
+	return pThreadBuffer;
+}
+
+void Profiler::EndZone(ProfileThreadBuffer* pThreadBuffer, const char* pZoneName, double startTime)
+{
+	pThreadBuffer->m_depth--;
+
+	unsigned int numWritten = pThreadBuffer->m_numWritten.load(std::memory_order_relaxed);
+	ProfileEvent* pEvent = &pThreadBuffer->m_pEvents[numWritten % THREAD_BUFFER_EVENTS];
+	pEvent->m_pZoneName = pZoneName;
+	pEvent->m_startTime = startTime;
+	pEvent->m_endTime = GetHighResolutionTime();
+	pEvent->m_depth = pThreadBuffer->m_depth;
+
+	// Publish the event to EndFrame() after it has been written
+	pThreadBuffer->m_numWritten.store(numWritten + 1, std::memory_order_release);
+}
+
+void Profiler::EndFrame()
+{
+	// Collect the new events from every thread
+	m_threadBuffersLock.lock();
+	for(unsigned int i = 0; i < m_vpThreadBuffers.size(); i++)
+	{
+		ProfileThreadBuffer* pThreadBuffer = m_vpThreadBuffers[i];
+
+		unsigned int numWritten = pThreadBuffer->m_numWritten.load(std::memory_order_acquire);
+		if(numWritten - pThreadBuffer->m_numRead > (unsigned int)THREAD_BUFFER_EVENTS)
+		{
+			// The thread has gone all the way around the ring since we last looked
+			unsigned int numDropped = numWritten - pThreadBuffer->m_numRead - THREAD_BUFFER_EVENTS;
+			m_numDroppedEvents += (int)numDropped;
+			pThreadBuffer->m_numRead += numDropped;
+		}
+
+		for(; pThreadBuffer->m_numRead != numWritten; pThreadBuffer->m_numRead++)
+		{
+			const ProfileEvent& event = pThreadBuffer->m_pEvents[pThreadBuffer->m_numRead % THREAD_BUFFER_EVENTS];
+
+			ProfileZoneStats* pZoneStats = GetZoneStats(event.m_pZoneName);
+			pZoneStats->m_currentFrameTime += (float)((event.m_endTime - event.m_startTime) * 1000.0);
+			pZoneStats->m_currentFrameCalls++;
+
+			if(m_capturing && (int)m_vCaptureEvents.size() < MAX_CAPTURE_EVENTS)
+			{
+				ProfileCaptureEvent captureEvent;
+				captureEvent.m_event = event;
+				captureEvent.m_threadIndex = pThreadBuffer->m_threadIndex;
+				m_vCaptureEvents.push_back(captureEvent);
+			}
+		}
+	}
+	m_threadBuffersLock.unlock();
+
+	// Move every zone on a frame, including the ones that didn't run this frame
+	for(unsigned int i = 0; i < m_vpZoneStats.size(); i++)
+	{
+		ProfileZoneStats* pZoneStats = m_vpZoneStats[i];
+
+		if((int)pZoneStats->m_vFrameTimes.size() < HISTORY_FRAMES)
+		{
+			pZoneStats->m_vFrameTimes.push_back(pZoneStats->m_currentFrameTime);
+		}
+		else
+		{
+			pZoneStats->m_vFrameTimes[pZoneStats->m_nextFrameIndex] = pZoneStats->m_currentFrameTime;
+		}
+		pZoneStats->m_nextFrameIndex = (pZoneStats->m_nextFrameIndex + 1) % HISTORY_FRAMES;
+
+		pZoneStats->m_lastFrameCalls = pZoneStats->m_currentFrameCalls;
+		pZoneStats->m_currentFrameTime = 0.0f;
+		pZoneStats->m_currentFrameCalls = 0;
+
+		UpdateZoneStats(pZoneStats);
+	}
+}
+
+// Zone statistics
+void Profiler::GetSortedZoneStats(ProfileZoneStatsList* pvpZoneStats)
+{
+	*pvpZoneStats = m_vpZoneStats;
+	sort(pvpZoneStats->begin(), pvpZoneStats->end(), Profiler::SortZoneStats);
+}
+
+int Profiler::GetNumDroppedEvents()
+{
+	return m_numDroppedEvents;
+}
+
+// Capturing and exporting
+void Profiler::StartCapture()
+{
+	m_vCaptureEvents.clear();
+	m_capturing = true;
+}
+
+void Profiler::StopCapture()
+{
+	m_capturing = false;
+}
+
+bool Profiler::IsCapturing()
+{
+	return m_capturing;
+}
+
+int Profiler::GetNumCaptureEvents()
+{
+	return (int)m_vCaptureEvents.size();
+}
+
+bool Profiler::WriteChromeTrace(const char* fileName)
+{
+	FILE* pFile = fopen(fileName, "w");
+	if(pFile == NULL)
+	{
+		return false;
+	}
+
+	// Complete events, with the times in microseconds
+	fprintf(pFile, "{\"traceEvents\":[\n");
+	m_threadBuffersLock.lock();
+	for(unsigned int i = 0; i < m_vpThreadBuffers.size(); i++)
+	{
+		ProfileThreadBuffer* pThreadBuffer = m_vpThreadBuffers[i];
+		fprintf(pFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}},\n", pThreadBuffer->m_threadIndex, pThreadBuffer->m_threadName.c_str());
+	}
+	m_threadBuffersLock.unlock();
+	for(unsigned int i = 0; i < m_vCaptureEvents.size(); i++)
+	{
+		const ProfileCaptureEvent& captureEvent = m_vCaptureEvents[i];
+		double start = (captureEvent.m_event.m_startTime - m_startTime) * 1000000.0;
+		double duration = (captureEvent.m_event.m_endTime - captureEvent.m_event.m_startTime) * 1000000.0;
+
+		fprintf(pFile, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}%s\n", captureEvent.m_event.m_pZoneName, captureEvent.m_threadIndex, start, duration, (i + 1 < m_vCaptureEvents.size()) ? "," : "");
+	}
+	fprintf(pFile, "]}\n");
+
+	fclose(pFile);
+
+	return true;
+}
+
+bool Profiler::WriteCSV(const char* fileName)
+{
+	FILE* pFile = fopen(fileName, "w");
+	if(pFile == NULL)
+	{
+		return false;
+	}
+
+	fprintf(pFile, "thread,zone,depth,start_ms,duration_ms\n");
+	m_threadBuffersLock.lock();
+	for(unsigned int i = 0; i < m_vCaptureEvents.size(); i++)
+	{
+		const ProfileCaptureEvent& captureEvent = m_vCaptureEvents[i];
+		double start = (captureEvent.m_event.m_startTime - m_startTime) * 1000.0;
+		double duration = (captureEvent.m_event.m_endTime - captureEvent.m_event.m_startTime) * 1000.0;
+
+		fprintf(pFile, "\"%s\",\"%s\",%i,%.4f,%.4f\n", m_vpThreadBuffers[captureEvent.m_threadIndex]->m_threadName.c_str(), captureEvent.m_event.m_pZoneName, captureEvent.m_event.m_depth, start, duration);
+	}
+	m_threadBuffersLock.unlock();
+
+	fclose(pFile);
+
+	return true;
+}
+
+ProfileThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if(t_pThreadBuffer == NULL)
+	{
+		ProfileThreadBuffer* pThreadBuffer = new ProfileThreadBuffer();
+		pThreadBuffer->m_pEvents = new ProfileEvent[THREAD_BUFFER_EVENTS];
+		pThreadBuffer->m_numWritten = 0;
+		pThreadBuffer->m_numRead = 0;
+		pThreadBuffer->m_depth = 0;
+
+		m_threadBuffersLock.lock();
+		pThreadBuffer->m_threadIndex = (int)m_vpThreadBuffers.size();
+		char lThreadName[32];
+		sprintf(lThreadName, "Thread %i", pThreadBuffer->m_threadIndex);
+		pThreadBuffer->m_threadName = lThreadName;
+		m_vpThreadBuffers.push_back(pThreadBuffer);
+		m_threadBuffersLock.unlock();
+
+		t_pThreadBuffer = pThreadBuffer;
+	}
+
+	return t_pThreadBuffer;
+}
+
+ProfileZoneStats* Profiler::GetZoneStats(const char* pZoneName)
+{
+	// The same name can be at different addresses in different files, so the zones are keyed by the string
+	ProfileZoneStatsMap::iterator iter = m_zoneStatsMap.find(pZoneName);
+	if(iter != m_zoneStatsMap.end())
+	{
+		return iter->second;
+	}
+
+	ProfileZoneStats* pZoneStats = new ProfileZoneStats();
+	pZoneStats->m_name = pZoneName;
+	pZoneStats->m_nextFrameIndex = 0;
+	pZoneStats->m_currentFrameTime = 0.0f;
+	pZoneStats->m_currentFrameCalls = 0;
+	pZoneStats->m_averageTime = 0.0f;
+	pZoneStats->m_p99Time = 0.0f;
+	pZoneStats->m_maxTime = 0.0f;
+	pZoneStats->m_lastFrameCalls = 0;
+
+	m_zoneStatsMap[pZoneStats->m_name] = pZoneStats;
+	m_vpZoneStats.push_back(pZoneStats);
+
+	return pZoneStats;
+}
+
+void Profiler::UpdateZoneStats(ProfileZoneStats* pZoneStats)
+{
+	int numFrames = (int)pZoneStats->m_vFrameTimes.size();
+	if(numFrames == 0)
+	{
+		return;
+	}
+
+	float totalTime = 0.0f;
+	float maxTime = 0.0f;
+	for(int i = 0; i < numFrames; i++)
+	{
+		totalTime += pZoneStats->m_vFrameTimes[i];
+		if(pZoneStats->m_vFrameTimes[i] > maxTime)
+		{
+			maxTime = pZoneStats->m_vFrameTimes[i];
+		}
+	}
+
+	// The 99th percentile frame, which is the max until we have 100 frames of history
+	m_vSortedFrameTimes.assign(pZoneStats->m_vFrameTimes.begin(), pZoneStats->m_vFrameTimes.end());
+	int p99Index = (numFrames * 99) / 100;
+	nth_element(m_vSortedFrameTimes.begin(), m_vSortedFrameTimes.begin() + p99Index, m_vSortedFrameTimes.end());
+
+	pZoneStats->m_averageTime = totalTime / numFrames;
+	pZoneStats->m_p99Time = m_vSortedFrameTimes[p99Index];
+	pZoneStats->m_maxTime = maxTime;
+}
+
+bool Profiler::SortZoneStats(ProfileZoneStats* pA, ProfileZoneStats* pB)
+{
+	return pA->m_averageTime > pB->m_averageTime;
+}
@@ -0,0 +1,227 @@
+// ******************************************************************************
+// Filename:    Profiler.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   A scoped zone frame profiler. PROFILE_ZONE("Name") times the rest of the
+//   enclosing scope. Every thread writes its finished zones into its own ring
+//   buffer without any locking, and the main thread collects them once per
+//   frame in EndFrame(), keeping a rolling history of the time spent in each
+//   zone per frame. Captured zones can be written out as a Chrome trace
+//   (chrome://tracing) or as CSV.
+//
+//   When the profiler is disabled a zone costs a single flag check, defining
+//   VOX_DISABLE_PROFILER removes the zones completely.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILER_THREAD_LOCAL thread_local
+#endif
+
+class ProfileEvent
+{
+public:
+	// Zone names must be string literals, or at least live as long as the profiler
+	const char* m_pZoneName;
+	double m_startTime;
+	double m_endTime;
+	int m_depth;
+};
+
+class ProfileThreadBuffer
+{
+public:
+	int m_threadIndex;
+	string m_threadName;
+
+	// Ring buffer, only the owning thread writes to it and only EndFrame() reads from it
+	ProfileEvent* m_pEvents;
+	std::atomic<unsigned int> m_numWritten;
+	unsigned int m_numRead;
+
+	// How many zones are open on this thread
+	int m_depth;
+};
+
+typedef vector<ProfileThreadBuffer*> ProfileThreadBufferList;
+
+class ProfileCaptureEvent
+{
+public:
+	ProfileEvent m_event;
+	int m_threadIndex;
+};
+
+typedef vector<ProfileCaptureEvent> ProfileCaptureEventList;
+
+class ProfileZoneStats
+{
+public:
+	string m_name;
+
+	// Milliseconds spent in the zone per frame, over all the threads, for the last HISTORY_FRAMES frames
+	vector<float> m_vFrameTimes;
+	int m_nextFrameIndex;
+
+	float m_currentFrameTime;
+	int m_currentFrameCalls;
+
+	// Worked out in EndFrame()
+	float m_averageTime;
+	float m_p99Time;
+	float m_maxTime;
+	int m_lastFrameCalls;
+};
+
+typedef map<string, ProfileZoneStats*> ProfileZoneStatsMap;
+typedef vector<ProfileZoneStats*> ProfileZoneStatsList;
+
+
+class Profiler
+{
+public:
+	/* Public methods */
+	static Profiler* GetInstance();
+	void Destroy();
+
+	// Enabling
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+	static bool IsZoneEnabled();
+
+	// Names the calling thread in the exports
+	void SetThreadName(const char* threadName);
+
+	// Zones, use PROFILE_ZONE instead of calling these directly
+	ProfileThreadBuffer* BeginZone();
+	void EndZone(ProfileThreadBuffer* pThreadBuffer, const char* pZoneName, double startTime);
+
+	// Collects the zones from all the threads, called once a frame by the main thread
+	void EndFrame();
+
+	// Zone statistics, sorted with the most expensive zones first
+	void GetSortedZoneStats(ProfileZoneStatsList* pvpZoneStats);
+	int GetNumDroppedEvents();
+
+	// Capturing and exporting
+	void StartCapture();
+	void StopCapture();
+	bool IsCapturing();
+	int GetNumCaptureEvents();
+	bool WriteChromeTrace(const char* fileName);
+	bool WriteCSV(const char* fileName);
+
+protected:
+	/* Protected methods */
+	Profiler();
+	Profiler(const Profiler&);
+	Profiler &operator=(const Profiler&);
+
+private:
+	/* Private methods */
+	ProfileThreadBuffer* GetThreadBuffer();
+	ProfileZoneStats* GetZoneStats(const char* pZoneName);
+	void UpdateZoneStats(ProfileZoneStats* pZoneStats);
+
+	static bool SortZoneStats(ProfileZoneStats* pA, ProfileZoneStats* pB);
+
+public:
+	/* Public members */
+	static const int THREAD_BUFFER_EVENTS = 16384;
+	static const int HISTORY_FRAMES = 240;
+	static const int MAX_CAPTURE_EVENTS = 1000000;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	static std::atomic<bool> c_enabled;
+
+	tthread::mutex m_threadBuffersLock;
+	ProfileThreadBufferList m_vpThreadBuffers;
+
+	// Cached per thread, so that a zone doesn't need to look the buffer up
+	static PROFILER_THREAD_LOCAL ProfileThreadBuffer* t_pThreadBuffer;
+
+	ProfileZoneStatsMap m_zoneStatsMap;
+	ProfileZoneStatsList m_vpZoneStats;
+
+	// Scratch space for working out the percentiles
+	vector<float> m_vSortedFrameTimes;
+
+	// Events that were written over before EndFrame() could read them
+	int m_numDroppedEvents;
+
+	bool m_capturing;
+	ProfileCaptureEventList m_vCaptureEvents;
+
+	// Capture and export times are relative to this
+	double m_startTime;
+
+	// Singleton instance
+	static Profiler *c_instance;
+};
+
+
+// Times from the constructor to the end of the scope
+class ProfileZone
+{
+public:
+	ProfileZone(const char* pZoneName)
+	{
+		m_pThreadBuffer = NULL;
+		m_pZoneName = pZoneName;
+		m_startTime = 0.0;
+
+		if (Profiler::IsZoneEnabled())
+		{
+			m_pThreadBuffer = Profiler::GetInstance()->BeginZone();
+			m_startTime = GetZoneTime();
+		}
+	}
+
+	~ProfileZone()
+	{
+		if (m_pThreadBuffer != NULL)
+		{
+			Profiler::GetInstance()->EndZone(m_pThreadBuffer, m_pZoneName, m_startTime);
+		}
+	}
+
+	static double GetZoneTime();
+
+private:
+	ProfileThreadBuffer* m_pThreadBuffer;
+	const char* m_pZoneName;
+	double m_startTime;
+};
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+
+#if defined(VOX_DISABLE_PROFILER)
+#define PROFILE_ZONE(zoneName)
+#define PROFILE_THREAD_NAME(threadName)
+#else
+#define PROFILE_ZONE(zoneName) ProfileZone PROFILE_ZONE_CONCAT(profileZone_, __LINE__)(zoneName)
+#define PROFILE_THREAD_NAME(threadName) Profiler::GetInstance()->SetThreadName(threadName)
+#endif
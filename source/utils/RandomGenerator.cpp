@@ -0,0 +1,85 @@
+// ******************************************************************************
+// Filename:    RandomGenerator.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include <math.h>
+
+#include "RandomGenerator.h"
+
+// Golden ratio increment, spreads consecutive counters and seeds across the whole range
+static const unsigned long long GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+
+RandomGenerator::RandomGenerator(unsigned long long seed)
+{
+	SetSeed(seed);
+}
+
+RandomGenerator::~RandomGenerator()
+{
+}
+
+// Seed
+void RandomGenerator::SetSeed(unsigned long long seed)
+{
+	m_seed = seed;
+	m_counter = 0;
+}
+
+unsigned long long RandomGenerator::GetSeed()
+{
+	return m_seed;
+}
+
+unsigned long long RandomGenerator::HashSeed(unsigned int worldSeed, int x, int y, int z)
+{
+	unsigned long long hash = Mix((unsigned long long)worldSeed + GOLDEN_GAMMA);
+	hash = Mix(hash ^ (unsigned long long)(unsigned int)x);
+	hash = Mix(hash ^ (unsigned long long)(unsigned int)y);
+	hash = Mix(hash ^ (unsigned long long)(unsigned int)z);
+
+	return hash;
+}
+
+// Random numbers
+unsigned int RandomGenerator::GetNext()
+{
+	m_counter++;
+
+	return (unsigned int)(Mix(m_seed + m_counter * GOLDEN_GAMMA) >> 32);
+}
+
+int RandomGenerator::GetRandomNumber(int lower, int higher)
+{
+	if (lower > higher)
+	{
+		int temp = lower;
+		lower = higher;
+		higher = temp;
+	}
+	unsigned int diff = (unsigned int)((higher + 1) - lower);
+	return (int)(GetNext() % diff) + lower;
+}
+
+float RandomGenerator::GetRandomNumber(int lower, int higher, int precision)
+{
+	float lPrecisionPow = pow(10.0f, precision);
+	float lRand = (float)GetRandomNumber((int)(lower * lPrecisionPow), (int)(higher * lPrecisionPow));
+
+	return (lRand / lPrecisionPow);
+}
+
+unsigned long long RandomGenerator::Mix(unsigned long long value)
+{
+	// splitmix64 finaliser
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
@@ -0,0 +1,62 @@
+// ******************************************************************************
+// Filename:    RandomGenerator.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   A counter based random number generator. Each number is a hash of the
+//   seed and a counter, so a generator owns all of its state and the same
+//   seed always gives the same sequence, on any thread and in any order.
+//   Used for world generation instead of the global rand().
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+
+class RandomGenerator
+{
+public:
+	/* Public methods */
+	RandomGenerator(unsigned long long seed);
+	~RandomGenerator();
+
+	// Seed
+	void SetSeed(unsigned long long seed);
+	unsigned long long GetSeed();
+
+	// Combine a world seed and a set of grid co-ordinates into a seed
+	static unsigned long long HashSeed(unsigned int worldSeed, int x, int y, int z);
+
+	// Random numbers
+	unsigned int GetNext();
+
+	// Get a random integer number in the range from lower to higher. INCLUSIVE
+	int GetRandomNumber(int lower, int higher);
+
+	// Get a random floating point number in the range from lower to higher. INCLUSIVE
+	// Precision defines how many significant numbers there are after the point
+	float GetRandomNumber(int lower, int higher, int precision);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	static unsigned long long Mix(unsigned long long value);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	unsigned long long m_seed;
+	unsigned long long m_counter;
+};
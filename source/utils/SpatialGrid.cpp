@@ -0,0 +1,292 @@
+// ******************************************************************************
+// Filename:    SpatialGrid.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "SpatialGrid.h"
+
+#include <math.h>
+
+
+SpatialGrid::SpatialGrid(float cellSize)
+{
+	m_cellSize = cellSize;
+
+	for(int i = 0; i < eSpatialGridLayer_NUM; i++)
+	{
+		m_layers[i].m_maxRadius = 0.0f;
+	}
+}
+
+SpatialGrid::~SpatialGrid()
+{
+	for(int i = 0; i < eSpatialGridLayer_NUM; i++)
+	{
+		ClearLayer((eSpatialGridLayer)i);
+	}
+}
+
+void SpatialGrid::ClearLayer(eSpatialGridLayer layer)
+{
+	m_gridLock.lock();
+	SpatialGridLayer* pLayer = &m_layers[layer];
+
+	pLayer->m_vEntries.clear();
+	pLayer->m_entryIndices.clear();
+	pLayer->m_maxRadius = 0.0f;
+
+	// Keep hold of the cells that are still in use, since they will most likely be filled again straight away
+	SpatialGridCellMap::iterator it = pLayer->m_cells.begin();
+	while(it != pLayer->m_cells.end())
+	{
+		if(it->second.empty())
+		{
+			it = pLayer->m_cells.erase(it);
+		}
+		else
+		{
+			it->second.clear();
+			++it;
+		}
+	}
+	m_gridLock.unlock();
+}
+
+void SpatialGrid::AddObject(eSpatialGridLayer layer, void* pObject, vec3 center, float radius)
+{
+	m_gridLock.lock();
+	SpatialGridLayer* pLayer = &m_layers[layer];
+
+	long long cellKey = GetCellKey(GetCellCoordinate(center.x), GetCellCoordinate(center.z));
+
+	if(radius > pLayer->m_maxRadius)
+	{
+		pLayer->m_maxRadius = radius;
+	}
+
+	unordered_map<void*, int>::iterator it = pLayer->m_entryIndices.find(pObject);
+	if(it != pLayer->m_entryIndices.end())
+	{
+		// Already in the layer, just move it
+		SpatialGridEntry* pEntry = &pLayer->m_vEntries[it->second];
+		pEntry->m_center = center;
+		pEntry->m_radius = radius;
+
+		if(pEntry->m_cellKey != cellKey)
+		{
+			RemoveFromCell(pLayer, pEntry->m_cellKey, it->second);
+			pLayer->m_cells[cellKey].push_back(it->second);
+			pEntry->m_cellKey = cellKey;
+		}
+	}
+	else
+	{
+		SpatialGridEntry entry;
+		entry.m_pObject = pObject;
+		entry.m_center = center;
+		entry.m_radius = radius;
+		entry.m_cellKey = cellKey;
+
+		int entryIndex = (int)pLayer->m_vEntries.size();
+		pLayer->m_vEntries.push_back(entry);
+		pLayer->m_entryIndices[pObject] = entryIndex;
+		pLayer->m_cells[cellKey].push_back(entryIndex);
+	}
+	m_gridLock.unlock();
+}
+
+void SpatialGrid::RemoveObject(eSpatialGridLayer layer, void* pObject)
+{
+	m_gridLock.lock();
+	SpatialGridLayer* pLayer = &m_layers[layer];
+
+	unordered_map<void*, int>::iterator it = pLayer->m_entryIndices.find(pObject);
+	if(it != pLayer->m_entryIndices.end())
+	{
+		int entryIndex = it->second;
+		int lastIndex = (int)pLayer->m_vEntries.size() - 1;
+
+		RemoveFromCell(pLayer, pLayer->m_vEntries[entryIndex].m_cellKey, entryIndex);
+		pLayer->m_entryIndices.erase(it);
+
+		// Fill the gap with the last entry, and point its cell and index at the new slot
+		if(entryIndex != lastIndex)
+		{
+			SpatialGridEntry* pLastEntry = &pLayer->m_vEntries[lastIndex];
+
+			vector<int>* pCell = &pLayer->m_cells[pLastEntry->m_cellKey];
+			for(unsigned int i = 0; i < pCell->size(); i++)
+			{
+				if((*pCell)[i] == lastIndex)
+				{
+					(*pCell)[i] = entryIndex;
+					break;
+				}
+			}
+
+			pLayer->m_entryIndices[pLastEntry->m_pObject] = entryIndex;
+			pLayer->m_vEntries[entryIndex] = *pLastEntry;
+		}
+		pLayer->m_vEntries.pop_back();
+	}
+	m_gridLock.unlock();
+}
+
+// Queries
+void SpatialGrid::RadiusQuery(eSpatialGridLayer layer, vec3 center, float radius, vector<void*>* pvpObjects)
+{
+	pvpObjects->clear();
+
+	m_gridLock.lock();
+	SpatialGridLayer* pLayer = &m_layers[layer];
+
+	float reach = radius + pLayer->m_maxRadius;
+	GatherEntries(pLayer, center.x - reach, center.z - reach, center.x + reach, center.z + reach);
+
+	for(unsigned int i = 0; i < m_vQueryEntries.size(); i++)
+	{
+		SpatialGridEntry* pEntry = &pLayer->m_vEntries[m_vQueryEntries[i]];
+
+		float xDistance = pEntry->m_center.x - center.x;
+		float zDistance = pEntry->m_center.z - center.z;
+		float range = radius + pEntry->m_radius;
+
+		if(xDistance*xDistance + zDistance*zDistance <= range*range)
+		{
+			pvpObjects->push_back(pEntry->m_pObject);
+		}
+	}
+	m_gridLock.unlock();
+}
+
+void SpatialGrid::SegmentQuery(eSpatialGridLayer layer, vec3 start, vec3 end, float radius, vector<void*>* pvpObjects)
+{
+	pvpObjects->clear();
+
+	m_gridLock.lock();
+	SpatialGridLayer* pLayer = &m_layers[layer];
+
+	float reach = radius + pLayer->m_maxRadius;
+	float minX = (start.x < end.x) ? start.x : end.x;
+	float maxX = (start.x < end.x) ? end.x : start.x;
+	float minZ = (start.z < end.z) ? start.z : end.z;
+	float maxZ = (start.z < end.z) ? end.z : start.z;
+	GatherEntries(pLayer, minX - reach, minZ - reach, maxX + reach, maxZ + reach);
+
+	float segmentX = end.x - start.x;
+	float segmentZ = end.z - start.z;
+	float segmentLengthSquared = segmentX*segmentX + segmentZ*segmentZ;
+
+	for(unsigned int i = 0; i < m_vQueryEntries.size(); i++)
+	{
+		SpatialGridEntry* pEntry = &pLayer->m_vEntries[m_vQueryEntries[i]];
+
+		// Closest point on the segment to the entry
+		float t = 0.0f;
+		if(segmentLengthSquared > 0.0f)
+		{
+			t = ((pEntry->m_center.x - start.x)*segmentX + (pEntry->m_center.z - start.z)*segmentZ) / segmentLengthSquared;
+			if(t < 0.0f)
+			{
+				t = 0.0f;
+			}
+			else if(t > 1.0f)
+			{
+				t = 1.0f;
+			}
+		}
+
+		float xDistance = pEntry->m_center.x - (start.x + segmentX*t);
+		float zDistance = pEntry->m_center.z - (start.z + segmentZ*t);
+		float range = radius + pEntry->m_radius;
+
+		if(xDistance*xDistance + zDistance*zDistance <= range*range)
+		{
+			pvpObjects->push_back(pEntry->m_pObject);
+		}
+	}
+	m_gridLock.unlock();
+}
+
+float SpatialGrid::GetCellSize()
+{
+	return m_cellSize;
+}
+
+float SpatialGrid::GetMaxRadius(eSpatialGridLayer layer)
+{
+	return m_layers[layer].m_maxRadius;
+}
+
+int SpatialGrid::GetNumObjects(eSpatialGridLayer layer)
+{
+	m_gridLock.lock();
+	int numObjects = (int)m_layers[layer].m_vEntries.size();
+	m_gridLock.unlock();
+
+	return numObjects;
+}
+
+long long SpatialGrid::GetCellKey(int cellX, int cellZ)
+{
+	return ((long long)cellX << 32) | (unsigned int)cellZ;
+}
+
+int SpatialGrid::GetCellCoordinate(float position)
+{
+	return (int)floorf(position / m_cellSize);
+}
+
+void SpatialGrid::RemoveFromCell(SpatialGridLayer* pLayer, long long cellKey, int entryIndex)
+{
+	vector<int>* pCell = &pLayer->m_cells[cellKey];
+	for(unsigned int i = 0; i < pCell->size(); i++)
+	{
+		if((*pCell)[i] == entryIndex)
+		{
+			(*pCell)[i] = pCell->back();
+			pCell->pop_back();
+			break;
+		}
+	}
+}
+
+void SpatialGrid::GatherEntries(SpatialGridLayer* pLayer, float minX, float minZ, float maxX, float maxZ)
+{
+	m_vQueryEntries.clear();
+
+	int minCellX = GetCellCoordinate(minX);
+	int minCellZ = GetCellCoordinate(minZ);
+	int maxCellX = GetCellCoordinate(maxX);
+	int maxCellZ = GetCellCoordinate(maxZ);
+
+	// When the bounds cover more cells than the layer uses, it is quicker to just look at every entry
+	double numBoundsCells = (double)(maxCellX - minCellX + 1) * (double)(maxCellZ - minCellZ + 1);
+	if(numBoundsCells > (double)pLayer->m_cells.size())
+	{
+		for(unsigned int i = 0; i < pLayer->m_vEntries.size(); i++)
+		{
+			m_vQueryEntries.push_back(i);
+		}
+
+		return;
+	}
+
+	for(int cellX = minCellX; cellX <= maxCellX; cellX++)
+	{
+		for(int cellZ = minCellZ; cellZ <= maxCellZ; cellZ++)
+		{
+			SpatialGridCellMap::iterator it = pLayer->m_cells.find(GetCellKey(cellX, cellZ));
+			if(it != pLayer->m_cells.end())
+			{
+				m_vQueryEntries.insert(m_vQueryEntries.end(), it->second.begin(), it->second.end());
+			}
+		}
+	}
+}
@@ -0,0 +1,113 @@
+// ******************************************************************************
+// Filename:    SpatialGrid.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   A uniform grid over the x and z axis that the entity managers register
+//   their objects into, so that collision and interaction checks only have to
+//   look at the objects in the nearby cells instead of every object in the
+//   world. Each type of object lives in its own layer. The queries are a broad
+//   phase only, they return every object that could be in range on the x and
+//   z axis and the caller still does its own exact checks.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+#include "../tinythread/tinythread.h"
+
+enum eSpatialGridLayer
+{
+	eSpatialGridLayer_Enemy = 0,
+	eSpatialGridLayer_NPC,
+	eSpatialGridLayer_Item,
+	eSpatialGridLayer_Projectile,
+
+	eSpatialGridLayer_NUM,
+};
+
+class SpatialGridEntry
+{
+public:
+	void* m_pObject;
+	vec3 m_center;
+	float m_radius;
+	long long m_cellKey;
+};
+
+typedef unordered_map<long long, vector<int> > SpatialGridCellMap;
+
+class SpatialGridLayer
+{
+public:
+	vector<SpatialGridEntry> m_vEntries;
+	unordered_map<void*, int> m_entryIndices;
+	SpatialGridCellMap m_cells;
+
+	// Largest radius added since the layer was last cleared, queries are widened by this much
+	float m_maxRadius;
+};
+
+
+class SpatialGrid
+{
+public:
+	/* Public methods */
+	SpatialGrid(float cellSize);
+	~SpatialGrid();
+
+	void ClearLayer(eSpatialGridLayer layer);
+
+	// Adds the object to the layer, or moves it if the object is already in the layer
+	void AddObject(eSpatialGridLayer layer, void* pObject, vec3 center, float radius);
+	void RemoveObject(eSpatialGridLayer layer, void* pObject);
+
+	// Queries, fills pvpObjects with the objects that are within radius (plus their own radius) on the x and z axis
+	void RadiusQuery(eSpatialGridLayer layer, vec3 center, float radius, vector<void*>* pvpObjects);
+	void SegmentQuery(eSpatialGridLayer layer, vec3 start, vec3 end, float radius, vector<void*>* pvpObjects);
+
+	float GetCellSize();
+	float GetMaxRadius(eSpatialGridLayer layer);
+	int GetNumObjects(eSpatialGridLayer layer);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	long long GetCellKey(int cellX, int cellZ);
+	int GetCellCoordinate(float position);
+
+	void RemoveFromCell(SpatialGridLayer* pLayer, long long cellKey, int entryIndex);
+
+	// Gathers the entries in all of the cells overlapping the x and z bounds into m_vQueryEntries, the caller must hold the lock
+	void GatherEntries(SpatialGridLayer* pLayer, float minX, float minZ, float maxX, float maxZ);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	tthread::mutex m_gridLock;
+
+	float m_cellSize;
+
+	SpatialGridLayer m_layers[eSpatialGridLayer_NUM];
+
+	vector<int> m_vQueryEntries;
+};
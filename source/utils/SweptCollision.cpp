@@ -0,0 +1,111 @@
+// ******************************************************************************
+// Filename:    SweptCollision.cpp
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "SweptCollision.h"
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+
+
+bool SweptHit::EarliestFirst(const SweptHit &lhs, const SweptHit &rhs)
+{
+	return lhs.m_time < rhs.m_time;
+}
+
+bool SweptCollision::SphereSphere(const vec3 &start, const vec3 &end, float radius, const vec3 &sphereCenter, float sphereRadius, float* pTime)
+{
+	vec3 movement = end - start;
+	vec3 fromCenter = start - sphereCenter;
+	float combinedRadius = radius + sphereRadius;
+
+	float c = dot(fromCenter, fromCenter) - combinedRadius*combinedRadius;
+	if(c < 0.0f)
+	{
+		*pTime = 0.0f;
+		return true;
+	}
+
+	float a = dot(movement, movement);
+	float b = dot(fromCenter, movement);
+	if(a <= 0.0f || b >= 0.0f)
+	{
+		// Not moving, or moving away
+		return false;
+	}
+
+	float discriminant = b*b - a*c;
+	if(discriminant < 0.0f)
+	{
+		return false;
+	}
+
+	float time = (-b - sqrtf(discriminant)) / a;
+	if(time > 1.0f)
+	{
+		return false;
+	}
+
+	*pTime = time;
+	return true;
+}
+
+bool SweptCollision::SphereBox(const vec3 &start, const vec3 &end, float radius, const vec3 &boxCenter, const vec3 &xAxis, const vec3 &yAxis, const vec3 &zAxis, const vec3 &halfLengths, float* pTime)
+{
+	vec3 axes[3] = { xAxis, yAxis, zAxis };
+	vec3 fromCenter = start - boxCenter;
+	vec3 movement = end - start;
+
+	// Clip the segment against each pair of faces in turn
+	float enterTime = 0.0f;
+	float exitTime = 1.0f;
+	for(int i = 0; i < 3; i++)
+	{
+		float position = dot(fromCenter, axes[i]);
+		float speed = dot(movement, axes[i]);
+		float halfLength = halfLengths[i] + radius;
+
+		if(speed == 0.0f)
+		{
+			if(position < -halfLength || position > halfLength)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			float time1 = (-halfLength - position) / speed;
+			float time2 = (halfLength - position) / speed;
+			if(time1 > time2)
+			{
+				float swap = time1;
+				time1 = time2;
+				time2 = swap;
+			}
+
+			enterTime = (time1 > enterTime) ? time1 : enterTime;
+			exitTime = (time2 < exitTime) ? time2 : exitTime;
+			if(enterTime > exitTime)
+			{
+				return false;
+			}
+		}
+	}
+
+	*pTime = enterTime;
+	return true;
+}
+
+void SweptCollision::Integrate(vec3* pPosition, vec3* pVelocity, const vec3 &acceleration, float dt)
+{
+	*pPosition += (*pVelocity) * dt + acceleration * (0.5f * dt * dt);
+	*pVelocity += acceleration * dt;
+}
@@ -0,0 +1,54 @@
+// ******************************************************************************
+// Filename:    SweptCollision.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//   Continuous collision for fast moving objects. Instead of testing where an
+//   object ends up after a step, the whole segment that it moved along in the
+//   step is tested, and the time of impact is returned as a fraction of the
+//   step. So a projectile can't pass through a thin wall or a small enemy
+//   between two steps, however far it moves in one step. The block grid is
+//   swept with VoxelRayCast, these are the sweeps against the entity hitboxes.
+//   No GL is used, so this also runs headless.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <glm/vec3.hpp>
+using namespace glm;
+
+
+class SweptHit
+{
+public:
+	void* m_pObject;
+	void* m_pOther;
+
+	// 0 at the start of the step, 1 at the end
+	float m_time;
+
+	static bool EarliestFirst(const SweptHit &lhs, const SweptHit &rhs);
+};
+
+
+class SweptCollision
+{
+public:
+	// A sphere of the radius moving from start to end, against a sphere that isn't moving.
+	// The time is 0 if they already touch at the start.
+	static bool SphereSphere(const vec3 &start, const vec3 &end, float radius, const vec3 &sphereCenter, float sphereRadius, float* pTime);
+
+	// A sphere of the radius moving from start to end, against a box around the center along the axes.
+	// The box is grown by the radius on each side, the same as the plane tests the hitboxes used before.
+	static bool SphereBox(const vec3 &start, const vec3 &end, float radius, const vec3 &boxCenter, const vec3 &xAxis, const vec3 &yAxis, const vec3 &zAxis, const vec3 &halfLengths, float* pTime);
+
+	// Moves with a constant acceleration over the step. The position is exactly on the curve for any step length,
+	// so the path, and where it hits, doesn't depend on how long the steps are.
+	static void Integrate(vec3* pPosition, vec3* pVelocity, const vec3 &acceleration, float dt);
+};
@@ -0,0 +1,39 @@
+// ******************************************************************************
+// Filename:    TimeUtils.h
+// Project:     Vox
+// Author:      Steven Ball
+//
+// Purpose:
+//	 High resolution time helpers, used for measuring how long a piece of
+//	 work took, for example chunk generation throughput and profiling.
+//
+// Revision History:
+//   Initial Revision - 17/10/26
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stddef.h>
+#include <sys/time.h>
+#endif //_WIN32
+
+// Get the current time in seconds, from an arbitrary fixed starting point.
+inline double GetHighResolutionTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER ticks;
+	LARGE_INTEGER ticksPerSecond;
+	QueryPerformanceCounter(&ticks);
+	QueryPerformanceFrequency(&ticksPerSecond);
+	return (double)ticks.QuadPart / (double)ticksPerSecond.QuadPart;
+#else
+	struct timeval tm;
+	gettimeofday(&tm, NULL);
+	return (double)tm.tv_sec + (double)tm.tv_usec / 1000000.0;
+#endif //_WIN32
+}